@@ -11,6 +11,7 @@ Archive Common
 #include "common/memContext.h"
 #include "common/regExp.h"
 #include "common/wait.h"
+#include "compress/helper.h"
 #include "postgres/version.h"
 #include "storage/helper.h"
 #include "storage/helper.h"
@@ -275,7 +276,7 @@ walSegmentFind(const Storage *storage, const String *archiveId, const String *wa
         // Get a list of all WAL segments that match
         StringList *list = storageListP(
             storage, strNewFmt(STORAGE_REPO_ARCHIVE "/%s/%s", strPtr(archiveId), strPtr(strSubN(walSegment, 0, 16))),
-            .expression = strNewFmt("^%s%s-[0-f]{40}(\\.gz){0,1}$", strPtr(strSubN(walSegment, 0, 24)),
+            .expression = strNewFmt("^%s%s-[0-f]{40}" COMPRESS_EXT_REGEXP "$", strPtr(strSubN(walSegment, 0, 24)),
                 walIsPartial(walSegment) ? WAL_SEGMENT_PARTIAL_EXT : ""));
 
         // If there are results
@@ -7,10 +7,9 @@ Archive Get File
 #include "common/debug.h"
 #include "common/io/filter/group.h"
 #include "common/log.h"
-#include "compress/gzip.h"
-#include "compress/gzipDecompress.h"
+#include "compress/helper.h"
 #include "config/config.h"
-#include "crypto/cipherBlock.h"
+#include "crypto/helper.h"
 #include "info/infoArchive.h"
 #include "postgres/interface.h"
 #include "storage/helper.h"
@@ -152,16 +151,14 @@ archiveGetFile(
             if (cipherType != cipherTypeNone)
             {
                 ioFilterGroupAdd(
-                    filterGroup,
-                    cipherBlockFilter(
-                        cipherBlockNew(cipherModeDecrypt, cipherType, bufNewStr(archiveGetCheckResult.cipherPass), NULL)));
+                    filterGroup, cipherFilter(cipherModeDecrypt, cipherType, bufNewStr(archiveGetCheckResult.cipherPass)));
             }
 
-            // If file is gzipped then add the decompression filter
-            if (strEndsWithZ(archiveGetCheckResult.archiveFileActual, "." GZIP_EXT))
-            {
-                ioFilterGroupAdd(filterGroup, gzipDecompressFilter(gzipDecompressNew(false)));
-            }
+            // If file is compressed then add the decompression filter for the type given by the extension
+            CompressType fileCompressType = compressTypeFromFile(archiveGetCheckResult.archiveFileActual);
+
+            if (fileCompressType != compressTypeNone)
+                ioFilterGroupAdd(filterGroup, decompressFilter(fileCompressType));
 
             ioWriteFilterGroupSet(storageFileWriteIo(destination), filterGroup);
 
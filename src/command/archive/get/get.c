@@ -302,8 +302,10 @@ cmdArchiveGetAsync(void)
                 strLstSize(walSegmentList) == 1 ?
                     "" : strPtr(strNewFmt("...%s", strPtr(strLstGet(walSegmentList, strLstSize(walSegmentList) - 1)))));
 
-            // Create the parallel executor
-            ProtocolParallel *parallelExec = protocolParallelNew((TimeMSec)(cfgOptionDbl(cfgOptProtocolTimeout) * MSEC_PER_SEC) / 2);
+            // Create the parallel executor.  Send two jobs to each process so the next WAL segment is queued when the current one
+            // completes.
+            ProtocolParallel *parallelExec = protocolParallelNew(
+                (TimeMSec)(cfgOptionDbl(cfgOptProtocolTimeout) * MSEC_PER_SEC) / 2, 2);
 
             for (unsigned int processIdx = 1; processIdx <= (unsigned int)cfgOptionInt(cfgOptProcessMax); processIdx++)
                 protocolParallelClientAdd(parallelExec, protocolLocalGet(protocolStorageTypeRepo, processIdx));
@@ -0,0 +1,487 @@
+/***********************************************************************************************************************************
+Backup Chunk Filter
+***********************************************************************************************************************************/
+#include "command/backup/chunk.h"
+#include "common/debug.h"
+#include "common/io/filter/filter.intern.h"
+#include "common/io/filter/group.h"
+#include "common/log.h"
+#include "common/memContext.h"
+#include "common/type/keyValue.h"
+#include "crypto/hash.h"
+#include "crypto/helper.h"
+#include "storage/fileRead.h"
+#include "storage/fileWrite.h"
+
+/***********************************************************************************************************************************
+Filter type and result key constants
+***********************************************************************************************************************************/
+STRING_EXTERN(BACKUP_CHUNK_FILTER_TYPE_STR,                         BACKUP_CHUNK_FILTER_TYPE);
+
+STRING_EXTERN(BACKUP_CHUNK_KEY_LIST_STR,                            BACKUP_CHUNK_KEY_LIST);
+
+/***********************************************************************************************************************************
+Gear table used by the rolling hash.  The table is generated from a fixed seed rather than stored since it only needs to be random
+looking, but the seed must never change because chunk boundaries (and therefore deduplication with prior backups) depend on it.
+***********************************************************************************************************************************/
+#define BACKUP_CHUNK_GEAR_SEED                                      0x7067427232303139ULL
+
+static uint64_t backupChunkGear[256];
+static bool backupChunkGearDone = false;
+
+static void
+backupChunkGearInit(void)
+{
+    FUNCTION_TEST_VOID();
+
+    if (!backupChunkGearDone)
+    {
+        // Generate with splitmix64
+        uint64_t state = BACKUP_CHUNK_GEAR_SEED;
+
+        for (unsigned int gearIdx = 0; gearIdx < 256; gearIdx++)
+        {
+            state += 0x9E3779B97F4A7C15ULL;
+
+            uint64_t value = state;
+            value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ULL;
+            value = (value ^ (value >> 27)) * 0x94D049BB133111EBULL;
+
+            backupChunkGear[gearIdx] = value ^ (value >> 31);
+        }
+
+        backupChunkGearDone = true;
+    }
+
+    FUNCTION_TEST_RETURN_VOID();
+}
+
+/***********************************************************************************************************************************
+Object type
+***********************************************************************************************************************************/
+struct BackupChunk
+{
+    MemContext *memContext;                                         // Mem context of filter
+    IoFilter *filter;                                               // Filter interface
+
+    size_t sizeMin;                                                 // Minimum chunk size (except for the last chunk)
+    size_t sizeAvg;                                                 // Average chunk size
+    size_t sizeMax;                                                 // Maximum chunk size
+    uint64_t maskSmall;                                             // Boundary mask used before the average size is reached
+    uint64_t maskLarge;                                             // Boundary mask used after the average size is reached
+
+    uint64_t hash;                                                  // Rolling hash of the current chunk
+    Buffer *chunk;                                                  // Data of the current chunk
+    Buffer *idKey;                                                  // Key used to calculate ids (NULL when not encrypted)
+
+    VariantList *list;                                              // Ids of chunks in file order
+    List *take;                                                     // Chunks completed since the last backupChunkTake()
+};
+
+/***********************************************************************************************************************************
+Derive the key used to calculate chunk ids from the cipher passphrase of the store
+
+The key is derived with a label so it is not the passphrase itself and differs from any other key derived from the passphrase.
+***********************************************************************************************************************************/
+#define BACKUP_CHUNK_ID_KEY_LABEL                                   "pgBackRest chunk id"
+
+static Buffer *
+backupChunkIdKey(const String *cipherPass)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(STRING, cipherPass);
+    FUNCTION_TEST_END();
+
+    ASSERT(cipherPass != NULL);
+
+    FUNCTION_TEST_RETURN(
+        cryptoHmacOne(HASH_TYPE_SHA256_STR, bufNewStr(cipherPass), bufNewStr(strNew(BACKUP_CHUNK_ID_KEY_LABEL))));
+}
+
+/***********************************************************************************************************************************
+Calculate the id of a chunk
+
+The id is the SHA-1 of the chunk, or the HMAC-SHA1 of the chunk with the id key when the store is encrypted so that ids (which are
+also the names of the files in the store) do not reveal the hash of the plaintext.  cryptoHmacOne() hashes the whole buffer, so the
+chunk is passed as a buffer of exactly the used size.
+***********************************************************************************************************************************/
+static String *
+backupChunkId(const Buffer *idKey, const Buffer *chunk)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(BUFFER, idKey);
+        FUNCTION_TEST_PARAM(BUFFER, chunk);
+    FUNCTION_TEST_END();
+
+    ASSERT(chunk != NULL);
+
+    FUNCTION_TEST_RETURN(
+        bufHex(
+            idKey == NULL ?
+                cryptoHashOneC(HASH_TYPE_SHA1_STR, bufPtr(chunk), bufUsed(chunk)) :
+                cryptoHmacOne(HASH_TYPE_SHA1_STR, idKey, bufNewUseC(bufPtr(chunk), bufUsed(chunk)))));
+}
+
+/***********************************************************************************************************************************
+New object
+
+The average size must be a power of two.  Boundaries are found with normalized chunking, i.e. a mask with more bits is used until
+the average size is reached and a mask with fewer bits after, which keeps chunk sizes close to the average.
+
+The cipher passphrase must be the passphrase of the store when the store is encrypted and NULL otherwise.
+***********************************************************************************************************************************/
+BackupChunk *
+backupChunkNew(size_t sizeAvg, const String *cipherPass)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(SIZE, sizeAvg);
+        FUNCTION_LOG_PARAM(STRING, cipherPass);
+    FUNCTION_LOG_END();
+
+    ASSERT(sizeAvg >= 64 && (sizeAvg & (sizeAvg - 1)) == 0);
+
+    backupChunkGearInit();
+
+    BackupChunk *this = NULL;
+
+    MEM_CONTEXT_NEW_BEGIN("BackupChunk")
+    {
+        this = memNew(sizeof(BackupChunk));
+        this->memContext = memContextCurrent();
+
+        this->sizeMin = sizeAvg / 4;
+        this->sizeAvg = sizeAvg;
+        this->sizeMax = sizeAvg * 4;
+
+        // The top bits of the hash are used since they depend on the most bytes
+        unsigned int sizeBits = 0;
+
+        while ((size_t)1 << sizeBits < sizeAvg)
+            sizeBits++;
+
+        this->maskSmall = UINT64_MAX << (64 - (sizeBits + 2));
+        this->maskLarge = UINT64_MAX << (64 - (sizeBits - 2));
+
+        this->chunk = bufNew(this->sizeMax);
+        this->idKey = cipherPass == NULL ? NULL : backupChunkIdKey(cipherPass);
+        this->list = varLstNew();
+        this->take = lstNew(sizeof(BackupChunkData));
+
+        // Create filter interface
+        this->filter = ioFilterNewP(
+            BACKUP_CHUNK_FILTER_TYPE_STR, this, .in = (IoFilterInterfaceProcessIn)backupChunkProcess,
+            .result = (IoFilterInterfaceResult)backupChunkResult);
+    }
+    MEM_CONTEXT_NEW_END();
+
+    FUNCTION_LOG_RETURN(BACKUP_CHUNK, this);
+}
+
+/***********************************************************************************************************************************
+Add the current chunk to the list and to the chunks to be taken by the caller
+***********************************************************************************************************************************/
+static void
+backupChunkAdd(BackupChunk *this)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(BACKUP_CHUNK, this);
+    FUNCTION_TEST_END();
+
+    ASSERT(this != NULL);
+    ASSERT(bufUsed(this->chunk) > 0);
+
+    // Allocate the chunk in the take list context so it moves to the caller with the list
+    MEM_CONTEXT_BEGIN(lstMemContext(this->take))
+    {
+        BackupChunkData chunk =
+        {
+            .id = backupChunkId(this->idKey, this->chunk),
+            .data = bufNewC(bufUsed(this->chunk), bufPtr(this->chunk)),
+        };
+
+        lstAdd(this->take, &chunk);
+
+        MEM_CONTEXT_BEGIN(this->memContext)
+        {
+            varLstAdd(this->list, varNewStr(chunk.id));
+        }
+        MEM_CONTEXT_END();
+    }
+    MEM_CONTEXT_END();
+
+    bufUsedZero(this->chunk);
+    this->hash = 0;
+
+    FUNCTION_TEST_RETURN_VOID();
+}
+
+/***********************************************************************************************************************************
+Find chunk boundaries in the input
+***********************************************************************************************************************************/
+void
+backupChunkProcess(BackupChunk *this, const Buffer *input)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(BACKUP_CHUNK, this);
+        FUNCTION_LOG_PARAM(BUFFER, input);
+    FUNCTION_LOG_END();
+
+    ASSERT(this != NULL);
+    ASSERT(input != NULL);
+
+    const unsigned char *inputPtr = bufPtr(input);
+    size_t inputIdx = 0;
+
+    while (inputIdx < bufUsed(input))
+    {
+        size_t inputBegin = inputIdx;
+        size_t chunkSize = bufUsed(this->chunk);
+        bool boundary = false;
+
+        // Skip the hash until the minimum size is reached since there cannot be a boundary
+        if (chunkSize < this->sizeMin)
+        {
+            size_t skipSize = this->sizeMin - chunkSize;
+
+            if (skipSize > bufUsed(input) - inputIdx)
+                skipSize = bufUsed(input) - inputIdx;
+
+            inputIdx += skipSize;
+            chunkSize += skipSize;
+        }
+
+        // Roll the hash until a boundary is found or the input is exhausted
+        while (!boundary && inputIdx < bufUsed(input))
+        {
+            this->hash = (this->hash << 1) + backupChunkGear[inputPtr[inputIdx]];
+            inputIdx++;
+            chunkSize++;
+
+            boundary =
+                (this->hash & (chunkSize < this->sizeAvg ? this->maskSmall : this->maskLarge)) == 0 || chunkSize == this->sizeMax;
+        }
+
+        bufCatC(this->chunk, inputPtr, inputBegin, inputIdx - inputBegin);
+
+        if (boundary)
+            backupChunkAdd(this);
+    }
+
+    FUNCTION_LOG_RETURN_VOID();
+}
+
+/***********************************************************************************************************************************
+Take the chunks completed since the last call
+***********************************************************************************************************************************/
+List *
+backupChunkTake(BackupChunk *this)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(BACKUP_CHUNK, this);
+    FUNCTION_LOG_END();
+
+    ASSERT(this != NULL);
+
+    List *result = lstMove(this->take, memContextCurrent());
+
+    MEM_CONTEXT_BEGIN(this->memContext)
+    {
+        this->take = lstNew(sizeof(BackupChunkData));
+    }
+    MEM_CONTEXT_END();
+
+    FUNCTION_LOG_RETURN(LIST, result);
+}
+
+/***********************************************************************************************************************************
+Get the name of a chunk file in the store
+***********************************************************************************************************************************/
+static String *
+backupChunkFile(const BackupChunkStore *store, const String *id)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM_P(VOID, store);
+        FUNCTION_TEST_PARAM(STRING, id);
+    FUNCTION_TEST_END();
+
+    ASSERT(store != NULL);
+    ASSERT(id != NULL);
+
+    FUNCTION_TEST_RETURN(
+        strNewFmt("%s/%s/%s%s", strPtr(store->path), strPtr(strSubN(id, 0, 3)), strPtr(id), compressExtZ(store->compressType)));
+}
+
+/***********************************************************************************************************************************
+Store a chunk if it is not already in the store
+***********************************************************************************************************************************/
+bool
+backupChunkPut(const BackupChunkStore *store, const String *id, const Buffer *data)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM_P(VOID, store);
+        FUNCTION_LOG_PARAM(STRING, id);
+        FUNCTION_LOG_PARAM(BUFFER, data);
+    FUNCTION_LOG_END();
+
+    ASSERT(store != NULL);
+    ASSERT(store->storage != NULL);
+    ASSERT(store->path != NULL);
+    ASSERT(store->cipherType == cipherTypeNone || store->cipherPass != NULL);
+    ASSERT(id != NULL);
+    ASSERT(data != NULL);
+
+    bool result = false;
+
+    MEM_CONTEXT_TEMP_BEGIN()
+    {
+        String *file = backupChunkFile(store, id);
+
+        // Chunks are immutable so a chunk that already exists does not need to be stored again
+        if (!storageExistsNP(store->storage, file))
+        {
+            StorageFileWrite *write = storageNewWriteNP(store->storage, file);
+            IoFilterGroup *filterGroup = ioFilterGroupNew();
+
+            if (store->compressType != compressTypeNone)
+                ioFilterGroupAdd(filterGroup, compressFilter(store->compressType, store->compressLevel));
+
+            if (store->cipherType != cipherTypeNone)
+                ioFilterGroupAdd(filterGroup, cipherFilter(cipherModeEncrypt, store->cipherType, bufNewStr(store->cipherPass)));
+
+            ioWriteFilterGroupSet(storageFileWriteIo(write), filterGroup);
+            storagePutNP(write, data);
+
+            result = true;
+        }
+    }
+    MEM_CONTEXT_TEMP_END();
+
+    FUNCTION_LOG_RETURN(BOOL, result);
+}
+
+/***********************************************************************************************************************************
+Rebuild a file by writing its chunks in order.  Each chunk is verified against its id so corruption in the store is detected.
+***********************************************************************************************************************************/
+void
+backupChunkRestore(const BackupChunkStore *store, const VariantList *chunkList, IoWrite *write)
+{
+    FUNCTION_LOG_BEGIN(logLevelDebug);
+        FUNCTION_LOG_PARAM_P(VOID, store);
+        FUNCTION_LOG_PARAM(VARIANT_LIST, chunkList);
+        FUNCTION_LOG_PARAM(IO_WRITE, write);
+    FUNCTION_LOG_END();
+
+    ASSERT(store != NULL);
+    ASSERT(store->storage != NULL);
+    ASSERT(store->path != NULL);
+    ASSERT(store->cipherType == cipherTypeNone || store->cipherPass != NULL);
+    ASSERT(chunkList != NULL);
+    ASSERT(write != NULL);
+
+    MEM_CONTEXT_TEMP_BEGIN()
+    {
+        const Buffer *idKey = store->cipherType == cipherTypeNone ? NULL : backupChunkIdKey(store->cipherPass);
+
+        for (unsigned int chunkIdx = 0; chunkIdx < varLstSize(chunkList); chunkIdx++)
+        {
+            MEM_CONTEXT_TEMP_BEGIN()
+            {
+                const String *id = varStr(varLstGet(chunkList, chunkIdx));
+                String *file = backupChunkFile(store, id);
+                StorageFileRead *read = storageNewReadNP(store->storage, file);
+                IoFilterGroup *filterGroup = ioFilterGroupNew();
+
+                if (store->cipherType != cipherTypeNone)
+                    ioFilterGroupAdd(filterGroup, cipherFilter(cipherModeDecrypt, store->cipherType, bufNewStr(store->cipherPass)));
+
+                if (store->compressType != compressTypeNone)
+                    ioFilterGroupAdd(filterGroup, decompressFilter(store->compressType));
+
+                ioReadFilterGroupSet(storageFileReadIo(read), filterGroup);
+
+                Buffer *chunk = storageGetNP(read);
+
+                if (!strEq(backupChunkId(idKey, chunk), id))
+                    THROW_FMT(ChecksumError, "chunk '%s' does not match its checksum", strPtr(file));
+
+                ioWrite(write, chunk);
+            }
+            MEM_CONTEXT_TEMP_END();
+        }
+    }
+    MEM_CONTEXT_TEMP_END();
+
+    FUNCTION_LOG_RETURN_VOID();
+}
+
+/***********************************************************************************************************************************
+Get filter interface
+***********************************************************************************************************************************/
+IoFilter *
+backupChunkFilter(const BackupChunk *this)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(BACKUP_CHUNK, this);
+    FUNCTION_TEST_END();
+
+    ASSERT(this != NULL);
+
+    FUNCTION_TEST_RETURN(this->filter);
+}
+
+/***********************************************************************************************************************************
+Return filter result
+
+The last chunk is completed here since in filters are not flushed, so backupChunkTake() must be called again after the filter group
+is closed.  The result is a KeyValue with the list of chunk ids.
+***********************************************************************************************************************************/
+const Variant *
+backupChunkResult(BackupChunk *this)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(BACKUP_CHUNK, this);
+    FUNCTION_LOG_END();
+
+    ASSERT(this != NULL);
+
+    Variant *result = NULL;
+
+    // Complete the last chunk
+    if (bufUsed(this->chunk) > 0)
+        backupChunkAdd(this);
+
+    MEM_CONTEXT_BEGIN(this->memContext)
+    {
+        result = varNewKv();
+
+        kvPut(varKv(result), varNewStr(BACKUP_CHUNK_KEY_LIST_STR), varNewVarLst(this->list));
+    }
+    MEM_CONTEXT_END();
+
+    FUNCTION_LOG_RETURN(VARIANT, result);
+}
+
+/***********************************************************************************************************************************
+Render as string for logging
+***********************************************************************************************************************************/
+String *
+backupChunkToLog(const BackupChunk *this)
+{
+    return strNewFmt("{chunkTotal: %u, sizeAvg: %zu}", varLstSize(this->list), this->sizeAvg);
+}
+
+/***********************************************************************************************************************************
+Free the filter
+***********************************************************************************************************************************/
+void
+backupChunkFree(BackupChunk *this)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(BACKUP_CHUNK, this);
+    FUNCTION_LOG_END();
+
+    if (this != NULL)
+        memContextFree(this->memContext);
+
+    FUNCTION_LOG_RETURN_VOID();
+}
@@ -0,0 +1,114 @@
+/***********************************************************************************************************************************
+Backup Chunk Filter
+
+Split a file into content-defined chunks as it passes through a filter group.  Chunk boundaries are found with a rolling (gear) hash
+so an update in the middle of a file only changes the chunks around it, and the rest of the file deduplicates against chunks stored
+by prior backups.  The filter result contains the list of chunk ids in file order, which is stored in the manifest so the file can
+be rebuilt with backupChunkRestore().  The id is the SHA-1 of the chunk, or an HMAC-SHA1 keyed from the cipher passphrase when the
+store is encrypted so the file names in the store do not reveal the hash of the plaintext.
+
+The filter does no I/O.  Completed chunks are collected with backupChunkTake() after each read/write through the filter group (and
+once more after the filter group is closed) and the caller stores them with backupChunkPut(), which skips chunks that are already in
+the store.
+
+Chunks are stored as <path>/<first three characters of id>/<id>[.<compress ext>].  Chunks are compressed and then encrypted with the
+store settings.
+***********************************************************************************************************************************/
+#ifndef COMMAND_BACKUP_CHUNK_H
+#define COMMAND_BACKUP_CHUNK_H
+
+/***********************************************************************************************************************************
+Object type
+***********************************************************************************************************************************/
+typedef struct BackupChunk BackupChunk;
+
+#include "common/io/filter/filter.h"
+#include "common/io/write.h"
+#include "common/type/buffer.h"
+#include "common/type/list.h"
+#include "common/type/variantList.h"
+#include "compress/helper.h"
+#include "crypto/crypto.h"
+#include "storage/storage.h"
+
+/***********************************************************************************************************************************
+Filter type constant
+***********************************************************************************************************************************/
+#define BACKUP_CHUNK_FILTER_TYPE                                    "chunk"
+    STRING_DECLARE(BACKUP_CHUNK_FILTER_TYPE_STR);
+
+/***********************************************************************************************************************************
+Result keys
+***********************************************************************************************************************************/
+#define BACKUP_CHUNK_KEY_LIST                                       "list"
+    STRING_DECLARE(BACKUP_CHUNK_KEY_LIST_STR);
+
+/***********************************************************************************************************************************
+Constants
+***********************************************************************************************************************************/
+// Average chunk size.  Chunks are between a quarter and four times this size.
+#define BACKUP_CHUNK_SIZE_AVG_DEFAULT                               ((size_t)64 * 1024)
+
+/***********************************************************************************************************************************
+Chunk returned by backupChunkTake()
+***********************************************************************************************************************************/
+typedef struct BackupChunkData
+{
+    const String *id;                                               // Chunk id
+    const Buffer *data;                                             // Chunk data
+} BackupChunkData;
+
+/***********************************************************************************************************************************
+Chunk store settings
+***********************************************************************************************************************************/
+typedef struct BackupChunkStore
+{
+    const Storage *storage;                                         // Storage where chunks are stored
+    const String *path;                                             // Path of the chunk store
+    CompressType compressType;                                      // Compression type of stored chunks
+    int compressLevel;                                              // Compression level of stored chunks
+    CipherType cipherType;                                          // Cipher type of stored chunks
+    const String *cipherPass;                                       // Cipher passphrase (when cipher type is not none)
+} BackupChunkStore;
+
+/***********************************************************************************************************************************
+Constructor
+***********************************************************************************************************************************/
+BackupChunk *backupChunkNew(size_t sizeAvg, const String *cipherPass);
+
+/***********************************************************************************************************************************
+Functions
+***********************************************************************************************************************************/
+void backupChunkProcess(BackupChunk *this, const Buffer *input);
+
+// Take the chunks completed since the last call as a list of BackupChunkData in file order.  The list is owned by the caller.
+List *backupChunkTake(BackupChunk *this);
+
+// Store a chunk if it is not already in the store.  Returns true if the chunk was stored.
+bool backupChunkPut(const BackupChunkStore *store, const String *id, const Buffer *data);
+
+// Rebuild a file from a chunk list
+void backupChunkRestore(const BackupChunkStore *store, const VariantList *chunkList, IoWrite *write);
+
+/***********************************************************************************************************************************
+Getters
+***********************************************************************************************************************************/
+IoFilter *backupChunkFilter(const BackupChunk *this);
+const Variant *backupChunkResult(BackupChunk *this);
+
+/***********************************************************************************************************************************
+Destructor
+***********************************************************************************************************************************/
+void backupChunkFree(BackupChunk *this);
+
+/***********************************************************************************************************************************
+Macros for function logging
+***********************************************************************************************************************************/
+String *backupChunkToLog(const BackupChunk *this);
+
+#define FUNCTION_LOG_BACKUP_CHUNK_TYPE                                                                                             \
+    BackupChunk *
+#define FUNCTION_LOG_BACKUP_CHUNK_FORMAT(value, buffer, bufferSize)                                                                \
+    FUNCTION_LOG_STRING_OBJECT_FORMAT(value, backupChunkToLog, buffer, bufferSize)
+
+#endif
@@ -0,0 +1,314 @@
+/***********************************************************************************************************************************
+Backup Pack
+***********************************************************************************************************************************/
+#include <inttypes.h>
+
+#include "command/backup/pack.h"
+#include "common/debug.h"
+#include "common/io/bufferWrite.h"
+#include "common/io/filter/group.h"
+#include "common/io/io.h"
+#include "common/log.h"
+#include "common/memContext.h"
+#include "crypto/helper.h"
+#include "storage/fileRead.h"
+#include "storage/fileWrite.h"
+
+/***********************************************************************************************************************************
+Index key constants
+***********************************************************************************************************************************/
+STRING_EXTERN(BACKUP_PACK_KEY_OFFSET_STR,                           BACKUP_PACK_KEY_OFFSET);
+STRING_EXTERN(BACKUP_PACK_KEY_SIZE_STR,                             BACKUP_PACK_KEY_SIZE);
+
+/***********************************************************************************************************************************
+Object type
+***********************************************************************************************************************************/
+struct BackupPack
+{
+    MemContext *memContext;                                         // Mem context of pack
+    const String *file;                                             // Name of the pack file
+    CompressType compressType;                                      // Compression type of files in the pack
+    int compressLevel;                                              // Compression level of files in the pack
+    CipherType cipherType;                                          // Cipher type of files in the pack
+    const String *cipherPass;                                       // Cipher passphrase (when cipher type is not none)
+
+    StorageFileWrite *write;                                        // Pack file write
+    uint64_t size;                                                  // Size of the pack written so far
+    KeyValue *index;                                                // Offset and size of each file in the pack
+};
+
+/***********************************************************************************************************************************
+New object
+
+The pack is written atomically so it will not be visible until backupPackClose() is called.
+***********************************************************************************************************************************/
+BackupPack *
+backupPackNew(
+    const Storage *storage, const String *file, CompressType compressType, int compressLevel, CipherType cipherType,
+    const String *cipherPass)
+{
+    FUNCTION_LOG_BEGIN(logLevelDebug);
+        FUNCTION_LOG_PARAM(STORAGE, storage);
+        FUNCTION_LOG_PARAM(STRING, file);
+        FUNCTION_LOG_PARAM(ENUM, compressType);
+        FUNCTION_LOG_PARAM(INT, compressLevel);
+        FUNCTION_LOG_PARAM(ENUM, cipherType);
+        // cipherPass omitted for security
+    FUNCTION_LOG_END();
+
+    ASSERT(storage != NULL);
+    ASSERT(file != NULL);
+    ASSERT((cipherType == cipherTypeNone && cipherPass == NULL) || (cipherType != cipherTypeNone && cipherPass != NULL));
+
+    BackupPack *this = NULL;
+
+    MEM_CONTEXT_NEW_BEGIN("BackupPack")
+    {
+        this = memNew(sizeof(BackupPack));
+        this->memContext = MEM_CONTEXT_NEW();
+
+        this->file = strDup(file);
+        this->compressType = compressType;
+        this->compressLevel = compressLevel;
+        this->cipherType = cipherType;
+        this->cipherPass = strDup(cipherPass);
+        this->index = kvNew();
+
+        this->write = storageNewWriteNP(storage, file);
+        ioWriteOpen(storageFileWriteIo(this->write));
+    }
+    MEM_CONTEXT_NEW_END();
+
+    FUNCTION_LOG_RETURN(BACKUP_PACK, this);
+}
+
+/***********************************************************************************************************************************
+Run a buffer through a filter group and return the result
+***********************************************************************************************************************************/
+static Buffer *
+backupPackFilter(const Buffer *buffer, IoFilterGroup *filterGroup)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(BUFFER, buffer);
+        FUNCTION_TEST_PARAM(IO_FILTER_GROUP, filterGroup);
+    FUNCTION_TEST_END();
+
+    ASSERT(buffer != NULL);
+    ASSERT(filterGroup != NULL);
+
+    Buffer *result = bufNew(0);
+
+    MEM_CONTEXT_TEMP_BEGIN()
+    {
+        IoWrite *write = ioBufferWriteIo(ioBufferWriteNew(result));
+        ioWriteFilterGroupSet(write, filterGroup);
+        ioWriteOpen(write);
+        ioWrite(write, buffer);
+        ioWriteClose(write);
+    }
+    MEM_CONTEXT_TEMP_END();
+
+    FUNCTION_TEST_RETURN(result);
+}
+
+/***********************************************************************************************************************************
+Add a file to the pack
+***********************************************************************************************************************************/
+void
+backupPackAdd(BackupPack *this, const String *name, const Buffer *content)
+{
+    FUNCTION_LOG_BEGIN(logLevelDebug);
+        FUNCTION_LOG_PARAM(BACKUP_PACK, this);
+        FUNCTION_LOG_PARAM(STRING, name);
+        FUNCTION_LOG_PARAM(BUFFER, content);
+    FUNCTION_LOG_END();
+
+    ASSERT(this != NULL);
+    ASSERT(this->write != NULL);
+    ASSERT(name != NULL);
+    ASSERT(content != NULL);
+    ASSERT(!kvKeyExists(this->index, varNewStr(name)));
+
+    MEM_CONTEXT_TEMP_BEGIN()
+    {
+        // Compress and encrypt the file on its own so it can be read without reading the files before it
+        const Buffer *stored = content;
+
+        if (this->compressType != compressTypeNone || this->cipherType != cipherTypeNone)
+        {
+            IoFilterGroup *filterGroup = ioFilterGroupNew();
+
+            if (this->compressType != compressTypeNone)
+                ioFilterGroupAdd(filterGroup, compressFilter(this->compressType, this->compressLevel));
+
+            if (this->cipherType != cipherTypeNone)
+                ioFilterGroupAdd(filterGroup, cipherFilter(cipherModeEncrypt, this->cipherType, bufNewStr(this->cipherPass)));
+
+            stored = backupPackFilter(content, filterGroup);
+        }
+
+        ioWrite(storageFileWriteIo(this->write), stored);
+
+        MEM_CONTEXT_BEGIN(this->memContext)
+        {
+            KeyValue *entry = kvPutKv(this->index, varNewStr(name));
+            kvPut(entry, varNewStr(BACKUP_PACK_KEY_OFFSET_STR), varNewUInt64(this->size));
+            kvPut(entry, varNewStr(BACKUP_PACK_KEY_SIZE_STR), varNewUInt64(bufUsed(stored)));
+        }
+        MEM_CONTEXT_END();
+
+        this->size += bufUsed(stored);
+    }
+    MEM_CONTEXT_TEMP_END();
+
+    FUNCTION_LOG_RETURN_VOID();
+}
+
+/***********************************************************************************************************************************
+Close the pack so it is visible in storage.  No more files can be added.
+***********************************************************************************************************************************/
+void
+backupPackClose(BackupPack *this)
+{
+    FUNCTION_LOG_BEGIN(logLevelDebug);
+        FUNCTION_LOG_PARAM(BACKUP_PACK, this);
+    FUNCTION_LOG_END();
+
+    ASSERT(this != NULL);
+    ASSERT(this->write != NULL);
+
+    ioWriteClose(storageFileWriteIo(this->write));
+
+    MEM_CONTEXT_BEGIN(this->memContext)
+    {
+        storageFileWriteFree(this->write);
+    }
+    MEM_CONTEXT_END();
+
+    this->write = NULL;
+
+    FUNCTION_LOG_RETURN_VOID();
+}
+
+/***********************************************************************************************************************************
+Read a file from a pack using the offset and size from the pack index.  Only the file is read from storage, not the whole pack.
+***********************************************************************************************************************************/
+Buffer *
+backupPackGet(
+    const Storage *storage, const String *file, CompressType compressType, CipherType cipherType, const String *cipherPass,
+    uint64_t offset, uint64_t size)
+{
+    FUNCTION_LOG_BEGIN(logLevelDebug);
+        FUNCTION_LOG_PARAM(STORAGE, storage);
+        FUNCTION_LOG_PARAM(STRING, file);
+        FUNCTION_LOG_PARAM(ENUM, compressType);
+        FUNCTION_LOG_PARAM(ENUM, cipherType);
+        // cipherPass omitted for security
+        FUNCTION_LOG_PARAM(UINT64, offset);
+        FUNCTION_LOG_PARAM(UINT64, size);
+    FUNCTION_LOG_END();
+
+    ASSERT(storage != NULL);
+    ASSERT(file != NULL);
+    ASSERT((cipherType == cipherTypeNone && cipherPass == NULL) || (cipherType != cipherTypeNone && cipherPass != NULL));
+
+    Buffer *result = NULL;
+
+    MEM_CONTEXT_TEMP_BEGIN()
+    {
+        // Read the file.  An empty file can only be stored uncompressed and unencrypted and there is nothing to read.
+        Buffer *stored = bufNew((size_t)size);
+
+        if (size > 0)
+        {
+            IoRead *read = storageFileReadIo(storageNewReadP(storage, file, .offset = offset, .limit = varNewUInt64(size)));
+            ioReadOpen(read);
+            ioRead(read, stored);
+
+            if (bufUsed(stored) != size)
+            {
+                THROW_FMT(
+                    FileReadError, "unable to read %" PRIu64 " byte(s) at offset %" PRIu64 " from '%s'", size, offset,
+                    strPtr(file));
+            }
+
+            ioReadClose(read);
+        }
+
+        // Decrypt and decompress the file
+        if (compressType != compressTypeNone || cipherType != cipherTypeNone)
+        {
+            IoFilterGroup *filterGroup = ioFilterGroupNew();
+
+            if (cipherType != cipherTypeNone)
+                ioFilterGroupAdd(filterGroup, cipherFilter(cipherModeDecrypt, cipherType, bufNewStr(cipherPass)));
+
+            if (compressType != compressTypeNone)
+                ioFilterGroupAdd(filterGroup, decompressFilter(compressType));
+
+            stored = backupPackFilter(stored, filterGroup);
+        }
+
+        bufMove(stored, MEM_CONTEXT_OLD());
+        result = stored;
+    }
+    MEM_CONTEXT_TEMP_END();
+
+    FUNCTION_LOG_RETURN(BUFFER, result);
+}
+
+/***********************************************************************************************************************************
+Get the pack index
+***********************************************************************************************************************************/
+const KeyValue *
+backupPackIndex(const BackupPack *this)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(BACKUP_PACK, this);
+    FUNCTION_TEST_END();
+
+    ASSERT(this != NULL);
+
+    FUNCTION_TEST_RETURN(this->index);
+}
+
+/***********************************************************************************************************************************
+Get the size of the pack written so far
+***********************************************************************************************************************************/
+uint64_t
+backupPackSize(const BackupPack *this)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(BACKUP_PACK, this);
+    FUNCTION_TEST_END();
+
+    ASSERT(this != NULL);
+
+    FUNCTION_TEST_RETURN(this->size);
+}
+
+/***********************************************************************************************************************************
+Render as string for logging
+***********************************************************************************************************************************/
+String *
+backupPackToLog(const BackupPack *this)
+{
+    return strNewFmt(
+        "{file: %s, fileTotal: %u, size: %" PRIu64 "}", strPtr(this->file), varLstSize(kvKeyList(this->index)), this->size);
+}
+
+/***********************************************************************************************************************************
+Free the pack.  If the pack has not been closed then it will not be visible in storage.
+***********************************************************************************************************************************/
+void
+backupPackFree(BackupPack *this)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(BACKUP_PACK, this);
+    FUNCTION_LOG_END();
+
+    if (this != NULL)
+        memContextFree(this->memContext);
+
+    FUNCTION_LOG_RETURN_VOID();
+}
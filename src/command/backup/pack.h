@@ -0,0 +1,82 @@
+/***********************************************************************************************************************************
+Backup Pack
+
+Small files cost more in per-file overhead (open/close, object requests on object stores, manifest checksums) than in the time spent
+copying their contents, so files below BACKUP_PACK_FILE_SIZE_MAX are bundled into pack files instead of being stored individually.
+Each file is compressed and encrypted independently before it is appended to the pack, so any file can be read back on its own with
+backupPackGet() using the offset and size recorded in the pack index.
+
+The pack index is a KeyValue of file name to a KeyValue containing the offset and size of the (compressed) file in the pack.  It is
+stored in the manifest with the file entries.
+***********************************************************************************************************************************/
+#ifndef COMMAND_BACKUP_PACK_H
+#define COMMAND_BACKUP_PACK_H
+
+/***********************************************************************************************************************************
+Object type
+***********************************************************************************************************************************/
+typedef struct BackupPack BackupPack;
+
+#include "common/type/buffer.h"
+#include "common/type/keyValue.h"
+#include "compress/helper.h"
+#include "crypto/crypto.h"
+#include "storage/storage.h"
+
+/***********************************************************************************************************************************
+Index keys
+***********************************************************************************************************************************/
+#define BACKUP_PACK_KEY_OFFSET                                      "offset"
+    STRING_DECLARE(BACKUP_PACK_KEY_OFFSET_STR);
+#define BACKUP_PACK_KEY_SIZE                                        "size"
+    STRING_DECLARE(BACKUP_PACK_KEY_SIZE_STR);
+
+/***********************************************************************************************************************************
+Constants
+***********************************************************************************************************************************/
+// Files smaller than this are stored in pack files
+#define BACKUP_PACK_FILE_SIZE_MAX                                   ((uint64_t)64 * 1024)
+
+// A pack is closed and a new one started once it reaches this size
+#define BACKUP_PACK_SIZE_DEFAULT                                    ((uint64_t)16 * 1024 * 1024)
+
+/***********************************************************************************************************************************
+Constructor
+***********************************************************************************************************************************/
+BackupPack *backupPackNew(
+    const Storage *storage, const String *file, CompressType compressType, int compressLevel, CipherType cipherType,
+    const String *cipherPass);
+
+/***********************************************************************************************************************************
+Functions
+***********************************************************************************************************************************/
+void backupPackAdd(BackupPack *this, const String *name, const Buffer *content);
+void backupPackClose(BackupPack *this);
+
+// Read a file from a pack
+Buffer *backupPackGet(
+    const Storage *storage, const String *file, CompressType compressType, CipherType cipherType, const String *cipherPass,
+    uint64_t offset, uint64_t size);
+
+/***********************************************************************************************************************************
+Getters
+***********************************************************************************************************************************/
+const KeyValue *backupPackIndex(const BackupPack *this);
+uint64_t backupPackSize(const BackupPack *this);
+
+/***********************************************************************************************************************************
+Destructor
+***********************************************************************************************************************************/
+void backupPackFree(BackupPack *this);
+
+/***********************************************************************************************************************************
+Macros for function logging
+***********************************************************************************************************************************/
+String *backupPackToLog(const BackupPack *this);
+
+#define FUNCTION_LOG_BACKUP_PACK_TYPE                                                                                              \
+    BackupPack *
+#define FUNCTION_LOG_BACKUP_PACK_FORMAT(value, buffer, bufferSize)                                                                 \
+    FUNCTION_LOG_STRING_OBJECT_FORMAT(value, backupPackToLog, buffer, bufferSize)
+
+#endif
@@ -0,0 +1,262 @@
+/***********************************************************************************************************************************
+Backup Page Checksum Filter
+***********************************************************************************************************************************/
+#include "command/backup/pageChecksum.h"
+#include "common/debug.h"
+#include "common/io/filter/filter.intern.h"
+#include "common/log.h"
+#include "common/memContext.h"
+#include "common/type/keyValue.h"
+#include "common/type/variantList.h"
+#include "postgres/pageChecksum.h"
+
+/***********************************************************************************************************************************
+Filter type and result key constants
+***********************************************************************************************************************************/
+STRING_EXTERN(PAGE_CHECKSUM_FILTER_TYPE_STR,                        PAGE_CHECKSUM_FILTER_TYPE);
+
+STRING_EXTERN(PAGE_CHECKSUM_KEY_ALIGN_STR,                          PAGE_CHECKSUM_KEY_ALIGN);
+STRING_EXTERN(PAGE_CHECKSUM_KEY_ERROR_STR,                          PAGE_CHECKSUM_KEY_ERROR);
+STRING_EXTERN(PAGE_CHECKSUM_KEY_VALID_STR,                          PAGE_CHECKSUM_KEY_VALID);
+
+/***********************************************************************************************************************************
+Object type
+***********************************************************************************************************************************/
+struct PageChecksum
+{
+    MemContext *memContext;                                         // Mem context of filter
+    IoFilter *filter;                                               // Filter interface
+
+    unsigned int pageSize;                                          // Page size
+    unsigned int blockNoBegin;                                      // Block number of the first page in the segment
+    uint32_t ignoreWalId;                                           // Ignore pages with a WAL id >= this value
+    uint32_t ignoreWalOffset;                                       // Ignore pages with a WAL offset >= this value (when id is equal)
+
+    unsigned int pageTotal;                                         // Total pages checked so far
+    bool valid;                                                     // Are all pages valid?
+    bool align;                                                     // Is the input aligned on page boundaries?
+
+    VariantList *error;                                             // List of invalid blocks and ranges of invalid blocks
+    bool errorRun;                                                  // Is there a run of invalid blocks that has not been added?
+    unsigned int errorBlockBegin;                                   // First block of the current run
+    unsigned int errorBlockEnd;                                     // Last block of the current run
+};
+
+/***********************************************************************************************************************************
+New object
+***********************************************************************************************************************************/
+PageChecksum *
+pageChecksumNew(
+    unsigned int segmentNo, unsigned int segmentPageTotal, unsigned int pageSize, uint32_t ignoreWalId, uint32_t ignoreWalOffset)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(UINT, segmentNo);
+        FUNCTION_LOG_PARAM(UINT, segmentPageTotal);
+        FUNCTION_LOG_PARAM(UINT, pageSize);
+        FUNCTION_LOG_PARAM(UINT32, ignoreWalId);
+        FUNCTION_LOG_PARAM(UINT32, ignoreWalOffset);
+    FUNCTION_LOG_END();
+
+    ASSERT(segmentPageTotal > 0);
+    ASSERT(pageSize > 0);
+
+    PageChecksum *this = NULL;
+
+    MEM_CONTEXT_NEW_BEGIN("PageChecksum")
+    {
+        this = memNew(sizeof(PageChecksum));
+        this->memContext = memContextCurrent();
+
+        this->pageSize = pageSize;
+        this->blockNoBegin = segmentNo * segmentPageTotal;
+        this->ignoreWalId = ignoreWalId;
+        this->ignoreWalOffset = ignoreWalOffset;
+
+        this->valid = true;
+        this->align = true;
+
+        // Create filter interface
+        this->filter = ioFilterNewP(
+            PAGE_CHECKSUM_FILTER_TYPE_STR, this, .in = (IoFilterInterfaceProcessIn)pageChecksumProcess,
+            .result = (IoFilterInterfaceResult)pageChecksumResult);
+    }
+    MEM_CONTEXT_NEW_END();
+
+    FUNCTION_LOG_RETURN(PAGE_CHECKSUM, this);
+}
+
+/***********************************************************************************************************************************
+Add the current run of invalid blocks to the error list as a single block or a [begin, end] range
+***********************************************************************************************************************************/
+static void
+pageChecksumErrorRunAdd(PageChecksum *this)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(PAGE_CHECKSUM, this);
+    FUNCTION_TEST_END();
+
+    ASSERT(this != NULL);
+    ASSERT(this->errorRun);
+
+    MEM_CONTEXT_BEGIN(this->memContext)
+    {
+        if (this->error == NULL)
+            this->error = varLstNew();
+
+        if (this->errorBlockBegin == this->errorBlockEnd)
+            varLstAdd(this->error, varNewUInt64(this->errorBlockBegin));
+        else
+        {
+            VariantList *range = varLstNew();
+            varLstAdd(range, varNewUInt64(this->errorBlockBegin));
+            varLstAdd(range, varNewUInt64(this->errorBlockEnd));
+
+            varLstAdd(this->error, varNewVarLst(range));
+            varLstFree(range);
+        }
+    }
+    MEM_CONTEXT_END();
+
+    this->errorRun = false;
+
+    FUNCTION_TEST_RETURN_VOID();
+}
+
+/***********************************************************************************************************************************
+Check the checksum of each page in the input
+***********************************************************************************************************************************/
+void
+pageChecksumProcess(PageChecksum *this, const Buffer *input)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(PAGE_CHECKSUM, this);
+        FUNCTION_LOG_PARAM(BUFFER, input);
+    FUNCTION_LOG_END();
+
+    ASSERT(this != NULL);
+    ASSERT(input != NULL);
+
+    // Only the last buffer of a file may be misaligned, e.g. when the file is truncated while being copied
+    if (!this->align)
+        THROW(AssertError, "should not be possible to see two misaligned pages in a row");
+
+    // If the buffer is not divisible by the page size then the file is not valid and errors for individual pages are meaningless
+    if (bufUsed(input) % this->pageSize != 0)
+    {
+        this->valid = false;
+        this->align = false;
+        this->errorRun = false;
+
+        varLstFree(this->error);
+        this->error = NULL;
+    }
+    else
+    {
+        unsigned int pageTotal = (unsigned int)(bufUsed(input) / this->pageSize);
+
+        for (unsigned int pageIdx = 0; pageIdx < pageTotal; pageIdx++)
+        {
+            unsigned int blockNo = this->blockNoBegin + this->pageTotal + pageIdx;
+
+            if (!pageChecksumTest(
+                    bufPtr(input) + pageIdx * this->pageSize, blockNo, this->pageSize, this->ignoreWalId, this->ignoreWalOffset))
+            {
+                this->valid = false;
+
+                // Extend the current run when the block follows it, else start a new run
+                if (this->errorRun && this->errorBlockEnd == blockNo - 1)
+                    this->errorBlockEnd = blockNo;
+                else
+                {
+                    if (this->errorRun)
+                        pageChecksumErrorRunAdd(this);
+
+                    this->errorRun = true;
+                    this->errorBlockBegin = blockNo;
+                    this->errorBlockEnd = blockNo;
+                }
+            }
+        }
+
+        this->pageTotal += pageTotal;
+    }
+
+    FUNCTION_LOG_RETURN_VOID();
+}
+
+/***********************************************************************************************************************************
+Get filter interface
+***********************************************************************************************************************************/
+IoFilter *
+pageChecksumFilter(const PageChecksum *this)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(PAGE_CHECKSUM, this);
+    FUNCTION_TEST_END();
+
+    ASSERT(this != NULL);
+
+    FUNCTION_TEST_RETURN(this->filter);
+}
+
+/***********************************************************************************************************************************
+Return filter result
+
+The result is a KeyValue with the same layout as the Perl filter, i.e. valid, align, and (when there are errors and the input was
+aligned) a list of invalid blocks where runs of consecutive blocks are represented as [begin, end] lists.
+***********************************************************************************************************************************/
+const Variant *
+pageChecksumResult(PageChecksum *this)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(PAGE_CHECKSUM, this);
+    FUNCTION_LOG_END();
+
+    ASSERT(this != NULL);
+
+    Variant *result = NULL;
+
+    // Add the final run of invalid blocks
+    if (this->errorRun)
+        pageChecksumErrorRunAdd(this);
+
+    MEM_CONTEXT_BEGIN(this->memContext)
+    {
+        result = varNewKv();
+
+        kvPut(varKv(result), varNewStr(PAGE_CHECKSUM_KEY_VALID_STR), varNewBool(this->valid));
+        kvPut(varKv(result), varNewStr(PAGE_CHECKSUM_KEY_ALIGN_STR), varNewBool(this->align));
+
+        if (this->error != NULL)
+            kvPut(varKv(result), varNewStr(PAGE_CHECKSUM_KEY_ERROR_STR), varNewVarLst(this->error));
+    }
+    MEM_CONTEXT_END();
+
+    FUNCTION_LOG_RETURN(VARIANT, result);
+}
+
+/***********************************************************************************************************************************
+Render as string for logging
+***********************************************************************************************************************************/
+String *
+pageChecksumToLog(const PageChecksum *this)
+{
+    return strNewFmt(
+        "{pageTotal: %u, valid: %s, align: %s}", this->pageTotal, cvtBoolToConstZ(this->valid), cvtBoolToConstZ(this->align));
+}
+
+/***********************************************************************************************************************************
+Free the filter
+***********************************************************************************************************************************/
+void
+pageChecksumFree(PageChecksum *this)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(PAGE_CHECKSUM, this);
+    FUNCTION_LOG_END();
+
+    if (this != NULL)
+        memContextFree(this->memContext);
+
+    FUNCTION_LOG_RETURN_VOID();
+}
@@ -0,0 +1,66 @@
+/***********************************************************************************************************************************
+Backup Page Checksum Filter
+
+Check the page checksums of a PostgreSQL relation file as it passes through a filter group.  Pages that fail are reported by block
+number in the filter result, with runs of consecutive blocks collapsed into ranges.
+***********************************************************************************************************************************/
+#ifndef COMMAND_BACKUP_PAGECHECKSUM_H
+#define COMMAND_BACKUP_PAGECHECKSUM_H
+
+/***********************************************************************************************************************************
+Object type
+***********************************************************************************************************************************/
+typedef struct PageChecksum PageChecksum;
+
+#include "common/io/filter/filter.h"
+#include "common/type/buffer.h"
+
+/***********************************************************************************************************************************
+Filter type constant
+***********************************************************************************************************************************/
+#define PAGE_CHECKSUM_FILTER_TYPE                                   "pgBackRest::Backup::Filter::PageChecksum"
+    STRING_DECLARE(PAGE_CHECKSUM_FILTER_TYPE_STR);
+
+/***********************************************************************************************************************************
+Result keys
+***********************************************************************************************************************************/
+#define PAGE_CHECKSUM_KEY_ALIGN                                     "align"
+    STRING_DECLARE(PAGE_CHECKSUM_KEY_ALIGN_STR);
+#define PAGE_CHECKSUM_KEY_ERROR                                     "error"
+    STRING_DECLARE(PAGE_CHECKSUM_KEY_ERROR_STR);
+#define PAGE_CHECKSUM_KEY_VALID                                     "valid"
+    STRING_DECLARE(PAGE_CHECKSUM_KEY_VALID_STR);
+
+/***********************************************************************************************************************************
+Constructor
+***********************************************************************************************************************************/
+PageChecksum *pageChecksumNew(
+    unsigned int segmentNo, unsigned int segmentPageTotal, unsigned int pageSize, uint32_t ignoreWalId, uint32_t ignoreWalOffset);
+
+/***********************************************************************************************************************************
+Functions
+***********************************************************************************************************************************/
+void pageChecksumProcess(PageChecksum *this, const Buffer *input);
+
+/***********************************************************************************************************************************
+Getters
+***********************************************************************************************************************************/
+IoFilter *pageChecksumFilter(const PageChecksum *this);
+const Variant *pageChecksumResult(PageChecksum *this);
+
+/***********************************************************************************************************************************
+Destructor
+***********************************************************************************************************************************/
+void pageChecksumFree(PageChecksum *this);
+
+/***********************************************************************************************************************************
+Macros for function logging
+***********************************************************************************************************************************/
+String *pageChecksumToLog(const PageChecksum *this);
+
+#define FUNCTION_LOG_PAGE_CHECKSUM_TYPE                                                                                            \
+    PageChecksum *
+#define FUNCTION_LOG_PAGE_CHECKSUM_FORMAT(value, buffer, bufferSize)                                                               \
+    FUNCTION_LOG_STRING_OBJECT_FORMAT(value, pageChecksumToLog, buffer, bufferSize)
+
+#endif
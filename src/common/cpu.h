@@ -0,0 +1,15 @@
+/***********************************************************************************************************************************
+CPU Features
+
+Vector implementations on x86-64 use the target attribute to compile functions for instruction sets not enabled for the rest of the
+build and __builtin_cpu_supports() to select the best function at runtime.  GCC 4.9 has both but does not recognize "avx512f" in
+__builtin_cpu_supports() so GCC >= 5 is required.  Other compilers and architectures use the portable implementations.
+***********************************************************************************************************************************/
+#ifndef COMMON_CPU_H
+#define COMMON_CPU_H
+
+#if defined(__x86_64__) && defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 5
+    #define CPU_X86_VECTOR
+#endif
+
+#endif
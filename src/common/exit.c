@@ -11,6 +11,7 @@ Exit Routines
 #include "common/lock.h"
 #include "common/log.h"
 #include "config/config.h"
+#include "crypto/cipherGcm.h"
 #include "protocol/helper.h"
 
 #ifdef WITH_PERL
@@ -148,6 +149,9 @@ exitSafe(int result, bool error, SignalType signalType)
     }
     TRY_END();
 
+    // Cleanse cached keys
+    cipherGcmKeyCacheClear();
+
     // Free Perl but ignore errors
 #ifdef WITH_PERL
     TRY_BEGIN()
@@ -6,6 +6,8 @@ Ini Handler
 #include <string.h>
 
 #include "common/debug.h"
+#include "common/io/bufferRead.h"
+#include "common/io/io.h"
 #include "common/memContext.h"
 #include "common/ini.h"
 #include "common/type/keyValue.h"
@@ -188,6 +190,160 @@ iniSectionList(const Ini *this)
     FUNCTION_TEST_RETURN(result);
 }
 
+/***********************************************************************************************************************************
+Is the character whitespace?  Matches the characters removed by strTrim() except linefeed, which never appears inside a line.
+***********************************************************************************************************************************/
+#define INI_WHITESPACE(c)                                                                                                          \
+    ((c) == ' ' || (c) == '\t' || (c) == '\r')
+
+/***********************************************************************************************************************************
+Load ini from an IoRead and pass each section/key/value to a callback
+
+Content is read in chunks and each line is parsed in place, so the key and value passed to the callback are views into the read
+buffer that are only valid until the callback returns.  Nothing is copied except a line split across reads, which is moved to the
+beginning of the buffer before the next read.  The buffer is grown if a single line does not fit.
+***********************************************************************************************************************************/
+void
+iniLoad(IoRead *read, IniLoadCallback callbackFunction, void *callbackData)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(IO_READ, read);
+        FUNCTION_TEST_PARAM(FUNCTIONP, callbackFunction);
+        FUNCTION_TEST_PARAM_P(VOID, callbackData);
+    FUNCTION_TEST_END();
+
+    ASSERT(read != NULL);
+    ASSERT(callbackFunction != NULL);
+
+    MEM_CONTEXT_TEMP_BEGIN()
+    {
+        Buffer *buffer = bufNew(ioBufferSize());
+        String *section = NULL;
+        unsigned int lineIdx = 0;
+        bool eof = false;
+
+        ioReadOpen(read);
+
+        do
+        {
+            // Grow the buffer when the partial line left from the last read fills it
+            if (bufRemains(buffer) == 0)
+                bufResize(buffer, bufSize(buffer) * 2);
+
+            ioRead(read, buffer);
+            eof = ioReadEof(read);
+
+            // Terminate the last line with a linefeed so it is parsed like the others
+            if (eof && bufUsed(buffer) > 0 && bufPtr(buffer)[bufUsed(buffer) - 1] != '\n')
+                bufCatC(buffer, (const unsigned char *)"\n", 0, 1);
+
+            // Parse all complete lines in the buffer
+            char *bufferEnd = (char *)bufPtr(buffer) + bufUsed(buffer);
+            char *lineBegin = (char *)bufPtr(buffer);
+            char *lineEnd = NULL;
+
+            while ((lineEnd = memchr(lineBegin, '\n', (size_t)(bufferEnd - lineBegin))) != NULL)
+            {
+                char *linePtr = lineBegin;
+                lineBegin = lineEnd + 1;
+                lineIdx++;
+
+                // Trim the line and terminate it in place
+                while (linePtr < lineEnd && INI_WHITESPACE(*linePtr))
+                    linePtr++;
+
+                while (lineEnd > linePtr && INI_WHITESPACE(lineEnd[-1]))
+                    lineEnd--;
+
+                *lineEnd = 0;
+
+                // Only interested in lines that are not blank or comments
+                if (linePtr == lineEnd || linePtr[0] == '#')
+                    continue;
+
+                // Looks like this line is a section
+                if (linePtr[0] == '[')
+                {
+                    // Make sure the section ends with ]
+                    if (lineEnd[-1] != ']')
+                        THROW_FMT(FormatError, "ini section should end with ] at line %u: %s", lineIdx, linePtr);
+
+                    // Assign section
+                    strFree(section);
+                    section = strNewN(linePtr + 1, (size_t)(lineEnd - linePtr) - 2);
+                }
+                // Else it should be a key/value
+                else
+                {
+                    if (section == NULL)
+                        THROW_FMT(FormatError, "key/value found outside of section at line %u: %s", lineIdx, linePtr);
+
+                    // Find the =
+                    char *lineEqual = strchr(linePtr, '=');
+
+                    if (lineEqual == NULL)
+                        THROW_FMT(FormatError, "missing '=' in key/value at line %u: %s", lineIdx, linePtr);
+
+                    // Extract the key
+                    char *keyEnd = lineEqual;
+
+                    while (keyEnd > linePtr && INI_WHITESPACE(keyEnd[-1]))
+                        keyEnd--;
+
+                    if (keyEnd == linePtr)
+                        THROW_FMT(FormatError, "key is zero-length at line %u: %s", lineIdx, linePtr);
+
+                    *keyEnd = 0;
+
+                    // Extract the value
+                    char *valuePtr = lineEqual + 1;
+
+                    while (valuePtr < lineEnd && INI_WHITESPACE(*valuePtr))
+                        valuePtr++;
+
+                    // Pass views of the key and value to the callback
+                    const struct StringCommon key = {.size = (unsigned int)(keyEnd - linePtr), .buffer = linePtr};
+                    const struct StringCommon value = {.size = (unsigned int)(lineEnd - valuePtr), .buffer = valuePtr};
+
+                    callbackFunction(callbackData, section, (const String *)&key, (const String *)&value);
+                }
+            }
+
+            // Move the partial line to the beginning of the buffer so the rest of it can be read
+            size_t remains = (size_t)(bufferEnd - lineBegin);
+
+            memmove(bufPtr(buffer), lineBegin, remains);
+            bufUsedSet(buffer, remains);
+        }
+        while (!eof);
+
+        ioReadClose(read);
+    }
+    MEM_CONTEXT_TEMP_END();
+
+    FUNCTION_TEST_RETURN_VOID();
+}
+
+/***********************************************************************************************************************************
+Store each key/value loaded by iniParse()
+***********************************************************************************************************************************/
+static void
+iniParseCallback(void *data, const String *section, const String *key, const String *value)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM_P(VOID, data);
+        FUNCTION_TEST_PARAM(STRING, section);
+        FUNCTION_TEST_PARAM(STRING, key);
+        FUNCTION_TEST_PARAM(STRING, value);
+    FUNCTION_TEST_END();
+
+    ASSERT(data != NULL);
+
+    iniSet((Ini *)data, section, key, varNewStr(value));
+
+    FUNCTION_TEST_RETURN_VOID();
+}
+
 /***********************************************************************************************************************************
 Parse ini from a string
 ***********************************************************************************************************************************/
@@ -210,57 +366,7 @@ iniParse(Ini *this, const String *content)
         {
             MEM_CONTEXT_TEMP_BEGIN()
             {
-                // Track the current section
-                String *section = NULL;
-
-                // Split the content into lines and loop
-                StringList *lines = strLstNewSplitZ(content, "\n");
-
-                for (unsigned int lineIdx = 0; lineIdx < strLstSize(lines); lineIdx++)
-                {
-                    // Get next line
-                    const String *line = strTrim(strLstGet(lines, lineIdx));
-                    const char *linePtr = strPtr(line);
-
-                    // Only interested in lines that are not blank or comments
-                    if (strSize(line) > 0 && linePtr[0] != '#')
-                    {
-                        // Looks like this line is a section
-                        if (linePtr[0] == '[')
-                        {
-                            // Make sure the section ends with ]
-                            if (linePtr[strSize(line) - 1] != ']')
-                                THROW_FMT(FormatError, "ini section should end with ] at line %u: %s", lineIdx + 1, linePtr);
-
-                            // Assign section
-                            section = strNewN(linePtr + 1, strSize(line) - 2);
-                        }
-                        // Else it should be a key/value
-                        else
-                        {
-                            if (section == NULL)
-                                THROW_FMT(FormatError, "key/value found outside of section at line %u: %s", lineIdx + 1, linePtr);
-
-                            // Find the =
-                            const char *lineEqual = strstr(linePtr, "=");
-
-                            if (lineEqual == NULL)
-                                THROW_FMT(FormatError, "missing '=' in key/value at line %u: %s", lineIdx + 1, linePtr);
-
-                            // Extract the key
-                            String *key = strTrim(strNewN(linePtr, (size_t)(lineEqual - linePtr)));
-
-                            if (strSize(key) == 0)
-                                THROW_FMT(FormatError, "key is zero-length at line %u: %s", lineIdx++, linePtr);
-
-                            // Extract the value
-                            Variant *value = varNewStr(strTrim(strNew(lineEqual + 1)));
-
-                            // Store the section/key/value
-                            iniSet(this, section, key, value);
-                        }
-                    }
-                }
+                iniLoad(ioBufferReadIo(ioBufferReadNew(bufNewStr(content))), iniParseCallback, this);
             }
             MEM_CONTEXT_TEMP_END();
         }
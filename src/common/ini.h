@@ -9,8 +9,14 @@ Ini object
 ***********************************************************************************************************************************/
 typedef struct Ini Ini;
 
+#include "common/io/read.h"
 #include "common/type/variant.h"
 
+/***********************************************************************************************************************************
+Callback for iniLoad().  The key and value are only valid until the callback returns so they must be copied if they are kept.
+***********************************************************************************************************************************/
+typedef void (*IniLoadCallback)(void *data, const String *section, const String *key, const String *value);
+
 /***********************************************************************************************************************************
 Functions
 ***********************************************************************************************************************************/
@@ -19,6 +25,7 @@ const Variant *iniGet(const Ini *this, const String *section, const String *key)
 const Variant *iniGetDefault(const Ini *this, const String *section, const String *key, Variant *defaultValue);
 StringList *iniSectionKeyList(const Ini *this, const String *section);
 StringList *iniSectionList(const Ini *this);
+void iniLoad(IoRead *read, IniLoadCallback callbackFunction, void *callbackData);
 void iniParse(Ini *this, const String *content);
 void iniSet(Ini *this, const String *section, const String *key, const Variant *value);
 void iniFree(Ini *this);
@@ -15,7 +15,9 @@ IO Filter Group
 /***********************************************************************************************************************************
 Filter and buffer structure
 
-Contains the filter object and inout/output buffers.
+Contains the filter object and inout/output buffers.  The inputSame and done state of the filter is cached so the group does not
+need to query every filter after each call to ioFilterGroupProcess().  The state can only change when the filter is processed so
+the cache is updated at that time.
 ***********************************************************************************************************************************/
 typedef struct IoFilterData
 {
@@ -23,6 +25,8 @@ typedef struct IoFilterData
     Buffer *inputLocal;                                             // Non-null if a locally created buffer that can be cleared
     IoFilter *filter;                                               // Filter to apply
     Buffer *output;                                                 // Output buffer for filter
+    bool inputSame;                                                 // Does the filter need the same input again?
+    bool done;                                                      // Is the filter done?
 } IoFilterData;
 
 // Macros for logging
@@ -39,6 +43,10 @@ struct IoFilterGroup
     MemContext *memContext;                                         // Mem context
     List *filterList;                                               // List of filters to apply
     unsigned int firstOutputFilter;                                 // Index of the first output filter
+    unsigned int lastOutputFilter;                                  // Index of the last output filter
+    Buffer *outputNew;                                              // Output written by the last output filter (for input filters)
+    unsigned int inputSameTotal;                                    // Total filters that need the same input again
+    unsigned int notDoneTotal;                                      // Total filters that are not done
     KeyValue *filterResult;                                         // Filter results (if any)
     bool inputSame;                                                 // Same input required again?
     bool done;                                                      // Is processing done?
@@ -113,10 +121,56 @@ ioFilterGroupGet(IoFilterGroup *this, unsigned int filterIdx)
     FUNCTION_TEST_RETURN((IoFilterData *)lstGet(this->filterList, filterIdx));
 }
 
+/***********************************************************************************************************************************
+Update the cached state of a filter after it has been processed
+***********************************************************************************************************************************/
+static void
+ioFilterGroupStateUpdate(IoFilterGroup *this, IoFilterData *filterData)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(IO_FILTER_GROUP, this);
+        FUNCTION_TEST_PARAM(IO_FILTER_DATA, filterData);
+    FUNCTION_TEST_END();
+
+    ASSERT(this != NULL);
+    ASSERT(filterData != NULL);
+
+    bool inputSame = ioFilterInputSame(filterData->filter);
+
+    if (inputSame != filterData->inputSame)
+    {
+        if (inputSame)
+            this->inputSameTotal++;
+        else
+            this->inputSameTotal--;
+
+        filterData->inputSame = inputSame;
+    }
+
+    bool done = ioFilterDone(filterData->filter);
+
+    if (done != filterData->done)
+    {
+        if (done)
+            this->notDoneTotal--;
+        else
+            this->notDoneTotal++;
+
+        filterData->done = done;
+    }
+
+    FUNCTION_TEST_RETURN_VOID();
+}
+
 /***********************************************************************************************************************************
 Open filter group
 
 Setup the filter group and allocate any required buffers.
+
+Filters that do not produce output (e.g. hash and size) observe the buffer they are given in place.  Input filters after the last
+output filter observe the data written to the caller's output buffer so no buffer filter is required to copy the data to the output
+buffer.  Note that the size of the data they see depends on the space available in the output buffer.  Output filters write
+directly into the input buffer of the next output filter so no data is copied between them.
 ***********************************************************************************************************************************/
 void
 ioFilterGroupOpen(IoFilterGroup *this)
@@ -129,10 +183,29 @@ ioFilterGroupOpen(IoFilterGroup *this)
 
     MEM_CONTEXT_BEGIN(this->memContext)
     {
-        // If the last filter is not an output filter then add a filter to buffer/copy data.  Input filters won't copy to an output
-        // buffer so we need some way to get the data to the output buffer.
-        if (lstSize(this->filterList) == 0 || !ioFilterOutput((ioFilterGroupGet(this, lstSize(this->filterList) - 1))->filter))
+        // Find the last output filter
+        bool outputFilter = false;
+
+        for (unsigned int filterIdx = 0; filterIdx < lstSize(this->filterList); filterIdx++)
+        {
+            if (ioFilterOutput(ioFilterGroupGet(this, filterIdx)->filter))
+            {
+                this->lastOutputFilter = filterIdx;
+                outputFilter = true;
+            }
+        }
+
+        // If there are no output filters then add a filter to buffer/copy data.  Input filters won't copy to an output buffer so we
+        // need some way to get the data to the output buffer.
+        if (!outputFilter)
+        {
             ioFilterGroupAdd(this, ioBufferFilter(ioBufferNew()));
+            this->lastOutputFilter = lstSize(this->filterList) - 1;
+        }
+
+        // Input filters after the last output filter see the data written to the output buffer by the last output filter
+        if (this->lastOutputFilter < lstSize(this->filterList) - 1)
+            this->outputNew = bufNewUseC(NULL, 0);
 
         // Create filter input/output buffers.  Input filters do not get an output buffer since they don't produce output.
         Buffer *lastOutputBuffer = NULL;
@@ -143,7 +216,9 @@ ioFilterGroupOpen(IoFilterGroup *this)
 
             // Assign the last output buffer to the input.  At first there won't be an input filter because it will be passed into
             // the process function as an input.
-            if (lastOutputBuffer != NULL)
+            if (filterIdx > this->lastOutputFilter)
+                filterData->input = this->outputNew;
+            else if (lastOutputBuffer != NULL)
             {
                 filterData->input = lastOutputBuffer;
                 filterData->inputLocal = lastOutputBuffer;
@@ -158,12 +233,19 @@ ioFilterGroupOpen(IoFilterGroup *this)
 
                 // If this is not the last output filter then create a new output buffer for it.  The output buffer for the last
                 // filter will be provided to the process function.
-                if (filterIdx < lstSize(this->filterList) - 1)
+                if (filterIdx < this->lastOutputFilter)
                 {
                     lastOutputBuffer = bufNew(ioBufferSize());
                     filterData->output = lastOutputBuffer;
                 }
+
+                // Initialize the cached state of the filter
+                this->notDoneTotal++;
+                ioFilterGroupStateUpdate(this, filterData);
             }
+            // Else input filters never need the same input and are always done
+            else
+                filterData->done = true;
         }
     }
     MEM_CONTEXT_END();
@@ -208,39 +290,28 @@ ioFilterGroupProcess(IoFilterGroup *this, const Buffer *input, Buffer *output)
     }
 
     // Assign the output buffer
-    (ioFilterGroupGet(this, lstSize(this->filterList) - 1))->output = output;
+    IoFilterData *lastOutputData = ioFilterGroupGet(this, this->lastOutputFilter);
+    lastOutputData->output = output;
 
-    //
     do
     {
         // Start from the first filter by default
         unsigned int filterIdx = 0;
 
-        // Search from the end of the list for a filter that needs the same input.  This indicates that the filter was not able to
-        // empty the input buffer on the last call.  Maybe it won't this time either -- we can but try.
+        // Else start from the last filter that needs the same input.  This indicates that the filter was not able to empty the
+        // input buffer on the last call.  Maybe it won't this time either -- we can but try.
         if (this->inputSame)
         {
-            this->inputSame = false;
-            filterIdx = lstSize(this->filterList);
+            filterIdx = this->lastOutputFilter;
 
-            do
-            {
+            while (!ioFilterGroupGet(this, filterIdx)->inputSame)
                 filterIdx--;
-
-                if (ioFilterInputSame((ioFilterGroupGet(this, filterIdx))->filter))
-                {
-                    this->inputSame = true;
-                    break;
-                }
-            }
-            while (filterIdx != this->firstOutputFilter);
-
-            // If no filter is found that needs the same input that means we are done with the current input.  So end the loop and
-            // get some more input.
-            if (!this->inputSame)
-                break;
         }
 
+        // Input filters after the last output filter only see output produced during this pass
+        if (this->outputNew != NULL)
+            bufUsedZero(this->outputNew);
+
         // Process forward from the filter that has input to process.  This may be a filter that needs the same input or it may be
         // new input for the first filter.
         for (; filterIdx < lstSize(this->filterList); filterIdx++)
@@ -251,7 +322,7 @@ ioFilterGroupProcess(IoFilterGroup *this, const Buffer *input, Buffer *output)
             if (ioFilterOutput(filterData->filter))
             {
                 // Keep processing while the filter is not done or there is input
-                if (!ioFilterDone(filterData->filter) || filterData->input != NULL)
+                if (!filterData->done || filterData->input != NULL)
                 {
                     // If we are flushing and the prior filter is done and is not producing any more output then this filter should
                     // be flushing as well.  Set filterData->input = NULL so it knows there is no more input coming.
@@ -261,54 +332,38 @@ ioFilterGroupProcess(IoFilterGroup *this, const Buffer *input, Buffer *output)
                     //
                     // Checking filterIdx - 1 is safe because the first filter's filterData->input is always set to NULL when input
                     // is NULL.
-                    if (input == NULL && filterData->input != NULL && !ioFilterDone(filterData->filter) &&
-                        ioFilterDone(ioFilterGroupGet(this, filterIdx - 1)->filter) && bufUsed(filterData->input) == 0)
+                    if (input == NULL && filterData->input != NULL && !filterData->done &&
+                        ioFilterGroupGet(this, filterIdx - 1)->done && bufUsed(filterData->input) == 0)
                     {
                         filterData->input = NULL;
                     }
 
-                    ioFilterProcessInOut(filterData->filter, filterData->input, filterData->output);
+                    size_t outputUsed = bufUsed(filterData->output);
 
-                    // If inputSame is set then the output buffer for this filter is full and it will need to be pre-processed with
-                    // the same input once the output buffer is cleared.
-                    if (ioFilterInputSame(filterData->filter))
-                        this->inputSame = true;
+                    ioFilterProcessInOut(filterData->filter, filterData->input, filterData->output);
+                    ioFilterGroupStateUpdate(this, filterData);
 
-                    // Else clear the buffer if it was locally allocated.  If this is an input buffer that was passed in then the
-                    // caller is responsible for clearing it.
-                    else if (filterData->inputLocal != NULL)
+                    // Clear the buffer if it was locally allocated and the filter does not need the same input again.  If this is
+                    // an input buffer that was passed in then the caller is responsible for clearing it.
+                    if (!filterData->inputSame && filterData->inputLocal != NULL)
                         bufUsedZero(filterData->inputLocal);
+
+                    // Let the input filters that follow the last output filter see the new output in place
+                    if (filterData == lastOutputData && this->outputNew != NULL)
+                        bufUseC(this->outputNew, bufPtr(output) + outputUsed, bufUsed(output) - outputUsed);
                 }
             }
             // Else the filter does not produce output.  No need to flush these filters because they don't buffer data.
             else if (filterData->input != NULL)
                 ioFilterProcessIn(filterData->filter, filterData->input);
         }
+
+        this->inputSame = this->inputSameTotal > 0;
     }
     while (!bufFull(output) && this->inputSame);
 
-    // Scan the filter list to determine if inputSame is set or done is not set for any filter.  We can't trust this->inputSame
-    // when it is true without going through the loop above again.  We need to scan to set this->done anyway so set this->inputSame
-    // in the same loop.
-    this->done = true;
-    this->inputSame = false;
-
-    for (unsigned int filterIdx = 0; filterIdx < lstSize(this->filterList); filterIdx++)
-    {
-        IoFilterData *filterData = ioFilterGroupGet(this, filterIdx);
-
-        // When inputSame then this->done = false and we can exit the loop immediately
-        if (ioFilterInputSame(filterData->filter))
-        {
-            this->done = false;
-            this->inputSame = true;
-            break;
-        }
-
-        // Set this->done = false if any filter is not done
-        if (!ioFilterDone(filterData->filter))
-            this->done = false;
-    }
+    // The group is done when no filter needs the same input and all filters are done
+    this->done = !this->inputSame && this->notDoneTotal == 0;
 
     FUNCTION_LOG_RETURN_VOID();
 }
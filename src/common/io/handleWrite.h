@@ -27,6 +27,7 @@ IoHandleWrite *ioHandleWriteMove(IoHandleWrite *this, MemContext *parentNew);
 /***********************************************************************************************************************************
 Getters
 ***********************************************************************************************************************************/
+int ioHandleWriteHandle(const IoHandleWrite *this);
 IoWrite *ioHandleWriteIo(const IoHandleWrite *this);
 
 /***********************************************************************************************************************************
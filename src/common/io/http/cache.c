@@ -0,0 +1,138 @@
+/***********************************************************************************************************************************
+Http Client Cache
+***********************************************************************************************************************************/
+#include "common/debug.h"
+#include "common/io/http/cache.h"
+#include "common/log.h"
+#include "common/memContext.h"
+#include "common/type/list.h"
+
+/***********************************************************************************************************************************
+Object type
+***********************************************************************************************************************************/
+struct HttpClientCache
+{
+    MemContext *memContext;                                         // Mem context
+
+    // Settings used to create new clients
+    String *host;                                                   // Hostname or IP address
+    unsigned int port;                                              // Port to connect to host on
+    TimeMSec timeout;                                               // Timeout for any i/o operation (connect, read, etc.)
+    TlsContext *tlsContext;                                         // TLS context and session shared by all clients
+
+    List *clientList;                                               // List of http clients
+};
+
+/***********************************************************************************************************************************
+New object
+***********************************************************************************************************************************/
+HttpClientCache *
+httpClientCacheNew(
+    const String *host, unsigned int port, TimeMSec timeout, bool verifyPeer, const String *caFile, const String *caPath)
+{
+    FUNCTION_LOG_BEGIN(logLevelDebug)
+        FUNCTION_LOG_PARAM(STRING, host);
+        FUNCTION_LOG_PARAM(UINT, port);
+        FUNCTION_LOG_PARAM(TIME_MSEC, timeout);
+        FUNCTION_LOG_PARAM(BOOL, verifyPeer);
+        FUNCTION_LOG_PARAM(STRING, caFile);
+        FUNCTION_LOG_PARAM(STRING, caPath);
+    FUNCTION_LOG_END();
+
+    ASSERT(host != NULL);
+
+    HttpClientCache *this = NULL;
+
+    MEM_CONTEXT_NEW_BEGIN("HttpClientCache")
+    {
+        // Allocate state and set context
+        this = memNew(sizeof(HttpClientCache));
+        this->memContext = MEM_CONTEXT_NEW();
+
+        this->host = strDup(host);
+        this->port = port;
+        this->timeout = timeout;
+        this->tlsContext = tlsContextNew(verifyPeer, caFile, caPath);
+
+        this->clientList = lstNew(sizeof(HttpClient *));
+    }
+    MEM_CONTEXT_NEW_END();
+
+    FUNCTION_LOG_RETURN(HTTP_CLIENT_CACHE, this);
+}
+
+/***********************************************************************************************************************************
+Get an http client that is not busy, creating a new client if all cached clients are busy
+
+An error is thrown if all clients are busy and the cache is full since that means clients are not being released.
+***********************************************************************************************************************************/
+HttpClient *
+httpClientCacheGet(HttpClientCache *this)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace)
+        FUNCTION_LOG_PARAM(HTTP_CLIENT_CACHE, this);
+    FUNCTION_LOG_END();
+
+    ASSERT(this != NULL);
+
+    HttpClient *result = NULL;
+
+    // Search for a client that is not busy
+    for (unsigned int clientIdx = 0; clientIdx < lstSize(this->clientList); clientIdx++)
+    {
+        HttpClient *httpClient = *(HttpClient **)lstGet(this->clientList, clientIdx);
+
+        if (!httpClientBusy(httpClient))
+        {
+            result = httpClient;
+            break;
+        }
+    }
+
+    // If none found then create a new one
+    if (result == NULL)
+    {
+        if (lstSize(this->clientList) >= HTTP_CLIENT_CACHE_MAX)
+            THROW_FMT(AssertError, "all %u http clients are busy", lstSize(this->clientList));
+
+        MEM_CONTEXT_BEGIN(this->memContext)
+        {
+            result = httpClientNew(this->tlsContext, this->host, this->port, this->timeout);
+            lstAdd(this->clientList, &result);
+        }
+        MEM_CONTEXT_END();
+    }
+
+    FUNCTION_LOG_RETURN(HTTP_CLIENT, result);
+}
+
+/***********************************************************************************************************************************
+Get the number of clients in the cache
+***********************************************************************************************************************************/
+unsigned int
+httpClientCacheSize(const HttpClientCache *this)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(HTTP_CLIENT_CACHE, this);
+    FUNCTION_TEST_END();
+
+    ASSERT(this != NULL);
+
+    FUNCTION_TEST_RETURN(lstSize(this->clientList));
+}
+
+/***********************************************************************************************************************************
+Free the object
+***********************************************************************************************************************************/
+void
+httpClientCacheFree(HttpClientCache *this)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(HTTP_CLIENT_CACHE, this);
+    FUNCTION_LOG_END();
+
+    if (this != NULL)
+        memContextFree(this->memContext);
+
+    FUNCTION_LOG_RETURN_VOID();
+}
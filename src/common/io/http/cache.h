@@ -0,0 +1,58 @@
+/***********************************************************************************************************************************
+Http Client Cache
+
+Cache http clients and return one that is not busy on request.  Clients are kept open after their requests complete so the next
+request to the same endpoint does not need to pay for a new TCP and TLS handshake.  The clients share a TLS context so a new
+connection can resume the session of any client that was shut down cleanly.  The cache grows as needed, e.g. when several
+asynchronous requests are in flight at the same time, and idle clients are reused in the order they were created so the first
+(warmest) connections are preferred.
+
+A client that is abandoned while busy must be released with httpClientDone() so it can be reused.  The size of the cache is limited
+to catch clients that are never released, since each would otherwise hold a connection open for the life of the cache.
+***********************************************************************************************************************************/
+#ifndef COMMON_IO_HTTP_CACHE_H
+#define COMMON_IO_HTTP_CACHE_H
+
+/***********************************************************************************************************************************
+Object type
+***********************************************************************************************************************************/
+typedef struct HttpClientCache HttpClientCache;
+
+#include "common/io/http/client.h"
+
+/***********************************************************************************************************************************
+Constants
+***********************************************************************************************************************************/
+// Max clients in the cache.  Drivers limit the requests they have in flight so this should never be reached.
+#define HTTP_CLIENT_CACHE_MAX                                       64
+
+/***********************************************************************************************************************************
+Constructor
+***********************************************************************************************************************************/
+HttpClientCache *httpClientCacheNew(
+    const String *host, unsigned int port, TimeMSec timeout, bool verifyPeer, const String *caFile, const String *caPath);
+
+/***********************************************************************************************************************************
+Functions
+***********************************************************************************************************************************/
+HttpClient *httpClientCacheGet(HttpClientCache *this);
+
+/***********************************************************************************************************************************
+Getters
+***********************************************************************************************************************************/
+unsigned int httpClientCacheSize(const HttpClientCache *this);
+
+/***********************************************************************************************************************************
+Destructor
+***********************************************************************************************************************************/
+void httpClientCacheFree(HttpClientCache *this);
+
+/***********************************************************************************************************************************
+Macros for function logging
+***********************************************************************************************************************************/
+#define FUNCTION_LOG_HTTP_CLIENT_CACHE_TYPE                                                                                        \
+    HttpClientCache *
+#define FUNCTION_LOG_HTTP_CLIENT_CACHE_FORMAT(value, buffer, bufferSize)                                                           \
+    objToLog(value, "HttpClientCache", buffer, bufferSize)
+
+#endif
@@ -16,11 +16,17 @@ Http constants
 #define HTTP_VERSION                                                "HTTP/1.1"
     STRING_STATIC(HTTP_VERSION_STR,                                 HTTP_VERSION);
 
+STRING_EXTERN(HTTP_VERB_DELETE_STR,                                 HTTP_VERB_DELETE);
 STRING_EXTERN(HTTP_VERB_GET_STR,                                    HTTP_VERB_GET);
+STRING_EXTERN(HTTP_VERB_POST_STR,                                   HTTP_VERB_POST);
+STRING_EXTERN(HTTP_VERB_PUT_STR,                                    HTTP_VERB_PUT);
 
 #define HTTP_HEADER_CONNECTION                                      "connection"
     STRING_STATIC(HTTP_HEADER_CONNECTION_STR,                       HTTP_HEADER_CONNECTION);
 STRING_EXTERN(HTTP_HEADER_CONTENT_LENGTH_STR,                       HTTP_HEADER_CONTENT_LENGTH);
+STRING_EXTERN(HTTP_HEADER_CONTENT_MD5_STR,                          HTTP_HEADER_CONTENT_MD5);
+STRING_EXTERN(HTTP_HEADER_ETAG_STR,                                 HTTP_HEADER_ETAG);
+STRING_EXTERN(HTTP_HEADER_RANGE_STR,                                HTTP_HEADER_RANGE);
 #define HTTP_HEADER_TRANSFER_ENCODING                               "transfer-encoding"
     STRING_STATIC(HTTP_HEADER_TRANSFER_ENCODING_STR,                HTTP_HEADER_TRANSFER_ENCODING);
 
@@ -29,6 +35,9 @@ STRING_EXTERN(HTTP_HEADER_CONTENT_LENGTH_STR,                       HTTP_HEADER_
 #define HTTP_VALUE_TRANSFER_ENCODING_CHUNKED                        "chunked"
     STRING_STATIC(HTTP_VALUE_TRANSFER_ENCODING_CHUNKED_STR,         HTTP_VALUE_TRANSFER_ENCODING_CHUNKED);
 
+// 2xx codes indicate success
+#define HTTP_RESPONSE_CODE_OK_CLASS                                 2
+
 // 5xx errors that should always be retried
 #define HTTP_RESPONSE_CODE_RETRY_CLASS                              5
 
@@ -43,6 +52,11 @@ struct HttpClient
     TlsClient *tls;                                                 // Tls client
     IoRead *ioRead;                                                 // Read io interface
 
+    String *request;                                                // Request line and headers (kept in case of retry)
+    const Buffer *requestBody;                                      // Request body (owned by the caller)
+    bool requestBusy;                                               // Has a request been made without reading the response?
+    bool requestSent;                                               // Has the current request been sent to the server?
+
     unsigned int responseCode;                                      // Response code (e.g. 200, 404)
     String *responseMessage;                                        // Response message e.g. (OK, Not Found)
     HttpHeader *responseHeader;                                     // Response headers
@@ -129,7 +143,7 @@ httpClientRead(HttpClient *this, Buffer *buffer, bool block)
 
         // If the server notified that it would close the connection after sending content then close the client side
         if (this->contentEof && this->closeOnContentEof)
-            tlsClientClose(this->tls);
+            tlsClientShutdown(this->tls);
     }
 
     FUNCTION_LOG_RETURN(SIZE, (size_t)actualBytes);
@@ -152,20 +166,20 @@ httpClientEof(const HttpClient *this)
 
 /***********************************************************************************************************************************
 New object
+
+The TLS context may be shared with other clients connecting to the same endpoint so they can resume each other's sessions.
 ***********************************************************************************************************************************/
 HttpClient *
-httpClientNew(
-    const String *host, unsigned int port, TimeMSec timeout, bool verifyPeer, const String *caFile, const String *caPath)
+httpClientNew(TlsContext *tlsContext, const String *host, unsigned int port, TimeMSec timeout)
 {
     FUNCTION_LOG_BEGIN(logLevelDebug)
+        FUNCTION_LOG_PARAM(TLS_CONTEXT, tlsContext);
         FUNCTION_LOG_PARAM(STRING, host);
         FUNCTION_LOG_PARAM(UINT, port);
         FUNCTION_LOG_PARAM(TIME_MSEC, timeout);
-        FUNCTION_LOG_PARAM(BOOL, verifyPeer);
-        FUNCTION_LOG_PARAM(STRING, caFile);
-        FUNCTION_LOG_PARAM(STRING, caPath);
     FUNCTION_LOG_END();
 
+    ASSERT(tlsContext != NULL);
     ASSERT(host != NULL);
 
     HttpClient *this = NULL;
@@ -177,20 +191,126 @@ httpClientNew(
         this->memContext = MEM_CONTEXT_NEW();
 
         this->timeout = timeout;
-        this->tls = tlsClientNew(host, port, timeout, verifyPeer, caFile, caPath);
+        this->tls = tlsClientNewContext(tlsContext, host, port, timeout);
     }
     MEM_CONTEXT_NEW_END();
 
     FUNCTION_LOG_RETURN(HTTP_CLIENT, this);
 }
 
+/***********************************************************************************************************************************
+Prepare a request so it can be sent (and resent if there is a retry)
+***********************************************************************************************************************************/
+static void
+httpClientRequestPrepare(
+    HttpClient *this, const String *verb, const String *uri, const HttpQuery *query, const HttpHeader *requestHeader,
+    const Buffer *body)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace)
+        FUNCTION_LOG_PARAM(HTTP_CLIENT, this);
+        FUNCTION_LOG_PARAM(STRING, verb);
+        FUNCTION_LOG_PARAM(STRING, uri);
+        FUNCTION_LOG_PARAM(HTTP_QUERY, query);
+        FUNCTION_LOG_PARAM(HTTP_HEADER, requestHeader);
+        FUNCTION_LOG_PARAM(BUFFER, body);
+    FUNCTION_LOG_END();
+
+    ASSERT(this != NULL);
+    ASSERT(verb != NULL);
+    ASSERT(uri != NULL);
+
+    // If the response to the last request was never read (e.g. an error was thrown) then the connection is in an unknown state
+    if (this->requestBusy)
+    {
+        tlsClientClose(this->tls);
+        this->requestBusy = false;
+    }
+
+    // Free the request left over from the last call
+    strFree(this->request);
+    this->request = NULL;
+
+    MEM_CONTEXT_TEMP_BEGIN()
+    {
+        // Render the request line
+        String *queryStr = httpQueryRender(query);
+
+        String *request = strNewFmt(
+            "%s %s%s%s " HTTP_VERSION "\r\n", strPtr(verb), strPtr(httpUriEncode(uri, true)), queryStr == NULL ? "" : "?",
+            queryStr == NULL ? "" : strPtr(queryStr));
+
+        // Render headers
+        if (requestHeader != NULL)
+        {
+            const StringList *headerList = httpHeaderList(requestHeader);
+
+            for (unsigned int headerIdx = 0; headerIdx < strLstSize(headerList); headerIdx++)
+            {
+                const String *headerKey = strLstGet(headerList, headerIdx);
+                strCatFmt(request, "%s:%s\r\n", strPtr(headerKey), strPtr(httpHeaderGet(requestHeader, headerKey)));
+            }
+        }
+
+        // Add blank line to end headers
+        strCat(request, "\r\n");
+
+        // Store the request in the object context so it can be resent on retry
+        MEM_CONTEXT_BEGIN(this->memContext)
+        {
+            this->request = strDup(request);
+        }
+        MEM_CONTEXT_END();
+    }
+    MEM_CONTEXT_TEMP_END();
+
+    this->requestBody = body;
+    this->requestBusy = true;
+    this->requestSent = false;
+
+    FUNCTION_LOG_RETURN_VOID();
+}
+
+/***********************************************************************************************************************************
+Send the prepared request to the server
+***********************************************************************************************************************************/
+static void
+httpClientRequestSend(HttpClient *this)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace)
+        FUNCTION_LOG_PARAM(HTTP_CLIENT, this);
+    FUNCTION_LOG_END();
+
+    ASSERT(this != NULL);
+    ASSERT(this->request != NULL);
+
+    MEM_CONTEXT_TEMP_BEGIN()
+    {
+        tlsClientOpen(this->tls);
+
+        // Write the request line and headers
+        ioWrite(tlsClientIoWrite(this->tls), bufNewStr(this->request));
+
+        // Write the body, if any
+        if (this->requestBody != NULL)
+            ioWrite(tlsClientIoWrite(this->tls), this->requestBody);
+
+        // Flush so the server gets the entire request
+        ioWriteFlush(tlsClientIoWrite(this->tls));
+    }
+    MEM_CONTEXT_TEMP_END();
+
+    this->requestSent = true;
+
+    FUNCTION_LOG_RETURN_VOID();
+}
+
 /***********************************************************************************************************************************
 Perform a request
 ***********************************************************************************************************************************/
 Buffer *
 httpClientRequest(
     HttpClient *this, const String *verb, const String *uri, const HttpQuery *query, const HttpHeader *requestHeader,
-    bool returnContent)
+    const Buffer *body, bool returnContent)
 {
     FUNCTION_LOG_BEGIN(logLevelDebug)
         FUNCTION_LOG_PARAM(HTTP_CLIENT, this);
@@ -198,12 +318,73 @@ httpClientRequest(
         FUNCTION_LOG_PARAM(STRING, uri);
         FUNCTION_LOG_PARAM(HTTP_QUERY, query);
         FUNCTION_LOG_PARAM(HTTP_HEADER, requestHeader);
+        FUNCTION_LOG_PARAM(BUFFER, body);
+        FUNCTION_LOG_PARAM(BOOL, returnContent);
     FUNCTION_LOG_END();
 
     ASSERT(this != NULL);
     ASSERT(verb != NULL);
     ASSERT(uri != NULL);
 
+    // The request will be sent when the response is requested so connection errors are retried
+    httpClientRequestPrepare(this, verb, uri, query, requestHeader, body);
+
+    FUNCTION_LOG_RETURN(BUFFER, httpClientResponse(this, returnContent));
+}
+
+/***********************************************************************************************************************************
+Send a request without waiting for the response
+
+Errors are not reported here since the request will be resent (with retries) by httpClientResponse() if the send fails.
+***********************************************************************************************************************************/
+void
+httpClientRequestAsync(
+    HttpClient *this, const String *verb, const String *uri, const HttpQuery *query, const HttpHeader *requestHeader,
+    const Buffer *body)
+{
+    FUNCTION_LOG_BEGIN(logLevelDebug)
+        FUNCTION_LOG_PARAM(HTTP_CLIENT, this);
+        FUNCTION_LOG_PARAM(STRING, verb);
+        FUNCTION_LOG_PARAM(STRING, uri);
+        FUNCTION_LOG_PARAM(HTTP_QUERY, query);
+        FUNCTION_LOG_PARAM(HTTP_HEADER, requestHeader);
+        FUNCTION_LOG_PARAM(BUFFER, body);
+    FUNCTION_LOG_END();
+
+    ASSERT(this != NULL);
+    ASSERT(verb != NULL);
+    ASSERT(uri != NULL);
+
+    httpClientRequestPrepare(this, verb, uri, query, requestHeader, body);
+
+    TRY_BEGIN()
+    {
+        httpClientRequestSend(this);
+    }
+    CATCH_ANY()
+    {
+        LOG_DEBUG("async send failed %s: %s", errorTypeName(errorType()), errorMessage());
+        tlsClientClose(this->tls);
+    }
+    TRY_END();
+
+    FUNCTION_LOG_RETURN_VOID();
+}
+
+/***********************************************************************************************************************************
+Read the response to the last request, resending the request when a retry is required
+***********************************************************************************************************************************/
+Buffer *
+httpClientResponse(HttpClient *this, bool returnContent)
+{
+    FUNCTION_LOG_BEGIN(logLevelDebug)
+        FUNCTION_LOG_PARAM(HTTP_CLIENT, this);
+        FUNCTION_LOG_PARAM(BOOL, returnContent);
+    FUNCTION_LOG_END();
+
+    ASSERT(this != NULL);
+    ASSERT(this->requestBusy);
+
     // Buffer for returned content
     Buffer *result = NULL;
 
@@ -237,34 +418,11 @@ httpClientRequest(
 
             TRY_BEGIN()
             {
-                tlsClientOpen(this->tls);
-
-                // Write the request
-                String *queryStr = httpQueryRender(query);
-
-                ioWriteLine(
-                    tlsClientIoWrite(this->tls),
-                    strNewFmt(
-                        "%s %s%s%s " HTTP_VERSION "\r", strPtr(verb), strPtr(httpUriEncode(uri, true)), queryStr == NULL ? "" : "?",
-                        queryStr == NULL ? "" : strPtr(queryStr)));
-
-                // Write headers
-                if (requestHeader != NULL)
-                {
-                    const StringList *headerList = httpHeaderList(requestHeader);
-
-                    for (unsigned int headerIdx = 0; headerIdx < strLstSize(headerList); headerIdx++)
-                    {
-                        const String *headerKey = strLstGet(headerList, headerIdx);
-                        ioWriteLine(
-                            tlsClientIoWrite(this->tls),
-                            strNewFmt("%s:%s\r", strPtr(headerKey), strPtr(httpHeaderGet(requestHeader, headerKey))));
-                    }
-                }
+                // Send the request unless it was already sent asynchronously.  Any retry must send the request again.
+                if (!this->requestSent)
+                    httpClientRequestSend(this);
 
-                // Write out blank line and close the write so it flushes
-                ioWriteLine(tlsClientIoWrite(this->tls), CR_STR);
-                ioWriteFlush(tlsClientIoWrite(this->tls));
+                this->requestSent = false;
 
                 // Read status and make sure it starts with the correct http version
                 String *status = strTrim(ioReadLine(tlsClientIoRead(this->tls)));
@@ -358,7 +516,7 @@ httpClientRequest(
 
                     // If all content should be returned from this function then read the buffer.  Also read the reponse if there
                     // has been an error.
-                    if (returnContent || httpClientResponseCode(this) != 200)
+                    if (returnContent || !httpClientResponseCodeOk(this))
                     {
                         result = bufNew(0);
 
@@ -383,7 +541,7 @@ httpClientRequest(
                 }
                 // If the server notified that it would close the connection after sending content then close the client side
                 else if (this->closeOnContentEof)
-                    tlsClientClose(this->tls);
+                    tlsClientShutdown(this->tls);
 
                 // Retry when reponse code is 5xx.  These errors generally represent a server error for a request that looks valid.
                 // There are a few errors that might be permanently fatal but they are rare and it seems best not to try and pick
@@ -409,6 +567,10 @@ httpClientRequest(
         }
         while (!complete && retry);
 
+        // The request is done whether or not it was successful
+        this->requestBody = NULL;
+        this->requestBusy = false;
+
         if (!complete)
             RETHROW();
 
@@ -420,6 +582,49 @@ httpClientRequest(
     FUNCTION_LOG_RETURN(BUFFER, result);
 }
 
+/***********************************************************************************************************************************
+Release the client when the response will not be read to the end, e.g. when a read is closed or freed before eof
+
+The remaining content could be large so it is not read.  Instead the connection is closed since it is in an unknown state, which
+leaves the client ready for the next request.  Nothing is done if the client is not busy.
+***********************************************************************************************************************************/
+void
+httpClientDone(HttpClient *this)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(HTTP_CLIENT, this);
+    FUNCTION_LOG_END();
+
+    ASSERT(this != NULL);
+
+    if (httpClientBusy(this))
+    {
+        tlsClientClose(this->tls);
+
+        this->requestBody = NULL;
+        this->requestBusy = false;
+        this->contentEof = true;
+    }
+
+    FUNCTION_LOG_RETURN_VOID();
+}
+
+/***********************************************************************************************************************************
+Is the client busy?  A client is busy when a request has been sent without the response being read or when response content is
+still being read through the io interface.
+***********************************************************************************************************************************/
+bool
+httpClientBusy(const HttpClient *this)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(HTTP_CLIENT, this);
+    FUNCTION_TEST_END();
+
+    ASSERT(this != NULL);
+
+    FUNCTION_TEST_RETURN(this->requestBusy || (this->ioRead != NULL && !this->contentEof));
+}
+
 /***********************************************************************************************************************************
 Get read interface
 ***********************************************************************************************************************************/
@@ -450,6 +655,21 @@ httpClientResponseCode(const HttpClient *this)
     FUNCTION_TEST_RETURN(this->responseCode);
 }
 
+/***********************************************************************************************************************************
+Was the response code in the success class (2xx)?  Some requests, e.g. DELETE, return a success code other than 200.
+***********************************************************************************************************************************/
+bool
+httpClientResponseCodeOk(const HttpClient *this)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(HTTP_CLIENT, this);
+    FUNCTION_TEST_END();
+
+    ASSERT(this != NULL);
+
+    FUNCTION_TEST_RETURN(this->responseCode / 100 == HTTP_RESPONSE_CODE_OK_CLASS);
+}
+
 /***********************************************************************************************************************************
 Get the response headers
 ***********************************************************************************************************************************/
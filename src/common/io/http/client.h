@@ -6,6 +6,10 @@ A robust HTTP client with pipelining support and automatic retries.
 Using a single object to make multiple requests is more efficient because requests are piplelined whenever possible.  Requests are
 automatically retried when the connection has been closed by the server.  Any 5xx response is also retried.
 
+Requests may also be split into a send phase, httpClientRequestAsync(), and a response phase, httpClientResponse(), so the caller
+can do other work (e.g. send a request on another client) while the server processes the request.  The request body is not copied so
+it must remain valid until the response has been read since it may need to be resent on retry.
+
 Only the HTTPS protocol is currently supported.
 ***********************************************************************************************************************************/
 #ifndef COMMON_IO_HTTP_CLIENT_H
@@ -19,17 +23,30 @@ typedef struct HttpClient HttpClient;
 #include "common/io/http/header.h"
 #include "common/io/http/query.h"
 #include "common/io/read.h"
+#include "common/io/tls/client.h"
 #include "common/time.h"
 #include "common/type/stringList.h"
 
 /***********************************************************************************************************************************
 HTTP Constants
 ***********************************************************************************************************************************/
+#define HTTP_VERB_DELETE                                            "DELETE"
+    STRING_DECLARE(HTTP_VERB_DELETE_STR);
 #define HTTP_VERB_GET                                               "GET"
     STRING_DECLARE(HTTP_VERB_GET_STR);
+#define HTTP_VERB_POST                                              "POST"
+    STRING_DECLARE(HTTP_VERB_POST_STR);
+#define HTTP_VERB_PUT                                               "PUT"
+    STRING_DECLARE(HTTP_VERB_PUT_STR);
 
 #define HTTP_HEADER_CONTENT_LENGTH                                  "content-length"
     STRING_DECLARE(HTTP_HEADER_CONTENT_LENGTH_STR);
+#define HTTP_HEADER_CONTENT_MD5                                     "content-md5"
+    STRING_DECLARE(HTTP_HEADER_CONTENT_MD5_STR);
+#define HTTP_HEADER_ETAG                                            "etag"
+    STRING_DECLARE(HTTP_HEADER_ETAG_STR);
+#define HTTP_HEADER_RANGE                                           "range"
+    STRING_DECLARE(HTTP_HEADER_RANGE_STR);
 
 #define HTTP_RESPONSE_CODE_OK                                       200
 #define HTTP_RESPONSE_CODE_FORBIDDEN                                403
@@ -38,21 +55,27 @@ HTTP Constants
 /***********************************************************************************************************************************
 Constructor
 ***********************************************************************************************************************************/
-HttpClient *httpClientNew(
-    const String *host, unsigned int port, TimeMSec timeout, bool verifyPeer, const String *caFile, const String *caPath);
+HttpClient *httpClientNew(TlsContext *tlsContext, const String *host, unsigned int port, TimeMSec timeout);
 
 /***********************************************************************************************************************************
 Functions
 ***********************************************************************************************************************************/
 Buffer *httpClientRequest(
     HttpClient *this, const String *verb, const String *uri, const HttpQuery *query, const HttpHeader *requestHeader,
-    bool returnContent);
+    const Buffer *body, bool returnContent);
+void httpClientRequestAsync(
+    HttpClient *this, const String *verb, const String *uri, const HttpQuery *query, const HttpHeader *requestHeader,
+    const Buffer *body);
+Buffer *httpClientResponse(HttpClient *this, bool returnContent);
+void httpClientDone(HttpClient *this);
 
 /***********************************************************************************************************************************
 Getters
 ***********************************************************************************************************************************/
+bool httpClientBusy(const HttpClient *this);
 IoRead *httpClientIoRead(const HttpClient *this);
 unsigned int httpClientResponseCode(const HttpClient *this);
+bool httpClientResponseCodeOk(const HttpClient *this);
 const HttpHeader *httpClientReponseHeader(const HttpClient *this);
 const String *httpClientResponseMessage(const HttpClient *this);
 
@@ -322,6 +322,25 @@ ioReadEof(const IoRead *this)
     FUNCTION_LOG_RETURN(BOOL, this->eofAll);
 }
 
+/***********************************************************************************************************************************
+Is a complete line already buffered?
+
+When true ioReadLine() will return without reading from the driver.  Callers that wait on the handle before reading lines must check
+this first since the handle will not signal for data that has already been read into the buffer.
+***********************************************************************************************************************************/
+bool
+ioReadLineBuffered(const IoRead *this)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(IO_READ, this);
+    FUNCTION_LOG_END();
+
+    ASSERT(this != NULL);
+
+    FUNCTION_LOG_RETURN(
+        BOOL, this->output != NULL && bufUsed(this->output) > 0 && memchr(bufPtr(this->output), '\n', bufUsed(this->output)) != NULL);
+}
+
 /***********************************************************************************************************************************
 Get/set filters
 
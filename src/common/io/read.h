@@ -32,6 +32,7 @@ bool ioReadEof(const IoRead *this);
 const IoFilterGroup *ioReadFilterGroup(const IoRead *this);
 void ioReadFilterGroupSet(IoRead *this, IoFilterGroup *filterGroup);
 int ioReadHandle(const IoRead *this);
+bool ioReadLineBuffered(const IoRead *this);
 
 /***********************************************************************************************************************************
 Destructor
@@ -27,17 +27,25 @@ TLS Client
 #include "crypto/crypto.h"
 
 /***********************************************************************************************************************************
-Object type
+Object types
 ***********************************************************************************************************************************/
+struct TlsContext
+{
+    MemContext *memContext;                                         // Mem context
+    bool verifyPeer;                                                // Should the peer (server) certificate be verified?
+
+    SSL_CTX *context;                                               // TLS context
+    SSL_SESSION *sessionResume;                                     // Most recent session shut down cleanly, to resume on open
+};
+
 struct TlsClient
 {
     MemContext *memContext;                                         // Mem context
     String *host;                                                   // Hostname or IP address
     unsigned int port;                                              // Port to connect to host on
     TimeMSec timeout;                                               // Timeout for any i/o operation (connect, read, etc.)
-    bool verifyPeer;                                                // Should the peer (server) certificate be verified?
 
-    SSL_CTX *context;                                               // TLS context
+    TlsContext *context;                                            // TLS context (may be shared with other clients)
     int socket;                                                     // Client socket
     SSL *session;                                                   // TLS session on the socket
 
@@ -46,38 +54,28 @@ struct TlsClient
 };
 
 /***********************************************************************************************************************************
-New object
+New context
+
+The context holds the TLS settings and the session to resume so it should only be shared by clients connecting to the same endpoint.
 ***********************************************************************************************************************************/
-TlsClient *
-tlsClientNew(
-    const String *host, unsigned int port, TimeMSec timeout, bool verifyPeer, const String *caFile, const String *caPath)
+TlsContext *
+tlsContextNew(bool verifyPeer, const String *caFile, const String *caPath)
 {
     FUNCTION_LOG_BEGIN(logLevelDebug)
-        FUNCTION_LOG_PARAM(STRING, host);
-        FUNCTION_LOG_PARAM(UINT, port);
-        FUNCTION_LOG_PARAM(TIME_MSEC, timeout);
         FUNCTION_LOG_PARAM(BOOL, verifyPeer);
         FUNCTION_LOG_PARAM(STRING, caFile);
         FUNCTION_LOG_PARAM(STRING, caPath);
     FUNCTION_LOG_END();
 
-    ASSERT(host != NULL);
-
-    TlsClient *this = NULL;
+    TlsContext *this = NULL;
 
-    MEM_CONTEXT_NEW_BEGIN("TlsClient")
+    MEM_CONTEXT_NEW_BEGIN("TlsContext")
     {
-        this = memNew(sizeof(TlsClient));
+        this = memNew(sizeof(TlsContext));
         this->memContext = MEM_CONTEXT_NEW();
 
-        this->host = strDup(host);
-        this->port = port;
-        this->timeout = timeout;
         this->verifyPeer = verifyPeer;
 
-        // Initialize socket to -1 so we know when it is disconnected
-        this->socket = -1;
-
         // Setup TLS context
         // -------------------------------------------------------------------------------------------------------------------------
         cryptoInit();
@@ -91,7 +89,7 @@ tlsClientNew(
         this->context = SSL_CTX_new(method);
         cryptoError(this->context == NULL, "unable to create TLS context");
 
-        memContextCallback(this->memContext, (MemContextCallback)tlsClientFree, this);
+        memContextCallback(this->memContext, (MemContextCallback)tlsContextFree, this);
 
         // Exclude SSL versions to only allow TLS and also disable compression
         SSL_CTX_set_options(this->context, (long)(SSL_OP_ALL | SSL_OP_NO_SSLv2 | SSL_OP_NO_SSLv3 | SSL_OP_NO_COMPRESSION));
@@ -114,6 +112,79 @@ tlsClientNew(
     }
     MEM_CONTEXT_NEW_END();
 
+    FUNCTION_LOG_RETURN(TLS_CONTEXT, this);
+}
+
+/***********************************************************************************************************************************
+New object with a shared context
+
+The context must not be freed before the client unless they are freed together, e.g. when they are in the same mem context.
+***********************************************************************************************************************************/
+TlsClient *
+tlsClientNewContext(TlsContext *context, const String *host, unsigned int port, TimeMSec timeout)
+{
+    FUNCTION_LOG_BEGIN(logLevelDebug)
+        FUNCTION_LOG_PARAM(TLS_CONTEXT, context);
+        FUNCTION_LOG_PARAM(STRING, host);
+        FUNCTION_LOG_PARAM(UINT, port);
+        FUNCTION_LOG_PARAM(TIME_MSEC, timeout);
+    FUNCTION_LOG_END();
+
+    ASSERT(context != NULL);
+    ASSERT(host != NULL);
+
+    TlsClient *this = NULL;
+
+    MEM_CONTEXT_NEW_BEGIN("TlsClient")
+    {
+        this = memNew(sizeof(TlsClient));
+        this->memContext = MEM_CONTEXT_NEW();
+
+        this->host = strDup(host);
+        this->port = port;
+        this->timeout = timeout;
+        this->context = context;
+
+        // Initialize socket to -1 so we know when it is disconnected
+        this->socket = -1;
+
+        memContextCallback(this->memContext, (MemContextCallback)tlsClientFree, this);
+    }
+    MEM_CONTEXT_NEW_END();
+
+    FUNCTION_LOG_RETURN(TLS_CLIENT, this);
+}
+
+/***********************************************************************************************************************************
+New object with its own context
+***********************************************************************************************************************************/
+TlsClient *
+tlsClientNew(
+    const String *host, unsigned int port, TimeMSec timeout, bool verifyPeer, const String *caFile, const String *caPath)
+{
+    FUNCTION_LOG_BEGIN(logLevelDebug)
+        FUNCTION_LOG_PARAM(STRING, host);
+        FUNCTION_LOG_PARAM(UINT, port);
+        FUNCTION_LOG_PARAM(TIME_MSEC, timeout);
+        FUNCTION_LOG_PARAM(BOOL, verifyPeer);
+        FUNCTION_LOG_PARAM(STRING, caFile);
+        FUNCTION_LOG_PARAM(STRING, caPath);
+    FUNCTION_LOG_END();
+
+    ASSERT(host != NULL);
+
+    TlsClient *this = NULL;
+
+    MEM_CONTEXT_TEMP_BEGIN()
+    {
+        this = tlsClientNewContext(tlsContextNew(verifyPeer, caFile, caPath), host, port, timeout);
+
+        // The client owns the context so they are freed together
+        memContextMove(this->context->memContext, this->memContext);
+        memContextMove(this->memContext, MEM_CONTEXT_OLD());
+    }
+    MEM_CONTEXT_TEMP_END();
+
     FUNCTION_LOG_RETURN(TLS_CLIENT, this);
 }
 
@@ -354,10 +425,19 @@ tlsClientOpen(TlsClient *this)
 #endif
 
                     // Negotiate TLS
-                    cryptoError((this->session = SSL_new(this->context)) == NULL, "unable to create TLS context");
+                    cryptoError((this->session = SSL_new(this->context->context)) == NULL, "unable to create TLS context");
 
                     cryptoError(SSL_set_tlsext_host_name(this->session, strPtr(this->host)) != 1, "unable to set TLS host name");
                     cryptoError(SSL_set_fd(this->session, this->socket) != 1, "unable to add socket to TLS context");
+
+                    // Offer the session saved from the last clean shutdown so the server can skip the full handshake
+                    if (this->context->sessionResume != NULL)
+                    {
+                        cryptoError(
+                            SSL_set_session(this->session, this->context->sessionResume) != 1,
+                            "unable to set TLS session to resume");
+                    }
+
                     cryptoError(SSL_connect(this->session) != 1, "unable to negotiate TLS connection");
 
                     // Connection was successful
@@ -384,7 +464,7 @@ tlsClientOpen(TlsClient *this)
         MEM_CONTEXT_TEMP_END();
 
         // Verify that the certificate presented by the server is valid
-        if (this->verifyPeer)
+        if (this->context->verifyPeer)
         {
             // Verify that the chain of trust leads to a valid CA
             long int verifyResult = SSL_get_verify_result(this->session);
@@ -482,10 +562,15 @@ tlsClientRead(TlsClient *this, Buffer *buffer, bool block)
         // Update amount of buffer used
         bufUsedInc(buffer, (size_t)actualBytes);
 
-        // If zero bytes were returned then the connection was closed
+        // If zero bytes were returned then the connection was closed.  The session is only saved if the server sent close_notify
+        // since otherwise the connection may have been truncated.
         if (actualBytes == 0)
         {
-            tlsClientClose(this);
+            if (SSL_get_shutdown(this->session) & SSL_RECEIVED_SHUTDOWN)
+                tlsClientShutdown(this);
+            else
+                tlsClientClose(this);                                   // {uncovered - OpenSSL >= 3 errors on truncation}
+
             break;
         }
     }
@@ -514,8 +599,51 @@ tlsClientWrite(TlsClient *this, const Buffer *buffer)
     FUNCTION_LOG_RETURN_VOID();
 }
 
+/***********************************************************************************************************************************
+Shut down the connection cleanly and save the session so it can be resumed by the next open of any client sharing the context
+
+This should only be used when the connection is in a known good state, e.g. after the server has closed it or all expected content
+has been read.
+***********************************************************************************************************************************/
+void
+tlsClientShutdown(TlsClient *this)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(TLS_CLIENT, this);
+    FUNCTION_LOG_END();
+
+    ASSERT(this != NULL);
+
+    if (this->session != NULL && SSL_is_init_finished(this->session))
+    {
+        bool shutdown = true;
+
+        // If the server has already sent close_notify then the shutdown is complete.  There is no need to reply since the server
+        // may already be gone.
+        if (SSL_get_shutdown(this->session) & SSL_RECEIVED_SHUTDOWN)
+            SSL_set_shutdown(this->session, SSL_SENT_SHUTDOWN | SSL_RECEIVED_SHUTDOWN);
+        // Else send close_notify without waiting for the reply
+        else
+            shutdown = SSL_shutdown(this->session) >= 0;
+
+        // Only the most recent session is kept
+        if (shutdown)
+        {
+            SSL_SESSION_free(this->context->sessionResume);
+            this->context->sessionResume = SSL_get1_session(this->session);
+        }
+    }
+
+    tlsClientClose(this);
+
+    FUNCTION_LOG_RETURN_VOID();
+}
+
 /***********************************************************************************************************************************
 Close the connection
+
+The connection is assumed to be in an unknown state (e.g. after an error) so the session is not saved and is marked as not
+resumable.  Use tlsClientShutdown() when the connection is known to be in a good state.
 ***********************************************************************************************************************************/
 void
 tlsClientClose(TlsClient *this)
@@ -558,6 +686,21 @@ tlsClientEof(const TlsClient *this)
     FUNCTION_LOG_RETURN(BOOL, this->session == NULL);
 }
 
+/***********************************************************************************************************************************
+Was the current session resumed from a prior connection?
+***********************************************************************************************************************************/
+bool
+tlsClientSessionReused(const TlsClient *this)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(TLS_CLIENT, this);
+    FUNCTION_LOG_END();
+
+    ASSERT(this != NULL);
+
+    FUNCTION_LOG_RETURN(BOOL, this->session != NULL && SSL_session_reused(this->session));
+}
+
 /***********************************************************************************************************************************
 Get read interface
 ***********************************************************************************************************************************/
@@ -600,10 +743,36 @@ tlsClientFree(TlsClient *this)
 
     if (this != NULL)
     {
+        memContextCallbackClear(this->memContext);
+
+        // The context is not used here since it may already have been freed when the client owns it
         tlsClientClose(this);
-        SSL_CTX_free(this->context);
 
+        memContextFree(this->memContext);
+    }
+
+    FUNCTION_TEST_RETURN_VOID();
+}
+
+/***********************************************************************************************************************************
+Free the context
+
+Clients that still have a connection open keep their own reference to the OpenSSL context, which is freed when they close.
+***********************************************************************************************************************************/
+void
+tlsContextFree(TlsContext *this)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(TLS_CONTEXT, this);
+    FUNCTION_TEST_END();
+
+    if (this != NULL)
+    {
         memContextCallbackClear(this->memContext);
+
+        SSL_SESSION_free(this->sessionResume);
+        SSL_CTX_free(this->context);
+
         memContextFree(this->memContext);
     }
 
@@ -9,6 +9,11 @@ connection is needed.  By default, an open connection will be reused for pipelin
 transaction on a read/write error if the server closes the connection before it can be reused.  If this behavior is not desirable
 then tlsClientClose() may be used to ensure that the next call to tlsClientOpen() will create a new TLS session.
 
+Clients connecting to the same endpoint may share a TlsContext, which holds the TLS settings and the most recent session that was
+shut down cleanly with tlsClientShutdown().  The session is offered to the server on the next tlsClientOpen() by any client sharing
+the context.  If the server accepts it the abbreviated handshake is used, which saves a round trip and the public key operations.
+Connections closed with tlsClientClose() are assumed to be in an unknown state so their sessions are never resumed.
+
 Note that tlsClientRead() is non-blocking unless there are *zero* bytes to be read from the session in which case it will raise an
 error after the defined timeout.  In any case the tlsClientRead()/tlsClientWrite()/tlsClientEof() functions should not generally
 be called directly.  Instead use the read/write interfaces available from tlsClientIoRead()/tlsClientIoWrite().
@@ -20,6 +25,7 @@ be called directly.  Instead use the read/write interfaces available from tlsCli
 Object type
 ***********************************************************************************************************************************/
 typedef struct TlsClient TlsClient;
+typedef struct TlsContext TlsContext;
 
 #include "common/io/read.h"
 #include "common/io/write.h"
@@ -27,10 +33,13 @@ typedef struct TlsClient TlsClient;
 #include "common/type/string.h"
 
 /***********************************************************************************************************************************
-Constructor
+Constructors
 ***********************************************************************************************************************************/
+TlsContext *tlsContextNew(bool verifyPeer, const String *caFile, const String *caPath);
+
 TlsClient *tlsClientNew(
     const String *host, unsigned int port, TimeMSec timeout, bool verifyPeer, const String *caFile, const String *caPath);
+TlsClient *tlsClientNewContext(TlsContext *context, const String *host, unsigned int port, TimeMSec timeout);
 
 /***********************************************************************************************************************************
 Functions
@@ -38,6 +47,7 @@ Functions
 void tlsClientOpen(TlsClient *this);
 size_t tlsClientRead(TlsClient *this, Buffer *buffer, bool block);
 void tlsClientWrite(TlsClient *this, const Buffer *buffer);
+void tlsClientShutdown(TlsClient *this);
 void tlsClientClose(TlsClient *this);
 
 /***********************************************************************************************************************************
@@ -46,11 +56,13 @@ Getters
 bool tlsClientEof(const TlsClient *this);
 IoRead *tlsClientIoRead(const TlsClient *this);
 IoWrite *tlsClientIoWrite(const TlsClient *this);
+bool tlsClientSessionReused(const TlsClient *this);
 
 /***********************************************************************************************************************************
-Destructor
+Destructors
 ***********************************************************************************************************************************/
 void tlsClientFree(TlsClient *this);
+void tlsContextFree(TlsContext *this);
 
 /***********************************************************************************************************************************
 Macros for function logging
@@ -59,5 +71,9 @@ Macros for function logging
     TlsClient *
 #define FUNCTION_LOG_TLS_CLIENT_FORMAT(value, buffer, bufferSize)                                                                  \
     objToLog(value, "TlsClient", buffer, bufferSize)
+#define FUNCTION_LOG_TLS_CONTEXT_TYPE                                                                                              \
+    TlsContext *
+#define FUNCTION_LOG_TLS_CONTEXT_FORMAT(value, buffer, bufferSize)                                                                 \
+    objToLog(value, "TlsContext", buffer, bufferSize)
 
 #endif
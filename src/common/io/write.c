@@ -170,6 +170,10 @@ ioWriteFlush(IoWrite *this)
         bufUsedZero(this->output);
     }
 
+    // Flush data the driver has buffered
+    if (this->interface.flush != NULL)
+        this->interface.flush(this->driver);
+
     FUNCTION_LOG_RETURN_VOID();
 }
 
@@ -250,6 +254,23 @@ ioWriteFilterGroupSet(IoWrite *this, IoFilterGroup *filterGroup)
     FUNCTION_LOG_RETURN_VOID();
 }
 
+/***********************************************************************************************************************************
+Handle (file descriptor) for the write object
+
+Not all write objects have a handle and -1 will be returned in that case.
+***********************************************************************************************************************************/
+int
+ioWriteHandle(const IoWrite *this)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(IO_WRITE, this);
+    FUNCTION_LOG_END();
+
+    ASSERT(this != NULL);
+
+    FUNCTION_LOG_RETURN(INT, this->interface.handle == NULL ? -1 : this->interface.handle(this->driver));
+}
+
 /***********************************************************************************************************************************
 Free the object
 ***********************************************************************************************************************************/
@@ -23,6 +23,33 @@ typedef struct MemContextAlloc
     void *buffer;                                                   // Allocated buffer
 } MemContextAlloc;
 
+/***********************************************************************************************************************************
+Arena slabs and allocation headers
+
+Arena contexts bump allocate from slabs rather than calling malloc() for each allocation.  Each allocation is preceded by a header
+so the allocation can be found from the buffer without searching.  Sizes are aligned so buffers have the same alignment as malloc().
+***********************************************************************************************************************************/
+typedef struct MemContextSlab
+{
+    struct MemContextSlab *next;                                    // Next (older) slab
+    size_t size;                                                    // Size of the slab data
+    size_t used;                                                    // Bytes of the slab data that have been allocated
+} MemContextSlab;
+
+typedef struct MemContextArenaAlloc
+{
+    MemContext *context;                                            // Context of the allocation (NULL once freed)
+    size_t size;                                                    // Allocation size
+} MemContextArenaAlloc;
+
+#define MEM_CONTEXT_ARENA_ALIGN                                     16
+#define MEM_CONTEXT_ARENA_ALIGN_SIZE(size)                                                                                         \
+    (((size) + MEM_CONTEXT_ARENA_ALIGN - 1) & ~((size_t)MEM_CONTEXT_ARENA_ALIGN - 1))
+
+#define MEM_CONTEXT_ARENA_HEADER_SIZE                               MEM_CONTEXT_ARENA_ALIGN_SIZE(sizeof(MemContextArenaAlloc))
+#define MEM_CONTEXT_SLAB_HEADER_SIZE                                MEM_CONTEXT_ARENA_ALIGN_SIZE(sizeof(MemContextSlab))
+#define MEM_CONTEXT_SLAB_DATA(slab)                                 ((unsigned char *)(slab) + MEM_CONTEXT_SLAB_HEADER_SIZE)
+
 /***********************************************************************************************************************************
 Contains information about the memory context
 ***********************************************************************************************************************************/
@@ -38,6 +65,9 @@ struct MemContext
     unsigned int contextChildListSize;                              // Size of child context list (not the actual count of contexts)
     unsigned int contextChildFreeIdx;                               // Index of first free space in the context list
 
+    bool arena;                                                     // Are allocations made from slabs?
+    MemContextSlab *slabList;                                       // Slabs used by the arena (most recent first)
+
     MemContextAlloc *allocList;                                     // List of memory allocations created in this context
     unsigned int allocListSize;                                     // Size of alloc list (not the actual count of allocations)
     unsigned int allocFreeIdx;                                      // Index of first free space in the alloc list
@@ -191,11 +221,12 @@ memContextNewIndex(MemContext *memContext, bool allowFree)
 /***********************************************************************************************************************************
 Create a new memory context
 ***********************************************************************************************************************************/
-MemContext *
-memContextNew(const char *name)
+static MemContext *
+memContextNewInternal(const char *name, bool arena)
 {
     FUNCTION_TEST_BEGIN();
         FUNCTION_TEST_PARAM(STRINGZ, name);
+        FUNCTION_TEST_PARAM(BOOL, arena);
     FUNCTION_TEST_END();
 
     ASSERT(name != NULL);
@@ -213,9 +244,14 @@ memContextNew(const char *name)
     // Get the context
     MemContext *this = contextCurrent->contextChildList[contextIdx];
 
-    // Create initial space for allocations
-    this->allocList = memAllocInternal(sizeof(MemContextAlloc) * MEM_CONTEXT_ALLOC_INITIAL_SIZE, true);
-    this->allocListSize = MEM_CONTEXT_ALLOC_INITIAL_SIZE;
+    // Create initial space for allocations.  Arena contexts allocate a slab on the first allocation instead.
+    if (arena)
+        this->arena = true;
+    else
+    {
+        this->allocList = memAllocInternal(sizeof(MemContextAlloc) * MEM_CONTEXT_ALLOC_INITIAL_SIZE, true);
+        this->allocListSize = MEM_CONTEXT_ALLOC_INITIAL_SIZE;
+    }
 
     // Set the context name
     this->name = name;
@@ -234,6 +270,33 @@ memContextNew(const char *name)
     FUNCTION_TEST_RETURN(this);
 }
 
+MemContext *
+memContextNew(const char *name)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(STRINGZ, name);
+    FUNCTION_TEST_END();
+
+    FUNCTION_TEST_RETURN(memContextNewInternal(name, false));
+}
+
+/***********************************************************************************************************************************
+Create a new arena memory context
+
+Allocations are bump allocated from slabs so they are cheap to make, and memFree()/memGrowRaw() find the allocation from its header
+rather than searching the allocation list.  Freed memory is only reused when it is the most recent allocation so arena contexts are
+best for objects that make many small allocations and are freed all at once, e.g. lists of strings.
+***********************************************************************************************************************************/
+MemContext *
+memContextNewArena(const char *name)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(STRINGZ, name);
+    FUNCTION_TEST_END();
+
+    FUNCTION_TEST_RETURN(memContextNewInternal(name, true));
+}
+
 /***********************************************************************************************************************************
 Register a callback to be called just before the context is freed
 ***********************************************************************************************************************************/
@@ -294,6 +357,164 @@ memContextCallbackClear(MemContext *this)
     FUNCTION_TEST_RETURN_VOID();
 }
 
+/***********************************************************************************************************************************
+Allocate memory from the current arena context
+***********************************************************************************************************************************/
+static void *
+memArenaAlloc(size_t size, bool zero)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(SIZE, size);
+        FUNCTION_TEST_PARAM(BOOL, zero);
+    FUNCTION_TEST_END();
+
+    ASSERT(contextCurrent->arena);
+
+    size_t sizeTotal = MEM_CONTEXT_ARENA_HEADER_SIZE + MEM_CONTEXT_ARENA_ALIGN_SIZE(size);
+    MemContextSlab *slab = contextCurrent->slabList;
+
+    // If the allocation does not fit in the current slab then allocate a new slab
+    if (slab == NULL || slab->size - slab->used < sizeTotal)
+    {
+        // Large allocations get a slab of their own.  It is linked after the current slab so the space left in the current slab can
+        // still be used.
+        if (sizeTotal > MEM_CONTEXT_ARENA_SLAB_SIZE / 4)
+        {
+            MemContextSlab *slabNew = memAllocInternal(MEM_CONTEXT_SLAB_HEADER_SIZE + sizeTotal, false);
+            *slabNew = (MemContextSlab){.size = sizeTotal};
+
+            if (slab == NULL)
+                contextCurrent->slabList = slabNew;
+            else
+            {
+                slabNew->next = slab->next;
+                slab->next = slabNew;
+            }
+
+            slab = slabNew;
+        }
+        // Else start a new current slab
+        else
+        {
+            slab = memAllocInternal(MEM_CONTEXT_SLAB_HEADER_SIZE + MEM_CONTEXT_ARENA_SLAB_SIZE, false);
+            *slab = (MemContextSlab){.next = contextCurrent->slabList, .size = MEM_CONTEXT_ARENA_SLAB_SIZE};
+            contextCurrent->slabList = slab;
+        }
+    }
+
+    // Bump allocate and set the header
+    MemContextArenaAlloc *alloc = (MemContextArenaAlloc *)(MEM_CONTEXT_SLAB_DATA(slab) + slab->used);
+    *alloc = (MemContextArenaAlloc){.context = contextCurrent, .size = size};
+    slab->used += sizeTotal;
+
+    void *buffer = (unsigned char *)alloc + MEM_CONTEXT_ARENA_HEADER_SIZE;
+
+    if (zero)
+        memset(buffer, 0, size);
+
+    FUNCTION_TEST_RETURN(buffer);
+}
+
+/***********************************************************************************************************************************
+Find an allocation in the current arena context from its header
+***********************************************************************************************************************************/
+static MemContextArenaAlloc *
+memArenaFind(const void *buffer)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM_P(VOID, buffer);
+    FUNCTION_TEST_END();
+
+    ASSERT(buffer != NULL);
+
+    MemContextArenaAlloc *alloc = (MemContextArenaAlloc *)((unsigned char *)buffer - MEM_CONTEXT_ARENA_HEADER_SIZE);
+
+    // Error if the allocation was not made in the current context or has been freed
+    if (alloc->context != contextCurrent)
+        THROW(AssertError, "unable to find allocation");
+
+    FUNCTION_TEST_RETURN(alloc);
+}
+
+/***********************************************************************************************************************************
+Is this the most recent allocation in the current slab?  If so, it can be freed or grown in place.
+***********************************************************************************************************************************/
+static bool
+memArenaLast(const MemContextArenaAlloc *alloc)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM_P(VOID, alloc);
+    FUNCTION_TEST_END();
+
+    ASSERT(alloc != NULL);
+
+    const MemContextSlab *slab = contextCurrent->slabList;
+
+    FUNCTION_TEST_RETURN(
+        (const unsigned char *)alloc + MEM_CONTEXT_ARENA_HEADER_SIZE + MEM_CONTEXT_ARENA_ALIGN_SIZE(alloc->size) ==
+            MEM_CONTEXT_SLAB_DATA(slab) + slab->used);
+}
+
+/***********************************************************************************************************************************
+Grow an allocation in the current arena context
+***********************************************************************************************************************************/
+static void *
+memArenaGrow(const void *buffer, size_t size)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM_P(VOID, buffer);
+        FUNCTION_TEST_PARAM(SIZE, size);
+    FUNCTION_TEST_END();
+
+    ASSERT(buffer != NULL);
+
+    MemContextArenaAlloc *alloc = memArenaFind(buffer);
+    MemContextSlab *slab = contextCurrent->slabList;
+    void *result = NULL;
+
+    // Grow in place when this is the most recent allocation and there is room in the slab
+    if (memArenaLast(alloc) &&
+        MEM_CONTEXT_ARENA_ALIGN_SIZE(size) <= slab->size - slab->used + MEM_CONTEXT_ARENA_ALIGN_SIZE(alloc->size))
+    {
+        slab->used = slab->used - MEM_CONTEXT_ARENA_ALIGN_SIZE(alloc->size) + MEM_CONTEXT_ARENA_ALIGN_SIZE(size);
+        alloc->size = size;
+        result = (void *)buffer;
+    }
+    // Else allocate and copy.  The old allocation is not the most recent anymore so its space is not reused until the context is
+    // freed.
+    else
+    {
+        result = memArenaAlloc(size, false);
+        memcpy(result, buffer, alloc->size < size ? alloc->size : size);
+        alloc->context = NULL;
+    }
+
+    FUNCTION_TEST_RETURN(result);
+}
+
+/***********************************************************************************************************************************
+Free an allocation in the current arena context
+***********************************************************************************************************************************/
+static void
+memArenaFree(void *buffer)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM_P(VOID, buffer);
+    FUNCTION_TEST_END();
+
+    ASSERT(buffer != NULL);
+
+    MemContextArenaAlloc *alloc = memArenaFind(buffer);
+
+    // Reuse the space if this is the most recent allocation
+    if (memArenaLast(alloc))
+        contextCurrent->slabList->used -= MEM_CONTEXT_ARENA_HEADER_SIZE + MEM_CONTEXT_ARENA_ALIGN_SIZE(alloc->size);
+
+    alloc->context = NULL;
+
+    FUNCTION_TEST_RETURN_VOID();
+}
+
 /***********************************************************************************************************************************
 Allocate memory in the memory context and optionally zero it.
 ***********************************************************************************************************************************/
@@ -305,6 +526,9 @@ memContextAlloc(size_t size, bool zero)
         FUNCTION_TEST_PARAM(BOOL, zero);
     FUNCTION_TEST_END();
 
+    if (contextCurrent->arena)
+        FUNCTION_TEST_RETURN(memArenaAlloc(size, zero));
+
     // Find space for the new allocation
     for (; contextCurrent->allocFreeIdx < contextCurrent->allocListSize; contextCurrent->allocFreeIdx++)
         if (!contextCurrent->allocList[contextCurrent->allocFreeIdx].active)
@@ -400,6 +624,9 @@ memGrowRaw(const void *buffer, size_t size)
 
     ASSERT(buffer != NULL);
 
+    if (contextCurrent->arena)
+        FUNCTION_TEST_RETURN(memArenaGrow(buffer, size));
+
     // Find the allocation
     MemContextAlloc *alloc = &(contextCurrent->allocList[memFind(buffer)]);
 
@@ -435,17 +662,22 @@ memFree(void *buffer)
 
     ASSERT(buffer != NULL);
 
-    // Find the allocation
-    unsigned int allocIdx = memFind(buffer);
-    MemContextAlloc *alloc = &(contextCurrent->allocList[allocIdx]);
+    if (contextCurrent->arena)
+        memArenaFree(buffer);
+    else
+    {
+        // Find the allocation
+        unsigned int allocIdx = memFind(buffer);
+        MemContextAlloc *alloc = &(contextCurrent->allocList[allocIdx]);
 
-    // Free the buffer
-    memFreeInternal(alloc->buffer);
-    alloc->active = false;
+        // Free the buffer
+        memFreeInternal(alloc->buffer);
+        alloc->active = false;
 
-    // If this allocation is before the current free allocation then make it the current free allocation
-    if (allocIdx < contextCurrent->allocFreeIdx)
-        contextCurrent->allocFreeIdx = allocIdx;
+        // If this allocation is before the current free allocation then make it the current free allocation
+        if (allocIdx < contextCurrent->allocFreeIdx)
+            contextCurrent->allocFreeIdx = allocIdx;
+    }
 
     FUNCTION_TEST_RETURN_VOID();
 }
@@ -622,6 +854,15 @@ memContextFree(MemContext *this)
             this->allocListSize = 0;
         }
 
+        // Free arena slabs
+        while (this->slabList != NULL)
+        {
+            MemContextSlab *slab = this->slabList;
+            this->slabList = slab->next;
+
+            memFreeInternal(slab);
+        }
+
         // If the context index is lower than the current free index in the parent then replace it
         if (this->contextParent != NULL && this->contextParentIdx < this->contextParent->contextChildFreeIdx)
             this->contextParent->contextChildFreeIdx = this->contextParentIdx;
@@ -28,6 +28,13 @@ Space is reserved for this many allocations when a context is created.  When mor
 ***********************************************************************************************************************************/
 #define MEM_CONTEXT_ALLOC_INITIAL_SIZE                              4
 
+/***********************************************************************************************************************************
+Define the slab size used by arena contexts
+
+Allocations larger than a quarter of this size are given a slab of their own.
+***********************************************************************************************************************************/
+#define MEM_CONTEXT_ARENA_SLAB_SIZE                                 ((size_t)32 * 1024)
+
 /***********************************************************************************************************************************
 Memory context callback function type, useful for casts in memContextCallback()
 ***********************************************************************************************************************************/
@@ -59,6 +66,7 @@ TRY_END();
 Use the MEM_CONTEXT*() macros when possible rather than implement error-handling for every memory context block.
 ***********************************************************************************************************************************/
 MemContext *memContextNew(const char *name);
+MemContext *memContextNewArena(const char *name);
 void memContextMove(MemContext *this, MemContext *parentNew);
 void memContextCallback(MemContext *this, void (*callbackFunction)(void *), void *callbackArgument);
 void memContextCallbackClear(MemContext *this);
@@ -142,6 +150,13 @@ Note that memory context names are expected to live for the lifetime of the cont
                                                                                                                                    \
     MEM_CONTEXT_BEGIN(MEM_CONTEXT_NEW())
 
+// Same as MEM_CONTEXT_NEW_BEGIN() but the context is created with memContextNewArena()
+#define MEM_CONTEXT_NEW_ARENA_BEGIN(memContextName)                                                                                \
+{                                                                                                                                  \
+    MemContext *MEM_CONTEXT_NEW() = memContextNewArena(memContextName);                                                            \
+                                                                                                                                   \
+    MEM_CONTEXT_BEGIN(MEM_CONTEXT_NEW())
+
 #define MEM_CONTEXT_NEW_END()                                                                                                      \
     CATCH_ANY()                                                                                                                    \
     {                                                                                                                              \
@@ -0,0 +1,25 @@
+/***********************************************************************************************************************************
+Thread Handler
+***********************************************************************************************************************************/
+#include "common/debug.h"
+#include "common/error.h"
+#include "common/thread.h"
+
+/***********************************************************************************************************************************
+Throw an error returned by a pthread function
+
+The pthread functions return the error rather than setting errno so the error is passed explicitly.
+***********************************************************************************************************************************/
+void
+threadError(int error, const char *function)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(INT, error);
+        FUNCTION_TEST_PARAM(STRINGZ, function);
+    FUNCTION_TEST_END();
+
+    if (error != 0)
+        THROW_SYS_ERROR_CODE_FMT(error, KernelError, "unable to %s", function);
+
+    FUNCTION_TEST_RETURN_VOID();
+}
@@ -0,0 +1,17 @@
+/***********************************************************************************************************************************
+Thread Handler
+
+Threads are used to overlap work that does not need the rest of the C library, e.g. compression, encryption, and file I/O.  A thread
+must not use memory contexts, error handling, logging, or function tracing since none of them are thread-safe.  All memory used by a
+thread is allocated by the main thread and the thread only calls functions that report errors with a return value (e.g. zlib,
+OpenSSL, and system calls).  Errors are returned to the main thread, which reports them.
+***********************************************************************************************************************************/
+#ifndef COMMON_THREAD_H
+#define COMMON_THREAD_H
+
+/***********************************************************************************************************************************
+Functions
+***********************************************************************************************************************************/
+void threadError(int error, const char *function);
+
+#endif
@@ -17,6 +17,7 @@ struct Buffer
     bool limitSet;                                                  // Has a limit been set?
     size_t limit;                                                   // Limited reported size of the buffer to make it appear smaller
     size_t used;                                                    // Amount of buffer used
+    bool external;                                                  // Is the memory owned by someone else? (no resize allowed)
     unsigned char *buffer;                                          // Buffer allocation
 };
 
@@ -70,6 +71,38 @@ bufNewC(size_t size, const void *buffer)
     FUNCTION_TEST_RETURN(this);
 }
 
+/***********************************************************************************************************************************
+Create a new buffer that uses existing memory
+
+No data is copied so the memory must not be freed while the buffer is in use.  The buffer cannot be resized since the memory is
+owned by the caller.  This is useful for passing a region of a larger buffer to a function that expects a Buffer.
+***********************************************************************************************************************************/
+Buffer *
+bufNewUseC(void *buffer, size_t size)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM_P(VOID, buffer);
+        FUNCTION_TEST_PARAM(SIZE, size);
+    FUNCTION_TEST_END();
+
+    ASSERT(buffer != NULL || size == 0);
+
+    Buffer *this = NULL;
+
+    MEM_CONTEXT_NEW_BEGIN("Buffer")
+    {
+        this = memNew(sizeof(Buffer));
+        this->memContext = MEM_CONTEXT_NEW();
+        this->external = true;
+        this->buffer = buffer;
+        this->size = size;
+        this->used = size;
+    }
+    MEM_CONTEXT_NEW_END();
+
+    FUNCTION_TEST_RETURN(this);
+}
+
 /***********************************************************************************************************************************
 Create a new buffer from a string
 ***********************************************************************************************************************************/
@@ -259,6 +292,7 @@ bufResize(Buffer *this, size_t size)
     FUNCTION_TEST_END();
 
     ASSERT(this != NULL);
+    ASSERT(!this->external);
 
     // Only resize if it the new size is different
     if (this->size != size)
@@ -476,6 +510,32 @@ bufUsedZero(Buffer *this)
     FUNCTION_TEST_RETURN_VOID();
 }
 
+/***********************************************************************************************************************************
+Point a buffer created with bufNewUseC() at different memory
+
+This allows a single buffer object to be reused for many regions without an allocation for each one.
+***********************************************************************************************************************************/
+void
+bufUseC(Buffer *this, void *buffer, size_t size)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(BUFFER, this);
+        FUNCTION_TEST_PARAM_P(VOID, buffer);
+        FUNCTION_TEST_PARAM(SIZE, size);
+    FUNCTION_TEST_END();
+
+    ASSERT(this != NULL);
+    ASSERT(this->external);
+    ASSERT(buffer != NULL || size == 0);
+
+    this->buffer = buffer;
+    this->size = size;
+    this->used = size;
+    this->limitSet = false;
+
+    FUNCTION_TEST_RETURN_VOID();
+}
+
 /***********************************************************************************************************************************
 Render as string for logging
 ***********************************************************************************************************************************/
@@ -18,6 +18,7 @@ Functions
 Buffer *bufNew(size_t size);
 Buffer *bufNewC(size_t size, const void *buffer);
 Buffer *bufNewStr(const String *string);
+Buffer *bufNewUseC(void *buffer, size_t size);
 Buffer *bufNewZ(const char *string);
 
 Buffer *bufCat(Buffer *this, const Buffer *cat);
@@ -39,6 +40,7 @@ size_t bufUsed(const Buffer *this);
 void bufUsedInc(Buffer *this, size_t inc);
 void bufUsedSet(Buffer *this, size_t used);
 void bufUsedZero(Buffer *this);
+void bufUseC(Buffer *this, void *buffer, size_t size);
 
 void bufFree(Buffer *this);
 
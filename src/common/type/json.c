@@ -336,13 +336,17 @@ jsonToVar(const String *json)
 
 /***********************************************************************************************************************************
 Output and escape a string
+
+Info files are checksummed by Perl after rendering each value with JSON::PP, which does not escape '/', so escapeSlash is false when
+rendering values for info files.
 ***********************************************************************************************************************************/
 static void
-jsonStringRender(String *json, const String *string)
+jsonStringRender(String *json, const String *string, bool escapeSlash)
 {
     FUNCTION_TEST_BEGIN();
         FUNCTION_TEST_PARAM(STRING, json);
         FUNCTION_TEST_PARAM(STRING, string);
+        FUNCTION_TEST_PARAM(BOOL, escapeSlash);
     FUNCTION_TEST_END();
 
     ASSERT(json != NULL);
@@ -372,7 +376,7 @@ jsonStringRender(String *json, const String *string)
                     break;
 
                 case '/':
-                    strCat(json, "\\/");
+                    strCat(json, escapeSlash ? "\\/" : "/");
                     break;
 
                 case '\n':
@@ -411,12 +415,13 @@ jsonStringRender(String *json, const String *string)
 Internal recursive function to walk a KeyValue and return a json string
 ***********************************************************************************************************************************/
 static String *
-kvToJsonInternal(const KeyValue *kv, String *indentSpace, String *indentDepth)
+kvToJsonInternal(const KeyValue *kv, String *indentSpace, String *indentDepth, bool escapeSlash)
 {
     FUNCTION_TEST_BEGIN();
         FUNCTION_TEST_PARAM(KEY_VALUE, kv);
         FUNCTION_TEST_PARAM(STRING, indentSpace);
         FUNCTION_TEST_PARAM(STRING, indentDepth);
+        FUNCTION_TEST_PARAM(BOOL, escapeSlash);
     FUNCTION_TEST_END();
 
     ASSERT(kv != NULL);
@@ -456,7 +461,7 @@ kvToJsonInternal(const KeyValue *kv, String *indentSpace, String *indentDepth)
             else if (varType(value) == varTypeKeyValue)
             {
                 strCat(indentDepth, strPtr(indentSpace));
-                strCat(result, strPtr(kvToJsonInternal(kvDup(varKv(value)), indentSpace, indentDepth)));
+                strCat(result, strPtr(kvToJsonInternal(kvDup(varKv(value)), indentSpace, indentDepth, escapeSlash)));
             }
             // VariantList
             else if (varType(value) == varTypeVariantList)
@@ -487,12 +492,13 @@ kvToJsonInternal(const KeyValue *kv, String *indentSpace, String *indentDepth)
                         // If the type is a string, add leading and trailing double quotes
                         else if (varType(arrayValue) == varTypeString)
                         {
-                            jsonStringRender(result, varStr(arrayValue));
+                            jsonStringRender(result, varStr(arrayValue), escapeSlash);
                         }
                         else if (varType(arrayValue) == varTypeKeyValue)
                         {
                             strCat(indentDepth, strPtr(indentSpace));
-                            strCat(result, strPtr(kvToJsonInternal(kvDup(varKv(arrayValue)), indentSpace, indentDepth)));
+                            strCat(
+                                result, strPtr(kvToJsonInternal(kvDup(varKv(arrayValue)), indentSpace, indentDepth, escapeSlash)));
                         }
                         // Numeric, Boolean or other type
                         else
@@ -508,7 +514,7 @@ kvToJsonInternal(const KeyValue *kv, String *indentSpace, String *indentDepth)
             // String
             else if (varType(value) == varTypeString)
             {
-                jsonStringRender(result, varStr(value));
+                jsonStringRender(result, varStr(value), escapeSlash);
             }
             // Numeric, Boolean or other type
             else
@@ -529,19 +535,16 @@ kvToJsonInternal(const KeyValue *kv, String *indentSpace, String *indentDepth)
 }
 
 /***********************************************************************************************************************************
-Convert KeyValue object to JSON string. If indent = 0 then no pretty format.
-
-Currently this function is only intended to convert the limited types that are included in info files.  More types will be added as
-needed.  Since this function is only intended to read internally-generated JSON it is assumed to be well-formed with no extraneous
-whitespace.
+Render a KeyValue object as JSON, optionally escaping '/'
 ***********************************************************************************************************************************/
-String *
-kvToJson(const KeyValue *kv, unsigned int indent)
+static String *
+kvToJsonRender(const KeyValue *kv, unsigned int indent, bool escapeSlash)
 {
-    FUNCTION_LOG_BEGIN(logLevelTrace);
-        FUNCTION_LOG_PARAM(KEY_VALUE, kv);
-        FUNCTION_LOG_PARAM(UINT, indent);
-    FUNCTION_LOG_END();
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(KEY_VALUE, kv);
+        FUNCTION_TEST_PARAM(UINT, indent);
+        FUNCTION_TEST_PARAM(BOOL, escapeSlash);
+    FUNCTION_TEST_END();
 
     ASSERT(kv != NULL);
 
@@ -562,7 +565,7 @@ kvToJson(const KeyValue *kv, unsigned int indent)
             strCat(indentDepth, "\n");
 
         strCat(indentDepth, strPtr(indentSpace));
-        strCat(jsonStr, strPtr(kvToJsonInternal(kv, indentSpace, indentDepth)));
+        strCat(jsonStr, strPtr(kvToJsonInternal(kv, indentSpace, indentDepth, escapeSlash)));
 
         // Add terminating linefeed for pretty print if it is not already added
         if (indent > 0 && !strEndsWithZ(jsonStr, "\n"))
@@ -575,30 +578,66 @@ kvToJson(const KeyValue *kv, unsigned int indent)
     }
     MEM_CONTEXT_TEMP_END();
 
-    FUNCTION_LOG_RETURN(STRING, result);
+    FUNCTION_TEST_RETURN(result);
 }
 
 /***********************************************************************************************************************************
-Convert Variant object to JSON string. If indent = 0 then no pretty format.
+Convert KeyValue object to JSON string. If indent = 0 then no pretty format.
 
 Currently this function is only intended to convert the limited types that are included in info files.  More types will be added as
-needed.
+needed.  Since this function is only intended to read internally-generated JSON it is assumed to be well-formed with no extraneous
+whitespace.
 ***********************************************************************************************************************************/
 String *
-varToJson(const Variant *var, unsigned int indent)
+kvToJson(const KeyValue *kv, unsigned int indent)
 {
     FUNCTION_LOG_BEGIN(logLevelTrace);
-        FUNCTION_LOG_PARAM(VARIANT, var);
+        FUNCTION_LOG_PARAM(KEY_VALUE, kv);
         FUNCTION_LOG_PARAM(UINT, indent);
     FUNCTION_LOG_END();
 
+    ASSERT(kv != NULL);
+
+    FUNCTION_LOG_RETURN(STRING, kvToJsonRender(kv, indent, true));
+}
+
+/***********************************************************************************************************************************
+Convert KeyValue object to JSON string the way values are rendered in info files, i.e. with no pretty format and '/' not escaped
+***********************************************************************************************************************************/
+String *
+kvToJsonInfo(const KeyValue *kv)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(KEY_VALUE, kv);
+    FUNCTION_LOG_END();
+
+    ASSERT(kv != NULL);
+
+    FUNCTION_LOG_RETURN(STRING, kvToJsonRender(kv, 0, false));
+}
+
+/***********************************************************************************************************************************
+Render a Variant object as JSON, optionally escaping '/'
+***********************************************************************************************************************************/
+static String *
+varToJsonRender(const Variant *var, unsigned int indent, bool escapeSlash)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(VARIANT, var);
+        FUNCTION_TEST_PARAM(UINT, indent);
+        FUNCTION_TEST_PARAM(BOOL, escapeSlash);
+    FUNCTION_TEST_END();
+
     ASSERT(var != NULL);
 
     String *result = NULL;
 
-    // Currently the variant to parse must be either a VariantList or a KeyValue type.
-    if (varType(var) != varTypeVariantList && varType(var) != varTypeKeyValue)
+    // Currently the variant to parse must be a VariantList, KeyValue, String, or Boolean type.
+    if (varType(var) != varTypeVariantList && varType(var) != varTypeKeyValue && varType(var) != varTypeString &&
+        varType(var) != varTypeBool)
+    {
         THROW(JsonFormatError, "variant type is invalid");
+    }
 
     MEM_CONTEXT_TEMP_BEGIN()
     {
@@ -636,7 +675,7 @@ varToJson(const Variant *var, unsigned int indent)
 
                     // Update the depth before processing the contents of the list element
                     strCat(indentDepth, strPtr(indentSpace));
-                    strCat(jsonStr, strPtr(kvToJsonInternal(varKv(varLstGet(vl, vlIdx)), indentSpace, indentDepth)));
+                    strCat(jsonStr, strPtr(kvToJsonInternal(varKv(varLstGet(vl, vlIdx)), indentSpace, indentDepth, escapeSlash)));
                 }
 
                 // Decrease the depth
@@ -650,9 +689,14 @@ varToJson(const Variant *var, unsigned int indent)
             else
                 strCat(jsonStr, "[]");
         }
-        // Else just convert the KeyValue
+        // Else if KeyValue then convert it
+        else if (varType(var) == varTypeKeyValue)
+            strCat(jsonStr, strPtr(kvToJsonInternal(varKv(var), indentSpace, indentDepth, escapeSlash)));
+        // Else render the scalar
+        else if (varType(var) == varTypeString)
+            jsonStringRender(jsonStr, varStr(var), escapeSlash);
         else
-            strCat(jsonStr, strPtr(kvToJsonInternal(varKv(var), indentSpace, indentDepth)));
+            strCat(jsonStr, strPtr(varStrForce(var)));
 
         // Add terminating linefeed for pretty print if it is not already added
         if (indent > 0 && !strEndsWithZ(jsonStr, "\n"))
@@ -665,5 +709,39 @@ varToJson(const Variant *var, unsigned int indent)
     }
     MEM_CONTEXT_TEMP_END();
 
-    FUNCTION_LOG_RETURN(STRING, result);
+    FUNCTION_TEST_RETURN(result);
+}
+
+/***********************************************************************************************************************************
+Convert Variant object to JSON string. If indent = 0 then no pretty format.
+
+Currently this function is only intended to convert the limited types that are included in info files.  More types will be added as
+needed.
+***********************************************************************************************************************************/
+String *
+varToJson(const Variant *var, unsigned int indent)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(VARIANT, var);
+        FUNCTION_LOG_PARAM(UINT, indent);
+    FUNCTION_LOG_END();
+
+    ASSERT(var != NULL);
+
+    FUNCTION_LOG_RETURN(STRING, varToJsonRender(var, indent, true));
+}
+
+/***********************************************************************************************************************************
+Convert Variant object to JSON string the way values are rendered in info files, i.e. with no pretty format and '/' not escaped
+***********************************************************************************************************************************/
+String *
+varToJsonInfo(const Variant *var)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(VARIANT, var);
+    FUNCTION_LOG_END();
+
+    ASSERT(var != NULL);
+
+    FUNCTION_LOG_RETURN(STRING, varToJsonRender(var, 0, false));
 }
@@ -14,4 +14,8 @@ Variant *jsonToVar(const String *json);
 String *kvToJson(const KeyValue *kv, unsigned int indent);
 String *varToJson(const Variant *var, unsigned int indent);
 
+// Render values for info files, which do not escape '/' so the checksum matches the checksum calculated by Perl
+String *kvToJsonInfo(const KeyValue *kv);
+String *varToJsonInfo(const Variant *var);
+
 #endif
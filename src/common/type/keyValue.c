@@ -2,6 +2,7 @@
 Key Value Handler
 ***********************************************************************************************************************************/
 #include <limits.h>
+#include <string.h>
 
 #include "common/debug.h"
 #include "common/memContext.h"
@@ -14,6 +15,11 @@ Constant to indicate key not found
 ***********************************************************************************************************************************/
 #define KEY_NOT_FOUND                                               UINT_MAX
 
+/***********************************************************************************************************************************
+Initial size of the key index.  The index is doubled when it is half full so there is always an empty slot to end a probe.
+***********************************************************************************************************************************/
+#define KEY_INDEX_INITIAL_SIZE                                      16
+
 /***********************************************************************************************************************************
 Contains information about the key value store
 ***********************************************************************************************************************************/
@@ -22,6 +28,9 @@ struct KeyValue
     MemContext *memContext;                                         // Mem context for the store
     List *list;                                                     // List of keys/values
     VariantList *keyList;                                           // List of keys
+
+    unsigned int *index;                                            // Open addressing index of list positions + 1 (0 is empty)
+    unsigned int indexSize;                                         // Size of the index (always a power of two)
 };
 
 /***********************************************************************************************************************************
@@ -31,8 +40,145 @@ typedef struct KeyValuePair
 {
     Variant *key;                                                   // The key
     Variant *value;                                                 // The value (this may be NULL)
+    uint64_t hash;                                                  // Hash of the key
 } KeyValuePair;
 
+/***********************************************************************************************************************************
+Hash a key.  Keys that are equal according to varEq() must have the same hash.
+***********************************************************************************************************************************/
+static uint64_t
+kvHashBytes(uint64_t hash, const void *data, size_t size)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM_P(VOID, data);
+        FUNCTION_TEST_PARAM(SIZE, size);
+    FUNCTION_TEST_END();
+
+    // FNV-1a
+    for (size_t dataIdx = 0; dataIdx < size; dataIdx++)
+        hash = (hash ^ ((const unsigned char *)data)[dataIdx]) * 0x100000001B3ULL;
+
+    FUNCTION_TEST_RETURN(hash);
+}
+
+static uint64_t
+kvHash(const Variant *key)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(VARIANT, key);
+    FUNCTION_TEST_END();
+
+    ASSERT(key != NULL);
+
+    VariantType type = varType(key);
+    uint64_t result = kvHashBytes(0xCBF29CE484222325ULL, &type, sizeof(type));
+
+    switch (type)
+    {
+        case varTypeBool:
+        {
+            bool value = varBool(key);
+            result = kvHashBytes(result, &value, sizeof(value));
+            break;
+        }
+
+        case varTypeDouble:
+        {
+            // Normalize zero since 0.0 == -0.0
+            double value = varDbl(key) == 0 ? 0 : varDbl(key);
+            result = kvHashBytes(result, &value, sizeof(value));
+            break;
+        }
+
+        case varTypeInt:
+        {
+            int value = varInt(key);
+            result = kvHashBytes(result, &value, sizeof(value));
+            break;
+        }
+
+        case varTypeInt64:
+        {
+            int64_t value = varInt64(key);
+            result = kvHashBytes(result, &value, sizeof(value));
+            break;
+        }
+
+        case varTypeUInt64:
+        {
+            uint64_t value = varUInt64(key);
+            result = kvHashBytes(result, &value, sizeof(value));
+            break;
+        }
+
+        case varTypeString:
+        {
+            result = kvHashBytes(result, strPtr(varStr(key)), strSize(varStr(key)));
+            break;
+        }
+
+        // These types cannot be compared by varEq() so only the type is hashed and varEq() will error when the key is compared
+        case varTypeKeyValue:
+        case varTypeVariantList:
+            break;
+    }
+
+    FUNCTION_TEST_RETURN(result);
+}
+
+/***********************************************************************************************************************************
+Add a list position to the index.  The index must have an empty slot.
+***********************************************************************************************************************************/
+static void
+kvIndexAdd(KeyValue *this, unsigned int listIdx)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(KEY_VALUE, this);
+        FUNCTION_TEST_PARAM(UINT, listIdx);
+    FUNCTION_TEST_END();
+
+    ASSERT(this != NULL);
+
+    unsigned int indexIdx = (unsigned int)(((const KeyValuePair *)lstGet(this->list, listIdx))->hash & (this->indexSize - 1));
+
+    while (this->index[indexIdx] != 0)
+        indexIdx = (indexIdx + 1) & (this->indexSize - 1);
+
+    this->index[indexIdx] = listIdx + 1;
+
+    FUNCTION_TEST_RETURN_VOID();
+}
+
+/***********************************************************************************************************************************
+Grow the index when adding another key would make it more than half full.  The correct mem context should be set before calling
+this function.
+***********************************************************************************************************************************/
+static void
+kvIndexGrow(KeyValue *this)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(KEY_VALUE, this);
+    FUNCTION_TEST_END();
+
+    ASSERT(this != NULL);
+
+    if ((lstSize(this->list) + 1) * 2 > this->indexSize)
+    {
+        unsigned int *indexOld = this->index;
+
+        this->indexSize = this->indexSize == 0 ? KEY_INDEX_INITIAL_SIZE : this->indexSize * 2;
+        this->index = memNew(sizeof(unsigned int) * this->indexSize);
+
+        for (unsigned int listIdx = 0; listIdx < lstSize(this->list); listIdx++)
+            kvIndexAdd(this, listIdx);
+
+        if (indexOld != NULL)
+            memFree(indexOld);
+    }
+
+    FUNCTION_TEST_RETURN_VOID();
+}
+
 /***********************************************************************************************************************************
 Create a new key/value store
 ***********************************************************************************************************************************/
@@ -81,6 +227,7 @@ kvDup(const KeyValue *source)
         KeyValuePair pair;
         pair.key = varDup(sourcePair->key);
         pair.value = varDup(sourcePair->value);
+        pair.hash = sourcePair->hash;
 
         // Add to the list
         lstAdd(this->list, &pair);
@@ -88,6 +235,18 @@ kvDup(const KeyValue *source)
 
     this->keyList = varLstDup(source->keyList);
 
+    // Copy the index since the list positions are the same
+    if (source->indexSize > 0)
+    {
+        MEM_CONTEXT_BEGIN(this->memContext)
+        {
+            this->index = memNewRaw(sizeof(unsigned int) * source->indexSize);
+            memcpy(this->index, source->index, sizeof(unsigned int) * source->indexSize);
+            this->indexSize = source->indexSize;
+        }
+        MEM_CONTEXT_END();
+    }
+
     FUNCTION_TEST_RETURN(this);
 }
 
@@ -105,18 +264,26 @@ kvGetIdx(const KeyValue *this, const Variant *key)
     ASSERT(this != NULL);
     ASSERT(key != NULL);
 
-    // Search for the key
+    // Search for the key in the index.  The probe ends at an empty slot, which always exists since the index is at most half full.
     unsigned int result = KEY_NOT_FOUND;
 
-    for (unsigned int listIdx = 0; listIdx < lstSize(this->list); listIdx++)
+    if (this->indexSize > 0)
     {
-        const KeyValuePair *pair = (const KeyValuePair *)lstGet(this->list, listIdx);
+        uint64_t hash = kvHash(key);
+        unsigned int indexIdx = (unsigned int)(hash & (this->indexSize - 1));
 
-        // Break if the key matches
-        if (varEq(key, pair->key))
+        while (this->index[indexIdx] != 0)
         {
-            result = listIdx;
-            break;
+            const KeyValuePair *pair = (const KeyValuePair *)lstGet(this->list, this->index[indexIdx] - 1);
+
+            // Break if the key matches
+            if (pair->hash == hash && varEq(key, pair->key))
+            {
+                result = this->index[indexIdx] - 1;
+                break;
+            }
+
+            indexIdx = (indexIdx + 1) & (this->indexSize - 1);
         }
     }
 
@@ -175,13 +342,18 @@ kvPutInternal(KeyValue *this, const Variant *key, Variant *value)
     // If the key was not found then add it
     if (listIdx == KEY_NOT_FOUND)
     {
+        // Make sure there is room in the index
+        kvIndexGrow(this);
+
         // Copy the pair
         KeyValuePair pair;
         pair.key = varDup(key);
         pair.value = value;
+        pair.hash = kvHash(key);
 
-        // Add to the list
+        // Add to the list and index
         lstAdd(this->list, &pair);
+        kvIndexAdd(this, lstSize(this->list) - 1);
 
         // Add to the key list
         varLstAdd(this->keyList, varDup(key));
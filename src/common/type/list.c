@@ -43,6 +43,33 @@ lstNew(size_t itemSize)
     FUNCTION_TEST_RETURN(this);
 }
 
+/***********************************************************************************************************************************
+Create a new list in an arena memory context
+
+Items that are allocated in the list's mem context (e.g. the strings in a StringList) are bump allocated, which is much faster for
+large lists.  See memContextNewArena() for details.
+***********************************************************************************************************************************/
+List *
+lstNewArena(size_t itemSize)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(SIZE, itemSize);
+    FUNCTION_TEST_END();
+
+    List *this = NULL;
+
+    MEM_CONTEXT_NEW_ARENA_BEGIN("List")
+    {
+        // Create object
+        this = memNew(sizeof(List));
+        this->memContext = MEM_CONTEXT_NEW();
+        this->itemSize = itemSize;
+    }
+    MEM_CONTEXT_NEW_END();
+
+    FUNCTION_TEST_RETURN(this);
+}
+
 /***********************************************************************************************************************************
 Add an item to the end of the list
 ***********************************************************************************************************************************/
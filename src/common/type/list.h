@@ -21,6 +21,7 @@ Define initial size of a list
 Functions
 ***********************************************************************************************************************************/
 List *lstNew(size_t itemSize);
+List *lstNewArena(size_t itemSize);
 List *lstAdd(List *this, const void *item);
 void *lstGet(const List *this, unsigned int listIdx);
 List *lstInsert(List *this, unsigned int listIdx, const void *item);
@@ -21,6 +21,19 @@ strLstNew(void)
     FUNCTION_TEST_RETURN((StringList *)lstNew(sizeof(String *)));
 }
 
+/***********************************************************************************************************************************
+Wrapper for lstNewArena()
+
+Use this for large lists that are built and then freed as a whole, e.g. a batch of keys.  Strings freed individually are not
+reclaimed until the list is freed so long-lived lists that are modified in place should use strLstNew().
+***********************************************************************************************************************************/
+StringList *
+strLstNewArena(void)
+{
+    FUNCTION_TEST_VOID();
+    FUNCTION_TEST_RETURN((StringList *)lstNewArena(sizeof(String *)));
+}
+
 /***********************************************************************************************************************************
 Internal add -- the string must have been created in the list's mem context before being passed
 ***********************************************************************************************************************************/
@@ -423,3 +423,52 @@ xmlDocumentFree(XmlDocument *this)
 
     FUNCTION_TEST_RETURN_VOID();
 }
+
+/***********************************************************************************************************************************
+Escape text so it can be added to xml as node content or an attribute value
+***********************************************************************************************************************************/
+String *
+xmlFromText(const String *text)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(STRING, text);
+    FUNCTION_TEST_END();
+
+    ASSERT(text != NULL);
+
+    String *result = strNew("");
+
+    for (unsigned int textIdx = 0; textIdx < strSize(text); textIdx++)
+    {
+        char textChar = strPtr(text)[textIdx];
+
+        switch (textChar)
+        {
+            case '&':
+                strCat(result, "&amp;");
+                break;
+
+            case '<':
+                strCat(result, "&lt;");
+                break;
+
+            case '>':
+                strCat(result, "&gt;");
+                break;
+
+            case '"':
+                strCat(result, "&quot;");
+                break;
+
+            case '\'':
+                strCat(result, "&apos;");
+                break;
+
+            default:
+                strCatChr(result, textChar);
+                break;
+        }
+    }
+
+    FUNCTION_TEST_RETURN(result);
+}
@@ -61,6 +61,11 @@ Node List Destructor
 ***********************************************************************************************************************************/
 void xmlNodeLstFree(XmlNodeList *this);
 
+/***********************************************************************************************************************************
+Functions
+***********************************************************************************************************************************/
+String *xmlFromText(const String *text);
+
 /***********************************************************************************************************************************
 Macros for function logging
 ***********************************************************************************************************************************/
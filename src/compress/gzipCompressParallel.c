@@ -0,0 +1,604 @@
+/***********************************************************************************************************************************
+Gzip Compress Parallel
+
+Blocks are compressed as raw deflate streams by worker threads.  Every block except the last is ended with a sync flush so it finishes
+on a byte boundary and can be concatenated with the next block.  The last block is finished normally, which marks the end of the
+deflate data.  The gzip header and trailer are written by the main thread, with the crc of each block combined in order as blocks
+are written.
+
+Workers follow the rules in common/thread.h and only report zlib results, which are checked by the main thread.
+***********************************************************************************************************************************/
+#include <limits.h>
+#include <pthread.h>
+#include <string.h>
+#include <zlib.h>
+
+#include "common/debug.h"
+#include "common/io/filter/filter.intern.h"
+#include "common/log.h"
+#include "common/memContext.h"
+#include "common/thread.h"
+#include "compress/gzip.h"
+#include "compress/gzipCompressParallel.h"
+
+/***********************************************************************************************************************************
+Filter type constant
+***********************************************************************************************************************************/
+#define GZIP_COMPRESS_PARALLEL_FILTER_TYPE                          "gzipCompressParallel"
+    STRING_STATIC(GZIP_COMPRESS_PARALLEL_FILTER_TYPE_STR,           GZIP_COMPRESS_PARALLEL_FILTER_TYPE);
+
+/***********************************************************************************************************************************
+Compression constants
+***********************************************************************************************************************************/
+#define MEM_LEVEL                                                   9
+
+// Size of the deflate window, which is the most of the prior block that can be used as a dictionary
+#define DICTIONARY_SIZE                                             ((size_t)32 * 1024)
+
+// Extra space required in the output buffer for the empty stored block written by a sync flush
+#define FLUSH_SIZE                                                  16
+
+// Size of the gzip header and trailer
+#define HEADER_SIZE                                                 10
+#define TRAILER_SIZE                                                8
+
+// Operating system written to the gzip header (unix)
+#define HEADER_OS                                                   3
+
+/***********************************************************************************************************************************
+Object types
+***********************************************************************************************************************************/
+typedef struct GzipCompressParallelJob
+{
+    Buffer *input;                                                  // Uncompressed block
+    Buffer *dictionary;                                             // End of the prior block used to prime compression
+    Buffer *output;                                                 // Compressed block
+
+    // Fields used by workers, which cannot call buffer functions
+    unsigned char *inputPtr;                                        // Uncompressed block data
+    unsigned int inputSize;                                         // Uncompressed block size
+    unsigned char *dictionaryPtr;                                   // Dictionary data
+    unsigned int dictionarySize;                                    // Dictionary size
+    unsigned char *outputPtr;                                       // Compressed block data
+    unsigned int outputSize;                                        // Space available for the compressed block
+    unsigned int outputUsed;                                        // Size of the compressed block
+    bool last;                                                      // Is this the last block?
+
+    bool done;                                                      // Has a worker finished compressing the block?
+    int result;                                                     // Result of compression
+    uLong crc;                                                      // Crc of the uncompressed block
+} GzipCompressParallelJob;
+
+typedef struct GzipCompressParallelWorker
+{
+    GzipCompressParallel *compress;                                 // Compress object that owns the worker
+    z_stream *stream;                                               // Compression stream state
+    pthread_t thread;                                               // Worker thread
+} GzipCompressParallelWorker;
+
+struct GzipCompressParallel
+{
+    MemContext *memContext;                                         // Context to store data
+    IoFilter *filter;                                               // Filter interface
+    bool raw;                                                       // Write raw deflate data without the gzip header/trailer?
+    size_t blockSize;                                               // Size of uncompressed blocks
+
+    pthread_mutex_t mutex;                                          // Protects job state shared with workers
+    pthread_cond_t jobCond;                                         // Signalled when a job is submitted or on shutdown
+    pthread_cond_t doneCond;                                        // Signalled when a job is done
+    bool shutdown;                                                  // Should workers exit?
+
+    unsigned int workerTotal;                                       // Total workers
+    unsigned int workerStarted;                                     // Workers with a running thread
+    GzipCompressParallelWorker *workerList;                         // List of workers
+
+    unsigned int jobTotal;                                          // Total jobs in the ring
+    GzipCompressParallelJob *jobList;                               // Ring of jobs
+    uint64_t jobSubmitTotal;                                        // Jobs submitted to workers
+    uint64_t jobStartTotal;                                         // Jobs started by workers
+    uint64_t jobOutputTotal;                                        // Jobs written to output
+    Buffer *dictionary;                                             // End of the last block submitted
+
+    size_t inputOffset;                                             // Offset of input not yet copied into a block
+    const Buffer *pending;                                          // Data being written to output
+    size_t pendingOffset;                                           // Offset of pending data not yet written
+    bool pendingJob;                                                // Is the pending data the output of the oldest job?
+    Buffer *header;                                                 // Gzip header
+    Buffer *trailer;                                                // Gzip trailer
+    uLong crc;                                                      // Crc of all uncompressed data written
+    uint64_t size;                                                  // Size of all uncompressed data written
+
+    bool inputSame;                                                 // Is the same input required on the next process call?
+    bool flush;                                                     // Is input complete and flushing in progress?
+    bool last;                                                      // Has the last block been submitted?
+    bool done;                                                      // Is compression done?
+};
+
+/***********************************************************************************************************************************
+Compress jobs until shutdown
+
+This runs on worker threads so it must only call zlib and pthread functions.
+***********************************************************************************************************************************/
+static void *
+gzipCompressParallelWorker(void *param)
+{
+    GzipCompressParallelWorker *worker = param;
+    GzipCompressParallel *this = worker->compress;
+
+    pthread_mutex_lock(&this->mutex);
+
+    while (true)
+    {
+        // Wait for a job
+        while (!this->shutdown && this->jobStartTotal == this->jobSubmitTotal)
+            pthread_cond_wait(&this->jobCond, &this->mutex);
+
+        if (this->shutdown)
+            break;
+
+        GzipCompressParallelJob *job = &this->jobList[this->jobStartTotal % this->jobTotal];
+        this->jobStartTotal++;
+
+        pthread_mutex_unlock(&this->mutex);
+
+        // Compress the block as a raw deflate stream primed with the end of the prior block
+        z_stream *stream = worker->stream;
+        int result = deflateReset(stream);
+
+        if (result == Z_OK && job->dictionarySize > 0)
+            result = deflateSetDictionary(stream, job->dictionaryPtr, job->dictionarySize);
+
+        if (result == Z_OK)
+        {
+            stream->next_in = job->inputPtr;
+            stream->avail_in = job->inputSize;
+            stream->next_out = job->outputPtr;
+            stream->avail_out = job->outputSize;
+
+            result = deflate(stream, job->last ? Z_FINISH : Z_SYNC_FLUSH);
+
+            // The output buffer is sized so the block always fits
+            if (stream->avail_out == 0 || (job->last && result != Z_STREAM_END))
+                result = Z_BUF_ERROR;
+
+            job->outputUsed = job->outputSize - stream->avail_out;
+        }
+
+        job->crc = crc32(crc32(0L, Z_NULL, 0), job->inputPtr, job->inputSize);
+
+        // Mark the job done
+        pthread_mutex_lock(&this->mutex);
+
+        job->result = result;
+        job->done = true;
+
+        pthread_cond_broadcast(&this->doneCond);
+    }
+
+    pthread_mutex_unlock(&this->mutex);
+
+    return NULL;
+}
+
+/***********************************************************************************************************************************
+New object
+***********************************************************************************************************************************/
+GzipCompressParallel *
+gzipCompressParallelNew(int level, bool raw, unsigned int threadTotal, size_t blockSize)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(INT, level);
+        FUNCTION_LOG_PARAM(BOOL, raw);
+        FUNCTION_LOG_PARAM(UINT, threadTotal);
+        FUNCTION_LOG_PARAM(SIZE, blockSize);
+    FUNCTION_LOG_END();
+
+    ASSERT(level >= -1 && level <= 9);
+    ASSERT(threadTotal > 0);
+    ASSERT(blockSize > 0 && blockSize <= UINT_MAX / 2);
+
+    GzipCompressParallel *this = NULL;
+
+    MEM_CONTEXT_NEW_BEGIN("GzipCompressParallel")
+    {
+        // Allocate state and set context
+        this = memNew(sizeof(GzipCompressParallel));
+        this->memContext = MEM_CONTEXT_NEW();
+        this->raw = raw;
+        this->blockSize = blockSize;
+
+        threadError(pthread_mutex_init(&this->mutex, NULL), "init mutex");
+        threadError(pthread_cond_init(&this->jobCond, NULL), "init condition");
+        threadError(pthread_cond_init(&this->doneCond, NULL), "init condition");
+
+        // Create compression streams for the workers.  The streams produce raw deflate data since the gzip header and trailer are
+        // written separately.
+        this->workerTotal = threadTotal;
+        this->workerList = memNew(sizeof(GzipCompressParallelWorker) * threadTotal);
+
+        for (unsigned int workerIdx = 0; workerIdx < threadTotal; workerIdx++)
+        {
+            GzipCompressParallelWorker *worker = &this->workerList[workerIdx];
+
+            worker->compress = this;
+            worker->stream = memNew(sizeof(z_stream));
+            gzipError(deflateInit2(worker->stream, level, Z_DEFLATED, gzipWindowBits(true), MEM_LEVEL, Z_DEFAULT_STRATEGY));
+        }
+
+        // Set free callback to ensure threads are stopped and gzip streams are freed
+        memContextCallback(this->memContext, (MemContextCallback)gzipCompressParallelFree, this);
+
+        // Create a ring of jobs large enough to keep all workers busy while completed jobs are waiting to be written.  Job data is
+        // allocated directly in this context since child contexts (e.g. buffers) are freed before the free callback stops the
+        // workers, which may still be using the data.
+        size_t outputSize = deflateBound(this->workerList[0].stream, blockSize) + FLUSH_SIZE;
+        size_t dictionarySize = blockSize < DICTIONARY_SIZE ? blockSize : DICTIONARY_SIZE;
+
+        this->jobTotal = threadTotal * 2;
+        this->jobList = memNew(sizeof(GzipCompressParallelJob) * this->jobTotal);
+
+        for (unsigned int jobIdx = 0; jobIdx < this->jobTotal; jobIdx++)
+        {
+            GzipCompressParallelJob *job = &this->jobList[jobIdx];
+
+            job->input = bufNewUseC(memNewRaw(blockSize), blockSize);
+            bufUsedZero(job->input);
+            job->dictionary = bufNewUseC(memNewRaw(dictionarySize), dictionarySize);
+            bufUsedZero(job->dictionary);
+            job->output = bufNewUseC(memNewRaw(outputSize), outputSize);
+            bufUsedZero(job->output);
+        }
+
+        // Create the gzip header.  The modification time is not stored.
+        if (!raw)
+        {
+            this->header = bufNewC(
+                HEADER_SIZE, (const unsigned char []){0x1f, 0x8b, Z_DEFLATED, 0, 0, 0, 0, 0, 0, HEADER_OS});
+            this->pending = this->header;
+        }
+
+        this->dictionary = bufNew(dictionarySize);
+        this->trailer = bufNew(TRAILER_SIZE);
+        this->crc = crc32(0L, Z_NULL, 0);
+
+        // Start the workers
+        for (unsigned int workerIdx = 0; workerIdx < threadTotal; workerIdx++)
+        {
+            GzipCompressParallelWorker *worker = &this->workerList[workerIdx];
+
+            threadError(pthread_create(&worker->thread, NULL, gzipCompressParallelWorker, worker), "create thread");
+            this->workerStarted++;
+        }
+
+        // Create filter interface
+        this->filter = ioFilterNewP(
+            GZIP_COMPRESS_PARALLEL_FILTER_TYPE_STR, this, .done = (IoFilterInterfaceDone)gzipCompressParallelDone,
+            .inOut = (IoFilterInterfaceProcessInOut)gzipCompressParallelProcess,
+            .inputSame = (IoFilterInterfaceInputSame)gzipCompressParallelInputSame);
+    }
+    MEM_CONTEXT_NEW_END();
+
+    FUNCTION_LOG_RETURN(GZIP_COMPRESS_PARALLEL, this);
+}
+
+/***********************************************************************************************************************************
+Submit the block being filled to the workers.  The block is primed with the end of the prior block and the end of this block is saved
+to prime the next block.
+***********************************************************************************************************************************/
+static void
+gzipCompressParallelSubmit(GzipCompressParallel *this, bool last)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(GZIP_COMPRESS_PARALLEL, this);
+        FUNCTION_TEST_PARAM(BOOL, last);
+    FUNCTION_TEST_END();
+
+    ASSERT(this != NULL);
+    ASSERT(this->jobSubmitTotal - this->jobOutputTotal < this->jobTotal);
+
+    GzipCompressParallelJob *job = &this->jobList[this->jobSubmitTotal % this->jobTotal];
+
+    bufUsedZero(job->dictionary);
+    bufCat(job->dictionary, this->dictionary);
+
+    if (!last)
+    {
+        bufUsedZero(this->dictionary);
+        bufCatSub(
+            this->dictionary, job->input, bufUsed(job->input) - bufSize(this->dictionary), bufSize(this->dictionary));
+    }
+
+    // Set fields for the worker
+    job->inputPtr = bufPtr(job->input);
+    job->inputSize = (unsigned int)bufUsed(job->input);
+    job->dictionaryPtr = bufPtr(job->dictionary);
+    job->dictionarySize = (unsigned int)bufUsed(job->dictionary);
+    job->outputPtr = bufPtr(job->output);
+    job->outputSize = (unsigned int)bufSize(job->output);
+    job->last = last;
+
+    pthread_mutex_lock(&this->mutex);
+
+    this->jobSubmitTotal++;
+    pthread_cond_signal(&this->jobCond);
+
+    pthread_mutex_unlock(&this->mutex);
+
+    this->last = last;
+
+    FUNCTION_TEST_RETURN_VOID();
+}
+
+/***********************************************************************************************************************************
+Write pending data to the output buffer.  If there is no pending data then get the next data to write: the output of the oldest job,
+or the trailer when all jobs have been written.  Returns false when the output buffer is full or the oldest job is not done and wait
+is false.
+***********************************************************************************************************************************/
+static bool
+gzipCompressParallelOutput(GzipCompressParallel *this, Buffer *compressed, bool wait)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(GZIP_COMPRESS_PARALLEL, this);
+        FUNCTION_TEST_PARAM(BUFFER, compressed);
+        FUNCTION_TEST_PARAM(BOOL, wait);
+    FUNCTION_TEST_END();
+
+    ASSERT(this != NULL);
+    ASSERT(compressed != NULL);
+
+    bool result = true;
+
+    // Get the next data to write
+    if (this->pending == NULL)
+    {
+        // Get the output of the oldest job
+        if (this->jobOutputTotal < this->jobSubmitTotal)
+        {
+            GzipCompressParallelJob *job = &this->jobList[this->jobOutputTotal % this->jobTotal];
+
+            pthread_mutex_lock(&this->mutex);
+
+            while (wait && !job->done)
+                pthread_cond_wait(&this->doneCond, &this->mutex);
+
+            bool done = job->done;
+
+            pthread_mutex_unlock(&this->mutex);
+
+            if (done)
+            {
+                gzipError(job->result);
+                bufUsedSet(job->output, job->outputUsed);
+
+                this->crc = crc32_combine(this->crc, job->crc, (z_off_t)bufUsed(job->input));
+                this->size += bufUsed(job->input);
+
+                this->pending = job->output;
+                this->pendingJob = true;
+            }
+            else
+                result = false;
+        }
+        // Else get the trailer
+        else if (this->last && !this->raw && bufUsed(this->trailer) == 0)
+        {
+            unsigned char *trailer = bufPtr(this->trailer);
+
+            for (unsigned int byteIdx = 0; byteIdx < 4; byteIdx++)
+            {
+                trailer[byteIdx] = (unsigned char)(this->crc >> (byteIdx * 8));
+                trailer[byteIdx + 4] = (unsigned char)(this->size >> (byteIdx * 8));
+            }
+
+            bufUsedSet(this->trailer, TRAILER_SIZE);
+            this->pending = this->trailer;
+        }
+    }
+
+    // Write as much pending data as will fit in the output buffer
+    if (this->pending != NULL)
+    {
+        size_t writeSize = bufUsed(this->pending) - this->pendingOffset;
+
+        if (writeSize > bufRemains(compressed))
+        {
+            writeSize = bufRemains(compressed);
+            result = false;
+        }
+
+        bufCatSub(compressed, this->pending, this->pendingOffset, writeSize);
+        this->pendingOffset += writeSize;
+
+        // If all pending data has been written then free the job for reuse
+        if (this->pendingOffset == bufUsed(this->pending))
+        {
+            if (this->pendingJob)
+            {
+                GzipCompressParallelJob *job = &this->jobList[this->jobOutputTotal % this->jobTotal];
+
+                bufUsedZero(job->input);
+                bufUsedZero(job->output);
+                job->done = false;
+
+                this->jobOutputTotal++;
+            }
+
+            this->pending = NULL;
+            this->pendingOffset = 0;
+            this->pendingJob = false;
+        }
+    }
+
+    FUNCTION_TEST_RETURN(result);
+}
+
+/***********************************************************************************************************************************
+Compress data
+***********************************************************************************************************************************/
+void
+gzipCompressParallelProcess(GzipCompressParallel *this, const Buffer *uncompressed, Buffer *compressed)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(GZIP_COMPRESS_PARALLEL, this);
+        FUNCTION_LOG_PARAM(BUFFER, uncompressed);
+        FUNCTION_LOG_PARAM(BUFFER, compressed);
+    FUNCTION_LOG_END();
+
+    ASSERT(this != NULL);
+    ASSERT(!this->done);
+    ASSERT(compressed != NULL);
+    ASSERT(!this->flush || uncompressed == NULL);
+
+    bool outputFull = false;
+
+    // Flushing
+    if (uncompressed == NULL)
+        this->flush = true;
+    // Else new input
+    else if (!this->inputSame)
+        this->inputOffset = 0;
+
+    // Copy input into blocks and submit each block when it is full
+    while (!outputFull && uncompressed != NULL && this->inputOffset < bufUsed(uncompressed))
+    {
+        // If all jobs are in use then the oldest job must be written before another block can be filled
+        if (this->jobSubmitTotal - this->jobOutputTotal == this->jobTotal)
+        {
+            outputFull = !gzipCompressParallelOutput(this, compressed, true);
+            continue;
+        }
+
+        GzipCompressParallelJob *job = &this->jobList[this->jobSubmitTotal % this->jobTotal];
+        size_t copySize = this->blockSize - bufUsed(job->input);
+
+        if (copySize > bufUsed(uncompressed) - this->inputOffset)
+            copySize = bufUsed(uncompressed) - this->inputOffset;
+
+        bufCatSub(job->input, uncompressed, this->inputOffset, copySize);
+        this->inputOffset += copySize;
+
+        if (bufUsed(job->input) == this->blockSize)
+            gzipCompressParallelSubmit(this, false);
+    }
+
+    // Submit the last block when flushing
+    while (!outputFull && this->flush && !this->last)
+    {
+        if (this->jobSubmitTotal - this->jobOutputTotal == this->jobTotal)
+            outputFull = !gzipCompressParallelOutput(this, compressed, true);
+        else
+            gzipCompressParallelSubmit(this, true);
+    }
+
+    // Write completed output.  When flushing wait for each job since nothing else can be done until all jobs are written.
+    while (!outputFull && (this->pending != NULL || this->jobOutputTotal < this->jobSubmitTotal || (this->last && !this->done)))
+    {
+        if (!gzipCompressParallelOutput(this, compressed, this->flush))
+            break;
+
+        // Compression is done when all jobs and the trailer have been written
+        if (this->last && this->pending == NULL && this->jobOutputTotal == this->jobSubmitTotal &&
+            (this->raw || bufUsed(this->trailer) > 0))
+        {
+            this->done = true;
+        }
+    }
+
+    // Can more input be provided on the next call?
+    this->inputSame = this->flush ? !this->done : uncompressed != NULL && this->inputOffset < bufUsed(uncompressed);
+
+    FUNCTION_LOG_RETURN_VOID();
+}
+
+/***********************************************************************************************************************************
+Is compress done?
+***********************************************************************************************************************************/
+bool
+gzipCompressParallelDone(const GzipCompressParallel *this)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(GZIP_COMPRESS_PARALLEL, this);
+    FUNCTION_TEST_END();
+
+    ASSERT(this != NULL);
+
+    FUNCTION_TEST_RETURN(this->done);
+}
+
+/***********************************************************************************************************************************
+Get filter interface
+***********************************************************************************************************************************/
+IoFilter *
+gzipCompressParallelFilter(const GzipCompressParallel *this)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(GZIP_COMPRESS_PARALLEL, this);
+    FUNCTION_TEST_END();
+
+    ASSERT(this != NULL);
+
+    FUNCTION_TEST_RETURN(this->filter);
+}
+
+/***********************************************************************************************************************************
+Is the same input required on the next process call?
+***********************************************************************************************************************************/
+bool
+gzipCompressParallelInputSame(const GzipCompressParallel *this)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(GZIP_COMPRESS_PARALLEL, this);
+    FUNCTION_TEST_END();
+
+    ASSERT(this != NULL);
+
+    FUNCTION_TEST_RETURN(this->inputSame);
+}
+
+/***********************************************************************************************************************************
+Render as string for logging
+***********************************************************************************************************************************/
+String *
+gzipCompressParallelToLog(const GzipCompressParallel *this)
+{
+    return strNewFmt(
+        "{inputSame: %s, done: %s, flushing: %s, threadTotal: %u, blockSize: %zu}", cvtBoolToConstZ(this->inputSame),
+        cvtBoolToConstZ(this->done), cvtBoolToConstZ(this->flush), this->workerTotal, this->blockSize);
+}
+
+/***********************************************************************************************************************************
+Free memory
+***********************************************************************************************************************************/
+void
+gzipCompressParallelFree(GzipCompressParallel *this)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(GZIP_COMPRESS_PARALLEL, this);
+    FUNCTION_LOG_END();
+
+    if (this != NULL)
+    {
+        // Stop the workers.  Jobs that have not been started are abandoned.
+        pthread_mutex_lock(&this->mutex);
+
+        this->shutdown = true;
+        pthread_cond_broadcast(&this->jobCond);
+
+        pthread_mutex_unlock(&this->mutex);
+
+        for (unsigned int workerIdx = 0; workerIdx < this->workerStarted; workerIdx++)
+            pthread_join(this->workerList[workerIdx].thread, NULL);
+
+        for (unsigned int workerIdx = 0; workerIdx < this->workerTotal; workerIdx++)
+            deflateEnd(this->workerList[workerIdx].stream);
+
+        pthread_cond_destroy(&this->doneCond);
+        pthread_cond_destroy(&this->jobCond);
+        pthread_mutex_destroy(&this->mutex);
+
+        memContextCallbackClear(this->memContext);
+        memContextFree(this->memContext);
+    }
+
+    FUNCTION_LOG_RETURN_VOID();
+}
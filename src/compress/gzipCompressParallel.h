@@ -0,0 +1,56 @@
+/***********************************************************************************************************************************
+Gzip Compress Parallel
+
+Compress IO using the gzip format with multiple threads.  Input is split into blocks that are compressed concurrently and then
+concatenated into a single gzip member, so the output can be read by gzipDecompress or any other gzip implementation.  Each block
+is primed with the end of the prior block so the compression ratio is close to that of gzipCompress.
+***********************************************************************************************************************************/
+#ifndef COMPRESS_GZIPCOMPRESSPARALLEL_H
+#define COMPRESS_GZIPCOMPRESSPARALLEL_H
+
+/***********************************************************************************************************************************
+Object type
+***********************************************************************************************************************************/
+typedef struct GzipCompressParallel GzipCompressParallel;
+
+#include "common/io/filter/filter.h"
+#include "common/type/buffer.h"
+
+/***********************************************************************************************************************************
+Constants
+***********************************************************************************************************************************/
+#define GZIP_COMPRESS_PARALLEL_BLOCK_SIZE                           ((size_t)128 * 1024)
+
+/***********************************************************************************************************************************
+Constructor
+***********************************************************************************************************************************/
+GzipCompressParallel *gzipCompressParallelNew(int level, bool raw, unsigned int threadTotal, size_t blockSize);
+
+/***********************************************************************************************************************************
+Functions
+***********************************************************************************************************************************/
+void gzipCompressParallelProcess(GzipCompressParallel *this, const Buffer *uncompressed, Buffer *compressed);
+
+/***********************************************************************************************************************************
+Getters
+***********************************************************************************************************************************/
+bool gzipCompressParallelDone(const GzipCompressParallel *this);
+IoFilter *gzipCompressParallelFilter(const GzipCompressParallel *this);
+bool gzipCompressParallelInputSame(const GzipCompressParallel *this);
+
+/***********************************************************************************************************************************
+Destructor
+***********************************************************************************************************************************/
+void gzipCompressParallelFree(GzipCompressParallel *this);
+
+/***********************************************************************************************************************************
+Macros for function logging
+***********************************************************************************************************************************/
+String *gzipCompressParallelToLog(const GzipCompressParallel *this);
+
+#define FUNCTION_LOG_GZIP_COMPRESS_PARALLEL_TYPE                                                                                   \
+    GzipCompressParallel *
+#define FUNCTION_LOG_GZIP_COMPRESS_PARALLEL_FORMAT(value, buffer, bufferSize)                                                      \
+    FUNCTION_LOG_STRING_OBJECT_FORMAT(value, gzipCompressParallelToLog, buffer, bufferSize)
+
+#endif
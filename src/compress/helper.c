@@ -0,0 +1,258 @@
+/***********************************************************************************************************************************
+Compression Helper
+***********************************************************************************************************************************/
+#include "common/debug.h"
+#include "common/log.h"
+#include "compress/gzip.h"
+#include "compress/gzipCompress.h"
+#include "compress/gzipDecompress.h"
+#include "compress/helper.h"
+#include "compress/lz4.h"
+#include "compress/lz4Compress.h"
+#include "compress/lz4Decompress.h"
+#include "compress/zst.h"
+#include "compress/zstCompress.h"
+#include "compress/zstDecompress.h"
+#include "version.h"
+
+/***********************************************************************************************************************************
+Compression types
+***********************************************************************************************************************************/
+STRING_EXTERN(COMPRESS_TYPE_NONE_STR,                               COMPRESS_TYPE_NONE);
+STRING_EXTERN(COMPRESS_TYPE_GZ_STR,                                 COMPRESS_TYPE_GZ);
+STRING_EXTERN(COMPRESS_TYPE_LZ4_STR,                                COMPRESS_TYPE_LZ4);
+STRING_EXTERN(COMPRESS_TYPE_ZST_STR,                                COMPRESS_TYPE_ZST);
+
+/***********************************************************************************************************************************
+Create the filters for each compression type.  These wrappers give all types the same signature so they can be stored in a table.
+***********************************************************************************************************************************/
+static IoFilter *
+compressGzNew(int level)
+{
+    return gzipCompressFilter(gzipCompressNew(level, false));
+}
+
+static IoFilter *
+decompressGzNew(void)
+{
+    return gzipDecompressFilter(gzipDecompressNew(false));
+}
+
+#ifdef HAVE_LIBLZ4
+
+static IoFilter *
+compressLz4New(int level)
+{
+    return lz4CompressFilter(lz4CompressNew(level));
+}
+
+static IoFilter *
+decompressLz4New(void)
+{
+    return lz4DecompressFilter(lz4DecompressNew());
+}
+
+#endif // HAVE_LIBLZ4
+
+#ifdef HAVE_LIBZST
+
+static IoFilter *
+compressZstNew(int level)
+{
+    return zstCompressFilter(zstCompressNew(level));
+}
+
+static IoFilter *
+decompressZstNew(void)
+{
+    return zstDecompressFilter(zstDecompressNew());
+}
+
+#endif // HAVE_LIBZST
+
+/***********************************************************************************************************************************
+Compression type table indexed by CompressType.  The filter constructors are NULL when the library is not available.
+***********************************************************************************************************************************/
+static const struct CompressHelperLocal
+{
+    const String *const *name;                                      // Compression type name
+    const char *ext;                                                // File extension, including the dot
+    IoFilter *(*compressNew)(int);                                  // Create the compression filter
+    IoFilter *(*decompressNew)(void);                               // Create the decompression filter
+    int levelDefault;                                               // Default compression level
+} compressHelperLocal[] =
+{
+    {
+        .name = &COMPRESS_TYPE_NONE_STR,
+        .ext = "",
+    },
+    {
+        .name = &COMPRESS_TYPE_GZ_STR,
+        .ext = "." GZIP_EXT,
+        .compressNew = compressGzNew,
+        .decompressNew = decompressGzNew,
+        .levelDefault = 6,
+    },
+    {
+        .name = &COMPRESS_TYPE_LZ4_STR,
+        .ext = "." COMPRESS_TYPE_LZ4,
+#ifdef HAVE_LIBLZ4
+        .compressNew = compressLz4New,
+        .decompressNew = decompressLz4New,
+#endif
+        .levelDefault = 1,
+    },
+    {
+        .name = &COMPRESS_TYPE_ZST_STR,
+        .ext = "." COMPRESS_TYPE_ZST,
+#ifdef HAVE_LIBZST
+        .compressNew = compressZstNew,
+        .decompressNew = decompressZstNew,
+#endif
+        .levelDefault = 3,
+    },
+};
+
+#define COMPRESS_TYPE_TOTAL                                         (sizeof(compressHelperLocal) / sizeof(compressHelperLocal[0]))
+
+/***********************************************************************************************************************************
+Get compression type or name
+***********************************************************************************************************************************/
+CompressType
+compressType(const String *name)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(STRING, name);
+    FUNCTION_TEST_END();
+
+    ASSERT(name != NULL);
+
+    CompressType result = compressTypeNone;
+
+    for (; result < COMPRESS_TYPE_TOTAL; result++)
+    {
+        if (strEq(name, *compressHelperLocal[result].name))
+            break;
+    }
+
+    if (result == COMPRESS_TYPE_TOTAL)
+        THROW_FMT(AssertError, "invalid compression type '%s'", strPtr(name));
+
+    FUNCTION_TEST_RETURN(result);
+}
+
+const String *
+compressTypeName(CompressType type)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(ENUM, type);
+    FUNCTION_TEST_END();
+
+    ASSERT(type < COMPRESS_TYPE_TOTAL);
+
+    FUNCTION_TEST_RETURN(*compressHelperLocal[type].name);
+}
+
+/***********************************************************************************************************************************
+Get compression type from the extension of a file.  Files without a known extension are not compressed.
+***********************************************************************************************************************************/
+CompressType
+compressTypeFromFile(const String *file)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(STRING, file);
+    FUNCTION_TEST_END();
+
+    ASSERT(file != NULL);
+
+    CompressType result = compressTypeGz;
+
+    for (; result < COMPRESS_TYPE_TOTAL; result++)
+    {
+        if (strEndsWithZ(file, compressHelperLocal[result].ext))
+            break;
+    }
+
+    FUNCTION_TEST_RETURN(result == COMPRESS_TYPE_TOTAL ? compressTypeNone : result);
+}
+
+/***********************************************************************************************************************************
+Error if the library for the compression type was not available at build time
+***********************************************************************************************************************************/
+void
+compressTypePresent(CompressType type)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(ENUM, type);
+    FUNCTION_TEST_END();
+
+    ASSERT(type < COMPRESS_TYPE_TOTAL);
+
+    if (type != compressTypeNone && compressHelperLocal[type].compressNew == NULL)
+    {
+        THROW_FMT(
+            OptionInvalidValueError, PROJECT_NAME " not compiled with %s support", strPtr(*compressHelperLocal[type].name));
+    }
+
+    FUNCTION_TEST_RETURN_VOID();
+}
+
+/***********************************************************************************************************************************
+Get the file extension, including the dot, for a compression type.  An empty string is returned when there is no compression.
+***********************************************************************************************************************************/
+const char *
+compressExtZ(CompressType type)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(ENUM, type);
+    FUNCTION_TEST_END();
+
+    ASSERT(type < COMPRESS_TYPE_TOTAL);
+
+    FUNCTION_TEST_RETURN(compressHelperLocal[type].ext);
+}
+
+/***********************************************************************************************************************************
+Get the default compression level for a compression type
+***********************************************************************************************************************************/
+int
+compressLevelDefault(CompressType type)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(ENUM, type);
+    FUNCTION_TEST_END();
+
+    ASSERT(type < COMPRESS_TYPE_TOTAL);
+
+    FUNCTION_TEST_RETURN(compressHelperLocal[type].levelDefault);
+}
+
+/***********************************************************************************************************************************
+Create a compression/decompression filter for the compression type
+***********************************************************************************************************************************/
+IoFilter *
+compressFilter(CompressType type, int level)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(ENUM, type);
+        FUNCTION_LOG_PARAM(INT, level);
+    FUNCTION_LOG_END();
+
+    ASSERT(type != compressTypeNone);
+    compressTypePresent(type);
+
+    FUNCTION_LOG_RETURN(IO_FILTER, compressHelperLocal[type].compressNew(level));
+}
+
+IoFilter *
+decompressFilter(CompressType type)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(ENUM, type);
+    FUNCTION_LOG_END();
+
+    ASSERT(type != compressTypeNone);
+    compressTypePresent(type);
+
+    FUNCTION_LOG_RETURN(IO_FILTER, compressHelperLocal[type].decompressNew());
+}
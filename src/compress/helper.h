@@ -0,0 +1,54 @@
+/***********************************************************************************************************************************
+Compression Helper
+
+Abstracts the compression types so callers can compress/decompress without knowing which library is used.  gzip is always available
+but lz4 and zst are only available when pgBackRest is built with the libraries, i.e. HAVE_LIBLZ4 and HAVE_LIBZST are defined.  The
+type of a compressed file in the repository is determined by its extension so repositories with mixed types can be read.
+***********************************************************************************************************************************/
+#ifndef COMPRESS_HELPER_H
+#define COMPRESS_HELPER_H
+
+/***********************************************************************************************************************************
+Compression types
+***********************************************************************************************************************************/
+typedef enum
+{
+    compressTypeNone,
+    compressTypeGz,
+    compressTypeLz4,
+    compressTypeZst,
+} CompressType;
+
+#include "common/io/filter/filter.h"
+#include "common/type/string.h"
+
+#define COMPRESS_TYPE_NONE                                          "none"
+    STRING_DECLARE(COMPRESS_TYPE_NONE_STR);
+#define COMPRESS_TYPE_GZ                                            "gz"
+    STRING_DECLARE(COMPRESS_TYPE_GZ_STR);
+#define COMPRESS_TYPE_LZ4                                           "lz4"
+    STRING_DECLARE(COMPRESS_TYPE_LZ4_STR);
+#define COMPRESS_TYPE_ZST                                           "zst"
+    STRING_DECLARE(COMPRESS_TYPE_ZST_STR);
+
+/***********************************************************************************************************************************
+Regular expression that matches the extension of any compression type, including no extension.  All types are matched even when the
+library is not available so a file compressed with a missing type is found and reported rather than silently skipped.
+***********************************************************************************************************************************/
+#define COMPRESS_EXT_REGEXP                                         "(\\.gz|\\.lz4|\\.zst){0,1}"
+
+/***********************************************************************************************************************************
+Functions
+***********************************************************************************************************************************/
+CompressType compressType(const String *name);
+const String *compressTypeName(CompressType type);
+CompressType compressTypeFromFile(const String *file);
+void compressTypePresent(CompressType type);
+
+const char *compressExtZ(CompressType type);
+int compressLevelDefault(CompressType type);
+
+IoFilter *compressFilter(CompressType type, int level);
+IoFilter *decompressFilter(CompressType type);
+
+#endif
@@ -0,0 +1,23 @@
+/***********************************************************************************************************************************
+LZ4 Common
+***********************************************************************************************************************************/
+#ifdef HAVE_LIBLZ4
+
+#include <lz4frame.h>
+
+#include "common/debug.h"
+#include "compress/lz4.h"
+
+/***********************************************************************************************************************************
+Process lz4 errors
+***********************************************************************************************************************************/
+size_t
+lz4Error(size_t error)
+{
+    if (LZ4F_isError(error))
+        THROW_FMT(FormatError, "lz4 error: [%zd] %s", (ssize_t)error, LZ4F_getErrorName(error));
+
+    return error;
+}
+
+#endif // HAVE_LIBLZ4
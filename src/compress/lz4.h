@@ -0,0 +1,25 @@
+/***********************************************************************************************************************************
+LZ4 Common
+
+Developed against version r131 using the documentation in https://github.com/lz4/lz4/blob/r131/lib/lz4frame.h.
+***********************************************************************************************************************************/
+#ifndef COMPRESS_LZ4_H
+#define COMPRESS_LZ4_H
+
+#ifdef HAVE_LIBLZ4
+
+#include <stddef.h>
+
+/***********************************************************************************************************************************
+LZ4 extension
+***********************************************************************************************************************************/
+#define LZ4_EXT                                                     "lz4"
+
+/***********************************************************************************************************************************
+Functions
+***********************************************************************************************************************************/
+size_t lz4Error(size_t error);
+
+#endif // HAVE_LIBLZ4
+
+#endif
@@ -0,0 +1,280 @@
+/***********************************************************************************************************************************
+LZ4 Compress
+
+Developed against version r131 using the documentation in https://github.com/lz4/lz4/blob/r131/lib/lz4frame.h.
+***********************************************************************************************************************************/
+#ifdef HAVE_LIBLZ4
+
+#include <stdio.h>
+#include <lz4frame.h>
+
+#include "common/debug.h"
+#include "common/io/filter/filter.intern.h"
+#include "common/log.h"
+#include "common/memContext.h"
+#include "compress/lz4.h"
+#include "compress/lz4Compress.h"
+
+/***********************************************************************************************************************************
+Filter type constant
+***********************************************************************************************************************************/
+#define LZ4_COMPRESS_FILTER_TYPE                                    "lz4Compress"
+    STRING_STATIC(LZ4_COMPRESS_FILTER_TYPE_STR,                     LZ4_COMPRESS_FILTER_TYPE);
+
+/***********************************************************************************************************************************
+Older versions of lz4 do not define the max header size.  This seems to be the max for any version.
+***********************************************************************************************************************************/
+#define LZ4_HEADER_SIZE_MAX                                         19
+
+/***********************************************************************************************************************************
+Object type
+***********************************************************************************************************************************/
+struct Lz4Compress
+{
+    MemContext *memContext;                                         // Context to store data
+    LZ4F_compressionContext_t context;                              // LZ4 compression context
+    LZ4F_preferences_t prefs;                                       // Preferences -- just compress level set
+    IoFilter *filter;                                               // Filter interface
+
+    Buffer *buffer;                                                 // For when the output buffer is too small for compressed data
+    size_t bufferOffset;                                            // Offset of data not yet copied from the buffer to the output
+    bool first;                                                     // Is this the first call to process?
+    bool inputSame;                                                 // Is the same input required on the next process call?
+    bool flushing;                                                  // Is input complete and flushing in progress?
+    bool done;                                                      // Is compression done?
+};
+
+/***********************************************************************************************************************************
+New object
+***********************************************************************************************************************************/
+Lz4Compress *
+lz4CompressNew(int level)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(INT, level);
+    FUNCTION_LOG_END();
+
+    ASSERT(level >= 0);
+
+    Lz4Compress *this = NULL;
+
+    MEM_CONTEXT_NEW_BEGIN("Lz4Compress")
+    {
+        // Allocate state and set context
+        this = memNew(sizeof(Lz4Compress));
+        this->memContext = MEM_CONTEXT_NEW();
+        this->prefs.compressionLevel = level;
+        this->first = true;
+
+        // Create lz4 context
+        lz4Error(LZ4F_createCompressionContext(&this->context, LZ4F_VERSION));
+
+        // Set free callback to ensure lz4 context is freed
+        memContextCallback(this->memContext, (MemContextCallback)lz4CompressFree, this);
+
+        // Create filter interface
+        this->filter = ioFilterNewP(
+            LZ4_COMPRESS_FILTER_TYPE_STR, this, .done = (IoFilterInterfaceDone)lz4CompressDone,
+            .inOut = (IoFilterInterfaceProcessInOut)lz4CompressProcess,
+            .inputSame = (IoFilterInterfaceInputSame)lz4CompressInputSame);
+    }
+    MEM_CONTEXT_NEW_END();
+
+    FUNCTION_LOG_RETURN(LZ4_COMPRESS, this);
+}
+
+/***********************************************************************************************************************************
+Get the buffer to write compressed data to.  lz4 requires space for the worst case so when the output buffer is not large enough
+the data is compressed to an internal buffer and copied to the output on this and subsequent calls.
+***********************************************************************************************************************************/
+static Buffer *
+lz4CompressBuffer(Lz4Compress *this, size_t compressSize, Buffer *compressed)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(LZ4_COMPRESS, this);
+        FUNCTION_TEST_PARAM(SIZE, compressSize);
+        FUNCTION_TEST_PARAM(BUFFER, compressed);
+    FUNCTION_TEST_END();
+
+    Buffer *result = compressed;
+
+    // Is an internal buffer required to hold the compressed data?
+    if (bufRemains(compressed) < compressSize)
+    {
+        // Allocate the buffer if it has not already been allocated
+        if (this->buffer == NULL)
+        {
+            MEM_CONTEXT_BEGIN(this->memContext)
+            {
+                this->buffer = bufNew(compressSize);
+            }
+            MEM_CONTEXT_END();
+        }
+        // Resize the buffer if it is not large enough
+        else if (bufSize(this->buffer) < compressSize)
+            bufResize(this->buffer, compressSize);
+
+        bufUsedZero(this->buffer);
+        this->bufferOffset = 0;
+
+        result = this->buffer;
+    }
+
+    FUNCTION_TEST_RETURN(result);
+}
+
+/***********************************************************************************************************************************
+Compress data
+***********************************************************************************************************************************/
+void
+lz4CompressProcess(Lz4Compress *this, const Buffer *uncompressed, Buffer *compressed)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(LZ4_COMPRESS, this);
+        FUNCTION_LOG_PARAM(BUFFER, uncompressed);
+        FUNCTION_LOG_PARAM(BUFFER, compressed);
+    FUNCTION_LOG_END();
+
+    ASSERT(this != NULL);
+    ASSERT(!this->done);
+    ASSERT(this->context != NULL);
+    ASSERT(compressed != NULL);
+    ASSERT(!this->flushing || uncompressed == NULL);
+
+    // Compress new input.  When the same input is expected the input has already been compressed but there is still buffered data
+    // to copy to the output.
+    if (!this->inputSame)
+    {
+        // Flushing
+        if (uncompressed == NULL)
+            this->flushing = true;
+
+        // Get the buffer to compress to, which must be large enough for the header (if first call) and the worst case output
+        Buffer *output = lz4CompressBuffer(
+            this,
+            (this->first ? LZ4_HEADER_SIZE_MAX : 0) +
+                LZ4F_compressBound(this->flushing ? 0 : bufUsed(uncompressed), &this->prefs),
+            compressed);
+
+        // Write the header on the first call
+        if (this->first)
+        {
+            bufUsedInc(
+                output, lz4Error(LZ4F_compressBegin(this->context, bufRemainsPtr(output), bufRemains(output), &this->prefs)));
+            this->first = false;
+        }
+
+        // Complete the frame when flushing
+        if (this->flushing)
+            bufUsedInc(output, lz4Error(LZ4F_compressEnd(this->context, bufRemainsPtr(output), bufRemains(output), NULL)));
+        // Else compress the input
+        else
+        {
+            bufUsedInc(
+                output,
+                lz4Error(
+                    LZ4F_compressUpdate(
+                        this->context, bufRemainsPtr(output), bufRemains(output), bufPtr(uncompressed), bufUsed(uncompressed),
+                        NULL)));
+        }
+    }
+
+    // Copy buffered data to the output
+    size_t bufferRemains = this->buffer == NULL ? 0 : bufUsed(this->buffer) - this->bufferOffset;
+
+    if (bufferRemains > 0)
+    {
+        size_t copySize = bufRemains(compressed) < bufferRemains ? bufRemains(compressed) : bufferRemains;
+
+        bufCatSub(compressed, this->buffer, this->bufferOffset, copySize);
+        this->bufferOffset += copySize;
+        bufferRemains -= copySize;
+    }
+
+    // The same input is required while there is buffered data to copy and compression is done when there is no buffered data left
+    // after flushing
+    this->inputSame = bufferRemains > 0;
+    this->done = this->flushing && !this->inputSame;
+
+    FUNCTION_LOG_RETURN_VOID();
+}
+
+/***********************************************************************************************************************************
+Is compress done?
+***********************************************************************************************************************************/
+bool
+lz4CompressDone(const Lz4Compress *this)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(LZ4_COMPRESS, this);
+    FUNCTION_TEST_END();
+
+    ASSERT(this != NULL);
+
+    FUNCTION_TEST_RETURN(this->done);
+}
+
+/***********************************************************************************************************************************
+Get filter interface
+***********************************************************************************************************************************/
+IoFilter *
+lz4CompressFilter(const Lz4Compress *this)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(LZ4_COMPRESS, this);
+    FUNCTION_TEST_END();
+
+    ASSERT(this != NULL);
+
+    FUNCTION_TEST_RETURN(this->filter);
+}
+
+/***********************************************************************************************************************************
+Is the same input required on the next process call?
+***********************************************************************************************************************************/
+bool
+lz4CompressInputSame(const Lz4Compress *this)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(LZ4_COMPRESS, this);
+    FUNCTION_TEST_END();
+
+    ASSERT(this != NULL);
+
+    FUNCTION_TEST_RETURN(this->inputSame);
+}
+
+/***********************************************************************************************************************************
+Render as string for logging
+***********************************************************************************************************************************/
+String *
+lz4CompressToLog(const Lz4Compress *this)
+{
+    return strNewFmt(
+        "{level: %d, first: %s, inputSame: %s, flushing: %s}", this->prefs.compressionLevel, cvtBoolToConstZ(this->first),
+        cvtBoolToConstZ(this->inputSame), cvtBoolToConstZ(this->flushing));
+}
+
+/***********************************************************************************************************************************
+Free memory
+***********************************************************************************************************************************/
+void
+lz4CompressFree(Lz4Compress *this)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(LZ4_COMPRESS, this);
+    FUNCTION_LOG_END();
+
+    if (this != NULL)
+    {
+        LZ4F_freeCompressionContext(this->context);
+        this->context = NULL;
+
+        memContextCallbackClear(this->memContext);
+        memContextFree(this->memContext);
+    }
+
+    FUNCTION_LOG_RETURN_VOID();
+}
+
+#endif // HAVE_LIBLZ4
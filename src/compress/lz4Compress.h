@@ -0,0 +1,53 @@
+/***********************************************************************************************************************************
+LZ4 Compress
+
+Compress IO to the lz4 frame format.
+***********************************************************************************************************************************/
+#ifndef COMPRESS_LZ4COMPRESS_H
+#define COMPRESS_LZ4COMPRESS_H
+
+#ifdef HAVE_LIBLZ4
+
+/***********************************************************************************************************************************
+Object type
+***********************************************************************************************************************************/
+typedef struct Lz4Compress Lz4Compress;
+
+#include "common/io/filter/filter.h"
+#include "common/type/buffer.h"
+
+/***********************************************************************************************************************************
+Constructor
+***********************************************************************************************************************************/
+Lz4Compress *lz4CompressNew(int level);
+
+/***********************************************************************************************************************************
+Functions
+***********************************************************************************************************************************/
+void lz4CompressProcess(Lz4Compress *this, const Buffer *uncompressed, Buffer *compressed);
+
+/***********************************************************************************************************************************
+Getters
+***********************************************************************************************************************************/
+bool lz4CompressDone(const Lz4Compress *this);
+IoFilter *lz4CompressFilter(const Lz4Compress *this);
+bool lz4CompressInputSame(const Lz4Compress *this);
+
+/***********************************************************************************************************************************
+Destructor
+***********************************************************************************************************************************/
+void lz4CompressFree(Lz4Compress *this);
+
+/***********************************************************************************************************************************
+Macros for function logging
+***********************************************************************************************************************************/
+String *lz4CompressToLog(const Lz4Compress *this);
+
+#define FUNCTION_LOG_LZ4_COMPRESS_TYPE                                                                                             \
+    Lz4Compress *
+#define FUNCTION_LOG_LZ4_COMPRESS_FORMAT(value, buffer, bufferSize)                                                                \
+    FUNCTION_LOG_STRING_OBJECT_FORMAT(value, lz4CompressToLog, buffer, bufferSize)
+
+#endif // HAVE_LIBLZ4
+
+#endif
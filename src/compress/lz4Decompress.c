@@ -0,0 +1,193 @@
+/***********************************************************************************************************************************
+LZ4 Decompress
+
+Developed against version r131 using the documentation in https://github.com/lz4/lz4/blob/r131/lib/lz4frame.h.
+***********************************************************************************************************************************/
+#ifdef HAVE_LIBLZ4
+
+#include <stdio.h>
+#include <lz4frame.h>
+
+#include "common/debug.h"
+#include "common/io/filter/filter.intern.h"
+#include "common/log.h"
+#include "common/memContext.h"
+#include "compress/lz4.h"
+#include "compress/lz4Decompress.h"
+
+/***********************************************************************************************************************************
+Filter type constant
+***********************************************************************************************************************************/
+#define LZ4_DECOMPRESS_FILTER_TYPE                                  "lz4Decompress"
+    STRING_STATIC(LZ4_DECOMPRESS_FILTER_TYPE_STR,                   LZ4_DECOMPRESS_FILTER_TYPE);
+
+/***********************************************************************************************************************************
+Object type
+***********************************************************************************************************************************/
+struct Lz4Decompress
+{
+    MemContext *memContext;                                         // Context to store data
+    LZ4F_decompressionContext_t context;                            // LZ4 decompression context
+    IoFilter *filter;                                               // Filter interface
+
+    size_t inputOffset;                                             // Offset of input not yet decompressed
+    bool inputSame;                                                 // Is the same input required on the next process call?
+    bool done;                                                      // Is decompression done?
+};
+
+/***********************************************************************************************************************************
+New object
+***********************************************************************************************************************************/
+Lz4Decompress *
+lz4DecompressNew(void)
+{
+    FUNCTION_LOG_VOID(logLevelTrace);
+
+    Lz4Decompress *this = NULL;
+
+    MEM_CONTEXT_NEW_BEGIN("Lz4Decompress")
+    {
+        // Allocate state and set context
+        this = memNew(sizeof(Lz4Decompress));
+        this->memContext = MEM_CONTEXT_NEW();
+
+        // Create lz4 context
+        lz4Error(LZ4F_createDecompressionContext(&this->context, LZ4F_VERSION));
+
+        // Set free callback to ensure lz4 context is freed
+        memContextCallback(this->memContext, (MemContextCallback)lz4DecompressFree, this);
+
+        // Create filter interface
+        this->filter = ioFilterNewP(
+            LZ4_DECOMPRESS_FILTER_TYPE_STR, this, .done = (IoFilterInterfaceDone)lz4DecompressDone,
+            .inOut = (IoFilterInterfaceProcessInOut)lz4DecompressProcess,
+            .inputSame = (IoFilterInterfaceInputSame)lz4DecompressInputSame);
+    }
+    MEM_CONTEXT_NEW_END();
+
+    FUNCTION_LOG_RETURN(LZ4_DECOMPRESS, this);
+}
+
+/***********************************************************************************************************************************
+Decompress data
+***********************************************************************************************************************************/
+void
+lz4DecompressProcess(Lz4Decompress *this, const Buffer *compressed, Buffer *uncompressed)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(LZ4_DECOMPRESS, this);
+        FUNCTION_LOG_PARAM(BUFFER, compressed);
+        FUNCTION_LOG_PARAM(BUFFER, uncompressed);
+    FUNCTION_LOG_END();
+
+    ASSERT(this != NULL);
+    ASSERT(!this->done);
+    ASSERT(this->context != NULL);
+    ASSERT(uncompressed != NULL);
+
+    // Input should not be complete until the frame is complete
+    if (compressed == NULL)
+        THROW(FormatError, "unexpected eof in compressed data");
+
+    // Start at the beginning of new input
+    if (!this->inputSame)
+        this->inputOffset = 0;
+
+    // Decompress as much input as will fit in the output
+    size_t srcSize = bufUsed(compressed) - this->inputOffset;
+    size_t dstSize = bufRemains(uncompressed);
+
+    this->done =
+        lz4Error(
+            LZ4F_decompress(
+                this->context, bufRemainsPtr(uncompressed), &dstSize, bufPtr(compressed) + this->inputOffset, &srcSize, NULL)) == 0;
+
+    this->inputOffset += srcSize;
+    bufUsedInc(uncompressed, dstSize);
+
+    // The same input is required if there is input left or the output is full, since lz4 may be holding decompressed data that did
+    // not fit in the output
+    this->inputSame = this->done ? false : this->inputOffset < bufUsed(compressed) || bufFull(uncompressed);
+
+    FUNCTION_LOG_RETURN_VOID();
+}
+
+/***********************************************************************************************************************************
+Is decompress done?
+***********************************************************************************************************************************/
+bool
+lz4DecompressDone(const Lz4Decompress *this)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(LZ4_DECOMPRESS, this);
+    FUNCTION_TEST_END();
+
+    ASSERT(this != NULL);
+
+    FUNCTION_TEST_RETURN(this->done);
+}
+
+/***********************************************************************************************************************************
+Get filter interface
+***********************************************************************************************************************************/
+IoFilter *
+lz4DecompressFilter(const Lz4Decompress *this)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(LZ4_DECOMPRESS, this);
+    FUNCTION_TEST_END();
+
+    ASSERT(this != NULL);
+
+    FUNCTION_TEST_RETURN(this->filter);
+}
+
+/***********************************************************************************************************************************
+Is the same input required on the next process call?
+***********************************************************************************************************************************/
+bool
+lz4DecompressInputSame(const Lz4Decompress *this)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(LZ4_DECOMPRESS, this);
+    FUNCTION_TEST_END();
+
+    ASSERT(this != NULL);
+
+    FUNCTION_TEST_RETURN(this->inputSame);
+}
+
+/***********************************************************************************************************************************
+Render as string for logging
+***********************************************************************************************************************************/
+String *
+lz4DecompressToLog(const Lz4Decompress *this)
+{
+    return strNewFmt(
+        "{inputSame: %s, inputOffset: %zu, done: %s}", cvtBoolToConstZ(this->inputSame), this->inputOffset,
+        cvtBoolToConstZ(this->done));
+}
+
+/***********************************************************************************************************************************
+Free memory
+***********************************************************************************************************************************/
+void
+lz4DecompressFree(Lz4Decompress *this)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(LZ4_DECOMPRESS, this);
+    FUNCTION_LOG_END();
+
+    if (this != NULL)
+    {
+        LZ4F_freeDecompressionContext(this->context);
+        this->context = NULL;
+
+        memContextCallbackClear(this->memContext);
+        memContextFree(this->memContext);
+    }
+
+    FUNCTION_LOG_RETURN_VOID();
+}
+
+#endif // HAVE_LIBLZ4
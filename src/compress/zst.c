@@ -0,0 +1,23 @@
+/***********************************************************************************************************************************
+Zstandard Common
+***********************************************************************************************************************************/
+#ifdef HAVE_LIBZST
+
+#include <zstd.h>
+
+#include "common/debug.h"
+#include "compress/zst.h"
+
+/***********************************************************************************************************************************
+Process zstd errors
+***********************************************************************************************************************************/
+size_t
+zstError(size_t error)
+{
+    if (ZSTD_isError(error))
+        THROW_FMT(FormatError, "zst error: [%zd] %s", (ssize_t)error, ZSTD_getErrorName(error));
+
+    return error;
+}
+
+#endif // HAVE_LIBZST
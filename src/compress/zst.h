@@ -0,0 +1,25 @@
+/***********************************************************************************************************************************
+Zstandard Common
+
+Developed against version v1.0.0 using the documentation in https://github.com/facebook/zstd/blob/v1.0.0/lib/zstd.h.
+***********************************************************************************************************************************/
+#ifndef COMPRESS_ZST_H
+#define COMPRESS_ZST_H
+
+#ifdef HAVE_LIBZST
+
+#include <stddef.h>
+
+/***********************************************************************************************************************************
+Zstandard extension
+***********************************************************************************************************************************/
+#define ZST_EXT                                                     "zst"
+
+/***********************************************************************************************************************************
+Functions
+***********************************************************************************************************************************/
+size_t zstError(size_t error);
+
+#endif // HAVE_LIBZST
+
+#endif
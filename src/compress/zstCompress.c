@@ -0,0 +1,211 @@
+/***********************************************************************************************************************************
+Zstandard Compress
+
+Developed against version v1.0.0 using the documentation in https://github.com/facebook/zstd/blob/v1.0.0/lib/zstd.h.
+***********************************************************************************************************************************/
+#ifdef HAVE_LIBZST
+
+#include <stdio.h>
+#include <zstd.h>
+
+#include "common/debug.h"
+#include "common/io/filter/filter.intern.h"
+#include "common/log.h"
+#include "common/memContext.h"
+#include "compress/zst.h"
+#include "compress/zstCompress.h"
+
+/***********************************************************************************************************************************
+Filter type constant
+***********************************************************************************************************************************/
+#define ZST_COMPRESS_FILTER_TYPE                                    "zstCompress"
+    STRING_STATIC(ZST_COMPRESS_FILTER_TYPE_STR,                     ZST_COMPRESS_FILTER_TYPE);
+
+/***********************************************************************************************************************************
+Object type
+***********************************************************************************************************************************/
+struct ZstCompress
+{
+    MemContext *memContext;                                         // Context to store data
+    ZSTD_CStream *context;                                          // Compression context
+    int level;                                                      // Compression level
+    IoFilter *filter;                                               // Filter interface
+
+    size_t inputOffset;                                             // Offset of input not yet compressed
+    bool inputSame;                                                 // Is the same input required on the next process call?
+    bool flushing;                                                  // Is input complete and flushing in progress?
+    bool done;                                                      // Is compression done?
+};
+
+/***********************************************************************************************************************************
+New object
+***********************************************************************************************************************************/
+ZstCompress *
+zstCompressNew(int level)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(INT, level);
+    FUNCTION_LOG_END();
+
+    ASSERT(level >= 0);
+
+    ZstCompress *this = NULL;
+
+    MEM_CONTEXT_NEW_BEGIN("ZstCompress")
+    {
+        // Allocate state and set context
+        this = memNew(sizeof(ZstCompress));
+        this->memContext = MEM_CONTEXT_NEW();
+        this->level = level;
+
+        // Create zstd context
+        this->context = ZSTD_createCStream();
+
+        // Set free callback to ensure zstd context is freed
+        memContextCallback(this->memContext, (MemContextCallback)zstCompressFree, this);
+
+        // Initialize the stream with the compression level
+        zstError(ZSTD_initCStream(this->context, this->level));
+
+        // Create filter interface
+        this->filter = ioFilterNewP(
+            ZST_COMPRESS_FILTER_TYPE_STR, this, .done = (IoFilterInterfaceDone)zstCompressDone,
+            .inOut = (IoFilterInterfaceProcessInOut)zstCompressProcess,
+            .inputSame = (IoFilterInterfaceInputSame)zstCompressInputSame);
+    }
+    MEM_CONTEXT_NEW_END();
+
+    FUNCTION_LOG_RETURN(ZST_COMPRESS, this);
+}
+
+/***********************************************************************************************************************************
+Compress data
+***********************************************************************************************************************************/
+void
+zstCompressProcess(ZstCompress *this, const Buffer *uncompressed, Buffer *compressed)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(ZST_COMPRESS, this);
+        FUNCTION_LOG_PARAM(BUFFER, uncompressed);
+        FUNCTION_LOG_PARAM(BUFFER, compressed);
+    FUNCTION_LOG_END();
+
+    ASSERT(this != NULL);
+    ASSERT(!this->done);
+    ASSERT(this->context != NULL);
+    ASSERT(compressed != NULL);
+    ASSERT(!this->flushing || uncompressed == NULL);
+
+    ZSTD_outBuffer out =
+    {
+        .dst = bufPtr(compressed),
+        .size = bufUsed(compressed) + bufRemains(compressed),
+        .pos = bufUsed(compressed),
+    };
+
+    // Flush the stream until it reports that no data remains
+    if (uncompressed == NULL)
+    {
+        this->flushing = true;
+        this->done = zstError(ZSTD_endStream(this->context, &out)) == 0;
+        this->inputSame = !this->done;
+    }
+    // Else compress as much input as will fit in the output
+    else
+    {
+        if (!this->inputSame)
+            this->inputOffset = 0;
+
+        ZSTD_inBuffer in = {.src = bufPtr(uncompressed), .size = bufUsed(uncompressed), .pos = this->inputOffset};
+
+        zstError(ZSTD_compressStream(this->context, &out, &in));
+
+        this->inputOffset = in.pos;
+        this->inputSame = in.pos < in.size;
+    }
+
+    // Set buffer used space
+    bufUsedSet(compressed, out.pos);
+
+    FUNCTION_LOG_RETURN_VOID();
+}
+
+/***********************************************************************************************************************************
+Is compress done?
+***********************************************************************************************************************************/
+bool
+zstCompressDone(const ZstCompress *this)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(ZST_COMPRESS, this);
+    FUNCTION_TEST_END();
+
+    ASSERT(this != NULL);
+
+    FUNCTION_TEST_RETURN(this->done);
+}
+
+/***********************************************************************************************************************************
+Get filter interface
+***********************************************************************************************************************************/
+IoFilter *
+zstCompressFilter(const ZstCompress *this)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(ZST_COMPRESS, this);
+    FUNCTION_TEST_END();
+
+    ASSERT(this != NULL);
+
+    FUNCTION_TEST_RETURN(this->filter);
+}
+
+/***********************************************************************************************************************************
+Is the same input required on the next process call?
+***********************************************************************************************************************************/
+bool
+zstCompressInputSame(const ZstCompress *this)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(ZST_COMPRESS, this);
+    FUNCTION_TEST_END();
+
+    ASSERT(this != NULL);
+
+    FUNCTION_TEST_RETURN(this->inputSame);
+}
+
+/***********************************************************************************************************************************
+Render as string for logging
+***********************************************************************************************************************************/
+String *
+zstCompressToLog(const ZstCompress *this)
+{
+    return strNewFmt(
+        "{level: %d, inputSame: %s, inputOffset: %zu, flushing: %s}", this->level, cvtBoolToConstZ(this->inputSame),
+        this->inputOffset, cvtBoolToConstZ(this->flushing));
+}
+
+/***********************************************************************************************************************************
+Free memory
+***********************************************************************************************************************************/
+void
+zstCompressFree(ZstCompress *this)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(ZST_COMPRESS, this);
+    FUNCTION_LOG_END();
+
+    if (this != NULL)
+    {
+        ZSTD_freeCStream(this->context);
+        this->context = NULL;
+
+        memContextCallbackClear(this->memContext);
+        memContextFree(this->memContext);
+    }
+
+    FUNCTION_LOG_RETURN_VOID();
+}
+
+#endif // HAVE_LIBZST
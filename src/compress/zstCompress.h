@@ -0,0 +1,53 @@
+/***********************************************************************************************************************************
+Zstandard Compress
+
+Compress IO to the Zstandard format.
+***********************************************************************************************************************************/
+#ifndef COMPRESS_ZSTCOMPRESS_H
+#define COMPRESS_ZSTCOMPRESS_H
+
+#ifdef HAVE_LIBZST
+
+/***********************************************************************************************************************************
+Object type
+***********************************************************************************************************************************/
+typedef struct ZstCompress ZstCompress;
+
+#include "common/io/filter/filter.h"
+#include "common/type/buffer.h"
+
+/***********************************************************************************************************************************
+Constructor
+***********************************************************************************************************************************/
+ZstCompress *zstCompressNew(int level);
+
+/***********************************************************************************************************************************
+Functions
+***********************************************************************************************************************************/
+void zstCompressProcess(ZstCompress *this, const Buffer *uncompressed, Buffer *compressed);
+
+/***********************************************************************************************************************************
+Getters
+***********************************************************************************************************************************/
+bool zstCompressDone(const ZstCompress *this);
+IoFilter *zstCompressFilter(const ZstCompress *this);
+bool zstCompressInputSame(const ZstCompress *this);
+
+/***********************************************************************************************************************************
+Destructor
+***********************************************************************************************************************************/
+void zstCompressFree(ZstCompress *this);
+
+/***********************************************************************************************************************************
+Macros for function logging
+***********************************************************************************************************************************/
+String *zstCompressToLog(const ZstCompress *this);
+
+#define FUNCTION_LOG_ZST_COMPRESS_TYPE                                                                                             \
+    ZstCompress *
+#define FUNCTION_LOG_ZST_COMPRESS_FORMAT(value, buffer, bufferSize)                                                                \
+    FUNCTION_LOG_STRING_OBJECT_FORMAT(value, zstCompressToLog, buffer, bufferSize)
+
+#endif // HAVE_LIBZST
+
+#endif
@@ -0,0 +1,198 @@
+/***********************************************************************************************************************************
+Zstandard Decompress
+
+Developed against version v1.0.0 using the documentation in https://github.com/facebook/zstd/blob/v1.0.0/lib/zstd.h.
+***********************************************************************************************************************************/
+#ifdef HAVE_LIBZST
+
+#include <stdio.h>
+#include <zstd.h>
+
+#include "common/debug.h"
+#include "common/io/filter/filter.intern.h"
+#include "common/log.h"
+#include "common/memContext.h"
+#include "compress/zst.h"
+#include "compress/zstDecompress.h"
+
+/***********************************************************************************************************************************
+Filter type constant
+***********************************************************************************************************************************/
+#define ZST_DECOMPRESS_FILTER_TYPE                                  "zstDecompress"
+    STRING_STATIC(ZST_DECOMPRESS_FILTER_TYPE_STR,                   ZST_DECOMPRESS_FILTER_TYPE);
+
+/***********************************************************************************************************************************
+Object type
+***********************************************************************************************************************************/
+struct ZstDecompress
+{
+    MemContext *memContext;                                         // Context to store data
+    ZSTD_DStream *context;                                          // Decompression context
+    IoFilter *filter;                                               // Filter interface
+
+    size_t inputOffset;                                             // Offset of input not yet decompressed
+    bool inputSame;                                                 // Is the same input required on the next process call?
+    bool done;                                                      // Is decompression done?
+};
+
+/***********************************************************************************************************************************
+New object
+***********************************************************************************************************************************/
+ZstDecompress *
+zstDecompressNew(void)
+{
+    FUNCTION_LOG_VOID(logLevelTrace);
+
+    ZstDecompress *this = NULL;
+
+    MEM_CONTEXT_NEW_BEGIN("ZstDecompress")
+    {
+        // Allocate state and set context
+        this = memNew(sizeof(ZstDecompress));
+        this->memContext = MEM_CONTEXT_NEW();
+
+        // Create zstd context
+        this->context = ZSTD_createDStream();
+
+        // Set free callback to ensure zstd context is freed
+        memContextCallback(this->memContext, (MemContextCallback)zstDecompressFree, this);
+
+        // Initialize the stream
+        zstError(ZSTD_initDStream(this->context));
+
+        // Create filter interface
+        this->filter = ioFilterNewP(
+            ZST_DECOMPRESS_FILTER_TYPE_STR, this, .done = (IoFilterInterfaceDone)zstDecompressDone,
+            .inOut = (IoFilterInterfaceProcessInOut)zstDecompressProcess,
+            .inputSame = (IoFilterInterfaceInputSame)zstDecompressInputSame);
+    }
+    MEM_CONTEXT_NEW_END();
+
+    FUNCTION_LOG_RETURN(ZST_DECOMPRESS, this);
+}
+
+/***********************************************************************************************************************************
+Decompress data
+***********************************************************************************************************************************/
+void
+zstDecompressProcess(ZstDecompress *this, const Buffer *compressed, Buffer *uncompressed)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(ZST_DECOMPRESS, this);
+        FUNCTION_LOG_PARAM(BUFFER, compressed);
+        FUNCTION_LOG_PARAM(BUFFER, uncompressed);
+    FUNCTION_LOG_END();
+
+    ASSERT(this != NULL);
+    ASSERT(!this->done);
+    ASSERT(this->context != NULL);
+    ASSERT(uncompressed != NULL);
+
+    // Input should not be complete until the frame is complete
+    if (compressed == NULL)
+        THROW(FormatError, "unexpected eof in compressed data");
+
+    // Start at the beginning of new input
+    if (!this->inputSame)
+        this->inputOffset = 0;
+
+    // Decompress as much input as will fit in the output
+    ZSTD_inBuffer in = {.src = bufPtr(compressed), .size = bufUsed(compressed), .pos = this->inputOffset};
+    ZSTD_outBuffer out =
+    {
+        .dst = bufPtr(uncompressed),
+        .size = bufUsed(uncompressed) + bufRemains(uncompressed),
+        .pos = bufUsed(uncompressed),
+    };
+
+    this->done = zstError(ZSTD_decompressStream(this->context, &out, &in)) == 0;
+
+    this->inputOffset = in.pos;
+    bufUsedSet(uncompressed, out.pos);
+
+    // The same input is required if there is input left or the output is full, since zstd may be holding decompressed data that
+    // did not fit in the output
+    this->inputSame = this->done ? false : in.pos < in.size || bufFull(uncompressed);
+
+    FUNCTION_LOG_RETURN_VOID();
+}
+
+/***********************************************************************************************************************************
+Is decompress done?
+***********************************************************************************************************************************/
+bool
+zstDecompressDone(const ZstDecompress *this)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(ZST_DECOMPRESS, this);
+    FUNCTION_TEST_END();
+
+    ASSERT(this != NULL);
+
+    FUNCTION_TEST_RETURN(this->done);
+}
+
+/***********************************************************************************************************************************
+Get filter interface
+***********************************************************************************************************************************/
+IoFilter *
+zstDecompressFilter(const ZstDecompress *this)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(ZST_DECOMPRESS, this);
+    FUNCTION_TEST_END();
+
+    ASSERT(this != NULL);
+
+    FUNCTION_TEST_RETURN(this->filter);
+}
+
+/***********************************************************************************************************************************
+Is the same input required on the next process call?
+***********************************************************************************************************************************/
+bool
+zstDecompressInputSame(const ZstDecompress *this)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(ZST_DECOMPRESS, this);
+    FUNCTION_TEST_END();
+
+    ASSERT(this != NULL);
+
+    FUNCTION_TEST_RETURN(this->inputSame);
+}
+
+/***********************************************************************************************************************************
+Render as string for logging
+***********************************************************************************************************************************/
+String *
+zstDecompressToLog(const ZstDecompress *this)
+{
+    return strNewFmt(
+        "{inputSame: %s, inputOffset: %zu, done: %s}", cvtBoolToConstZ(this->inputSame), this->inputOffset,
+        cvtBoolToConstZ(this->done));
+}
+
+/***********************************************************************************************************************************
+Free memory
+***********************************************************************************************************************************/
+void
+zstDecompressFree(ZstDecompress *this)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(ZST_DECOMPRESS, this);
+    FUNCTION_LOG_END();
+
+    if (this != NULL)
+    {
+        ZSTD_freeDStream(this->context);
+        this->context = NULL;
+
+        memContextCallbackClear(this->memContext);
+        memContextFree(this->memContext);
+    }
+
+    FUNCTION_LOG_RETURN_VOID();
+}
+
+#endif // HAVE_LIBZST
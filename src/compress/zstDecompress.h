@@ -0,0 +1,53 @@
+/***********************************************************************************************************************************
+Zstandard Decompress
+
+Decompress IO from the Zstandard format.
+***********************************************************************************************************************************/
+#ifndef COMPRESS_ZSTDECOMPRESS_H
+#define COMPRESS_ZSTDECOMPRESS_H
+
+#ifdef HAVE_LIBZST
+
+/***********************************************************************************************************************************
+Object type
+***********************************************************************************************************************************/
+typedef struct ZstDecompress ZstDecompress;
+
+#include "common/io/filter/filter.h"
+#include "common/type/buffer.h"
+
+/***********************************************************************************************************************************
+Constructor
+***********************************************************************************************************************************/
+ZstDecompress *zstDecompressNew(void);
+
+/***********************************************************************************************************************************
+Functions
+***********************************************************************************************************************************/
+void zstDecompressProcess(ZstDecompress *this, const Buffer *compressed, Buffer *uncompressed);
+
+/***********************************************************************************************************************************
+Getters
+***********************************************************************************************************************************/
+bool zstDecompressDone(const ZstDecompress *this);
+IoFilter *zstDecompressFilter(const ZstDecompress *this);
+bool zstDecompressInputSame(const ZstDecompress *this);
+
+/***********************************************************************************************************************************
+Destructor
+***********************************************************************************************************************************/
+void zstDecompressFree(ZstDecompress *this);
+
+/***********************************************************************************************************************************
+Macros for function logging
+***********************************************************************************************************************************/
+String *zstDecompressToLog(const ZstDecompress *this);
+
+#define FUNCTION_LOG_ZST_DECOMPRESS_TYPE                                                                                           \
+    ZstDecompress *
+#define FUNCTION_LOG_ZST_DECOMPRESS_FORMAT(value, buffer, bufferSize)                                                              \
+    FUNCTION_LOG_STRING_OBJECT_FORMAT(value, zstDecompressToLog, buffer, bufferSize)
+
+#endif // HAVE_LIBZST
+
+#endif
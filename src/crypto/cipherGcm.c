@@ -0,0 +1,964 @@
+/***********************************************************************************************************************************
+Chunked AES-256-GCM Cipher
+
+Chunks are encrypted/decrypted by worker threads using a ring of jobs and written to the output in order.  Workers are only started
+when the first chunk that is not the last is submitted, so data that fits in a single chunk (e.g. info files) is processed on the
+calling thread without the cost of starting threads.
+
+Workers follow the rules in common/thread.h and only report whether the chunk was processed (and authenticated) successfully, which
+is checked by the main thread.
+***********************************************************************************************************************************/
+#include <inttypes.h>
+#include <pthread.h>
+#include <string.h>
+
+#include <openssl/evp.h>
+#include <openssl/hmac.h>
+#include <openssl/sha.h>
+
+#include "common/debug.h"
+#include "common/io/filter/filter.intern.h"
+#include "common/log.h"
+#include "common/memContext.h"
+#include "common/thread.h"
+#include "crypto/cipherGcm.h"
+#include "crypto/crypto.h"
+
+/***********************************************************************************************************************************
+Filter type constant
+***********************************************************************************************************************************/
+#define CIPHER_GCM_FILTER_TYPE                                      "cipherGcm"
+    STRING_STATIC(CIPHER_GCM_FILTER_TYPE_STR,                       CIPHER_GCM_FILTER_TYPE);
+
+/***********************************************************************************************************************************
+Header constants and sizes
+***********************************************************************************************************************************/
+// Magic constant that identifies the format
+#define CIPHER_GCM_MAGIC                                            "pgbrGCM2"
+#define CIPHER_GCM_MAGIC_SIZE                                       (sizeof(CIPHER_GCM_MAGIC) - 1)
+
+// Offsets of the chunk size, master key salt, and file key salt in the header
+#define CIPHER_GCM_HEADER_CHUNK_SIZE_OFFSET                         CIPHER_GCM_MAGIC_SIZE
+#define CIPHER_GCM_HEADER_KEY_SALT_OFFSET                           (CIPHER_GCM_HEADER_CHUNK_SIZE_OFFSET + 4)
+#define CIPHER_GCM_HEADER_SALT_OFFSET                               (CIPHER_GCM_HEADER_KEY_SALT_OFFSET + CIPHER_GCM_SALT_SIZE)
+
+// Largest chunk size accepted in a header.  This limits the memory allocated when reading a corrupt header.
+#define CIPHER_GCM_CHUNK_SIZE_MAX                                   ((size_t)16 * 1024 * 1024)
+
+/***********************************************************************************************************************************
+Key constants
+***********************************************************************************************************************************/
+#define CIPHER_GCM_KEY_SIZE                                         32
+#define CIPHER_GCM_KEY_ITERATION                                    10000
+#define CIPHER_GCM_KEY_CACHE_TOTAL                                  16
+#define CIPHER_GCM_NONCE_SIZE                                       12
+#define CIPHER_GCM_SALT_SIZE                                        16
+
+/***********************************************************************************************************************************
+Master key cache
+
+The master key is derived from the passphrase and a random salt with PBKDF2, which is slow by design, so it is derived once per
+passphrase and salt and cached.  On encrypt the salt of a cached key for the passphrase is reused, so the files written by a process
+for a repository (or a backup with its own passphrase) share a master key.  On decrypt there is one key for each process that wrote
+the files being read, so the cache is large enough for a restore that reads files from many backups.  Passphrases are identified by
+their SHA-256 hash so they are not kept in the cache.  Keys are cleansed when their entry is replaced and when the cache is cleared
+with cipherGcmKeyCacheClear() on exit.
+***********************************************************************************************************************************/
+static struct
+{
+    unsigned int replaceIdx;                                        // Entry to replace when the key is not found
+    struct
+    {
+        bool valid;                                                 // Does the entry contain a key?
+        unsigned char passHash[SHA256_DIGEST_LENGTH];               // Hash of the passphrase
+        unsigned char salt[CIPHER_GCM_SALT_SIZE];                   // Salt used to derive the master key
+        unsigned char key[CIPHER_GCM_KEY_SIZE];                     // Master key derived from the passphrase and salt
+    } entry[CIPHER_GCM_KEY_CACHE_TOTAL];
+} cipherGcmKeyCache;
+
+/***********************************************************************************************************************************
+Object types
+***********************************************************************************************************************************/
+typedef struct CipherGcmJob
+{
+    Buffer *input;                                                  // Plaintext (encrypt) or ciphertext and tag (decrypt)
+    Buffer *output;                                                 // Ciphertext and tag (encrypt) or plaintext (decrypt)
+
+    // Fields used by workers, which cannot call buffer functions
+    const unsigned char *inputPtr;                                  // Input data
+    size_t inputSize;                                               // Input size
+    unsigned char *outputPtr;                                       // Output data
+    uint64_t chunkIdx;                                              // Chunk index used as the nonce
+
+    bool done;                                                      // Has the chunk been processed?
+    bool result;                                                    // Was the chunk processed (and authenticated) successfully?
+} CipherGcmJob;
+
+typedef struct CipherGcmWorker
+{
+    CipherGcm *cipher;                                              // Cipher object that owns the worker
+    EVP_CIPHER_CTX *context;                                        // Cipher context
+    pthread_t thread;                                               // Worker thread
+} CipherGcmWorker;
+
+struct CipherGcm
+{
+    MemContext *memContext;                                         // Context to store data
+    IoFilter *filter;                                               // Filter interface
+    CipherMode mode;                                                // Mode encrypt/decrypt
+    unsigned char *pass;                                            // Passphrase, freed once the key has been derived
+    size_t passSize;                                                // Size of passphrase in bytes
+    unsigned char key[CIPHER_GCM_KEY_SIZE];                         // Key derived from the passphrase and salt
+    size_t chunkSize;                                               // Plaintext size of all chunks except the last
+    Buffer *header;                                                 // Header written on encrypt or read on decrypt
+    bool headerDone;                                                // Has the header been generated/read?
+    EVP_CIPHER_CTX *context;                                        // Cipher context used when no workers are running
+
+    pthread_mutex_t mutex;                                          // Protects job state shared with workers
+    pthread_cond_t jobCond;                                         // Signalled when a job is submitted or on shutdown
+    pthread_cond_t doneCond;                                        // Signalled when a job is done
+    bool shutdown;                                                  // Should workers exit?
+
+    unsigned int workerTotal;                                       // Total workers
+    unsigned int workerStarted;                                     // Workers with a running thread
+    CipherGcmWorker *workerList;                                    // List of workers
+
+    unsigned int jobTotal;                                          // Total jobs in the ring
+    CipherGcmJob *jobList;                                          // Ring of jobs
+    uint64_t jobSubmitTotal;                                        // Jobs submitted
+    uint64_t jobStartTotal;                                         // Jobs started by workers
+    uint64_t jobOutputTotal;                                        // Jobs written to output
+
+    size_t inputOffset;                                             // Offset of input not yet copied into a chunk
+    const Buffer *pending;                                          // Data being written to output
+    size_t pendingOffset;                                           // Offset of pending data not yet written
+    bool pendingJob;                                                // Is the pending data the output of the oldest job?
+
+    bool inputSame;                                                 // Is the same input required on the next process call?
+    bool flush;                                                     // Is input complete and flushing in progress?
+    bool last;                                                      // Has the last chunk been submitted?
+    bool done;                                                      // Is processing done?
+};
+
+/***********************************************************************************************************************************
+Encrypt/decrypt a chunk
+
+On encrypt the output is the ciphertext followed by the tag.  On decrypt the input is the ciphertext followed by the tag and false
+is returned if the tag does not authenticate the ciphertext.  This runs on worker threads so it must only call OpenSSL functions.
+Each step is attempted even when a prior step failed so there are no branches that cannot be tested.
+***********************************************************************************************************************************/
+static bool
+cipherGcmChunk(
+    EVP_CIPHER_CTX *context, bool encrypt, const unsigned char *key, uint64_t chunkIdx, const unsigned char *input,
+    size_t inputSize, unsigned char *output)
+{
+    // The nonce is the chunk index
+    unsigned char nonce[CIPHER_GCM_NONCE_SIZE] = {0};
+
+    for (unsigned int byteIdx = 0; byteIdx < sizeof(chunkIdx); byteIdx++)
+        nonce[CIPHER_GCM_NONCE_SIZE - 1 - byteIdx] = (unsigned char)(chunkIdx >> (byteIdx * 8));
+
+    size_t dataSize = encrypt ? inputSize : inputSize - CIPHER_GCM_TAG_SIZE;
+    int outputSize = 0;
+    int finalSize = 0;
+
+    bool result = EVP_CipherInit_ex(context, EVP_aes_256_gcm(), NULL, key, nonce, encrypt) == 1;
+
+    if (dataSize > 0)
+        result &= EVP_CipherUpdate(context, output, &outputSize, input, (int)dataSize) == 1;
+
+    // On decrypt the tag must be set before finalizing so it can be checked
+    if (!encrypt)
+        result &= EVP_CIPHER_CTX_ctrl(context, EVP_CTRL_GCM_SET_TAG, CIPHER_GCM_TAG_SIZE, (void *)(input + dataSize)) == 1;
+
+    result &= EVP_CipherFinal_ex(context, output + outputSize, &finalSize) == 1;
+
+    // On encrypt append the tag
+    if (encrypt)
+        result &= EVP_CIPHER_CTX_ctrl(context, EVP_CTRL_GCM_GET_TAG, CIPHER_GCM_TAG_SIZE, output + dataSize) == 1;
+
+    return result;
+}
+
+/***********************************************************************************************************************************
+Process jobs until shutdown
+
+This runs on worker threads so it must only call OpenSSL and pthread functions.
+***********************************************************************************************************************************/
+static void *
+cipherGcmWorker(void *param)
+{
+    CipherGcmWorker *worker = param;
+    CipherGcm *this = worker->cipher;
+
+    pthread_mutex_lock(&this->mutex);
+
+    while (true)
+    {
+        // Wait for a job
+        while (!this->shutdown && this->jobStartTotal == this->jobSubmitTotal)
+            pthread_cond_wait(&this->jobCond, &this->mutex);
+
+        if (this->shutdown)
+            break;
+
+        CipherGcmJob *job = &this->jobList[this->jobStartTotal % this->jobTotal];
+        this->jobStartTotal++;
+
+        pthread_mutex_unlock(&this->mutex);
+
+        bool result = cipherGcmChunk(
+            worker->context, this->mode == cipherModeEncrypt, this->key, job->chunkIdx, job->inputPtr, job->inputSize,
+            job->outputPtr);
+
+        // Mark the job done
+        pthread_mutex_lock(&this->mutex);
+
+        job->result = result;
+        job->done = true;
+
+        pthread_cond_broadcast(&this->doneCond);
+    }
+
+    pthread_mutex_unlock(&this->mutex);
+
+    return NULL;
+}
+
+/***********************************************************************************************************************************
+Get the chunk size from a header and check that the header is valid
+***********************************************************************************************************************************/
+static size_t
+cipherGcmHeaderChunkSize(const unsigned char *header)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM_P(UCHARDATA, header);
+    FUNCTION_TEST_END();
+
+    ASSERT(header != NULL);
+
+    // The first bytes of the header should be equal to the magic.  If not then this is not an encrypted file, or at least not in a
+    // format we recognize.
+    if (memcmp(header, CIPHER_GCM_MAGIC, CIPHER_GCM_MAGIC_SIZE) != 0)
+        THROW(CryptoError, "cipher header invalid");
+
+    const unsigned char *chunkSizeData = header + CIPHER_GCM_HEADER_CHUNK_SIZE_OFFSET;
+    size_t result =
+        (size_t)chunkSizeData[0] << 24 | (size_t)chunkSizeData[1] << 16 | (size_t)chunkSizeData[2] << 8 | (size_t)chunkSizeData[3];
+
+    if (result == 0 || result > CIPHER_GCM_CHUNK_SIZE_MAX)
+        THROW_FMT(CryptoError, "cipher chunk size %zu is invalid", result);
+
+    FUNCTION_TEST_RETURN(result);
+}
+
+/***********************************************************************************************************************************
+Get the master key for a passphrase and salt from the cache, deriving it if needed
+
+On encrypt the salt is generated (or reused from the cache) and returned in salt, otherwise the salt read from the header is used.
+***********************************************************************************************************************************/
+static const unsigned char *
+cipherGcmKeyMaster(const unsigned char *pass, size_t passSize, unsigned char *salt, bool encrypt)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM_P(UCHARDATA, pass);
+        FUNCTION_TEST_PARAM(SIZE, passSize);
+        FUNCTION_TEST_PARAM_P(UCHARDATA, salt);
+        FUNCTION_TEST_PARAM(BOOL, encrypt);
+    FUNCTION_TEST_END();
+
+    ASSERT(pass != NULL);
+    ASSERT(salt != NULL);
+
+    const unsigned char *result = NULL;
+    unsigned char passHash[SHA256_DIGEST_LENGTH];
+
+    cryptoError(SHA256(pass, passSize, passHash) == NULL, "unable to hash passphrase");
+
+    // Search the cache for the passphrase (and salt on decrypt)
+    for (unsigned int entryIdx = 0; entryIdx < CIPHER_GCM_KEY_CACHE_TOTAL; entryIdx++)
+    {
+        if (cipherGcmKeyCache.entry[entryIdx].valid &&
+            memcmp(cipherGcmKeyCache.entry[entryIdx].passHash, passHash, sizeof(passHash)) == 0 &&
+            (encrypt || memcmp(cipherGcmKeyCache.entry[entryIdx].salt, salt, CIPHER_GCM_SALT_SIZE) == 0))
+        {
+            if (encrypt)
+                memcpy(salt, cipherGcmKeyCache.entry[entryIdx].salt, CIPHER_GCM_SALT_SIZE);
+
+            result = cipherGcmKeyCache.entry[entryIdx].key;
+            break;
+        }
+    }
+
+    // Else derive the master key into the oldest entry
+    if (result == NULL)
+    {
+        unsigned int entryIdx = cipherGcmKeyCache.replaceIdx;
+        cipherGcmKeyCache.replaceIdx = (entryIdx + 1) % CIPHER_GCM_KEY_CACHE_TOTAL;
+
+        OPENSSL_cleanse(&cipherGcmKeyCache.entry[entryIdx], sizeof(cipherGcmKeyCache.entry[entryIdx]));
+
+        if (encrypt)
+            cryptoRandomBytes(salt, CIPHER_GCM_SALT_SIZE);
+
+        cryptoError(
+            !PKCS5_PBKDF2_HMAC(
+                (const char *)pass, (int)passSize, salt, CIPHER_GCM_SALT_SIZE, CIPHER_GCM_KEY_ITERATION, EVP_sha256(),
+                CIPHER_GCM_KEY_SIZE, cipherGcmKeyCache.entry[entryIdx].key),
+            "unable to derive key");
+
+        memcpy(cipherGcmKeyCache.entry[entryIdx].passHash, passHash, sizeof(passHash));
+        memcpy(cipherGcmKeyCache.entry[entryIdx].salt, salt, CIPHER_GCM_SALT_SIZE);
+        cipherGcmKeyCache.entry[entryIdx].valid = true;
+
+        result = cipherGcmKeyCache.entry[entryIdx].key;
+    }
+
+    FUNCTION_TEST_RETURN(result);
+}
+
+/***********************************************************************************************************************************
+Clear the master key cache
+***********************************************************************************************************************************/
+void
+cipherGcmKeyCacheClear(void)
+{
+    FUNCTION_TEST_VOID();
+
+    OPENSSL_cleanse(&cipherGcmKeyCache, sizeof(cipherGcmKeyCache));
+
+    FUNCTION_TEST_RETURN_VOID();
+}
+
+/***********************************************************************************************************************************
+Derive the key and allocate jobs once the chunk size and salt are known
+***********************************************************************************************************************************/
+static void
+cipherGcmInit(CipherGcm *this, size_t chunkSize, unsigned char *header)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(CIPHER_GCM, this);
+        FUNCTION_TEST_PARAM(SIZE, chunkSize);
+        FUNCTION_TEST_PARAM_P(UCHARDATA, header);
+    FUNCTION_TEST_END();
+
+    ASSERT(this != NULL);
+    ASSERT(!this->headerDone);
+    ASSERT(header != NULL);
+
+    this->chunkSize = chunkSize;
+
+    // Derive the file key from the master key and the file salt and free the passphrase since it is no longer needed.  On encrypt
+    // the master key salt is written to the header.
+    unsigned int keySize = 0;
+    const unsigned char *keyMaster = cipherGcmKeyMaster(
+        this->pass, this->passSize, header + CIPHER_GCM_HEADER_KEY_SALT_OFFSET, this->mode == cipherModeEncrypt);
+
+    cryptoError(
+        HMAC(
+            EVP_sha256(), keyMaster, CIPHER_GCM_KEY_SIZE, header + CIPHER_GCM_HEADER_SALT_OFFSET, CIPHER_GCM_SALT_SIZE, this->key,
+            &keySize) == NULL,
+        "unable to derive key");
+
+    OPENSSL_cleanse(this->pass, this->passSize);
+
+    MEM_CONTEXT_BEGIN(this->memContext)
+    {
+        memFree(this->pass);
+        this->pass = NULL;
+
+        // Create a ring of jobs large enough to keep all workers busy while completed jobs are waiting to be written.  Job data is
+        // allocated directly in this context since child contexts (e.g. buffers) are freed before the free callback stops the
+        // workers, which may still be using the data.
+        size_t inputSize = this->mode == cipherModeEncrypt ? chunkSize : chunkSize + CIPHER_GCM_TAG_SIZE;
+        size_t outputSize = chunkSize + CIPHER_GCM_TAG_SIZE;
+
+        this->jobTotal = this->workerTotal == 0 ? 1 : this->workerTotal * 2;
+        this->jobList = memNew(sizeof(CipherGcmJob) * this->jobTotal);
+
+        for (unsigned int jobIdx = 0; jobIdx < this->jobTotal; jobIdx++)
+        {
+            CipherGcmJob *job = &this->jobList[jobIdx];
+
+            job->input = bufNewUseC(memNewRaw(inputSize), inputSize);
+            bufUsedZero(job->input);
+            job->output = bufNewUseC(memNewRaw(outputSize), outputSize);
+            bufUsedZero(job->output);
+        }
+    }
+    MEM_CONTEXT_END();
+
+    this->headerDone = true;
+
+    FUNCTION_TEST_RETURN_VOID();
+}
+
+/***********************************************************************************************************************************
+New object
+
+The chunk size is only used on encrypt since decrypt reads the chunk size from the header.  When threadTotal is zero all chunks are
+processed on the calling thread.
+***********************************************************************************************************************************/
+CipherGcm *
+cipherGcmNew(CipherMode mode, const Buffer *pass, unsigned int threadTotal, size_t chunkSize)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(ENUM, mode);
+        FUNCTION_LOG_PARAM(BUFFER, pass);
+        FUNCTION_LOG_PARAM(UINT, threadTotal);
+        FUNCTION_LOG_PARAM(SIZE, chunkSize);
+    FUNCTION_LOG_END();
+
+    ASSERT(pass != NULL);
+    ASSERT(bufUsed(pass) > 0);
+    ASSERT(mode == cipherModeDecrypt || (chunkSize > 0 && chunkSize <= CIPHER_GCM_CHUNK_SIZE_MAX));
+
+    // Only need to init once
+    if (!cryptoIsInit())
+        cryptoInit();
+
+    CipherGcm *this = NULL;
+
+    MEM_CONTEXT_NEW_BEGIN("CipherGcm")
+    {
+        // Allocate state and set context
+        this = memNew(sizeof(CipherGcm));
+        this->memContext = MEM_CONTEXT_NEW();
+        this->mode = mode;
+        this->workerTotal = threadTotal;
+
+        // Store the passphrase
+        this->passSize = bufUsed(pass);
+        this->pass = memNewRaw(this->passSize);
+        memcpy(this->pass, bufPtr(pass), this->passSize);
+
+        threadError(pthread_mutex_init(&this->mutex, NULL), "init mutex");
+        threadError(pthread_cond_init(&this->jobCond, NULL), "init condition");
+        threadError(pthread_cond_init(&this->doneCond, NULL), "init condition");
+
+        // Set free callback to ensure threads are stopped and cipher contexts are freed
+        memContextCallback(this->memContext, (MemContextCallback)cipherGcmFree, this);
+
+        cryptoError(!(this->context = EVP_CIPHER_CTX_new()), "unable to create context");
+
+        // On encrypt generate the header, which will be written before the first chunk
+        this->header = bufNew(CIPHER_GCM_HEADER_SIZE);
+
+        if (mode == cipherModeEncrypt)
+        {
+            unsigned char *header = bufPtr(this->header);
+
+            memcpy(header, CIPHER_GCM_MAGIC, CIPHER_GCM_MAGIC_SIZE);
+
+            for (unsigned int byteIdx = 0; byteIdx < 4; byteIdx++)
+                header[CIPHER_GCM_HEADER_CHUNK_SIZE_OFFSET + byteIdx] = (unsigned char)(chunkSize >> ((3 - byteIdx) * 8));
+
+            cryptoRandomBytes(header + CIPHER_GCM_HEADER_SALT_OFFSET, CIPHER_GCM_SALT_SIZE);
+            bufUsedSet(this->header, CIPHER_GCM_HEADER_SIZE);
+
+            cipherGcmInit(this, chunkSize, header);
+            this->pending = this->header;
+        }
+
+        // Create filter interface
+        this->filter = ioFilterNewP(
+            CIPHER_GCM_FILTER_TYPE_STR, this, .done = (IoFilterInterfaceDone)cipherGcmDone,
+            .inOut = (IoFilterInterfaceProcessInOut)cipherGcmProcess, .inputSame = (IoFilterInterfaceInputSame)cipherGcmInputSame);
+    }
+    MEM_CONTEXT_NEW_END();
+
+    FUNCTION_LOG_RETURN(CIPHER_GCM, this);
+}
+
+/***********************************************************************************************************************************
+Start the workers
+***********************************************************************************************************************************/
+static void
+cipherGcmWorkerStart(CipherGcm *this)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(CIPHER_GCM, this);
+    FUNCTION_TEST_END();
+
+    ASSERT(this != NULL);
+    ASSERT(this->workerStarted == 0);
+
+    MEM_CONTEXT_BEGIN(this->memContext)
+    {
+        this->workerList = memNew(sizeof(CipherGcmWorker) * this->workerTotal);
+    }
+    MEM_CONTEXT_END();
+
+    while (this->workerStarted < this->workerTotal)
+    {
+        CipherGcmWorker *worker = &this->workerList[this->workerStarted];
+
+        worker->cipher = this;
+        cryptoError(!(worker->context = EVP_CIPHER_CTX_new()), "unable to create context");
+
+        threadError(pthread_create(&worker->thread, NULL, cipherGcmWorker, worker), "create thread");
+        this->workerStarted++;
+    }
+
+    FUNCTION_TEST_RETURN_VOID();
+}
+
+/***********************************************************************************************************************************
+Submit the chunk being filled.  The chunk is processed on the calling thread when there are no workers.
+***********************************************************************************************************************************/
+static void
+cipherGcmSubmit(CipherGcm *this, bool last)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(CIPHER_GCM, this);
+        FUNCTION_TEST_PARAM(BOOL, last);
+    FUNCTION_TEST_END();
+
+    ASSERT(this != NULL);
+    ASSERT(this->jobSubmitTotal - this->jobOutputTotal < this->jobTotal);
+
+    CipherGcmJob *job = &this->jobList[this->jobSubmitTotal % this->jobTotal];
+
+    // On decrypt the last chunk must at least contain the tag
+    if (this->mode == cipherModeDecrypt && last && bufUsed(job->input) < CIPHER_GCM_TAG_SIZE)
+        THROW(CryptoError, "cipher data truncated");
+
+    // Set fields for the worker
+    job->inputPtr = bufPtr(job->input);
+    job->inputSize = bufUsed(job->input);
+    job->outputPtr = bufPtr(job->output);
+    job->chunkIdx = this->jobSubmitTotal;
+
+    // Start the workers when there is more than one chunk
+    if (!last && this->workerStarted < this->workerTotal)
+        cipherGcmWorkerStart(this);
+
+    if (this->workerStarted == 0)
+    {
+        job->result = cipherGcmChunk(
+            this->context, this->mode == cipherModeEncrypt, this->key, job->chunkIdx, job->inputPtr, job->inputSize,
+            job->outputPtr);
+        job->done = true;
+
+        this->jobSubmitTotal++;
+    }
+    else
+    {
+        pthread_mutex_lock(&this->mutex);
+
+        this->jobSubmitTotal++;
+        pthread_cond_signal(&this->jobCond);
+
+        pthread_mutex_unlock(&this->mutex);
+    }
+
+    this->last = last;
+
+    FUNCTION_TEST_RETURN_VOID();
+}
+
+/***********************************************************************************************************************************
+Write pending data to the output buffer.  If there is no pending data then get the output of the oldest job, so there must be
+pending data or a job that has not been written.  Returns false when the output buffer is full or the oldest job is not done and
+wait is false.
+***********************************************************************************************************************************/
+static bool
+cipherGcmOutput(CipherGcm *this, Buffer *destination, bool wait)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(CIPHER_GCM, this);
+        FUNCTION_TEST_PARAM(BUFFER, destination);
+        FUNCTION_TEST_PARAM(BOOL, wait);
+    FUNCTION_TEST_END();
+
+    ASSERT(this != NULL);
+    ASSERT(destination != NULL);
+
+    bool result = true;
+
+    // Get the output of the oldest job
+    if (this->pending == NULL)
+    {
+        ASSERT(this->jobOutputTotal < this->jobSubmitTotal);
+
+        CipherGcmJob *job = &this->jobList[this->jobOutputTotal % this->jobTotal];
+
+        pthread_mutex_lock(&this->mutex);
+
+        while (wait && !job->done)
+            pthread_cond_wait(&this->doneCond, &this->mutex);
+
+        bool done = job->done;
+
+        pthread_mutex_unlock(&this->mutex);
+
+        if (done)
+        {
+            if (!job->result)
+                THROW_FMT(CryptoError, "unable to process cipher chunk %" PRIu64, this->jobOutputTotal);
+
+            bufUsedSet(
+                job->output,
+                this->mode == cipherModeEncrypt ?
+                    bufUsed(job->input) + CIPHER_GCM_TAG_SIZE : bufUsed(job->input) - CIPHER_GCM_TAG_SIZE);
+
+            this->pending = job->output;
+            this->pendingJob = true;
+        }
+        else
+            result = false;
+    }
+
+    // Write as much pending data as will fit in the output buffer
+    if (this->pending != NULL)
+    {
+        size_t writeSize = bufUsed(this->pending) - this->pendingOffset;
+
+        if (writeSize > bufRemains(destination))
+        {
+            writeSize = bufRemains(destination);
+            result = false;
+        }
+
+        bufCatSub(destination, this->pending, this->pendingOffset, writeSize);
+        this->pendingOffset += writeSize;
+
+        // If all pending data has been written then free the job for reuse
+        if (this->pendingOffset == bufUsed(this->pending))
+        {
+            if (this->pendingJob)
+            {
+                CipherGcmJob *job = &this->jobList[this->jobOutputTotal % this->jobTotal];
+
+                bufUsedZero(job->input);
+                bufUsedZero(job->output);
+                job->done = false;
+
+                this->jobOutputTotal++;
+            }
+
+            this->pending = NULL;
+            this->pendingOffset = 0;
+            this->pendingJob = false;
+        }
+    }
+
+    FUNCTION_TEST_RETURN(result);
+}
+
+/***********************************************************************************************************************************
+Encrypt/decrypt data
+***********************************************************************************************************************************/
+void
+cipherGcmProcess(CipherGcm *this, const Buffer *source, Buffer *destination)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(CIPHER_GCM, this);
+        FUNCTION_LOG_PARAM(BUFFER, source);
+        FUNCTION_LOG_PARAM(BUFFER, destination);
+    FUNCTION_LOG_END();
+
+    ASSERT(this != NULL);
+    ASSERT(!this->done);
+    ASSERT(destination != NULL);
+    ASSERT(!this->flush || source == NULL);
+
+    bool outputFull = false;
+
+    // Flushing
+    if (source == NULL)
+        this->flush = true;
+    // Else new input
+    else if (!this->inputSame)
+        this->inputOffset = 0;
+
+    // On decrypt read the header before any chunks
+    if (!this->headerDone)
+    {
+        if (source != NULL)
+        {
+            size_t copySize = CIPHER_GCM_HEADER_SIZE - bufUsed(this->header);
+
+            if (copySize > bufUsed(source) - this->inputOffset)
+                copySize = bufUsed(source) - this->inputOffset;
+
+            bufCatSub(this->header, source, this->inputOffset, copySize);
+            this->inputOffset += copySize;
+
+            if (bufUsed(this->header) == CIPHER_GCM_HEADER_SIZE)
+            {
+                cipherGcmInit(this, cipherGcmHeaderChunkSize(bufPtr(this->header)), bufPtr(this->header));
+            }
+        }
+        // Else the header is incomplete
+        else
+            THROW(CryptoError, "cipher header missing");
+    }
+
+    // Copy input into chunks and submit each chunk when it is full
+    while (!outputFull && source != NULL && this->inputOffset < bufUsed(source))
+    {
+        // If all jobs are in use then the oldest job must be written before another chunk can be filled
+        if (this->jobSubmitTotal - this->jobOutputTotal == this->jobTotal)
+        {
+            outputFull = !cipherGcmOutput(this, destination, true);
+            continue;
+        }
+
+        CipherGcmJob *job = &this->jobList[this->jobSubmitTotal % this->jobTotal];
+        size_t copySize = bufSize(job->input) - bufUsed(job->input);
+
+        if (copySize > bufUsed(source) - this->inputOffset)
+            copySize = bufUsed(source) - this->inputOffset;
+
+        bufCatSub(job->input, source, this->inputOffset, copySize);
+        this->inputOffset += copySize;
+
+        if (bufFull(job->input))
+            cipherGcmSubmit(this, false);
+    }
+
+    // Submit the last chunk when flushing
+    while (!outputFull && this->flush && !this->last)
+    {
+        if (this->jobSubmitTotal - this->jobOutputTotal == this->jobTotal)
+            outputFull = !cipherGcmOutput(this, destination, true);
+        else
+            cipherGcmSubmit(this, true);
+    }
+
+    // Write completed output.  When flushing wait for each job since nothing else can be done until all jobs are written.
+    while (!outputFull && (this->pending != NULL || this->jobOutputTotal < this->jobSubmitTotal))
+    {
+        if (!cipherGcmOutput(this, destination, this->flush))
+            break;
+
+        // Processing is done when all jobs have been written
+        if (this->last && this->jobOutputTotal == this->jobSubmitTotal)
+            this->done = true;
+    }
+
+    // Can more input be provided on the next call?
+    this->inputSame = this->flush ? !this->done : this->inputOffset < bufUsed(source);
+
+    FUNCTION_LOG_RETURN_VOID();
+}
+
+/***********************************************************************************************************************************
+Get the offset in the encrypted data of the chunk that contains the plaintext offset.  The encrypted data read from this offset can
+be passed to cipherGcmDecryptRange().
+***********************************************************************************************************************************/
+uint64_t
+cipherGcmRangeOffset(const Buffer *header, uint64_t offset)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(BUFFER, header);
+        FUNCTION_LOG_PARAM(UINT64, offset);
+    FUNCTION_LOG_END();
+
+    ASSERT(header != NULL);
+    ASSERT(bufUsed(header) == CIPHER_GCM_HEADER_SIZE);
+
+    size_t chunkSize = cipherGcmHeaderChunkSize(bufPtr(header));
+
+    FUNCTION_LOG_RETURN(UINT64, CIPHER_GCM_HEADER_SIZE + offset / chunkSize * (chunkSize + CIPHER_GCM_TAG_SIZE));
+}
+
+/***********************************************************************************************************************************
+Get the size of the encrypted data required to decrypt a plaintext range.  The size may extend past the end of the encrypted data.
+***********************************************************************************************************************************/
+uint64_t
+cipherGcmRangeSize(const Buffer *header, uint64_t offset, uint64_t size)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(BUFFER, header);
+        FUNCTION_LOG_PARAM(UINT64, offset);
+        FUNCTION_LOG_PARAM(UINT64, size);
+    FUNCTION_LOG_END();
+
+    ASSERT(header != NULL);
+    ASSERT(bufUsed(header) == CIPHER_GCM_HEADER_SIZE);
+    ASSERT(size > 0);
+
+    size_t chunkSize = cipherGcmHeaderChunkSize(bufPtr(header));
+
+    FUNCTION_LOG_RETURN(
+        UINT64, ((offset + size - 1) / chunkSize - offset / chunkSize + 1) * (chunkSize + CIPHER_GCM_TAG_SIZE));
+}
+
+/***********************************************************************************************************************************
+Decrypt a range of the plaintext
+
+The header is the first CIPHER_GCM_HEADER_SIZE bytes of the encrypted data and the encrypted data must start at the offset returned
+by cipherGcmRangeOffset().  Fewer bytes than requested are returned when the range extends past the end of the plaintext, but the
+range must start before the end of the plaintext since otherwise there is no way to tell the data from a truncated file.
+***********************************************************************************************************************************/
+Buffer *
+cipherGcmDecryptRange(const Buffer *pass, const Buffer *header, const Buffer *encrypted, uint64_t offset, size_t size)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(BUFFER, pass);
+        FUNCTION_LOG_PARAM(BUFFER, header);
+        FUNCTION_LOG_PARAM(BUFFER, encrypted);
+        FUNCTION_LOG_PARAM(UINT64, offset);
+        FUNCTION_LOG_PARAM(SIZE, size);
+    FUNCTION_LOG_END();
+
+    ASSERT(pass != NULL);
+    ASSERT(header != NULL);
+    ASSERT(bufUsed(header) == CIPHER_GCM_HEADER_SIZE);
+    ASSERT(encrypted != NULL);
+
+    Buffer *result = bufNew(size);
+
+    MEM_CONTEXT_TEMP_BEGIN()
+    {
+        CipherGcm *this = cipherGcmNew(cipherModeDecrypt, pass, 0, 0);
+        cipherGcmInit(this, cipherGcmHeaderChunkSize(bufPtr(header)), bufPtr(header));
+
+        Buffer *chunk = bufNew(this->chunkSize);
+        uint64_t chunkIdx = offset / this->chunkSize;
+        size_t chunkOffset = (size_t)(offset % this->chunkSize);
+        size_t encryptedOffset = 0;
+        bool last = false;
+
+        // Decrypt chunks until the range is complete or the last chunk has been decrypted
+        while (!last && bufUsed(result) < size)
+        {
+            // A chunk smaller than a full chunk is the last chunk
+            size_t encryptedSize = bufUsed(encrypted) - encryptedOffset;
+
+            if (encryptedSize >= this->chunkSize + CIPHER_GCM_TAG_SIZE)
+                encryptedSize = this->chunkSize + CIPHER_GCM_TAG_SIZE;
+            else
+                last = true;
+
+            if (encryptedSize < CIPHER_GCM_TAG_SIZE)
+                THROW(CryptoError, "cipher data truncated");
+
+            if (!cipherGcmChunk(
+                    this->context, false, this->key, chunkIdx, bufPtr(encrypted) + encryptedOffset, encryptedSize, bufPtr(chunk)))
+            {
+                THROW_FMT(CryptoError, "unable to process cipher chunk %" PRIu64, chunkIdx);
+            }
+
+            // Copy the part of the chunk that is in the range
+            size_t chunkSize = encryptedSize - CIPHER_GCM_TAG_SIZE;
+
+            if (chunkOffset < chunkSize)
+            {
+                size_t copySize = chunkSize - chunkOffset;
+
+                if (copySize > size - bufUsed(result))
+                    copySize = size - bufUsed(result);
+
+                bufCatC(result, bufPtr(chunk), chunkOffset, copySize);
+            }
+
+            chunkIdx++;
+            chunkOffset = 0;
+            encryptedOffset += encryptedSize;
+        }
+    }
+    MEM_CONTEXT_TEMP_END();
+
+    FUNCTION_LOG_RETURN(BUFFER, result);
+}
+
+/***********************************************************************************************************************************
+Is cipher done?
+***********************************************************************************************************************************/
+bool
+cipherGcmDone(const CipherGcm *this)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(CIPHER_GCM, this);
+    FUNCTION_TEST_END();
+
+    ASSERT(this != NULL);
+
+    FUNCTION_TEST_RETURN(this->done);
+}
+
+/***********************************************************************************************************************************
+Get filter interface
+***********************************************************************************************************************************/
+IoFilter *
+cipherGcmFilter(const CipherGcm *this)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(CIPHER_GCM, this);
+    FUNCTION_TEST_END();
+
+    ASSERT(this != NULL);
+
+    FUNCTION_TEST_RETURN(this->filter);
+}
+
+/***********************************************************************************************************************************
+Is the same input required on the next process call?
+***********************************************************************************************************************************/
+bool
+cipherGcmInputSame(const CipherGcm *this)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(CIPHER_GCM, this);
+    FUNCTION_TEST_END();
+
+    ASSERT(this != NULL);
+
+    FUNCTION_TEST_RETURN(this->inputSame);
+}
+
+/***********************************************************************************************************************************
+Render as string for logging
+***********************************************************************************************************************************/
+String *
+cipherGcmToLog(const CipherGcm *this)
+{
+    return strNewFmt(
+        "{inputSame: %s, done: %s, flushing: %s, threadTotal: %u, threadStarted: %u, chunkSize: %zu}",
+        cvtBoolToConstZ(this->inputSame), cvtBoolToConstZ(this->done), cvtBoolToConstZ(this->flush), this->workerTotal,
+        this->workerStarted, this->chunkSize);
+}
+
+/***********************************************************************************************************************************
+Free memory
+***********************************************************************************************************************************/
+void
+cipherGcmFree(CipherGcm *this)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(CIPHER_GCM, this);
+    FUNCTION_LOG_END();
+
+    if (this != NULL)
+    {
+        // Stop the workers.  Jobs that have not been started are abandoned.
+        pthread_mutex_lock(&this->mutex);
+
+        this->shutdown = true;
+        pthread_cond_broadcast(&this->jobCond);
+
+        pthread_mutex_unlock(&this->mutex);
+
+        for (unsigned int workerIdx = 0; workerIdx < this->workerStarted; workerIdx++)
+            pthread_join(this->workerList[workerIdx].thread, NULL);
+
+        // Free cipher contexts and clear the key
+        for (unsigned int workerIdx = 0; workerIdx < this->workerStarted; workerIdx++)
+            EVP_CIPHER_CTX_free(this->workerList[workerIdx].context);
+
+        EVP_CIPHER_CTX_free(this->context);
+        OPENSSL_cleanse(this->key, sizeof(this->key));
+
+        pthread_cond_destroy(&this->doneCond);
+        pthread_cond_destroy(&this->jobCond);
+        pthread_mutex_destroy(&this->mutex);
+
+        memContextCallbackClear(this->memContext);
+        memContextFree(this->memContext);
+    }
+
+    FUNCTION_LOG_RETURN_VOID();
+}
@@ -0,0 +1,79 @@
+/***********************************************************************************************************************************
+Chunked AES-256-GCM Cipher
+
+Encrypt/decrypt IO in independent chunks with AES-256-GCM.  Each chunk is authenticated, so corruption or tampering is detected
+without a separate hash.  Chunks do not depend on each other so they are processed concurrently by worker threads, and any range of
+the plaintext can be decrypted without decrypting the chunks before it (see cipherGcmDecryptRange()).
+
+The format is a header followed by the chunks:
+
+header: magic (8 bytes) + chunk size (4 bytes, big-endian) + master key salt (16 bytes) + file key salt (16 bytes)
+chunk: ciphertext (chunk size bytes, except for the last chunk) + tag (16 bytes)
+
+A master key is derived from the passphrase and a random master key salt with PBKDF2-HMAC-SHA256 and the key for each file is
+HMAC-SHA256 of the random file key salt with the master key, so the expensive derivation is only done once per passphrase and master
+key salt.  The nonce of each chunk is its index, so chunks cannot be
+reordered or moved between files.  The last chunk is always smaller than the chunk size (it is empty when the plaintext is a
+multiple of the chunk size) so a file that has been truncated on a chunk boundary is detected.
+***********************************************************************************************************************************/
+#ifndef CRYPTO_CIPHERGCM_H
+#define CRYPTO_CIPHERGCM_H
+
+/***********************************************************************************************************************************
+Object type
+***********************************************************************************************************************************/
+typedef struct CipherGcm CipherGcm;
+
+#include "common/io/filter/filter.h"
+#include "common/type/buffer.h"
+#include "crypto/crypto.h"
+
+/***********************************************************************************************************************************
+Constants
+***********************************************************************************************************************************/
+#define CIPHER_GCM_CHUNK_SIZE_DEFAULT                               ((size_t)64 * 1024)
+#define CIPHER_GCM_HEADER_SIZE                                      44
+#define CIPHER_GCM_TAG_SIZE                                         16
+#define CIPHER_GCM_THREAD_TOTAL_DEFAULT                             2
+
+/***********************************************************************************************************************************
+Constructor
+***********************************************************************************************************************************/
+CipherGcm *cipherGcmNew(CipherMode mode, const Buffer *pass, unsigned int threadTotal, size_t chunkSize);
+
+/***********************************************************************************************************************************
+Functions
+***********************************************************************************************************************************/
+void cipherGcmProcess(CipherGcm *this, const Buffer *source, Buffer *destination);
+
+// Random access decryption
+uint64_t cipherGcmRangeOffset(const Buffer *header, uint64_t offset);
+uint64_t cipherGcmRangeSize(const Buffer *header, uint64_t offset, uint64_t size);
+Buffer *cipherGcmDecryptRange(const Buffer *pass, const Buffer *header, const Buffer *encrypted, uint64_t offset, size_t size);
+
+// Cleanse cached master keys
+void cipherGcmKeyCacheClear(void);
+
+/***********************************************************************************************************************************
+Getters
+***********************************************************************************************************************************/
+bool cipherGcmDone(const CipherGcm *this);
+IoFilter *cipherGcmFilter(const CipherGcm *this);
+bool cipherGcmInputSame(const CipherGcm *this);
+
+/***********************************************************************************************************************************
+Destructor
+***********************************************************************************************************************************/
+void cipherGcmFree(CipherGcm *this);
+
+/***********************************************************************************************************************************
+Macros for function logging
+***********************************************************************************************************************************/
+String *cipherGcmToLog(const CipherGcm *this);
+
+#define FUNCTION_LOG_CIPHER_GCM_TYPE                                                                                               \
+    CipherGcm *
+#define FUNCTION_LOG_CIPHER_GCM_FORMAT(value, buffer, bufferSize)                                                                  \
+    FUNCTION_LOG_STRING_OBJECT_FORMAT(value, cipherGcmToLog, buffer, bufferSize)
+
+#endif
@@ -17,6 +17,7 @@ Cipher types
 ***********************************************************************************************************************************/
 STRING_EXTERN(CIPHER_TYPE_NONE_STR,                                 CIPHER_TYPE_NONE);
 STRING_EXTERN(CIPHER_TYPE_AES_256_CBC_STR,                          CIPHER_TYPE_AES_256_CBC);
+STRING_EXTERN(CIPHER_TYPE_AES_256_GCM_STR,                          CIPHER_TYPE_AES_256_GCM);
 
 /***********************************************************************************************************************************
 Flag to indicate if OpenSSL has already been initialized
@@ -70,6 +71,8 @@ cipherType(const String *name)
 
     if (strEq(name, CIPHER_TYPE_AES_256_CBC_STR))
         result = cipherTypeAes256Cbc;
+    else if (strEq(name, CIPHER_TYPE_AES_256_GCM_STR))
+        result = cipherTypeAes256Gcm;
     else if (!strEq(name, CIPHER_TYPE_NONE_STR))
         THROW_FMT(AssertError, "invalid cipher name '%s'", strPtr(name));
 
@@ -87,6 +90,8 @@ cipherTypeName(CipherType type)
 
     if (type == cipherTypeAes256Cbc)
         result = CIPHER_TYPE_AES_256_CBC_STR;
+    else if (type == cipherTypeAes256Gcm)
+        result = CIPHER_TYPE_AES_256_GCM_STR;
     else if (type != cipherTypeNone)
         THROW_FMT(AssertError, "invalid cipher type %u", type);
 
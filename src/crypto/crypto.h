@@ -20,6 +20,7 @@ typedef enum
 {
     cipherTypeNone,
     cipherTypeAes256Cbc,
+    cipherTypeAes256Gcm,
 } CipherType;
 
 #include <common/type/string.h>
@@ -28,6 +29,8 @@ typedef enum
     STRING_DECLARE(CIPHER_TYPE_NONE_STR);
 #define CIPHER_TYPE_AES_256_CBC                                     "aes-256-cbc"
     STRING_DECLARE(CIPHER_TYPE_AES_256_CBC_STR);
+#define CIPHER_TYPE_AES_256_GCM                                     "aes-256-gcm"
+    STRING_DECLARE(CIPHER_TYPE_AES_256_GCM_STR);
 
 /***********************************************************************************************************************************
 Functions
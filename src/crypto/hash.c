@@ -35,6 +35,7 @@ struct CryptoHash
     MemContext *memContext;                                         // Context to store data
     const EVP_MD *hashType;                                         // Hash type (sha1, md5, etc.)
     EVP_MD_CTX *hashContext;                                        // Message hash context
+    CryptoHashMultiStream *multiStream;                             // Multi-buffer stream (replaces the message hash context)
     Buffer *hash;                                                   // Hash in binary form
     IoFilter *filter;                                               // Filter interface
 };
@@ -87,6 +88,41 @@ cryptoHashNew(const String *type)
     FUNCTION_LOG_RETURN(CRYPTO_HASH, this);
 }
 
+/***********************************************************************************************************************************
+New sha1 object that is hashed along with other streams by a multi-buffer engine
+***********************************************************************************************************************************/
+CryptoHash *
+cryptoHashNewMulti(CryptoHashMulti *multi)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(CRYPTO_HASH_MULTI, multi);
+    FUNCTION_LOG_END();
+
+    ASSERT(multi != NULL);
+
+    // Allocate memory to hold process state
+    CryptoHash *this = NULL;
+
+    MEM_CONTEXT_NEW_BEGIN("CryptoHash")
+    {
+        // Allocate state and set context
+        this = memNew(sizeof(CryptoHash));
+        this->memContext = MEM_CONTEXT_NEW();
+        this->hashType = EVP_sha1();
+
+        // Create stream
+        this->multiStream = cryptoHashMultiStreamNew(multi);
+
+        // Create filter interface
+        this->filter = ioFilterNewP(
+            CRYPTO_HASH_FILTER_TYPE_STR, this, .in = (IoFilterInterfaceProcessIn)cryptoHashProcess,
+            .result = (IoFilterInterfaceResult)cryptoHashResult);
+    }
+    MEM_CONTEXT_NEW_END();
+
+    FUNCTION_LOG_RETURN(CRYPTO_HASH, this);
+}
+
 /***********************************************************************************************************************************
 Add message data to the hash
 ***********************************************************************************************************************************/
@@ -100,10 +136,13 @@ cryptoHashProcessC(CryptoHash *this, const unsigned char *message, size_t messag
     FUNCTION_LOG_END();
 
     ASSERT(this != NULL);
-    ASSERT(this->hashContext != NULL);
+    ASSERT(this->hashContext != NULL || this->multiStream != NULL);
     ASSERT(message != NULL);
 
-    cryptoError(!EVP_DigestUpdate(this->hashContext, message, messageSize), "unable to process message hash");
+    if (this->multiStream != NULL)
+        cryptoHashMultiStreamProcess(this->multiStream, message, messageSize);
+    else
+        cryptoError(!EVP_DigestUpdate(this->hashContext, message, messageSize), "unable to process message hash");
 
     FUNCTION_LOG_RETURN_VOID();
 }
@@ -164,11 +203,22 @@ cryptoHash(CryptoHash *this)
         {
             this->hash = bufNew((size_t)EVP_MD_size(this->hashType));
 
-            cryptoError(!EVP_DigestFinal_ex(this->hashContext, bufPtr(this->hash), NULL), "unable to finalize message hash");
-
-            // Free the context
-            EVP_MD_CTX_destroy(this->hashContext);
-            this->hashContext = NULL;
+            if (this->multiStream != NULL)
+            {
+                cryptoHashMultiStreamFinal(this->multiStream, bufPtr(this->hash));
+
+                // Free the stream so it is no longer flushed with the other streams
+                cryptoHashMultiStreamFree(this->multiStream);
+                this->multiStream = NULL;
+            }
+            else
+            {
+                cryptoError(!EVP_DigestFinal_ex(this->hashContext, bufPtr(this->hash), NULL), "unable to finalize message hash");
+
+                // Free the context
+                EVP_MD_CTX_destroy(this->hashContext);
+                this->hashContext = NULL;
+            }
         }
         MEM_CONTEXT_END();
     }
@@ -324,5 +374,5 @@ cryptoHmacOne(const String *type, const Buffer *key, const Buffer *message)
     // Calculate the HMAC
     HMAC(hashType, bufPtr(key), (int)bufSize(key), bufPtr(message), bufSize(message), bufPtr(result), NULL);
 
-    FUNCTION_TEST_RETURN(result);
+    FUNCTION_LOG_RETURN(BUFFER, result);
 }
@@ -13,6 +13,7 @@ typedef struct CryptoHash CryptoHash;
 
 #include "common/io/filter/filter.h"
 #include "common/type/string.h"
+#include "crypto/hashMulti.h"
 
 /***********************************************************************************************************************************
 Hash types
@@ -28,6 +29,7 @@ Hash types
 Constructor
 ***********************************************************************************************************************************/
 CryptoHash *cryptoHashNew(const String *type);
+CryptoHash *cryptoHashNewMulti(CryptoHashMulti *multi);
 
 /***********************************************************************************************************************************
 Functions
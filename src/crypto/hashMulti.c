@@ -0,0 +1,720 @@
+/***********************************************************************************************************************************
+Multi-Buffer SHA-1 Hash
+
+The SHA-1 block function is written once with GCC vector extensions and instantiated for 1, 4, 8, and 16 lanes.  The vector
+implementations require SSE2, AVX2, and AVX-512 respectively.  The best implementation supported by the CPU is selected at runtime
+and the portable implementation is used when none are supported.  SHA-NI is not used since it accelerates a single stream rather
+than several, and OpenSSL already uses it for the single-stream CryptoHash.
+***********************************************************************************************************************************/
+#include <string.h>
+
+#include "common/cpu.h"
+
+/***********************************************************************************************************************************
+Vector implementations are only available when the compiler supports them (see common/cpu.h)
+***********************************************************************************************************************************/
+#ifdef CPU_X86_VECTOR
+    #define CRYPTO_HASH_MULTI_X86
+#endif
+
+#include "common/debug.h"
+#include "common/log.h"
+#include "common/memContext.h"
+#include "crypto/hashMulti.h"
+
+/***********************************************************************************************************************************
+SHA-1 block size and the largest number of lanes in any implementation
+***********************************************************************************************************************************/
+#define SHA1_BLOCK_SIZE                                             64
+#define SHA1_LANE_MAX                                               16
+
+/***********************************************************************************************************************************
+Object types
+***********************************************************************************************************************************/
+struct CryptoHashMulti
+{
+    MemContext *memContext;                                         // Mem context
+    unsigned int impl;                                              // Implementation used to hash blocks
+    CryptoHashMultiStream *streamFirst;                             // Streams created from this engine
+    unsigned int streamTotal;                                       // Total streams created from this engine
+};
+
+struct CryptoHashMultiStream
+{
+    MemContext *memContext;                                         // Mem context
+    CryptoHashMulti *multi;                                         // Engine that hashes the queued blocks (NULL when detached)
+    CryptoHashMultiStream *streamPrev;                              // Previous stream of the engine
+    CryptoHashMultiStream *streamNext;                              // Next stream of the engine
+
+    uint32_t state[5];                                              // SHA-1 state
+    uint64_t size;                                                  // Total size of the message
+    bool final;                                                     // Has the message been padded?
+
+    unsigned char *queue;                                           // Data waiting to be hashed
+    size_t queueSize;                                               // Size of data in the queue
+    size_t queueDone;                                               // Size of data hashed during a flush
+};
+
+/***********************************************************************************************************************************
+SHA-1 block function
+
+Each lane hashes blockTotal blocks from data[lane] into state[lane].  The rounds are written with operators that work on both
+scalars and GCC vectors so the same code is used for every lane total.
+***********************************************************************************************************************************/
+typedef void (*CryptoHashMultiBlockFunc)(uint32_t *const *state, const unsigned char *const *data, size_t blockTotal);
+
+#define SHA1_ROL(x, n)                                              (((x) << (n)) | ((x) >> (32 - (n))))
+
+#define SHA1_F1(b, c, d)                                            ((d) ^ ((b) & ((c) ^ (d))))
+#define SHA1_F2(b, c, d)                                            ((b) ^ (c) ^ (d))
+#define SHA1_F3(b, c, d)                                            (((b) & (c)) | ((d) & ((b) | (c))))
+
+// Message schedule for round t, calculated in place in a 16 word circular buffer
+#define SHA1_W(t)                                                                                                                  \
+    ((t) < 16 ? w[t] :                                                                                                             \
+        (w[(t) & 15] = SHA1_ROL(w[((t) - 3) & 15] ^ w[((t) - 8) & 15] ^ w[((t) - 14) & 15] ^ w[(t) & 15], 1)))
+
+// Rounds rotate the roles of the working variables rather than moving values between them
+#define SHA1_ROUND(a, b, c, d, e, f, k, t)                                                                                         \
+    do                                                                                                                             \
+    {                                                                                                                              \
+        e += SHA1_ROL(a, 5) + f(b, c, d) + (uint32_t)(k) + SHA1_W(t);                                                              \
+        b = SHA1_ROL(b, 30);                                                                                                       \
+    }                                                                                                                              \
+    while (0)
+
+#define SHA1_ROUND5(f, k, t)                                                                                                       \
+    SHA1_ROUND(a, b, c, d, e, f, k, t);                                                                                            \
+    SHA1_ROUND(e, a, b, c, d, f, k, t + 1);                                                                                        \
+    SHA1_ROUND(d, e, a, b, c, f, k, t + 2);                                                                                        \
+    SHA1_ROUND(c, d, e, a, b, f, k, t + 3);                                                                                        \
+    SHA1_ROUND(b, c, d, e, a, f, k, t + 4)
+
+#define SHA1_ROUND20(f, k, t)                                                                                                      \
+    SHA1_ROUND5(f, k, t);                                                                                                          \
+    SHA1_ROUND5(f, k, t + 5);                                                                                                      \
+    SHA1_ROUND5(f, k, t + 10);                                                                                                     \
+    SHA1_ROUND5(f, k, t + 15)
+
+// Load a big-endian word
+static inline uint32_t
+sha1Load32(const unsigned char *data)
+{
+#ifdef CRYPTO_HASH_MULTI_X86
+    uint32_t result;
+    memcpy(&result, data, sizeof(result));
+
+    return __builtin_bswap32(result);
+#else
+    return (uint32_t)data[0] << 24 | (uint32_t)data[1] << 16 | (uint32_t)data[2] << 8 | (uint32_t)data[3];
+#endif
+}
+
+// Body of the block function.  State and message words are transposed through arrays so each vector holds one word from every lane.
+#define SHA1_BLOCK(Vector, laneTotal)                                                                                              \
+    do                                                                                                                             \
+    {                                                                                                                              \
+        uint32_t transpose[16][laneTotal] __attribute__((aligned(64)));                                                            \
+        Vector a, b, c, d, e, w[16];                                                                                               \
+                                                                                                                                   \
+        for (unsigned int laneIdx = 0; laneIdx < laneTotal; laneIdx++)                                                             \
+        {                                                                                                                          \
+            for (unsigned int wordIdx = 0; wordIdx < 5; wordIdx++)                                                                 \
+                transpose[wordIdx][laneIdx] = state[laneIdx][wordIdx];                                                             \
+        }                                                                                                                          \
+                                                                                                                                   \
+        memcpy(&a, transpose[0], sizeof(Vector));                                                                                  \
+        memcpy(&b, transpose[1], sizeof(Vector));                                                                                  \
+        memcpy(&c, transpose[2], sizeof(Vector));                                                                                  \
+        memcpy(&d, transpose[3], sizeof(Vector));                                                                                  \
+        memcpy(&e, transpose[4], sizeof(Vector));                                                                                  \
+                                                                                                                                   \
+        for (size_t blockIdx = 0; blockIdx < blockTotal; blockIdx++)                                                               \
+        {                                                                                                                          \
+            for (unsigned int laneIdx = 0; laneIdx < laneTotal; laneIdx++)                                                         \
+            {                                                                                                                      \
+                const unsigned char *block = data[laneIdx] + blockIdx * SHA1_BLOCK_SIZE;                                           \
+                                                                                                                                   \
+                for (unsigned int wordIdx = 0; wordIdx < 16; wordIdx++)                                                            \
+                    transpose[wordIdx][laneIdx] = sha1Load32(block + wordIdx * sizeof(uint32_t));                                  \
+            }                                                                                                                      \
+                                                                                                                                   \
+            for (unsigned int wordIdx = 0; wordIdx < 16; wordIdx++)                                                                \
+                memcpy(&w[wordIdx], transpose[wordIdx], sizeof(Vector));                                                           \
+                                                                                                                                   \
+            Vector aPrior = a, bPrior = b, cPrior = c, dPrior = d, ePrior = e;                                                     \
+                                                                                                                                   \
+            SHA1_ROUND20(SHA1_F1, 0x5A827999, 0);                                                                                  \
+            SHA1_ROUND20(SHA1_F2, 0x6ED9EBA1, 20);                                                                                 \
+            SHA1_ROUND20(SHA1_F3, 0x8F1BBCDC, 40);                                                                                 \
+            SHA1_ROUND20(SHA1_F2, 0xCA62C1D6, 60);                                                                                 \
+                                                                                                                                   \
+            a += aPrior;                                                                                                           \
+            b += bPrior;                                                                                                           \
+            c += cPrior;                                                                                                           \
+            d += dPrior;                                                                                                           \
+            e += ePrior;                                                                                                           \
+        }                                                                                                                          \
+                                                                                                                                   \
+        memcpy(transpose[0], &a, sizeof(Vector));                                                                                  \
+        memcpy(transpose[1], &b, sizeof(Vector));                                                                                  \
+        memcpy(transpose[2], &c, sizeof(Vector));                                                                                  \
+        memcpy(transpose[3], &d, sizeof(Vector));                                                                                  \
+        memcpy(transpose[4], &e, sizeof(Vector));                                                                                  \
+                                                                                                                                   \
+        for (unsigned int laneIdx = 0; laneIdx < laneTotal; laneIdx++)                                                             \
+        {                                                                                                                          \
+            for (unsigned int wordIdx = 0; wordIdx < 5; wordIdx++)                                                                 \
+                state[laneIdx][wordIdx] = transpose[wordIdx][laneIdx];                                                             \
+        }                                                                                                                          \
+    }                                                                                                                              \
+    while (0)
+
+static void
+cryptoHashMultiBlockPortable(uint32_t *const *state, const unsigned char *const *data, size_t blockTotal)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM_PP(UINT32, state);
+        FUNCTION_TEST_PARAM_PP(UCHARDATA, data);
+        FUNCTION_TEST_PARAM(SIZE, blockTotal);
+    FUNCTION_TEST_END();
+
+    SHA1_BLOCK(uint32_t, 1);
+
+    FUNCTION_TEST_RETURN_VOID();
+}
+
+#ifdef CRYPTO_HASH_MULTI_X86
+
+static void
+cryptoHashMultiBlockSse2(uint32_t *const *state, const unsigned char *const *data, size_t blockTotal)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM_PP(UINT32, state);
+        FUNCTION_TEST_PARAM_PP(UCHARDATA, data);
+        FUNCTION_TEST_PARAM(SIZE, blockTotal);
+    FUNCTION_TEST_END();
+
+    typedef uint32_t Vector __attribute__((vector_size(4 * sizeof(uint32_t))));
+    SHA1_BLOCK(Vector, 4);
+
+    FUNCTION_TEST_RETURN_VOID();
+}
+
+__attribute__((target("avx2"))) static void
+cryptoHashMultiBlockAvx2(uint32_t *const *state, const unsigned char *const *data, size_t blockTotal)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM_PP(UINT32, state);
+        FUNCTION_TEST_PARAM_PP(UCHARDATA, data);
+        FUNCTION_TEST_PARAM(SIZE, blockTotal);
+    FUNCTION_TEST_END();
+
+    typedef uint32_t Vector __attribute__((vector_size(8 * sizeof(uint32_t))));
+    SHA1_BLOCK(Vector, 8);
+
+    FUNCTION_TEST_RETURN_VOID();
+}
+
+__attribute__((target("avx512f"))) static void
+cryptoHashMultiBlockAvx512(uint32_t *const *state, const unsigned char *const *data, size_t blockTotal)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM_PP(UINT32, state);
+        FUNCTION_TEST_PARAM_PP(UCHARDATA, data);
+        FUNCTION_TEST_PARAM(SIZE, blockTotal);
+    FUNCTION_TEST_END();
+
+    typedef uint32_t Vector __attribute__((vector_size(16 * sizeof(uint32_t))));
+    SHA1_BLOCK(Vector, 16);
+
+    FUNCTION_TEST_RETURN_VOID();
+}
+
+#endif // CRYPTO_HASH_MULTI_X86
+
+/***********************************************************************************************************************************
+Implementations in order of preference from worst to best
+***********************************************************************************************************************************/
+typedef enum
+{
+    cryptoHashMultiImplPortable,
+#ifdef CRYPTO_HASH_MULTI_X86
+    cryptoHashMultiImplSse2,
+    cryptoHashMultiImplAvx2,
+    cryptoHashMultiImplAvx512,
+#endif
+} CryptoHashMultiImpl;
+
+static const struct CryptoHashMultiImplLocal
+{
+    const char *name;                                               // Name for logging and benchmarks
+    unsigned int laneTotal;                                         // Streams hashed at once
+    CryptoHashMultiBlockFunc block;                                 // Function to hash blocks
+} cryptoHashMultiImplLocal[] =
+{
+    {.name = "portable", .laneTotal = 1, .block = cryptoHashMultiBlockPortable},
+#ifdef CRYPTO_HASH_MULTI_X86
+    {.name = "sse2", .laneTotal = 4, .block = cryptoHashMultiBlockSse2},
+    {.name = "avx2", .laneTotal = 8, .block = cryptoHashMultiBlockAvx2},
+    {.name = "avx512", .laneTotal = 16, .block = cryptoHashMultiBlockAvx512},
+#endif
+};
+
+#define CRYPTO_HASH_MULTI_IMPL_TOTAL (sizeof(cryptoHashMultiImplLocal) / sizeof(cryptoHashMultiImplLocal[0]))
+
+/***********************************************************************************************************************************
+Is the implementation supported by the CPU?
+***********************************************************************************************************************************/
+static bool
+cryptoHashMultiImplSupported(CryptoHashMultiImpl impl)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(ENUM, impl);
+    FUNCTION_TEST_END();
+
+    bool result = true;
+
+#ifdef CRYPTO_HASH_MULTI_X86
+    __builtin_cpu_init();
+
+    switch (impl)
+    {
+        case cryptoHashMultiImplPortable:
+        case cryptoHashMultiImplSse2:
+            break;
+
+        case cryptoHashMultiImplAvx2:
+        {
+            result = __builtin_cpu_supports("avx2");
+            break;
+        }
+
+        case cryptoHashMultiImplAvx512:
+        {
+            result = __builtin_cpu_supports("avx512f");
+            break;
+        }
+    }
+#endif
+
+    FUNCTION_TEST_RETURN(result);
+}
+
+/***********************************************************************************************************************************
+Select the best implementation supported by the CPU
+***********************************************************************************************************************************/
+static CryptoHashMultiImpl
+cryptoHashMultiImplSelect(void)
+{
+    FUNCTION_TEST_VOID();
+
+    CryptoHashMultiImpl result = (CryptoHashMultiImpl)(CRYPTO_HASH_MULTI_IMPL_TOTAL - 1);
+
+    while (!cryptoHashMultiImplSupported(result))                   // {uncoverable - depends on the CPU running the test}
+        result--;                                                   // {+uncoverable}
+
+    FUNCTION_TEST_RETURN(result);
+}
+
+/***********************************************************************************************************************************
+Detach the remaining streams when the engine is freed
+
+Streams are not created in the engine's context, so when the engine and its streams share a parent that is freed the engine may be
+freed first.  The streams are kept in a list linked through the streams themselves rather than a List so they can still be reached
+here, after the engine's child contexts have been freed.
+***********************************************************************************************************************************/
+static void
+cryptoHashMultiFreeCallback(CryptoHashMulti *this)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(CRYPTO_HASH_MULTI, this);
+    FUNCTION_TEST_END();
+
+    ASSERT(this != NULL);
+
+    for (CryptoHashMultiStream *stream = this->streamFirst; stream != NULL; stream = stream->streamNext)
+        stream->multi = NULL;
+
+    FUNCTION_TEST_RETURN_VOID();
+}
+
+/***********************************************************************************************************************************
+New object
+***********************************************************************************************************************************/
+CryptoHashMulti *
+cryptoHashMultiNew(void)
+{
+    FUNCTION_LOG_VOID(logLevelTrace);
+
+    CryptoHashMulti *this = NULL;
+
+    MEM_CONTEXT_NEW_BEGIN("CryptoHashMulti")
+    {
+        this = memNew(sizeof(CryptoHashMulti));
+        this->memContext = MEM_CONTEXT_NEW();
+        this->impl = cryptoHashMultiImplSelect();
+
+        memContextCallback(this->memContext, (MemContextCallback)cryptoHashMultiFreeCallback, this);
+    }
+    MEM_CONTEXT_NEW_END();
+
+    FUNCTION_LOG_RETURN(CRYPTO_HASH_MULTI, this);
+}
+
+/***********************************************************************************************************************************
+Hash the blocks queued in all streams
+
+Lanes are assigned to streams that have blocks queued and each lane is refilled with the next waiting stream as soon as its stream
+runs out of blocks.  Lanes that cannot be filled repeat the data of the first lane into a scratch state.
+
+When only one stream is left the portable implementation is used since the other lanes would be wasted.  To give the stream a chance
+to be hashed with other streams later, a stream that is not final is only hashed until its queue is half full.
+***********************************************************************************************************************************/
+#define STREAM_BLOCK_TOTAL(stream)                                                                                                 \
+    (((stream)->queueSize - (stream)->queueDone) / SHA1_BLOCK_SIZE)
+
+static void
+cryptoHashMultiRun(CryptoHashMulti *this)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(CRYPTO_HASH_MULTI, this);
+    FUNCTION_TEST_END();
+
+    ASSERT(this != NULL);
+
+    const struct CryptoHashMultiImplLocal *impl = &cryptoHashMultiImplLocal[this->impl];
+
+    CryptoHashMultiStream *lane[SHA1_LANE_MAX];
+    unsigned int laneActive = 0;
+    CryptoHashMultiStream *streamNext = this->streamFirst;
+
+    uint32_t *state[SHA1_LANE_MAX];
+    uint32_t stateScratch[SHA1_LANE_MAX][5] = {{0}};
+    const unsigned char *data[SHA1_LANE_MAX];
+
+    do
+    {
+        // Fill empty lanes with streams that have blocks queued
+        while (laneActive < impl->laneTotal && streamNext != NULL)
+        {
+            CryptoHashMultiStream *stream = streamNext;
+            streamNext = stream->streamNext;
+
+            if (STREAM_BLOCK_TOTAL(stream) > 0)
+            {
+                lane[laneActive] = stream;
+                laneActive++;
+            }
+        }
+
+        // Hash a single stream with the portable implementation
+        if (laneActive == 1)
+        {
+            state[0] = lane[0]->state;
+            data[0] = lane[0]->queue + lane[0]->queueDone;
+            size_t blockTotal = STREAM_BLOCK_TOTAL(lane[0]);
+
+            if (!lane[0]->final && impl->laneTotal > 1)
+            {
+                size_t queueLeft = lane[0]->queueSize - lane[0]->queueDone;
+
+                blockTotal =
+                    queueLeft > CRYPTO_HASH_MULTI_QUEUE_SIZE / 2 ?
+                        (queueLeft - CRYPTO_HASH_MULTI_QUEUE_SIZE / 2) / SHA1_BLOCK_SIZE : 0;
+            }
+
+            cryptoHashMultiImplLocal[cryptoHashMultiImplPortable].block(state, data, blockTotal);
+
+            lane[0]->queueDone += blockTotal * SHA1_BLOCK_SIZE;
+            laneActive = 0;
+        }
+        // Else hash all lanes until the stream with the fewest blocks runs out
+        else if (laneActive > 1)
+        {
+            size_t blockTotal = STREAM_BLOCK_TOTAL(lane[0]);
+
+            for (unsigned int laneIdx = 0; laneIdx < impl->laneTotal; laneIdx++)
+            {
+                if (laneIdx < laneActive)
+                {
+                    state[laneIdx] = lane[laneIdx]->state;
+                    data[laneIdx] = lane[laneIdx]->queue + lane[laneIdx]->queueDone;
+
+                    if (STREAM_BLOCK_TOTAL(lane[laneIdx]) < blockTotal)
+                        blockTotal = STREAM_BLOCK_TOTAL(lane[laneIdx]);
+                }
+                else
+                {
+                    state[laneIdx] = stateScratch[laneIdx];
+                    data[laneIdx] = data[0];
+                }
+            }
+
+            impl->block(state, data, blockTotal);
+
+            // Remove streams that have no blocks left from the lanes
+            for (unsigned int laneIdx = 0; laneIdx < laneActive;)
+            {
+                lane[laneIdx]->queueDone += blockTotal * SHA1_BLOCK_SIZE;
+
+                if (STREAM_BLOCK_TOTAL(lane[laneIdx]) == 0)
+                {
+                    laneActive--;
+                    lane[laneIdx] = lane[laneActive];
+                }
+                else
+                    laneIdx++;
+            }
+        }
+    }
+    while (laneActive > 0 || streamNext != NULL);
+
+    // Move the partial blocks that are left to the beginning of each queue
+    for (CryptoHashMultiStream *stream = this->streamFirst; stream != NULL; stream = stream->streamNext)
+    {
+        if (stream->queueDone > 0)
+        {
+            stream->queueSize -= stream->queueDone;
+            memmove(stream->queue, stream->queue + stream->queueDone, stream->queueSize);
+            stream->queueDone = 0;
+        }
+    }
+
+    FUNCTION_TEST_RETURN_VOID();
+}
+
+/***********************************************************************************************************************************
+Remove the stream from the engine when it is freed, unless the engine has already been freed
+***********************************************************************************************************************************/
+static void
+cryptoHashMultiStreamFreeCallback(CryptoHashMultiStream *this)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(CRYPTO_HASH_MULTI_STREAM, this);
+    FUNCTION_TEST_END();
+
+    ASSERT(this != NULL);
+
+    if (this->multi != NULL)
+    {
+        if (this->streamPrev == NULL)
+            this->multi->streamFirst = this->streamNext;
+        else
+            this->streamPrev->streamNext = this->streamNext;
+
+        if (this->streamNext != NULL)
+            this->streamNext->streamPrev = this->streamPrev;
+
+        this->multi->streamTotal--;
+    }
+
+    FUNCTION_TEST_RETURN_VOID();
+}
+
+/***********************************************************************************************************************************
+Create a stream
+***********************************************************************************************************************************/
+CryptoHashMultiStream *
+cryptoHashMultiStreamNew(CryptoHashMulti *this)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(CRYPTO_HASH_MULTI, this);
+    FUNCTION_LOG_END();
+
+    ASSERT(this != NULL);
+
+    CryptoHashMultiStream *stream = NULL;
+
+    MEM_CONTEXT_NEW_BEGIN("CryptoHashMultiStream")
+    {
+        stream = memNew(sizeof(CryptoHashMultiStream));
+        stream->memContext = MEM_CONTEXT_NEW();
+        stream->multi = this;
+
+        stream->state[0] = 0x67452301;
+        stream->state[1] = 0xEFCDAB89;
+        stream->state[2] = 0x98BADCFE;
+        stream->state[3] = 0x10325476;
+        stream->state[4] = 0xC3D2E1F0;
+
+        // Leave room for the padding, which is added when the queue is not full
+        stream->queue = memNewRaw(CRYPTO_HASH_MULTI_QUEUE_SIZE + SHA1_BLOCK_SIZE * 2);
+
+        // Add the stream to the beginning of the engine's list
+        stream->streamNext = this->streamFirst;
+
+        if (this->streamFirst != NULL)
+            this->streamFirst->streamPrev = stream;
+
+        this->streamFirst = stream;
+        this->streamTotal++;
+
+        memContextCallback(stream->memContext, (MemContextCallback)cryptoHashMultiStreamFreeCallback, stream);
+    }
+    MEM_CONTEXT_NEW_END();
+
+    FUNCTION_LOG_RETURN(CRYPTO_HASH_MULTI_STREAM, stream);
+}
+
+/***********************************************************************************************************************************
+Add message data to the stream
+***********************************************************************************************************************************/
+void
+cryptoHashMultiStreamProcess(CryptoHashMultiStream *this, const unsigned char *message, size_t messageSize)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(CRYPTO_HASH_MULTI_STREAM, this);
+        FUNCTION_LOG_PARAM_P(UCHARDATA, message);
+        FUNCTION_LOG_PARAM(SIZE, messageSize);
+    FUNCTION_LOG_END();
+
+    ASSERT(this != NULL);
+    ASSERT(this->multi != NULL);
+    ASSERT(!this->final);
+    ASSERT(message != NULL);
+
+    this->size += messageSize;
+
+    while (messageSize > 0)
+    {
+        size_t copySize = CRYPTO_HASH_MULTI_QUEUE_SIZE - this->queueSize;
+
+        if (copySize > messageSize)
+            copySize = messageSize;
+
+        memcpy(this->queue + this->queueSize, message, copySize);
+        this->queueSize += copySize;
+        message += copySize;
+        messageSize -= copySize;
+
+        // Hash the blocks of all streams when the queue is full
+        if (this->queueSize == CRYPTO_HASH_MULTI_QUEUE_SIZE)
+        {
+            cryptoHashMultiRun(this->multi);
+            ASSERT(this->queueSize < CRYPTO_HASH_MULTI_QUEUE_SIZE);
+        }
+    }
+
+    FUNCTION_LOG_RETURN_VOID();
+}
+
+/***********************************************************************************************************************************
+Pad the message and return the hash
+***********************************************************************************************************************************/
+void
+cryptoHashMultiStreamFinal(CryptoHashMultiStream *this, unsigned char *hash)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(CRYPTO_HASH_MULTI_STREAM, this);
+        FUNCTION_LOG_PARAM_P(UCHARDATA, hash);
+    FUNCTION_LOG_END();
+
+    ASSERT(this != NULL);
+    ASSERT(this->multi != NULL);
+    ASSERT(!this->final);
+    ASSERT(hash != NULL);
+
+    // Append a one bit, zeroes up to the last 8 bytes of a block, and the message size in bits
+    uint64_t bitSize = this->size * 8;
+
+    this->queue[this->queueSize] = 0x80;
+    this->queueSize++;
+
+    size_t zeroSize = (SHA1_BLOCK_SIZE * 2 - sizeof(uint64_t) - this->queueSize % SHA1_BLOCK_SIZE) % SHA1_BLOCK_SIZE;
+    memset(this->queue + this->queueSize, 0, zeroSize);
+    this->queueSize += zeroSize;
+
+    for (unsigned int byteIdx = 0; byteIdx < sizeof(uint64_t); byteIdx++)
+        this->queue[this->queueSize + byteIdx] = (unsigned char)(bitSize >> (56 - byteIdx * 8));
+
+    this->queueSize += sizeof(uint64_t);
+    this->final = true;
+
+    // Hash the remaining blocks along with the blocks queued in other streams
+    cryptoHashMultiRun(this->multi);
+    ASSERT(this->queueSize == 0);
+
+    for (unsigned int wordIdx = 0; wordIdx < 5; wordIdx++)
+    {
+        hash[wordIdx * 4] = (unsigned char)(this->state[wordIdx] >> 24);
+        hash[wordIdx * 4 + 1] = (unsigned char)(this->state[wordIdx] >> 16);
+        hash[wordIdx * 4 + 2] = (unsigned char)(this->state[wordIdx] >> 8);
+        hash[wordIdx * 4 + 3] = (unsigned char)this->state[wordIdx];
+    }
+
+    FUNCTION_LOG_RETURN_VOID();
+}
+
+/***********************************************************************************************************************************
+Free the stream
+***********************************************************************************************************************************/
+void
+cryptoHashMultiStreamFree(CryptoHashMultiStream *this)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(CRYPTO_HASH_MULTI_STREAM, this);
+    FUNCTION_LOG_END();
+
+    if (this != NULL)
+        memContextFree(this->memContext);
+
+    FUNCTION_LOG_RETURN_VOID();
+}
+
+/***********************************************************************************************************************************
+Get the implementation name
+***********************************************************************************************************************************/
+const char *
+cryptoHashMultiImpl(const CryptoHashMulti *this)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(CRYPTO_HASH_MULTI, this);
+    FUNCTION_TEST_END();
+
+    ASSERT(this != NULL);
+
+    FUNCTION_TEST_RETURN(cryptoHashMultiImplLocal[this->impl].name);
+}
+
+/***********************************************************************************************************************************
+Get the number of streams hashed at once
+***********************************************************************************************************************************/
+unsigned int
+cryptoHashMultiLaneTotal(const CryptoHashMulti *this)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(CRYPTO_HASH_MULTI, this);
+    FUNCTION_TEST_END();
+
+    ASSERT(this != NULL);
+
+    FUNCTION_TEST_RETURN(cryptoHashMultiImplLocal[this->impl].laneTotal);
+}
+
+/***********************************************************************************************************************************
+Render as string for logging
+***********************************************************************************************************************************/
+String *
+cryptoHashMultiToLog(const CryptoHashMulti *this)
+{
+    return strNewFmt(
+        "{impl: %s, laneTotal: %u, streamTotal: %u}", cryptoHashMultiImplLocal[this->impl].name,
+        cryptoHashMultiImplLocal[this->impl].laneTotal, this->streamTotal);
+}
+
+/***********************************************************************************************************************************
+Free the engine
+***********************************************************************************************************************************/
+void
+cryptoHashMultiFree(CryptoHashMulti *this)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(CRYPTO_HASH_MULTI, this);
+    FUNCTION_LOG_END();
+
+    if (this != NULL)
+        memContextFree(this->memContext);
+
+    FUNCTION_LOG_RETURN_VOID();
+}
@@ -0,0 +1,69 @@
+/***********************************************************************************************************************************
+Multi-Buffer SHA-1 Hash
+
+Calculate SHA-1 hashes for multiple independent streams at once.  Each vector lane hashes a different stream, so throughput scales
+with the number of streams that have data queued, e.g. when a worker is copying several small files at the same time.  Streams are
+not created directly but through cryptoHashNewMulti(), which exposes them with the same interface as any other CryptoHash.
+
+Data written to a stream is queued until the stream's queue is full or a hash is requested, then the queued blocks of all streams
+are hashed together.  Streams that are still open when the engine is freed are detached and can then only be freed.
+***********************************************************************************************************************************/
+#ifndef CRYPTO_HASHMULTI_H
+#define CRYPTO_HASHMULTI_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/***********************************************************************************************************************************
+Object types
+***********************************************************************************************************************************/
+typedef struct CryptoHashMulti CryptoHashMulti;
+typedef struct CryptoHashMultiStream CryptoHashMultiStream;
+
+#include "common/type/string.h"
+
+/***********************************************************************************************************************************
+Constants
+***********************************************************************************************************************************/
+#define CRYPTO_HASH_MULTI_QUEUE_SIZE                                ((size_t)256 * 1024)
+
+/***********************************************************************************************************************************
+Constructor
+***********************************************************************************************************************************/
+CryptoHashMulti *cryptoHashMultiNew(void);
+
+/***********************************************************************************************************************************
+Stream functions used by CryptoHash
+***********************************************************************************************************************************/
+CryptoHashMultiStream *cryptoHashMultiStreamNew(CryptoHashMulti *this);
+void cryptoHashMultiStreamProcess(CryptoHashMultiStream *this, const unsigned char *message, size_t messageSize);
+void cryptoHashMultiStreamFinal(CryptoHashMultiStream *this, unsigned char *hash);
+void cryptoHashMultiStreamFree(CryptoHashMultiStream *this);
+
+/***********************************************************************************************************************************
+Getters
+***********************************************************************************************************************************/
+const char *cryptoHashMultiImpl(const CryptoHashMulti *this);
+unsigned int cryptoHashMultiLaneTotal(const CryptoHashMulti *this);
+
+/***********************************************************************************************************************************
+Destructor
+***********************************************************************************************************************************/
+void cryptoHashMultiFree(CryptoHashMulti *this);
+
+/***********************************************************************************************************************************
+Macros for function logging
+***********************************************************************************************************************************/
+String *cryptoHashMultiToLog(const CryptoHashMulti *this);
+
+#define FUNCTION_LOG_CRYPTO_HASH_MULTI_TYPE                                                                                        \
+    CryptoHashMulti *
+#define FUNCTION_LOG_CRYPTO_HASH_MULTI_FORMAT(value, buffer, bufferSize)                                                           \
+    FUNCTION_LOG_STRING_OBJECT_FORMAT(value, cryptoHashMultiToLog, buffer, bufferSize)
+
+#define FUNCTION_LOG_CRYPTO_HASH_MULTI_STREAM_TYPE                                                                                 \
+    CryptoHashMultiStream *
+#define FUNCTION_LOG_CRYPTO_HASH_MULTI_STREAM_FORMAT(value, buffer, bufferSize)                                                    \
+    objToLog(value, "CryptoHashMultiStream", buffer, bufferSize)
+
+#endif
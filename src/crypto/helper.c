@@ -0,0 +1,35 @@
+/***********************************************************************************************************************************
+Cipher Helper
+***********************************************************************************************************************************/
+#include "common/debug.h"
+#include "common/log.h"
+#include "crypto/cipherBlock.h"
+#include "crypto/cipherGcm.h"
+#include "crypto/helper.h"
+
+/***********************************************************************************************************************************
+Get a filter to encrypt/decrypt with the cipher type
+***********************************************************************************************************************************/
+IoFilter *
+cipherFilter(CipherMode mode, CipherType type, const Buffer *pass)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(ENUM, mode);
+        FUNCTION_LOG_PARAM(ENUM, type);
+        FUNCTION_LOG_PARAM(BUFFER, pass);
+    FUNCTION_LOG_END();
+
+    ASSERT(type != cipherTypeNone);
+    ASSERT(pass != NULL);
+
+    IoFilter *result = NULL;
+
+    // GCM chunks are processed in parallel.  Workers are only started when there is more than one chunk so small files like info
+    // files do not pay the cost of starting threads.
+    if (type == cipherTypeAes256Gcm)
+        result = cipherGcmFilter(cipherGcmNew(mode, pass, CIPHER_GCM_THREAD_TOTAL_DEFAULT, CIPHER_GCM_CHUNK_SIZE_DEFAULT));
+    else
+        result = cipherBlockFilter(cipherBlockNew(mode, type, pass, NULL));
+
+    FUNCTION_LOG_RETURN(IO_FILTER, result);
+}
@@ -0,0 +1,18 @@
+/***********************************************************************************************************************************
+Cipher Helper
+
+Abstracts the cipher types so callers can encrypt/decrypt without knowing which cipher implementation is used.
+***********************************************************************************************************************************/
+#ifndef CRYPTO_HELPER_H
+#define CRYPTO_HELPER_H
+
+#include "common/io/filter/filter.h"
+#include "common/type/buffer.h"
+#include "crypto/crypto.h"
+
+/***********************************************************************************************************************************
+Functions
+***********************************************************************************************************************************/
+IoFilter *cipherFilter(CipherMode mode, CipherType type, const Buffer *pass);
+
+#endif
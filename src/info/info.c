@@ -9,8 +9,8 @@ Info Handler
 #include "common/ini.h"
 #include "common/log.h"
 #include "common/memContext.h"
-#include "crypto/cipherBlock.h"
 #include "crypto/hash.h"
+#include "crypto/helper.h"
 #include "info/info.h"
 #include "storage/helper.h"
 #include "version.h"
@@ -20,11 +20,11 @@ Internal constants
 ***********************************************************************************************************************************/
 #define INI_COPY_EXT                                                ".copy"
 
-STRING_STATIC(INFO_SECTION_BACKREST_STR,                            "backrest");
+STRING_EXTERN(INFO_SECTION_BACKREST_STR,                            INFO_SECTION_BACKREST);
 STRING_STATIC(INFO_SECTION_CIPHER_STR,                              "cipher");
 
 STRING_STATIC(INFO_KEY_CIPHER_PASS_STR,                             "cipher-pass");
-STRING_STATIC(INFO_KEY_CHECKSUM_STR,                                "backrest-checksum");
+STRING_EXTERN(INFO_KEY_CHECKSUM_STR,                                INFO_KEY_CHECKSUM);
 STRING_EXTERN(INFO_KEY_FORMAT_STR,                                  INFO_KEY_FORMAT);
 STRING_EXTERN(INFO_KEY_VERSION_STR,                                 INFO_KEY_VERSION);
 
@@ -40,71 +40,163 @@ struct Info
 };
 
 /***********************************************************************************************************************************
-Return a hash of the contents of the info file
+Checksum object type
 ***********************************************************************************************************************************/
-static CryptoHash *
-infoHash(const Ini *ini)
+struct InfoChecksum
+{
+    MemContext *memContext;                                         // Context that contains the checksum
+    CryptoHash *hash;                                               // Hash of the info file
+    String *section;                                                // Current section
+    bool keyPrior;                                                  // Was the prior key in the section added to the hash?
+};
+
+/***********************************************************************************************************************************
+Create a new checksum
+
+The checksum is calculated over a JSON rendering of the file, i.e. {"section":{"key":value,...},...}, skipping the checksum itself.
+Since the checksum is built as the file is loaded (or saved), sections are expected to be contiguous, which is always true for files
+written by backrest.
+***********************************************************************************************************************************/
+InfoChecksum *
+infoChecksumNew(void)
+{
+    FUNCTION_TEST_VOID();
+
+    InfoChecksum *this = NULL;
+
+    MEM_CONTEXT_NEW_BEGIN("InfoChecksum")
+    {
+        this = memNew(sizeof(InfoChecksum));
+        this->memContext = MEM_CONTEXT_NEW();
+        this->hash = cryptoHashNew(HASH_TYPE_SHA1_STR);
+    }
+    MEM_CONTEXT_NEW_END();
+
+    FUNCTION_TEST_RETURN(this);
+}
+
+/***********************************************************************************************************************************
+Add a key/value to the checksum
+***********************************************************************************************************************************/
+void
+infoChecksumAdd(InfoChecksum *this, const String *section, const String *key, const String *value)
 {
     FUNCTION_TEST_BEGIN();
-        FUNCTION_TEST_PARAM(INI, ini);
+        FUNCTION_TEST_PARAM(INFO_CHECKSUM, this);
+        FUNCTION_TEST_PARAM(STRING, section);
+        FUNCTION_TEST_PARAM(STRING, key);
+        FUNCTION_TEST_PARAM(STRING, value);
     FUNCTION_TEST_END();
 
-    ASSERT(ini != NULL);
-
-    CryptoHash *result = cryptoHashNew(HASH_TYPE_SHA1_STR);
+    ASSERT(this != NULL);
+    ASSERT(section != NULL);
+    ASSERT(key != NULL);
+    ASSERT(value != NULL);
 
-    MEM_CONTEXT_TEMP_BEGIN()
+    // Start a new section, closing the prior section or opening the JSON
+    if (this->section == NULL || !strEq(section, this->section))
     {
-        StringList *sectionList = iniSectionList(ini);
+        if (this->section == NULL)
+            cryptoHashProcessC(this->hash, (const unsigned char *)"{", 1);
+        else
+            cryptoHashProcessC(this->hash, (const unsigned char *)"},", 2);
 
-        // Initial JSON opening bracket
-        cryptoHashProcessC(result, (const unsigned char *)"{", 1);
+        cryptoHashProcessC(this->hash, (const unsigned char *)"\"", 1);
+        cryptoHashProcessStr(this->hash, section);
+        cryptoHashProcessC(this->hash, (const unsigned char *)"\":{", 3);
 
-        // Loop through sections and create hash for checking checksum
-        for (unsigned int sectionIdx = 0; sectionIdx < strLstSize(sectionList); sectionIdx++)
+        MEM_CONTEXT_BEGIN(this->memContext)
         {
-            String *section = strLstGet(sectionList, sectionIdx);
+            strFree(this->section);
+            this->section = strDup(section);
+        }
+        MEM_CONTEXT_END();
 
-            // Add a comma before additional sections
-            if (sectionIdx != 0)
-                cryptoHashProcessC(result, (const unsigned char *)",", 1);
+        this->keyPrior = false;
+    }
+    // Else add a comma after the prior key.  The comma is added even when this key is the skipped checksum to match the checksum
+    // written by backrest.
+    else if (this->keyPrior)
+        cryptoHashProcessC(this->hash, (const unsigned char *)",", 1);
 
-            // Create the section header
-            cryptoHashProcessC(result, (const unsigned char *)"\"", 1);
-            cryptoHashProcessStr(result, section);
-            cryptoHashProcessC(result, (const unsigned char *)"\":{", 3);
+    // Skip the backrest checksum in the file
+    this->keyPrior = !strEq(section, INFO_SECTION_BACKREST_STR) || !strEq(key, INFO_KEY_CHECKSUM_STR);
 
-            StringList *keyList = iniSectionKeyList(ini, section);
-            unsigned int keyListSize = strLstSize(keyList);
+    if (this->keyPrior)
+    {
+        cryptoHashProcessC(this->hash, (const unsigned char *)"\"", 1);
+        cryptoHashProcessStr(this->hash, key);
+        cryptoHashProcessC(this->hash, (const unsigned char *)"\":", 2);
+        cryptoHashProcessStr(this->hash, value);
+    }
 
-            // Loop through values and build the section
-            for (unsigned int keyIdx = 0; keyIdx < keyListSize; keyIdx++)
-            {
-                String *key = strLstGet(keyList, keyIdx);
-
-                // Skip the backrest checksum in the file
-                if ((strEq(section, INFO_SECTION_BACKREST_STR) && !strEq(key, INFO_KEY_CHECKSUM_STR)) ||
-                    !strEq(section, INFO_SECTION_BACKREST_STR))
-                {
-                    cryptoHashProcessC(result, (const unsigned char *)"\"", 1);
-                    cryptoHashProcessStr(result, key);
-                    cryptoHashProcessC(result, (const unsigned char *)"\":", 2);
-                    cryptoHashProcessStr(result, varStr(iniGet(ini, section, strLstGet(keyList, keyIdx))));
-                    if ((keyListSize > 1) && (keyIdx < keyListSize - 1))
-                        cryptoHashProcessC(result, (const unsigned char *)",", 1);
-                }
-            }
+    FUNCTION_TEST_RETURN_VOID();
+}
 
-            // Close the key/value list
-            cryptoHashProcessC(result, (const unsigned char *)"}", 1);
-        }
+/***********************************************************************************************************************************
+Get the checksum as hex.  No more keys/values can be added.
+***********************************************************************************************************************************/
+String *
+infoChecksumHex(InfoChecksum *this)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(INFO_CHECKSUM, this);
+    FUNCTION_TEST_END();
 
-        // JSON closing bracket
-        cryptoHashProcessC(result, (const unsigned char *)"}", 1);
-    }
-    MEM_CONTEXT_TEMP_END();
+    ASSERT(this != NULL);
+
+    // Close the last section and the JSON
+    if (this->section == NULL)
+        cryptoHashProcessC(this->hash, (const unsigned char *)"{}", 2);
+    else
+        cryptoHashProcessC(this->hash, (const unsigned char *)"}}", 2);
+
+    FUNCTION_TEST_RETURN(bufHex(cryptoHash(this->hash)));
+}
+
+/***********************************************************************************************************************************
+Free the checksum
+***********************************************************************************************************************************/
+void
+infoChecksumFree(InfoChecksum *this)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(INFO_CHECKSUM, this);
+    FUNCTION_TEST_END();
+
+    if (this != NULL)
+        memContextFree(this->memContext);
+
+    FUNCTION_TEST_RETURN_VOID();
+}
 
-    FUNCTION_TEST_RETURN(result);
+/***********************************************************************************************************************************
+Store each key/value loaded by infoLoad() and add it to the checksum
+***********************************************************************************************************************************/
+typedef struct InfoLoadData
+{
+    Ini *ini;                                                       // Ini to store keys/values in
+    InfoChecksum *checksum;                                         // Checksum of the info file
+} InfoLoadData;
+
+static void
+infoLoadCallback(void *data, const String *section, const String *key, const String *value)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM_P(VOID, data);
+        FUNCTION_TEST_PARAM(STRING, section);
+        FUNCTION_TEST_PARAM(STRING, key);
+        FUNCTION_TEST_PARAM(STRING, value);
+    FUNCTION_TEST_END();
+
+    ASSERT(data != NULL);
+
+    InfoLoadData *loadData = (InfoLoadData *)data;
+
+    iniSet(loadData->ini, section, key, varNewStr(value));
+    infoChecksumAdd(loadData->checksum, section, key, value);
+
+    FUNCTION_TEST_RETURN_VOID();
 }
 
 /***********************************************************************************************************************************
@@ -125,6 +217,14 @@ infoLoad(Info *this, const Storage *storage, bool copyFile, CipherType cipherTyp
 
     bool result = false;
 
+    // Start with an empty ini in case a prior load failed part way through
+    MEM_CONTEXT_BEGIN(this->memContext)
+    {
+        iniFree(this->ini);
+        this->ini = iniNew();
+    }
+    MEM_CONTEXT_END();
+
     MEM_CONTEXT_TEMP_BEGIN()
     {
         String *fileName = copyFile ? strCat(strDup(this->fileName), INI_COPY_EXT) : this->fileName;
@@ -136,17 +236,15 @@ infoLoad(Info *this, const Storage *storage, bool copyFile, CipherType cipherTyp
         {
             ioReadFilterGroupSet(
                 storageFileReadIo(infoRead),
-                ioFilterGroupAdd(
-                    ioFilterGroupNew(), cipherBlockFilter(cipherBlockNew(cipherModeDecrypt, cipherType, bufNewStr(cipherPass),
-                    NULL))));
+                ioFilterGroupAdd(ioFilterGroupNew(), cipherFilter(cipherModeDecrypt, cipherType, bufNewStr(cipherPass))));
         }
 
-        // Load and parse the info file
-        Buffer *buffer = NULL;
+        // Load the info file and calculate the checksum as it is loaded
+        InfoLoadData loadData = {.ini = this->ini, .checksum = infoChecksumNew()};
 
         TRY_BEGIN()
         {
-            buffer = storageGetNP(infoRead);
+            iniLoad(storageFileReadIo(infoRead), infoLoadCallback, &loadData);
         }
         CATCH(CryptoError)
         {
@@ -156,22 +254,19 @@ infoLoad(Info *this, const Storage *storage, bool copyFile, CipherType cipherTyp
         }
         TRY_END();
 
-        iniParse(this->ini, strNewBuf(buffer));
-
         // Make sure the ini is valid by testing the checksum
+        String *checksum = infoChecksumHex(loadData.checksum);
         String *infoChecksum = varStr(iniGet(this->ini, INFO_SECTION_BACKREST_STR, INFO_KEY_CHECKSUM_STR));
 
-        CryptoHash *hash = infoHash(this->ini);
-
         // ??? Temporary hack until get json parser: add quotes around hash before comparing
-        if (!strEq(infoChecksum, strQuoteZ(bufHex(cryptoHash(hash)), "\"")))
+        if (!strEq(infoChecksum, strQuoteZ(checksum, "\"")))
         {
             // Is the checksum present?
             bool checksumMissing = strSize(infoChecksum) < 3;
 
             THROW_FMT(
                 ChecksumError, "invalid checksum in '%s', expected '%s' but %s%s%s", strPtr(storagePathNP(storage, fileName)),
-                strPtr(bufHex(cryptoHash(hash))), checksumMissing ? "no checksum found" : "found '",
+                strPtr(checksum), checksumMissing ? "no checksum found" : "found '",
                 // ??? Temporary hack until get json parser: remove quotes around hash before displaying in messsage
                 checksumMissing ? "" : strPtr(strSubN(infoChecksum, 1, strSize(infoChecksum) - 2)),
                 checksumMissing ? "" : "'");
@@ -216,7 +311,6 @@ infoNew(const Storage *storage, const String *fileName, CipherType cipherType, c
         this = memNew(sizeof(Info));
         this->memContext = MEM_CONTEXT_NEW();
 
-        this->ini = iniNew();
         this->fileName = strDup(fileName);
 
         // Attempt to load the primary file
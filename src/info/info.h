@@ -8,6 +8,7 @@ Info Handler
 Object type
 ***********************************************************************************************************************************/
 typedef struct Info Info;
+typedef struct InfoChecksum InfoChecksum;
 
 #include "common/ini.h"
 #include "crypto/crypto.h"
@@ -17,6 +18,11 @@ typedef struct Info Info;
 /***********************************************************************************************************************************
 Constants
 ***********************************************************************************************************************************/
+#define INFO_SECTION_BACKREST                                       "backrest"
+    STRING_DECLARE(INFO_SECTION_BACKREST_STR);
+
+#define INFO_KEY_CHECKSUM                                           "backrest-checksum"
+    STRING_DECLARE(INFO_KEY_CHECKSUM_STR);
 #define INFO_KEY_FORMAT                                             "backrest-format"
     STRING_DECLARE(INFO_KEY_VERSION_STR);
 #define INFO_KEY_VERSION                                            "backrest-version"
@@ -27,6 +33,14 @@ Constructor
 ***********************************************************************************************************************************/
 Info *infoNew(const Storage *storage, const String *fileName, CipherType cipherType, const String *cipherPass);
 
+/***********************************************************************************************************************************
+Checksum of the keys/values in an info file, calculated as the file is loaded or saved
+***********************************************************************************************************************************/
+InfoChecksum *infoChecksumNew(void);
+void infoChecksumAdd(InfoChecksum *this, const String *section, const String *key, const String *value);
+String *infoChecksumHex(InfoChecksum *this);
+void infoChecksumFree(InfoChecksum *this);
+
 /***********************************************************************************************************************************
 Getters
 ***********************************************************************************************************************************/
@@ -47,4 +61,9 @@ Macros for function logging
 #define FUNCTION_LOG_INFO_FORMAT(value, buffer, bufferSize)                                                                        \
     objToLog(value, "Info", buffer, bufferSize)
 
+#define FUNCTION_LOG_INFO_CHECKSUM_TYPE                                                                                            \
+    InfoChecksum *
+#define FUNCTION_LOG_INFO_CHECKSUM_FORMAT(value, buffer, bufferSize)                                                               \
+    objToLog(value, "InfoChecksum", buffer, bufferSize)
+
 #endif
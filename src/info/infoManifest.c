@@ -1,8 +1,27 @@
 /***********************************************************************************************************************************
 Manifest Info Handler
 ***********************************************************************************************************************************/
+#include <grp.h>
+#include <inttypes.h>
+#include <limits.h>
+#include <pwd.h>
+#include <string.h>
+
+#include "common/debug.h"
+#include "common/io/io.h"
+#include "common/log.h"
+#include "common/memContext.h"
+#include "common/regExp.h"
+#include "common/type/json.h"
+#include "common/type/list.h"
 #include "common/type/string.h"
+#include "crypto/hash.h"
+#include "info/info.h"
 #include "info/infoManifest.h"
+#include "info/infoManifestSidecar.h"
+#include "postgres/interface.h"
+#include "postgres/version.h"
+#include "version.h"
 
 /***********************************************************************************************************************************
 Constants
@@ -18,5 +37,2456 @@ STRING_EXTERN(INFO_MANIFEST_KEY_OPT_ARCHIVE_COPY_STR,               INFO_MANIFES
 STRING_EXTERN(INFO_MANIFEST_KEY_OPT_BACKUP_STANDBY_STR,             INFO_MANIFEST_KEY_OPT_BACKUP_STANDBY);
 STRING_EXTERN(INFO_MANIFEST_KEY_OPT_CHECKSUM_PAGE_STR,              INFO_MANIFEST_KEY_OPT_CHECKSUM_PAGE);
 STRING_EXTERN(INFO_MANIFEST_KEY_OPT_COMPRESS_STR,                   INFO_MANIFEST_KEY_OPT_COMPRESS);
+STRING_EXTERN(INFO_MANIFEST_KEY_OPT_COMPRESS_TYPE_STR,              INFO_MANIFEST_KEY_OPT_COMPRESS_TYPE);
 STRING_EXTERN(INFO_MANIFEST_KEY_OPT_HARDLINK_STR,                   INFO_MANIFEST_KEY_OPT_HARDLINK);
 STRING_EXTERN(INFO_MANIFEST_KEY_OPT_ONLINE_STR,                     INFO_MANIFEST_KEY_OPT_ONLINE);
+
+STRING_EXTERN(INFO_MANIFEST_SECTION_BACKUP_TARGET_STR,              INFO_MANIFEST_SECTION_BACKUP_TARGET);
+STRING_EXTERN(INFO_MANIFEST_SECTION_TARGET_FILE_STR,                INFO_MANIFEST_SECTION_TARGET_FILE);
+STRING_EXTERN(INFO_MANIFEST_SECTION_TARGET_LINK_STR,                INFO_MANIFEST_SECTION_TARGET_LINK);
+STRING_EXTERN(INFO_MANIFEST_SECTION_TARGET_PATH_STR,                INFO_MANIFEST_SECTION_TARGET_PATH);
+
+STRING_EXTERN(INFO_MANIFEST_SUBKEY_CHECKSUM_STR,                    INFO_MANIFEST_SUBKEY_CHECKSUM);
+STRING_EXTERN(INFO_MANIFEST_SUBKEY_DESTINATION_STR,                 INFO_MANIFEST_SUBKEY_DESTINATION);
+STRING_EXTERN(INFO_MANIFEST_SUBKEY_FILE_STR,                        INFO_MANIFEST_SUBKEY_FILE);
+STRING_EXTERN(INFO_MANIFEST_SUBKEY_GROUP_STR,                       INFO_MANIFEST_SUBKEY_GROUP);
+STRING_EXTERN(INFO_MANIFEST_SUBKEY_MASTER_STR,                      INFO_MANIFEST_SUBKEY_MASTER);
+STRING_EXTERN(INFO_MANIFEST_SUBKEY_MODE_STR,                        INFO_MANIFEST_SUBKEY_MODE);
+STRING_EXTERN(INFO_MANIFEST_SUBKEY_PATH_STR,                        INFO_MANIFEST_SUBKEY_PATH);
+STRING_EXTERN(INFO_MANIFEST_SUBKEY_REFERENCE_STR,                   INFO_MANIFEST_SUBKEY_REFERENCE);
+STRING_EXTERN(INFO_MANIFEST_SUBKEY_SIZE_STR,                        INFO_MANIFEST_SUBKEY_SIZE);
+STRING_EXTERN(INFO_MANIFEST_SUBKEY_TABLESPACE_ID_STR,               INFO_MANIFEST_SUBKEY_TABLESPACE_ID);
+STRING_EXTERN(INFO_MANIFEST_SUBKEY_TABLESPACE_NAME_STR,             INFO_MANIFEST_SUBKEY_TABLESPACE_NAME);
+STRING_EXTERN(INFO_MANIFEST_SUBKEY_TIMESTAMP_STR,                   INFO_MANIFEST_SUBKEY_TIMESTAMP);
+STRING_EXTERN(INFO_MANIFEST_SUBKEY_TYPE_STR,                        INFO_MANIFEST_SUBKEY_TYPE);
+STRING_EXTERN(INFO_MANIFEST_SUBKEY_USER_STR,                        INFO_MANIFEST_SUBKEY_USER);
+
+STRING_EXTERN(INFO_MANIFEST_TARGET_PGDATA_STR,                      INFO_MANIFEST_TARGET_PGDATA);
+STRING_EXTERN(INFO_MANIFEST_TARGET_PGTBLSPC_STR,                    INFO_MANIFEST_TARGET_PGTBLSPC);
+
+STRING_EXTERN(INFO_MANIFEST_VALUE_LINK_STR,                         INFO_MANIFEST_VALUE_LINK);
+STRING_EXTERN(INFO_MANIFEST_VALUE_PATH_STR,                         INFO_MANIFEST_VALUE_PATH);
+
+/***********************************************************************************************************************************
+Internal constants
+***********************************************************************************************************************************/
+#define INFO_MANIFEST_BUILD_DEPTH_MAX                               16
+
+STRING_STATIC(INFO_MANIFEST_DOT_STR,                                ".");
+STRING_STATIC(INFO_MANIFEST_JSON_FALSE_STR,                         "false");
+STRING_STATIC(INFO_MANIFEST_JSON_TRUE_STR,                          "true");
+
+#define INFO_MANIFEST_FILE_PGCONTROL                                                                                               \
+    INFO_MANIFEST_TARGET_PGDATA "/" PG_PATH_GLOBAL "/" PG_FILE_PGCONTROL
+    STRING_STATIC(INFO_MANIFEST_FILE_PGCONTROL_STR,                 INFO_MANIFEST_FILE_PGCONTROL);
+
+/***********************************************************************************************************************************
+Paths whose contents are not copied because they are reset or cannot be reused on recovery, e.g. pg_subtrans
+***********************************************************************************************************************************/
+static const struct
+{
+    const char *path;                                               // Path prefix (pg_data/<path>/)
+    unsigned int version;                                           // Minimum PostgreSQL version the path is skipped for
+} infoManifestBuildSkipPath[] =
+{
+    {.path = INFO_MANIFEST_TARGET_PGDATA "/" PG_PATH_PGDYNSHMEM "/", .version = PG_VERSION_94},
+    {.path = INFO_MANIFEST_TARGET_PGDATA "/" PG_PATH_PGNOTIFY "/", .version = PG_VERSION_90},
+    {.path = INFO_MANIFEST_TARGET_PGDATA "/" PG_PATH_PGREPLSLOT "/", .version = PG_VERSION_94},
+    {.path = INFO_MANIFEST_TARGET_PGDATA "/" PG_PATH_PGSERIAL "/", .version = PG_VERSION_91},
+    {.path = INFO_MANIFEST_TARGET_PGDATA "/" PG_PATH_PGSNAPSHOTS "/", .version = PG_VERSION_92},
+    {.path = INFO_MANIFEST_TARGET_PGDATA "/" PG_PATH_PGSTATTMP "/", .version = PG_VERSION_84},
+    {.path = INFO_MANIFEST_TARGET_PGDATA "/" PG_PATH_PGSUBTRANS "/", .version = 0},
+};
+
+/***********************************************************************************************************************************
+Files in the root of pg_data that are never copied
+***********************************************************************************************************************************/
+static const char *infoManifestBuildSkipFile[] =
+{
+    INFO_MANIFEST_TARGET_PGDATA "/" PG_FILE_POSTGRESQLAUTOCONFTMP,  // Temp file for safe writes
+    INFO_MANIFEST_TARGET_PGDATA "/" PG_FILE_BACKUPLABELOLD,         // Old backup labels are not useful
+    INFO_MANIFEST_TARGET_PGDATA "/" PG_FILE_POSTMASTEROPTS,         // Not useful for backup
+    INFO_MANIFEST_TARGET_PGDATA "/" PG_FILE_POSTMASTERPID,          // Would confuse postgres after restore
+    INFO_MANIFEST_TARGET_PGDATA "/" PG_FILE_RECOVERYCONF,           // Doesn't make sense to backup this file
+    INFO_MANIFEST_TARGET_PGDATA "/" PG_FILE_RECOVERYDONE,           // Doesn't make sense to backup this file
+};
+
+/***********************************************************************************************************************************
+Manifest build types
+
+Entries are stored in a flat list rather than in an Ini because building an Ini requires a key search per insert.  User, group, and
+mode values are cached (already rendered as JSON) since they are shared by nearly every entry.  This also means they can be compared
+by pointer when calculating defaults.
+***********************************************************************************************************************************/
+typedef enum
+{
+    infoManifestBuildCacheUser,
+    infoManifestBuildCacheGroup,
+    infoManifestBuildCacheMode,
+} InfoManifestBuildCacheType;
+
+typedef struct InfoManifestBuildCache
+{
+    InfoManifestBuildCacheType type;                                // Type of value cached
+    unsigned int id;                                                // User/group id or mode
+    const String *value;                                            // Value rendered as JSON (NULL if the id has no name)
+} InfoManifestBuildCache;
+
+typedef struct InfoManifestBuildEntry
+{
+    const String *name;                                             // Manifest name, e.g. pg_data/base/1/1000
+    StorageType type;                                               // Type file/path/link
+    const String *user;                                             // User (NULL if the user has no name)
+    const String *group;                                            // Group (NULL if the group has no name)
+    const String *mode;                                             // Mode (file/path only)
+    bool master;                                                    // Must the file be copied from the master?
+    uint64_t size;                                                  // Size (file only)
+    time_t timestamp;                                               // Modification time (file only)
+    const String *destination;                                      // Destination rendered as JSON (link only)
+} InfoManifestBuildEntry;
+
+typedef struct InfoManifestBuild
+{
+    MemContext *memContext;                                         // Context for entries
+    const Storage *storage;                                         // Storage to build the manifest from
+    unsigned int pgVersion;                                         // PostgreSQL version
+    bool online;                                                    // Is the backup online?
+    const KeyValue *tablespaceMap;                                  // Tablespace names by oid
+    StringList *excludeList;                                        // User exclusions (sorted)
+    const String *tablespacePath;                                   // Top-level tablespace path, e.g. PG_9.4_201409291
+    String *walPath;                                                // WAL path prefix, e.g. pg_data/pg_wal/
+    String *walArchiveStatusPath;                                   // WAL archive status path (not skipped when online)
+    RegExp *tempExp;                                                // Match pgsql_tmp paths/files
+    RegExp *dbPathExp;                                              // Match database paths in base or a tablespace
+    RegExp *relationTempExp;                                        // Match temp relations
+    RegExp *relationExp;                                            // Match relations (to check for unlogged relations)
+    RegExp *masterExp;                                              // Match files that can be copied from a standby
+    KeyValue *targetKv;                                             // Backup targets
+    List *cacheList;                                                // Cached user/group/mode values
+    List *entryList;                                                // Files, paths, and links
+    List *levelList;                                                // Levels to build (pg_data and link destinations)
+    bool pgDataFound;                                               // Has the pg_data path been added?
+    InfoManifestBuildEntry pgData;                                  // The pg_data path (copied to create the pg_tblspc path)
+    bool tablespaceFound;                                           // Has a tablespace been added?
+} InfoManifestBuild;
+
+typedef struct InfoManifestBuildLevel
+{
+    const String *name;                                             // Name of the level, e.g. pg_data or pg_tblspc/16384
+    const String *path;                                             // Path to the level (absolute once the level is built)
+    const String *parentPath;                                       // Path containing the link (to make a relative path absolute)
+    const String *filter;                                           // Only include this entry in the top path (when not NULL)
+    bool tablespace;                                                // Is the level a tablespace?
+    unsigned int depth;                                             // Number of links followed to reach the level
+} InfoManifestBuildLevel;
+
+typedef struct InfoManifestBuildDirEntry
+{
+    const String *name;                                             // Name of the entry in the directory
+    StorageInfo info;                                               // Info for the entry
+} InfoManifestBuildDirEntry;
+
+typedef struct InfoManifestBuildDir
+{
+    const String *filter;                                           // Only include this entry (when not NULL)
+    List *entryList;                                                // Entries in the directory
+    StringList *initList;                                           // Init forks in the directory
+} InfoManifestBuildDir;
+
+/***********************************************************************************************************************************
+Make a path absolute using a base path.  Relative paths may only go up using leading .. since that is the way link destinations are
+generally written.
+***********************************************************************************************************************************/
+static String *
+infoManifestPathAbsolute(const String *basePath, const String *path)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(STRING, basePath);
+        FUNCTION_TEST_PARAM(STRING, path);
+    FUNCTION_TEST_END();
+
+    ASSERT(basePath != NULL);
+    ASSERT(path != NULL);
+
+    String *result = NULL;
+
+    // If the path is already absolute
+    if (strBeginsWithZ(path, "/"))
+        result = strDup(path);
+    // Else make it absolute using the base path
+    else
+    {
+        // Make sure the base path is really absolute
+        if (!strBeginsWithZ(basePath, "/") || strstr(strPtr(basePath), "/..") != NULL)
+            THROW_FMT(PathTypeError, "%s is not an absolute path", strPtr(basePath));
+
+        MEM_CONTEXT_TEMP_BEGIN()
+        {
+            String *basePathAbsolute = strDup(basePath);
+            String *pathRelative = strDup(path);
+
+            while (strBeginsWithZ(pathRelative, ".."))
+            {
+                basePathAbsolute = strPath(basePathAbsolute);
+                pathRelative = strSub(pathRelative, 2);
+
+                if (strBeginsWithZ(pathRelative, "/"))
+                    pathRelative = strSub(pathRelative, 1);
+            }
+
+            memContextSwitch(MEM_CONTEXT_OLD());
+            result = strNewFmt(
+                "%s/%s", strEqZ(basePathAbsolute, "/") ? "" : strPtr(basePathAbsolute), strPtr(pathRelative));
+            memContextSwitch(MEM_CONTEXT_TEMP());
+        }
+        MEM_CONTEXT_TEMP_END();
+    }
+
+    // Make sure the result is really an absolute path
+    if (!strBeginsWithZ(result, "/") || strstr(strPtr(result), "/..") != NULL)
+        THROW_FMT(PathTypeError, "result %s was not an absolute path", strPtr(result));
+
+    FUNCTION_TEST_RETURN(result);
+}
+
+/***********************************************************************************************************************************
+Get a cached user/group/mode value rendered as JSON
+***********************************************************************************************************************************/
+static const String *
+infoManifestBuildCacheGet(InfoManifestBuild *build, InfoManifestBuildCacheType type, unsigned int id)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM_P(VOID, build);
+        FUNCTION_TEST_PARAM(ENUM, type);
+        FUNCTION_TEST_PARAM(UINT, id);
+    FUNCTION_TEST_END();
+
+    ASSERT(build != NULL);
+
+    // Search the cache first since there are generally only a few distinct values
+    for (unsigned int cacheIdx = 0; cacheIdx < lstSize(build->cacheList); cacheIdx++)
+    {
+        InfoManifestBuildCache *cache = lstGet(build->cacheList, cacheIdx);
+
+        if (cache->type == type && cache->id == id)
+            FUNCTION_TEST_RETURN(cache->value);
+    }
+
+    // Else get the value and add it to the cache
+    InfoManifestBuildCache cache = {.type = type, .id = id};
+
+    MEM_CONTEXT_BEGIN(build->memContext)
+    {
+        switch (type)
+        {
+            case infoManifestBuildCacheUser:
+            {
+                struct passwd *userData = getpwuid((uid_t)id);
+
+                if (userData != NULL)
+                    cache.value = varToJsonInfo(varNewStrZ(userData->pw_name));
+
+                break;
+            }
+
+            case infoManifestBuildCacheGroup:
+            {
+                struct group *groupData = getgrgid((gid_t)id);
+
+                if (groupData != NULL)
+                    cache.value = varToJsonInfo(varNewStrZ(groupData->gr_name));
+
+                break;
+            }
+
+            case infoManifestBuildCacheMode:
+            {
+                cache.value = strNewFmt("\"%04o\"", id);
+                break;
+            }
+        }
+
+        lstAdd(build->cacheList, &cache);
+    }
+    MEM_CONTEXT_END();
+
+    FUNCTION_TEST_RETURN(cache.value);
+}
+
+/***********************************************************************************************************************************
+Add an entry for each item in a directory
+***********************************************************************************************************************************/
+static void
+infoManifestBuildDirCallback(void *callbackData, const String *name, StorageInfo info)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM_P(VOID, callbackData);
+        FUNCTION_TEST_PARAM(STRING, name);
+        FUNCTION_TEST_PARAM(STORAGE_INFO, info);
+    FUNCTION_TEST_END();
+
+    ASSERT(callbackData != NULL);
+    ASSERT(name != NULL);
+
+    InfoManifestBuildDir *dir = (InfoManifestBuildDir *)callbackData;
+
+    // Skip everything but the filter if specified
+    if (dir->filter == NULL || strEq(name, dir->filter))
+    {
+        // Name and link destination are only valid for the duration of the callback so copy them to the directory context
+        MemContext *memContextOld = memContextSwitch(lstMemContext(dir->entryList));
+
+        InfoManifestBuildDirEntry entry = {.name = strDup(name), .info = info};
+
+        if (info.linkDestination != NULL)
+            entry.info.linkDestination = strDup(info.linkDestination);
+
+        lstAdd(dir->entryList, &entry);
+
+        // Init forks are needed to determine which relations are unlogged
+        if (info.type == storageTypeFile && strEndsWithZ(name, "_init"))
+            strLstAdd(dir->initList, name);
+
+        memContextSwitch(memContextOld);
+    }
+
+    FUNCTION_TEST_RETURN_VOID();
+}
+
+/***********************************************************************************************************************************
+Add a level to be built.  Levels are built in the order they are added rather than recursively so following links does not nest
+memory contexts (and error handlers) for each link.
+***********************************************************************************************************************************/
+static void
+infoManifestBuildLevelAdd(
+    InfoManifestBuild *build, const String *name, const String *path, const String *parentPath, const String *filter,
+    bool tablespace, unsigned int depth)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM_P(VOID, build);
+        FUNCTION_TEST_PARAM(STRING, name);
+        FUNCTION_TEST_PARAM(STRING, path);
+        FUNCTION_TEST_PARAM(STRING, parentPath);
+        FUNCTION_TEST_PARAM(STRING, filter);
+        FUNCTION_TEST_PARAM(BOOL, tablespace);
+        FUNCTION_TEST_PARAM(UINT, depth);
+    FUNCTION_TEST_END();
+
+    ASSERT(build != NULL);
+    ASSERT(name != NULL);
+    ASSERT(path != NULL);
+
+    // Limit link depth to something reasonable (if more then we are very likely in a link loop)
+    if (depth >= INFO_MANIFEST_BUILD_DEPTH_MAX)
+    {
+        THROW_FMT(
+            FormatError, "recursion in manifest build exceeds depth of %u: %s\nHINT: is there a link loop in $PGDATA?", depth,
+            strPtr(name));
+    }
+
+    MEM_CONTEXT_BEGIN(build->memContext)
+    {
+        InfoManifestBuildLevel level =
+        {
+            .name = strDup(name),
+            .path = strDup(path),
+            .parentPath = strDup(parentPath),
+            .filter = filter,
+            .tablespace = tablespace,
+            .depth = depth,
+        };
+
+        lstAdd(build->levelList, &level);
+    }
+    MEM_CONTEXT_END();
+
+    FUNCTION_TEST_RETURN_VOID();
+}
+
+/***********************************************************************************************************************************
+Process a single file/path/link.  Returns true when the entry is a path that should be descended into.
+***********************************************************************************************************************************/
+static bool
+infoManifestBuildEntry(
+    InfoManifestBuild *build, const InfoManifestBuildLevel *level, const String *name, const String *file, const StorageInfo *info,
+    const StringList *initList)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM_P(VOID, build);
+        FUNCTION_TEST_PARAM_P(VOID, level);
+        FUNCTION_TEST_PARAM(STRING, name);
+        FUNCTION_TEST_PARAM(STRING, file);
+        FUNCTION_TEST_PARAM_P(STORAGE_INFO, info);
+        FUNCTION_TEST_PARAM(STRING_LIST, initList);
+    FUNCTION_TEST_END();
+
+    ASSERT(build != NULL);
+    ASSERT(level != NULL);
+    ASSERT(name != NULL);
+    ASSERT(file != NULL);
+    ASSERT(info != NULL);
+
+    // Skip the wal directory when doing an online backup.  WAL will be restored from the archive or stored in the wal directory at
+    // the end of the backup if the archive-copy option is set.
+    if (build->online && strBeginsWith(file, build->walPath) && !strEq(file, build->walArchiveStatusPath))
+        FUNCTION_TEST_RETURN(false);
+
+    // Skip all directories and files that start with pgsql_tmp.  The files are removed when the server is restarted and the
+    // directories are recreated.
+    if (regExpMatch(build->tempExp, name))
+        FUNCTION_TEST_RETURN(false);
+
+    // Skip the contents of paths that are reset or cannot be reused on recovery
+    for (unsigned int skipIdx = 0; skipIdx < sizeof(infoManifestBuildSkipPath) / sizeof(infoManifestBuildSkipPath[0]); skipIdx++)
+    {
+        if (build->pgVersion >= infoManifestBuildSkipPath[skipIdx].version &&
+            strBeginsWithZ(file, infoManifestBuildSkipPath[skipIdx].path))
+        {
+            FUNCTION_TEST_RETURN(false);
+        }
+    }
+
+    // Skip pg_internal.init since it is recreated on startup
+    if (strEndsWithZ(file, PG_FILE_PGINTERNALINIT))
+        FUNCTION_TEST_RETURN(false);
+
+    // Skip ignored files
+    for (unsigned int skipIdx = 0; skipIdx < sizeof(infoManifestBuildSkipFile) / sizeof(infoManifestBuildSkipFile[0]); skipIdx++)
+    {
+        if (strEqZ(file, infoManifestBuildSkipFile[skipIdx]))
+            FUNCTION_TEST_RETURN(false);
+    }
+
+    bool result = false;
+
+    MEM_CONTEXT_TEMP_BEGIN()
+    {
+        bool skip = false;
+
+        // If version is at least 9.0 then check for relation files to skip in database paths (base or tablespace)
+        if (build->pgVersion >= PG_VERSION_90 && info->type == storageTypeFile && regExpMatch(build->dbPathExp, strPath(name)))
+        {
+            String *baseName = strBase(name);
+
+            // Skip temp relations (lower t followed by numbers underscore numbers and a dot (segment) or underscore (fork) and/or
+            // segment, e.g. t1234_123, t1234_123.1, t1234_123_vm, t1234_123_fsm.1
+            if (regExpMatch(build->relationTempExp, baseName))
+                skip = true;
+            // Exclude all forks for unlogged relations except the init fork (numbers underscore init and optional dot segment)
+            else if (build->pgVersion >= PG_VERSION_91 && regExpMatch(build->relationExp, baseName))
+            {
+                String *initFork = strNewFmt(
+                    "%s_init", strPtr(strSubN(baseName, 0, strspn(strPtr(baseName), "0123456789"))));
+
+                skip = strLstExists(initList, initFork);
+            }
+        }
+
+        // Make sure pg_tblspc contains only absolute links that do not point inside PGDATA
+        bool tablespace = false;
+
+        if (!skip && strEq(level->name, INFO_MANIFEST_TARGET_PGDATA_STR) && strBeginsWithZ(name, PG_PATH_PGTBLSPC "/"))
+        {
+            tablespace = true;
+
+            // Check for files in pg_tblspc that are not links
+            if (info->type != storageTypeLink)
+            {
+                THROW_FMT(
+                    LinkExpectedError, "%s is not a symlink - " PG_PATH_PGTBLSPC " should contain only symlinks", strPtr(name));
+            }
+
+            // Check for tablespaces in PGDATA
+            String *pathPrefix = strNewFmt("%s/", strPtr(level->path));
+
+            if (strBeginsWith(info->linkDestination, pathPrefix) ||
+                (!strBeginsWithZ(info->linkDestination, "/") &&
+                 strBeginsWith(
+                    strCatChr(
+                        infoManifestPathAbsolute(
+                            strNewFmt("%s/" PG_PATH_PGTBLSPC, strPtr(level->path)), info->linkDestination), '/'),
+                    pathPrefix)))
+            {
+                THROW_FMT(
+                    TablespaceInPgdataError, "tablespace symlink %s destination must not be in $PGDATA",
+                    strPtr(info->linkDestination));
+            }
+        }
+
+        // Exclude files requested by the user
+        if (!skip && build->excludeList != NULL)
+        {
+            // Exclusions are based on the name of the file relative to PGDATA
+            const String *pgFile = strBeginsWithZ(file, INFO_MANIFEST_TARGET_PGDATA "/") ?
+                strSub(file, sizeof(INFO_MANIFEST_TARGET_PGDATA)) : file;
+
+            for (unsigned int excludeIdx = 0; excludeIdx < strLstSize(build->excludeList); excludeIdx++)
+            {
+                const String *exclude = strLstGet(build->excludeList, excludeIdx);
+
+                // If the exclusion ends in / then we must do a prefix match, else an exact match or a prefix match with / appended
+                // is required
+                if (strEndsWithZ(exclude, "/") ?
+                        strBeginsWith(pgFile, exclude) :
+                        strEq(pgFile, exclude) || strBeginsWith(pgFile, strNewFmt("%s/", strPtr(exclude))))
+                {
+                    // Log everything that gets excluded at a high level so it will hopefully be seen if wrong
+                    LOG_INFO("exclude %s from backup using '%s' exclusion", strPtr(pgFile), strPtr(exclude));
+
+                    skip = true;
+                    break;
+                }
+            }
+        }
+
+        if (!skip)
+        {
+            // Add the entry
+            InfoManifestBuildEntry entry =
+            {
+                .type = info->type,
+                .user = infoManifestBuildCacheGet(build, infoManifestBuildCacheUser, info->userId),
+                .group = infoManifestBuildCacheGet(build, infoManifestBuildCacheGroup, info->groupId),
+            };
+
+            if (info->type != storageTypeLink)
+                entry.mode = infoManifestBuildCacheGet(build, infoManifestBuildCacheMode, info->mode);
+
+            if (info->type == storageTypeFile)
+            {
+                entry.size = info->size;
+                entry.timestamp = info->timeModified;
+                entry.master = strEq(file, INFO_MANIFEST_FILE_PGCONTROL_STR) || !regExpMatch(build->masterExp, file);
+            }
+
+            memContextSwitch(build->memContext);
+
+            entry.name = strDup(file);
+
+            if (info->type == storageTypeLink)
+                entry.destination = varToJsonInfo(varNewStr(info->linkDestination));
+
+            lstAdd(build->entryList, &entry);
+
+            memContextSwitch(MEM_CONTEXT_TEMP());
+
+            // Store the pg_data path so it can be copied to the pg_tblspc path
+            if (strEq(file, INFO_MANIFEST_TARGET_PGDATA_STR))
+            {
+                build->pgDataFound = true;
+                build->pgData = entry;
+            }
+
+            // Descend into paths
+            if (info->type == storageTypePath)
+                result = true;
+            // Add the link destination as a new level
+            else if (info->type == storageTypeLink)
+            {
+                const String *linkLevel = file;
+                const String *linkFilter = NULL;
+
+                if (tablespace)
+                {
+                    // Only versions >= 9.0 have the special top-level tablespace path.  Below 9.0 the database files are stored
+                    // directly in the path referenced by the symlink.
+                    if (build->pgVersion >= PG_VERSION_90)
+                        linkFilter = build->tablespacePath;
+
+                    // Add the pg_tblspc path using the pg_data path settings
+                    if (!build->tablespaceFound)
+                    {
+                        ASSERT(build->pgDataFound);
+
+                        InfoManifestBuildEntry tablespaceEntry = build->pgData;
+                        tablespaceEntry.name = INFO_MANIFEST_TARGET_PGTBLSPC_STR;
+
+                        lstAdd(build->entryList, &tablespaceEntry);
+                        build->tablespaceFound = true;
+                    }
+
+                    // PGDATA prefix was only needed for the link so strip it off before building the level
+                    linkLevel = strSub(file, sizeof(INFO_MANIFEST_TARGET_PGDATA));
+                }
+
+                infoManifestBuildLevelAdd(
+                    build, linkLevel, info->linkDestination, strPath(strNewFmt("%s/%s", strPtr(level->path), strPtr(name))),
+                    linkFilter, tablespace, level->depth + 1);
+            }
+        }
+    }
+    MEM_CONTEXT_TEMP_END();
+
+    FUNCTION_TEST_RETURN(result);
+}
+
+/***********************************************************************************************************************************
+Build a level of the manifest, i.e. pg_data or a link destination
+
+Paths are walked breadth first using a queue of pending paths.  Each directory is read exactly once and entries are stat'd as they
+are read.  Paths that are skipped are not descended into.
+***********************************************************************************************************************************/
+static void
+infoManifestBuildLevel(InfoManifestBuild *build, const InfoManifestBuildLevel *levelPending)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM_P(VOID, build);
+        FUNCTION_TEST_PARAM_P(VOID, levelPending);
+    FUNCTION_TEST_END();
+
+    ASSERT(build != NULL);
+    ASSERT(levelPending != NULL);
+
+    const String *levelName = levelPending->name;
+    const String *path = levelPending->path;
+
+    MEM_CONTEXT_TEMP_BEGIN()
+    {
+        // Add the target
+        KeyValue *target = kvPutKv(build->targetKv, varNewStr(levelName));
+        kvPut(target, varNewStr(INFO_MANIFEST_SUBKEY_PATH_STR), varNewStr(path));
+        kvPut(
+            target, varNewStr(INFO_MANIFEST_SUBKEY_TYPE_STR),
+            varNewStr(
+                strEq(levelName, INFO_MANIFEST_TARGET_PGDATA_STR) ? INFO_MANIFEST_VALUE_PATH_STR : INFO_MANIFEST_VALUE_LINK_STR));
+
+        if (levelPending->tablespace)
+        {
+            String *tablespaceId = strSub(levelName, sizeof(PG_PATH_PGTBLSPC));
+            String *tablespaceName = NULL;
+
+            // Without a tablespace map the name is generated from the oid
+            if (build->tablespaceMap == NULL)
+                tablespaceName = strNewFmt("ts%s", strPtr(tablespaceId));
+            else
+            {
+                const Variant *tablespaceNameVar = kvGet(build->tablespaceMap, varNewStr(tablespaceId));
+
+                if (tablespaceNameVar == NULL)
+                {
+                    THROW_FMT(
+                        AssertError,
+                        "tablespace with oid %s not found in tablespace map\n"
+                            "HINT: was a tablespace created or dropped during the backup?",
+                        strPtr(tablespaceId));
+                }
+
+                tablespaceName = varStrForce(tablespaceNameVar);
+            }
+
+            kvPut(target, varNewStr(INFO_MANIFEST_SUBKEY_TABLESPACE_ID_STR), varNewStr(tablespaceId));
+            kvPut(target, varNewStr(INFO_MANIFEST_SUBKEY_TABLESPACE_NAME_STR), varNewStr(tablespaceName));
+        }
+
+        // Make the path absolute
+        InfoManifestBuildLevel level = *levelPending;
+
+        if (!strBeginsWithZ(path, "/"))
+        {
+            ASSERT(level.parentPath != NULL);
+            level.path = infoManifestPathAbsolute(level.parentPath, path);
+        }
+
+        StorageInfo info = storageInfoNP(build->storage, level.path);
+
+        // If the level is not a path then it is a link to a file
+        if (info.type != storageTypePath)
+        {
+            if (info.type == storageTypeLink)
+            {
+                THROW_FMT(
+                    LinkDestinationError, "link '%s/%s' -> '%s' cannot reference another link",
+                    strPtr(varStr(kvGet(varKv(kvGet(build->targetKv, varNewStr(INFO_MANIFEST_TARGET_PGDATA_STR))),
+                        varNewStr(INFO_MANIFEST_SUBKEY_PATH_STR)))),
+                    strPtr(strBeginsWithZ(levelName, INFO_MANIFEST_TARGET_PGDATA "/") ?
+                        strSub(levelName, sizeof(INFO_MANIFEST_TARGET_PGDATA)) : levelName),
+                    strPtr(path));
+            }
+
+            // The target is the path containing the file
+            String *name = strBase(level.path);
+
+            kvPut(target, varNewStr(INFO_MANIFEST_SUBKEY_PATH_STR), varNewStr(strPath(path)));
+            kvPut(target, varNewStr(INFO_MANIFEST_SUBKEY_FILE_STR), varNewStr(name));
+
+            infoManifestBuildEntry(
+                build, &level, name, strNewFmt("%s/%s", strPtr(strPath(levelName)), strPtr(name)), &info, NULL);
+        }
+        // Else walk the path
+        else
+        {
+            infoManifestBuildEntry(build, &level, INFO_MANIFEST_DOT_STR, levelName, &info, NULL);
+
+            StringList *pathList = strLstNew();
+            strLstAdd(pathList, EMPTY_STR);
+
+            for (unsigned int pathIdx = 0; pathIdx < strLstSize(pathList); pathIdx++)
+            {
+                MEM_CONTEXT_TEMP_BEGIN()
+                {
+                    const String *subPath = strLstGet(pathList, pathIdx);
+
+                    // Read the directory.  The filter only applies to the top path.
+                    InfoManifestBuildDir dir =
+                    {
+                        .filter = strEmpty(subPath) ? level.filter : NULL,
+                        .entryList = lstNew(sizeof(InfoManifestBuildDirEntry)),
+                        .initList = strLstNew(),
+                    };
+
+                    storageListEachNP(
+                        build->storage, strEmpty(subPath) ? level.path : strNewFmt("%s/%s", strPtr(level.path), strPtr(subPath)),
+                        infoManifestBuildDirCallback, &dir);
+
+                    // Process the entries
+                    for (unsigned int entryIdx = 0; entryIdx < lstSize(dir.entryList); entryIdx++)
+                    {
+                        InfoManifestBuildDirEntry *entry = lstGet(dir.entryList, entryIdx);
+                        String *name = strEmpty(subPath) ?
+                            strDup(entry->name) : strNewFmt("%s/%s", strPtr(subPath), strPtr(entry->name));
+
+                        if (infoManifestBuildEntry(
+                                build, &level, name, strNewFmt("%s/%s", strPtr(levelName), strPtr(name)), &entry->info,
+                                dir.initList))
+                        {
+                            strLstAdd(pathList, name);
+                        }
+                    }
+                }
+                MEM_CONTEXT_TEMP_END();
+            }
+        }
+    }
+    MEM_CONTEXT_TEMP_END();
+
+    FUNCTION_TEST_RETURN_VOID();
+}
+
+/***********************************************************************************************************************************
+Check that links do not reference a subdirectory of or the same directory as another link.  It might be possible to resolve these
+dependencies and generate a valid backup/restore but it's really complicated and there don't seem to be any compelling use cases.
+***********************************************************************************************************************************/
+static void
+infoManifestBuildLinkCheck(const InfoManifestBuild *build)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM_P(VOID, build);
+    FUNCTION_TEST_END();
+
+    ASSERT(build != NULL);
+
+    MEM_CONTEXT_TEMP_BEGIN()
+    {
+        const String *basePath = varStr(
+            kvGet(
+                varKv(kvGet(build->targetKv, varNewStr(INFO_MANIFEST_TARGET_PGDATA_STR))),
+                varNewStr(INFO_MANIFEST_SUBKEY_PATH_STR)));
+        const VariantList *targetList = kvKeyList(build->targetKv);
+
+        for (unsigned int parentIdx = 0; parentIdx < varLstSize(targetList); parentIdx++)
+        {
+            const String *parentName = varStr(varLstGet(targetList, parentIdx));
+            const KeyValue *parent = varKv(kvGet(build->targetKv, varLstGet(targetList, parentIdx)));
+
+            // Links to files may share a path with other links
+            if (!strEq(varStr(kvGet(parent, varNewStr(INFO_MANIFEST_SUBKEY_TYPE_STR))), INFO_MANIFEST_VALUE_LINK_STR) ||
+                kvGet(parent, varNewStr(INFO_MANIFEST_SUBKEY_FILE_STR)) != NULL)
+            {
+                continue;
+            }
+
+            const String *parentPath = varStr(kvGet(parent, varNewStr(INFO_MANIFEST_SUBKEY_PATH_STR)));
+            String *parentPathAbsolute = strCatChr(infoManifestPathAbsolute(basePath, parentPath), '/');
+
+            for (unsigned int childIdx = 0; childIdx < varLstSize(targetList); childIdx++)
+            {
+                const String *childName = varStr(varLstGet(targetList, childIdx));
+                const KeyValue *child = varKv(kvGet(build->targetKv, varLstGet(targetList, childIdx)));
+
+                if (childIdx != parentIdx &&
+                    strEq(varStr(kvGet(child, varNewStr(INFO_MANIFEST_SUBKEY_TYPE_STR))), INFO_MANIFEST_VALUE_LINK_STR))
+                {
+                    const String *childPath = varStr(kvGet(child, varNewStr(INFO_MANIFEST_SUBKEY_PATH_STR)));
+
+                    if (strBeginsWith(strCatChr(infoManifestPathAbsolute(basePath, childPath), '/'), parentPathAbsolute))
+                    {
+                        THROW_FMT(
+                            LinkDestinationError,
+                            "link %s/%s (%s) references a subdirectory of or the same directory as link %s/%s (%s)",
+                            strPtr(basePath), strPtr(strBeginsWithZ(childName, INFO_MANIFEST_TARGET_PGDATA "/") ?
+                                strSub(childName, sizeof(INFO_MANIFEST_TARGET_PGDATA)) : childName),
+                            strPtr(childPath), strPtr(basePath),
+                            strPtr(strBeginsWithZ(parentName, INFO_MANIFEST_TARGET_PGDATA "/") ?
+                                strSub(parentName, sizeof(INFO_MANIFEST_TARGET_PGDATA)) : parentName),
+                            strPtr(parentPath));
+                    }
+                }
+            }
+        }
+    }
+    MEM_CONTEXT_TEMP_END();
+
+    FUNCTION_TEST_RETURN_VOID();
+}
+
+/***********************************************************************************************************************************
+Get the value of a subkey that may be defaulted
+***********************************************************************************************************************************/
+typedef enum
+{
+    infoManifestBuildSubKeyGroup,
+    infoManifestBuildSubKeyMaster,
+    infoManifestBuildSubKeyMode,
+    infoManifestBuildSubKeyUser,
+} InfoManifestBuildSubKey;
+
+static const char *infoManifestBuildSubKeyName[] =
+{
+    INFO_MANIFEST_SUBKEY_GROUP,
+    INFO_MANIFEST_SUBKEY_MASTER,
+    INFO_MANIFEST_SUBKEY_MODE,
+    INFO_MANIFEST_SUBKEY_USER,
+};
+
+static const String *
+infoManifestBuildSubKeyValue(const InfoManifestBuildEntry *entry, InfoManifestBuildSubKey subKey)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM_P(VOID, entry);
+        FUNCTION_TEST_PARAM(ENUM, subKey);
+    FUNCTION_TEST_END();
+
+    ASSERT(entry != NULL);
+
+    const String *result = NULL;
+
+    switch (subKey)
+    {
+        case infoManifestBuildSubKeyGroup:
+        {
+            result = entry->group;
+            break;
+        }
+
+        case infoManifestBuildSubKeyMaster:
+        {
+            result = entry->master ? INFO_MANIFEST_JSON_TRUE_STR : INFO_MANIFEST_JSON_FALSE_STR;
+            break;
+        }
+
+        case infoManifestBuildSubKeyMode:
+        {
+            result = entry->mode;
+            break;
+        }
+
+        case infoManifestBuildSubKeyUser:
+        {
+            result = entry->user;
+            break;
+        }
+    }
+
+    FUNCTION_TEST_RETURN(result);
+}
+
+/***********************************************************************************************************************************
+Find the default for a subkey in a section, i.e. the most common value when it is used by more than 10% of the entries.  Users and
+groups without names are not counted.
+***********************************************************************************************************************************/
+typedef struct InfoManifestBuildDefaultTotal
+{
+    const String *value;                                            // Value rendered as JSON
+    unsigned int total;                                             // Entries with the value
+} InfoManifestBuildDefaultTotal;
+
+static const String *
+infoManifestBuildDefault(const List *entryList, StorageType type, InfoManifestBuildSubKey subKey)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(LIST, entryList);
+        FUNCTION_TEST_PARAM(ENUM, type);
+        FUNCTION_TEST_PARAM(ENUM, subKey);
+    FUNCTION_TEST_END();
+
+    ASSERT(entryList != NULL);
+
+    const String *result = NULL;
+
+    MEM_CONTEXT_TEMP_BEGIN()
+    {
+        List *totalList = lstNew(sizeof(InfoManifestBuildDefaultTotal));
+        unsigned int sectionTotal = 0;
+
+        // Count the values.  They are cached so comparing by pointer is enough.
+        for (unsigned int entryIdx = 0; entryIdx < lstSize(entryList); entryIdx++)
+        {
+            const InfoManifestBuildEntry *entry = lstGet(entryList, entryIdx);
+            const String *value = infoManifestBuildSubKeyValue(entry, subKey);
+
+            if (entry->type != type || value == NULL)
+                continue;
+
+            unsigned int totalIdx = 0;
+
+            for (; totalIdx < lstSize(totalList); totalIdx++)
+            {
+                InfoManifestBuildDefaultTotal *total = lstGet(totalList, totalIdx);
+
+                if (total->value == value)
+                {
+                    total->total++;
+                    break;
+                }
+            }
+
+            if (totalIdx == lstSize(totalList))
+                lstAdd(totalList, &(InfoManifestBuildDefaultTotal){.value = value, .total = 1});
+
+            sectionTotal++;
+        }
+
+        // Find the most common value.  Ties go to the value that sorts first.
+        unsigned int resultTotal = 0;
+
+        for (unsigned int totalIdx = 0; totalIdx < lstSize(totalList); totalIdx++)
+        {
+            InfoManifestBuildDefaultTotal *total = lstGet(totalList, totalIdx);
+
+            if (total->total > resultTotal || (total->total == resultTotal && strCmp(total->value, result) < 0))
+            {
+                result = total->value;
+                resultTotal = total->total;
+            }
+        }
+
+        // Only use the value as a default if it is common enough
+        if (resultTotal * 10 <= sectionTotal)
+            result = NULL;
+    }
+    MEM_CONTEXT_TEMP_END();
+
+    FUNCTION_TEST_RETURN(result);
+}
+
+/***********************************************************************************************************************************
+Add a key to an entry rendered as JSON.  The caller adds the value.
+***********************************************************************************************************************************/
+static String *
+infoManifestBuildRenderKey(String *json, const char *key)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(STRING, json);
+        FUNCTION_TEST_PARAM(STRINGZ, key);
+    FUNCTION_TEST_END();
+
+    ASSERT(json != NULL);
+    ASSERT(key != NULL);
+
+    FUNCTION_TEST_RETURN(strCatFmt(json, "%s\"%s\":", strSize(json) > 1 ? "," : "", key));
+}
+
+/***********************************************************************************************************************************
+Render a file/path/link section and its defaults
+***********************************************************************************************************************************/
+static void
+infoManifestBuildRenderSection(String *content, const List *entryList, StorageType type, const String *section)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(STRING, content);
+        FUNCTION_TEST_PARAM(LIST, entryList);
+        FUNCTION_TEST_PARAM(ENUM, type);
+        FUNCTION_TEST_PARAM(STRING, section);
+    FUNCTION_TEST_END();
+
+    ASSERT(content != NULL);
+    ASSERT(entryList != NULL);
+    ASSERT(section != NULL);
+
+    MEM_CONTEXT_TEMP_BEGIN()
+    {
+        // Determine defaults (links don't have a mode and only files have the master subkey)
+        const String *defaultValue[sizeof(infoManifestBuildSubKeyName) / sizeof(infoManifestBuildSubKeyName[0])] = {NULL};
+
+        defaultValue[infoManifestBuildSubKeyGroup] = infoManifestBuildDefault(entryList, type, infoManifestBuildSubKeyGroup);
+        defaultValue[infoManifestBuildSubKeyUser] = infoManifestBuildDefault(entryList, type, infoManifestBuildSubKeyUser);
+
+        if (type != storageTypeLink)
+            defaultValue[infoManifestBuildSubKeyMode] = infoManifestBuildDefault(entryList, type, infoManifestBuildSubKeyMode);
+
+        if (type == storageTypeFile)
+            defaultValue[infoManifestBuildSubKeyMaster] = infoManifestBuildDefault(entryList, type, infoManifestBuildSubKeyMaster);
+
+        // Render entries
+        bool found = false;
+        String *json = strNew("");
+
+        for (unsigned int entryIdx = 0; entryIdx < lstSize(entryList); entryIdx++)
+        {
+            const InfoManifestBuildEntry *entry = lstGet(entryList, entryIdx);
+
+            if (entry->type != type)
+                continue;
+
+            if (!found)
+            {
+                strCatFmt(content, "\n[%s]\n", strPtr(section));
+                found = true;
+            }
+
+            // Keys are rendered in sorted order
+            strCat(strTrunc(json, 0), "{");
+
+            if (type == storageTypeLink)
+                strCat(infoManifestBuildRenderKey(json, INFO_MANIFEST_SUBKEY_DESTINATION), strPtr(entry->destination));
+
+            if (entry->group != defaultValue[infoManifestBuildSubKeyGroup] || entry->group == NULL)
+            {
+                strCat(
+                    infoManifestBuildRenderKey(json, INFO_MANIFEST_SUBKEY_GROUP),
+                    strPtr(entry->group == NULL ? INFO_MANIFEST_JSON_FALSE_STR : entry->group));
+            }
+
+            if (type == storageTypeFile)
+            {
+                const String *master = infoManifestBuildSubKeyValue(entry, infoManifestBuildSubKeyMaster);
+
+                if (master != defaultValue[infoManifestBuildSubKeyMaster])
+                    strCat(infoManifestBuildRenderKey(json, INFO_MANIFEST_SUBKEY_MASTER), strPtr(master));
+            }
+
+            if (type != storageTypeLink && entry->mode != defaultValue[infoManifestBuildSubKeyMode])
+                strCat(infoManifestBuildRenderKey(json, INFO_MANIFEST_SUBKEY_MODE), strPtr(entry->mode));
+
+            if (type == storageTypeFile)
+            {
+                strCatFmt(infoManifestBuildRenderKey(json, INFO_MANIFEST_SUBKEY_SIZE), "%" PRIu64, entry->size);
+                strCatFmt(infoManifestBuildRenderKey(json, INFO_MANIFEST_SUBKEY_TIMESTAMP), "%" PRId64, (int64_t)entry->timestamp);
+            }
+
+            if (entry->user != defaultValue[infoManifestBuildSubKeyUser] || entry->user == NULL)
+            {
+                strCat(
+                    infoManifestBuildRenderKey(json, INFO_MANIFEST_SUBKEY_USER),
+                    strPtr(entry->user == NULL ? INFO_MANIFEST_JSON_FALSE_STR : entry->user));
+            }
+
+            strCatFmt(content, "%s=%s}\n", strPtr(entry->name), strPtr(json));
+        }
+
+        // Render defaults
+        if (found)
+        {
+            bool defaultFound = false;
+
+            for (unsigned int subKeyIdx = 0;
+                 subKeyIdx < sizeof(infoManifestBuildSubKeyName) / sizeof(infoManifestBuildSubKeyName[0]); subKeyIdx++)
+            {
+                if (defaultValue[subKeyIdx] != NULL)
+                {
+                    if (!defaultFound)
+                    {
+                        strCatFmt(content, "\n[%s" INFO_MANIFEST_SECTION_DEFAULT_SUFFIX "]\n", strPtr(section));
+                        defaultFound = true;
+                    }
+
+                    strCatFmt(content, "%s=%s\n", infoManifestBuildSubKeyName[subKeyIdx], strPtr(defaultValue[subKeyIdx]));
+                }
+            }
+        }
+    }
+    MEM_CONTEXT_TEMP_END();
+
+    FUNCTION_TEST_RETURN_VOID();
+}
+
+/***********************************************************************************************************************************
+Compare entries by name for sorting
+***********************************************************************************************************************************/
+static int
+infoManifestBuildEntryComparator(const void *item1, const void *item2)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM_P(VOID, item1);
+        FUNCTION_TEST_PARAM_P(VOID, item2);
+    FUNCTION_TEST_END();
+
+    ASSERT(item1 != NULL);
+    ASSERT(item2 != NULL);
+
+    FUNCTION_TEST_RETURN(
+        strCmp(((const InfoManifestBuildEntry *)item1)->name, ((const InfoManifestBuildEntry *)item2)->name));
+}
+
+/***********************************************************************************************************************************
+Build the target, file, path, and link sections of a backup manifest from a PostgreSQL cluster
+
+The storage must accept absolute paths since link destinations can be anywhere.  The result is rendered in the same format as the
+manifest saved by the Perl code.
+***********************************************************************************************************************************/
+String *
+infoManifestBuild(
+    const Storage *storage, const String *pgPath, unsigned int pgVersion, unsigned int pgCatalogVersion, bool online,
+    const KeyValue *tablespaceMap, const StringList *excludeList)
+{
+    FUNCTION_LOG_BEGIN(logLevelDebug);
+        FUNCTION_LOG_PARAM(STORAGE, storage);
+        FUNCTION_LOG_PARAM(STRING, pgPath);
+        FUNCTION_LOG_PARAM(UINT, pgVersion);
+        FUNCTION_LOG_PARAM(UINT, pgCatalogVersion);
+        FUNCTION_LOG_PARAM(BOOL, online);
+        FUNCTION_LOG_PARAM(KEY_VALUE, tablespaceMap);
+        FUNCTION_LOG_PARAM(STRING_LIST, excludeList);
+    FUNCTION_LOG_END();
+
+    ASSERT(storage != NULL);
+    ASSERT(pgPath != NULL);
+
+    String *result = strNew("");
+
+    MEM_CONTEXT_TEMP_BEGIN()
+    {
+        const char *walPath = pgVersion >= PG_VERSION_10 ? PG_PATH_PGWAL : PG_PATH_PGXLOG;
+        const String *tablespacePath = strNewFmt("PG_%s_%u", strPtr(pgVersionToStr(pgVersion)), pgCatalogVersion);
+
+        InfoManifestBuild build =
+        {
+            .memContext = MEM_CONTEXT_TEMP(),
+            .storage = storage,
+            .pgVersion = pgVersion,
+            .online = online,
+            .tablespaceMap = tablespaceMap,
+            .excludeList = excludeList == NULL ? NULL : strLstSort(strLstDup(excludeList), sortOrderAsc),
+            .tablespacePath = tablespacePath,
+            .walPath = strNewFmt(INFO_MANIFEST_TARGET_PGDATA "/%s/", walPath),
+            .walArchiveStatusPath = strNewFmt(INFO_MANIFEST_TARGET_PGDATA "/%s/" PG_PATH_ARCHIVE_STATUS, walPath),
+            .tempExp = regExpNew(strNew("(^|/)" PG_PREFIX_PGSQLTMP)),
+            .dbPathExp = regExpNew(strNewFmt("^(" PG_PATH_BASE "|%s)/[0-9]+$", strPtr(tablespacePath))),
+            .relationTempExp = regExpNew(strNew("^t[0-9]+_[0-9]+(|_(fsm|vm)){0,1}(\\.[0-9]+){0,1}$")),
+            .relationExp = regExpNew(strNew("^[0-9]+(|_(fsm|vm)){0,1}(\\.[0-9]+){0,1}$")),
+            .masterExp = regExpNew(
+                strNewFmt(
+                    "^(" INFO_MANIFEST_TARGET_PGDATA "/(" PG_PATH_BASE "|" PG_PATH_GLOBAL "|%s|" PG_PATH_PGMULTIXACT ")|"
+                        INFO_MANIFEST_TARGET_PGTBLSPC ")/",
+                    pgVersion >= PG_VERSION_10 ? PG_PATH_PGXACT : PG_PATH_PGCLOG)),
+            .targetKv = kvNew(),
+            .cacheList = lstNew(sizeof(InfoManifestBuildCache)),
+            .entryList = lstNew(sizeof(InfoManifestBuildEntry)),
+            .levelList = lstNew(sizeof(InfoManifestBuildLevel)),
+        };
+
+        // Build pg_data and all link destinations
+        infoManifestBuildLevelAdd(&build, INFO_MANIFEST_TARGET_PGDATA_STR, pgPath, NULL, NULL, false, 0);
+
+        for (unsigned int levelIdx = 0; levelIdx < lstSize(build.levelList); levelIdx++)
+            infoManifestBuildLevel(&build, lstGet(build.levelList, levelIdx));
+
+        // Check that links are valid
+        infoManifestBuildLinkCheck(&build);
+
+        // Render targets
+        StringList *targetList = strLstSort(strLstNewVarLst(kvKeyList(build.targetKv)), sortOrderAsc);
+
+        strCat(result, "[" INFO_MANIFEST_SECTION_BACKUP_TARGET "]\n");
+
+        for (unsigned int targetIdx = 0; targetIdx < strLstSize(targetList); targetIdx++)
+        {
+            const String *target = strLstGet(targetList, targetIdx);
+
+            strCatFmt(
+                result, "%s=%s\n", strPtr(target), strPtr(kvToJsonInfo(varKv(kvGet(build.targetKv, varNewStr(target))))));
+        }
+
+        // Render files, links, and paths in sorted order
+        lstSort(build.entryList, infoManifestBuildEntryComparator);
+
+        infoManifestBuildRenderSection(result, build.entryList, storageTypeFile, INFO_MANIFEST_SECTION_TARGET_FILE_STR);
+        infoManifestBuildRenderSection(result, build.entryList, storageTypeLink, INFO_MANIFEST_SECTION_TARGET_LINK_STR);
+        infoManifestBuildRenderSection(result, build.entryList, storageTypePath, INFO_MANIFEST_SECTION_TARGET_PATH_STR);
+    }
+    MEM_CONTEXT_TEMP_END();
+
+    FUNCTION_LOG_RETURN(STRING, result);
+}
+
+/***********************************************************************************************************************************
+Manifest object
+
+Files are stored in columns rather than as an Ini of JSON values so a manifest with millions of files fits in a reasonable amount of
+memory.  Paths and references are interned, names without the path are stored in a shared pool, checksums are stored as binary,
+and size/timestamp are stored as integers.  Any other keys in the file JSON (e.g. group, master, mode, user) are kept as rendered
+and interned as a set since nearly all files share one of a few combinations.
+
+All other sections are small so they are stored in an Ini.
+***********************************************************************************************************************************/
+#define INFO_MANIFEST_CHECKSUM_SIZE                                 20
+
+#define INFO_MANIFEST_FILE_FLAG_CHECKSUM                            1
+#define INFO_MANIFEST_FILE_FLAG_SIZE                                2
+#define INFO_MANIFEST_FILE_FLAG_TIMESTAMP                           4
+
+#define INFO_MANIFEST_NONE                                          UINT_MAX
+
+typedef struct InfoManifestExtra
+{
+    const String *json;                                             // Keys/values rendered as JSON without braces
+    StringList *keyList;                                            // Keys
+    StringList *valueList;                                          // Values rendered as JSON
+} InfoManifestExtra;
+
+struct InfoManifest
+{
+    MemContext *memContext;                                         // Context that contains the manifest
+    Ini *ini;                                                       // All sections except files
+    String *checksum;                                               // Checksum when loaded or last saved (NULL if neither)
+
+    StringList *pathList;                                           // Interned paths, e.g. pg_data/base/1/
+    KeyValue *pathIndex;                                            // Index of each path in pathList
+    unsigned int pathLastIdx;                                       // Last path found (files are generally sorted by path)
+    Buffer *namePool;                                               // Zero-terminated names without the path
+    StringList *referenceList;                                      // Interned references
+    StringList *referenceJsonList;                                  // Interned references rendered as JSON
+    List *extraList;                                                // Interned extra keys/values
+    KeyValue *extraIndex;                                           // Index of each extra in extraList
+    unsigned int extraLastIdx;                                      // Last extra found (neighboring files generally share extras)
+
+    List *filePath;                                                 // Index of the path in pathList
+    List *fileName;                                                 // Offset of the name in namePool
+    List *fileSize;                                                 // Size
+    List *fileTimestamp;                                            // Timestamp
+    List *fileChecksum;                                             // Checksum as binary
+    List *fileReference;                                            // Index of the reference in referenceList
+    List *fileExtra;                                                // Index of the extra in extraList
+    List *fileFlag;                                                 // Which of the checksum/size/timestamp columns are set
+};
+
+// Keys stored in columns, in the order they are rendered
+typedef enum
+{
+    infoManifestColumnChecksum,
+    infoManifestColumnReference,
+    infoManifestColumnSize,
+    infoManifestColumnTimestamp,
+} InfoManifestColumn;
+
+static const char *infoManifestColumnName[] =
+{
+    INFO_MANIFEST_SUBKEY_CHECKSUM,
+    INFO_MANIFEST_SUBKEY_REFERENCE,
+    INFO_MANIFEST_SUBKEY_SIZE,
+    INFO_MANIFEST_SUBKEY_TIMESTAMP,
+};
+
+/***********************************************************************************************************************************
+Create a new empty manifest
+***********************************************************************************************************************************/
+InfoManifest *
+infoManifestNew(void)
+{
+    FUNCTION_LOG_VOID(logLevelDebug);
+
+    InfoManifest *this = NULL;
+
+    MEM_CONTEXT_NEW_BEGIN("InfoManifest")
+    {
+        this = memNew(sizeof(InfoManifest));
+        this->memContext = MEM_CONTEXT_NEW();
+
+        this->ini = iniNew();
+        this->pathList = strLstNew();
+        this->pathIndex = kvNew();
+        this->pathLastIdx = INFO_MANIFEST_NONE;
+        this->namePool = bufNew(0);
+        this->referenceList = strLstNew();
+        this->referenceJsonList = strLstNew();
+        this->extraList = lstNew(sizeof(InfoManifestExtra));
+        this->extraIndex = kvNew();
+        this->extraLastIdx = INFO_MANIFEST_NONE;
+
+        this->filePath = lstNew(sizeof(unsigned int));
+        this->fileName = lstNew(sizeof(unsigned int));
+        this->fileSize = lstNew(sizeof(uint64_t));
+        this->fileTimestamp = lstNew(sizeof(int64_t));
+        this->fileChecksum = lstNew(INFO_MANIFEST_CHECKSUM_SIZE);
+        this->fileReference = lstNew(sizeof(unsigned int));
+        this->fileExtra = lstNew(sizeof(unsigned int));
+        this->fileFlag = lstNew(sizeof(uint8_t));
+    }
+    MEM_CONTEXT_NEW_END();
+
+    FUNCTION_LOG_RETURN(INFO_MANIFEST, this);
+}
+
+/***********************************************************************************************************************************
+Get the next key/value in a file rendered as JSON.  Returns false when there are no more keys.
+
+The value is returned as rendered so it can be saved exactly as it was loaded.  JSON is expected to be rendered the way backrest
+renders it, i.e. an object with sorted keys and no whitespace.
+***********************************************************************************************************************************/
+typedef struct InfoManifestJsonPair
+{
+    const char *key;                                                // Key (not terminated)
+    int keySize;                                                    // Size of key
+    const char *value;                                              // Value rendered as JSON (not terminated)
+    int valueSize;                                                  // Size of value
+} InfoManifestJsonPair;
+
+static bool
+infoManifestJsonNext(const String *json, unsigned int *jsonPos, InfoManifestJsonPair *pair)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(STRING, json);
+        FUNCTION_TEST_PARAM_P(UINT, jsonPos);
+        FUNCTION_TEST_PARAM_P(VOID, pair);
+    FUNCTION_TEST_END();
+
+    ASSERT(json != NULL);
+    ASSERT(jsonPos != NULL);
+    ASSERT(pair != NULL);
+
+    const char *jsonPtr = strPtr(json);
+    bool result = false;
+    bool valid = true;
+
+    // The object must begin with {
+    if (*jsonPos == 0)
+    {
+        valid = jsonPtr[0] == '{';
+        (*jsonPos)++;
+    }
+
+    // The object must end with } and nothing after it
+    if (valid && jsonPtr[*jsonPos] == '}')
+        valid = jsonPtr[*jsonPos + 1] == 0;
+    else if (valid)
+    {
+        // Skip the comma that ended the prior value
+        if (*jsonPos > 1)
+            (*jsonPos)++;
+
+        // Get the key
+        if (jsonPtr[*jsonPos] == '"')
+        {
+            pair->key = jsonPtr + *jsonPos + 1;
+
+            const char *keyEnd = strchr(pair->key, '"');
+
+            if (keyEnd == NULL)
+                valid = false;
+            else
+            {
+                pair->keySize = (int)(keyEnd - pair->key);
+                *jsonPos += (unsigned int)pair->keySize + 2;
+            }
+        }
+        else
+            valid = false;
+
+        // Get the value, which ends at the first comma or closing brace that is not in a string or a nested array/object
+        if (valid && jsonPtr[(*jsonPos)++] == ':')
+        {
+            unsigned int valueBegin = *jsonPos;
+            unsigned int depth = 0;
+            bool string = false;
+
+            for (; jsonPtr[*jsonPos] != 0; (*jsonPos)++)
+            {
+                char jsonChar = jsonPtr[*jsonPos];
+
+                if (string)
+                {
+                    if (jsonChar == '\\' && jsonPtr[*jsonPos + 1] != 0)
+                        (*jsonPos)++;
+                    else if (jsonChar == '"')
+                        string = false;
+                }
+                else if (jsonChar == '"')
+                    string = true;
+                else if (jsonChar == '[' || jsonChar == '{')
+                    depth++;
+                else if ((jsonChar == ']' || jsonChar == '}') && depth > 0)
+                    depth--;
+                else if ((jsonChar == ',' || jsonChar == '}') && depth == 0)
+                    break;
+            }
+
+            pair->value = jsonPtr + valueBegin;
+            pair->valueSize = (int)(*jsonPos - valueBegin);
+
+            valid = pair->valueSize > 0 && jsonPtr[*jsonPos] != 0;
+            result = true;
+        }
+        else
+            valid = false;
+    }
+
+    if (!valid)
+        THROW_FMT(FormatError, "invalid JSON object '%s'", jsonPtr);
+
+    FUNCTION_TEST_RETURN(result);
+}
+
+/***********************************************************************************************************************************
+Get the index of an interned path, adding it if it does not exist
+***********************************************************************************************************************************/
+static unsigned int
+infoManifestPathIdx(InfoManifest *this, const char *path, size_t pathSize)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(INFO_MANIFEST, this);
+        FUNCTION_TEST_PARAM(STRINGZ, path);
+        FUNCTION_TEST_PARAM(SIZE, pathSize);
+    FUNCTION_TEST_END();
+
+    ASSERT(this != NULL);
+    ASSERT(path != NULL);
+
+    // Files are generally added in order so the path is usually the same as the last path
+    if (this->pathLastIdx != INFO_MANIFEST_NONE)
+    {
+        const String *pathLast = strLstGet(this->pathList, this->pathLastIdx);
+
+        if (strSize(pathLast) == pathSize && strncmp(strPtr(pathLast), path, pathSize) == 0)
+            FUNCTION_TEST_RETURN(this->pathLastIdx);
+    }
+
+    MEM_CONTEXT_TEMP_BEGIN()
+    {
+        const Variant *pathVar = varNewStr(strNewN(path, pathSize));
+        const Variant *pathIdx = kvGet(this->pathIndex, pathVar);
+
+        if (pathIdx == NULL)
+        {
+            this->pathLastIdx = strLstSize(this->pathList);
+
+            MEM_CONTEXT_BEGIN(this->memContext)
+            {
+                strLstAdd(this->pathList, varStr(pathVar));
+                kvPut(this->pathIndex, pathVar, varNewUInt64(this->pathLastIdx));
+            }
+            MEM_CONTEXT_END();
+        }
+        else
+            this->pathLastIdx = (unsigned int)varUInt64(pathIdx);
+    }
+    MEM_CONTEXT_TEMP_END();
+
+    FUNCTION_TEST_RETURN(this->pathLastIdx);
+}
+
+/***********************************************************************************************************************************
+Get the index of an interned reference, adding it if it does not exist.  There are only a few references (one for each prior backup
+in the set) so they are searched directly.
+***********************************************************************************************************************************/
+static unsigned int
+infoManifestReferenceIdx(InfoManifest *this, const String *reference, const String *referenceJson)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(INFO_MANIFEST, this);
+        FUNCTION_TEST_PARAM(STRING, reference);
+        FUNCTION_TEST_PARAM(STRING, referenceJson);
+    FUNCTION_TEST_END();
+
+    ASSERT(this != NULL);
+    ASSERT(reference != NULL);
+    ASSERT(referenceJson != NULL);
+
+    unsigned int result = 0;
+
+    for (; result < strLstSize(this->referenceList); result++)
+    {
+        if (strEq(strLstGet(this->referenceList, result), reference))
+            break;
+    }
+
+    if (result == strLstSize(this->referenceList))
+    {
+        MEM_CONTEXT_BEGIN(this->memContext)
+        {
+            strLstAdd(this->referenceList, reference);
+            strLstAdd(this->referenceJsonList, referenceJson);
+        }
+        MEM_CONTEXT_END();
+    }
+
+    FUNCTION_TEST_RETURN(result);
+}
+
+/***********************************************************************************************************************************
+Get the index of an interned extra, adding it if it does not exist
+***********************************************************************************************************************************/
+static unsigned int
+infoManifestExtraIdx(InfoManifest *this, const String *extraJson)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(INFO_MANIFEST, this);
+        FUNCTION_TEST_PARAM(STRING, extraJson);
+    FUNCTION_TEST_END();
+
+    ASSERT(this != NULL);
+    ASSERT(extraJson != NULL);
+
+    // Neighboring files usually have the same extra
+    if (this->extraLastIdx != INFO_MANIFEST_NONE &&
+        strEq(((InfoManifestExtra *)lstGet(this->extraList, this->extraLastIdx))->json, extraJson))
+    {
+        FUNCTION_TEST_RETURN(this->extraLastIdx);
+    }
+
+    MEM_CONTEXT_TEMP_BEGIN()
+    {
+        const Variant *extraVar = varNewStr(extraJson);
+        const Variant *extraIdx = kvGet(this->extraIndex, extraVar);
+
+        if (extraIdx == NULL)
+        {
+            this->extraLastIdx = lstSize(this->extraList);
+
+            MEM_CONTEXT_BEGIN(this->memContext)
+            {
+                InfoManifestExtra extra = {.json = strDup(extraJson), .keyList = strLstNew(), .valueList = strLstNew()};
+
+                // Split the keys/values so they can be rendered in order with the columns
+                String *json = strNewFmt("{%s}", strPtr(extraJson));
+                unsigned int jsonPos = 0;
+                InfoManifestJsonPair pair;
+
+                while (infoManifestJsonNext(json, &jsonPos, &pair))
+                {
+                    strLstAdd(extra.keyList, strNewN(pair.key, (size_t)pair.keySize));
+                    strLstAdd(extra.valueList, strNewN(pair.value, (size_t)pair.valueSize));
+                }
+
+                strFree(json);
+
+                lstAdd(this->extraList, &extra);
+                kvPut(this->extraIndex, extraVar, varNewUInt64(this->extraLastIdx));
+            }
+            MEM_CONTEXT_END();
+        }
+        else
+            this->extraLastIdx = (unsigned int)varUInt64(extraIdx);
+    }
+    MEM_CONTEXT_TEMP_END();
+
+    FUNCTION_TEST_RETURN(this->extraLastIdx);
+}
+
+/***********************************************************************************************************************************
+Convert a checksum from hex to binary.  Returns false if the checksum is not valid lowercase hex.
+***********************************************************************************************************************************/
+static bool
+infoManifestChecksumFromHex(const char *hex, size_t hexSize, unsigned char *checksum)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(STRINGZ, hex);
+        FUNCTION_TEST_PARAM(SIZE, hexSize);
+        FUNCTION_TEST_PARAM_P(UCHARDATA, checksum);
+    FUNCTION_TEST_END();
+
+    ASSERT(hex != NULL);
+    ASSERT(checksum != NULL);
+
+    bool result = hexSize == INFO_MANIFEST_CHECKSUM_SIZE * 2;
+
+    for (unsigned int hexIdx = 0; result && hexIdx < INFO_MANIFEST_CHECKSUM_SIZE * 2; hexIdx++)
+    {
+        char hexChar = hex[hexIdx];
+        unsigned char nibble = 0;
+
+        if (hexChar >= '0' && hexChar <= '9')
+            nibble = (unsigned char)(hexChar - '0');
+        else if (hexChar >= 'a' && hexChar <= 'f')
+            nibble = (unsigned char)(hexChar - 'a' + 10);
+        else
+            result = false;
+
+        if (hexIdx % 2 == 0)
+            checksum[hexIdx / 2] = (unsigned char)(nibble << 4);
+        else
+            checksum[hexIdx / 2] |= nibble;
+    }
+
+    FUNCTION_TEST_RETURN(result);
+}
+
+/***********************************************************************************************************************************
+Convert a checksum from binary to zero-terminated hex
+***********************************************************************************************************************************/
+static void
+infoManifestChecksumToHex(const unsigned char *checksum, char *hex)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM_P(UCHARDATA, checksum);
+        FUNCTION_TEST_PARAM_P(CHARDATA, hex);
+    FUNCTION_TEST_END();
+
+    ASSERT(checksum != NULL);
+    ASSERT(hex != NULL);
+
+    static const char hexDigit[] = "0123456789abcdef";
+
+    for (unsigned int checksumIdx = 0; checksumIdx < INFO_MANIFEST_CHECKSUM_SIZE; checksumIdx++)
+    {
+        hex[checksumIdx * 2] = hexDigit[checksum[checksumIdx] >> 4];
+        hex[checksumIdx * 2 + 1] = hexDigit[checksum[checksumIdx] & 0xF];
+    }
+
+    hex[INFO_MANIFEST_CHECKSUM_SIZE * 2] = 0;
+
+    FUNCTION_TEST_RETURN_VOID();
+}
+
+/***********************************************************************************************************************************
+Add a file to the columns
+***********************************************************************************************************************************/
+static void
+infoManifestFileAddInternal(
+    InfoManifest *this, const String *name, uint8_t flag, uint64_t size, int64_t timestamp, const unsigned char *checksum,
+    unsigned int referenceIdx, unsigned int extraIdx)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(INFO_MANIFEST, this);
+        FUNCTION_TEST_PARAM(STRING, name);
+        FUNCTION_TEST_PARAM(UINT, flag);
+        FUNCTION_TEST_PARAM(UINT64, size);
+        FUNCTION_TEST_PARAM(INT64, timestamp);
+        FUNCTION_TEST_PARAM_P(UCHARDATA, checksum);
+        FUNCTION_TEST_PARAM(UINT, referenceIdx);
+        FUNCTION_TEST_PARAM(UINT, extraIdx);
+    FUNCTION_TEST_END();
+
+    ASSERT(this != NULL);
+    ASSERT(name != NULL);
+    ASSERT(checksum != NULL);
+
+    // Split the path from the name
+    const char *namePtr = strrchr(strPtr(name), '/');
+    namePtr = namePtr == NULL ? strPtr(name) : namePtr + 1;
+
+    unsigned int pathIdx = infoManifestPathIdx(this, strPtr(name), (size_t)(namePtr - strPtr(name)));
+
+    // Add the name to the pool, doubling the pool when it is full
+    size_t nameSize = strSize(name) - (size_t)(namePtr - strPtr(name)) + 1;
+    unsigned int nameOffset = (unsigned int)bufUsed(this->namePool);
+
+    ASSERT(bufUsed(this->namePool) + nameSize <= UINT_MAX);
+
+    if (bufRemains(this->namePool) < nameSize)
+        bufResize(this->namePool, (bufSize(this->namePool) + nameSize) * 2);
+
+    memcpy(bufPtr(this->namePool) + bufUsed(this->namePool), namePtr, nameSize);
+    bufUsedInc(this->namePool, nameSize);
+
+    // Add the columns
+    MEM_CONTEXT_BEGIN(this->memContext)
+    {
+        lstAdd(this->filePath, &pathIdx);
+        lstAdd(this->fileName, &nameOffset);
+        lstAdd(this->fileSize, &size);
+        lstAdd(this->fileTimestamp, &timestamp);
+        lstAdd(this->fileChecksum, checksum);
+        lstAdd(this->fileReference, &referenceIdx);
+        lstAdd(this->fileExtra, &extraIdx);
+        lstAdd(this->fileFlag, &flag);
+    }
+    MEM_CONTEXT_END();
+
+    FUNCTION_TEST_RETURN_VOID();
+}
+
+/***********************************************************************************************************************************
+Add a file
+***********************************************************************************************************************************/
+void
+infoManifestFileAdd(InfoManifest *this, const InfoManifestFile *file)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(INFO_MANIFEST, this);
+        FUNCTION_LOG_PARAM_P(VOID, file);
+    FUNCTION_LOG_END();
+
+    ASSERT(this != NULL);
+    ASSERT(file != NULL);
+    ASSERT(file->name != NULL);
+
+    MEM_CONTEXT_TEMP_BEGIN()
+    {
+        unsigned char checksum[INFO_MANIFEST_CHECKSUM_SIZE] = {0};
+        uint8_t flag = INFO_MANIFEST_FILE_FLAG_SIZE | INFO_MANIFEST_FILE_FLAG_TIMESTAMP;
+
+        if (file->checksum != NULL)
+        {
+            if (!infoManifestChecksumFromHex(strPtr(file->checksum), strSize(file->checksum), checksum))
+                THROW_FMT(AssertError, "invalid checksum '%s' for file '%s'", strPtr(file->checksum), strPtr(file->name));
+
+            flag |= INFO_MANIFEST_FILE_FLAG_CHECKSUM;
+        }
+
+        infoManifestFileAddInternal(
+            this, file->name, flag, file->size, (int64_t)file->timestamp, checksum,
+            file->reference == NULL ?
+                INFO_MANIFEST_NONE : infoManifestReferenceIdx(this, file->reference, varToJsonInfo(varNewStr(file->reference))),
+            infoManifestExtraIdx(this, EMPTY_STR));
+    }
+    MEM_CONTEXT_TEMP_END();
+
+    FUNCTION_LOG_RETURN_VOID();
+}
+
+/***********************************************************************************************************************************
+Does the key in a JSON pair match?
+***********************************************************************************************************************************/
+static bool
+infoManifestJsonKey(const InfoManifestJsonPair *pair, const char *key)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM_P(VOID, pair);
+        FUNCTION_TEST_PARAM(STRINGZ, key);
+    FUNCTION_TEST_END();
+
+    ASSERT(pair != NULL);
+    ASSERT(key != NULL);
+
+    FUNCTION_TEST_RETURN(strlen(key) == (size_t)pair->keySize && strncmp(pair->key, key, (size_t)pair->keySize) == 0);
+}
+
+/***********************************************************************************************************************************
+Is the value in a JSON pair a string with no escapes?  The value can be stored without the quotes since it renders the same.
+***********************************************************************************************************************************/
+static bool
+infoManifestJsonStr(const InfoManifestJsonPair *pair)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM_P(VOID, pair);
+    FUNCTION_TEST_END();
+
+    ASSERT(pair != NULL);
+
+    FUNCTION_TEST_RETURN(
+        pair->valueSize > 1 && pair->value[0] == '"' && pair->value[pair->valueSize - 1] == '"' &&
+        memchr(pair->value, '\\', (size_t)pair->valueSize) == NULL);
+}
+
+/***********************************************************************************************************************************
+Copy an integer value in a JSON pair to a zero-terminated buffer for conversion.  Returns false if the value is not an integer or
+does not fit in the buffer.
+***********************************************************************************************************************************/
+static bool
+infoManifestJsonInt(const InfoManifestJsonPair *pair, bool negative, char *buffer, size_t bufferSize)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM_P(VOID, pair);
+        FUNCTION_TEST_PARAM(BOOL, negative);
+        FUNCTION_TEST_PARAM_P(CHARDATA, buffer);
+        FUNCTION_TEST_PARAM(SIZE, bufferSize);
+    FUNCTION_TEST_END();
+
+    ASSERT(pair != NULL);
+    ASSERT(buffer != NULL);
+
+    bool result = (size_t)pair->valueSize < bufferSize;
+
+    if (result)
+    {
+        memcpy(buffer, pair->value, (size_t)pair->valueSize);
+        buffer[pair->valueSize] = 0;
+
+        const char *digit = negative && buffer[0] == '-' ? buffer + 1 : buffer;
+        result = digit[0] != 0 && strspn(digit, "0123456789") == strlen(digit);
+    }
+
+    FUNCTION_TEST_RETURN(result);
+}
+
+/***********************************************************************************************************************************
+Load a file from JSON
+***********************************************************************************************************************************/
+static void
+infoManifestFileLoad(InfoManifest *this, const String *name, const String *json, String *extraJson)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(INFO_MANIFEST, this);
+        FUNCTION_TEST_PARAM(STRING, name);
+        FUNCTION_TEST_PARAM(STRING, json);
+        FUNCTION_TEST_PARAM(STRING, extraJson);
+    FUNCTION_TEST_END();
+
+    ASSERT(this != NULL);
+    ASSERT(name != NULL);
+    ASSERT(json != NULL);
+    ASSERT(extraJson != NULL);
+
+    unsigned char checksum[INFO_MANIFEST_CHECKSUM_SIZE] = {0};
+    uint8_t flag = 0;
+    uint64_t size = 0;
+    int64_t timestamp = 0;
+    unsigned int referenceIdx = INFO_MANIFEST_NONE;
+
+    unsigned int jsonPos = 0;
+    InfoManifestJsonPair pair;
+    char number[32];
+
+    strTrunc(extraJson, 0);
+
+    while (infoManifestJsonNext(json, &jsonPos, &pair))
+    {
+        // Store known keys in columns when the value has the expected type
+        if (infoManifestJsonKey(&pair, INFO_MANIFEST_SUBKEY_CHECKSUM) && infoManifestJsonStr(&pair) &&
+            infoManifestChecksumFromHex(pair.value + 1, (size_t)pair.valueSize - 2, checksum))
+        {
+            flag |= INFO_MANIFEST_FILE_FLAG_CHECKSUM;
+        }
+        else if (infoManifestJsonKey(&pair, INFO_MANIFEST_SUBKEY_REFERENCE) && infoManifestJsonStr(&pair))
+        {
+            MEM_CONTEXT_TEMP_BEGIN()
+            {
+                referenceIdx = infoManifestReferenceIdx(
+                    this, strNewN(pair.value + 1, (size_t)pair.valueSize - 2), strNewN(pair.value, (size_t)pair.valueSize));
+            }
+            MEM_CONTEXT_TEMP_END();
+        }
+        else if (infoManifestJsonKey(&pair, INFO_MANIFEST_SUBKEY_SIZE) && infoManifestJsonInt(&pair, false, number, sizeof(number)))
+        {
+            size = cvtZToUInt64(number);
+            flag |= INFO_MANIFEST_FILE_FLAG_SIZE;
+        }
+        else if (
+            infoManifestJsonKey(&pair, INFO_MANIFEST_SUBKEY_TIMESTAMP) && infoManifestJsonInt(&pair, true, number, sizeof(number)))
+        {
+            timestamp = cvtZToInt64(number);
+            flag |= INFO_MANIFEST_FILE_FLAG_TIMESTAMP;
+        }
+        // Else keep the key/value as rendered
+        else
+        {
+            strCatFmt(
+                extraJson, "%s\"%.*s\":%.*s", strSize(extraJson) == 0 ? "" : ",", pair.keySize, pair.key, pair.valueSize,
+                pair.value);
+        }
+    }
+
+    infoManifestFileAddInternal(this, name, flag, size, timestamp, checksum, referenceIdx, infoManifestExtraIdx(this, extraJson));
+
+    FUNCTION_TEST_RETURN_VOID();
+}
+
+/***********************************************************************************************************************************
+Load a manifest
+
+The manifest is loaded with iniLoad() so the file content is never held in memory and files are stored directly in columns.  The
+checksum and format are validated in the same way as other info files.
+***********************************************************************************************************************************/
+typedef struct InfoManifestLoadData
+{
+    InfoManifest *manifest;                                         // Manifest being loaded
+    InfoChecksum *checksum;                                         // Checksum of the manifest
+    String *extraJson;                                              // Extra keys/values for the current file
+} InfoManifestLoadData;
+
+static void
+infoManifestLoadCallback(void *data, const String *section, const String *key, const String *value)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM_P(VOID, data);
+        FUNCTION_TEST_PARAM(STRING, section);
+        FUNCTION_TEST_PARAM(STRING, key);
+        FUNCTION_TEST_PARAM(STRING, value);
+    FUNCTION_TEST_END();
+
+    ASSERT(data != NULL);
+
+    InfoManifestLoadData *loadData = (InfoManifestLoadData *)data;
+
+    infoChecksumAdd(loadData->checksum, section, key, value);
+
+    if (strEq(section, INFO_MANIFEST_SECTION_TARGET_FILE_STR))
+        infoManifestFileLoad(loadData->manifest, key, value, loadData->extraJson);
+    else
+    {
+        MEM_CONTEXT_TEMP_BEGIN()
+        {
+            iniSet(loadData->manifest->ini, section, key, varNewStr(value));
+        }
+        MEM_CONTEXT_TEMP_END();
+    }
+
+    FUNCTION_TEST_RETURN_VOID();
+}
+
+InfoManifest *
+infoManifestNewLoad(IoRead *read)
+{
+    FUNCTION_LOG_BEGIN(logLevelDebug);
+        FUNCTION_LOG_PARAM(IO_READ, read);
+    FUNCTION_LOG_END();
+
+    ASSERT(read != NULL);
+
+    InfoManifest *this = infoManifestNew();
+
+    MEM_CONTEXT_TEMP_BEGIN()
+    {
+        InfoManifestLoadData loadData = {.manifest = this, .checksum = infoChecksumNew(), .extraJson = strNew("")};
+
+        iniLoad(read, infoManifestLoadCallback, &loadData);
+
+        // Make sure the manifest is valid by testing the checksum
+        const String *checksumHex = infoChecksumHex(loadData.checksum);
+        const String *checksum = strQuoteZ(checksumHex, "\"");
+        const Variant *checksumFound = iniGetDefault(this->ini, INFO_SECTION_BACKREST_STR, INFO_KEY_CHECKSUM_STR, NULL);
+
+        if (checksumFound == NULL || !strEq(varStr(checksumFound), checksum))
+        {
+            THROW_FMT(
+                ChecksumError, "invalid manifest checksum, expected %s but found %s", strPtr(checksum),
+                checksumFound == NULL ? "none" : strPtr(varStr(checksumFound)));
+        }
+
+        MEM_CONTEXT_BEGIN(this->memContext)
+        {
+            this->checksum = strDup(checksumHex);
+        }
+        MEM_CONTEXT_END();
+
+        // Make sure that the format is current
+        const Variant *format = iniGet(this->ini, INFO_SECTION_BACKREST_STR, INFO_KEY_FORMAT_STR);
+
+        if (varIntForce(format) != REPOSITORY_FORMAT)
+        {
+            THROW_FMT(
+                FormatError, "invalid manifest format, expected %d but found %s", REPOSITORY_FORMAT, strPtr(varStr(format)));
+        }
+    }
+    MEM_CONTEXT_TEMP_END();
+
+    FUNCTION_LOG_RETURN(INFO_MANIFEST, this);
+}
+
+/***********************************************************************************************************************************
+Render a file as JSON, merging the columns with the extra keys/values so all keys are sorted
+***********************************************************************************************************************************/
+static void
+infoManifestFileRender(const InfoManifest *this, unsigned int fileIdx, String *name, String *json)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(INFO_MANIFEST, this);
+        FUNCTION_TEST_PARAM(UINT, fileIdx);
+        FUNCTION_TEST_PARAM(STRING, name);
+        FUNCTION_TEST_PARAM(STRING, json);
+    FUNCTION_TEST_END();
+
+    ASSERT(this != NULL);
+    ASSERT(name != NULL);
+    ASSERT(json != NULL);
+
+    // Render the name
+    strCat(
+        strCat(strTrunc(name, 0), strPtr(strLstGet(this->pathList, *(unsigned int *)lstGet(this->filePath, fileIdx)))),
+        (const char *)bufPtr(this->namePool) + *(unsigned int *)lstGet(this->fileName, fileIdx));
+
+    // Render the keys
+    const InfoManifestExtra *extra = lstGet(this->extraList, *(unsigned int *)lstGet(this->fileExtra, fileIdx));
+    uint8_t flag = *(uint8_t *)lstGet(this->fileFlag, fileIdx);
+    unsigned int referenceIdx = *(unsigned int *)lstGet(this->fileReference, fileIdx);
+    unsigned int extraIdx = 0;
+
+    strCat(strTrunc(json, 0), "{");
+
+    for (unsigned int columnIdx = 0; columnIdx <= infoManifestColumnTimestamp + 1; columnIdx++)
+    {
+        // Render extra keys that sort before the column
+        while (extraIdx < strLstSize(extra->keyList) &&
+               (columnIdx > infoManifestColumnTimestamp ||
+                strCmpZ(strLstGet(extra->keyList, extraIdx), infoManifestColumnName[columnIdx]) < 0))
+        {
+            strCat(
+                infoManifestBuildRenderKey(json, strPtr(strLstGet(extra->keyList, extraIdx))),
+                strPtr(strLstGet(extra->valueList, extraIdx)));
+            extraIdx++;
+        }
+
+        // Render the column
+        switch (columnIdx)
+        {
+            case infoManifestColumnChecksum:
+            {
+                if (flag & INFO_MANIFEST_FILE_FLAG_CHECKSUM)
+                {
+                    char checksum[INFO_MANIFEST_CHECKSUM_SIZE * 2 + 1];
+                    infoManifestChecksumToHex(lstGet(this->fileChecksum, fileIdx), checksum);
+
+                    strCatFmt(infoManifestBuildRenderKey(json, INFO_MANIFEST_SUBKEY_CHECKSUM), "\"%s\"", checksum);
+                }
+
+                break;
+            }
+
+            case infoManifestColumnReference:
+            {
+                if (referenceIdx != INFO_MANIFEST_NONE)
+                {
+                    strCat(
+                        infoManifestBuildRenderKey(json, INFO_MANIFEST_SUBKEY_REFERENCE),
+                        strPtr(strLstGet(this->referenceJsonList, referenceIdx)));
+                }
+
+                break;
+            }
+
+            case infoManifestColumnSize:
+            {
+                if (flag & INFO_MANIFEST_FILE_FLAG_SIZE)
+                {
+                    strCatFmt(
+                        infoManifestBuildRenderKey(json, INFO_MANIFEST_SUBKEY_SIZE), "%" PRIu64,
+                        *(uint64_t *)lstGet(this->fileSize, fileIdx));
+                }
+
+                break;
+            }
+
+            case infoManifestColumnTimestamp:
+            {
+                if (flag & INFO_MANIFEST_FILE_FLAG_TIMESTAMP)
+                {
+                    strCatFmt(
+                        infoManifestBuildRenderKey(json, INFO_MANIFEST_SUBKEY_TIMESTAMP), "%" PRId64,
+                        *(int64_t *)lstGet(this->fileTimestamp, fileIdx));
+                }
+
+                break;
+            }
+        }
+    }
+
+    strCat(json, "}");
+
+    FUNCTION_TEST_RETURN_VOID();
+}
+
+/***********************************************************************************************************************************
+Render the manifest as the sections/keys/values of an ini, passing each to a callback in the order they are saved.  Sections and
+keys are sorted to match the Perl rendering.  Files are rendered in the order they were added.
+***********************************************************************************************************************************/
+static void
+infoManifestRender(const InfoManifest *this, const String *checksum, IniLoadCallback callbackFunction, void *callbackData)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(INFO_MANIFEST, this);
+        FUNCTION_TEST_PARAM(STRING, checksum);
+        FUNCTION_TEST_PARAM(FUNCTIONP, callbackFunction);
+        FUNCTION_TEST_PARAM_P(VOID, callbackData);
+    FUNCTION_TEST_END();
+
+    ASSERT(this != NULL);
+    ASSERT(checksum != NULL);
+    ASSERT(callbackFunction != NULL);
+
+    MEM_CONTEXT_TEMP_BEGIN()
+    {
+        StringList *sectionList = iniSectionList(this->ini);
+
+        if (!strLstExists(sectionList, INFO_SECTION_BACKREST_STR))
+            strLstAdd(sectionList, INFO_SECTION_BACKREST_STR);
+
+        if (infoManifestFileTotal(this) > 0)
+            strLstAdd(sectionList, INFO_MANIFEST_SECTION_TARGET_FILE_STR);
+
+        strLstSort(sectionList, sortOrderAsc);
+
+        for (unsigned int sectionIdx = 0; sectionIdx < strLstSize(sectionList); sectionIdx++)
+        {
+            const String *section = strLstGet(sectionList, sectionIdx);
+
+            // Render files
+            if (strEq(section, INFO_MANIFEST_SECTION_TARGET_FILE_STR))
+            {
+                String *name = strNew("");
+                String *json = strNew("");
+
+                for (unsigned int fileIdx = 0; fileIdx < infoManifestFileTotal(this); fileIdx++)
+                {
+                    infoManifestFileRender(this, fileIdx, name, json);
+                    callbackFunction(callbackData, section, name, json);
+                }
+            }
+            // Else render keys
+            else
+            {
+                // The checksum is always the first key in the backrest section
+                bool backrest = strEq(section, INFO_SECTION_BACKREST_STR);
+
+                if (backrest)
+                    callbackFunction(callbackData, section, INFO_KEY_CHECKSUM_STR, checksum);
+
+                StringList *keyList = strLstSort(iniSectionKeyList(this->ini, section), sortOrderAsc);
+
+                for (unsigned int keyIdx = 0; keyIdx < strLstSize(keyList); keyIdx++)
+                {
+                    const String *key = strLstGet(keyList, keyIdx);
+
+                    if (!backrest || !strEq(key, INFO_KEY_CHECKSUM_STR))
+                        callbackFunction(callbackData, section, key, varStr(iniGet(this->ini, section, key)));
+                }
+            }
+        }
+    }
+    MEM_CONTEXT_TEMP_END();
+
+    FUNCTION_TEST_RETURN_VOID();
+}
+
+/***********************************************************************************************************************************
+Save a manifest
+
+The manifest is rendered twice, first to calculate the checksum (which is saved at the beginning of the file) and then to write it,
+so the rendered manifest is never held in memory.
+***********************************************************************************************************************************/
+typedef struct InfoManifestSaveData
+{
+    IoWrite *write;                                                 // Write the manifest is saved to
+    Buffer *buffer;                                                 // Lines waiting to be written
+    String *section;                                                // Current section
+} InfoManifestSaveData;
+
+static void
+infoManifestSaveChecksumCallback(void *data, const String *section, const String *key, const String *value)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM_P(VOID, data);
+        FUNCTION_TEST_PARAM(STRING, section);
+        FUNCTION_TEST_PARAM(STRING, key);
+        FUNCTION_TEST_PARAM(STRING, value);
+    FUNCTION_TEST_END();
+
+    ASSERT(data != NULL);
+
+    infoChecksumAdd((InfoChecksum *)data, section, key, value);
+
+    FUNCTION_TEST_RETURN_VOID();
+}
+
+static void
+infoManifestSaveCallback(void *data, const String *section, const String *key, const String *value)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM_P(VOID, data);
+        FUNCTION_TEST_PARAM(STRING, section);
+        FUNCTION_TEST_PARAM(STRING, key);
+        FUNCTION_TEST_PARAM(STRING, value);
+    FUNCTION_TEST_END();
+
+    ASSERT(data != NULL);
+    ASSERT(section != NULL);
+    ASSERT(key != NULL);
+    ASSERT(value != NULL);
+
+    InfoManifestSaveData *saveData = (InfoManifestSaveData *)data;
+
+    // Write the section header, with a blank line between sections
+    if (saveData->section == NULL || !strEq(section, saveData->section))
+    {
+        if (saveData->section != NULL)
+            bufCatC(saveData->buffer, (const unsigned char *)"\n", 0, 1);
+
+        bufCatC(saveData->buffer, (const unsigned char *)"[", 0, 1);
+        bufCatC(saveData->buffer, (const unsigned char *)strPtr(section), 0, strSize(section));
+        bufCatC(saveData->buffer, (const unsigned char *)"]\n", 0, 2);
+
+        strFree(saveData->section);
+        saveData->section = strDup(section);
+    }
+
+    // Write the key/value
+    bufCatC(saveData->buffer, (const unsigned char *)strPtr(key), 0, strSize(key));
+    bufCatC(saveData->buffer, (const unsigned char *)"=", 0, 1);
+    bufCatC(saveData->buffer, (const unsigned char *)strPtr(value), 0, strSize(value));
+    bufCatC(saveData->buffer, (const unsigned char *)"\n", 0, 1);
+
+    if (bufUsed(saveData->buffer) >= ioBufferSize())
+    {
+        ioWrite(saveData->write, saveData->buffer);
+        bufUsedZero(saveData->buffer);
+    }
+
+    FUNCTION_TEST_RETURN_VOID();
+}
+
+void
+infoManifestSave(InfoManifest *this, IoWrite *write)
+{
+    FUNCTION_LOG_BEGIN(logLevelDebug);
+        FUNCTION_LOG_PARAM(INFO_MANIFEST, this);
+        FUNCTION_LOG_PARAM(IO_WRITE, write);
+    FUNCTION_LOG_END();
+
+    ASSERT(this != NULL);
+    ASSERT(write != NULL);
+
+    MEM_CONTEXT_TEMP_BEGIN()
+    {
+        // Calculate the checksum
+        InfoChecksum *checksum = infoChecksumNew();
+        infoManifestRender(this, EMPTY_STR, infoManifestSaveChecksumCallback, checksum);
+
+        // Write the manifest
+        InfoManifestSaveData saveData = {.write = write, .buffer = bufNew(ioBufferSize())};
+
+        const String *checksumHex = infoChecksumHex(checksum);
+
+        ioWriteOpen(write);
+        infoManifestRender(this, strQuoteZ(checksumHex, "\""), infoManifestSaveCallback, &saveData);
+        ioWrite(write, saveData.buffer);
+        ioWriteClose(write);
+
+        // Store the checksum of the saved manifest
+        MEM_CONTEXT_BEGIN(this->memContext)
+        {
+            strFree(this->checksum);
+            this->checksum = strDup(checksumHex);
+        }
+        MEM_CONTEXT_END();
+    }
+    MEM_CONTEXT_TEMP_END();
+
+    FUNCTION_LOG_RETURN_VOID();
+}
+
+/***********************************************************************************************************************************
+Save the file list to a binary sidecar, see infoManifestSidecar.h for the format.  The manifest must have been loaded or saved so
+the sidecar can record the manifest checksum.
+***********************************************************************************************************************************/
+typedef struct InfoManifestSidecarSort
+{
+    const String *name;                                             // Full name of the file
+    unsigned int fileIdx;                                           // Index of the file in the manifest
+} InfoManifestSidecarSort;
+
+static int
+infoManifestSidecarSortComparator(const void *item1, const void *item2)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM_P(VOID, item1);
+        FUNCTION_TEST_PARAM_P(VOID, item2);
+    FUNCTION_TEST_END();
+
+    ASSERT(item1 != NULL);
+    ASSERT(item2 != NULL);
+
+    FUNCTION_TEST_RETURN(
+        strCmp(((const InfoManifestSidecarSort *)item1)->name, ((const InfoManifestSidecarSort *)item2)->name));
+}
+
+void
+infoManifestSaveSidecar(const InfoManifest *this, IoWrite *write)
+{
+    FUNCTION_LOG_BEGIN(logLevelDebug);
+        FUNCTION_LOG_PARAM(INFO_MANIFEST, this);
+        FUNCTION_LOG_PARAM(IO_WRITE, write);
+    FUNCTION_LOG_END();
+
+    ASSERT(this != NULL);
+    ASSERT(write != NULL);
+
+    MEM_CONTEXT_TEMP_BEGIN()
+    {
+        if (this->checksum == NULL)
+            THROW(AssertError, "manifest must be loaded or saved before the sidecar is saved");
+
+        // Order the files by name
+        List *sortList = lstNew(sizeof(InfoManifestSidecarSort));
+
+        for (unsigned int fileIdx = 0; fileIdx < infoManifestFileTotal(this); fileIdx++)
+        {
+            InfoManifestSidecarSort sort =
+            {
+                .name = strNewFmt(
+                    "%s%s", strPtr(strLstGet(this->pathList, *(unsigned int *)lstGet(this->filePath, fileIdx))),
+                    (const char *)bufPtr(this->namePool) + *(unsigned int *)lstGet(this->fileName, fileIdx)),
+                .fileIdx = fileIdx,
+            };
+
+            lstAdd(sortList, &sort);
+        }
+
+        lstSort(sortList, infoManifestSidecarSortComparator);
+
+        // Build the file records and the string pool after space for the header.  Each reference is added to the pool once.
+        InfoManifestSidecarHeader header =
+        {
+            .magic = INFO_MANIFEST_SIDECAR_MAGIC,
+            .version = INFO_MANIFEST_SIDECAR_VERSION,
+            .fileTotal = lstSize(sortList),
+        };
+
+        Buffer *content = bufNew(sizeof(header) + lstSize(sortList) * sizeof(InfoManifestSidecarFile));
+        bufCatC(content, (const unsigned char *)&header, 0, sizeof(header));
+        Buffer *pool = bufNew(0);
+        List *referenceOffsetList = lstNew(sizeof(unsigned int));
+
+        for (unsigned int referenceIdx = 0; referenceIdx < strLstSize(this->referenceList); referenceIdx++)
+            lstAdd(referenceOffsetList, &(unsigned int){INFO_MANIFEST_NONE});
+
+        for (unsigned int sortIdx = 0; sortIdx < lstSize(sortList); sortIdx++)
+        {
+            const InfoManifestSidecarSort *sort = lstGet(sortList, sortIdx);
+
+            ASSERT(bufUsed(pool) + strSize(sort->name) <= UINT32_MAX);
+
+            InfoManifestSidecarFile file =
+            {
+                .size = *(uint64_t *)lstGet(this->fileSize, sort->fileIdx),
+                .timestamp = *(int64_t *)lstGet(this->fileTimestamp, sort->fileIdx),
+                .nameOffset = (uint32_t)bufUsed(pool),
+                .nameSize = (uint32_t)strSize(sort->name),
+            };
+
+            bufCatC(pool, (const unsigned char *)strPtr(sort->name), 0, strSize(sort->name));
+
+            if (*(uint8_t *)lstGet(this->fileFlag, sort->fileIdx) & INFO_MANIFEST_FILE_FLAG_CHECKSUM)
+            {
+                memcpy(file.checksum, lstGet(this->fileChecksum, sort->fileIdx), INFO_MANIFEST_SIDECAR_CHECKSUM_SIZE);
+                file.flag |= INFO_MANIFEST_SIDECAR_FLAG_CHECKSUM;
+            }
+
+            unsigned int referenceIdx = *(unsigned int *)lstGet(this->fileReference, sort->fileIdx);
+
+            if (referenceIdx != INFO_MANIFEST_NONE)
+            {
+                const String *reference = strLstGet(this->referenceList, referenceIdx);
+                unsigned int *referenceOffset = lstGet(referenceOffsetList, referenceIdx);
+
+                if (*referenceOffset == INFO_MANIFEST_NONE)
+                {
+                    ASSERT(bufUsed(pool) + strSize(reference) <= UINT32_MAX);
+
+                    *referenceOffset = (unsigned int)bufUsed(pool);
+                    bufCatC(pool, (const unsigned char *)strPtr(reference), 0, strSize(reference));
+                }
+
+                file.referenceOffset = *referenceOffset;
+                file.referenceSize = (uint32_t)strSize(reference);
+            }
+
+            bufCatC(content, (const unsigned char *)&file, 0, sizeof(file));
+        }
+
+        bufCat(content, pool);
+
+        // Complete the header
+        header.poolSize = (uint32_t)bufUsed(pool);
+        memcpy(header.manifestChecksum, strPtr(this->checksum), INFO_MANIFEST_SIDECAR_CHECKSUM_HEX_SIZE);
+        memcpy(
+            header.checksum,
+            bufPtr(cryptoHashOneC(HASH_TYPE_SHA1_STR, bufPtr(content) + sizeof(header), bufUsed(content) - sizeof(header))),
+            INFO_MANIFEST_SIDECAR_CHECKSUM_SIZE);
+        memcpy(bufPtr(content), &header, sizeof(header));
+
+        // Write the sidecar
+        ioWriteOpen(write);
+        ioWrite(write, content);
+        ioWriteClose(write);
+    }
+    MEM_CONTEXT_TEMP_END();
+
+    FUNCTION_LOG_RETURN_VOID();
+}
+
+/***********************************************************************************************************************************
+Get a file.  The name and checksum are allocated in the current memory context.
+***********************************************************************************************************************************/
+InfoManifestFile
+infoManifestFile(const InfoManifest *this, unsigned int fileIdx)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(INFO_MANIFEST, this);
+        FUNCTION_TEST_PARAM(UINT, fileIdx);
+    FUNCTION_TEST_END();
+
+    ASSERT(this != NULL);
+    ASSERT(fileIdx < infoManifestFileTotal(this));
+
+    unsigned int referenceIdx = *(unsigned int *)lstGet(this->fileReference, fileIdx);
+
+    InfoManifestFile result =
+    {
+        .name = strNewFmt(
+            "%s%s", strPtr(strLstGet(this->pathList, *(unsigned int *)lstGet(this->filePath, fileIdx))),
+            (const char *)bufPtr(this->namePool) + *(unsigned int *)lstGet(this->fileName, fileIdx)),
+        .size = *(uint64_t *)lstGet(this->fileSize, fileIdx),
+        .timestamp = (time_t)*(int64_t *)lstGet(this->fileTimestamp, fileIdx),
+        .reference = referenceIdx == INFO_MANIFEST_NONE ? NULL : strLstGet(this->referenceList, referenceIdx),
+    };
+
+    if (*(uint8_t *)lstGet(this->fileFlag, fileIdx) & INFO_MANIFEST_FILE_FLAG_CHECKSUM)
+    {
+        char checksum[INFO_MANIFEST_CHECKSUM_SIZE * 2 + 1];
+        infoManifestChecksumToHex(lstGet(this->fileChecksum, fileIdx), checksum);
+
+        result.checksum = strNew(checksum);
+    }
+
+    FUNCTION_TEST_RETURN(result);
+}
+
+/***********************************************************************************************************************************
+Get the checksum of the manifest when it was loaded or last saved
+***********************************************************************************************************************************/
+const String *
+infoManifestChecksum(const InfoManifest *this)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(INFO_MANIFEST, this);
+    FUNCTION_TEST_END();
+
+    ASSERT(this != NULL);
+
+    FUNCTION_TEST_RETURN(this->checksum);
+}
+
+/***********************************************************************************************************************************
+Get the number of files
+***********************************************************************************************************************************/
+unsigned int
+infoManifestFileTotal(const InfoManifest *this)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(INFO_MANIFEST, this);
+    FUNCTION_TEST_END();
+
+    ASSERT(this != NULL);
+
+    FUNCTION_TEST_RETURN(lstSize(this->fileFlag));
+}
+
+/***********************************************************************************************************************************
+Get the sections other than files
+***********************************************************************************************************************************/
+Ini *
+infoManifestIni(const InfoManifest *this)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(INFO_MANIFEST, this);
+    FUNCTION_TEST_END();
+
+    ASSERT(this != NULL);
+
+    FUNCTION_TEST_RETURN(this->ini);
+}
+
+/***********************************************************************************************************************************
+Free the manifest
+***********************************************************************************************************************************/
+void
+infoManifestFree(InfoManifest *this)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(INFO_MANIFEST, this);
+    FUNCTION_LOG_END();
+
+    if (this != NULL)
+        memContextFree(this->memContext);
+
+    FUNCTION_LOG_RETURN_VOID();
+}
@@ -4,6 +4,25 @@ Manifest Info Handler
 #ifndef INFO_INFOMANIFEST_H
 #define INFO_INFOMANIFEST_H
 
+/***********************************************************************************************************************************
+Object type
+***********************************************************************************************************************************/
+typedef struct InfoManifest InfoManifest;
+
+#include <time.h>
+
+#include "common/ini.h"
+#include "common/io/read.h"
+#include "common/io/write.h"
+#include "common/type/keyValue.h"
+#include "common/type/string.h"
+#include "common/type/stringList.h"
+#include "storage/storage.h"
+
+/***********************************************************************************************************************************
+Constants
+***********************************************************************************************************************************/
+
 #define INFO_MANIFEST_KEY_BACKUP_ARCHIVE_START                      "backup-archive-start"
     STRING_DECLARE(INFO_MANIFEST_KEY_BACKUP_ARCHIVE_START_STR);
 #define INFO_MANIFEST_KEY_BACKUP_ARCHIVE_STOP                       "backup-archive-stop"
@@ -26,9 +45,109 @@ Manifest Info Handler
     STRING_DECLARE(INFO_MANIFEST_KEY_OPT_CHECKSUM_PAGE_STR);
 #define INFO_MANIFEST_KEY_OPT_COMPRESS                              "option-compress"
     STRING_DECLARE(INFO_MANIFEST_KEY_OPT_COMPRESS_STR);
+#define INFO_MANIFEST_KEY_OPT_COMPRESS_TYPE                         "option-compress-type"
+    STRING_DECLARE(INFO_MANIFEST_KEY_OPT_COMPRESS_TYPE_STR);
 #define INFO_MANIFEST_KEY_OPT_HARDLINK                              "option-hardlink"
     STRING_DECLARE(INFO_MANIFEST_KEY_OPT_HARDLINK_STR);
 #define INFO_MANIFEST_KEY_OPT_ONLINE                                "option-online"
     STRING_DECLARE(INFO_MANIFEST_KEY_OPT_ONLINE_STR);
 
+#define INFO_MANIFEST_SECTION_BACKUP_TARGET                         "backup:target"
+    STRING_DECLARE(INFO_MANIFEST_SECTION_BACKUP_TARGET_STR);
+#define INFO_MANIFEST_SECTION_TARGET_FILE                           "target:file"
+    STRING_DECLARE(INFO_MANIFEST_SECTION_TARGET_FILE_STR);
+#define INFO_MANIFEST_SECTION_TARGET_LINK                           "target:link"
+    STRING_DECLARE(INFO_MANIFEST_SECTION_TARGET_LINK_STR);
+#define INFO_MANIFEST_SECTION_TARGET_PATH                           "target:path"
+    STRING_DECLARE(INFO_MANIFEST_SECTION_TARGET_PATH_STR);
+#define INFO_MANIFEST_SECTION_DEFAULT_SUFFIX                        ":default"
+
+#define INFO_MANIFEST_SUBKEY_CHECKSUM                               "checksum"
+    STRING_DECLARE(INFO_MANIFEST_SUBKEY_CHECKSUM_STR);
+#define INFO_MANIFEST_SUBKEY_DESTINATION                            "destination"
+    STRING_DECLARE(INFO_MANIFEST_SUBKEY_DESTINATION_STR);
+#define INFO_MANIFEST_SUBKEY_FILE                                   "file"
+    STRING_DECLARE(INFO_MANIFEST_SUBKEY_FILE_STR);
+#define INFO_MANIFEST_SUBKEY_GROUP                                  "group"
+    STRING_DECLARE(INFO_MANIFEST_SUBKEY_GROUP_STR);
+#define INFO_MANIFEST_SUBKEY_MASTER                                 "master"
+    STRING_DECLARE(INFO_MANIFEST_SUBKEY_MASTER_STR);
+#define INFO_MANIFEST_SUBKEY_MODE                                   "mode"
+    STRING_DECLARE(INFO_MANIFEST_SUBKEY_MODE_STR);
+#define INFO_MANIFEST_SUBKEY_PATH                                   "path"
+    STRING_DECLARE(INFO_MANIFEST_SUBKEY_PATH_STR);
+#define INFO_MANIFEST_SUBKEY_REFERENCE                              "reference"
+    STRING_DECLARE(INFO_MANIFEST_SUBKEY_REFERENCE_STR);
+#define INFO_MANIFEST_SUBKEY_SIZE                                   "size"
+    STRING_DECLARE(INFO_MANIFEST_SUBKEY_SIZE_STR);
+#define INFO_MANIFEST_SUBKEY_TABLESPACE_ID                          "tablespace-id"
+    STRING_DECLARE(INFO_MANIFEST_SUBKEY_TABLESPACE_ID_STR);
+#define INFO_MANIFEST_SUBKEY_TABLESPACE_NAME                        "tablespace-name"
+    STRING_DECLARE(INFO_MANIFEST_SUBKEY_TABLESPACE_NAME_STR);
+#define INFO_MANIFEST_SUBKEY_TIMESTAMP                              "timestamp"
+    STRING_DECLARE(INFO_MANIFEST_SUBKEY_TIMESTAMP_STR);
+#define INFO_MANIFEST_SUBKEY_TYPE                                   "type"
+    STRING_DECLARE(INFO_MANIFEST_SUBKEY_TYPE_STR);
+#define INFO_MANIFEST_SUBKEY_USER                                   "user"
+    STRING_DECLARE(INFO_MANIFEST_SUBKEY_USER_STR);
+
+#define INFO_MANIFEST_TARGET_PGDATA                                 "pg_data"
+    STRING_DECLARE(INFO_MANIFEST_TARGET_PGDATA_STR);
+#define INFO_MANIFEST_TARGET_PGTBLSPC                               "pg_tblspc"
+    STRING_DECLARE(INFO_MANIFEST_TARGET_PGTBLSPC_STR);
+
+#define INFO_MANIFEST_VALUE_LINK                                    "link"
+    STRING_DECLARE(INFO_MANIFEST_VALUE_LINK_STR);
+#define INFO_MANIFEST_VALUE_PATH                                    "path"
+    STRING_DECLARE(INFO_MANIFEST_VALUE_PATH_STR);
+
+/***********************************************************************************************************************************
+File in the manifest
+***********************************************************************************************************************************/
+typedef struct InfoManifestFile
+{
+    const String *name;                                             // Manifest name, e.g. pg_data/base/1/1000
+    uint64_t size;                                                  // Original size
+    time_t timestamp;                                               // Modification time
+    const String *checksum;                                         // SHA-1 checksum as hex (NULL if not calculated yet)
+    const String *reference;                                        // Label of the backup that stores the file (NULL if this one)
+} InfoManifestFile;
+
+/***********************************************************************************************************************************
+Constructors
+***********************************************************************************************************************************/
+InfoManifest *infoManifestNew(void);
+InfoManifest *infoManifestNewLoad(IoRead *read);
+
+/***********************************************************************************************************************************
+Functions
+***********************************************************************************************************************************/
+String *infoManifestBuild(
+    const Storage *storage, const String *pgPath, unsigned int pgVersion, unsigned int pgCatalogVersion, bool online,
+    const KeyValue *tablespaceMap, const StringList *excludeList);
+void infoManifestFileAdd(InfoManifest *this, const InfoManifestFile *file);
+void infoManifestSave(InfoManifest *this, IoWrite *write);
+void infoManifestSaveSidecar(const InfoManifest *this, IoWrite *write);
+
+/***********************************************************************************************************************************
+Getters
+***********************************************************************************************************************************/
+const String *infoManifestChecksum(const InfoManifest *this);
+InfoManifestFile infoManifestFile(const InfoManifest *this, unsigned int fileIdx);
+unsigned int infoManifestFileTotal(const InfoManifest *this);
+Ini *infoManifestIni(const InfoManifest *this);
+
+/***********************************************************************************************************************************
+Destructor
+***********************************************************************************************************************************/
+void infoManifestFree(InfoManifest *this);
+
+/***********************************************************************************************************************************
+Macros for function logging
+***********************************************************************************************************************************/
+#define FUNCTION_LOG_INFO_MANIFEST_TYPE                                                                                            \
+    InfoManifest *
+#define FUNCTION_LOG_INFO_MANIFEST_FORMAT(value, buffer, bufferSize)                                                               \
+    objToLog(value, "InfoManifest", buffer, bufferSize)
+
 #endif
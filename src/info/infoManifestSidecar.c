@@ -0,0 +1,413 @@
+/***********************************************************************************************************************************
+Manifest Sidecar
+***********************************************************************************************************************************/
+#include <string.h>
+
+#include "common/debug.h"
+#include "common/io/bufferWrite.h"
+#include "common/io/filter/group.h"
+#include "common/io/io.h"
+#include "common/log.h"
+#include "common/memContext.h"
+#include "crypto/hash.h"
+#include "crypto/helper.h"
+#include "info/info.h"
+#include "info/infoManifestSidecar.h"
+#include "storage/fileRead.h"
+#include "storage/fileWrite.h"
+
+/***********************************************************************************************************************************
+Object type
+***********************************************************************************************************************************/
+struct InfoManifestSidecar
+{
+    MemContext *memContext;                                         // Mem context
+    Buffer *buffer;                                                 // Sidecar content
+    const InfoManifestSidecarHeader *header;                        // Header at the start of the content
+    const InfoManifestSidecarFile *fileList;                        // File records following the header
+    const char *pool;                                               // String pool following the file records
+    const String *manifestChecksum;                                 // Checksum of the manifest the sidecar was built from
+};
+
+/***********************************************************************************************************************************
+Create a sidecar from a buffer
+
+The buffer is moved into the sidecar and the records are accessed in place.  An error is thrown if the sidecar is invalid or, when
+manifestChecksum is not NULL, if the sidecar was not built from the manifest with that checksum.
+***********************************************************************************************************************************/
+InfoManifestSidecar *
+infoManifestSidecarNew(Buffer *buffer, const String *manifestChecksum)
+{
+    FUNCTION_LOG_BEGIN(logLevelDebug);
+        FUNCTION_LOG_PARAM(BUFFER, buffer);
+        FUNCTION_LOG_PARAM(STRING, manifestChecksum);
+    FUNCTION_LOG_END();
+
+    ASSERT(buffer != NULL);
+
+    InfoManifestSidecar *this = NULL;
+
+    MEM_CONTEXT_NEW_BEGIN("InfoManifestSidecar")
+    {
+        this = memNew(sizeof(InfoManifestSidecar));
+        this->memContext = MEM_CONTEXT_NEW();
+        this->buffer = bufMove(buffer, this->memContext);
+
+        // Check the header
+        this->header = (const InfoManifestSidecarHeader *)bufPtr(this->buffer);
+
+        if (bufUsed(this->buffer) < sizeof(InfoManifestSidecarHeader) ||
+            memcmp(this->header->magic, INFO_MANIFEST_SIDECAR_MAGIC, sizeof(this->header->magic)) != 0 ||
+            this->header->version != INFO_MANIFEST_SIDECAR_VERSION)
+        {
+            THROW(FormatError, "invalid manifest sidecar header");
+        }
+
+        size_t size =
+            sizeof(InfoManifestSidecarHeader) + (size_t)this->header->fileTotal * sizeof(InfoManifestSidecarFile) +
+            this->header->poolSize;
+
+        if (bufUsed(this->buffer) != size)
+            THROW_FMT(FormatError, "invalid manifest sidecar size, expected %zu but found %zu", size, bufUsed(this->buffer));
+
+        this->fileList = (const InfoManifestSidecarFile *)(bufPtr(this->buffer) + sizeof(InfoManifestSidecarHeader));
+        this->pool = (const char *)(this->fileList + this->header->fileTotal);
+        this->manifestChecksum = strNewN(this->header->manifestChecksum, sizeof(this->header->manifestChecksum));
+
+        // Check the content
+        MEM_CONTEXT_TEMP_BEGIN()
+        {
+            const Buffer *checksum = cryptoHashOneC(
+                HASH_TYPE_SHA1_STR, (const unsigned char *)this->fileList, size - sizeof(InfoManifestSidecarHeader));
+
+            if (memcmp(bufPtr(checksum), this->header->checksum, sizeof(this->header->checksum)) != 0)
+                THROW(ChecksumError, "invalid manifest sidecar checksum");
+        }
+        MEM_CONTEXT_TEMP_END();
+
+        // Make sure the names and references are in the string pool
+        for (unsigned int fileIdx = 0; fileIdx < this->header->fileTotal; fileIdx++)
+        {
+            const InfoManifestSidecarFile *file = &this->fileList[fileIdx];
+
+            if ((uint64_t)file->nameOffset + file->nameSize > this->header->poolSize ||
+                (uint64_t)file->referenceOffset + file->referenceSize > this->header->poolSize)
+            {
+                THROW_FMT(FormatError, "invalid manifest sidecar file %u", fileIdx);
+            }
+        }
+
+        // Check that the sidecar was built from the expected manifest
+        if (manifestChecksum != NULL && !strEq(manifestChecksum, this->manifestChecksum))
+        {
+            THROW_FMT(
+                ChecksumError, "manifest sidecar is stale, expected manifest checksum '%s' but found '%s'",
+                strPtr(manifestChecksum), strPtr(this->manifestChecksum));
+        }
+    }
+    MEM_CONTEXT_NEW_END();
+
+    FUNCTION_LOG_RETURN(INFO_MANIFEST_SIDECAR, this);
+}
+
+/***********************************************************************************************************************************
+Read the checksum from the start of the manifest.  Manifests written by backrest always begin with the [backrest] section and the
+checksum is always the first key so the rest of the manifest does not need to be read.  Returns NULL if the manifest does not begin
+as expected.
+***********************************************************************************************************************************/
+static String *
+infoManifestSidecarChecksumRead(IoRead *read)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(IO_READ, read);
+    FUNCTION_TEST_END();
+
+    ASSERT(read != NULL);
+
+    String *result = NULL;
+
+    MEM_CONTEXT_TEMP_BEGIN()
+    {
+        ioReadOpen(read);
+
+        const String *prefix = strNewFmt("%s=\"", INFO_KEY_CHECKSUM);
+
+        if (strEq(ioReadLine(read), strNewFmt("[%s]", INFO_SECTION_BACKREST)))
+        {
+            String *line = ioReadLine(read);
+
+            if (strBeginsWith(line, prefix) && strSize(line) == strSize(prefix) + INFO_MANIFEST_SIDECAR_CHECKSUM_HEX_SIZE + 1 &&
+                strEndsWithZ(line, "\""))
+            {
+                memContextSwitch(MEM_CONTEXT_OLD());
+                result = strSubN(line, strSize(prefix), INFO_MANIFEST_SIDECAR_CHECKSUM_HEX_SIZE);
+                memContextSwitch(MEM_CONTEXT_TEMP());
+            }
+        }
+
+        ioReadClose(read);
+    }
+    MEM_CONTEXT_TEMP_END();
+
+    FUNCTION_TEST_RETURN(result);
+}
+
+/***********************************************************************************************************************************
+Load the sidecar for a manifest
+
+The sidecar is loaded from the manifest file name plus INFO_MANIFEST_SIDECAR_EXT.  If the sidecar is missing, invalid, or was built
+from a different manifest, then the manifest is loaded (which also validates the manifest checksum) and the sidecar is rebuilt.  The
+rebuilt sidecar is saved to storageWrite unless it is NULL.  The sidecar is encrypted with the same cipher as the manifest.
+***********************************************************************************************************************************/
+InfoManifestSidecar *
+infoManifestSidecarNewLoad(
+    const Storage *storage, const String *fileName, const Storage *storageWrite, CipherType cipherType, const String *cipherPass)
+{
+    FUNCTION_LOG_BEGIN(logLevelDebug);
+        FUNCTION_LOG_PARAM(STORAGE, storage);
+        FUNCTION_LOG_PARAM(STRING, fileName);
+        FUNCTION_LOG_PARAM(STORAGE, storageWrite);
+        FUNCTION_LOG_PARAM(ENUM, cipherType);
+        // cipherPass omitted for security
+    FUNCTION_LOG_END();
+
+    ASSERT(storage != NULL);
+    ASSERT(fileName != NULL);
+    ASSERT((cipherType == cipherTypeNone && cipherPass == NULL) || (cipherType != cipherTypeNone && cipherPass != NULL));
+
+    InfoManifestSidecar *result = NULL;
+
+    MEM_CONTEXT_TEMP_BEGIN()
+    {
+        const String *sidecarFileName = strNewFmt("%s" INFO_MANIFEST_SIDECAR_EXT, strPtr(fileName));
+
+        // Get the manifest checksum
+        StorageFileRead *manifestRead = storageNewReadNP(storage, fileName);
+
+        if (cipherType != cipherTypeNone)
+        {
+            ioReadFilterGroupSet(
+                storageFileReadIo(manifestRead),
+                ioFilterGroupAdd(ioFilterGroupNew(), cipherFilter(cipherModeDecrypt, cipherType, bufNewStr(cipherPass))));
+        }
+
+        const String *manifestChecksum = infoManifestSidecarChecksumRead(storageFileReadIo(manifestRead));
+
+        // Load the sidecar when the manifest checksum was found
+        if (manifestChecksum != NULL)
+        {
+            StorageFileRead *sidecarRead = storageNewReadP(storage, sidecarFileName, .ignoreMissing = true);
+
+            if (cipherType != cipherTypeNone)
+            {
+                ioReadFilterGroupSet(
+                    storageFileReadIo(sidecarRead),
+                    ioFilterGroupAdd(ioFilterGroupNew(), cipherFilter(cipherModeDecrypt, cipherType, bufNewStr(cipherPass))));
+            }
+
+            // The sidecar is read inside the try block since a corrupt encrypted sidecar throws an error while being decrypted
+            TRY_BEGIN()
+            {
+                Buffer *sidecar = storageGetNP(sidecarRead);
+
+                if (sidecar != NULL)
+                    result = infoManifestSidecarNew(sidecar, manifestChecksum);
+            }
+            CATCH(FormatError)
+            {
+                LOG_DETAIL("rebuild manifest sidecar '%s': %s", strPtr(sidecarFileName), errorMessage());
+            }
+            CATCH(ChecksumError)
+            {
+                LOG_DETAIL("rebuild manifest sidecar '%s': %s", strPtr(sidecarFileName), errorMessage());
+            }
+            CATCH(CryptoError)
+            {
+                LOG_DETAIL("rebuild manifest sidecar '%s': %s", strPtr(sidecarFileName), errorMessage());
+            }
+            TRY_END();
+        }
+
+        // Rebuild the sidecar from the manifest
+        if (result == NULL)
+        {
+            manifestRead = storageNewReadNP(storage, fileName);
+
+            if (cipherType != cipherTypeNone)
+            {
+                ioReadFilterGroupSet(
+                    storageFileReadIo(manifestRead),
+                    ioFilterGroupAdd(ioFilterGroupNew(), cipherFilter(cipherModeDecrypt, cipherType, bufNewStr(cipherPass))));
+            }
+
+            Buffer *sidecar = bufNew(0);
+            infoManifestSaveSidecar(
+                infoManifestNewLoad(storageFileReadIo(manifestRead)), ioBufferWriteIo(ioBufferWriteNew(sidecar)));
+
+            if (storageWrite != NULL)
+            {
+                StorageFileWrite *sidecarWrite = storageNewWriteNP(storageWrite, sidecarFileName);
+
+                if (cipherType != cipherTypeNone)
+                {
+                    ioWriteFilterGroupSet(
+                        storageFileWriteIo(sidecarWrite),
+                        ioFilterGroupAdd(ioFilterGroupNew(), cipherFilter(cipherModeEncrypt, cipherType, bufNewStr(cipherPass))));
+                }
+
+                storagePutNP(sidecarWrite, sidecar);
+            }
+
+            result = infoManifestSidecarNew(sidecar, NULL);
+        }
+
+        infoManifestSidecarMove(result, MEM_CONTEXT_OLD());
+    }
+    MEM_CONTEXT_TEMP_END();
+
+    FUNCTION_LOG_RETURN(INFO_MANIFEST_SIDECAR, result);
+}
+
+/***********************************************************************************************************************************
+Find a file by name with a binary search.  Returns false if the file is not found.
+***********************************************************************************************************************************/
+bool
+infoManifestSidecarFind(const InfoManifestSidecar *this, const String *name, unsigned int *fileIdx)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(INFO_MANIFEST_SIDECAR, this);
+        FUNCTION_TEST_PARAM(STRING, name);
+        FUNCTION_TEST_PARAM_P(UINT, fileIdx);
+    FUNCTION_TEST_END();
+
+    ASSERT(this != NULL);
+    ASSERT(name != NULL);
+    ASSERT(fileIdx != NULL);
+
+    bool result = false;
+    unsigned int low = 0;
+    unsigned int high = this->header->fileTotal;
+
+    while (low < high)
+    {
+        unsigned int middle = low + (high - low) / 2;
+        const InfoManifestSidecarFile *file = &this->fileList[middle];
+
+        // Compare the same way as strcmp() since the names are not zero-terminated in the pool
+        size_t compareSize = file->nameSize < strSize(name) ? file->nameSize : strSize(name);
+        int compare = memcmp(this->pool + file->nameOffset, strPtr(name), compareSize);
+
+        if (compare == 0)
+            compare = file->nameSize < strSize(name) ? -1 : (file->nameSize > strSize(name) ? 1 : 0);
+
+        if (compare < 0)
+            low = middle + 1;
+        else if (compare > 0)
+            high = middle;
+        else
+        {
+            *fileIdx = middle;
+            result = true;
+            break;
+        }
+    }
+
+    FUNCTION_TEST_RETURN(result);
+}
+
+/***********************************************************************************************************************************
+Move the sidecar to a new mem context
+***********************************************************************************************************************************/
+InfoManifestSidecar *
+infoManifestSidecarMove(InfoManifestSidecar *this, MemContext *parentNew)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(INFO_MANIFEST_SIDECAR, this);
+        FUNCTION_TEST_PARAM(MEM_CONTEXT, parentNew);
+    FUNCTION_TEST_END();
+
+    ASSERT(this != NULL);
+    ASSERT(parentNew != NULL);
+
+    memContextMove(this->memContext, parentNew);
+
+    FUNCTION_TEST_RETURN(this);
+}
+
+/***********************************************************************************************************************************
+Get a file.  The name, checksum, and reference are allocated in the current memory context.
+***********************************************************************************************************************************/
+InfoManifestFile
+infoManifestSidecarFile(const InfoManifestSidecar *this, unsigned int fileIdx)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(INFO_MANIFEST_SIDECAR, this);
+        FUNCTION_TEST_PARAM(UINT, fileIdx);
+    FUNCTION_TEST_END();
+
+    ASSERT(this != NULL);
+    ASSERT(fileIdx < this->header->fileTotal);
+
+    const InfoManifestSidecarFile *file = &this->fileList[fileIdx];
+
+    InfoManifestFile result =
+    {
+        .name = strNewN(this->pool + file->nameOffset, file->nameSize),
+        .size = file->size,
+        .timestamp = (time_t)file->timestamp,
+    };
+
+    if (file->flag & INFO_MANIFEST_SIDECAR_FLAG_CHECKSUM)
+        result.checksum = bufHex(bufNewUseC((void *)file->checksum, sizeof(file->checksum)));
+
+    if (file->referenceSize > 0)
+        result.reference = strNewN(this->pool + file->referenceOffset, file->referenceSize);
+
+    FUNCTION_TEST_RETURN(result);
+}
+
+/***********************************************************************************************************************************
+Get the number of files
+***********************************************************************************************************************************/
+unsigned int
+infoManifestSidecarFileTotal(const InfoManifestSidecar *this)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(INFO_MANIFEST_SIDECAR, this);
+    FUNCTION_TEST_END();
+
+    ASSERT(this != NULL);
+
+    FUNCTION_TEST_RETURN(this->header->fileTotal);
+}
+
+/***********************************************************************************************************************************
+Get the checksum of the manifest the sidecar was built from
+***********************************************************************************************************************************/
+const String *
+infoManifestSidecarManifestChecksum(const InfoManifestSidecar *this)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(INFO_MANIFEST_SIDECAR, this);
+    FUNCTION_TEST_END();
+
+    ASSERT(this != NULL);
+
+    FUNCTION_TEST_RETURN(this->manifestChecksum);
+}
+
+/***********************************************************************************************************************************
+Free the sidecar
+***********************************************************************************************************************************/
+void
+infoManifestSidecarFree(InfoManifestSidecar *this)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(INFO_MANIFEST_SIDECAR, this);
+    FUNCTION_LOG_END();
+
+    if (this != NULL)
+        memContextFree(this->memContext);
+
+    FUNCTION_LOG_RETURN_VOID();
+}
@@ -0,0 +1,109 @@
+/***********************************************************************************************************************************
+Manifest Sidecar
+
+The sidecar is a binary copy of the file list in a manifest that can be searched without parsing the manifest.  The manifest is
+always the source of truth -- the sidecar records the checksum of the manifest it was built from and is rebuilt when it is missing,
+invalid, or stale.
+
+The sidecar is stored in native byte order and is laid out as:
+
+    header | file records ordered by name | string pool
+
+The header is fixed size.  File records are fixed size and ordered by name (byte order) so a file can be found with a binary search
+or all files can be read in order.  Names and references in the records are offsets into the string pool, which follows the records.
+The header contains a SHA-1 checksum of the records and string pool so corruption is detected when the sidecar is loaded.  Since the
+format is only a cache of the manifest, a sidecar with a different version (or byte order) is simply rebuilt.
+***********************************************************************************************************************************/
+#ifndef INFO_INFOMANIFESTSIDECAR_H
+#define INFO_INFOMANIFESTSIDECAR_H
+
+/***********************************************************************************************************************************
+Object type
+***********************************************************************************************************************************/
+typedef struct InfoManifestSidecar InfoManifestSidecar;
+
+#include <stdint.h>
+
+#include "common/memContext.h"
+#include "common/type/buffer.h"
+#include "common/type/string.h"
+#include "crypto/crypto.h"
+#include "info/infoManifest.h"
+#include "storage/storage.h"
+
+/***********************************************************************************************************************************
+Constants
+***********************************************************************************************************************************/
+// Extension added to the manifest file name to get the sidecar file name
+#define INFO_MANIFEST_SIDECAR_EXT                                   ".sidecar"
+
+#define INFO_MANIFEST_SIDECAR_MAGIC                                 "PGBRMSC"
+#define INFO_MANIFEST_SIDECAR_VERSION                               1
+
+// Sizes of the checksums stored in the sidecar
+#define INFO_MANIFEST_SIDECAR_CHECKSUM_SIZE                         20
+#define INFO_MANIFEST_SIDECAR_CHECKSUM_HEX_SIZE                     (INFO_MANIFEST_SIDECAR_CHECKSUM_SIZE * 2)
+
+// File flags
+#define INFO_MANIFEST_SIDECAR_FLAG_CHECKSUM                         1
+
+/***********************************************************************************************************************************
+Sidecar header and file record.  Both are multiples of eight bytes and have no padding so the records are aligned when the sidecar
+is read into memory.
+***********************************************************************************************************************************/
+typedef struct InfoManifestSidecarHeader
+{
+    char magic[8];                                                  // INFO_MANIFEST_SIDECAR_MAGIC
+    uint32_t version;                                               // INFO_MANIFEST_SIDECAR_VERSION
+    uint32_t fileTotal;                                             // Number of file records
+    uint32_t poolSize;                                              // Size of the string pool
+    char manifestChecksum[INFO_MANIFEST_SIDECAR_CHECKSUM_HEX_SIZE]; // Checksum of the manifest the sidecar was built from
+    unsigned char checksum[INFO_MANIFEST_SIDECAR_CHECKSUM_SIZE];    // SHA-1 checksum of the records and the string pool
+} InfoManifestSidecarHeader;
+
+typedef struct InfoManifestSidecarFile
+{
+    uint64_t size;                                                  // Original size
+    int64_t timestamp;                                              // Modification time
+    uint32_t nameOffset;                                            // Offset of the name in the string pool
+    uint32_t nameSize;                                              // Size of the name
+    uint32_t referenceOffset;                                       // Offset of the reference in the string pool
+    uint32_t referenceSize;                                         // Size of the reference (0 if no reference)
+    unsigned char checksum[INFO_MANIFEST_SIDECAR_CHECKSUM_SIZE];    // SHA-1 checksum (valid if the checksum flag is set)
+    uint32_t flag;                                                  // File flags
+} InfoManifestSidecarFile;
+
+/***********************************************************************************************************************************
+Constructors
+***********************************************************************************************************************************/
+InfoManifestSidecar *infoManifestSidecarNew(Buffer *buffer, const String *manifestChecksum);
+InfoManifestSidecar *infoManifestSidecarNewLoad(
+    const Storage *storage, const String *fileName, const Storage *storageWrite, CipherType cipherType, const String *cipherPass);
+
+/***********************************************************************************************************************************
+Functions
+***********************************************************************************************************************************/
+bool infoManifestSidecarFind(const InfoManifestSidecar *this, const String *name, unsigned int *fileIdx);
+InfoManifestSidecar *infoManifestSidecarMove(InfoManifestSidecar *this, MemContext *parentNew);
+
+/***********************************************************************************************************************************
+Getters
+***********************************************************************************************************************************/
+InfoManifestFile infoManifestSidecarFile(const InfoManifestSidecar *this, unsigned int fileIdx);
+unsigned int infoManifestSidecarFileTotal(const InfoManifestSidecar *this);
+const String *infoManifestSidecarManifestChecksum(const InfoManifestSidecar *this);
+
+/***********************************************************************************************************************************
+Destructor
+***********************************************************************************************************************************/
+void infoManifestSidecarFree(InfoManifestSidecar *this);
+
+/***********************************************************************************************************************************
+Macros for function logging
+***********************************************************************************************************************************/
+#define FUNCTION_LOG_INFO_MANIFEST_SIDECAR_TYPE                                                                                    \
+    InfoManifestSidecar *
+#define FUNCTION_LOG_INFO_MANIFEST_SIDECAR_FORMAT(value, buffer, bufferSize)                                                       \
+    objToLog(value, "InfoManifestSidecar", buffer, bufferSize)
+
+#endif
@@ -12,9 +12,33 @@ PostgreSQL Interface
 /***********************************************************************************************************************************
 Defines for various Postgres paths and files
 ***********************************************************************************************************************************/
+#define PG_FILE_BACKUPLABELOLD                                      "backup_label.old"
 #define PG_FILE_PGCONTROL                                           "pg_control"
+#define PG_FILE_PGINTERNALINIT                                      "pg_internal.init"
+#define PG_FILE_POSTGRESQLAUTOCONFTMP                               "postgresql.auto.conf.tmp"
+#define PG_FILE_POSTMASTEROPTS                                      "postmaster.opts"
+#define PG_FILE_POSTMASTERPID                                       "postmaster.pid"
+#define PG_FILE_RECOVERYCONF                                        "recovery.conf"
+#define PG_FILE_RECOVERYDONE                                        "recovery.done"
 
+#define PG_PREFIX_PGSQLTMP                                          "pgsql_tmp"
+
+#define PG_PATH_ARCHIVE_STATUS                                      "archive_status"
+#define PG_PATH_BASE                                                "base"
 #define PG_PATH_GLOBAL                                              "global"
+#define PG_PATH_PGCLOG                                              "pg_clog"
+#define PG_PATH_PGDYNSHMEM                                          "pg_dynshmem"
+#define PG_PATH_PGMULTIXACT                                         "pg_multixact"
+#define PG_PATH_PGNOTIFY                                            "pg_notify"
+#define PG_PATH_PGREPLSLOT                                          "pg_replslot"
+#define PG_PATH_PGSERIAL                                            "pg_serial"
+#define PG_PATH_PGSNAPSHOTS                                         "pg_snapshots"
+#define PG_PATH_PGSTATTMP                                           "pg_stat_tmp"
+#define PG_PATH_PGSUBTRANS                                          "pg_subtrans"
+#define PG_PATH_PGTBLSPC                                            "pg_tblspc"
+#define PG_PATH_PGWAL                                               "pg_wal"
+#define PG_PATH_PGXACT                                              "pg_xact"
+#define PG_PATH_PGXLOG                                              "pg_xlog"
 
 /***********************************************************************************************************************************
 PostgreSQL Control File Info
@@ -61,9 +61,24 @@ leave some performance on the table. When vectorization is not available it migh
 calculate a subset of the columns at a time and perform multiple passes to avoid register spilling. This optimization opportunity
 is not used. Current coding also assumes that the compiler has the ability to unroll the inner loop to avoid loop overhead and
 minimize register spilling. For less sophisticated compilers it might be beneficial to manually unroll the inner loop.
+
+pgBackRest does not rely on the compiler to vectorize the calculation.  On x86-64 there are explicit SSE4.1, AVX2, and AVX-512
+implementations that calculate 4, 8, and 16 of the partial checksums per instruction.  The best implementation supported by the CPU
+is selected at runtime and the portable implementation is used when none are supported.
 ***********************************************************************************************************************************/
+#include <stddef.h>
 #include <string.h>
 
+#include "common/cpu.h"
+
+/***********************************************************************************************************************************
+Vector implementations are only available when the compiler supports them (see common/cpu.h)
+***********************************************************************************************************************************/
+#ifdef CPU_X86_VECTOR
+    #define PAGE_CHECKSUM_X86
+    #include <immintrin.h>
+#endif
+
 #include "common/debug.h"
 #include "common/error.h"
 #include "common/log.h"
@@ -114,6 +129,9 @@ The data argument must be aligned on a 4-byte boundary.
 // number of checksums to calculate in parallel
 #define N_SUMS 32
 
+// size of a row, i.e. the data added to the partial checksums in one iteration
+#define ROW_SIZE ((unsigned int)(N_SUMS * sizeof(uint32_t)))
+
 // prime multiplier of FNV-1a hash
 #define FNV_PRIME 16777619
 
@@ -126,6 +144,9 @@ static const uint32_t checksumBaseOffsets[N_SUMS] =
     0x783125BB, 0x6CA8EAA2, 0xE407EAC6, 0x4B5CFC3E, 0x9FBF8C76, 0x15CA20BE, 0xF2CA9FD3, 0x959BD756
 };
 
+// Two rows of zeroes that are added at the end for additional mixing
+static const uint32_t checksumZeroRows[2][N_SUMS];
+
 // Calculate one round of the checksum.
 #define CHECKSUM_COMP(checksum, value) \
 do { \
@@ -133,6 +154,221 @@ do { \
     (checksum) = temp * FNV_PRIME ^ (temp >> 17); \
 } while (0)
 
+/***********************************************************************************************************************************
+Add rows to the partial checksums.  All implementations produce the same result but the vector implementations process multiple
+partial checksums per instruction.
+***********************************************************************************************************************************/
+typedef void (*PageChecksumRowsFunc)(uint32_t *sums, const unsigned char *rows, unsigned int rowTotal);
+
+static void
+pageChecksumRowsPortable(uint32_t *sums, const unsigned char *rows, unsigned int rowTotal)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM_P(UINT32, sums);
+        FUNCTION_TEST_PARAM_P(UCHARDATA, rows);
+        FUNCTION_TEST_PARAM(UINT, rowTotal);
+    FUNCTION_TEST_END();
+
+    const uint32_t (*dataArray)[N_SUMS] = (const uint32_t (*)[N_SUMS])rows;
+
+    for (unsigned int i = 0; i < rowTotal; i++)
+        for (unsigned int j = 0; j < N_SUMS; j++)
+            CHECKSUM_COMP(sums[j], dataArray[i][j]);
+
+    FUNCTION_TEST_RETURN_VOID();
+}
+
+#ifdef PAGE_CHECKSUM_X86
+
+__attribute__((target("sse4.1"))) static void
+pageChecksumRowsSse41(uint32_t *sums, const unsigned char *rows, unsigned int rowTotal)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM_P(UINT32, sums);
+        FUNCTION_TEST_PARAM_P(UCHARDATA, rows);
+        FUNCTION_TEST_PARAM(UINT, rowTotal);
+    FUNCTION_TEST_END();
+
+    const __m128i prime = _mm_set1_epi32(FNV_PRIME);
+    __m128i sum[N_SUMS / 4];
+
+    for (unsigned int j = 0; j < N_SUMS / 4; j++)
+        sum[j] = _mm_loadu_si128((const __m128i *)sums + j);
+
+    for (unsigned int i = 0; i < rowTotal; i++)
+    {
+        const __m128i *row = (const __m128i *)(rows + i * ROW_SIZE);
+
+        for (unsigned int j = 0; j < N_SUMS / 4; j++)
+        {
+            __m128i temp = _mm_xor_si128(sum[j], _mm_loadu_si128(row + j));
+            sum[j] = _mm_xor_si128(_mm_mullo_epi32(temp, prime), _mm_srli_epi32(temp, 17));
+        }
+    }
+
+    for (unsigned int j = 0; j < N_SUMS / 4; j++)
+        _mm_storeu_si128((__m128i *)sums + j, sum[j]);
+
+    FUNCTION_TEST_RETURN_VOID();
+}
+
+__attribute__((target("avx2"))) static void
+pageChecksumRowsAvx2(uint32_t *sums, const unsigned char *rows, unsigned int rowTotal)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM_P(UINT32, sums);
+        FUNCTION_TEST_PARAM_P(UCHARDATA, rows);
+        FUNCTION_TEST_PARAM(UINT, rowTotal);
+    FUNCTION_TEST_END();
+
+    const __m256i prime = _mm256_set1_epi32(FNV_PRIME);
+    __m256i sum[N_SUMS / 8];
+
+    for (unsigned int j = 0; j < N_SUMS / 8; j++)
+        sum[j] = _mm256_loadu_si256((const __m256i *)sums + j);
+
+    for (unsigned int i = 0; i < rowTotal; i++)
+    {
+        const __m256i *row = (const __m256i *)(rows + i * ROW_SIZE);
+
+        for (unsigned int j = 0; j < N_SUMS / 8; j++)
+        {
+            __m256i temp = _mm256_xor_si256(sum[j], _mm256_loadu_si256(row + j));
+            sum[j] = _mm256_xor_si256(_mm256_mullo_epi32(temp, prime), _mm256_srli_epi32(temp, 17));
+        }
+    }
+
+    for (unsigned int j = 0; j < N_SUMS / 8; j++)
+        _mm256_storeu_si256((__m256i *)sums + j, sum[j]);
+
+    FUNCTION_TEST_RETURN_VOID();
+}
+
+__attribute__((target("avx512f"))) static void
+pageChecksumRowsAvx512(uint32_t *sums, const unsigned char *rows, unsigned int rowTotal)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM_P(UINT32, sums);
+        FUNCTION_TEST_PARAM_P(UCHARDATA, rows);
+        FUNCTION_TEST_PARAM(UINT, rowTotal);
+    FUNCTION_TEST_END();
+
+    const __m512i prime = _mm512_set1_epi32(FNV_PRIME);
+    __m512i sum[N_SUMS / 16];
+
+    for (unsigned int j = 0; j < N_SUMS / 16; j++)
+        sum[j] = _mm512_loadu_si512((const __m512i *)sums + j);
+
+    for (unsigned int i = 0; i < rowTotal; i++)
+    {
+        const __m512i *row = (const __m512i *)(rows + i * ROW_SIZE);
+
+        for (unsigned int j = 0; j < N_SUMS / 16; j++)
+        {
+            __m512i temp = _mm512_xor_si512(sum[j], _mm512_loadu_si512(row + j));
+            sum[j] = _mm512_xor_si512(_mm512_mullo_epi32(temp, prime), _mm512_srli_epi32(temp, 17));
+        }
+    }
+
+    for (unsigned int j = 0; j < N_SUMS / 16; j++)
+        _mm512_storeu_si512((__m512i *)sums + j, sum[j]);
+
+    FUNCTION_TEST_RETURN_VOID();
+}
+
+#endif // PAGE_CHECKSUM_X86
+
+/***********************************************************************************************************************************
+Implementations in order of preference from worst to best
+***********************************************************************************************************************************/
+typedef enum
+{
+    pageChecksumImplPortable,
+#ifdef PAGE_CHECKSUM_X86
+    pageChecksumImplSse41,
+    pageChecksumImplAvx2,
+    pageChecksumImplAvx512,
+#endif
+} PageChecksumImpl;
+
+static const struct PageChecksumImplLocal
+{
+    const char *name;                                               // Name for logging and benchmarks
+    PageChecksumRowsFunc rows;                                      // Function to add rows to the partial checksums
+} pageChecksumImplLocal[] =
+{
+    {.name = "portable", .rows = pageChecksumRowsPortable},
+#ifdef PAGE_CHECKSUM_X86
+    {.name = "sse4.1", .rows = pageChecksumRowsSse41},
+    {.name = "avx2", .rows = pageChecksumRowsAvx2},
+    {.name = "avx512", .rows = pageChecksumRowsAvx512},
+#endif
+};
+
+#define PAGE_CHECKSUM_IMPL_TOTAL (sizeof(pageChecksumImplLocal) / sizeof(pageChecksumImplLocal[0]))
+
+// Implementation selected for this CPU
+static PageChecksumRowsFunc pageChecksumRows = NULL;
+
+/***********************************************************************************************************************************
+Is the implementation supported by the CPU?
+***********************************************************************************************************************************/
+static bool
+pageChecksumImplSupported(PageChecksumImpl impl)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(ENUM, impl);
+    FUNCTION_TEST_END();
+
+    bool result = true;
+
+#ifdef PAGE_CHECKSUM_X86
+    __builtin_cpu_init();
+
+    switch (impl)
+    {
+        case pageChecksumImplPortable:
+            break;
+
+        case pageChecksumImplSse41:
+        {
+            result = __builtin_cpu_supports("sse4.1");
+            break;
+        }
+
+        case pageChecksumImplAvx2:
+        {
+            result = __builtin_cpu_supports("avx2");
+            break;
+        }
+
+        case pageChecksumImplAvx512:
+        {
+            result = __builtin_cpu_supports("avx512f");
+            break;
+        }
+    }
+#endif
+
+    FUNCTION_TEST_RETURN(result);
+}
+
+/***********************************************************************************************************************************
+Select the best implementation supported by the CPU
+***********************************************************************************************************************************/
+static PageChecksumImpl
+pageChecksumImplSelect(void)
+{
+    FUNCTION_TEST_VOID();
+
+    PageChecksumImpl result = (PageChecksumImpl)(PAGE_CHECKSUM_IMPL_TOTAL - 1);
+
+    while (!pageChecksumImplSupported(result))                      // {uncoverable - depends on the CPU running the test}
+        result--;                                                   // {+uncoverable}
+
+    FUNCTION_TEST_RETURN(result);
+}
+
 static uint32_t
 pageChecksumBlock(const unsigned char *page, unsigned int pageSize)
 {
@@ -142,27 +378,32 @@ pageChecksumBlock(const unsigned char *page, unsigned int pageSize)
     FUNCTION_TEST_END();
 
     ASSERT(page != NULL);
+    ASSERT(pageSize >= ROW_SIZE && pageSize % ROW_SIZE == 0);
+
+    if (pageChecksumRows == NULL)
+        pageChecksumRows = pageChecksumImplLocal[pageChecksumImplSelect()].rows;
 
     uint32_t sums[N_SUMS];
-    uint32_t (*dataArray)[N_SUMS] = (uint32_t (*)[N_SUMS])page;
     uint32_t result = 0;
-    uint32_t i, j;
 
     /* initialize partial checksums to their corresponding offsets */
     memcpy(sums, checksumBaseOffsets, sizeof(checksumBaseOffsets));
 
+    // The checksum is calculated as if pd_checksum were zero.  Copy the first row and zero pd_checksum in the copy rather than
+    // modifying the page, which may be read-only and is shared with the caller.
+    uint32_t rowFirst[N_SUMS];
+    memcpy(rowFirst, page, sizeof(rowFirst));
+    memset((unsigned char *)rowFirst + offsetof(PageHeaderData, pd_checksum), 0, sizeof(((PageHeaderData *)NULL)->pd_checksum));
+
     /* main checksum calculation */
-    for (i = 0; i < pageSize / sizeof(uint32_t) / N_SUMS; i++)
-        for (j = 0; j < N_SUMS; j++)
-            CHECKSUM_COMP(sums[j], dataArray[i][j]);
+    pageChecksumRows(sums, (const unsigned char *)rowFirst, 1);
+    pageChecksumRows(sums, page + ROW_SIZE, pageSize / ROW_SIZE - 1);
 
     /* finally add in two rounds of zeroes for additional mixing */
-    for (i = 0; i < 2; i++)
-        for (j = 0; j < N_SUMS; j++)
-            CHECKSUM_COMP(sums[j], 0);
+    pageChecksumRows(sums, (const unsigned char *)checksumZeroRows, 2);
 
     // xor fold partial checksums together
-    for (i = 0; i < N_SUMS; i++)
+    for (unsigned int i = 0; i < N_SUMS; i++)
         result ^= sums[i];
 
     FUNCTION_TEST_RETURN(result);
@@ -185,17 +426,8 @@ pageChecksum(const unsigned char *page, unsigned int blockNo, unsigned int pageS
 
     ASSERT(page != NULL);
 
-    // Save pd_checksum and temporarily set it to zero, so that the checksum calculation isn't affected by the old checksum stored
-    // on the page. Restore it after, because actually updating the checksum is NOT part of the API of this function.
-    PageHeader pageHeader = (PageHeader)page;
-
-    uint16_t originalChecksum = pageHeader->pd_checksum;
-    pageHeader->pd_checksum = 0;
-    uint32_t checksum = pageChecksumBlock(page, pageSize);
-    pageHeader->pd_checksum = originalChecksum;
-
-    // Mix in the block number to detect transposed pages
-    checksum ^= blockNo;
+    // Calculate the checksum without pd_checksum and mix in the block number to detect transposed pages
+    uint32_t checksum = pageChecksumBlock(page, pageSize) ^ blockNo;
 
     // Reduce to a uint16 with an offset of one. That avoids checksums of zero, which seems like a good idea.
     FUNCTION_TEST_RETURN((uint16_t)(checksum % 65535 + 1));
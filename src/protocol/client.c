@@ -8,17 +8,20 @@ Protocol Client
 #include "common/type/json.h"
 #include "common/type/keyValue.h"
 #include "protocol/client.h"
+#include "protocol/frame.h"
 #include "version.h"
 
 /***********************************************************************************************************************************
 Constants
 ***********************************************************************************************************************************/
+STRING_EXTERN(PROTOCOL_GREETING_FRAME_STR,                          PROTOCOL_GREETING_FRAME);
 STRING_EXTERN(PROTOCOL_GREETING_NAME_STR,                           PROTOCOL_GREETING_NAME);
 STRING_EXTERN(PROTOCOL_GREETING_SERVICE_STR,                        PROTOCOL_GREETING_SERVICE);
 STRING_EXTERN(PROTOCOL_GREETING_VERSION_STR,                        PROTOCOL_GREETING_VERSION);
 
-STRING_EXTERN(PROTOCOL_COMMAND_NOOP_STR,                            PROTOCOL_COMMAND_NOOP);
 STRING_EXTERN(PROTOCOL_COMMAND_EXIT_STR,                            PROTOCOL_COMMAND_EXIT);
+STRING_EXTERN(PROTOCOL_COMMAND_FRAME_STR,                           PROTOCOL_COMMAND_FRAME);
+STRING_EXTERN(PROTOCOL_COMMAND_NOOP_STR,                            PROTOCOL_COMMAND_NOOP);
 
 STRING_EXTERN(PROTOCOL_ERROR_STR,                                   PROTOCOL_ERROR);
 
@@ -35,6 +38,7 @@ struct ProtocolClient
     IoRead *read;
     IoWrite *write;
     TimeMSec keepAliveTime;
+    bool binary;                                                    // Are binary frames used instead of JSON?
 };
 
 /***********************************************************************************************************************************
@@ -68,6 +72,8 @@ protocolClientNew(const String *name, const String *service, IoRead *read, IoWri
         this->keepAliveTime = timeMSec();
 
         // Read, parse, and check the protocol greeting
+        bool frameBinary = false;
+
         MEM_CONTEXT_TEMP_BEGIN()
         {
             String *greeting = ioReadLine(this->read);
@@ -100,11 +106,30 @@ protocolClientNew(const String *name, const String *service, IoRead *read, IoWri
                         strPtr(expectedKey), strPtr(varStr(actualValue)));
                 }
             }
+
+            // Binary frames can be used if the server advertises them.  Older servers do not send this key.
+            const Variant *frame = kvGet(greetingKv, varNewStr(PROTOCOL_GREETING_FRAME_STR));
+            frameBinary = frame != NULL && varType(frame) == varTypeString && strEq(varStr(frame), PROTOCOL_FRAME_BINARY_STR);
         }
         MEM_CONTEXT_TEMP_END();
 
-        // Send one noop to catch any errors that might happen after the greeting
-        protocolClientNoOp(this);
+        // Request binary frames if available.  This also catches any errors that might happen after the greeting since the server
+        // responds (in JSON) before switching.
+        if (frameBinary)
+        {
+            MEM_CONTEXT_TEMP_BEGIN()
+            {
+                protocolClientExecute(
+                    this, protocolCommandParamAdd(protocolCommandNew(PROTOCOL_COMMAND_FRAME_STR), varNewStr(PROTOCOL_FRAME_BINARY_STR)),
+                    false);
+            }
+            MEM_CONTEXT_TEMP_END();
+
+            this->binary = true;
+        }
+        // Else send one noop to catch any errors that might happen after the greeting
+        else
+            protocolClientNoOp(this);
 
         // Set a callback to shutdown the protocol
         memContextCallback(this->memContext, (MemContextCallback)protocolClientFree, this);
@@ -114,6 +139,30 @@ protocolClientNew(const String *name, const String *service, IoRead *read, IoWri
     FUNCTION_LOG_RETURN(PROTOCOL_CLIENT, this);
 }
 
+/***********************************************************************************************************************************
+Throw an error received from the server
+***********************************************************************************************************************************/
+static void
+protocolClientError(ProtocolClient *this, const KeyValue *errorKv)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(PROTOCOL_CLIENT, this);
+        FUNCTION_TEST_PARAM(KEY_VALUE, errorKv);
+    FUNCTION_TEST_END();
+
+    ASSERT(this != NULL);
+    ASSERT(errorKv != NULL);
+
+    const Variant *error = kvGet(errorKv, varNewStr(PROTOCOL_ERROR_STR));
+    const String *message = varStr(kvGet(errorKv, varNewStr(PROTOCOL_OUTPUT_STR)));
+
+    THROWP_FMT(
+        errorTypeFromCode(varIntForce(error)), "%s: %s", strPtr(this->errorPrefix),
+        message == NULL ? "no details available" : strPtr(message));
+
+    FUNCTION_TEST_RETURN_VOID();
+}
+
 /***********************************************************************************************************************************
 Read the command output
 ***********************************************************************************************************************************/
@@ -131,33 +180,50 @@ protocolClientReadOutput(ProtocolClient *this, bool outputRequired)
 
     MEM_CONTEXT_TEMP_BEGIN()
     {
-        // Read the response
-        String *response = ioReadLine(this->read);
-        KeyValue *responseKv = varKv(jsonToVar(response));
+        if (this->binary)
+        {
+            // Read the response into the calling context when output is required so it does not need to be copied
+            ProtocolFrameType type;
 
-        // Process error if any
-        const Variant *error = kvGet(responseKv, varNewStr(PROTOCOL_ERROR_STR));
+            if (outputRequired)
+                memContextSwitch(MEM_CONTEXT_OLD());
 
-        if (error != NULL)
-        {
-            const String *message = varStr(kvGet(responseKv, varNewStr(PROTOCOL_OUTPUT_STR)));
+            result = protocolFrameRead(this->read, &type);
+            memContextSwitch(MEM_CONTEXT_TEMP());
 
-            THROWP_FMT(
-                errorTypeFromCode(varIntForce(error)), "%s: %s", strPtr(this->errorPrefix),
-                message == NULL ? "no details available" : strPtr(message));
-        }
+            // Process error if any
+            if (type == protocolFrameTypeError)
+                protocolClientError(this, varKv(result));
 
-        // Get output
-        result = kvGet(responseKv, varNewStr(PROTOCOL_OUTPUT_STR));
+            if (type != protocolFrameTypeResponse)
+                THROW_FMT(ProtocolError, "expected response frame but got '%c'", type);
 
-        if (outputRequired)
+            // If no output is required then there should not be any
+            if (!outputRequired && result != NULL)
+                THROW(AssertError, "no output required by command");
+        }
+        else
         {
-            // Just move the entire response kv since the output is the largest part if it
-            kvMove(responseKv, MEM_CONTEXT_OLD());
+            // Read the response
+            String *response = ioReadLine(this->read);
+            KeyValue *responseKv = varKv(jsonToVar(response));
+
+            // Process error if any
+            if (kvGet(responseKv, varNewStr(PROTOCOL_ERROR_STR)) != NULL)
+                protocolClientError(this, responseKv);
+
+            // Get output
+            result = kvGet(responseKv, varNewStr(PROTOCOL_OUTPUT_STR));
+
+            if (outputRequired)
+            {
+                // Just move the entire response kv since the output is the largest part if it
+                kvMove(responseKv, MEM_CONTEXT_OLD());
+            }
+            // Else if no output is required then there should not be any
+            else if (result != NULL)
+                THROW(AssertError, "no output required by command");
         }
-        // Else if no output is required then there should not be any
-        else if (result != NULL)
-            THROW(AssertError, "no output required by command");
 
         // Reset the keep alive time
         this->keepAliveTime = timeMSec();
@@ -182,7 +248,15 @@ protocolClientWriteCommand(ProtocolClient *this, const ProtocolCommand *command)
     ASSERT(command != NULL);
 
     // Write out the command
-    ioWriteLine(this->write, protocolCommandJson(command));
+    MEM_CONTEXT_TEMP_BEGIN()
+    {
+        if (this->binary)
+            protocolFrameWrite(this->write, protocolFrameTypeCommand, protocolCommandVar(command));
+        else
+            ioWriteLine(this->write, protocolCommandJson(command));
+    }
+    MEM_CONTEXT_TEMP_END();
+
     ioWriteFlush(this->write);
 
     // Reset the keep alive time
@@ -251,6 +325,21 @@ protocolClientNoOp(ProtocolClient *this)
     FUNCTION_LOG_RETURN_VOID();
 }
 
+/***********************************************************************************************************************************
+Are binary frames used instead of JSON?
+***********************************************************************************************************************************/
+bool
+protocolClientBinary(const ProtocolClient *this)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(PROTOCOL_CLIENT, this);
+    FUNCTION_TEST_END();
+
+    ASSERT(this != NULL);
+
+    FUNCTION_TEST_RETURN(this->binary);
+}
+
 /***********************************************************************************************************************************
 Get read interface
 ***********************************************************************************************************************************/
@@ -16,6 +16,8 @@ typedef struct ProtocolClient ProtocolClient;
 /***********************************************************************************************************************************
 Constants
 ***********************************************************************************************************************************/
+#define PROTOCOL_GREETING_FRAME                                     "frame"
+    STRING_DECLARE(PROTOCOL_GREETING_FRAME_STR);
 #define PROTOCOL_GREETING_NAME                                      "name"
     STRING_DECLARE(PROTOCOL_GREETING_NAME_STR);
 #define PROTOCOL_GREETING_SERVICE                                   "service"
@@ -25,6 +27,8 @@ Constants
 
 #define PROTOCOL_COMMAND_EXIT                                       "exit"
     STRING_DECLARE(PROTOCOL_COMMAND_EXIT_STR);
+#define PROTOCOL_COMMAND_FRAME                                      "frame"
+    STRING_DECLARE(PROTOCOL_COMMAND_FRAME_STR);
 #define PROTOCOL_COMMAND_NOOP                                       "noop"
     STRING_DECLARE(PROTOCOL_COMMAND_NOOP_STR);
 
@@ -51,6 +55,7 @@ void protocolClientWriteCommand(ProtocolClient *this, const ProtocolCommand *com
 /***********************************************************************************************************************************
 Getters
 ***********************************************************************************************************************************/
+bool protocolClientBinary(const ProtocolClient *this);
 IoRead *protocolClientIoRead(const ProtocolClient *this);
 IoWrite *protocolClientIoWrite(const ProtocolClient *this);
 
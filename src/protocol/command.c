@@ -97,7 +97,28 @@ protocolCommandMove(ProtocolCommand *this, MemContext *parentNew)
 }
 
 /***********************************************************************************************************************************
-Get write interface
+Get the command and parameters as a KeyValue variant
+***********************************************************************************************************************************/
+Variant *
+protocolCommandVar(const ProtocolCommand *this)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(PROTOCOL_COMMAND, this);
+    FUNCTION_TEST_END();
+
+    ASSERT(this != NULL);
+
+    Variant *result = varNewKv();
+    KeyValue *command = kvPut(varKv(result), varNewStr(PROTOCOL_KEY_COMMAND_STR), varNewStr(this->command));
+
+    if (this->parameterList != NULL)
+        kvPut(command, varNewStr(PROTOCOL_KEY_PARAMETER_STR), this->parameterList);
+
+    FUNCTION_TEST_RETURN(result);
+}
+
+/***********************************************************************************************************************************
+Get the command and parameters as JSON
 ***********************************************************************************************************************************/
 String *
 protocolCommandJson(const ProtocolCommand *this)
@@ -112,13 +133,10 @@ protocolCommandJson(const ProtocolCommand *this)
 
     MEM_CONTEXT_TEMP_BEGIN()
     {
-        KeyValue *command = kvPut(kvNew(), varNewStr(PROTOCOL_KEY_COMMAND_STR), varNewStr(this->command));
-
-        if (this->parameterList != NULL)
-            kvPut(command, varNewStr(PROTOCOL_KEY_PARAMETER_STR), this->parameterList);
+        Variant *command = protocolCommandVar(this);
 
         memContextSwitch(MEM_CONTEXT_OLD());
-        result = kvToJson(command, 0);
+        result = kvToJson(varKv(command), 0);
         memContextSwitch(MEM_CONTEXT_TEMP());
     }
     MEM_CONTEXT_TEMP_END();
@@ -34,6 +34,7 @@ ProtocolCommand *protocolCommandParamAdd(ProtocolCommand *this, const Variant *p
 Getters
 ***********************************************************************************************************************************/
 String *protocolCommandJson(const ProtocolCommand *this);
+Variant *protocolCommandVar(const ProtocolCommand *this);
 
 /***********************************************************************************************************************************
 Destructor
@@ -0,0 +1,572 @@
+/***********************************************************************************************************************************
+Protocol Binary Frame
+***********************************************************************************************************************************/
+#include <string.h>
+
+#include "common/debug.h"
+#include "common/log.h"
+#include "common/memContext.h"
+#include "common/type/keyValue.h"
+#include "common/type/variantList.h"
+#include "protocol/frame.h"
+
+/***********************************************************************************************************************************
+Constants
+***********************************************************************************************************************************/
+STRING_EXTERN(PROTOCOL_FRAME_BINARY_STR,                            PROTOCOL_FRAME_BINARY);
+
+#define PROTOCOL_FRAME_HEADER_SIZE                                  5
+#define PROTOCOL_FRAME_SIZE_INITIAL                                 256
+#define PROTOCOL_FRAME_SIZE_MAX                                     0xFFFFFFFF
+
+/***********************************************************************************************************************************
+Tags for typed data.  Each value starts with a tag which is followed by the fixed size value or, for strings and containers, a four
+byte size and the contents.
+***********************************************************************************************************************************/
+typedef enum
+{
+    protocolFrameTagNull = 'n',
+    protocolFrameTagBool = 'b',
+    protocolFrameTagDouble = 'd',
+    protocolFrameTagInt = 'i',
+    protocolFrameTagInt64 = 'I',
+    protocolFrameTagKeyValue = 'k',
+    protocolFrameTagString = 's',
+    protocolFrameTagUInt64 = 'U',
+    protocolFrameTagVariantList = 'l',
+} ProtocolFrameTag;
+
+/***********************************************************************************************************************************
+Append data to a frame
+
+The buffer is grown geometrically since bufCatC() only grows the buffer enough for the data being added.
+***********************************************************************************************************************************/
+static void
+protocolFrameCat(Buffer *frame, const void *data, size_t size)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(BUFFER, frame);
+        FUNCTION_TEST_PARAM_P(VOID, data);
+        FUNCTION_TEST_PARAM(SIZE, size);
+    FUNCTION_TEST_END();
+
+    ASSERT(frame != NULL);
+    ASSERT(data != NULL || size == 0);
+
+    if (bufUsed(frame) + size > bufSize(frame))
+        bufResize(frame, (bufUsed(frame) + size) * 2);
+
+    bufCatC(frame, (const unsigned char *)data, 0, size);
+
+    FUNCTION_TEST_RETURN_VOID();
+}
+
+static void
+protocolFrameCatUInt32(Buffer *frame, uint32_t value)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(BUFFER, frame);
+        FUNCTION_TEST_PARAM(UINT32, value);
+    FUNCTION_TEST_END();
+
+    unsigned char data[4] =
+    {
+        (unsigned char)(value >> 24), (unsigned char)(value >> 16), (unsigned char)(value >> 8), (unsigned char)value,
+    };
+
+    protocolFrameCat(frame, data, sizeof(data));
+
+    FUNCTION_TEST_RETURN_VOID();
+}
+
+static void
+protocolFrameCatUInt64(Buffer *frame, uint64_t value)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(BUFFER, frame);
+        FUNCTION_TEST_PARAM(UINT64, value);
+    FUNCTION_TEST_END();
+
+    protocolFrameCatUInt32(frame, (uint32_t)(value >> 32));
+    protocolFrameCatUInt32(frame, (uint32_t)value);
+
+    FUNCTION_TEST_RETURN_VOID();
+}
+
+static void
+protocolFrameCatSize(Buffer *frame, size_t size)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(BUFFER, frame);
+        FUNCTION_TEST_PARAM(SIZE, size);
+    FUNCTION_TEST_END();
+
+    ASSERT(size <= PROTOCOL_FRAME_SIZE_MAX);
+
+    protocolFrameCatUInt32(frame, (uint32_t)size);
+
+    FUNCTION_TEST_RETURN_VOID();
+}
+
+/***********************************************************************************************************************************
+Encode a variant into a frame
+***********************************************************************************************************************************/
+static void
+protocolFrameEncode(Buffer *frame, const Variant *data)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(BUFFER, frame);
+        FUNCTION_TEST_PARAM(VARIANT, data);
+    FUNCTION_TEST_END();
+
+    ASSERT(frame != NULL);
+
+    unsigned char tag = protocolFrameTagNull;
+
+    if (data == NULL)
+        protocolFrameCat(frame, &tag, 1);
+    else
+    {
+        switch (varType(data))
+        {
+            case varTypeBool:
+            {
+                unsigned char value = varBool(data);
+
+                tag = protocolFrameTagBool;
+                protocolFrameCat(frame, &tag, 1);
+                protocolFrameCat(frame, &value, 1);
+                break;
+            }
+
+            case varTypeDouble:
+            {
+                double value = varDbl(data);
+                uint64_t valueBits;
+                memcpy(&valueBits, &value, sizeof(valueBits));
+
+                tag = protocolFrameTagDouble;
+                protocolFrameCat(frame, &tag, 1);
+                protocolFrameCatUInt64(frame, valueBits);
+                break;
+            }
+
+            case varTypeInt:
+            {
+                tag = protocolFrameTagInt;
+                protocolFrameCat(frame, &tag, 1);
+                protocolFrameCatUInt32(frame, (uint32_t)varInt(data));
+                break;
+            }
+
+            case varTypeInt64:
+            {
+                tag = protocolFrameTagInt64;
+                protocolFrameCat(frame, &tag, 1);
+                protocolFrameCatUInt64(frame, (uint64_t)varInt64(data));
+                break;
+            }
+
+            case varTypeKeyValue:
+            {
+                const KeyValue *kv = varKv(data);
+                const VariantList *keyList = kvKeyList(kv);
+
+                tag = protocolFrameTagKeyValue;
+                protocolFrameCat(frame, &tag, 1);
+                protocolFrameCatSize(frame, varLstSize(keyList));
+
+                for (unsigned int keyIdx = 0; keyIdx < varLstSize(keyList); keyIdx++)
+                {
+                    const Variant *key = varLstGet(keyList, keyIdx);
+
+                    protocolFrameEncode(frame, key);
+                    protocolFrameEncode(frame, kvGet(kv, key));
+                }
+
+                break;
+            }
+
+            case varTypeString:
+            {
+                const String *value = varStr(data);
+
+                // A string variant can hold a NULL string so encode it as null
+                if (value != NULL)
+                {
+                    tag = protocolFrameTagString;
+                    protocolFrameCat(frame, &tag, 1);
+                    protocolFrameCatSize(frame, strSize(value));
+                    protocolFrameCat(frame, strPtr(value), strSize(value));
+                }
+                else
+                    protocolFrameCat(frame, &tag, 1);
+
+                break;
+            }
+
+            case varTypeUInt64:
+            {
+                tag = protocolFrameTagUInt64;
+                protocolFrameCat(frame, &tag, 1);
+                protocolFrameCatUInt64(frame, varUInt64(data));
+                break;
+            }
+
+            case varTypeVariantList:
+            {
+                const VariantList *list = varVarLst(data);
+
+                // A list variant can hold a NULL list so encode it as null
+                if (list != NULL)
+                {
+                    tag = protocolFrameTagVariantList;
+                    protocolFrameCat(frame, &tag, 1);
+                    protocolFrameCatSize(frame, varLstSize(list));
+
+                    for (unsigned int listIdx = 0; listIdx < varLstSize(list); listIdx++)
+                        protocolFrameEncode(frame, varLstGet(list, listIdx));
+                }
+                else
+                    protocolFrameCat(frame, &tag, 1);
+
+                break;
+            }
+        }
+    }
+
+    FUNCTION_TEST_RETURN_VOID();
+}
+
+/***********************************************************************************************************************************
+Decode a variant from a frame
+***********************************************************************************************************************************/
+typedef struct ProtocolFrameDecode
+{
+    const Buffer *frame;                                            // Frame data (without header)
+    size_t position;                                                // Current position in the frame
+} ProtocolFrameDecode;
+
+static const unsigned char *
+protocolFrameDecodeData(ProtocolFrameDecode *decode, size_t size)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM_P(VOID, decode);
+        FUNCTION_TEST_PARAM(SIZE, size);
+    FUNCTION_TEST_END();
+
+    ASSERT(decode != NULL);
+
+    if (bufUsed(decode->frame) - decode->position < size)
+        THROW(ProtocolError, "frame data is truncated");
+
+    const unsigned char *result = bufPtr(decode->frame) + decode->position;
+    decode->position += size;
+
+    FUNCTION_TEST_RETURN(result);
+}
+
+static uint32_t
+protocolFrameDecodeUInt32(ProtocolFrameDecode *decode)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM_P(VOID, decode);
+    FUNCTION_TEST_END();
+
+    const unsigned char *data = protocolFrameDecodeData(decode, 4);
+
+    FUNCTION_TEST_RETURN(
+        (uint32_t)data[0] << 24 | (uint32_t)data[1] << 16 | (uint32_t)data[2] << 8 | (uint32_t)data[3]);
+}
+
+static uint64_t
+protocolFrameDecodeUInt64(ProtocolFrameDecode *decode)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM_P(VOID, decode);
+    FUNCTION_TEST_END();
+
+    uint64_t result = (uint64_t)protocolFrameDecodeUInt32(decode) << 32;
+    result |= protocolFrameDecodeUInt32(decode);
+
+    FUNCTION_TEST_RETURN(result);
+}
+
+static Variant *
+protocolFrameDecode(ProtocolFrameDecode *decode)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM_P(VOID, decode);
+    FUNCTION_TEST_END();
+
+    ASSERT(decode != NULL);
+
+    Variant *result = NULL;
+    unsigned char tag = *protocolFrameDecodeData(decode, 1);
+
+    switch (tag)
+    {
+        case protocolFrameTagNull:
+            break;
+
+        case protocolFrameTagBool:
+        {
+            result = varNewBool(*protocolFrameDecodeData(decode, 1) != 0);
+            break;
+        }
+
+        case protocolFrameTagDouble:
+        {
+            uint64_t valueBits = protocolFrameDecodeUInt64(decode);
+            double value;
+            memcpy(&value, &valueBits, sizeof(value));
+
+            result = varNewDbl(value);
+            break;
+        }
+
+        case protocolFrameTagInt:
+        {
+            result = varNewInt((int)protocolFrameDecodeUInt32(decode));
+            break;
+        }
+
+        case protocolFrameTagInt64:
+        {
+            result = varNewInt64((int64_t)protocolFrameDecodeUInt64(decode));
+            break;
+        }
+
+        case protocolFrameTagKeyValue:
+        {
+            result = varNewKv();
+            KeyValue *kv = varKv(result);
+            uint32_t size = protocolFrameDecodeUInt32(decode);
+
+            for (uint32_t keyIdx = 0; keyIdx < size; keyIdx++)
+            {
+                Variant *key = protocolFrameDecode(decode);
+
+                if (key == NULL)
+                    THROW(ProtocolError, "frame key must not be null");
+
+                kvPut(kv, key, protocolFrameDecode(decode));
+            }
+
+            break;
+        }
+
+        case protocolFrameTagString:
+        {
+            uint32_t size = protocolFrameDecodeUInt32(decode);
+
+            result = varNewStr(strNewN((const char *)protocolFrameDecodeData(decode, size), size));
+            break;
+        }
+
+        case protocolFrameTagUInt64:
+        {
+            result = varNewUInt64(protocolFrameDecodeUInt64(decode));
+            break;
+        }
+
+        case protocolFrameTagVariantList:
+        {
+            result = varNewVarLst(varLstNew());
+            VariantList *list = varVarLst(result);
+            uint32_t size = protocolFrameDecodeUInt32(decode);
+
+            for (uint32_t listIdx = 0; listIdx < size; listIdx++)
+                varLstAdd(list, protocolFrameDecode(decode));
+
+            break;
+        }
+
+        default:
+            THROW_FMT(ProtocolError, "invalid frame data tag '%c'", tag);
+    }
+
+    FUNCTION_TEST_RETURN(result);
+}
+
+/***********************************************************************************************************************************
+Read a frame header
+***********************************************************************************************************************************/
+static ProtocolFrameType
+protocolFrameReadHeader(IoRead *read, size_t *size)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(IO_READ, read);
+        FUNCTION_TEST_PARAM_P(SIZE, size);
+    FUNCTION_TEST_END();
+
+    ASSERT(read != NULL);
+    ASSERT(size != NULL);
+
+    Buffer *headerBuffer = bufNew(PROTOCOL_FRAME_HEADER_SIZE);
+
+    if (ioRead(read, headerBuffer) != PROTOCOL_FRAME_HEADER_SIZE)
+        THROW(ProtocolError, "unexpected eof while reading frame");
+
+    ProtocolFrameDecode decode = {.frame = headerBuffer};
+    ProtocolFrameType result = (ProtocolFrameType)*protocolFrameDecodeData(&decode, 1);
+    *size = protocolFrameDecodeUInt32(&decode);
+
+    bufFree(headerBuffer);
+
+    FUNCTION_TEST_RETURN(result);
+}
+
+/***********************************************************************************************************************************
+Read a command, response, or error frame and return the data
+***********************************************************************************************************************************/
+Variant *
+protocolFrameRead(IoRead *read, ProtocolFrameType *type)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(IO_READ, read);
+        FUNCTION_LOG_PARAM_P(ENUM, type);
+    FUNCTION_LOG_END();
+
+    ASSERT(read != NULL);
+    ASSERT(type != NULL);
+
+    Variant *result = NULL;
+
+    MEM_CONTEXT_TEMP_BEGIN()
+    {
+        size_t size = 0;
+        *type = protocolFrameReadHeader(read, &size);
+
+        if (*type != protocolFrameTypeCommand && *type != protocolFrameTypeError && *type != protocolFrameTypeResponse)
+            THROW_FMT(ProtocolError, "invalid frame type '%c'", *type);
+
+        if (size > PROTOCOL_FRAME_READ_SIZE_MAX)
+            THROW_FMT(ProtocolError, "frame size %zu exceeds maximum of %d bytes", size, PROTOCOL_FRAME_READ_SIZE_MAX);
+
+        Buffer *frame = bufNew(size);
+
+        if (ioRead(read, frame) != size)
+            THROW(ProtocolError, "unexpected eof while reading frame");
+
+        // Decode the data directly into the calling context to avoid a copy and make sure it used the entire frame
+        ProtocolFrameDecode decode = {.frame = frame};
+
+        memContextSwitch(MEM_CONTEXT_OLD());
+        result = protocolFrameDecode(&decode);
+        memContextSwitch(MEM_CONTEXT_TEMP());
+
+        if (decode.position != size)
+            THROW(ProtocolError, "frame has unexpected data after value");
+    }
+    MEM_CONTEXT_TEMP_END();
+
+    FUNCTION_LOG_RETURN(VARIANT, result);
+}
+
+/***********************************************************************************************************************************
+Read a block frame header and return the size of the block.  The caller reads the block data.
+***********************************************************************************************************************************/
+size_t
+protocolFrameReadBlock(IoRead *read)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(IO_READ, read);
+    FUNCTION_LOG_END();
+
+    ASSERT(read != NULL);
+
+    size_t result = 0;
+
+    if (protocolFrameReadHeader(read, &result) != protocolFrameTypeBlock)
+        THROW(ProtocolError, "expected block frame");
+
+    FUNCTION_LOG_RETURN(SIZE, result);
+}
+
+/***********************************************************************************************************************************
+Write a command, response, or error frame.  The caller is responsible for flushing.
+***********************************************************************************************************************************/
+void
+protocolFrameWrite(IoWrite *write, ProtocolFrameType type, const Variant *data)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(IO_WRITE, write);
+        FUNCTION_LOG_PARAM(ENUM, type);
+        FUNCTION_LOG_PARAM(VARIANT, data);
+    FUNCTION_LOG_END();
+
+    ASSERT(write != NULL);
+    ASSERT(type == protocolFrameTypeCommand || type == protocolFrameTypeError || type == protocolFrameTypeResponse);
+
+    MEM_CONTEXT_TEMP_BEGIN()
+    {
+        // Reserve space for the header and encode the data
+        Buffer *frame = bufNew(PROTOCOL_FRAME_SIZE_INITIAL);
+        bufUsedSet(frame, PROTOCOL_FRAME_HEADER_SIZE);
+
+        protocolFrameEncode(frame, data);
+
+        // Write the header now that the size is known
+        size_t size = bufUsed(frame) - PROTOCOL_FRAME_HEADER_SIZE;
+
+        bufUsedZero(frame);
+        protocolFrameCat(frame, &(unsigned char){(unsigned char)type}, 1);
+        protocolFrameCatSize(frame, size);
+        bufUsedSet(frame, PROTOCOL_FRAME_HEADER_SIZE + size);
+
+        ioWrite(write, frame);
+    }
+    MEM_CONTEXT_TEMP_END();
+
+    FUNCTION_LOG_RETURN_VOID();
+}
+
+/***********************************************************************************************************************************
+Write a block frame header.  The caller must write exactly size bytes of block data after the header, which allows the data to be
+sent without passing through an IoWrite buffer.  The caller is responsible for flushing.
+***********************************************************************************************************************************/
+void
+protocolFrameWriteBlockSize(IoWrite *write, size_t size)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(IO_WRITE, write);
+        FUNCTION_LOG_PARAM(SIZE, size);
+    FUNCTION_LOG_END();
+
+    ASSERT(write != NULL);
+
+    MEM_CONTEXT_TEMP_BEGIN()
+    {
+        Buffer *header = bufNew(PROTOCOL_FRAME_HEADER_SIZE);
+
+        protocolFrameCat(header, &(unsigned char){protocolFrameTypeBlock}, 1);
+        protocolFrameCatSize(header, size);
+
+        ioWrite(write, header);
+    }
+    MEM_CONTEXT_TEMP_END();
+
+    FUNCTION_LOG_RETURN_VOID();
+}
+
+/***********************************************************************************************************************************
+Write a block frame.  A NULL or empty block indicates that there are no more blocks.  The caller is responsible for flushing.
+***********************************************************************************************************************************/
+void
+protocolFrameWriteBlock(IoWrite *write, const Buffer *block)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(IO_WRITE, write);
+        FUNCTION_LOG_PARAM(BUFFER, block);
+    FUNCTION_LOG_END();
+
+    ASSERT(write != NULL);
+
+    protocolFrameWriteBlockSize(write, block == NULL ? 0 : bufUsed(block));
+
+    if (block != NULL && bufUsed(block) > 0)
+        ioWrite(write, block);
+
+    FUNCTION_LOG_RETURN_VOID();
+}
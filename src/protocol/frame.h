@@ -0,0 +1,45 @@
+/***********************************************************************************************************************************
+Protocol Binary Frame
+
+Frames replace JSON lines when both sides of the protocol support them (negotiated after the greeting).  Each frame starts with a one
+byte type and a four byte size in network byte order.  Command, response, and error frames are followed by a typed encoding of their
+data, which avoids rendering and parsing JSON.  Block frames are followed by raw data.
+***********************************************************************************************************************************/
+#ifndef PROTOCOL_FRAME_H
+#define PROTOCOL_FRAME_H
+
+#include "common/io/read.h"
+#include "common/io/write.h"
+#include "common/type/variant.h"
+
+/***********************************************************************************************************************************
+Frame type enum
+***********************************************************************************************************************************/
+typedef enum
+{
+    protocolFrameTypeBlock = 'B',                                   // Block of raw data (zero size means no more blocks)
+    protocolFrameTypeCommand = 'C',                                 // Command with parameters
+    protocolFrameTypeError = 'E',                                   // Error code and message
+    protocolFrameTypeResponse = 'R',                                // Response with optional output
+} ProtocolFrameType;
+
+/***********************************************************************************************************************************
+Constants
+***********************************************************************************************************************************/
+#define PROTOCOL_FRAME_BINARY                                       "binary"
+    STRING_DECLARE(PROTOCOL_FRAME_BINARY_STR);
+
+// Largest command, response, or error frame that will be read.  The size comes from the remote so it must be limited before the
+// frame buffer is allocated.  Block frames are not limited since their data is streamed by the caller.
+#define PROTOCOL_FRAME_READ_SIZE_MAX                                (64 * 1024 * 1024)
+
+/***********************************************************************************************************************************
+Functions
+***********************************************************************************************************************************/
+Variant *protocolFrameRead(IoRead *read, ProtocolFrameType *type);
+size_t protocolFrameReadBlock(IoRead *read);
+void protocolFrameWrite(IoWrite *write, ProtocolFrameType type, const Variant *data);
+void protocolFrameWriteBlock(IoWrite *write, const Buffer *block);
+void protocolFrameWriteBlockSize(IoWrite *write, size_t size);
+
+#endif
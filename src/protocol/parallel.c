@@ -1,7 +1,7 @@
 /***********************************************************************************************************************************
 Protocol Parallel Executor
 ***********************************************************************************************************************************/
-#include <sys/select.h>
+#include <poll.h>
 
 #include "common/debug.h"
 #include "common/log.h"
@@ -19,25 +19,40 @@ struct ProtocolParallel
 {
     MemContext *memContext;
     TimeMSec timeout;                                               // Max time to wait for jobs before returning
+    unsigned int clientJobMax;                                      // Max jobs sent to each client before results are read
 
     List *clientList;                                               // List of clients to process jobs
-    List *jobList;                                                  // List of jobs to be processed
-
-    ProtocolParallelJob **clientJobList;                            // Jobs being processing by each client
+    List *jobList;                                                  // List of jobs to be processed (in the order added)
+    unsigned int jobPendingIdx;                                     // Next job in jobList to be sent to a client
+    List *jobDoneList;                                              // List of jobs that are done (in the order completed)
+    unsigned int jobDoneIdx;                                        // Next job in jobDoneList to be returned
+
+    ProtocolParallelJob **clientJobList;                            // Jobs being processed by each client (clientJobMax per client)
+    unsigned int *clientJobIdx;                                     // Oldest job being processed by each client
+    unsigned int *clientJobTotal;                                   // Total jobs being processed by each client
+    unsigned int clientRunningTotal;                                // Clients that are running jobs
+    struct pollfd *pollList;                                        // Handles of clients that are running jobs
+    unsigned int *pollClientList;                                   // Client for each handle in pollList
 
     ProtocolParallelJobState state;                                 // Overall state of job processing
 };
 
 /***********************************************************************************************************************************
 Create object
+
+clientJobMax is the number of jobs that may be sent to a client before the results are read.  Values greater than one allow the next
+command to be waiting when the client finishes a job, which avoids a round trip per job when jobs are small.
 ***********************************************************************************************************************************/
 ProtocolParallel *
-protocolParallelNew(TimeMSec timeout)
+protocolParallelNew(TimeMSec timeout, unsigned int clientJobMax)
 {
     FUNCTION_LOG_BEGIN(logLevelTrace);
         FUNCTION_LOG_PARAM(UINT64, timeout);
+        FUNCTION_LOG_PARAM(UINT, clientJobMax);
     FUNCTION_LOG_END();
 
+    ASSERT(clientJobMax > 0);
+
     ProtocolParallel *this = NULL;
 
     MEM_CONTEXT_NEW_BEGIN("ProtocolParallel")
@@ -45,9 +60,11 @@ protocolParallelNew(TimeMSec timeout)
         this = memNew(sizeof(ProtocolParallel));
         this->memContext = memContextCurrent();
         this->timeout = timeout;
+        this->clientJobMax = clientJobMax;
 
         this->clientList = lstNew(sizeof(ProtocolClient *));
         this->jobList = lstNew(sizeof(ProtocolParallelJob *));
+        this->jobDoneList = lstNew(sizeof(ProtocolParallelJob *));
         this->state = protocolParallelJobStatePending;
     }
     MEM_CONTEXT_NEW_END();
@@ -101,6 +118,12 @@ protocolParallelJobAdd(ProtocolParallel *this, ProtocolParallelJob *job)
 
 /***********************************************************************************************************************************
 Process jobs
+
+Jobs are sent to clients in the order they were added and returned in the order they complete, so each job is handled in constant
+time no matter how many jobs are queued.  Clients are polled rather than selected so there is no limit on the value of the handles.
+
+Each client may be processing up to clientJobMax jobs.  A client returns results in the order the jobs were sent so the oldest job is
+always the one that completes.
 ***********************************************************************************************************************************/
 unsigned int
 protocolParallelProcess(ProtocolParallel *this)
@@ -119,104 +142,115 @@ protocolParallelProcess(ProtocolParallel *this)
     {
         MEM_CONTEXT_BEGIN(this->memContext)
         {
-            this->clientJobList = (ProtocolParallelJob **)memNew(sizeof(ProtocolParallelJob *) * lstSize(this->clientList));
+            this->clientJobList = (ProtocolParallelJob **)memNew(
+                sizeof(ProtocolParallelJob *) * lstSize(this->clientList) * this->clientJobMax);
+            this->clientJobIdx = (unsigned int *)memNew(sizeof(unsigned int) * lstSize(this->clientList));
+            this->clientJobTotal = (unsigned int *)memNew(sizeof(unsigned int) * lstSize(this->clientList));
+            this->pollList = (struct pollfd *)memNew(sizeof(struct pollfd) * lstSize(this->clientList));
+            this->pollClientList = (unsigned int *)memNew(sizeof(unsigned int) * lstSize(this->clientList));
         }
         MEM_CONTEXT_END();
 
         this->state = protocolParallelJobStateRunning;
     }
 
-    // Initialize the file descriptor set used for select
-    fd_set selectSet;
-    FD_ZERO(&selectSet);
-    int handleMax = -1;
-
-    // Find clients that are running jobs
-    unsigned int clientRunningTotal = 0;
-
-    for (unsigned int clientIdx = 0; clientIdx < lstSize(this->clientList); clientIdx++)
+    // If clients are running then wait for one to finish
+    if (this->clientRunningTotal > 0)
     {
-        if (this->clientJobList[clientIdx] != NULL)
-        {
-            int handle = ioReadHandle(protocolClientIoRead(*(ProtocolClient **)lstGet(this->clientList, clientIdx)));
-            FD_SET((unsigned int)handle, &selectSet);
+        // Build the list of handles for clients that are running jobs
+        nfds_t pollTotal = 0;
 
-            // Set the max handle
-            if (handle > handleMax)                                         // {+uncovered - handles are often in ascending order}
-                handleMax = handle;
+        for (unsigned int clientIdx = 0; clientIdx < lstSize(this->clientList); clientIdx++)
+        {
+            if (this->clientJobTotal[clientIdx] > 0)
+            {
+                this->pollList[pollTotal] = (struct pollfd)
+                {
+                    .fd = ioReadHandle(protocolClientIoRead(*(ProtocolClient **)lstGet(this->clientList, clientIdx))),
+                    .events = POLLIN,
+                };
 
-            clientRunningTotal++;
+                this->pollClientList[pollTotal] = clientIdx;
+                pollTotal++;
+            }
         }
-    }
-
-    // If clients are running then wait for one to finish
-    if (clientRunningTotal > 0)
-    {
-        // Initialize timeout struct used for select.  Recreate this structure each time since Linux (at least) will modify it.
-        struct timeval timeoutSelect;
-        timeoutSelect.tv_sec = (time_t)(this->timeout / MSEC_PER_SEC);
-        timeoutSelect.tv_usec = (time_t)(this->timeout % MSEC_PER_SEC * 1000);
 
         // Determine if there is data to be read
-        int completed = select(handleMax + 1, &selectSet, NULL, NULL, &timeoutSelect);
-        THROW_ON_SYS_ERROR(completed == -1, AssertError, "unable to select from parallel client(s)");
+        int completed = poll(this->pollList, pollTotal, (int)this->timeout);
+        THROW_ON_SYS_ERROR(completed == -1, AssertError, "unable to poll from parallel client(s)");
 
         // If any jobs have completed then get the results
-        if (completed > 0)
+        for (nfds_t pollIdx = 0; completed > 0 && pollIdx < pollTotal; pollIdx++)
         {
-            for (unsigned int clientIdx = 0; clientIdx < lstSize(this->clientList); clientIdx++)
+            if (this->pollList[pollIdx].revents != 0)
             {
-                ProtocolParallelJob *job = this->clientJobList[clientIdx];
+                unsigned int clientIdx = this->pollClientList[pollIdx];
+                ProtocolClient *client = *(ProtocolClient **)lstGet(this->clientList, clientIdx);
 
-                if (job != NULL &&
-                    FD_ISSET(
-                        (unsigned int)ioReadHandle(protocolClientIoRead(*(ProtocolClient **)lstGet(this->clientList, clientIdx))),
-                        &selectSet))
+                // Read results until there are no more complete results buffered.  The handle will not signal again for results
+                // that have already been read from it.
+                do
                 {
+                    ProtocolParallelJob **clientJob =
+                        &this->clientJobList[clientIdx * this->clientJobMax + this->clientJobIdx[clientIdx]];
+                    ProtocolParallelJob *job = *clientJob;
+
                     MEM_CONTEXT_TEMP_BEGIN()
                     {
                         TRY_BEGIN()
                         {
-                            protocolParallelJobResultSet(
-                                job, protocolClientReadOutput(*(ProtocolClient **)lstGet(this->clientList, clientIdx), true));
+                            protocolParallelJobResultSet(job, protocolClientReadOutput(client, true));
                         }
                         CATCH_ANY()
                         {
                             protocolParallelJobErrorSet(job, errorCode(), strNew(errorMessage()));
                         }
                         TRY_END();
-
-                        protocolParallelJobStateSet(job, protocolParallelJobStateDone);
-                        this->clientJobList[clientIdx] = NULL;
                     }
                     MEM_CONTEXT_TEMP_END();
+
+                    protocolParallelJobStateSet(job, protocolParallelJobStateDone);
+                    lstAdd(this->jobDoneList, &job);
+
+                    *clientJob = NULL;
+                    this->clientJobIdx[clientIdx] = (this->clientJobIdx[clientIdx] + 1) % this->clientJobMax;
+                    this->clientJobTotal[clientIdx]--;
+
+                    if (this->clientJobTotal[clientIdx] == 0)
+                        this->clientRunningTotal--;
+
+                    result++;
                 }
-            }
+                while (this->clientJobTotal[clientIdx] > 0 && ioReadLineBuffered(protocolClientIoRead(client)));
 
-            result = (unsigned int)completed;
+                completed--;
+            }
         }
     }
 
-    // Find new jobs to be run
-    for (unsigned int clientIdx = 0; clientIdx < lstSize(this->clientList); clientIdx++)
+    // Send pending jobs to clients.  Each client gets a job before any client gets another so jobs are spread evenly.
+    for (unsigned int clientJobTotal = 0; clientJobTotal < this->clientJobMax; clientJobTotal++)
     {
-        // If nothing is running for this client
-        if (this->clientJobList[clientIdx] == NULL)
+        for (unsigned int clientIdx = 0;
+             clientIdx < lstSize(this->clientList) && this->jobPendingIdx < lstSize(this->jobList); clientIdx++)
         {
-            for (unsigned int jobIdx = 0; jobIdx < lstSize(this->jobList); jobIdx++)
+            if (this->clientJobTotal[clientIdx] == clientJobTotal)
             {
-                ProtocolParallelJob *job = *(ProtocolParallelJob **)lstGet(this->jobList, jobIdx);
+                ProtocolParallelJob *job = *(ProtocolParallelJob **)lstGet(this->jobList, this->jobPendingIdx);
 
-                if (protocolParallelJobState(job) == protocolParallelJobStatePending)
-                {
-                    protocolClientWriteCommand(
-                        *(ProtocolClient **)lstGet(this->clientList, clientIdx), protocolParallelJobCommand(job));
+                protocolClientWriteCommand(
+                    *(ProtocolClient **)lstGet(this->clientList, clientIdx), protocolParallelJobCommand(job));
 
-                    protocolParallelJobStateSet(job, protocolParallelJobStateRunning);
-                    this->clientJobList[clientIdx] = job;
+                protocolParallelJobStateSet(job, protocolParallelJobStateRunning);
 
-                    break;
-                }
+                this->clientJobList[
+                    clientIdx * this->clientJobMax + (this->clientJobIdx[clientIdx] + clientJobTotal) % this->clientJobMax] = job;
+
+                if (this->clientJobTotal[clientIdx] == 0)
+                    this->clientRunningTotal++;
+
+                this->clientJobTotal[clientIdx]++;
+                this->jobPendingIdx++;
             }
         }
     }
@@ -239,21 +273,15 @@ protocolParallelResult(ProtocolParallel *this)
 
     ProtocolParallelJob *result = NULL;
 
-    // Find the next completed job
-    for (unsigned int jobIdx = 0; jobIdx < lstSize(this->jobList); jobIdx++)
+    // Get the next completed job
+    if (this->jobDoneIdx < lstSize(this->jobDoneList))
     {
-        ProtocolParallelJob *job = *(ProtocolParallelJob **)lstGet(this->jobList, jobIdx);
-
-        if (protocolParallelJobState(job) == protocolParallelJobStateDone)
-        {
-            result = protocolParallelJobMove(job, memContextCurrent());
-            lstRemove(this->jobList, jobIdx);
-            break;
-        }
+        result = protocolParallelJobMove(*(ProtocolParallelJob **)lstGet(this->jobDoneList, this->jobDoneIdx), memContextCurrent());
+        this->jobDoneIdx++;
     }
 
     // If all jobs have been returned then we are done
-    if (lstSize(this->jobList) == 0)
+    if (this->jobDoneIdx == lstSize(this->jobList))
         this->state = protocolParallelJobStateDone;
 
     FUNCTION_LOG_RETURN(PROTOCOL_PARALLEL_JOB, result);
@@ -280,7 +308,7 @@ protocolParallelToLog(const ProtocolParallel *this)
 {
     return strNewFmt(
         "{state: %s, clientTotal: %u, jobTotal: %u}", protocolParallelJobToConstZ(this->state), lstSize(this->clientList),
-        lstSize(this->jobList));
+        lstSize(this->jobList) - this->jobDoneIdx);
 }
 
 /***********************************************************************************************************************************
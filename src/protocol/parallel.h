@@ -16,7 +16,7 @@ typedef struct ProtocolParallel ProtocolParallel;
 /***********************************************************************************************************************************
 Constructor
 ***********************************************************************************************************************************/
-ProtocolParallel *protocolParallelNew(TimeMSec timeout);
+ProtocolParallel *protocolParallelNew(TimeMSec timeout, unsigned int clientJobMax);
 
 /***********************************************************************************************************************************
 Functions
@@ -9,6 +9,7 @@ Protocol Server
 #include "common/type/keyValue.h"
 #include "common/type/list.h"
 #include "protocol/client.h"
+#include "protocol/frame.h"
 #include "protocol/server.h"
 #include "version.h"
 
@@ -21,6 +22,7 @@ struct ProtocolServer
     const String *name;
     IoRead *read;
     IoWrite *write;
+    bool binary;                                                    // Are binary frames used instead of JSON?
 
     List *handlerList;
 };
@@ -62,6 +64,7 @@ protocolServerNew(const String *name, const String *service, IoRead *read, IoWri
             kvPut(greetingKv, varNewStr(PROTOCOL_GREETING_NAME_STR), varNewStr(strNew(PROJECT_NAME)));
             kvPut(greetingKv, varNewStr(PROTOCOL_GREETING_SERVICE_STR), varNewStr(service));
             kvPut(greetingKv, varNewStr(PROTOCOL_GREETING_VERSION_STR), varNewStr(strNew(PROJECT_VERSION)));
+            kvPut(greetingKv, varNewStr(PROTOCOL_GREETING_FRAME_STR), varNewStr(PROTOCOL_FRAME_BINARY_STR));
 
             ioWriteLine(this->write, kvToJson(greetingKv, 0));
             ioWriteFlush(this->write);
@@ -109,7 +112,19 @@ protocolServerProcess(ProtocolServer *this)
             MEM_CONTEXT_TEMP_BEGIN()
             {
                 // Read command
-                KeyValue *commandKv = varKv(jsonToVar(ioReadLine(this->read)));
+                KeyValue *commandKv = NULL;
+
+                if (this->binary)
+                {
+                    ProtocolFrameType type;
+                    commandKv = varKv(protocolFrameRead(this->read, &type));
+
+                    if (type != protocolFrameTypeCommand)
+                        THROW_FMT(ProtocolError, "expected command frame but got '%c'", type);
+                }
+                else
+                    commandKv = varKv(jsonToVar(ioReadLine(this->read)));
+
                 String *command = varStr(kvGet(commandKv, varNewStr(PROTOCOL_KEY_COMMAND_STR)));
                 VariantList *paramList = varVarLst(kvGet(commandKv, varNewStr(PROTOCOL_KEY_PARAMETER_STR)));
 
@@ -135,6 +150,17 @@ protocolServerProcess(ProtocolServer *this)
                         protocolServerResponse(this, NULL);
                     else if (strEq(command, PROTOCOL_COMMAND_EXIT_STR))
                         exit = true;
+                    else if (strEq(command, PROTOCOL_COMMAND_FRAME_STR))
+                    {
+                        const String *frame = varStr(varLstGet(paramList, 0));
+
+                        if (!strEq(frame, PROTOCOL_FRAME_BINARY_STR))
+                            THROW_FMT(ProtocolError, "invalid frame '%s'", strPtr(frame));
+
+                        // Respond in JSON before switching so the client knows the switch was successful
+                        protocolServerResponse(this, NULL);
+                        this->binary = true;
+                    }
                     else
                         THROW_FMT(ProtocolError, "invalid command '%s'", strPtr(command));
                 }
@@ -148,11 +174,15 @@ protocolServerProcess(ProtocolServer *this)
         }
         CATCH_ANY()
         {
-            KeyValue *error = kvNew();
-            kvPut(error, varNewStr(PROTOCOL_ERROR_STR), varNewInt(errorCode()));
-            kvPut(error, varNewStr(PROTOCOL_OUTPUT_STR), varNewStr(strNew(errorMessage())));
+            Variant *error = varNewKv();
+            kvPut(varKv(error), varNewStr(PROTOCOL_ERROR_STR), varNewInt(errorCode()));
+            kvPut(varKv(error), varNewStr(PROTOCOL_OUTPUT_STR), varNewStr(strNew(errorMessage())));
+
+            if (this->binary)
+                protocolFrameWrite(this->write, protocolFrameTypeError, error);
+            else
+                ioWriteLine(this->write, kvToJson(varKv(error), 0));
 
-            ioWriteLine(this->write, kvToJson(error, 0));
             ioWriteFlush(this->write);
         }
         TRY_END();
@@ -173,12 +203,25 @@ protocolServerResponse(ProtocolServer *this, const Variant *output)
         FUNCTION_LOG_PARAM(VARIANT, output);
     FUNCTION_LOG_END();
 
-    KeyValue *result = kvNew();
+    ASSERT(this != NULL);
 
-    if (output != NULL)
-        kvAdd(result, varNewStr(PROTOCOL_OUTPUT_STR), output);
+    MEM_CONTEXT_TEMP_BEGIN()
+    {
+        // Binary response frames contain only the output
+        if (this->binary)
+            protocolFrameWrite(this->write, protocolFrameTypeResponse, output);
+        else
+        {
+            KeyValue *result = kvNew();
+
+            if (output != NULL)
+                kvAdd(result, varNewStr(PROTOCOL_OUTPUT_STR), output);
+
+            ioWriteLine(this->write, kvToJson(result, 0));
+        }
+    }
+    MEM_CONTEXT_TEMP_END();
 
-    ioWriteLine(this->write, kvToJson(result, 0));
     ioWriteFlush(this->write);
 
     FUNCTION_LOG_RETURN_VOID();
@@ -203,6 +246,21 @@ protocolServerMove(ProtocolServer *this, MemContext *parentNew)
     FUNCTION_TEST_RETURN(this);
 }
 
+/***********************************************************************************************************************************
+Are binary frames used instead of JSON?
+***********************************************************************************************************************************/
+bool
+protocolServerBinary(const ProtocolServer *this)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(PROTOCOL_SERVER, this);
+    FUNCTION_TEST_END();
+
+    ASSERT(this != NULL);
+
+    FUNCTION_TEST_RETURN(this->binary);
+}
+
 /***********************************************************************************************************************************
 Get read interface
 ***********************************************************************************************************************************/
@@ -33,6 +33,7 @@ ProtocolServer *protocolServerMove(ProtocolServer *this, MemContext *parentNew);
 /***********************************************************************************************************************************
 Getters
 ***********************************************************************************************************************************/
+bool protocolServerBinary(const ProtocolServer *this);
 IoRead *protocolServerIoRead(const ProtocolServer *this);
 IoWrite *protocolServerIoWrite(const ProtocolServer *this);
 
@@ -0,0 +1,415 @@
+/***********************************************************************************************************************************
+Posix Storage File Async I/O
+
+The thread follows the rules in common/thread.h and only calls read() or write().  A failed call stops the thread and the saved
+errno is returned to the main thread by the next function that needs the thread to make progress.
+***********************************************************************************************************************************/
+#include <errno.h>
+#include <inttypes.h>
+#include <pthread.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "common/debug.h"
+#include "common/log.h"
+#include "common/memContext.h"
+#include "common/thread.h"
+#include "common/type/buffer.h"
+#include "storage/driver/posix/fileAsync.h"
+
+/***********************************************************************************************************************************
+Object type
+***********************************************************************************************************************************/
+typedef struct StorageDriverPosixFileAsyncBuffer
+{
+    unsigned char *data;                                            // Buffer data
+    size_t used;                                                    // Amount of data in the buffer
+} StorageDriverPosixFileAsyncBuffer;
+
+struct StorageDriverPosixFileAsync
+{
+    MemContext *memContext;                                         // Mem context
+    int handle;                                                     // File handle owned by the caller
+    bool write;                                                     // Write behind (else read ahead)?
+    size_t bufferSize;                                              // Size of each buffer in the ring
+    StorageDriverPosixFileAsyncBuffer bufferList[STORAGE_DRIVER_POSIX_FILE_ASYNC_BUFFER_TOTAL];
+
+    pthread_mutex_t mutex;                                          // Protects state shared with the thread
+    pthread_cond_t cond;                                            // Signalled when a buffer is filled or drained or on shutdown
+    pthread_t thread;                                               // Thread doing the I/O
+    bool shutdown;                                                  // Should the thread exit?
+
+    uint64_t fillTotal;                                             // Buffers filled (by the thread for read, else main thread)
+    uint64_t drainTotal;                                            // Buffers drained (by the main thread for read, else thread)
+    size_t drainOffset;                                             // Offset of data not yet read from the next read buffer
+    bool eof;                                                       // Has the thread reached the end of the file?
+    int error;                                                      // Error (errno) from the thread or 0 if none
+};
+
+/***********************************************************************************************************************************
+Read into free buffers until end of file, error, or shutdown
+
+This runs on a separate thread so it must only call read() and pthread functions.  A short read is considered to be the end of the
+file, the same as storageDriverPosixFileRead().  A read interrupted by a signal is retried.
+***********************************************************************************************************************************/
+static void *
+storageDriverPosixFileAsyncReader(void *param)
+{
+    StorageDriverPosixFileAsync *this = param;
+
+    pthread_mutex_lock(&this->mutex);
+
+    while (true)
+    {
+        // Wait for a free buffer
+        while (!this->shutdown && this->fillTotal - this->drainTotal == STORAGE_DRIVER_POSIX_FILE_ASYNC_BUFFER_TOTAL)
+            pthread_cond_wait(&this->cond, &this->mutex);
+
+        if (this->shutdown)
+            break;
+
+        StorageDriverPosixFileAsyncBuffer *buffer =
+            &this->bufferList[this->fillTotal % STORAGE_DRIVER_POSIX_FILE_ASYNC_BUFFER_TOTAL];
+
+        pthread_mutex_unlock(&this->mutex);
+
+        ssize_t actualBytes;
+        int error;
+
+        do
+        {
+            actualBytes = read(this->handle, buffer->data, this->bufferSize);
+            error = errno;
+        }
+        while (actualBytes == -1 && error == EINTR);
+
+        pthread_mutex_lock(&this->mutex);
+
+        if (actualBytes == -1)
+            this->error = error;
+        else
+        {
+            buffer->used = (size_t)actualBytes;
+            this->fillTotal++;
+            this->eof = (size_t)actualBytes != this->bufferSize;
+        }
+
+        pthread_cond_broadcast(&this->cond);
+
+        if (this->error != 0 || this->eof)
+            break;
+    }
+
+    pthread_mutex_unlock(&this->mutex);
+
+    return NULL;
+}
+
+/***********************************************************************************************************************************
+Write filled buffers until error or shutdown
+
+This runs on a separate thread so it must only call write() and pthread functions.  Buffers filled before shutdown are still written
+so that freeing the object has the same result as writing directly.  A short write is continued from the last byte written and a
+write interrupted by a signal is retried, so a buffer is only drained once all of it has been written.
+***********************************************************************************************************************************/
+static void *
+storageDriverPosixFileAsyncWriter(void *param)
+{
+    StorageDriverPosixFileAsync *this = param;
+
+    pthread_mutex_lock(&this->mutex);
+
+    while (true)
+    {
+        // Wait for a filled buffer
+        while (!this->shutdown && this->fillTotal == this->drainTotal)
+            pthread_cond_wait(&this->cond, &this->mutex);
+
+        if (this->fillTotal == this->drainTotal)
+            break;
+
+        StorageDriverPosixFileAsyncBuffer *buffer =
+            &this->bufferList[this->drainTotal % STORAGE_DRIVER_POSIX_FILE_ASYNC_BUFFER_TOTAL];
+
+        pthread_mutex_unlock(&this->mutex);
+
+        size_t writeOffset = 0;
+        int error = 0;
+
+        while (writeOffset < buffer->used)
+        {
+            ssize_t actualBytes = write(this->handle, buffer->data + writeOffset, buffer->used - writeOffset);
+
+            if (actualBytes == -1)
+            {
+                if (errno == EINTR)
+                    continue;
+
+                error = errno;
+                break;
+            }
+
+            writeOffset += (size_t)actualBytes;
+        }
+
+        pthread_mutex_lock(&this->mutex);
+
+        if (error == 0)
+            this->drainTotal++;
+        else
+            this->error = error;
+
+        pthread_cond_broadcast(&this->cond);
+
+        if (this->error != 0)
+            break;
+    }
+
+    pthread_mutex_unlock(&this->mutex);
+
+    return NULL;
+}
+
+/***********************************************************************************************************************************
+New object
+
+The handle must remain open until the object is freed and must not be used by the caller while the object exists.
+***********************************************************************************************************************************/
+StorageDriverPosixFileAsync *
+storageDriverPosixFileAsyncNew(int handle, bool write, size_t bufferSize)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(INT, handle);
+        FUNCTION_LOG_PARAM(BOOL, write);
+        FUNCTION_LOG_PARAM(SIZE, bufferSize);
+    FUNCTION_LOG_END();
+
+    ASSERT(handle != -1);
+    ASSERT(bufferSize > 0);
+
+    StorageDriverPosixFileAsync *this = NULL;
+
+    MEM_CONTEXT_NEW_BEGIN("StorageDriverPosixFileAsync")
+    {
+        this = memNew(sizeof(StorageDriverPosixFileAsync));
+        this->memContext = MEM_CONTEXT_NEW();
+        this->handle = handle;
+        this->write = write;
+        this->bufferSize = bufferSize;
+
+        for (unsigned int bufferIdx = 0; bufferIdx < STORAGE_DRIVER_POSIX_FILE_ASYNC_BUFFER_TOTAL; bufferIdx++)
+            this->bufferList[bufferIdx].data = memNewRaw(bufferSize);
+
+        threadError(pthread_mutex_init(&this->mutex, NULL), "init mutex");
+        threadError(pthread_cond_init(&this->cond, NULL), "init condition");
+
+        void *(*threadMain)(void *) = write ? storageDriverPosixFileAsyncWriter : storageDriverPosixFileAsyncReader;
+        threadError(pthread_create(&this->thread, NULL, threadMain, this), "create thread");
+
+        // Set free callback to ensure the thread is stopped
+        memContextCallback(this->memContext, (MemContextCallback)storageDriverPosixFileAsyncFree, this);
+    }
+    MEM_CONTEXT_NEW_END();
+
+    FUNCTION_LOG_RETURN(STORAGE_DRIVER_POSIX_FILE_ASYNC, this);
+}
+
+/***********************************************************************************************************************************
+Read data that has been read ahead into the remaining space in the buffer
+
+The buffer is filled unless the end of the file is reached.  Returns 0 on success or the error (errno) if the thread failed.
+***********************************************************************************************************************************/
+int
+storageDriverPosixFileAsyncRead(StorageDriverPosixFileAsync *this, Buffer *buffer)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(STORAGE_DRIVER_POSIX_FILE_ASYNC, this);
+        FUNCTION_LOG_PARAM(BUFFER, buffer);
+    FUNCTION_LOG_END();
+
+    ASSERT(this != NULL);
+    ASSERT(!this->write);
+    ASSERT(buffer != NULL);
+
+    int result = 0;
+
+    pthread_mutex_lock(&this->mutex);
+
+    while (bufRemains(buffer) > 0)
+    {
+        // Wait for a filled buffer
+        while (this->fillTotal == this->drainTotal && !this->eof && this->error == 0)
+            pthread_cond_wait(&this->cond, &this->mutex);
+
+        // Stop when there is nothing left to read.  An error is only returned once the data read before it has been returned.
+        if (this->fillTotal == this->drainTotal)
+        {
+            result = this->error;
+            break;
+        }
+
+        // Copy as much as possible from the filled buffer.  The thread does not touch filled buffers so the lock is not required.
+        StorageDriverPosixFileAsyncBuffer *fill =
+            &this->bufferList[this->drainTotal % STORAGE_DRIVER_POSIX_FILE_ASYNC_BUFFER_TOTAL];
+        size_t copySize = fill->used - this->drainOffset;
+
+        if (copySize > bufRemains(buffer))
+            copySize = bufRemains(buffer);
+
+        pthread_mutex_unlock(&this->mutex);
+
+        bufCatC(buffer, fill->data, this->drainOffset, copySize);
+
+        pthread_mutex_lock(&this->mutex);
+
+        this->drainOffset += copySize;
+
+        // Free the filled buffer for the thread when it is empty
+        if (this->drainOffset == fill->used)
+        {
+            this->drainTotal++;
+            this->drainOffset = 0;
+
+            pthread_cond_broadcast(&this->cond);
+        }
+    }
+
+    pthread_mutex_unlock(&this->mutex);
+
+    FUNCTION_LOG_RETURN(INT, result);
+}
+
+/***********************************************************************************************************************************
+Queue data to be written behind
+
+Returns 0 on success or the error (errno) if a prior write failed.  Use storageDriverPosixFileAsyncFlush() to wait for the data to
+be written.
+***********************************************************************************************************************************/
+int
+storageDriverPosixFileAsyncWrite(StorageDriverPosixFileAsync *this, const Buffer *buffer)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(STORAGE_DRIVER_POSIX_FILE_ASYNC, this);
+        FUNCTION_LOG_PARAM(BUFFER, buffer);
+    FUNCTION_LOG_END();
+
+    ASSERT(this != NULL);
+    ASSERT(this->write);
+    ASSERT(buffer != NULL);
+
+    int result = 0;
+    size_t bufferOffset = 0;
+
+    pthread_mutex_lock(&this->mutex);
+
+    while (bufferOffset < bufUsed(buffer))
+    {
+        // Wait for a free buffer
+        while (this->fillTotal - this->drainTotal == STORAGE_DRIVER_POSIX_FILE_ASYNC_BUFFER_TOTAL && this->error == 0)
+            pthread_cond_wait(&this->cond, &this->mutex);
+
+        if (this->error != 0)
+        {
+            result = this->error;
+            break;
+        }
+
+        // Fill the free buffer.  The thread does not touch free buffers so the lock is not required.
+        StorageDriverPosixFileAsyncBuffer *fill =
+            &this->bufferList[this->fillTotal % STORAGE_DRIVER_POSIX_FILE_ASYNC_BUFFER_TOTAL];
+        size_t copySize = bufUsed(buffer) - bufferOffset;
+
+        if (copySize > this->bufferSize)
+            copySize = this->bufferSize;
+
+        pthread_mutex_unlock(&this->mutex);
+
+        memcpy(fill->data, bufPtr(buffer) + bufferOffset, copySize);
+        fill->used = copySize;
+
+        pthread_mutex_lock(&this->mutex);
+
+        bufferOffset += copySize;
+        this->fillTotal++;
+
+        pthread_cond_broadcast(&this->cond);
+    }
+
+    pthread_mutex_unlock(&this->mutex);
+
+    FUNCTION_LOG_RETURN(INT, result);
+}
+
+/***********************************************************************************************************************************
+Wait for all queued data to be written
+
+Returns 0 on success or the error (errno) if a write failed.
+***********************************************************************************************************************************/
+int
+storageDriverPosixFileAsyncFlush(StorageDriverPosixFileAsync *this)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(STORAGE_DRIVER_POSIX_FILE_ASYNC, this);
+    FUNCTION_LOG_END();
+
+    ASSERT(this != NULL);
+    ASSERT(this->write);
+
+    pthread_mutex_lock(&this->mutex);
+
+    while (this->fillTotal != this->drainTotal && this->error == 0)
+        pthread_cond_wait(&this->cond, &this->mutex);
+
+    int result = this->error;
+
+    pthread_mutex_unlock(&this->mutex);
+
+    FUNCTION_LOG_RETURN(INT, result);
+}
+
+/***********************************************************************************************************************************
+Render as string for logging
+***********************************************************************************************************************************/
+String *
+storageDriverPosixFileAsyncToLog(const StorageDriverPosixFileAsync *this)
+{
+    return strNewFmt(
+        "{write: %s, bufferSize: %zu, fillTotal: %" PRIu64 ", drainTotal: %" PRIu64 ", eof: %s, error: %d}",
+        cvtBoolToConstZ(this->write), this->bufferSize, this->fillTotal, this->drainTotal, cvtBoolToConstZ(this->eof),
+        this->error);
+}
+
+/***********************************************************************************************************************************
+Free the object
+
+The thread is stopped after queued data has been written, but errors are ignored so call storageDriverPosixFileAsyncFlush() first
+if they need to be reported.
+***********************************************************************************************************************************/
+void
+storageDriverPosixFileAsyncFree(StorageDriverPosixFileAsync *this)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(STORAGE_DRIVER_POSIX_FILE_ASYNC, this);
+    FUNCTION_LOG_END();
+
+    if (this != NULL)
+    {
+        // Stop the thread.  It will finish the read in progress or the queued writes first.
+        pthread_mutex_lock(&this->mutex);
+
+        this->shutdown = true;
+        pthread_cond_broadcast(&this->cond);
+
+        pthread_mutex_unlock(&this->mutex);
+
+        pthread_join(this->thread, NULL);
+
+        pthread_cond_destroy(&this->cond);
+        pthread_mutex_destroy(&this->mutex);
+
+        memContextCallbackClear(this->memContext);
+        memContextFree(this->memContext);
+    }
+
+    FUNCTION_LOG_RETURN_VOID();
+}
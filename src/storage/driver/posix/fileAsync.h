@@ -0,0 +1,51 @@
+/***********************************************************************************************************************************
+Posix Storage File Async I/O
+
+Read ahead or write behind on a separate thread so disk I/O overlaps with the work done by the main thread, e.g. running filters and
+writing to the destination in storageCopy().  Data is passed through a small ring of buffers.  Functions return the error (errno)
+from the thread rather than throwing so the caller can report errors the same way it does for read() and write().
+***********************************************************************************************************************************/
+#ifndef STORAGE_DRIVER_POSIX_FILEASYNC_H
+#define STORAGE_DRIVER_POSIX_FILEASYNC_H
+
+/***********************************************************************************************************************************
+Object type
+***********************************************************************************************************************************/
+typedef struct StorageDriverPosixFileAsync StorageDriverPosixFileAsync;
+
+#include "common/type/buffer.h"
+#include "common/type/string.h"
+
+/***********************************************************************************************************************************
+Constants
+***********************************************************************************************************************************/
+#define STORAGE_DRIVER_POSIX_FILE_ASYNC_BUFFER_TOTAL                4
+
+/***********************************************************************************************************************************
+Constructor
+***********************************************************************************************************************************/
+StorageDriverPosixFileAsync *storageDriverPosixFileAsyncNew(int handle, bool write, size_t bufferSize);
+
+/***********************************************************************************************************************************
+Functions
+***********************************************************************************************************************************/
+int storageDriverPosixFileAsyncRead(StorageDriverPosixFileAsync *this, Buffer *buffer);
+int storageDriverPosixFileAsyncWrite(StorageDriverPosixFileAsync *this, const Buffer *buffer);
+int storageDriverPosixFileAsyncFlush(StorageDriverPosixFileAsync *this);
+
+/***********************************************************************************************************************************
+Destructor
+***********************************************************************************************************************************/
+void storageDriverPosixFileAsyncFree(StorageDriverPosixFileAsync *this);
+
+/***********************************************************************************************************************************
+Macros for function logging
+***********************************************************************************************************************************/
+String *storageDriverPosixFileAsyncToLog(const StorageDriverPosixFileAsync *this);
+
+#define FUNCTION_LOG_STORAGE_DRIVER_POSIX_FILE_ASYNC_TYPE                                                                          \
+    StorageDriverPosixFileAsync *
+#define FUNCTION_LOG_STORAGE_DRIVER_POSIX_FILE_ASYNC_FORMAT(value, buffer, bufferSize)                                             \
+    FUNCTION_LOG_STRING_OBJECT_FORMAT(value, storageDriverPosixFileAsyncToLog, buffer, bufferSize)
+
+#endif
@@ -2,13 +2,16 @@
 Posix Storage File Read Driver
 ***********************************************************************************************************************************/
 #include <fcntl.h>
+#include <inttypes.h>
 #include <unistd.h>
 
 #include "common/debug.h"
+#include "common/io/io.h"
 #include "common/io/read.intern.h"
 #include "common/log.h"
 #include "common/memContext.h"
 #include "storage/driver/posix/common.h"
+#include "storage/driver/posix/fileAsync.h"
 #include "storage/driver/posix/fileRead.h"
 #include "storage/fileRead.intern.h"
 
@@ -23,20 +26,27 @@ struct StorageDriverPosixFileRead
     IoRead *io;
     String *name;
     bool ignoreMissing;
+    uint64_t offset;                                                // Where to start reading in the file
+    Variant *limit;                                                 // Max bytes to read (NULL reads to the end of the file)
 
     int handle;
     bool eof;
+    uint64_t size;                                                  // Bytes read so far
+    StorageDriverPosixFileAsync *async;                             // Read ahead (started once the file is larger than a buffer)
 };
 
 /***********************************************************************************************************************************
 Create a new file
 ***********************************************************************************************************************************/
 StorageDriverPosixFileRead *
-storageDriverPosixFileReadNew(StorageDriverPosix *storage, const String *name, bool ignoreMissing)
+storageDriverPosixFileReadNew(
+    StorageDriverPosix *storage, const String *name, bool ignoreMissing, uint64_t offset, const Variant *limit)
 {
     FUNCTION_LOG_BEGIN(logLevelTrace);
         FUNCTION_LOG_PARAM(STRING, name);
         FUNCTION_LOG_PARAM(BOOL, ignoreMissing);
+        FUNCTION_LOG_PARAM(UINT64, offset);
+        FUNCTION_LOG_PARAM(VARIANT, limit);
     FUNCTION_LOG_END();
 
     ASSERT(name != NULL);
@@ -51,6 +61,8 @@ storageDriverPosixFileReadNew(StorageDriverPosix *storage, const String *name, b
         this->storage = storage;
         this->name = strDup(name);
         this->ignoreMissing = ignoreMissing;
+        this->offset = offset;
+        this->limit = varDup(limit);
 
         this->handle = -1;
 
@@ -63,6 +75,7 @@ storageDriverPosixFileReadNew(StorageDriverPosix *storage, const String *name, b
         this->io = ioReadNewP(
             this, .eof = (IoReadInterfaceEof)storageDriverPosixFileReadEof,
             .close = (IoReadInterfaceClose)storageDriverPosixFileReadClose,
+            .handle = (IoReadInterfaceHandle)storageDriverPosixFileReadHandle,
             .open = (IoReadInterfaceOpen)storageDriverPosixFileReadOpen, .read = (IoReadInterfaceRead)storageDriverPosixFileRead);
     }
     MEM_CONTEXT_NEW_END();
@@ -70,6 +83,26 @@ storageDriverPosixFileReadNew(StorageDriverPosix *storage, const String *name, b
     FUNCTION_LOG_RETURN(STORAGE_DRIVER_POSIX_FILE_READ, this);
 }
 
+/***********************************************************************************************************************************
+Free the file when the mem context is freed
+
+Child contexts are freed before the callback runs, so the async object has already stopped its thread and must not be freed again.
+***********************************************************************************************************************************/
+static void
+storageDriverPosixFileReadFreeCallback(StorageDriverPosixFileRead *this)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(STORAGE_DRIVER_POSIX_FILE_READ, this);
+    FUNCTION_TEST_END();
+
+    ASSERT(this != NULL);
+
+    this->async = NULL;
+    storageDriverPosixFileReadFree(this);
+
+    FUNCTION_TEST_RETURN_VOID();
+}
+
 /***********************************************************************************************************************************
 Open the file
 ***********************************************************************************************************************************/
@@ -91,7 +124,16 @@ storageDriverPosixFileReadOpen(StorageDriverPosixFileRead *this)
     // On success set free callback to ensure file handle is freed
     if (this->handle != -1)
     {
-        memContextCallback(this->memContext, (MemContextCallback)storageDriverPosixFileReadFree, this);
+        memContextCallback(this->memContext, (MemContextCallback)storageDriverPosixFileReadFreeCallback, this);
+
+        // Seek to the offset so the data before it is not read
+        if (this->offset > 0)
+        {
+            THROW_ON_SYS_ERROR_FMT(
+                lseek(this->handle, (off_t)this->offset, SEEK_SET) == -1, FileOpenError,
+                "unable to seek to %" PRIu64 " in '%s'", this->offset, strPtr(this->name));
+        }
+
         result = true;
     }
 
@@ -118,21 +160,57 @@ storageDriverPosixFileRead(StorageDriverPosixFileRead *this, Buffer *buffer, boo
 
     if (!this->eof)
     {
-        // Read and handle errors
         size_t expectedBytes = bufRemains(buffer);
-        actualBytes = read(this->handle, bufRemainsPtr(buffer), expectedBytes);
 
-        // Error occurred during read
-        if (actualBytes == -1)
-            THROW_SYS_ERROR_FMT(FileReadError, "unable to read '%s'", strPtr(this->name));
-
-        // Update amount of buffer used
-        bufUsedInc(buffer, (size_t)actualBytes);
+        // Do not read past the limit
+        if (this->limit != NULL && varUInt64(this->limit) - this->size < expectedBytes)
+            expectedBytes = (size_t)(varUInt64(this->limit) - this->size);
+
+        // Once a full buffer has been read start reading ahead on a separate thread so the next read overlaps with whatever the
+        // caller does with the data.  Smaller files are not worth starting a thread for.  Reads with a limit are not read ahead
+        // since the thread would read past the limit.
+        if (this->async == NULL && this->limit == NULL && this->size >= ioBufferSize())
+        {
+            MEM_CONTEXT_BEGIN(this->memContext)
+            {
+                this->async = storageDriverPosixFileAsyncNew(this->handle, false, ioBufferSize());
+            }
+            MEM_CONTEXT_END();
+        }
+
+        // Read from the read ahead buffers
+        if (this->async != NULL)
+        {
+            int error = storageDriverPosixFileAsyncRead(this->async, buffer);
+
+            if (error != 0)
+                THROW_SYS_ERROR_CODE_FMT(error, FileReadError, "unable to read '%s'", strPtr(this->name));
+
+            actualBytes = (ssize_t)(expectedBytes - bufRemains(buffer));
+        }
+        // Else read directly
+        else
+        {
+            actualBytes = read(this->handle, bufRemainsPtr(buffer), expectedBytes);
+
+            // Error occurred during read
+            if (actualBytes == -1)
+                THROW_SYS_ERROR_FMT(FileReadError, "unable to read '%s'", strPtr(this->name));
+
+            // Update amount of buffer used
+            bufUsedInc(buffer, (size_t)actualBytes);
+        }
+
+        this->size += (uint64_t)actualBytes;
 
         // If less data than expected was read then EOF.  The file may not actually be EOF but we are not concerned with files that
         // are growing.  Just read up to the point where the file is being extended.
         if ((size_t)actualBytes != expectedBytes)
             this->eof = true;
+
+        // Reaching the limit is also EOF
+        if (this->limit != NULL && this->size == varUInt64(this->limit))
+            this->eof = true;
     }
 
     FUNCTION_LOG_RETURN(SIZE, (size_t)actualBytes);
@@ -153,6 +231,10 @@ storageDriverPosixFileReadClose(StorageDriverPosixFileRead *this)
     // Close if the file has not already been closed
     if (this->handle != -1)
     {
+        // Stop reading ahead before the handle is closed
+        storageDriverPosixFileAsyncFree(this->async);
+        this->async = NULL;
+
         // Close the file
         storageDriverPosixFileClose(this->handle, this->name, true);
 
@@ -177,6 +259,21 @@ storageDriverPosixFileReadEof(const StorageDriverPosixFileRead *this)
     FUNCTION_TEST_RETURN(this->eof);
 }
 
+/***********************************************************************************************************************************
+Get handle (file descriptor)
+***********************************************************************************************************************************/
+int
+storageDriverPosixFileReadHandle(const StorageDriverPosixFileRead *this)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(STORAGE_DRIVER_POSIX_FILE_READ, this);
+    FUNCTION_TEST_END();
+
+    ASSERT(this != NULL);
+
+    FUNCTION_TEST_RETURN(this->handle);
+}
+
 /***********************************************************************************************************************************
 Should a missing file be ignored?
 ***********************************************************************************************************************************/
@@ -17,7 +17,8 @@ typedef struct StorageDriverPosixFileRead StorageDriverPosixFileRead;
 /***********************************************************************************************************************************
 Constructor
 ***********************************************************************************************************************************/
-StorageDriverPosixFileRead *storageDriverPosixFileReadNew(StorageDriverPosix *storage, const String *name, bool ignoreMissing);
+StorageDriverPosixFileRead *storageDriverPosixFileReadNew(
+    StorageDriverPosix *storage, const String *name, bool ignoreMissing, uint64_t offset, const Variant *limit);
 
 /***********************************************************************************************************************************
 Functions
@@ -30,6 +31,7 @@ void storageDriverPosixFileReadClose(StorageDriverPosixFileRead *this);
 Getters
 ***********************************************************************************************************************************/
 bool storageDriverPosixFileReadEof(const StorageDriverPosixFileRead *this);
+int storageDriverPosixFileReadHandle(const StorageDriverPosixFileRead *this);
 bool storageDriverPosixFileReadIgnoreMissing(const StorageDriverPosixFileRead *this);
 StorageFileRead *storageDriverPosixFileReadInterface(const StorageDriverPosixFileRead *this);
 IoRead *storageDriverPosixFileReadIo(const StorageDriverPosixFileRead *this);
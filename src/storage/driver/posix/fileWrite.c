@@ -6,10 +6,12 @@ Posix Storage File Write Driver
 #include <unistd.h>
 
 #include "common/debug.h"
+#include "common/io/io.h"
 #include "common/io/write.intern.h"
 #include "common/log.h"
 #include "common/memContext.h"
 #include "storage/driver/posix/common.h"
+#include "storage/driver/posix/fileAsync.h"
 #include "storage/driver/posix/fileWrite.h"
 #include "storage/fileWrite.intern.h"
 
@@ -34,6 +36,8 @@ struct StorageDriverPosixFileWrite
     bool atomic;
 
     int handle;
+    uint64_t size;                                                  // Bytes written so far
+    StorageDriverPosixFileAsync *async;                             // Write behind (started once the file is larger than a buffer)
 };
 
 /***********************************************************************************************************************************
@@ -87,6 +91,7 @@ storageDriverPosixFileWriteNew(
 
         this->io = ioWriteNewP(
             this, .close = (IoWriteInterfaceClose)storageDriverPosixFileWriteClose,
+            .flush = (IoWriteInterfaceFlush)storageDriverPosixFileWriteFlush,
             .open = (IoWriteInterfaceOpen)storageDriverPosixFileWriteOpen,
             .write = (IoWriteInterfaceWrite)storageDriverPosixFileWrite);
 
@@ -107,6 +112,26 @@ storageDriverPosixFileWriteNew(
     FUNCTION_LOG_RETURN(STORAGE_DRIVER_POSIX_FILE_WRITE, this);
 }
 
+/***********************************************************************************************************************************
+Free the file when the mem context is freed
+
+Child contexts are freed before the callback runs, so the async object has already stopped its thread and must not be freed again.
+***********************************************************************************************************************************/
+static void
+storageDriverPosixFileWriteFreeCallback(StorageDriverPosixFileWrite *this)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(STORAGE_DRIVER_POSIX_FILE_WRITE, this);
+    FUNCTION_TEST_END();
+
+    ASSERT(this != NULL);
+
+    this->async = NULL;
+    storageDriverPosixFileWriteFree(this);
+
+    FUNCTION_TEST_RETURN_VOID();
+}
+
 /***********************************************************************************************************************************
 Open the file
 ***********************************************************************************************************************************/
@@ -136,7 +161,7 @@ storageDriverPosixFileWriteOpen(StorageDriverPosixFileWrite *this)
     }
     // On success set free callback to ensure file handle is freed
     else
-        memContextCallback(this->memContext, (MemContextCallback)storageDriverPosixFileWriteFree, this);
+        memContextCallback(this->memContext, (MemContextCallback)storageDriverPosixFileWriteFreeCallback, this);
 
     FUNCTION_LOG_RETURN_VOID();
 }
@@ -156,10 +181,54 @@ storageDriverPosixFileWrite(StorageDriverPosixFileWrite *this, const Buffer *buf
     ASSERT(buffer != NULL);
     ASSERT(this->handle != -1);
 
-    // Write the data
-    if (write(this->handle, bufPtr(buffer), bufUsed(buffer)) != (ssize_t)bufUsed(buffer))
+    // Once a full buffer has been written start writing behind on a separate thread so writes overlap with whatever the caller does
+    // to produce the next buffer.  Smaller files are not worth starting a thread for.
+    if (this->async == NULL && this->size >= ioBufferSize())
+    {
+        MEM_CONTEXT_BEGIN(this->memContext)
+        {
+            this->async = storageDriverPosixFileAsyncNew(this->handle, true, ioBufferSize());
+        }
+        MEM_CONTEXT_END();
+    }
+
+    // Queue the data to be written behind
+    if (this->async != NULL)
+    {
+        int error = storageDriverPosixFileAsyncWrite(this->async, buffer);
+
+        if (error != 0)
+            THROW_SYS_ERROR_CODE_FMT(error, FileWriteError, "unable to write '%s'", strPtr(this->name));
+    }
+    // Else write the data directly
+    else if (write(this->handle, bufPtr(buffer), bufUsed(buffer)) != (ssize_t)bufUsed(buffer))
         THROW_SYS_ERROR_FMT(FileWriteError, "unable to write '%s'", strPtr(this->name));
 
+    this->size += bufUsed(buffer);
+
+    FUNCTION_LOG_RETURN_VOID();
+}
+
+/***********************************************************************************************************************************
+Wait for data being written behind to reach the file
+***********************************************************************************************************************************/
+void
+storageDriverPosixFileWriteFlush(StorageDriverPosixFileWrite *this)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(STORAGE_DRIVER_POSIX_FILE_WRITE, this);
+    FUNCTION_LOG_END();
+
+    ASSERT(this != NULL);
+
+    if (this->async != NULL)
+    {
+        int error = storageDriverPosixFileAsyncFlush(this->async);
+
+        if (error != 0)
+            THROW_SYS_ERROR_CODE_FMT(error, FileWriteError, "unable to write '%s'", strPtr(this->name));
+    }
+
     FUNCTION_LOG_RETURN_VOID();
 }
 
@@ -178,6 +247,11 @@ storageDriverPosixFileWriteClose(StorageDriverPosixFileWrite *this)
     // Close if the file has not already been closed
     if (this->handle != -1)
     {
+        // Wait for data being written behind and stop the thread
+        storageDriverPosixFileWriteFlush(this);
+        storageDriverPosixFileAsyncFree(this->async);
+        this->async = NULL;
+
         // Sync the file
         if (this->syncFile)
             storageDriverPosixFileSync(this->handle, this->name, true, false);
@@ -354,6 +428,9 @@ storageDriverPosixFileWriteFree(StorageDriverPosixFileWrite *this)
     {
         memContextCallbackClear(this->memContext);
 
+        // Finish writing behind before the handle is closed
+        storageDriverPosixFileAsyncFree(this->async);
+
         // Close the temp file.  *Close() must be called explicitly in order for the file to be sycn'ed, renamed, etc.  If *Free()
         // is called first the assumption is that some kind of error occurred and we should only close the handle to free
         // resources.
@@ -27,6 +27,7 @@ Functions
 ***********************************************************************************************************************************/
 void storageDriverPosixFileWriteOpen(StorageDriverPosixFileWrite *this);
 void storageDriverPosixFileWrite(StorageDriverPosixFileWrite *this, const Buffer *buffer);
+void storageDriverPosixFileWriteFlush(StorageDriverPosixFileWrite *this);
 void storageDriverPosixFileWriteClose(StorageDriverPosixFileWrite *this);
 
 /***********************************************************************************************************************************
@@ -4,7 +4,9 @@ Posix Storage Driver
 #include <dirent.h>
 #include <errno.h>
 #include <fcntl.h>
+#include <limits.h>
 #include <stdio.h>
+#include <string.h>
 #include <sys/stat.h>
 #include <unistd.h>
 
@@ -59,7 +61,8 @@ storageDriverPosixNew(
         this->interface = storageNewP(
             STORAGE_DRIVER_POSIX_TYPE_STR, path, modeFile, modePath, write, pathExpressionFunction, this,
             .exists = (StorageInterfaceExists)storageDriverPosixExists, .info = (StorageInterfaceInfo)storageDriverPosixInfo,
-            .list = (StorageInterfaceList)storageDriverPosixList, .move = (StorageInterfaceMove)storageDriverPosixMove,
+            .list = (StorageInterfaceList)storageDriverPosixList, .listEach = (StorageInterfaceListEach)storageDriverPosixListEach,
+            .move = (StorageInterfaceMove)storageDriverPosixMove,
             .newRead = (StorageInterfaceNewRead)storageDriverPosixNewRead,
             .newWrite = (StorageInterfaceNewWrite)storageDriverPosixNewWrite,
             .pathCreate = (StorageInterfacePathCreate)storageDriverPosixPathCreate,
@@ -104,6 +107,53 @@ storageDriverPosixExists(StorageDriverPosix *this, const String *path)
     FUNCTION_LOG_RETURN(BOOL, result);
 }
 
+/***********************************************************************************************************************************
+Load info from the results of a stat
+***********************************************************************************************************************************/
+static StorageInfo
+storageDriverPosixInfoStat(const String *file, const struct stat *statFile)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(STRING, file);
+        FUNCTION_TEST_PARAM_P(VOID, statFile);
+    FUNCTION_TEST_END();
+
+    ASSERT(file != NULL);
+    ASSERT(statFile != NULL);
+
+    StorageInfo result = {.exists = true};
+
+    if (S_ISREG(statFile->st_mode))
+    {
+        result.type = storageTypeFile;
+        result.size = (size_t)statFile->st_size;
+    }
+    else if (S_ISDIR(statFile->st_mode))
+        result.type = storageTypePath;
+    else if (S_ISLNK(statFile->st_mode))
+    {
+        result.type = storageTypeLink;
+
+        // Get the link destination
+        char linkDestination[PATH_MAX];
+        ssize_t linkDestinationSize = readlink(strPtr(file), linkDestination, sizeof(linkDestination) - 1);
+
+        if (linkDestinationSize == -1)
+            THROW_SYS_ERROR_FMT(FileReadError, "unable to get destination for link '%s'", strPtr(file));
+
+        result.linkDestination = strNewN(linkDestination, (size_t)linkDestinationSize);
+    }
+    else
+        THROW_FMT(FileInfoError, "invalid type for '%s'", strPtr(file));
+
+    result.mode = statFile->st_mode & (S_IRWXU | S_IRWXG | S_IRWXO);
+    result.userId = statFile->st_uid;
+    result.groupId = statFile->st_gid;
+    result.timeModified = statFile->st_mtime;
+
+    FUNCTION_TEST_RETURN(result);
+}
+
 /***********************************************************************************************************************************
 File/path info
 ***********************************************************************************************************************************/
@@ -131,23 +181,7 @@ storageDriverPosixInfo(StorageDriverPosix *this, const String *file, bool ignore
     }
     // On success load info into a structure
     else
-    {
-        result.exists = true;
-
-        if (S_ISREG(statFile.st_mode))
-        {
-            result.type = storageTypeFile;
-            result.size = (size_t)statFile.st_size;
-        }
-        else if (S_ISDIR(statFile.st_mode))
-            result.type = storageTypePath;
-        else if (S_ISLNK(statFile.st_mode))
-            result.type = storageTypeLink;
-        else
-            THROW_FMT(FileInfoError, "invalid type for '%s'", strPtr(file));
-
-        result.mode = statFile.st_mode & (S_IRWXU | S_IRWXG | S_IRWXO);
-    }
+        result = storageDriverPosixInfoStat(file, &statFile);
 
     FUNCTION_LOG_RETURN(STORAGE_INFO, result);
 }
@@ -224,6 +258,99 @@ storageDriverPosixList(StorageDriverPosix *this, const String *path, bool errorO
     FUNCTION_LOG_RETURN(STRING_LIST, result);
 }
 
+/***********************************************************************************************************************************
+Call a function for each file/path/link in a directory
+
+The name and full path are reused for each entry so no objects are allocated per entry and only the current entry is held in memory.
+***********************************************************************************************************************************/
+bool
+storageDriverPosixListEach(
+    StorageDriverPosix *this, const String *path, bool errorOnMissing, const String *expression, StorageListEachCallback callback,
+    void *callbackData)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(STORAGE_DRIVER_POSIX, this);
+        FUNCTION_LOG_PARAM(STRING, path);
+        FUNCTION_LOG_PARAM(BOOL, errorOnMissing);
+        FUNCTION_LOG_PARAM(STRING, expression);
+        FUNCTION_LOG_PARAM(FUNCTIONP, callback);
+        FUNCTION_LOG_PARAM_P(VOID, callbackData);
+    FUNCTION_LOG_END();
+
+    ASSERT(this != NULL);
+    ASSERT(path != NULL);
+    ASSERT(callback != NULL);
+
+    bool result = false;
+    DIR *dir = NULL;
+
+    TRY_BEGIN()
+    {
+        // Open the directory for read
+        dir = opendir(strPtr(path));
+
+        // If the directory could not be opened process errors but ignore missing directories when specified
+        if (!dir)
+        {
+            if (errorOnMissing || errno != ENOENT)
+                THROW_SYS_ERROR_FMT(PathOpenError, "unable to open path '%s' for read", strPtr(path));
+        }
+        else
+        {
+            result = true;
+
+            MEM_CONTEXT_TEMP_BEGIN()
+            {
+                // Prepare regexp if an expression was passed
+                RegExp *regExp = (expression == NULL) ? NULL : regExpNew(expression);
+
+                String *name = strNew("");
+                String *file = strNewFmt("%s/", strPtr(path));
+                int pathSize = (int)strSize(file);
+
+                // Read the directory entries
+                struct dirent *dirEntry = readdir(dir);
+
+                while (dirEntry != NULL)
+                {
+                    // Exclude current/parent directory
+                    if (strcmp(dirEntry->d_name, ".") != 0 && strcmp(dirEntry->d_name, "..") != 0)
+                    {
+                        strCat(strTrunc(name, 0), dirEntry->d_name);
+
+                        // Apply the expression if specified
+                        if (regExp == NULL || regExpMatch(regExp, name))
+                        {
+                            strCat(strTrunc(file, pathSize), dirEntry->d_name);
+                            struct stat statFile;
+
+                            // Skip entries that were removed after the directory was read
+                            if (lstat(strPtr(file), &statFile) == -1)
+                            {
+                                if (errno != ENOENT)
+                                    THROW_SYS_ERROR_FMT(FileOpenError, "unable to get info for '%s'", strPtr(file));
+                            }
+                            else
+                                callback(callbackData, name, storageDriverPosixInfoStat(file, &statFile));
+                        }
+                    }
+
+                    dirEntry = readdir(dir);
+                }
+            }
+            MEM_CONTEXT_TEMP_END();
+        }
+    }
+    FINALLY()
+    {
+        if (dir != NULL)
+            closedir(dir);
+    }
+    TRY_END();
+
+    FUNCTION_LOG_RETURN(BOOL, result);
+}
+
 /***********************************************************************************************************************************
 Move a path/file
 ***********************************************************************************************************************************/
@@ -296,19 +423,23 @@ storageDriverPosixMove(StorageDriverPosix *this, StorageDriverPosixFileRead *sou
 New file read object
 ***********************************************************************************************************************************/
 StorageFileRead *
-storageDriverPosixNewRead(StorageDriverPosix *this, const String *file, bool ignoreMissing)
+storageDriverPosixNewRead(
+    StorageDriverPosix *this, const String *file, bool ignoreMissing, uint64_t offset, const Variant *limit)
 {
     FUNCTION_LOG_BEGIN(logLevelTrace);
         FUNCTION_LOG_PARAM(STORAGE_DRIVER_POSIX, this);
         FUNCTION_LOG_PARAM(STRING, file);
         FUNCTION_LOG_PARAM(BOOL, ignoreMissing);
+        FUNCTION_LOG_PARAM(UINT64, offset);
+        FUNCTION_LOG_PARAM(VARIANT, limit);
     FUNCTION_LOG_END();
 
     ASSERT(this != NULL);
     ASSERT(file != NULL);
 
     FUNCTION_LOG_RETURN(
-        STORAGE_FILE_READ, storageDriverPosixFileReadInterface(storageDriverPosixFileReadNew(this, file, ignoreMissing)));
+        STORAGE_FILE_READ,
+        storageDriverPosixFileReadInterface(storageDriverPosixFileReadNew(this, file, ignoreMissing, offset, limit)));
 }
 
 /***********************************************************************************************************************************
@@ -36,8 +36,12 @@ Functions
 bool storageDriverPosixExists(StorageDriverPosix *this, const String *path);
 StorageInfo storageDriverPosixInfo(StorageDriverPosix *this, const String *file, bool ignoreMissing);
 StringList *storageDriverPosixList(StorageDriverPosix *this, const String *path, bool errorOnMissing, const String *expression);
+bool storageDriverPosixListEach(
+    StorageDriverPosix *this, const String *path, bool errorOnMissing, const String *expression, StorageListEachCallback callback,
+    void *callbackData);
 bool storageDriverPosixMove(StorageDriverPosix *this, StorageDriverPosixFileRead *source, StorageDriverPosixFileWrite *destination);
-StorageFileRead *storageDriverPosixNewRead(StorageDriverPosix *this, const String *file, bool ignoreMissing);
+StorageFileRead *storageDriverPosixNewRead(
+    StorageDriverPosix *this, const String *file, bool ignoreMissing, uint64_t offset, const Variant *limit);
 StorageFileWrite *storageDriverPosixNewWrite(
     StorageDriverPosix *this, const String *file, mode_t modeFile, mode_t modePath, bool createPath, bool syncFile, bool syncPath,
     bool atomic);
@@ -10,6 +10,7 @@ Remote Storage File Read Driver
 #include "common/memContext.h"
 #include "common/regExp.h"
 #include "common/type/convert.h"
+#include "protocol/frame.h"
 #include "storage/driver/remote/fileRead.h"
 #include "storage/driver/remote/protocol.h"
 #include "storage/fileRead.intern.h"
@@ -30,6 +31,8 @@ struct StorageDriverRemoteFileRead
     IoRead *io;
     String *name;
     bool ignoreMissing;
+    uint64_t offset;                                                // Where to start reading in the file
+    Variant *limit;                                                 // Max bytes to read (NULL reads to the end of the file)
 
     ProtocolClient *client;                                         // Protocol client for requests
     size_t remaining;                                               // Bytes remaining to be read
@@ -49,13 +52,17 @@ static struct
 Create a new file
 ***********************************************************************************************************************************/
 StorageDriverRemoteFileRead *
-storageDriverRemoteFileReadNew(StorageDriverRemote *storage, ProtocolClient *client, const String *name, bool ignoreMissing)
+storageDriverRemoteFileReadNew(
+    StorageDriverRemote *storage, ProtocolClient *client, const String *name, bool ignoreMissing, uint64_t offset,
+    const Variant *limit)
 {
     FUNCTION_LOG_BEGIN(logLevelTrace);
         FUNCTION_LOG_PARAM(STORAGE_DRIVER_REMOTE, storage);
         FUNCTION_LOG_PARAM(PROTOCOL_CLIENT, client);
         FUNCTION_LOG_PARAM(STRING, name);
         FUNCTION_LOG_PARAM(BOOL, ignoreMissing);
+        FUNCTION_LOG_PARAM(UINT64, offset);
+        FUNCTION_LOG_PARAM(VARIANT, limit);
     FUNCTION_LOG_END();
 
     ASSERT(storage != NULL);
@@ -72,6 +79,8 @@ storageDriverRemoteFileReadNew(StorageDriverRemote *storage, ProtocolClient *cli
         this->storage = storage;
         this->name = strDup(name);
         this->ignoreMissing = ignoreMissing;
+        this->offset = offset;
+        this->limit = varDup(limit);
 
         this->client = client;
 
@@ -124,6 +133,8 @@ storageDriverRemoteFileReadOpen(StorageDriverRemoteFileRead *this)
         ProtocolCommand *command = protocolCommandNew(PROTOCOL_COMMAND_STORAGE_OPEN_READ_STR);
         protocolCommandParamAdd(command, varNewStr(this->name));
         protocolCommandParamAdd(command, varNewBool(this->ignoreMissing));
+        protocolCommandParamAdd(command, varNewUInt64(this->offset));
+        protocolCommandParamAdd(command, this->limit);
 
         result = varBool(protocolClientExecute(this->client, command, true));
     }
@@ -175,14 +186,20 @@ storageDriverRemoteFileRead(StorageDriverRemoteFileRead *this, Buffer *buffer, b
             // If no bytes remaining then read a new block
             if (this->remaining == 0)
             {
-                MEM_CONTEXT_TEMP_BEGIN()
+                // Binary frames have the size in the header so there is no need to parse a block message
+                if (protocolClientBinary(this->client))
+                    this->remaining = protocolFrameReadBlock(protocolClientIoRead(this->client));
+                else
                 {
-                    this->remaining = storageDriverRemoteFileReadBlockSize(ioReadLine(protocolClientIoRead(this->client)));
-
-                    if (this->remaining == 0)
-                        this->eof = true;
+                    MEM_CONTEXT_TEMP_BEGIN()
+                    {
+                        this->remaining = storageDriverRemoteFileReadBlockSize(ioReadLine(protocolClientIoRead(this->client)));
+                    }
+                    MEM_CONTEXT_TEMP_END();
                 }
-                MEM_CONTEXT_TEMP_END();
+
+                if (this->remaining == 0)
+                    this->eof = true;
             }
 
             // Read if not eof
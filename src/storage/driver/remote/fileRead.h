@@ -19,7 +19,8 @@ typedef struct StorageDriverRemoteFileRead StorageDriverRemoteFileRead;
 Constructor
 ***********************************************************************************************************************************/
 StorageDriverRemoteFileRead *storageDriverRemoteFileReadNew(
-    StorageDriverRemote *storage, ProtocolClient *client, const String *name, bool ignoreMissing);
+    StorageDriverRemote *storage, ProtocolClient *client, const String *name, bool ignoreMissing, uint64_t offset,
+    const Variant *limit);
 
 /***********************************************************************************************************************************
 Functions
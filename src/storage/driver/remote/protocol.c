@@ -1,10 +1,22 @@
 /***********************************************************************************************************************************
 Remote Storage Protocol Handler
 ***********************************************************************************************************************************/
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+    // Required for splice()
+    #define _GNU_SOURCE
+#endif
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
 #include "common/debug.h"
 #include "common/io/io.h"
 #include "common/log.h"
 #include "common/memContext.h"
+#include "protocol/frame.h"
 #include "storage/driver/remote/protocol.h"
 #include "storage/helper.h"
 #include "storage/storage.intern.h"
@@ -14,8 +26,265 @@ Constants
 ***********************************************************************************************************************************/
 STRING_EXTERN(PROTOCOL_COMMAND_STORAGE_EXISTS_STR,                  PROTOCOL_COMMAND_STORAGE_EXISTS);
 STRING_EXTERN(PROTOCOL_COMMAND_STORAGE_LIST_STR,                    PROTOCOL_COMMAND_STORAGE_LIST);
+STRING_EXTERN(PROTOCOL_COMMAND_STORAGE_LIST_EACH_STR,               PROTOCOL_COMMAND_STORAGE_LIST_EACH);
 STRING_EXTERN(PROTOCOL_COMMAND_STORAGE_OPEN_READ_STR,               PROTOCOL_COMMAND_STORAGE_OPEN_READ);
 
+/***********************************************************************************************************************************
+Send list entries to the client in batches so the directory is never held in memory
+***********************************************************************************************************************************/
+typedef struct StorageDriverRemoteProtocolListEachData
+{
+    ProtocolServer *server;                                         // Server to send entries with
+    MemContext *memContext;                                         // Context to create batches in
+    MemContext *batchContext;                                       // Context for the current batch
+    VariantList *entryList;                                         // Entries in the current batch
+} StorageDriverRemoteProtocolListEachData;
+
+static void
+storageDriverRemoteProtocolListEachSend(StorageDriverRemoteProtocolListEachData *data)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM_P(VOID, data);
+    FUNCTION_TEST_END();
+
+    ASSERT(data != NULL);
+
+    if (data->batchContext != NULL)
+    {
+        MEM_CONTEXT_BEGIN(data->batchContext)
+        {
+            protocolServerResponse(data->server, varNewVarLst(data->entryList));
+        }
+        MEM_CONTEXT_END();
+
+        memContextFree(data->batchContext);
+        data->batchContext = NULL;
+        data->entryList = NULL;
+    }
+
+    FUNCTION_TEST_RETURN_VOID();
+}
+
+static void
+storageDriverRemoteProtocolListEachCallback(void *callbackData, const String *name, StorageInfo info)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM_P(VOID, callbackData);
+        FUNCTION_TEST_PARAM(STRING, name);
+        FUNCTION_TEST_PARAM(STORAGE_INFO, info);
+    FUNCTION_TEST_END();
+
+    ASSERT(callbackData != NULL);
+    ASSERT(name != NULL);
+
+    StorageDriverRemoteProtocolListEachData *data = (StorageDriverRemoteProtocolListEachData *)callbackData;
+
+    // Start a new batch if needed
+    if (data->batchContext == NULL)
+    {
+        MEM_CONTEXT_BEGIN(data->memContext)
+        {
+            MEM_CONTEXT_NEW_BEGIN("StorageDriverRemoteProtocolListEach")
+            {
+                data->batchContext = MEM_CONTEXT_NEW();
+                data->entryList = varLstNew();
+            }
+            MEM_CONTEXT_NEW_END();
+        }
+        MEM_CONTEXT_END();
+    }
+
+    // Add the entry to the batch
+    MEM_CONTEXT_BEGIN(data->batchContext)
+    {
+        varLstAdd(data->entryList, varNewStr(name));
+        varLstAdd(data->entryList, varNewUInt64(info.type));
+        varLstAdd(data->entryList, varNewUInt64(info.size));
+        varLstAdd(data->entryList, varNewUInt64(info.mode));
+        varLstAdd(data->entryList, varNewUInt64(info.userId));
+        varLstAdd(data->entryList, varNewUInt64(info.groupId));
+        varLstAdd(data->entryList, varNewInt64(info.timeModified));
+        varLstAdd(data->entryList, varNewStr(info.linkDestination));
+    }
+    MEM_CONTEXT_END();
+
+    // Send the batch when it is full
+    if (varLstSize(data->entryList) >= PROTOCOL_STORAGE_LIST_EACH_BATCH_MAX * PROTOCOL_STORAGE_LIST_EACH_FIELD_TOTAL)
+        storageDriverRemoteProtocolListEachSend(data);
+
+    FUNCTION_TEST_RETURN_VOID();
+}
+
+/***********************************************************************************************************************************
+Write the header for a block of file data
+***********************************************************************************************************************************/
+static void
+storageDriverRemoteProtocolBlockSize(ProtocolServer *server, size_t size)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(PROTOCOL_SERVER, server);
+        FUNCTION_TEST_PARAM(SIZE, size);
+    FUNCTION_TEST_END();
+
+    ASSERT(server != NULL);
+
+    if (protocolServerBinary(server))
+        protocolFrameWriteBlockSize(protocolServerIoWrite(server), size);
+    else
+        ioWriteLine(protocolServerIoWrite(server), strNewFmt(PROTOCOL_BLOCK_HEADER "%zu", size));
+
+    FUNCTION_TEST_RETURN_VOID();
+}
+
+#ifdef __linux__
+/***********************************************************************************************************************************
+Move data between handles with splice().  Interrupted calls are retried and when the output handle is non-blocking (e.g. a socket)
+and full then wait until it can be written.  Returns the bytes moved, which may be fewer than requested, or -1 with errno set.
+***********************************************************************************************************************************/
+static ssize_t
+storageDriverRemoteProtocolSplice(int handleIn, int handleOut, size_t size)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(INT, handleIn);
+        FUNCTION_TEST_PARAM(INT, handleOut);
+        FUNCTION_TEST_PARAM(SIZE, size);
+    FUNCTION_TEST_END();
+
+    ssize_t result;
+
+    while ((result = splice(handleIn, NULL, handleOut, NULL, size, SPLICE_F_MOVE)) == -1)
+    {
+        if (errno == EAGAIN)
+        {
+            struct pollfd pollOut = {.fd = handleOut, .events = POLLOUT};
+
+            if (poll(&pollOut, 1, -1) == -1 && errno != EINTR)
+                break;
+        }
+        else if (errno != EINTR)
+            break;
+    }
+
+    FUNCTION_TEST_RETURN(result);
+}
+
+/***********************************************************************************************************************************
+Send file data from one handle to another without copying it through user space.  Each block is moved from the file into a pipe
+first so the size of the block is known before its header is written.  The file may be truncated while it is being sent (e.g. a
+relation truncated during a backup) so fewer bytes than requested may be sent, which is the same result as the buffered copy.  The
+block headers are written through the protocol so they must be flushed before the data is sent.
+***********************************************************************************************************************************/
+static void
+storageDriverRemoteProtocolSendHandle(ProtocolServer *server, int handleIn, int handleOut, uint64_t size)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(PROTOCOL_SERVER, server);
+        FUNCTION_TEST_PARAM(INT, handleIn);
+        FUNCTION_TEST_PARAM(INT, handleOut);
+        FUNCTION_TEST_PARAM(UINT64, size);
+    FUNCTION_TEST_END();
+
+    ASSERT(server != NULL);
+    ASSERT(handleIn != -1);
+    ASSERT(handleOut != -1);
+
+    int pipeHandle[2];
+    THROW_ON_SYS_ERROR(pipe(pipeHandle) == -1, FileOpenError, "unable to create pipe");
+
+    TRY_BEGIN()
+    {
+        while (size > 0)
+        {
+            // Move the next block into the pipe.  The block may be smaller than requested when the pipe is full or the file is
+            // shorter than expected.
+            ssize_t blockSize = storageDriverRemoteProtocolSplice(
+                handleIn, pipeHandle[1], size > ioBufferSize() ? ioBufferSize() : (size_t)size);
+
+            THROW_ON_SYS_ERROR(blockSize == -1, FileReadError, "unable to read file");
+
+            // The file is smaller than when it was opened so there is nothing more to send
+            if (blockSize == 0)
+                break;
+
+            storageDriverRemoteProtocolBlockSize(server, (size_t)blockSize);
+            ioWriteFlush(protocolServerIoWrite(server));
+
+            // Send the block from the pipe, which may take multiple calls
+            ssize_t blockSent = 0;
+
+            do
+            {
+                ssize_t sent = storageDriverRemoteProtocolSplice(pipeHandle[0], handleOut, (size_t)(blockSize - blockSent));
+
+                THROW_ON_SYS_ERROR(sent == -1, FileWriteError, "unable to send file");
+
+                blockSent += sent;
+            }
+            while (blockSent < blockSize);
+
+            size -= (uint64_t)blockSize;
+        }
+    }
+    FINALLY()
+    {
+        close(pipeHandle[0]);
+        close(pipeHandle[1]);
+    }
+    TRY_END();
+
+    FUNCTION_TEST_RETURN_VOID();
+}
+#endif
+
+/***********************************************************************************************************************************
+Send a file without copying it through user space if possible.  This is only possible when both the file and the protocol have
+handles and the file is a regular file so the size is known.  The driver read object has no filters so the data can be sent as is.
+The data is sent from the current position of the file, which is the offset of the read, up to the limit.  Returns false if the
+file must be copied through a buffer instead.
+***********************************************************************************************************************************/
+static bool
+storageDriverRemoteProtocolSendFile(ProtocolServer *server, IoRead *fileRead, const Variant *limit)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(PROTOCOL_SERVER, server);
+        FUNCTION_TEST_PARAM(IO_READ, fileRead);
+        FUNCTION_TEST_PARAM(VARIANT, limit);
+    FUNCTION_TEST_END();
+
+    ASSERT(server != NULL);
+    ASSERT(fileRead != NULL);
+
+    bool result = false;
+
+#ifdef __linux__
+    int handleIn = ioReadHandle(fileRead);
+    int handleOut = ioWriteHandle(protocolServerIoWrite(server));
+
+    if (handleIn != -1 && handleOut != -1)
+    {
+        struct stat statFile;
+
+        THROW_ON_SYS_ERROR(fstat(handleIn, &statFile) == -1, FileReadError, "unable to stat file");
+
+        if (S_ISREG(statFile.st_mode))
+        {
+            off_t position = lseek(handleIn, 0, SEEK_CUR);
+            THROW_ON_SYS_ERROR(position == -1, FileReadError, "unable to get file position");
+
+            uint64_t size = statFile.st_size > position ? (uint64_t)(statFile.st_size - position) : 0;
+
+            if (limit != NULL && varUInt64(limit) < size)
+                size = varUInt64(limit);
+
+            storageDriverRemoteProtocolSendHandle(server, handleIn, handleOut, size);
+            result = true;
+        }
+    }
+#endif
+
+    FUNCTION_TEST_RETURN(result);
+}
+
 /***********************************************************************************************************************************
 Process storage protocol requests
 ***********************************************************************************************************************************/
@@ -55,19 +324,34 @@ storageDriverRemoteProtocol(const String *command, const VariantList *paramList,
                             driver, storagePathNP(storage, varStr(varLstGet(paramList, 0))), varBool(varLstGet(paramList, 1)),
                             varStr(varLstGet(paramList, 2))))));
         }
+        else if (strEq(command, PROTOCOL_COMMAND_STORAGE_LIST_EACH_STR))
+        {
+            StorageDriverRemoteProtocolListEachData data = {.server = server, .memContext = MEM_CONTEXT_TEMP()};
+
+            bool exists = interface.listEach(
+                driver, storagePathNP(storage, varStr(varLstGet(paramList, 0))), varBool(varLstGet(paramList, 1)),
+                varStr(varLstGet(paramList, 2)), storageDriverRemoteProtocolListEachCallback, &data);
+
+            // Send the last partial batch and then whether the path exists to end the list
+            storageDriverRemoteProtocolListEachSend(&data);
+            protocolServerResponse(server, varNewBool(exists));
+        }
         else if (strEq(command, PROTOCOL_COMMAND_STORAGE_OPEN_READ_STR))
         {
             // Create the read object
+            const Variant *limit = varLstGet(paramList, 3) == NULL ? NULL : varNewUInt64(varUInt64Force(varLstGet(paramList, 3)));
+
             IoRead *fileRead = storageFileReadIo(
                 interface.newRead(
-                    driver, storagePathNP(storage, varStr(varLstGet(paramList, 0))), varBool(varLstGet(paramList, 1))));
+                    driver, storagePathNP(storage, varStr(varLstGet(paramList, 0))), varBool(varLstGet(paramList, 1)),
+                    varUInt64Force(varLstGet(paramList, 2)), limit));
 
             // Check if the file exists
             bool exists = ioReadOpen(fileRead);
             protocolServerResponse(server, varNewBool(exists));
 
-            // Transfer the file if it exists
-            if (exists)
+            // Transfer the file if it exists.  Copy the file through a buffer when it cannot be sent directly.
+            if (exists && !storageDriverRemoteProtocolSendFile(server, fileRead, limit))
             {
                 Buffer *buffer = bufNew(ioBufferSize());
 
@@ -78,7 +362,7 @@ storageDriverRemoteProtocol(const String *command, const VariantList *paramList,
 
                     if (bufUsed(buffer) > 0)
                     {
-                        ioWriteLine(protocolServerIoWrite(server), strNewFmt(PROTOCOL_BLOCK_HEADER "%zu", bufUsed(buffer)));
+                        storageDriverRemoteProtocolBlockSize(server, bufUsed(buffer));
                         ioWrite(protocolServerIoWrite(server), buffer);
                         ioWriteFlush(protocolServerIoWrite(server));
 
@@ -86,9 +370,12 @@ storageDriverRemoteProtocol(const String *command, const VariantList *paramList,
                     }
                 }
                 while (!ioReadEof(fileRead));
+            }
 
-                // Write a zero block to show file is complete
-                ioWriteLine(protocolServerIoWrite(server), strNew(PROTOCOL_BLOCK_HEADER "0"));
+            // Write a zero block to show file is complete
+            if (exists)
+            {
+                storageDriverRemoteProtocolBlockSize(server, 0);
                 ioWriteFlush(protocolServerIoWrite(server));
             }
         }
@@ -13,10 +13,17 @@ Constants
 ***********************************************************************************************************************************/
 #define PROTOCOL_BLOCK_HEADER                                       "BRBLOCK"
 
+// List entries are sent in batches as a flat list of name, type, size, mode, user id, group id, time modified, and link destination
+// for each entry
+#define PROTOCOL_STORAGE_LIST_EACH_BATCH_MAX                        1024
+#define PROTOCOL_STORAGE_LIST_EACH_FIELD_TOTAL                      8
+
 #define PROTOCOL_COMMAND_STORAGE_EXISTS                             "storageExists"
     STRING_DECLARE(PROTOCOL_COMMAND_STORAGE_EXISTS_STR);
 #define PROTOCOL_COMMAND_STORAGE_LIST                               "storageList"
     STRING_DECLARE(PROTOCOL_COMMAND_STORAGE_LIST_STR);
+#define PROTOCOL_COMMAND_STORAGE_LIST_EACH                          "storageListEach"
+    STRING_DECLARE(PROTOCOL_COMMAND_STORAGE_LIST_EACH_STR);
 #define PROTOCOL_COMMAND_STORAGE_OPEN_READ                          "storageOpenRead"
     STRING_DECLARE(PROTOCOL_COMMAND_STORAGE_OPEN_READ_STR);
 
@@ -57,7 +57,9 @@ storageDriverRemoteNew(
         this->interface = storageNewP(
             STORAGE_DRIVER_REMOTE_TYPE_STR, NULL, modeFile, modePath, write, pathExpressionFunction, this,
             .exists = (StorageInterfaceExists)storageDriverRemoteExists, .info = (StorageInterfaceInfo)storageDriverRemoteInfo,
-            .list = (StorageInterfaceList)storageDriverRemoteList, .newRead = (StorageInterfaceNewRead)storageDriverRemoteNewRead,
+            .list = (StorageInterfaceList)storageDriverRemoteList,
+            .listEach = (StorageInterfaceListEach)storageDriverRemoteListEach,
+            .newRead = (StorageInterfaceNewRead)storageDriverRemoteNewRead,
             .newWrite = (StorageInterfaceNewWrite)storageDriverRemoteNewWrite,
             .pathCreate = (StorageInterfacePathCreate)storageDriverRemotePathCreate,
             .pathRemove = (StorageInterfacePathRemove)storageDriverRemotePathRemove,
@@ -149,23 +151,105 @@ storageDriverRemoteList(StorageDriverRemote *this, const String *path, bool erro
     FUNCTION_LOG_RETURN(STRING_LIST, result);
 }
 
+/***********************************************************************************************************************************
+Call a function for each file/path/link in a directory
+
+The remote sends entries in batches followed by a boolean that indicates whether the path exists.
+***********************************************************************************************************************************/
+bool
+storageDriverRemoteListEach(
+    StorageDriverRemote *this, const String *path, bool errorOnMissing, const String *expression, StorageListEachCallback callback,
+    void *callbackData)
+{
+    FUNCTION_LOG_BEGIN(logLevelDebug);
+        FUNCTION_LOG_PARAM(STORAGE_DRIVER_REMOTE, this);
+        FUNCTION_LOG_PARAM(STRING, path);
+        FUNCTION_LOG_PARAM(BOOL, errorOnMissing);
+        FUNCTION_LOG_PARAM(STRING, expression);
+        FUNCTION_LOG_PARAM(FUNCTIONP, callback);
+        FUNCTION_LOG_PARAM_P(VOID, callbackData);
+    FUNCTION_LOG_END();
+
+    ASSERT(this != NULL);
+    ASSERT(callback != NULL);
+
+    bool result = false;
+    bool done = false;
+
+    MEM_CONTEXT_TEMP_BEGIN()
+    {
+        ProtocolCommand *command = protocolCommandNew(PROTOCOL_COMMAND_STORAGE_LIST_EACH_STR);
+        protocolCommandParamAdd(command, varNewStr(path));
+        protocolCommandParamAdd(command, varNewBool(errorOnMissing));
+        protocolCommandParamAdd(command, varNewStr(expression));
+
+        protocolClientWriteCommand(this->client, command);
+
+        // Read batches until the path exists flag is received
+        do
+        {
+            MEM_CONTEXT_TEMP_BEGIN()
+            {
+                const Variant *output = protocolClientReadOutput(this->client, true);
+
+                if (varType(output) == varTypeBool)
+                {
+                    result = varBool(output);
+                    done = true;
+                }
+                else
+                {
+                    const VariantList *entryList = varVarLst(output);
+
+                    for (unsigned int entryIdx = 0; entryIdx < varLstSize(entryList);
+                         entryIdx += PROTOCOL_STORAGE_LIST_EACH_FIELD_TOTAL)
+                    {
+                        callback(
+                            callbackData, varStr(varLstGet(entryList, entryIdx)),
+                            (StorageInfo)
+                            {
+                                .exists = true,
+                                .type = (StorageType)varUInt64Force(varLstGet(entryList, entryIdx + 1)),
+                                .size = (size_t)varUInt64Force(varLstGet(entryList, entryIdx + 2)),
+                                .mode = (mode_t)varUInt64Force(varLstGet(entryList, entryIdx + 3)),
+                                .userId = (uid_t)varUInt64Force(varLstGet(entryList, entryIdx + 4)),
+                                .groupId = (gid_t)varUInt64Force(varLstGet(entryList, entryIdx + 5)),
+                                .timeModified = (time_t)varInt64Force(varLstGet(entryList, entryIdx + 6)),
+                                .linkDestination = varStr(varLstGet(entryList, entryIdx + 7)),
+                            });
+                    }
+                }
+            }
+            MEM_CONTEXT_TEMP_END();
+        }
+        while (!done);
+    }
+    MEM_CONTEXT_TEMP_END();
+
+    FUNCTION_LOG_RETURN(BOOL, result);
+}
+
 /***********************************************************************************************************************************
 New file read object
 ***********************************************************************************************************************************/
 StorageFileRead *
-storageDriverRemoteNewRead(StorageDriverRemote *this, const String *file, bool ignoreMissing)
+storageDriverRemoteNewRead(
+    StorageDriverRemote *this, const String *file, bool ignoreMissing, uint64_t offset, const Variant *limit)
 {
     FUNCTION_LOG_BEGIN(logLevelDebug);
         FUNCTION_LOG_PARAM(STORAGE_DRIVER_REMOTE, this);
         FUNCTION_LOG_PARAM(STRING, file);
         FUNCTION_LOG_PARAM(BOOL, ignoreMissing);
+        FUNCTION_LOG_PARAM(UINT64, offset);
+        FUNCTION_LOG_PARAM(VARIANT, limit);
     FUNCTION_LOG_END();
 
     ASSERT(this != NULL);
 
     FUNCTION_LOG_RETURN(
         STORAGE_FILE_READ,
-        storageDriverRemoteFileReadInterface(storageDriverRemoteFileReadNew(this, this->client, file, ignoreMissing)));
+        storageDriverRemoteFileReadInterface(
+            storageDriverRemoteFileReadNew(this, this->client, file, ignoreMissing, offset, limit)));
 }
 
 /***********************************************************************************************************************************
@@ -31,7 +31,11 @@ Functions
 bool storageDriverRemoteExists(StorageDriverRemote *this, const String *path);
 StorageInfo storageDriverRemoteInfo(StorageDriverRemote *this, const String *file, bool ignoreMissing);
 StringList *storageDriverRemoteList(StorageDriverRemote *this, const String *path, bool errorOnMissing, const String *expression);
-StorageFileRead *storageDriverRemoteNewRead(StorageDriverRemote *this, const String *file, bool ignoreMissing);
+bool storageDriverRemoteListEach(
+    StorageDriverRemote *this, const String *path, bool errorOnMissing, const String *expression, StorageListEachCallback callback,
+    void *callbackData);
+StorageFileRead *storageDriverRemoteNewRead(
+    StorageDriverRemote *this, const String *file, bool ignoreMissing, uint64_t offset, const Variant *limit);
 StorageFileWrite *storageDriverRemoteNewWrite(
     StorageDriverRemote *this, const String *file, mode_t modeFile, mode_t modePath, bool createPath, bool syncFile, bool syncPath,
     bool atomic);
@@ -2,6 +2,7 @@
 S3 Storage File Read Driver
 ***********************************************************************************************************************************/
 #include <fcntl.h>
+#include <inttypes.h>
 #include <unistd.h>
 
 #include "common/debug.h"
@@ -23,6 +24,8 @@ struct StorageDriverS3FileRead
     IoRead *io;
     String *name;
     bool ignoreMissing;
+    uint64_t offset;                                                // Where to start reading in the file
+    Variant *limit;                                                 // Max bytes to read (NULL reads to the end of the file)
 
     HttpClient *httpClient;                                         // Http client for requests
 };
@@ -31,12 +34,15 @@ struct StorageDriverS3FileRead
 Create a new file
 ***********************************************************************************************************************************/
 StorageDriverS3FileRead *
-storageDriverS3FileReadNew(StorageDriverS3 *storage, const String *name, bool ignoreMissing)
+storageDriverS3FileReadNew(
+    StorageDriverS3 *storage, const String *name, bool ignoreMissing, uint64_t offset, const Variant *limit)
 {
     FUNCTION_LOG_BEGIN(logLevelTrace);
         FUNCTION_LOG_PARAM(STORAGE_DRIVER_S3, storage);
         FUNCTION_LOG_PARAM(STRING, name);
         FUNCTION_LOG_PARAM(BOOL, ignoreMissing);
+        FUNCTION_LOG_PARAM(UINT64, offset);
+        FUNCTION_LOG_PARAM(VARIANT, limit);
     FUNCTION_LOG_END();
 
     ASSERT(storage != NULL);
@@ -52,6 +58,8 @@ storageDriverS3FileReadNew(StorageDriverS3 *storage, const String *name, bool ig
         this->storage = storage;
         this->name = strDup(name);
         this->ignoreMissing = ignoreMissing;
+        this->offset = offset;
+        this->limit = varDup(limit);
 
         this->interface = storageFileReadNewP(
             strNew(STORAGE_DRIVER_S3_TYPE), this,
@@ -60,14 +68,32 @@ storageDriverS3FileReadNew(StorageDriverS3 *storage, const String *name, bool ig
             .name = (StorageFileReadInterfaceName)storageDriverS3FileReadName);
 
         this->io = ioReadNewP(
-            this, .eof = (IoReadInterfaceEof)storageDriverS3FileReadEof,
-            .open = (IoReadInterfaceOpen)storageDriverS3FileReadOpen, .read = (IoReadInterfaceRead)storageDriverS3FileRead);
+            this, .close = (IoReadInterfaceClose)storageDriverS3FileReadClose,
+            .eof = (IoReadInterfaceEof)storageDriverS3FileReadEof, .open = (IoReadInterfaceOpen)storageDriverS3FileReadOpen,
+            .read = (IoReadInterfaceRead)storageDriverS3FileRead);
     }
     MEM_CONTEXT_NEW_END();
 
     FUNCTION_LOG_RETURN(STORAGE_DRIVER_S3_FILE_READ, this);
 }
 
+/***********************************************************************************************************************************
+Free the file when the mem context is freed
+***********************************************************************************************************************************/
+static void
+storageDriverS3FileReadFreeCallback(StorageDriverS3FileRead *this)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(STORAGE_DRIVER_S3_FILE_READ, this);
+    FUNCTION_TEST_END();
+
+    ASSERT(this != NULL);
+
+    storageDriverS3FileReadFree(this);
+
+    FUNCTION_TEST_RETURN_VOID();
+}
+
 /***********************************************************************************************************************************
 Open the file
 ***********************************************************************************************************************************/
@@ -83,13 +109,38 @@ storageDriverS3FileReadOpen(StorageDriverS3FileRead *this)
 
     bool result = false;
 
-    // Request the file
-    storageDriverS3Request(this->storage, HTTP_VERB_GET_STR, this->name, NULL, NULL, false, true);
-
-    // On success
+    // Request the file.  The client is kept busy until all content has been read so other requests will use a different client.
+    // Set a callback so the client is released if the file is freed before it is closed.
     this->httpClient = storageDriverS3HttpClient(this->storage);
+    memContextCallback(this->memContext, (MemContextCallback)storageDriverS3FileReadFreeCallback, this);
+
+    MEM_CONTEXT_TEMP_BEGIN()
+    {
+        // Request only part of the file when there is an offset or limit
+        HttpHeader *header = NULL;
+
+        if (this->offset > 0 || this->limit != NULL)
+        {
+            header = httpHeaderNew(NULL);
+
+            if (this->limit == NULL)
+                httpHeaderAdd(header, HTTP_HEADER_RANGE_STR, strNewFmt("bytes=%" PRIu64 "-", this->offset));
+            else
+            {
+                httpHeaderAdd(
+                    header, HTTP_HEADER_RANGE_STR,
+                    strNewFmt("bytes=%" PRIu64 "-%" PRIu64, this->offset, this->offset + varUInt64(this->limit) - 1));
+            }
+        }
+
+        HttpHeader *requestHeader = storageDriverS3RequestAsync(
+            this->storage, this->httpClient, HTTP_VERB_GET_STR, this->name, NULL, header, NULL);
+        storageDriverS3Response(this->storage, this->httpClient, this->name, NULL, requestHeader, false, true);
+    }
+    MEM_CONTEXT_TEMP_END();
 
-    if (httpClientResponseCode(this->httpClient) == HTTP_RESPONSE_CODE_OK)
+    // On success (a ranged request returns partial content)
+    if (httpClientResponseCodeOk(this->httpClient))
         result = true;
 
     // Else error unless ignore missing
@@ -117,6 +168,29 @@ storageDriverS3FileRead(StorageDriverS3FileRead *this, Buffer *buffer, bool bloc
     FUNCTION_LOG_RETURN(SIZE, ioRead(httpClientIoRead(this->httpClient), buffer));
 }
 
+/***********************************************************************************************************************************
+Close the file
+
+If the content was not read to the end then the http client is released so it can be used for other requests.
+***********************************************************************************************************************************/
+void
+storageDriverS3FileReadClose(StorageDriverS3FileRead *this)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(STORAGE_DRIVER_S3_FILE_READ, this);
+    FUNCTION_LOG_END();
+
+    ASSERT(this != NULL);
+
+    if (this->httpClient != NULL)
+    {
+        httpClientDone(this->httpClient);
+        this->httpClient = NULL;
+    }
+
+    FUNCTION_LOG_RETURN_VOID();
+}
+
 /***********************************************************************************************************************************
 Has file reached EOF?
 ***********************************************************************************************************************************/
@@ -191,3 +265,24 @@ storageDriverS3FileReadName(const StorageDriverS3FileRead *this)
 
     FUNCTION_TEST_RETURN(this->name);
 }
+
+/***********************************************************************************************************************************
+Free the file
+***********************************************************************************************************************************/
+void
+storageDriverS3FileReadFree(StorageDriverS3FileRead *this)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(STORAGE_DRIVER_S3_FILE_READ, this);
+    FUNCTION_LOG_END();
+
+    if (this != NULL)
+    {
+        storageDriverS3FileReadClose(this);
+
+        memContextCallbackClear(this->memContext);
+        memContextFree(this->memContext);
+    }
+
+    FUNCTION_LOG_RETURN_VOID();
+}
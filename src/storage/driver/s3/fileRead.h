@@ -17,13 +17,15 @@ typedef struct StorageDriverS3FileRead StorageDriverS3FileRead;
 /***********************************************************************************************************************************
 Constructor
 ***********************************************************************************************************************************/
-StorageDriverS3FileRead *storageDriverS3FileReadNew(StorageDriverS3 *storage, const String *name, bool ignoreMissing);
+StorageDriverS3FileRead *storageDriverS3FileReadNew(
+    StorageDriverS3 *storage, const String *name, bool ignoreMissing, uint64_t offset, const Variant *limit);
 
 /***********************************************************************************************************************************
 Functions
 ***********************************************************************************************************************************/
 bool storageDriverS3FileReadOpen(StorageDriverS3FileRead *this);
 size_t storageDriverS3FileRead(StorageDriverS3FileRead *this, Buffer *buffer, bool block);
+void storageDriverS3FileReadClose(StorageDriverS3FileRead *this);
 
 /***********************************************************************************************************************************
 Getters
@@ -0,0 +1,466 @@
+/***********************************************************************************************************************************
+S3 Storage File Write Driver
+***********************************************************************************************************************************/
+#include "common/debug.h"
+#include "common/io/http/client.h"
+#include "common/io/write.intern.h"
+#include "common/log.h"
+#include "common/memContext.h"
+#include "common/type/list.h"
+#include "common/type/xml.h"
+#include "storage/driver/s3/fileWrite.h"
+#include "storage/fileWrite.intern.h"
+
+/***********************************************************************************************************************************
+S3 query tokens
+***********************************************************************************************************************************/
+STRING_STATIC(S3_QUERY_PART_NUMBER_STR,                             "partNumber");
+STRING_STATIC(S3_QUERY_UPLOADS_STR,                                 "uploads");
+STRING_STATIC(S3_QUERY_UPLOAD_ID_STR,                               "uploadId");
+
+/***********************************************************************************************************************************
+XML tags
+***********************************************************************************************************************************/
+STRING_STATIC(S3_XML_TAG_UPLOAD_ID_STR,                             "UploadId");
+
+/***********************************************************************************************************************************
+Part that has been sent but whose response has not been read yet
+***********************************************************************************************************************************/
+typedef struct StorageDriverS3FileWritePart
+{
+    MemContext *memContext;                                         // Context for part data
+    HttpClient *httpClient;                                         // Http client the part was sent on
+    HttpQuery *query;                                               // Part query (part number and upload id)
+    HttpHeader *header;                                             // Signed request header
+    Buffer *buffer;                                                 // Part data (kept in case the request is retried)
+} StorageDriverS3FileWritePart;
+
+/***********************************************************************************************************************************
+Object type
+***********************************************************************************************************************************/
+struct StorageDriverS3FileWrite
+{
+    MemContext *memContext;
+    StorageDriverS3 *storage;
+    StorageFileWrite *interface;
+    IoWrite *io;
+    String *name;
+    size_t partSize;
+
+    Buffer *partBuffer;                                             // Part currently being filled
+    String *uploadId;                                               // Id of the multi-part upload (NULL until the first part)
+    unsigned int partTotal;                                         // Parts sent so far
+    List *partAsyncList;                                            // Parts in flight (oldest first)
+    StringList *uploadPartList;                                     // ETags of completed parts
+};
+
+/***********************************************************************************************************************************
+Create a new file
+***********************************************************************************************************************************/
+StorageDriverS3FileWrite *
+storageDriverS3FileWriteNew(StorageDriverS3 *storage, const String *name, size_t partSize)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(STORAGE_DRIVER_S3, storage);
+        FUNCTION_LOG_PARAM(STRING, name);
+        FUNCTION_LOG_PARAM(SIZE, partSize);
+    FUNCTION_LOG_END();
+
+    ASSERT(storage != NULL);
+    ASSERT(name != NULL);
+    ASSERT(partSize > 0);
+
+    StorageDriverS3FileWrite *this = NULL;
+
+    MEM_CONTEXT_NEW_BEGIN("StorageDriverS3FileWrite")
+    {
+        this = memNew(sizeof(StorageDriverS3FileWrite));
+        this->memContext = MEM_CONTEXT_NEW();
+        this->storage = storage;
+
+        this->interface = storageFileWriteNewP(
+            STORAGE_DRIVER_S3_TYPE_STR, this, .atomic = (StorageFileWriteInterfaceAtomic)storageDriverS3FileWriteAtomic,
+            .createPath = (StorageFileWriteInterfaceCreatePath)storageDriverS3FileWriteCreatePath,
+            .io = (StorageFileWriteInterfaceIo)storageDriverS3FileWriteIo,
+            .modeFile = (StorageFileWriteInterfaceModeFile)storageDriverS3FileWriteModeFile,
+            .modePath = (StorageFileWriteInterfaceModePath)storageDriverS3FileWriteModePath,
+            .name = (StorageFileWriteInterfaceName)storageDriverS3FileWriteName,
+            .syncFile = (StorageFileWriteInterfaceSyncFile)storageDriverS3FileWriteSyncFile,
+            .syncPath = (StorageFileWriteInterfaceSyncPath)storageDriverS3FileWriteSyncPath);
+
+        this->io = ioWriteNewP(
+            this, .close = (IoWriteInterfaceClose)storageDriverS3FileWriteClose,
+            .open = (IoWriteInterfaceOpen)storageDriverS3FileWriteOpen, .write = (IoWriteInterfaceWrite)storageDriverS3FileWrite);
+
+        this->name = strDup(name);
+        this->partSize = partSize;
+    }
+    MEM_CONTEXT_NEW_END();
+
+    FUNCTION_LOG_RETURN(STORAGE_DRIVER_S3_FILE_WRITE, this);
+}
+
+/***********************************************************************************************************************************
+Open the file
+***********************************************************************************************************************************/
+void
+storageDriverS3FileWriteOpen(StorageDriverS3FileWrite *this)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(STORAGE_DRIVER_S3_FILE_WRITE, this);
+    FUNCTION_LOG_END();
+
+    ASSERT(this != NULL);
+    ASSERT(this->partBuffer == NULL);
+
+    // Allocate the part buffer.  Nothing is sent to S3 until the first part is full or the file is closed.
+    MEM_CONTEXT_BEGIN(this->memContext)
+    {
+        this->partBuffer = bufNew(this->partSize);
+        this->partAsyncList = lstNew(sizeof(StorageDriverS3FileWritePart));
+    }
+    MEM_CONTEXT_END();
+
+    FUNCTION_LOG_RETURN_VOID();
+}
+
+/***********************************************************************************************************************************
+Wait for the oldest part in flight to complete and store its ETag
+***********************************************************************************************************************************/
+static void
+storageDriverS3FileWritePartComplete(StorageDriverS3FileWrite *this)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(STORAGE_DRIVER_S3_FILE_WRITE, this);
+    FUNCTION_LOG_END();
+
+    ASSERT(this != NULL);
+    ASSERT(lstSize(this->partAsyncList) > 0);
+
+    StorageDriverS3FileWritePart *part = (StorageDriverS3FileWritePart *)lstGet(this->partAsyncList, 0);
+
+    MEM_CONTEXT_TEMP_BEGIN()
+    {
+        storageDriverS3Response(this->storage, part->httpClient, this->name, part->query, part->header, true, false);
+
+        const String *eTag = httpHeaderGet(httpClientReponseHeader(part->httpClient), HTTP_HEADER_ETAG_STR);
+
+        if (eTag == NULL)
+            THROW_FMT(FormatError, "missing " HTTP_HEADER_ETAG " header for part %u of '%s'",
+                strLstSize(this->uploadPartList) + 1, strPtr(this->name));
+
+        strLstAdd(this->uploadPartList, eTag);
+    }
+    MEM_CONTEXT_TEMP_END();
+
+    // Free the part data now that it can no longer be resent
+    memContextFree(part->memContext);
+    lstRemove(this->partAsyncList, 0);
+
+    FUNCTION_LOG_RETURN_VOID();
+}
+
+/***********************************************************************************************************************************
+Send the part buffer to S3 without waiting for a response
+***********************************************************************************************************************************/
+static void
+storageDriverS3FileWritePart(StorageDriverS3FileWrite *this)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(STORAGE_DRIVER_S3_FILE_WRITE, this);
+    FUNCTION_LOG_END();
+
+    ASSERT(this != NULL);
+    ASSERT(this->partBuffer != NULL);
+
+    // Initiate the multi-part upload if this is the first part
+    if (this->uploadId == NULL)
+    {
+        MEM_CONTEXT_TEMP_BEGIN()
+        {
+            HttpQuery *query = httpQueryAdd(httpQueryNew(), S3_QUERY_UPLOADS_STR, EMPTY_STR);
+
+            XmlNode *xmlRoot = xmlDocumentRoot(
+                xmlDocumentNewBuf(storageDriverS3Request(this->storage, HTTP_VERB_POST_STR, this->name, query, NULL, true, false)));
+
+            MEM_CONTEXT_BEGIN(this->memContext)
+            {
+                this->uploadId = xmlNodeContent(xmlNodeChild(xmlRoot, S3_XML_TAG_UPLOAD_ID_STR, true));
+                this->uploadPartList = strLstNew();
+            }
+            MEM_CONTEXT_END();
+        }
+        MEM_CONTEXT_TEMP_END();
+    }
+
+    // If the max parts are already in flight then wait for the oldest to complete.  This frees a client for the next part.
+    if (lstSize(this->partAsyncList) >= storageDriverS3PartAsyncMax(this->storage))
+        storageDriverS3FileWritePartComplete(this);
+
+    // Send the part
+    MEM_CONTEXT_BEGIN(this->memContext)
+    {
+        MEM_CONTEXT_NEW_BEGIN("StorageDriverS3FileWritePart")
+        {
+            StorageDriverS3FileWritePart part =
+            {
+                .memContext = MEM_CONTEXT_NEW(),
+                .httpClient = storageDriverS3HttpClient(this->storage),
+                .query = httpQueryNew(),
+                .buffer = bufMove(this->partBuffer, MEM_CONTEXT_NEW()),
+            };
+
+            httpQueryAdd(part.query, S3_QUERY_PART_NUMBER_STR, strNewFmt("%u", this->partTotal + 1));
+            httpQueryAdd(part.query, S3_QUERY_UPLOAD_ID_STR, this->uploadId);
+
+            part.header = storageDriverS3RequestAsync(
+                this->storage, part.httpClient, HTTP_VERB_PUT_STR, this->name, part.query, NULL, part.buffer);
+
+            lstAdd(this->partAsyncList, &part);
+        }
+        MEM_CONTEXT_NEW_END();
+
+        // Start a new part
+        this->partBuffer = bufNew(this->partSize);
+    }
+    MEM_CONTEXT_END();
+
+    this->partTotal++;
+
+    FUNCTION_LOG_RETURN_VOID();
+}
+
+/***********************************************************************************************************************************
+Write to the file
+***********************************************************************************************************************************/
+void
+storageDriverS3FileWrite(StorageDriverS3FileWrite *this, const Buffer *buffer)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(STORAGE_DRIVER_S3_FILE_WRITE, this);
+        FUNCTION_LOG_PARAM(BUFFER, buffer);
+    FUNCTION_LOG_END();
+
+    ASSERT(this != NULL);
+    ASSERT(this->partBuffer != NULL);
+    ASSERT(buffer != NULL);
+
+    size_t bytesTotal = 0;
+
+    // Copy the buffer into parts, sending each part as soon as it is full
+    while (bytesTotal < bufUsed(buffer))
+    {
+        size_t bytesNext = bufUsed(buffer) - bytesTotal;
+
+        if (bytesNext > bufRemains(this->partBuffer))
+            bytesNext = bufRemains(this->partBuffer);
+
+        bufCatSub(this->partBuffer, buffer, bytesTotal, bytesNext);
+        bytesTotal += bytesNext;
+
+        if (bufFull(this->partBuffer))
+            storageDriverS3FileWritePart(this);
+    }
+
+    FUNCTION_LOG_RETURN_VOID();
+}
+
+/***********************************************************************************************************************************
+Close the file
+***********************************************************************************************************************************/
+void
+storageDriverS3FileWriteClose(StorageDriverS3FileWrite *this)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(STORAGE_DRIVER_S3_FILE_WRITE, this);
+    FUNCTION_LOG_END();
+
+    ASSERT(this != NULL);
+
+    // Close if the file has not already been closed
+    if (this->partBuffer != NULL)
+    {
+        MEM_CONTEXT_TEMP_BEGIN()
+        {
+            // If a multi-part upload was started then send the last part and complete the upload
+            if (this->uploadId != NULL)
+            {
+                if (bufUsed(this->partBuffer) > 0)
+                    storageDriverS3FileWritePart(this);
+
+                while (lstSize(this->partAsyncList) > 0)
+                    storageDriverS3FileWritePartComplete(this);
+
+                // Generate the part list
+                String *xml = strNew("<?xml version=\"1.0\" encoding=\"UTF-8\"?><CompleteMultipartUpload>");
+
+                for (unsigned int partIdx = 0; partIdx < strLstSize(this->uploadPartList); partIdx++)
+                {
+                    strCatFmt(
+                        xml, "<Part><PartNumber>%u</PartNumber><ETag>%s</ETag></Part>", partIdx + 1,
+                        strPtr(strLstGet(this->uploadPartList, partIdx)));
+                }
+
+                strCat(xml, "</CompleteMultipartUpload>");
+
+                // Finalize the upload
+                HttpQuery *query = httpQueryAdd(httpQueryNew(), S3_QUERY_UPLOAD_ID_STR, this->uploadId);
+
+                XmlNode *xmlRoot = xmlDocumentRoot(
+                    xmlDocumentNewBuf(
+                        storageDriverS3Request(
+                            this->storage, HTTP_VERB_POST_STR, this->name, query, bufNewStr(xml), true, false)));
+
+                // S3 may report an error in the content of a 200 response since the response is sent before completion finishes
+                const XmlNode *xmlCode = xmlNodeChild(xmlRoot, S3_XML_TAG_CODE_STR, false);
+
+                if (xmlCode != NULL)
+                {
+                    THROW_FMT(
+                        ProtocolError, "unable to complete upload of '%s': [%s] %s", strPtr(this->name),
+                        strPtr(xmlNodeContent((XmlNode *)xmlCode)),
+                        strPtr(xmlNodeContent(xmlNodeChild(xmlRoot, S3_XML_TAG_MESSAGE_STR, true))));
+                }
+            }
+            // Else the file fit in a single part so send it all at once
+            else
+                storageDriverS3Request(this->storage, HTTP_VERB_PUT_STR, this->name, NULL, this->partBuffer, true, false);
+        }
+        MEM_CONTEXT_TEMP_END();
+
+        // This marks the file as closed
+        bufFree(this->partBuffer);
+        this->partBuffer = NULL;
+    }
+
+    FUNCTION_LOG_RETURN_VOID();
+}
+
+/***********************************************************************************************************************************
+S3 object writes are always atomic -- the object is not visible until the upload is complete
+***********************************************************************************************************************************/
+bool
+storageDriverS3FileWriteAtomic(const StorageDriverS3FileWrite *this)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(STORAGE_DRIVER_S3_FILE_WRITE, this);
+    FUNCTION_LOG_END();
+
+    ASSERT(this != NULL);
+
+    FUNCTION_LOG_RETURN(BOOL, true);
+}
+
+/***********************************************************************************************************************************
+There are no physical paths on S3 so paths are always "created"
+***********************************************************************************************************************************/
+bool
+storageDriverS3FileWriteCreatePath(const StorageDriverS3FileWrite *this)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(STORAGE_DRIVER_S3_FILE_WRITE, this);
+    FUNCTION_LOG_END();
+
+    ASSERT(this != NULL);
+
+    FUNCTION_LOG_RETURN(BOOL, true);
+}
+
+/***********************************************************************************************************************************
+Get interface
+***********************************************************************************************************************************/
+StorageFileWrite *
+storageDriverS3FileWriteInterface(const StorageDriverS3FileWrite *this)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(STORAGE_DRIVER_S3_FILE_WRITE, this);
+    FUNCTION_TEST_END();
+
+    ASSERT(this != NULL);
+
+    FUNCTION_TEST_RETURN(this->interface);
+}
+
+/***********************************************************************************************************************************
+Get I/O interface
+***********************************************************************************************************************************/
+IoWrite *
+storageDriverS3FileWriteIo(const StorageDriverS3FileWrite *this)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(STORAGE_DRIVER_S3_FILE_WRITE, this);
+    FUNCTION_TEST_END();
+
+    ASSERT(this != NULL);
+
+    FUNCTION_TEST_RETURN(this->io);
+}
+
+/***********************************************************************************************************************************
+Modes are not supported on S3
+***********************************************************************************************************************************/
+mode_t
+storageDriverS3FileWriteModeFile(const StorageDriverS3FileWrite *this)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(STORAGE_DRIVER_S3_FILE_WRITE, this);
+    FUNCTION_LOG_END();
+
+    ASSERT(this != NULL);
+
+    FUNCTION_LOG_RETURN(MODE, 0);
+}
+
+mode_t
+storageDriverS3FileWriteModePath(const StorageDriverS3FileWrite *this)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(STORAGE_DRIVER_S3_FILE_WRITE, this);
+    FUNCTION_LOG_END();
+
+    ASSERT(this != NULL);
+
+    FUNCTION_LOG_RETURN(MODE, 0);
+}
+
+/***********************************************************************************************************************************
+File name
+***********************************************************************************************************************************/
+const String *
+storageDriverS3FileWriteName(const StorageDriverS3FileWrite *this)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(STORAGE_DRIVER_S3_FILE_WRITE, this);
+    FUNCTION_TEST_END();
+
+    ASSERT(this != NULL);
+
+    FUNCTION_TEST_RETURN(this->name);
+}
+
+/***********************************************************************************************************************************
+S3 is always consistent once the upload is complete so there is nothing to sync
+***********************************************************************************************************************************/
+bool
+storageDriverS3FileWriteSyncFile(const StorageDriverS3FileWrite *this)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(STORAGE_DRIVER_S3_FILE_WRITE, this);
+    FUNCTION_LOG_END();
+
+    ASSERT(this != NULL);
+
+    FUNCTION_LOG_RETURN(BOOL, true);
+}
+
+bool
+storageDriverS3FileWriteSyncPath(const StorageDriverS3FileWrite *this)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(STORAGE_DRIVER_S3_FILE_WRITE, this);
+    FUNCTION_LOG_END();
+
+    ASSERT(this != NULL);
+
+    FUNCTION_LOG_RETURN(BOOL, true);
+}
@@ -0,0 +1,54 @@
+/***********************************************************************************************************************************
+S3 Storage File Write Driver
+
+Files smaller than the part size are written with a single PUT request.  Larger files are uploaded in parts using the S3 multi-part
+upload API.  Each part is sent asynchronously so several parts can be in flight at once, which allows the upload to continue while
+S3 processes prior parts.
+***********************************************************************************************************************************/
+#ifndef STORAGE_DRIVER_S3_FILEWRITE_H
+#define STORAGE_DRIVER_S3_FILEWRITE_H
+
+/***********************************************************************************************************************************
+Object type
+***********************************************************************************************************************************/
+typedef struct StorageDriverS3FileWrite StorageDriverS3FileWrite;
+
+#include "common/type/buffer.h"
+#include "common/type/string.h"
+#include "storage/driver/s3/storage.h"
+#include "storage/fileWrite.h"
+
+/***********************************************************************************************************************************
+Constructor
+***********************************************************************************************************************************/
+StorageDriverS3FileWrite *storageDriverS3FileWriteNew(StorageDriverS3 *storage, const String *name, size_t partSize);
+
+/***********************************************************************************************************************************
+Functions
+***********************************************************************************************************************************/
+void storageDriverS3FileWriteOpen(StorageDriverS3FileWrite *this);
+void storageDriverS3FileWrite(StorageDriverS3FileWrite *this, const Buffer *buffer);
+void storageDriverS3FileWriteClose(StorageDriverS3FileWrite *this);
+
+/***********************************************************************************************************************************
+Getters
+***********************************************************************************************************************************/
+bool storageDriverS3FileWriteAtomic(const StorageDriverS3FileWrite *this);
+bool storageDriverS3FileWriteCreatePath(const StorageDriverS3FileWrite *this);
+mode_t storageDriverS3FileWriteModeFile(const StorageDriverS3FileWrite *this);
+StorageFileWrite* storageDriverS3FileWriteInterface(const StorageDriverS3FileWrite *this);
+IoWrite *storageDriverS3FileWriteIo(const StorageDriverS3FileWrite *this);
+mode_t storageDriverS3FileWriteModePath(const StorageDriverS3FileWrite *this);
+const String *storageDriverS3FileWriteName(const StorageDriverS3FileWrite *this);
+bool storageDriverS3FileWriteSyncFile(const StorageDriverS3FileWrite *this);
+bool storageDriverS3FileWriteSyncPath(const StorageDriverS3FileWrite *this);
+
+/***********************************************************************************************************************************
+Macros for function logging
+***********************************************************************************************************************************/
+#define FUNCTION_LOG_STORAGE_DRIVER_S3_FILE_WRITE_TYPE                                                                             \
+    StorageDriverS3FileWrite *
+#define FUNCTION_LOG_STORAGE_DRIVER_S3_FILE_WRITE_FORMAT(value, buffer, bufferSize)                                                \
+    objToLog(value, "StorageDriverS3FileWrite", buffer, bufferSize)
+
+#endif
@@ -4,13 +4,18 @@ S3 Storage Driver
 #include <time.h>
 
 #include "common/debug.h"
+#include "common/encode.h"
+#include "common/io/http/cache.h"
 #include "common/io/http/common.h"
 #include "common/log.h"
 #include "common/memContext.h"
 #include "common/regExp.h"
+#include "common/type/convert.h"
+#include "common/type/list.h"
 #include "common/type/xml.h"
 #include "crypto/hash.h"
 #include "storage/driver/s3/fileRead.h"
+#include "storage/driver/s3/fileWrite.h"
 #include "storage/driver/s3/storage.h"
 
 /***********************************************************************************************************************************
@@ -27,10 +32,17 @@ STRING_STATIC(S3_HEADER_DATE_STR,                                   "x-amz-date"
 STRING_STATIC(S3_HEADER_HOST_STR,                                   "host");
 STRING_STATIC(S3_HEADER_TOKEN_STR,                                  "x-amz-security-token");
 
+/***********************************************************************************************************************************
+SHA256 hash of an empty payload
+***********************************************************************************************************************************/
+STRING_STATIC(
+    S3_PAYLOAD_EMPTY_SHA256_STR, "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855");
+
 /***********************************************************************************************************************************
 S3 query tokens
 ***********************************************************************************************************************************/
 STRING_STATIC(S3_QUERY_CONTINUATION_TOKEN_STR,                      "continuation-token");
+STRING_STATIC(S3_QUERY_DELETE_STR,                                  "delete");
 STRING_STATIC(S3_QUERY_DELIMITER_STR,                               "delimiter");
 STRING_STATIC(S3_QUERY_LIST_TYPE_STR,                               "list-type");
 STRING_STATIC(S3_QUERY_PREFIX_STR,                                  "prefix");
@@ -41,10 +53,14 @@ STRING_STATIC(S3_QUERY_VALUE_LIST_TYPE_2_STR,                       "2");
 XML tags
 ***********************************************************************************************************************************/
 STRING_STATIC(S3_XML_TAG_COMMON_PREFIXES_STR,                       "CommonPrefixes");
+STRING_EXTERN(S3_XML_TAG_CODE_STR,                                  S3_XML_TAG_CODE);
 STRING_STATIC(S3_XML_TAG_CONTENTS_STR,                              "Contents");
+STRING_STATIC(S3_XML_TAG_ERROR_STR,                                 "Error");
 STRING_STATIC(S3_XML_TAG_KEY_STR,                                   "Key");
+STRING_EXTERN(S3_XML_TAG_MESSAGE_STR,                               S3_XML_TAG_MESSAGE);
 STRING_STATIC(S3_XML_TAG_NEXT_CONTINUATION_TOKEN_STR,               "NextContinuationToken");
 STRING_STATIC(S3_XML_TAG_PREFIX_STR,                                "Prefix");
+STRING_STATIC(S3_XML_TAG_SIZE_STR,                                  "Size");
 
 /***********************************************************************************************************************************
 AWS authentication v4 constants
@@ -66,7 +82,7 @@ struct StorageDriverS3
 {
     MemContext *memContext;
     Storage *interface;                                             // Driver interface
-    HttpClient *httpClient;                                         // Http client to service requests
+    HttpClientCache *httpClientCache;                               // Http clients to service requests
     const StringList *headerRedactList;                             // List of headers to redact from logging
 
     const String *bucket;                                           // Bucket to store data in
@@ -76,6 +92,12 @@ struct StorageDriverS3
     const String *securityToken;                                    // Security token, if any
     const String *host;                                             // Defaults to {bucket}.{endpoint}
 
+    size_t partSize;                                                // Part size for multi-part uploads
+    unsigned int partAsyncMax;                                      // Max parts that can be in flight at once during upload
+    unsigned int deleteMax;                                         // Max files that can be deleted in one request
+    unsigned int deleteAsyncMax;                                    // Max delete requests that can be in flight at once
+    unsigned int listAsyncMax;                                      // Max list requests that can be in flight at once
+
     // Current signing key and date it is valid for
     const String *signingKeyDate;                                   // Date of cached signing key (so we know when to regenerate)
     const Buffer *signingKey;                                       // Cached signing key
@@ -256,6 +278,11 @@ storageDriverS3New(
         this->secretAccessKey = strDup(secretAccessKey);
         this->securityToken = strDup(securityToken);
         this->host = host == NULL ? strNewFmt("%s.%s", strPtr(bucket), strPtr(endPoint)) : strDup(host);
+        this->partSize = STORAGE_DRIVER_S3_PART_SIZE_DEFAULT;
+        this->partAsyncMax = STORAGE_DRIVER_S3_PART_ASYNC_MAX_DEFAULT;
+        this->deleteMax = STORAGE_DRIVER_S3_DELETE_MAX_DEFAULT;
+        this->deleteAsyncMax = STORAGE_DRIVER_S3_DELETE_ASYNC_MAX_DEFAULT;
+        this->listAsyncMax = STORAGE_DRIVER_S3_LIST_ASYNC_MAX_DEFAULT;
 
         // Force the signing key to be generated on the first run
         this->signingKeyDate = YYYYMMDD_STR;
@@ -264,14 +291,15 @@ storageDriverS3New(
         this->interface = storageNewP(
             STORAGE_DRIVER_S3_TYPE_STR, path, 0, 0, write, pathExpressionFunction, this,
             .exists = (StorageInterfaceExists)storageDriverS3Exists, .info = (StorageInterfaceInfo)storageDriverS3Info,
-            .list = (StorageInterfaceList)storageDriverS3List, .newRead = (StorageInterfaceNewRead)storageDriverS3NewRead,
+            .list = (StorageInterfaceList)storageDriverS3List, .listEach = (StorageInterfaceListEach)storageDriverS3ListEach,
+            .newRead = (StorageInterfaceNewRead)storageDriverS3NewRead,
             .newWrite = (StorageInterfaceNewWrite)storageDriverS3NewWrite,
             .pathCreate = (StorageInterfacePathCreate)storageDriverS3PathCreate,
             .pathRemove = (StorageInterfacePathRemove)storageDriverS3PathRemove,
             .pathSync = (StorageInterfacePathSync)storageDriverS3PathSync, .remove = (StorageInterfaceRemove)storageDriverS3Remove);
 
-        // Create the http client used to service requests
-        this->httpClient = httpClientNew(this->host, port, timeout, verifyPeer, caFile, caPath);
+        // Create the http client cache used to service requests
+        this->httpClientCache = httpClientCacheNew(this->host, port, timeout, verifyPeer, caFile, caPath);
         this->headerRedactList = strLstAdd(strLstNew(), S3_HEADER_AUTHORIZATION_STR);
     }
     MEM_CONTEXT_NEW_END();
@@ -280,51 +308,118 @@ storageDriverS3New(
 }
 
 /***********************************************************************************************************************************
-Process S3 request
+Send an S3 request without waiting for the response
+
+The signed request header is returned because it must be passed to storageDriverS3Response() with the uri and query.  These, along
+with the body, must remain valid until the response has been read.
 ***********************************************************************************************************************************/
-Buffer *
-storageDriverS3Request(
-    StorageDriverS3 *this, const String *verb, const String *uri, const HttpQuery *query, const Buffer *body, bool returnContent,
-    bool allowMissing)
+HttpHeader *
+storageDriverS3RequestAsync(
+    StorageDriverS3 *this, HttpClient *httpClient, const String *verb, const String *uri, const HttpQuery *query,
+    const HttpHeader *header, const Buffer *body)
 {
     FUNCTION_LOG_BEGIN(logLevelDebug);
         FUNCTION_LOG_PARAM(STORAGE_DRIVER_S3, this);
+        FUNCTION_LOG_PARAM(HTTP_CLIENT, httpClient);
         FUNCTION_LOG_PARAM(STRING, verb);
         FUNCTION_LOG_PARAM(STRING, uri);
         FUNCTION_LOG_PARAM(HTTP_QUERY, query);
+        FUNCTION_LOG_PARAM(HTTP_HEADER, header);
         FUNCTION_LOG_PARAM(BUFFER, body);
-        FUNCTION_LOG_PARAM(BOOL, returnContent);
-        FUNCTION_LOG_PARAM(BOOL, allowMissing);
     FUNCTION_LOG_END();
 
     ASSERT(this != NULL);
+    ASSERT(httpClient != NULL);
     ASSERT(verb != NULL);
     ASSERT(uri != NULL);
 
-    Buffer *result = NULL;
+    HttpHeader *result = NULL;
 
     MEM_CONTEXT_TEMP_BEGIN()
     {
         // Create header list and add content length
         HttpHeader *requestHeader = httpHeaderNew(this->headerRedactList);
-        httpHeaderAdd(requestHeader, HTTP_HEADER_CONTENT_LENGTH_STR, ZERO_STR);
+        httpHeaderAdd(
+            requestHeader, HTTP_HEADER_CONTENT_LENGTH_STR, body == NULL ? ZERO_STR : strNewFmt("%zu", bufUsed(body)));
+
+        // Add headers passed by the caller so they are included in the signature
+        if (header != NULL)
+        {
+            const StringList *headerList = httpHeaderList(header);
+
+            for (unsigned int headerIdx = 0; headerIdx < strLstSize(headerList); headerIdx++)
+            {
+                const String *headerKey = strLstGet(headerList, headerIdx);
+                httpHeaderAdd(requestHeader, headerKey, httpHeaderGet(header, headerKey));
+            }
+        }
+
+        // Add content md5 so S3 can verify the content was not corrupted in transit.  This is required for some requests, e.g.
+        // multi-object delete.
+        if (body != NULL && bufUsed(body) > 0)
+        {
+            const Buffer *md5 = cryptoHashOneC(HASH_TYPE_MD5_STR, bufPtr(body), bufUsed(body));
+            char *md5Base64 = memNew(encodeToStrSize(encodeBase64, bufUsed(md5)) + 1);
+
+            encodeToStr(encodeBase64, bufPtr(md5), bufUsed(md5), md5Base64);
+            httpHeaderAdd(requestHeader, HTTP_HEADER_CONTENT_MD5_STR, strNew(md5Base64));
+        }
 
         // Generate authorization header
         storageDriverS3Auth(
             this, verb, uri, query, storageDriverS3DateTime(time(NULL)), requestHeader,
-            strNew("e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855"));
+            body == NULL || bufUsed(body) == 0 ?
+                S3_PAYLOAD_EMPTY_SHA256_STR : bufHex(cryptoHashOneC(HASH_TYPE_SHA256_STR, bufPtr(body), bufUsed(body))));
+
+        // Send request
+        httpClientRequestAsync(httpClient, verb, uri, query, requestHeader, body);
+
+        // Move the header to the calling context
+        result = httpHeaderMove(requestHeader, MEM_CONTEXT_OLD());
+    }
+    MEM_CONTEXT_TEMP_END();
+
+    FUNCTION_LOG_RETURN(HTTP_HEADER, result);
+}
+
+/***********************************************************************************************************************************
+Read the response to an S3 request and error if it was not successful
+***********************************************************************************************************************************/
+Buffer *
+storageDriverS3Response(
+    StorageDriverS3 *this, HttpClient *httpClient, const String *uri, const HttpQuery *query, const HttpHeader *requestHeader,
+    bool returnContent, bool allowMissing)
+{
+    FUNCTION_LOG_BEGIN(logLevelDebug);
+        FUNCTION_LOG_PARAM(STORAGE_DRIVER_S3, this);
+        FUNCTION_LOG_PARAM(HTTP_CLIENT, httpClient);
+        FUNCTION_LOG_PARAM(STRING, uri);
+        FUNCTION_LOG_PARAM(HTTP_QUERY, query);
+        FUNCTION_LOG_PARAM(HTTP_HEADER, requestHeader);
+        FUNCTION_LOG_PARAM(BOOL, returnContent);
+        FUNCTION_LOG_PARAM(BOOL, allowMissing);
+    FUNCTION_LOG_END();
+
+    ASSERT(this != NULL);
+    ASSERT(httpClient != NULL);
+    ASSERT(uri != NULL);
+    ASSERT(requestHeader != NULL);
+
+    Buffer *result = NULL;
 
-        // Process request
-        result = httpClientRequest(this->httpClient, verb, uri, query, requestHeader, returnContent);
+    MEM_CONTEXT_TEMP_BEGIN()
+    {
+        // Wait for the response
+        result = httpClientResponse(httpClient, returnContent);
 
         // Error if the request was not successful
-        if (httpClientResponseCode(this->httpClient) != HTTP_RESPONSE_CODE_OK &&
-            (!allowMissing || httpClientResponseCode(this->httpClient) != HTTP_RESPONSE_CODE_NOT_FOUND))
+        if (!httpClientResponseCodeOk(httpClient) &&
+            (!allowMissing || httpClientResponseCode(httpClient) != HTTP_RESPONSE_CODE_NOT_FOUND))
         {
             // General error message
             String *error = strNewFmt(
-                "S3 request failed with %u: %s", httpClientResponseCode(this->httpClient),
-                strPtr(httpClientResponseMessage(this->httpClient)));
+                "S3 request failed with %u: %s", httpClientResponseCode(httpClient),
+                strPtr(httpClientResponseMessage(httpClient)));
 
             // Output uri/query
             strCat(error, "\n*** URI/Query ***:");
@@ -350,7 +445,7 @@ storageDriverS3Request(
             }
 
             // Output response headers
-            const HttpHeader *responseHeader = httpClientReponseHeader(this->httpClient);
+            const HttpHeader *responseHeader = httpClientReponseHeader(httpClient);
             const StringList *responseHeaderList = httpHeaderList(responseHeader);
 
             if (strLstSize(responseHeaderList) > 0)
@@ -379,6 +474,43 @@ storageDriverS3Request(
     FUNCTION_LOG_RETURN(BUFFER, result);
 }
 
+/***********************************************************************************************************************************
+Process S3 request
+***********************************************************************************************************************************/
+Buffer *
+storageDriverS3Request(
+    StorageDriverS3 *this, const String *verb, const String *uri, const HttpQuery *query, const Buffer *body, bool returnContent,
+    bool allowMissing)
+{
+    FUNCTION_LOG_BEGIN(logLevelDebug);
+        FUNCTION_LOG_PARAM(STORAGE_DRIVER_S3, this);
+        FUNCTION_LOG_PARAM(STRING, verb);
+        FUNCTION_LOG_PARAM(STRING, uri);
+        FUNCTION_LOG_PARAM(HTTP_QUERY, query);
+        FUNCTION_LOG_PARAM(BUFFER, body);
+        FUNCTION_LOG_PARAM(BOOL, returnContent);
+        FUNCTION_LOG_PARAM(BOOL, allowMissing);
+    FUNCTION_LOG_END();
+
+    ASSERT(this != NULL);
+    ASSERT(verb != NULL);
+    ASSERT(uri != NULL);
+
+    Buffer *result = NULL;
+
+    MEM_CONTEXT_TEMP_BEGIN()
+    {
+        HttpClient *httpClient = httpClientCacheGet(this->httpClientCache);
+        HttpHeader *requestHeader = storageDriverS3RequestAsync(this, httpClient, verb, uri, query, NULL, body);
+
+        result = storageDriverS3Response(this, httpClient, uri, query, requestHeader, returnContent, allowMissing);
+        bufMove(result, MEM_CONTEXT_OLD());
+    }
+    MEM_CONTEXT_TEMP_END();
+
+    FUNCTION_LOG_RETURN(BUFFER, result);
+}
+
 /***********************************************************************************************************************************
 Does a file/path exist?
 ***********************************************************************************************************************************/
@@ -449,29 +581,108 @@ storageDriverS3Info(StorageDriverS3 *this, const String *file, bool ignoreMissin
 }
 
 /***********************************************************************************************************************************
-Get a list of files from a directory
+List request that has been sent but whose response has not been read yet
 ***********************************************************************************************************************************/
-StringList *
-storageDriverS3List(StorageDriverS3 *this, const String *path, bool errorOnMissing, const String *expression)
+typedef struct StorageDriverS3ListAsync
 {
-    FUNCTION_LOG_BEGIN(logLevelDebug);
+    MemContext *memContext;                                         // Context for request data
+    const String *prefix;                                           // Prefix being listed
+    bool delimiter;                                                 // Is the list limited to a single level?
+    HttpClient *httpClient;                                         // Http client the request was sent on
+    HttpQuery *query;                                               // Request query
+    HttpHeader *header;                                             // Signed request header
+} StorageDriverS3ListAsync;
+
+/***********************************************************************************************************************************
+Send a list request without waiting for the response
+***********************************************************************************************************************************/
+static void
+storageDriverS3ListSend(
+    StorageDriverS3 *this, List *listAsyncList, const String *prefix, bool delimiter, const String *continuationToken)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(STORAGE_DRIVER_S3, this);
+        FUNCTION_LOG_PARAM(LIST, listAsyncList);
+        FUNCTION_LOG_PARAM(STRING, prefix);
+        FUNCTION_LOG_PARAM(BOOL, delimiter);
+        FUNCTION_LOG_PARAM(STRING, continuationToken);
+    FUNCTION_LOG_END();
+
+    ASSERT(this != NULL);
+    ASSERT(listAsyncList != NULL);
+    ASSERT(prefix != NULL);
+
+    MEM_CONTEXT_BEGIN(lstMemContext(listAsyncList))
+    {
+        MEM_CONTEXT_NEW_BEGIN("StorageDriverS3ListAsync")
+        {
+            StorageDriverS3ListAsync listAsync =
+            {
+                .memContext = MEM_CONTEXT_NEW(),
+                .prefix = strDup(prefix),
+                .delimiter = delimiter,
+                .httpClient = storageDriverS3HttpClient(this),
+                .query = httpQueryNew(),
+            };
+
+            // Add continuation token from the prior page if any
+            if (continuationToken != NULL)
+                httpQueryAdd(listAsync.query, S3_QUERY_CONTINUATION_TOKEN_STR, continuationToken);
+
+            // Add the delimiter to list a single level
+            if (delimiter)
+                httpQueryAdd(listAsync.query, S3_QUERY_DELIMITER_STR, FSLASH_STR);
+
+            // Use list type 2
+            httpQueryAdd(listAsync.query, S3_QUERY_LIST_TYPE_STR, S3_QUERY_VALUE_LIST_TYPE_2_STR);
+
+            // Don't specify empty prefix because it is the default
+            if (!strEmpty(prefix))
+                httpQueryAdd(listAsync.query, S3_QUERY_PREFIX_STR, prefix);
+
+            listAsync.header = storageDriverS3RequestAsync(
+                this, listAsync.httpClient, HTTP_VERB_GET_STR, FSLASH_STR, listAsync.query, NULL, NULL);
+
+            lstAdd(listAsyncList, &listAsync);
+        }
+        MEM_CONTEXT_NEW_END();
+    }
+    MEM_CONTEXT_END();
+
+    FUNCTION_LOG_RETURN_VOID();
+}
+
+/***********************************************************************************************************************************
+Call a function for each file/path in a directory, optionally recursing into sub-paths
+
+Results are passed to the callback one page at a time so memory usage does not depend on the number of files.  The request for the
+next page is sent before the current page is processed so the page is retrieved while the callback is running.
+
+When recurse is true the first level is listed with a delimiter and each sub-path found is then listed without a delimiter.  These
+lists are run in parallel on separate http clients, up to listAsyncMax at a time.  This works well for paths like the archive where
+files are spread across many sub-paths (e.g. the WAL paths under archive/<id>).  Since S3 has no physical paths only files are
+reported in this mode and names include the sub-path.
+***********************************************************************************************************************************/
+static void
+storageDriverS3ListInternal(
+    StorageDriverS3 *this, const String *path, bool recurse, const String *expression, StorageListEachCallback callback,
+    void *callbackData)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace);
         FUNCTION_LOG_PARAM(STORAGE_DRIVER_S3, this);
         FUNCTION_LOG_PARAM(STRING, path);
-        FUNCTION_LOG_PARAM(BOOL, errorOnMissing);
+        FUNCTION_LOG_PARAM(BOOL, recurse);
         FUNCTION_LOG_PARAM(STRING, expression);
+        FUNCTION_LOG_PARAM(FUNCTIONP, callback);
+        FUNCTION_LOG_PARAM_P(VOID, callbackData);
     FUNCTION_LOG_END();
 
     ASSERT(this != NULL);
     ASSERT(path != NULL);
-    ASSERT(!errorOnMissing);
-
-    StringList *result = NULL;
+    ASSERT(callback != NULL);
 
     MEM_CONTEXT_TEMP_BEGIN()
     {
-        result = strLstNew();
-        const String *continuationToken = NULL;
-
         // Prepare regexp if an expression was passed
         RegExp *regExp = (expression == NULL) ? NULL : regExpNew(expression);
 
@@ -499,31 +710,35 @@ storageDriverS3List(StorageDriverS3 *this, const String *path, bool errorOnMissi
                 queryPrefix = strNewFmt("%s%s", strPtr(basePrefix), strPtr(expressionPrefix));
         }
 
-        // Loop as long as a continuation token returned
+        // Requests in flight and sub-paths waiting to be listed when recursing
+        List *listAsyncList = lstNew(sizeof(StorageDriverS3ListAsync));
+        StringList *subPathPendingList = strLstNewArena();
+        unsigned int subPathPendingIdx = 0;
+
+        storageDriverS3ListSend(this, listAsyncList, queryPrefix, true, NULL);
+
+        // Loop as long as there are requests in flight
         do
         {
             // Use an inner mem context here because we could potentially be retrieving millions of files so it is a good idea to
             // free memory at regular intervals
             MEM_CONTEXT_TEMP_BEGIN()
             {
-                HttpQuery *query = httpQueryNew();
-
-                // Add continuation token from the prior loop if any
-                if (continuationToken != NULL)
-                    httpQueryAdd(query, S3_QUERY_CONTINUATION_TOKEN_STR, continuationToken);
-
-                // Add the delimiter so we don't recurse
-                httpQueryAdd(query, S3_QUERY_DELIMITER_STR, FSLASH_STR);
+                // Copy the oldest request out of the list since more requests may be added below
+                StorageDriverS3ListAsync listAsync = *(StorageDriverS3ListAsync *)lstGet(listAsyncList, 0);
+                lstRemove(listAsyncList, 0);
 
-                // Use list type 2
-                httpQueryAdd(query, S3_QUERY_LIST_TYPE_STR, S3_QUERY_VALUE_LIST_TYPE_2_STR);
+                XmlNode *xmlRoot = xmlDocumentRoot(
+                    xmlDocumentNewBuf(
+                        storageDriverS3Response(
+                            this, listAsync.httpClient, FSLASH_STR, listAsync.query, listAsync.header, true, false)));
 
-                // Don't specified empty prefix because it is the default
-                if (!strEmpty(queryPrefix))
-                    httpQueryAdd(query, S3_QUERY_PREFIX_STR, queryPrefix);
+                // Request the next page right away so it is retrieved while this page is being processed
+                const String *continuationToken = xmlNodeContent(
+                    xmlNodeChild(xmlRoot, S3_XML_TAG_NEXT_CONTINUATION_TOKEN_STR, false));
 
-                XmlNode *xmlRoot = xmlDocumentRoot(
-                    xmlDocumentNewBuf(storageDriverS3Request(this, HTTP_VERB_GET_STR, FSLASH_STR, query, NULL, true, false)));
+                if (continuationToken != NULL)
+                    storageDriverS3ListSend(this, listAsyncList, listAsync.prefix, listAsync.delimiter, continuationToken);
 
                 // Get subpath list
                 XmlNodeList *subPathList = xmlNodeChildList(xmlRoot, S3_XML_TAG_COMMON_PREFIXES_STR);
@@ -534,12 +749,16 @@ storageDriverS3List(StorageDriverS3 *this, const String *path, bool errorOnMissi
                     const String *subPath = xmlNodeContent(
                         xmlNodeChild(xmlNodeLstGet(subPathList, subPathIdx), S3_XML_TAG_PREFIX_STR, true));
 
-                    // Strip off base prefix and final /
-                    subPath = strSubN(subPath, strSize(basePrefix), strSize(subPath) - strSize(basePrefix) - 1);
+                    // When recursing the subpath will be listed later, else strip off base prefix and final / and report it
+                    if (recurse)
+                        strLstAdd(subPathPendingList, subPath);
+                    else
+                    {
+                        subPath = strSubN(subPath, strSize(basePrefix), strSize(subPath) - strSize(basePrefix) - 1);
 
-                    // Add to list after checking expression if present
-                    if (regExp == NULL || regExpMatch(regExp, subPath))
-                        strLstAdd(result, subPath);
+                        if (regExp == NULL || regExpMatch(regExp, subPath))
+                            callback(callbackData, subPath, (StorageInfo){.exists = true, .type = storageTypePath});
+                    }
                 }
 
                 // Get file list
@@ -547,30 +766,110 @@ storageDriverS3List(StorageDriverS3 *this, const String *path, bool errorOnMissi
 
                 for (unsigned int fileIdx = 0; fileIdx < xmlNodeLstSize(fileList); fileIdx++)
                 {
-                    // Get file name
-                    const String *file = xmlNodeContent(xmlNodeChild(xmlNodeLstGet(fileList, fileIdx), S3_XML_TAG_KEY_STR, true));
+                    XmlNode *fileNode = xmlNodeLstGet(fileList, fileIdx);
 
-                    // Strip off the base prefix when present
+                    // Get file name and strip off the base prefix when present
+                    const String *file = xmlNodeContent(xmlNodeChild(fileNode, S3_XML_TAG_KEY_STR, true));
                     file = strEmpty(basePrefix) ? file : strSub(file, strSize(basePrefix));
 
-                    // Add to list after checking expression if present
+                    // Report file after checking expression if present
                     if (regExp == NULL || regExpMatch(regExp, file))
-                        strLstAdd(result, file);
+                    {
+                        const String *size = xmlNodeContent(xmlNodeChild(fileNode, S3_XML_TAG_SIZE_STR, true));
+
+                        callback(
+                            callbackData, file,
+                            (StorageInfo){.exists = true, .type = storageTypeFile, .size = (size_t)cvtZToUInt64(strPtr(size))});
+                    }
                 }
 
-                // Get the continuation token and store it in the outer temp context
-                memContextSwitch(MEM_CONTEXT_OLD());
-                continuationToken = xmlNodeContent(xmlNodeChild(xmlRoot, S3_XML_TAG_NEXT_CONTINUATION_TOKEN_STR, false));
-                memContextSwitch(MEM_CONTEXT_TEMP());
+                memContextFree(listAsync.memContext);
+
+                // Start listing pending subpaths while there is room for more requests
+                while (subPathPendingIdx < strLstSize(subPathPendingList) && lstSize(listAsyncList) < this->listAsyncMax)
+                    storageDriverS3ListSend(this, listAsyncList, strLstGet(subPathPendingList, subPathPendingIdx++), false, NULL);
             }
             MEM_CONTEXT_TEMP_END();
         }
-        while (continuationToken != NULL);
-
-        strLstMove(result, MEM_CONTEXT_OLD());
+        while (lstSize(listAsyncList) > 0);
     }
     MEM_CONTEXT_TEMP_END();
 
+    FUNCTION_LOG_RETURN_VOID();
+}
+
+/***********************************************************************************************************************************
+Call a function for each file/path in a directory
+
+A single level is listed so there are no sub-paths to fan out to.  The pages of a prefix must be requested in order since each
+continuation token comes from the prior page, so the pages are retrieved serially, though each page is requested before the prior
+page is processed.
+***********************************************************************************************************************************/
+bool
+storageDriverS3ListEach(
+    StorageDriverS3 *this, const String *path, bool errorOnMissing, const String *expression, StorageListEachCallback callback,
+    void *callbackData)
+{
+    FUNCTION_LOG_BEGIN(logLevelDebug);
+        FUNCTION_LOG_PARAM(STORAGE_DRIVER_S3, this);
+        FUNCTION_LOG_PARAM(STRING, path);
+        FUNCTION_LOG_PARAM(BOOL, errorOnMissing);
+        FUNCTION_LOG_PARAM(STRING, expression);
+        FUNCTION_LOG_PARAM(FUNCTIONP, callback);
+        FUNCTION_LOG_PARAM_P(VOID, callbackData);
+    FUNCTION_LOG_END();
+
+    ASSERT(this != NULL);
+    ASSERT(path != NULL);
+    ASSERT(!errorOnMissing);
+    ASSERT(callback != NULL);
+
+    // There are no physical paths on S3 so the path always exists
+    storageDriverS3ListInternal(this, path, false, expression, callback, callbackData);
+
+    FUNCTION_LOG_RETURN(BOOL, true);
+}
+
+/***********************************************************************************************************************************
+Get a list of files from a directory (pages are retrieved as for storageDriverS3ListEach())
+***********************************************************************************************************************************/
+static void
+storageDriverS3ListCallback(void *callbackData, const String *name, StorageInfo info)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM_P(VOID, callbackData);
+        FUNCTION_TEST_PARAM(STRING, name);
+        FUNCTION_TEST_PARAM(STORAGE_INFO, info);
+    FUNCTION_TEST_END();
+
+    ASSERT(callbackData != NULL);
+    ASSERT(name != NULL);
+
+    (void)info;
+
+    strLstAdd((StringList *)callbackData, name);
+
+    FUNCTION_TEST_RETURN_VOID();
+}
+
+StringList *
+storageDriverS3List(StorageDriverS3 *this, const String *path, bool errorOnMissing, const String *expression)
+{
+    FUNCTION_LOG_BEGIN(logLevelDebug);
+        FUNCTION_LOG_PARAM(STORAGE_DRIVER_S3, this);
+        FUNCTION_LOG_PARAM(STRING, path);
+        FUNCTION_LOG_PARAM(BOOL, errorOnMissing);
+        FUNCTION_LOG_PARAM(STRING, expression);
+    FUNCTION_LOG_END();
+
+    ASSERT(this != NULL);
+    ASSERT(path != NULL);
+    ASSERT(!errorOnMissing);
+
+    StringList *result = strLstNew();
+
+    storageDriverS3ListInternal(this, path, false, expression, storageDriverS3ListCallback, result);
+
     FUNCTION_LOG_RETURN(STRING_LIST, result);
 }
 
@@ -578,19 +877,21 @@ storageDriverS3List(StorageDriverS3 *this, const String *path, bool errorOnMissi
 New file read object
 ***********************************************************************************************************************************/
 StorageFileRead *
-storageDriverS3NewRead(StorageDriverS3 *this, const String *file, bool ignoreMissing)
+storageDriverS3NewRead(StorageDriverS3 *this, const String *file, bool ignoreMissing, uint64_t offset, const Variant *limit)
 {
     FUNCTION_LOG_BEGIN(logLevelDebug);
         FUNCTION_LOG_PARAM(STORAGE_DRIVER_S3, this);
         FUNCTION_LOG_PARAM(STRING, file);
         FUNCTION_LOG_PARAM(BOOL, ignoreMissing);
+        FUNCTION_LOG_PARAM(UINT64, offset);
+        FUNCTION_LOG_PARAM(VARIANT, limit);
     FUNCTION_LOG_END();
 
     ASSERT(this != NULL);
     ASSERT(file != NULL);
 
     FUNCTION_LOG_RETURN(
-        STORAGE_FILE_READ, storageDriverS3FileReadInterface(storageDriverS3FileReadNew(this, file, ignoreMissing)));
+        STORAGE_FILE_READ, storageDriverS3FileReadInterface(storageDriverS3FileReadNew(this, file, ignoreMissing, offset, limit)));
 }
 
 /***********************************************************************************************************************************
@@ -617,9 +918,8 @@ storageDriverS3NewWrite(
     ASSERT(modeFile == 0);
     ASSERT(modePath == 0);
 
-    THROW(AssertError, "NOT YET IMPLEMENTED");
-
-    FUNCTION_LOG_RETURN(STORAGE_FILE_WRITE, NULL);
+    FUNCTION_LOG_RETURN(
+        STORAGE_FILE_WRITE, storageDriverS3FileWriteInterface(storageDriverS3FileWriteNew(this, file, this->partSize)));
 }
 
 /***********************************************************************************************************************************
@@ -643,9 +943,168 @@ storageDriverS3PathCreate(StorageDriverS3 *this, const String *path, bool errorO
     FUNCTION_LOG_RETURN_VOID();
 }
 
+/***********************************************************************************************************************************
+Multi-object delete request that has been sent but whose response has not been read yet
+***********************************************************************************************************************************/
+typedef struct StorageDriverS3DeleteAsync
+{
+    MemContext *memContext;                                         // Context for request data
+    HttpClient *httpClient;                                         // Http client the request was sent on
+    HttpQuery *query;                                               // Request query
+    HttpHeader *header;                                             // Signed request header
+    Buffer *body;                                                   // Request body (kept in case the request is retried)
+} StorageDriverS3DeleteAsync;
+
+/***********************************************************************************************************************************
+Wait for the oldest delete request in flight to complete and error if any file could not be removed
+***********************************************************************************************************************************/
+static void
+storageDriverS3PathRemoveComplete(StorageDriverS3 *this, List *deleteAsyncList)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(STORAGE_DRIVER_S3, this);
+        FUNCTION_LOG_PARAM(LIST, deleteAsyncList);
+    FUNCTION_LOG_END();
+
+    ASSERT(this != NULL);
+    ASSERT(deleteAsyncList != NULL);
+    ASSERT(lstSize(deleteAsyncList) > 0);
+
+    StorageDriverS3DeleteAsync *deleteAsync = (StorageDriverS3DeleteAsync *)lstGet(deleteAsyncList, 0);
+
+    MEM_CONTEXT_TEMP_BEGIN()
+    {
+        XmlNode *xmlRoot = xmlDocumentRoot(
+            xmlDocumentNewBuf(
+                storageDriverS3Response(
+                    this, deleteAsync->httpClient, FSLASH_STR, deleteAsync->query, deleteAsync->header, true, false)));
+
+        // Quiet mode was requested so only errors are returned
+        XmlNodeList *errorList = xmlNodeChildList(xmlRoot, S3_XML_TAG_ERROR_STR);
+
+        if (xmlNodeLstSize(errorList) > 0)
+        {
+            XmlNode *error = xmlNodeLstGet(errorList, 0);
+
+            THROW_FMT(
+                PathRemoveError, "unable to remove path/file '/%s': [%s] %s",
+                strPtr(xmlNodeContent(xmlNodeChild(error, S3_XML_TAG_KEY_STR, true))),
+                strPtr(xmlNodeContent(xmlNodeChild(error, S3_XML_TAG_CODE_STR, true))),
+                strPtr(xmlNodeContent(xmlNodeChild(error, S3_XML_TAG_MESSAGE_STR, true))));
+        }
+    }
+    MEM_CONTEXT_TEMP_END();
+
+    memContextFree(deleteAsync->memContext);
+    lstRemove(deleteAsyncList, 0);
+
+    FUNCTION_LOG_RETURN_VOID();
+}
+
+/***********************************************************************************************************************************
+Send a multi-object delete request for a batch of files without waiting for the response
+***********************************************************************************************************************************/
+static void
+storageDriverS3PathRemoveBatch(StorageDriverS3 *this, List *deleteAsyncList, const StringList *keyList)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(STORAGE_DRIVER_S3, this);
+        FUNCTION_LOG_PARAM(LIST, deleteAsyncList);
+        FUNCTION_LOG_PARAM(STRING_LIST, keyList);
+    FUNCTION_LOG_END();
+
+    ASSERT(this != NULL);
+    ASSERT(deleteAsyncList != NULL);
+    ASSERT(keyList != NULL);
+    ASSERT(strLstSize(keyList) > 0);
+
+    // If the max requests are already in flight then wait for the oldest to complete.  This frees a client for the next request.
+    if (lstSize(deleteAsyncList) >= this->deleteAsyncMax)
+        storageDriverS3PathRemoveComplete(this, deleteAsyncList);
+
+    MEM_CONTEXT_BEGIN(lstMemContext(deleteAsyncList))
+    {
+        MEM_CONTEXT_NEW_BEGIN("StorageDriverS3DeleteAsync")
+        {
+            // Generate the delete request in quiet mode so only errors are returned.  Keys are escaped since they may contain
+            // characters that are special in xml.
+            String *xml = strNew("<?xml version=\"1.0\" encoding=\"UTF-8\"?><Delete><Quiet>true</Quiet>");
+
+            for (unsigned int keyIdx = 0; keyIdx < strLstSize(keyList); keyIdx++)
+                strCatFmt(xml, "<Object><Key>%s</Key></Object>", strPtr(xmlFromText(strLstGet(keyList, keyIdx))));
+
+            strCat(xml, "</Delete>");
+
+            StorageDriverS3DeleteAsync deleteAsync =
+            {
+                .memContext = MEM_CONTEXT_NEW(),
+                .httpClient = storageDriverS3HttpClient(this),
+                .query = httpQueryAdd(httpQueryNew(), S3_QUERY_DELETE_STR, EMPTY_STR),
+                .body = bufNewStr(xml),
+            };
+
+            deleteAsync.header = storageDriverS3RequestAsync(
+                this, deleteAsync.httpClient, HTTP_VERB_POST_STR, FSLASH_STR, deleteAsync.query, NULL, deleteAsync.body);
+
+            lstAdd(deleteAsyncList, &deleteAsync);
+        }
+        MEM_CONTEXT_NEW_END();
+    }
+    MEM_CONTEXT_END();
+
+    FUNCTION_LOG_RETURN_VOID();
+}
+
 /***********************************************************************************************************************************
 Remove a path
+
+There are no physical paths on S3 so a non-recursive remove has nothing to do.  A recursive remove lists all files with the path
+prefix and removes them with multi-object delete requests.  Files are removed in batches while the list is still running and
+several delete requests may be in flight at once.
 ***********************************************************************************************************************************/
+typedef struct StorageDriverS3PathRemoveData
+{
+    StorageDriverS3 *this;                                          // Driver
+    MemContext *memContext;                                         // Context for the key list
+    const String *basePrefix;                                       // Prefix to add to names to get keys
+    List *deleteAsyncList;                                          // Delete requests in flight
+    StringList *keyList;                                            // Keys for the next delete request
+} StorageDriverS3PathRemoveData;
+
+static void
+storageDriverS3PathRemoveCallback(void *callbackData, const String *name, StorageInfo info)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM_P(VOID, callbackData);
+        FUNCTION_TEST_PARAM(STRING, name);
+        FUNCTION_TEST_PARAM(STORAGE_INFO, info);
+    FUNCTION_TEST_END();
+
+    ASSERT(callbackData != NULL);
+    ASSERT(name != NULL);
+
+    (void)info;
+
+    StorageDriverS3PathRemoveData *data = (StorageDriverS3PathRemoveData *)callbackData;
+
+    strLstAdd(data->keyList, strNewFmt("%s%s", strPtr(data->basePrefix), strPtr(name)));
+
+    // Send the batch when it is full
+    if (strLstSize(data->keyList) >= data->this->deleteMax)
+    {
+        storageDriverS3PathRemoveBatch(data->this, data->deleteAsyncList, data->keyList);
+
+        MEM_CONTEXT_BEGIN(data->memContext)
+        {
+            strLstFree(data->keyList);
+            data->keyList = strLstNewArena();
+        }
+        MEM_CONTEXT_END();
+    }
+
+    FUNCTION_TEST_RETURN_VOID();
+}
+
 void
 storageDriverS3PathRemove(StorageDriverS3 *this, const String *path, bool errorOnMissing, bool recurse)
 {
@@ -658,8 +1117,33 @@ storageDriverS3PathRemove(StorageDriverS3 *this, const String *path, bool errorO
 
     ASSERT(this != NULL);
     ASSERT(path != NULL);
+    ASSERT(!errorOnMissing);
 
-    THROW(AssertError, "NOT YET IMPLEMENTED");
+    if (recurse)
+    {
+        MEM_CONTEXT_TEMP_BEGIN()
+        {
+            StorageDriverS3PathRemoveData data =
+            {
+                .this = this,
+                .memContext = MEM_CONTEXT_TEMP(),
+                .basePrefix = strSize(path) == 1 ? EMPTY_STR : strNewFmt("%s/", strPtr(strSub(path, 1))),
+                .deleteAsyncList = lstNew(sizeof(StorageDriverS3DeleteAsync)),
+                .keyList = strLstNewArena(),
+            };
+
+            storageDriverS3ListInternal(this, path, true, NULL, storageDriverS3PathRemoveCallback, &data);
+
+            // Send the last partial batch
+            if (strLstSize(data.keyList) > 0)
+                storageDriverS3PathRemoveBatch(this, data.deleteAsyncList, data.keyList);
+
+            // Wait for the remaining delete requests to complete
+            while (lstSize(data.deleteAsyncList) > 0)
+                storageDriverS3PathRemoveComplete(this, data.deleteAsyncList);
+        }
+        MEM_CONTEXT_TEMP_END();
+    }
 
     FUNCTION_LOG_RETURN_VOID();
 }
@@ -696,25 +1180,45 @@ storageDriverS3Remove(StorageDriverS3 *this, const String *file, bool errorOnMis
 
     ASSERT(this != NULL);
     ASSERT(file != NULL);
+    ASSERT(!errorOnMissing);
 
-    THROW(AssertError, "NOT YET IMPLEMENTED");
+    // S3 does not report whether the file existed so errorOnMissing is not supported
+    storageDriverS3Request(this, HTTP_VERB_DELETE_STR, file, NULL, NULL, true, false);
 
     FUNCTION_LOG_RETURN_VOID();
 }
 
 /***********************************************************************************************************************************
-Get http client
+Get an http client that is not busy
+
+Clients are cached by the driver so connections (and TLS sessions) are reused by later requests.  The client is busy until the
+response has been read, including any content read through the io interface, so the caller should hold onto the client until then.
 ***********************************************************************************************************************************/
 HttpClient *
-storageDriverS3HttpClient(const StorageDriverS3 *this)
+storageDriverS3HttpClient(StorageDriverS3 *this)
 {
-    FUNCTION_TEST_BEGIN();
+    FUNCTION_LOG_BEGIN(logLevelTrace);
         FUNCTION_LOG_PARAM(STORAGE_DRIVER_S3, this);
+    FUNCTION_LOG_END();
+
+    ASSERT(this != NULL);
+
+    FUNCTION_LOG_RETURN(HTTP_CLIENT, httpClientCacheGet(this->httpClientCache));
+}
+
+/***********************************************************************************************************************************
+Max parts that can be in flight at once during a multi-part upload
+***********************************************************************************************************************************/
+unsigned int
+storageDriverS3PartAsyncMax(const StorageDriverS3 *this)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(STORAGE_DRIVER_S3, this);
     FUNCTION_TEST_END();
 
     ASSERT(this != NULL);
 
-    FUNCTION_TEST_RETURN(this->httpClient);
+    FUNCTION_TEST_RETURN(this->partAsyncMax);
 }
 
 /***********************************************************************************************************************************
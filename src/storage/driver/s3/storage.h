@@ -19,12 +19,31 @@ Driver type constant
 #define STORAGE_DRIVER_S3_TYPE                                      "s3"
     STRING_DECLARE(STORAGE_DRIVER_S3_TYPE_STR);
 
+/***********************************************************************************************************************************
+XML tags used to report errors
+***********************************************************************************************************************************/
+#define S3_XML_TAG_CODE                                             "Code"
+    STRING_DECLARE(S3_XML_TAG_CODE_STR);
+#define S3_XML_TAG_MESSAGE                                          "Message"
+    STRING_DECLARE(S3_XML_TAG_MESSAGE_STR);
+
 /***********************************************************************************************************************************
 Defaults
 ***********************************************************************************************************************************/
 #define STORAGE_DRIVER_S3_PORT_DEFAULT                              443
 #define STORAGE_DRIVER_S3_TIMEOUT_DEFAULT                           60000
 
+// Files larger than the part size are uploaded in parts.  S3 requires parts (except the last) to be at least 5MiB.
+#define STORAGE_DRIVER_S3_PART_SIZE_DEFAULT                         ((size_t)16 * 1024 * 1024)
+#define STORAGE_DRIVER_S3_PART_ASYNC_MAX_DEFAULT                    4
+
+// S3 allows up to 1000 files to be removed with a single multi-object delete request
+#define STORAGE_DRIVER_S3_DELETE_MAX_DEFAULT                        1000
+#define STORAGE_DRIVER_S3_DELETE_ASYNC_MAX_DEFAULT                  4
+
+// Max list requests that can be in flight at once when sub-paths are listed in parallel
+#define STORAGE_DRIVER_S3_LIST_ASYNC_MAX_DEFAULT                    4
+
 /***********************************************************************************************************************************
 Constructor
 ***********************************************************************************************************************************/
@@ -40,7 +59,11 @@ Functions
 bool storageDriverS3Exists(StorageDriverS3 *this, const String *path);
 StorageInfo storageDriverS3Info(StorageDriverS3 *this, const String *file, bool ignoreMissing);
 StringList *storageDriverS3List(StorageDriverS3 *this, const String *path, bool errorOnMissing, const String *expression);
-StorageFileRead *storageDriverS3NewRead(StorageDriverS3 *this, const String *file, bool ignoreMissing);
+bool storageDriverS3ListEach(
+    StorageDriverS3 *this, const String *path, bool errorOnMissing, const String *expression, StorageListEachCallback callback,
+    void *callbackData);
+StorageFileRead *storageDriverS3NewRead(
+    StorageDriverS3 *this, const String *file, bool ignoreMissing, uint64_t offset, const Variant *limit);
 StorageFileWrite *storageDriverS3NewWrite(
     StorageDriverS3 *this, const String *file, mode_t modeFile, mode_t modePath, bool createPath, bool syncFile, bool syncPath,
     bool atomic);
@@ -52,11 +75,18 @@ void storageDriverS3Remove(StorageDriverS3 *this, const String *file, bool error
 Buffer *storageDriverS3Request(
     StorageDriverS3 *this, const String *verb, const String *uri, const HttpQuery *query, const Buffer *body, bool returnContent,
     bool allowMissing);
+HttpHeader *storageDriverS3RequestAsync(
+    StorageDriverS3 *this, HttpClient *httpClient, const String *verb, const String *uri, const HttpQuery *query,
+    const HttpHeader *header, const Buffer *body);
+Buffer *storageDriverS3Response(
+    StorageDriverS3 *this, HttpClient *httpClient, const String *uri, const HttpQuery *query, const HttpHeader *requestHeader,
+    bool returnContent, bool allowMissing);
 
 /***********************************************************************************************************************************
 Getters
 ***********************************************************************************************************************************/
-HttpClient *storageDriverS3HttpClient(const StorageDriverS3 *this);
+HttpClient *storageDriverS3HttpClient(StorageDriverS3 *this);
+unsigned int storageDriverS3PartAsyncMax(const StorageDriverS3 *this);
 Storage *storageDriverS3Interface(const StorageDriverS3 *this);
 
 /***********************************************************************************************************************************
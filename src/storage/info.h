@@ -6,6 +6,8 @@ Storage Info
 
 #include <sys/types.h>
 
+#include "common/type/string.h"
+
 /***********************************************************************************************************************************
 Storage type
 ***********************************************************************************************************************************/
@@ -25,6 +27,10 @@ typedef struct StorageInfo
     StorageType type;                                               // Type file/path/link)
     size_t size;                                                    // Size (path/link is 0)
     mode_t mode;                                                    // Mode of path/file/link
+    uid_t userId;                                                   // User that owns the path/file/link
+    gid_t groupId;                                                  // Group that owns the path/file/link
+    time_t timeModified;                                            // Time file was last modified
+    const String *linkDestination;                                  // Destination if this is a link
 } StorageInfo;
 
 /***********************************************************************************************************************************
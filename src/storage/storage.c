@@ -54,6 +54,7 @@ storageNew(
     ASSERT(interface.exists != NULL);
     ASSERT(interface.info != NULL);
     ASSERT(interface.list != NULL);
+    ASSERT(interface.listEach != NULL);
     ASSERT(interface.newRead != NULL);
     ASSERT(interface.newWrite != NULL);
     ASSERT(interface.pathCreate != NULL);
@@ -247,6 +248,14 @@ storageInfo(const Storage *this, const String *fileExp, StorageInfoParam param)
 
         // Call driver function
         result = this->interface.info(this->driver, file, param.ignoreMissing);
+
+        // Move the link destination up to the old context
+        if (result.linkDestination != NULL)
+        {
+            memContextSwitch(MEM_CONTEXT_OLD());
+            result.linkDestination = strDup(result.linkDestination);
+            memContextSwitch(MEM_CONTEXT_TEMP());
+        }
     }
     MEM_CONTEXT_TEMP_END();
 
@@ -283,6 +292,43 @@ storageList(const Storage *this, const String *pathExp, StorageListParam param)
     FUNCTION_LOG_RETURN(STRING_LIST, result);
 }
 
+/***********************************************************************************************************************************
+Call a function for each file/path/link in a directory
+
+Entries are passed to the callback with their info as they are read so the directory is never held in memory.  The name passed to
+the callback is only valid until the callback returns.  Returns false if the path is missing and errorOnMissing is false.
+***********************************************************************************************************************************/
+bool
+storageListEach(
+    const Storage *this, const String *pathExp, StorageListEachCallback callback, void *callbackData, StorageListEachParam param)
+{
+    FUNCTION_LOG_BEGIN(logLevelDebug);
+        FUNCTION_LOG_PARAM(STORAGE, this);
+        FUNCTION_LOG_PARAM(STRING, pathExp);
+        FUNCTION_LOG_PARAM(FUNCTIONP, callback);
+        FUNCTION_LOG_PARAM_P(VOID, callbackData);
+        FUNCTION_LOG_PARAM(BOOL, param.errorOnMissing);
+        FUNCTION_LOG_PARAM(STRING, param.expression);
+    FUNCTION_LOG_END();
+
+    ASSERT(this != NULL);
+    ASSERT(callback != NULL);
+
+    bool result = false;
+
+    MEM_CONTEXT_TEMP_BEGIN()
+    {
+        // Build the path
+        String *path = storagePathNP(this, pathExp);
+
+        // Call driver function
+        result = this->interface.listEach(this->driver, path, param.errorOnMissing, param.expression, callback, callbackData);
+    }
+    MEM_CONTEXT_TEMP_END();
+
+    FUNCTION_LOG_RETURN(BOOL, result);
+}
+
 /***********************************************************************************************************************************
 Move a file
 ***********************************************************************************************************************************/
@@ -334,16 +380,20 @@ storageNewRead(const Storage *this, const String *fileExp, StorageNewReadParam p
         FUNCTION_LOG_PARAM(STORAGE, this);
         FUNCTION_LOG_PARAM(STRING, fileExp);
         FUNCTION_LOG_PARAM(BOOL, param.ignoreMissing);
+        FUNCTION_LOG_PARAM(UINT64, param.offset);
+        FUNCTION_LOG_PARAM(VARIANT, param.limit);
         FUNCTION_LOG_PARAM(IO_FILTER_GROUP, param.filterGroup);
     FUNCTION_LOG_END();
 
     ASSERT(this != NULL);
+    ASSERT(param.limit == NULL || varUInt64(param.limit) > 0);
 
     StorageFileRead *result = NULL;
 
     MEM_CONTEXT_TEMP_BEGIN()
     {
-        result = this->interface.newRead(this->driver, storagePathNP(this, fileExp), param.ignoreMissing);
+        result = this->interface.newRead(
+            this->driver, storagePathNP(this, fileExp), param.ignoreMissing, param.offset, param.limit);
 
         if (param.filterGroup != NULL)
             ioReadFilterGroupSet(storageFileReadIo(result), param.filterGroup);
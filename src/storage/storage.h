@@ -88,6 +88,25 @@ typedef struct StorageListParam
 
 StringList *storageList(const Storage *this, const String *pathExp, StorageListParam param);
 
+/***********************************************************************************************************************************
+storageListEach
+***********************************************************************************************************************************/
+typedef void (*StorageListEachCallback)(void *callbackData, const String *name, StorageInfo info);
+
+typedef struct StorageListEachParam
+{
+    bool errorOnMissing;
+    const String *expression;
+} StorageListEachParam;
+
+#define storageListEachP(this, pathExp, callback, callbackData, ...)                                                               \
+    storageListEach(this, pathExp, callback, callbackData, (StorageListEachParam){__VA_ARGS__})
+#define storageListEachNP(this, pathExp, callback, callbackData)                                                                   \
+    storageListEach(this, pathExp, callback, callbackData, (StorageListEachParam){0})
+
+bool storageListEach(
+    const Storage *this, const String *pathExp, StorageListEachCallback callback, void *callbackData, StorageListEachParam param);
+
 /***********************************************************************************************************************************
 storageMove
 ***********************************************************************************************************************************/
@@ -102,6 +121,8 @@ storageNewRead
 typedef struct StorageNewReadParam
 {
     bool ignoreMissing;
+    uint64_t offset;                                                // Where to start reading in the file
+    const Variant *limit;                                           // Max bytes to read (NULL reads to the end of the file)
     IoFilterGroup *filterGroup;
 } StorageNewReadParam;
 
@@ -23,8 +23,12 @@ Constructor
 typedef bool (*StorageInterfaceExists)(void *driver, const String *path);
 typedef StorageInfo (*StorageInterfaceInfo)(void *driver, const String *file, bool ignoreMissing);
 typedef StringList *(*StorageInterfaceList)(void *driver, const String *path, bool errorOnMissing, const String *expression);
+typedef bool (*StorageInterfaceListEach)(
+    void *driver, const String *path, bool errorOnMissing, const String *expression, StorageListEachCallback callback,
+    void *callbackData);
 typedef bool (*StorageInterfaceMove)(void *driver, void *source, void *destination);
-typedef StorageFileRead *(*StorageInterfaceNewRead)(void *driver, const String *file, bool ignoreMissing);
+typedef StorageFileRead *(*StorageInterfaceNewRead)(
+    void *driver, const String *file, bool ignoreMissing, uint64_t offset, const Variant *limit);
 typedef StorageFileWrite *(*StorageInterfaceNewWrite)(
     void *driver, const String *file, mode_t modeFile, mode_t modePath, bool createPath, bool syncFile, bool syncPath, bool atomic);
 typedef void (*StorageInterfacePathCreate)(
@@ -38,6 +42,7 @@ typedef struct StorageInterface
     StorageInterfaceExists exists;
     StorageInterfaceInfo info;
     StorageInterfaceList list;
+    StorageInterfaceListEach listEach;
     StorageInterfaceMove move;
     StorageInterfaceNewRead newRead;
     StorageInterfaceNewWrite newWrite;
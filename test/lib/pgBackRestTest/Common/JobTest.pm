@@ -426,6 +426,27 @@ sub run
 
                 buildPutDiffers($self->{oStorageTest}, "$self->{strGCovPath}/buildflags", "${strCommonFlags} ${strBuildFlags}");
 
+                # Optional libraries are only linked when the test enables them
+                my $strLibrary = '';
+
+                if ($self->{oTest}->{&TEST_CDEF})
+                {
+                    $strLibrary .= $self->{oTest}->{&TEST_CDEF} =~ /-DHAVE_LIBLZ4\b/ ? ' -llz4' : '';
+                    $strLibrary .= $self->{oTest}->{&TEST_CDEF} =~ /-DHAVE_LIBZST\b/ ? ' -lzstd' : '';
+                }
+
+                # Link pthread only when a C file in the build uses it
+                foreach my $strFile (@stryCFile, split(' ', $strTestDepend))
+                {
+                    next if $strFile !~ /\.c$/;
+
+                    if (${$self->{oStorageTest}->get("$self->{strGCovPath}/${strFile}")} =~ /^\#include \<pthread\.h\>$/m)
+                    {
+                        $strLibrary .= ' -lpthread';
+                        last;
+                    }
+                }
+
                 # Build the Makefile
                 my $strMakefile =
                     "CC=gcc\n" .
@@ -433,7 +454,7 @@ sub run
                     "BUILDFLAGS=${strBuildFlags}\n" .
                     "HARNESSFLAGS=${strHarnessFlags}\n" .
                     "TESTFLAGS=${strTestFlags}\n" .
-                    "LDFLAGS=-lcrypto -lssl -lxml2 -lz" .
+                    "LDFLAGS=-lcrypto -lssl -lxml2 -lz${strLibrary}" .
                         (vmCoverageC($self->{oTest}->{&TEST_VM}) && $self->{bCoverageUnit} ? " -lgcov" : '') .
                         (vmWithBackTrace($self->{oTest}->{&TEST_VM}) && $self->{bBackTrace} ? ' -lbacktrace' : '') .
                         " `perl -MExtUtils::Embed -e ldopts`\n" .
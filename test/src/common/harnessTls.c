@@ -16,11 +16,19 @@ Tls Test Harness
 
 #include "common/harnessTls.h"
 
+/***********************************************************************************************************************************
+Max connections that can be open at once
+***********************************************************************************************************************************/
+#define HARNESS_TLS_CONNECTION_MAX                                  4
+
 static bool hostInit = false;
 static int testServerSocket = 0;
 static SSL_CTX *testServerContext = NULL;
-static int testClientSocket = 0;
-static SSL *testClientSSL = NULL;
+
+// Client connections and the index of the connection currently being used
+static int testClientSocketList[HARNESS_TLS_CONNECTION_MAX];
+static SSL *testClientSSLList[HARNESS_TLS_CONNECTION_MAX];
+static unsigned int testClientIdx = 0;
 
 /***********************************************************************************************************************************
 Initialize TLS and listen on the specified port for TLS connections
@@ -75,7 +83,7 @@ harnessTlsServerInit(int port, const char *serverCert, const char *serverKey)
         THROW_SYS_ERROR(AssertError, "unable to bind socket");
 
     // Listen for client connections
-    if (listen(testServerSocket, 1) < 0)
+    if (listen(testServerSocket, HARNESS_TLS_CONNECTION_MAX) < 0)
         THROW_SYS_ERROR(AssertError, "unable to listen on socket");
 }
 
@@ -93,7 +101,7 @@ harnessTlsServerExpect(const char *expected)
     // Read expected bytes
     do
     {
-        int lastBytes = SSL_read(testClientSSL, bufRemainsPtr(buffer), (int)bufRemains(buffer));
+        int lastBytes = SSL_read(testClientSSLList[testClientIdx], bufRemainsPtr(buffer), (int)bufRemains(buffer));
         readBytes += lastBytes;
         bufUsedSet(buffer, (size_t)readBytes);
     }
@@ -119,7 +127,7 @@ Send a reply to the client
 void
 harnessTlsServerReply(const char *reply)
 {
-    SSL_write(testClientSSL, reply, (int)strlen(reply));
+    SSL_write(testClientSSLList[testClientIdx], reply, (int)strlen(reply));
 }
 
 /***********************************************************************************************************************************
@@ -131,15 +139,15 @@ harnessTlsServerAccept(void)
     struct sockaddr_in addr;
     uint len = sizeof(addr);
 
-    testClientSocket = accept(testServerSocket, (struct sockaddr *)&addr, &len);
+    testClientSocketList[testClientIdx] = accept(testServerSocket, (struct sockaddr *)&addr, &len);
 
-    if (testClientSocket < 0)
+    if (testClientSocketList[testClientIdx] < 0)
         THROW_SYS_ERROR(AssertError, "unable to accept socket");
 
-    testClientSSL = SSL_new(testServerContext);
-    SSL_set_fd(testClientSSL, testClientSocket);
+    testClientSSLList[testClientIdx] = SSL_new(testServerContext);
+    SSL_set_fd(testClientSSLList[testClientIdx], testClientSocketList[testClientIdx]);
 
-    cryptoError(SSL_accept(testClientSSL) <= 0, "unable to accept TLS connection");
+    cryptoError(SSL_accept(testClientSSLList[testClientIdx]) <= 0, "unable to accept TLS connection");
 }
 
 /***********************************************************************************************************************************
@@ -148,6 +156,23 @@ Close the connection
 void
 harnessTlsServerClose(void)
 {
-    SSL_free(testClientSSL);
-    close(testClientSocket);
+    // Shut down cleanly so the client can resume the session
+    SSL_shutdown(testClientSSLList[testClientIdx]);
+    SSL_free(testClientSSLList[testClientIdx]);
+    close(testClientSocketList[testClientIdx]);
+}
+
+/***********************************************************************************************************************************
+Set the connection used by the other functions
+
+Connection 0 is used by default.  Tests that open more than one connection at a time (e.g. async requests) must switch between
+connections in the same order that the client uses them.
+***********************************************************************************************************************************/
+void
+harnessTlsServerConnectionSet(unsigned int connectionIdx)
+{
+    if (connectionIdx >= HARNESS_TLS_CONNECTION_MAX)
+        THROW_FMT(AssertError, "connection %u exceeds max %u", connectionIdx, HARNESS_TLS_CONNECTION_MAX - 1);
+
+    testClientIdx = connectionIdx;
 }
@@ -26,4 +26,6 @@ void harnessTlsServerExpect(const char *expected);
 void harnessTlsServerReply(const char *reply);
 void harnessTlsServerClose(void);
 
+void harnessTlsServerConnectionSet(unsigned int connectionIdx);
+
 #endif
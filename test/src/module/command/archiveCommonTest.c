@@ -207,6 +207,16 @@ testRun(void)
                 " 123456781234567812345678-aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa"
                 ", 123456781234567812345678-bbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbb.gz"
                 "\nHINT: are multiple primaries archiving to this stanza?");
+
+        storagePutNP(
+            storageNewWriteNP(
+                storageTest,
+                strNew("archive/db/9.6-2/1234567812345678/123456781234567812345679-cccccccccccccccccccccccccccccccccccccccc.lz4")),
+            NULL);
+
+        TEST_RESULT_STR(
+            strPtr(walSegmentFind(storageRepo(), strNew("9.6-2"), strNew("123456781234567812345679"))),
+            "123456781234567812345679-cccccccccccccccccccccccccccccccccccccccc.lz4", "found lz4 segment");
     }
 
     // *****************************************************************************************************************************
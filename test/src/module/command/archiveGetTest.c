@@ -194,8 +194,7 @@ testRun(void)
         ioWriteFilterGroupSet(
             storageFileWriteIo(infoWrite),
             ioFilterGroupAdd(
-                ioFilterGroupNew(),
-                cipherBlockFilter(cipherBlockNew(cipherModeEncrypt, cipherTypeAes256Cbc, bufNewStr(strNew("12345678")), NULL))));
+                ioFilterGroupNew(), cipherFilter(cipherModeEncrypt, cipherTypeAes256Cbc, bufNewStr(strNew("12345678")))));
 
         storagePutNP(
             infoWrite,
@@ -219,9 +218,7 @@ testRun(void)
         IoFilterGroup *filterGroup = ioFilterGroupNew();
         ioFilterGroupAdd(filterGroup, gzipCompressFilter(gzipCompressNew(3, false)));
         ioFilterGroupAdd(
-            filterGroup,
-            cipherBlockFilter(
-                cipherBlockNew(cipherModeEncrypt, cipherTypeAes256Cbc, bufNewStr(strNew("worstpassphraseever")), NULL)));
+            filterGroup, cipherFilter(cipherModeEncrypt, cipherTypeAes256Cbc, bufNewStr(strNew("worstpassphraseever"))));
         ioWriteFilterGroupSet(storageFileWriteIo(destination), filterGroup);
         storagePutNP(destination, buffer);
 
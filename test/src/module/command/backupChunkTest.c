@@ -0,0 +1,295 @@
+/***********************************************************************************************************************************
+Test Backup Chunk Filter
+***********************************************************************************************************************************/
+#include "common/io/bufferWrite.h"
+#include "common/io/filter/group.h"
+#include "common/io/write.h"
+#include "storage/driver/posix/storage.h"
+
+/***********************************************************************************************************************************
+Test data
+***********************************************************************************************************************************/
+#define TEST_SIZE_AVG                                               1024
+
+// Generate data that does not repeat so chunk boundaries are found by the hash
+static Buffer *
+testData(size_t size, uint32_t seed)
+{
+    Buffer *result = bufNew(size);
+
+    for (size_t dataIdx = 0; dataIdx < size; dataIdx++)
+    {
+        seed = seed * 1103515245 + 12345;
+        bufPtr(result)[dataIdx] = (unsigned char)(seed >> 16);
+    }
+
+    bufUsedSet(result, size);
+
+    return result;
+}
+
+/***********************************************************************************************************************************
+Store the chunks taken from a chunk filter
+***********************************************************************************************************************************/
+typedef struct TestChunkResult
+{
+    const VariantList *list;                                        // Chunk list from the filter result
+    unsigned int newTotal;                                          // Chunks that were not already in the store
+    uint64_t newSize;                                               // Size of chunks that were not already in the store
+} TestChunkResult;
+
+static void
+testChunkPut(const BackupChunkStore *store, BackupChunk *chunk, TestChunkResult *result)
+{
+    List *chunkList = backupChunkTake(chunk);
+
+    for (unsigned int chunkIdx = 0; chunkIdx < lstSize(chunkList); chunkIdx++)
+    {
+        const BackupChunkData *chunkData = lstGet(chunkList, chunkIdx);
+
+        if (backupChunkPut(store, chunkData->id, chunkData->data))
+        {
+            result->newTotal++;
+            result->newSize += bufUsed(chunkData->data);
+        }
+    }
+
+    lstFree(chunkList);
+}
+
+/***********************************************************************************************************************************
+Write data through a filter group containing a chunk filter and store the chunks
+***********************************************************************************************************************************/
+static TestChunkResult
+testChunk(const BackupChunkStore *store, const Buffer *input, size_t inputSize)
+{
+    TestChunkResult result = {0};
+
+    BackupChunk *chunk = backupChunkNew(TEST_SIZE_AVG, store->cipherType == cipherTypeNone ? NULL : store->cipherPass);
+    IoFilterGroup *filterGroup = ioFilterGroupAdd(ioFilterGroupNew(), backupChunkFilter(chunk));
+
+    IoWrite *write = ioBufferWriteIo(ioBufferWriteNew(bufNew(0)));
+    ioWriteFilterGroupSet(write, filterGroup);
+    ioWriteOpen(write);
+
+    for (size_t inputIdx = 0; inputIdx < bufUsed(input); inputIdx += inputSize)
+    {
+        size_t size = bufUsed(input) - inputIdx < inputSize ? bufUsed(input) - inputIdx : inputSize;
+        ioWrite(write, bufNewC(size, bufPtr(input) + inputIdx));
+        testChunkPut(store, chunk, &result);
+    }
+
+    ioWriteClose(write);
+    testChunkPut(store, chunk, &result);
+
+    result.list = varVarLst(
+        kvGet(varKv(ioFilterGroupResult(filterGroup, BACKUP_CHUNK_FILTER_TYPE_STR)), varNewStr(BACKUP_CHUNK_KEY_LIST_STR)));
+
+    return result;
+}
+
+/***********************************************************************************************************************************
+Restore data from a chunk list
+***********************************************************************************************************************************/
+static Buffer *
+testRestore(const BackupChunkStore *store, const VariantList *chunkList)
+{
+    Buffer *result = bufNew(0);
+
+    IoWrite *write = ioBufferWriteIo(ioBufferWriteNew(result));
+    ioWriteOpen(write);
+
+    backupChunkRestore(store, chunkList, write);
+
+    ioWriteClose(write);
+
+    return result;
+}
+
+/***********************************************************************************************************************************
+Count chunks in the second list that are not in the first list
+***********************************************************************************************************************************/
+static unsigned int
+testChunkDiff(const VariantList *listOld, const VariantList *listNew)
+{
+    StringList *old = strLstNewVarLst(listOld);
+    unsigned int result = 0;
+
+    for (unsigned int chunkIdx = 0; chunkIdx < varLstSize(listNew); chunkIdx++)
+    {
+        if (!strLstExists(old, varStr(varLstGet(listNew, chunkIdx))))
+            result++;
+    }
+
+    return result;
+}
+
+/***********************************************************************************************************************************
+Test Run
+***********************************************************************************************************************************/
+void
+testRun(void)
+{
+    FUNCTION_HARNESS_VOID();
+
+    Storage *storageTest = storageDriverPosixInterface(
+        storageDriverPosixNew(strNew(testPath()), STORAGE_MODE_FILE_DEFAULT, STORAGE_MODE_PATH_DEFAULT, true, NULL));
+
+    // *****************************************************************************************************************************
+    if (testBegin("backupChunk*()"))
+    {
+        Buffer *data = testData(65536, 1);
+        BackupChunkStore store = {.storage = storageTest, .path = strNew("chunk")};
+
+        // Store chunks
+        // -------------------------------------------------------------------------------------------------------------------------
+        TestChunkResult result = {0};
+
+        TEST_ASSIGN(result, testChunk(&store, data, 100), "chunk data");
+
+        const VariantList *list = result.list;
+        unsigned int chunkTotal = varLstSize(list);
+
+        TEST_RESULT_BOOL(
+            chunkTotal >= 65536 / (TEST_SIZE_AVG * 4) && chunkTotal <= 65536 / (TEST_SIZE_AVG / 4), true,
+            "    chunk total is in range");
+        TEST_RESULT_UINT(result.newTotal, chunkTotal, "    all chunks are new");
+        TEST_RESULT_UINT(result.newSize, 65536, "    new size");
+
+        // All chunks except the last are within the size limits
+        for (unsigned int chunkIdx = 0; chunkIdx < chunkTotal - 1; chunkIdx++)
+        {
+            const String *id = varStr(varLstGet(list, chunkIdx));
+            uint64_t size = storageInfoNP(storageTest, strNewFmt("chunk/%s/%s", strPtr(strSubN(id, 0, 3)), strPtr(id))).size;
+
+            if (size < TEST_SIZE_AVG / 4 || size > TEST_SIZE_AVG * 4)
+                THROW_FMT(AssertError, "chunk %u size %" PRIu64 " is out of range", chunkIdx, size);
+        }
+
+        TEST_RESULT_BOOL(bufEq(testRestore(&store, list), data), true, "    restore");
+
+        // Boundaries do not depend on how input is buffered and stored chunks are not stored again
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_ASSIGN(result, testChunk(&store, data, 65536), "chunk data again");
+        TEST_RESULT_BOOL(
+            varLstSize(result.list) == chunkTotal && testChunkDiff(list, result.list) == 0, true, "    chunk list is the same");
+        TEST_RESULT_UINT(result.newTotal, 0, "    no new chunks");
+        TEST_RESULT_UINT(result.newSize, 0, "    no new size");
+
+        // Only the chunks around an update are new
+        // -------------------------------------------------------------------------------------------------------------------------
+        Buffer *dataUpdate = bufNewC(bufUsed(data), bufPtr(data));
+        bufPtr(dataUpdate)[30000] ^= 0xFF;
+
+        TEST_ASSIGN(result, testChunk(&store, dataUpdate, 8192), "chunk updated data");
+        TEST_RESULT_BOOL(testChunkDiff(list, result.list) <= 2, true, "    at most two chunks are new");
+        TEST_RESULT_UINT(result.newTotal, testChunkDiff(list, result.list), "    only new chunks are stored");
+        TEST_RESULT_BOOL(bufEq(testRestore(&store, result.list), dataUpdate), true, "    restore");
+
+        // Boundaries resynchronize after an insert shifts the data
+        Buffer *dataInsert = bufNew(bufUsed(data) + 100);
+        bufCat(dataInsert, testData(100, 2));
+        bufCat(dataInsert, data);
+
+        TEST_ASSIGN(result, testChunk(&store, dataInsert, 8192), "chunk shifted data");
+        TEST_RESULT_BOOL(testChunkDiff(list, result.list) <= 2, true, "    at most two chunks are new");
+
+        // Chunks are cut at the maximum size when the hash never finds a boundary, e.g. zeroed pages
+        // -------------------------------------------------------------------------------------------------------------------------
+        Buffer *dataZero = bufNew(TEST_SIZE_AVG * 4 * 4 + 10);
+        memset(bufPtr(dataZero), 0, bufSize(dataZero));
+        bufUsedSet(dataZero, bufSize(dataZero));
+
+        TEST_ASSIGN(result, testChunk(&store, dataZero, 65536), "chunk zeroes");
+
+        TEST_RESULT_UINT(varLstSize(result.list), 5, "    five chunks");
+        TEST_RESULT_STR(
+            strPtr(varStr(varLstGet(result.list, 3))), strPtr(varStr(varLstGet(result.list, 0))), "    full chunks are the same");
+        TEST_RESULT_UINT(result.newTotal, 2, "    two new chunks");
+
+        // Empty file
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_ASSIGN(result, testChunk(&store, bufNew(0), 65536), "chunk empty data");
+        TEST_RESULT_UINT(varLstSize(result.list), 0, "    no chunks");
+        TEST_RESULT_UINT(bufUsed(testRestore(&store, varLstNew())), 0, "    restore");
+
+        // Compressed chunks
+        // -------------------------------------------------------------------------------------------------------------------------
+        BackupChunkStore storeCompress = {.storage = storageTest, .path = strNew("chunk"), .compressType = compressTypeGz};
+
+        TEST_ASSIGN(result, testChunk(&storeCompress, data, 4096), "chunk data compressed");
+        list = result.list;
+
+        TEST_RESULT_UINT(varLstSize(list), chunkTotal, "    same chunk total");
+
+        const String *id = varStr(varLstGet(list, 0));
+        TEST_RESULT_BOOL(
+            storageExistsNP(storageTest, strNewFmt("chunk/%s/%s.gz", strPtr(strSubN(id, 0, 3)), strPtr(id))), true,
+            "    chunk is compressed");
+        TEST_RESULT_BOOL(bufEq(testRestore(&storeCompress, list), data), true, "    restore");
+
+        // Compressed and encrypted chunks
+        // -------------------------------------------------------------------------------------------------------------------------
+        BackupChunkStore storeCipher =
+        {
+            .storage = storageTest, .path = strNew("chunk-cipher"), .compressType = compressTypeGz,
+            .cipherType = cipherTypeAes256Cbc, .cipherPass = strNew("12345678"),
+        };
+
+        TEST_ASSIGN(result, testChunk(&storeCipher, data, 4096), "chunk data compressed and encrypted");
+        TEST_RESULT_UINT(result.newTotal, chunkTotal, "    all chunks are new");
+        TEST_RESULT_UINT(testChunkDiff(list, result.list), chunkTotal, "    ids differ from unencrypted ids");
+
+        const String *idCipher = varStr(varLstGet(result.list, 0));
+        Buffer *chunkData = bufNew(0);
+        IoWrite *chunkWrite = ioBufferWriteIo(ioBufferWriteNew(chunkData));
+        ioWriteOpen(chunkWrite);
+        backupChunkRestore(&storeCompress, varLstAdd(varLstNew(), varNewStr(id)), chunkWrite);
+        ioWriteClose(chunkWrite);
+
+        Buffer *idKey = cryptoHmacOne(
+            HASH_TYPE_SHA256_STR, bufNewStr(storeCipher.cipherPass), bufNewStr(strNew("pgBackRest chunk id")));
+
+        TEST_RESULT_STR(
+            strPtr(idCipher), strPtr(bufHex(cryptoHmacOne(HASH_TYPE_SHA1_STR, idKey, chunkData))), "    id is keyed hash of chunk");
+
+        const String *fileCompress = strNewFmt("chunk/%s/%s.gz", strPtr(strSubN(id, 0, 3)), strPtr(id));
+        const String *fileCipher = strNewFmt("chunk-cipher/%s/%s.gz", strPtr(strSubN(idCipher, 0, 3)), strPtr(idCipher));
+
+        TEST_RESULT_BOOL(
+            bufEq(storageGetNP(storageNewReadNP(storageTest, fileCipher)), storageGetNP(storageNewReadNP(storageTest, fileCompress))),
+            false, "    chunk is encrypted");
+        TEST_RESULT_BOOL(bufEq(testRestore(&storeCipher, result.list), data), true, "    restore");
+
+        // A chunk renamed to its unkeyed id does not match its checksum
+        storageMoveNP(
+            storageTest, storageNewReadNP(storageTest, fileCipher),
+            storageNewWriteNP(storageTest, strNewFmt("chunk-cipher/%s/%s.gz", strPtr(strSubN(id, 0, 3)), strPtr(id))));
+
+        TEST_ERROR(
+            testRestore(&storeCipher, varLstAdd(varLstNew(), varNewStr(id))), ChecksumError,
+            strPtr(
+                strNewFmt(
+                    "chunk 'chunk-cipher/%s/%s.gz' does not match its checksum", strPtr(strSubN(id, 0, 3)), strPtr(id))));
+
+        // Corrupt chunk
+        // -------------------------------------------------------------------------------------------------------------------------
+        storagePutNP(
+            storageNewWriteNP(storageTest, strNewFmt("chunk/%s/%s", strPtr(strSubN(id, 0, 3)), strPtr(id))),
+            bufNewStr(strNew("BOGUS")));
+
+        TEST_ERROR(
+            testRestore(&store, list), ChecksumError,
+            strPtr(strNewFmt("chunk 'chunk/%s/%s' does not match its checksum", strPtr(strSubN(id, 0, 3)), strPtr(id))));
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        BackupChunk *chunk = backupChunkNew(TEST_SIZE_AVG, NULL);
+
+        TEST_RESULT_STR(strPtr(backupChunkToLog(chunk)), "{chunkTotal: 0, sizeAvg: 1024}", "format object");
+        TEST_RESULT_UINT(lstSize(backupChunkTake(chunk)), 0, "no chunks to take");
+        TEST_RESULT_VOID(backupChunkFree(chunk), "free chunk");
+        TEST_RESULT_VOID(backupChunkFree(NULL), "free null chunk");
+    }
+
+    FUNCTION_HARNESS_RESULT_VOID();
+}
@@ -0,0 +1,157 @@
+/***********************************************************************************************************************************
+Test Backup Pack
+***********************************************************************************************************************************/
+#include "storage/driver/posix/storage.h"
+
+/***********************************************************************************************************************************
+Get a file from a pack using the pack index
+***********************************************************************************************************************************/
+static Buffer *
+testPackGetCipher(
+    const Storage *storage, const KeyValue *index, CompressType compressType, CipherType cipherType, const String *cipherPass,
+    const char *name)
+{
+    const KeyValue *entry = varKv(kvGet(index, varNewStr(strNew(name))));
+
+    return backupPackGet(
+        storage, strNew("pack"), compressType, cipherType, cipherPass,
+        varUInt64(kvGet(entry, varNewStr(BACKUP_PACK_KEY_OFFSET_STR))),
+        varUInt64(kvGet(entry, varNewStr(BACKUP_PACK_KEY_SIZE_STR))));
+}
+
+static Buffer *
+testPackGet(const Storage *storage, const KeyValue *index, CompressType compressType, const char *name)
+{
+    return testPackGetCipher(storage, index, compressType, cipherTypeNone, NULL, name);
+}
+
+/***********************************************************************************************************************************
+Test Run
+***********************************************************************************************************************************/
+void
+testRun(void)
+{
+    FUNCTION_HARNESS_VOID();
+
+    Storage *storageTest = storageDriverPosixInterface(
+        storageDriverPosixNew(strNew(testPath()), STORAGE_MODE_FILE_DEFAULT, STORAGE_MODE_PATH_DEFAULT, true, NULL));
+
+    // *****************************************************************************************************************************
+    if (testBegin("backupPack*()"))
+    {
+        // Larger than a buffer so reading it takes more than one read
+        Buffer *large = bufNew(ioBufferSize() * 2 + 10);
+        memset(bufPtr(large), 'L', bufSize(large));
+        bufUsedSet(large, bufSize(large));
+
+        // Uncompressed pack
+        // -------------------------------------------------------------------------------------------------------------------------
+        BackupPack *pack = NULL;
+
+        TEST_ASSIGN(pack, backupPackNew(storageTest, strNew("pack"), compressTypeNone, 0, cipherTypeNone, NULL), "new pack");
+        TEST_RESULT_BOOL(storageExistsNP(storageTest, strNew("pack")), false, "    pack is not visible");
+
+        TEST_RESULT_VOID(backupPackAdd(pack, strNew("PG_VERSION"), bufNewStr(strNew("11\n"))), "add file");
+        TEST_RESULT_VOID(backupPackAdd(pack, strNew("empty"), bufNew(0)), "add empty file");
+        TEST_RESULT_VOID(backupPackAdd(pack, strNew("large"), large), "add large file");
+        TEST_RESULT_VOID(backupPackAdd(pack, strNew("global/pg_filenode.map"), bufNewStr(strNew("MAP"))), "add file");
+        TEST_RESULT_UINT(backupPackSize(pack), 3 + bufUsed(large) + 3, "    pack size");
+        TEST_RESULT_STR(
+            strPtr(backupPackToLog(pack)), strPtr(strNewFmt("{file: pack, fileTotal: 4, size: %zu}", 3 + bufUsed(large) + 3)),
+            "    format object");
+
+        TEST_RESULT_VOID(backupPackClose(pack), "close pack");
+        TEST_RESULT_UINT(storageInfoNP(storageTest, strNew("pack")).size, 3 + bufUsed(large) + 3, "    pack is visible");
+
+        const KeyValue *index = backupPackIndex(pack);
+
+        TEST_RESULT_UINT(varLstSize(kvKeyList(index)), 4, "    index has all files");
+        TEST_RESULT_STR(strPtr(strNewBuf(testPackGet(storageTest, index, compressTypeNone, "PG_VERSION"))), "11\n", "get file");
+        TEST_RESULT_UINT(bufUsed(testPackGet(storageTest, index, compressTypeNone, "empty")), 0, "get empty file");
+        TEST_RESULT_BOOL(bufEq(testPackGet(storageTest, index, compressTypeNone, "large"), large), true, "get large file");
+        TEST_RESULT_STR(
+            strPtr(strNewBuf(testPackGet(storageTest, index, compressTypeNone, "global/pg_filenode.map"))), "MAP",
+            "get file after large file");
+
+        TEST_ERROR_FMT(
+            backupPackGet(storageTest, strNew("pack"), compressTypeNone, cipherTypeNone, NULL, bufUsed(large) + 10, 1),
+            FileReadError, "unable to read 1 byte(s) at offset %zu from 'pack'", bufUsed(large) + 10);
+        TEST_ERROR_FMT(
+            backupPackGet(storageTest, strNew("pack"), compressTypeNone, cipherTypeNone, NULL, 3 + bufUsed(large), 4),
+            FileReadError, "unable to read 4 byte(s) at offset %zu from 'pack'", 3 + bufUsed(large));
+
+        TEST_RESULT_VOID(backupPackFree(pack), "free pack");
+        TEST_RESULT_VOID(backupPackFree(NULL), "free null pack");
+
+        // Compressed pack
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_ASSIGN(
+            pack, backupPackNew(storageTest, strNew("pack"), compressTypeGz, 3, cipherTypeNone, NULL), "new compressed pack");
+        TEST_RESULT_VOID(backupPackAdd(pack, strNew("large"), large), "add large file");
+        TEST_RESULT_VOID(backupPackAdd(pack, strNew("PG_VERSION"), bufNewStr(strNew("11\n"))), "add file");
+        TEST_RESULT_BOOL(backupPackSize(pack) < bufUsed(large), true, "    pack is compressed");
+        TEST_RESULT_VOID(backupPackClose(pack), "close pack");
+
+        index = backupPackIndex(pack);
+
+        TEST_RESULT_BOOL(bufEq(testPackGet(storageTest, index, compressTypeGz, "large"), large), true, "get large file");
+        TEST_RESULT_STR(strPtr(strNewBuf(testPackGet(storageTest, index, compressTypeGz, "PG_VERSION"))), "11\n", "get file");
+
+        // Encrypted pack
+        // -------------------------------------------------------------------------------------------------------------------------
+        const String *cipherPass = strNew("12345678");
+
+        TEST_ASSIGN(
+            pack, backupPackNew(storageTest, strNew("pack"), compressTypeGz, 3, cipherTypeAes256Cbc, cipherPass),
+            "new encrypted pack");
+        TEST_RESULT_VOID(backupPackAdd(pack, strNew("large"), large), "add large file");
+        TEST_RESULT_VOID(backupPackAdd(pack, strNew("empty"), bufNew(0)), "add empty file");
+        TEST_RESULT_VOID(backupPackAdd(pack, strNew("PG_VERSION"), bufNewStr(strNew("11\n"))), "add file");
+        TEST_RESULT_VOID(backupPackClose(pack), "close pack");
+
+        index = backupPackIndex(pack);
+
+        TEST_RESULT_BOOL(
+            bufEq(testPackGetCipher(storageTest, index, compressTypeGz, cipherTypeAes256Cbc, cipherPass, "large"), large),
+            true, "get large file");
+        TEST_RESULT_UINT(
+            bufUsed(testPackGetCipher(storageTest, index, compressTypeGz, cipherTypeAes256Cbc, cipherPass, "empty")), 0,
+            "get empty file");
+        TEST_RESULT_STR(
+            strPtr(
+                strNewBuf(testPackGetCipher(storageTest, index, compressTypeGz, cipherTypeAes256Cbc, cipherPass, "PG_VERSION"))),
+            "11\n", "get file after empty file");
+
+        // Encrypted pack without compression
+        TEST_ASSIGN(
+            pack, backupPackNew(storageTest, strNew("pack"), compressTypeNone, 0, cipherTypeAes256Cbc, cipherPass),
+            "new encrypted pack");
+        TEST_RESULT_VOID(backupPackAdd(pack, strNew("PG_VERSION"), bufNewStr(strNew("11\n"))), "add file");
+        TEST_RESULT_VOID(backupPackAdd(pack, strNew("global/pg_filenode.map"), bufNewStr(strNew("MAP"))), "add file");
+        TEST_RESULT_VOID(backupPackClose(pack), "close pack");
+
+        index = backupPackIndex(pack);
+
+        TEST_RESULT_BOOL(
+            bufUsed(testPackGet(storageTest, index, compressTypeNone, "global/pg_filenode.map")) > strlen("MAP"), true,
+            "    file is encrypted");
+        TEST_RESULT_STR(
+            strPtr(
+                strNewBuf(
+                    testPackGetCipher(
+                        storageTest, index, compressTypeNone, cipherTypeAes256Cbc, cipherPass, "global/pg_filenode.map"))),
+            "MAP", "get file");
+        TEST_ERROR(
+            testPackGetCipher(storageTest, index, compressTypeNone, cipherTypeAes256Cbc, strNew("bogus"), "PG_VERSION"),
+            CryptoError, "unable to flush");
+
+        // Pack that is freed before it is closed is not visible
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_ASSIGN(pack, backupPackNew(storageTest, strNew("pack2"), compressTypeNone, 0, cipherTypeNone, NULL), "new pack");
+        TEST_RESULT_VOID(backupPackAdd(pack, strNew("PG_VERSION"), bufNewStr(strNew("11\n"))), "add file");
+        TEST_RESULT_VOID(backupPackFree(pack), "free pack");
+        TEST_RESULT_BOOL(storageExistsNP(storageTest, strNew("pack2")), false, "    pack is not visible");
+    }
+
+    FUNCTION_HARNESS_RESULT_VOID();
+}
@@ -0,0 +1,149 @@
+/***********************************************************************************************************************************
+Test Backup Page Checksum Filter
+***********************************************************************************************************************************/
+#include "common/io/bufferWrite.h"
+#include "common/io/filter/group.h"
+#include "common/io/write.h"
+#include "crypto/hash.h"
+#include "postgres/pageChecksum.h"
+
+/***********************************************************************************************************************************
+Page data for testing -- use 8192 for page size since this is the most common value
+***********************************************************************************************************************************/
+#define TEST_PAGE_SIZE                                              8192
+#define TEST_PAGE_TOTAL                                             16
+#define TEST_SEGMENT_PAGE_TOTAL                                     131072
+
+// Page header fields checked by the filter
+typedef struct TestPageHeader
+{
+    uint32_t walId;                                                 // High bits of the page lsn
+    uint32_t walOffset;                                             // Low bits of the page lsn
+    uint16_t checksum;                                              // Page checksum
+} TestPageHeader;
+
+// GCC doesn't like this elements of this array being used as both char * and struct * so wrap it in a function to disable the
+// optimizations that cause warnings
+unsigned char *
+testPage(unsigned int pageIdx)
+{
+    static unsigned char testPageBuffer[TEST_PAGE_TOTAL][TEST_PAGE_SIZE];
+    return testPageBuffer[pageIdx];
+}
+
+/***********************************************************************************************************************************
+Write pages through a filter group containing a page checksum filter and return the filter result
+***********************************************************************************************************************************/
+static const KeyValue *
+testPageChecksum(const Buffer *input, size_t chunkSize, unsigned int segmentNo, uint32_t ignoreWalId, uint32_t ignoreWalOffset)
+{
+    IoFilterGroup *filterGroup = ioFilterGroupNew();
+    ioFilterGroupAdd(filterGroup, cryptoHashFilter(cryptoHashNew(HASH_TYPE_SHA1_STR)));
+    ioFilterGroupAdd(
+        filterGroup,
+        pageChecksumFilter(pageChecksumNew(segmentNo, TEST_SEGMENT_PAGE_TOTAL, TEST_PAGE_SIZE, ignoreWalId, ignoreWalOffset)));
+
+    IoWrite *write = ioBufferWriteIo(ioBufferWriteNew(bufNew(0)));
+    ioWriteFilterGroupSet(write, filterGroup);
+    ioWriteOpen(write);
+
+    for (size_t inputIdx = 0; inputIdx < bufUsed(input); inputIdx += chunkSize)
+    {
+        size_t size = bufUsed(input) - inputIdx < chunkSize ? bufUsed(input) - inputIdx : chunkSize;
+        ioWrite(write, bufNewC(size, bufPtr(input) + inputIdx));
+    }
+
+    ioWriteClose(write);
+
+    return varKv(ioFilterGroupResult(filterGroup, PAGE_CHECKSUM_FILTER_TYPE_STR));
+}
+
+/***********************************************************************************************************************************
+Test Run
+***********************************************************************************************************************************/
+void
+testRun(void)
+{
+    FUNCTION_HARNESS_VOID();
+
+    // *****************************************************************************************************************************
+    if (testBegin("pageChecksum()"))
+    {
+        // Create pages with valid checksums starting at the first block of segment 1.  Don't fill with zero because zeroes will
+        // succeed on the pd_upper check.
+        for (unsigned int pageIdx = 0; pageIdx < TEST_PAGE_TOTAL; pageIdx++)
+        {
+            memset(testPage(pageIdx), 0x77, TEST_PAGE_SIZE);
+            ((TestPageHeader *)testPage(pageIdx))->checksum = pageChecksum(
+                testPage(pageIdx), TEST_SEGMENT_PAGE_TOTAL + pageIdx, TEST_PAGE_SIZE);
+        }
+
+        Buffer *input = bufNewC(TEST_PAGE_TOTAL * TEST_PAGE_SIZE, testPage(0));
+        const KeyValue *result = NULL;
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_ASSIGN(result, testPageChecksum(input, TEST_PAGE_SIZE * 3, 1, 0xFFFFFFFF, 0xFFFFFFFF), "valid pages");
+        TEST_RESULT_BOOL(varBool(kvGet(result, varNewStr(PAGE_CHECKSUM_KEY_VALID_STR))), true, "    check valid");
+        TEST_RESULT_BOOL(varBool(kvGet(result, varNewStr(PAGE_CHECKSUM_KEY_ALIGN_STR))), true, "    check align");
+        TEST_RESULT_PTR(kvGet(result, varNewStr(PAGE_CHECKSUM_KEY_ERROR_STR)), NULL, "    check no errors");
+
+        TEST_ASSIGN(result, testPageChecksum(input, TEST_PAGE_SIZE, 0, 0xFFFFFFFF, 0xFFFFFFFF), "wrong segment");
+        TEST_RESULT_BOOL(varBool(kvGet(result, varNewStr(PAGE_CHECKSUM_KEY_VALID_STR))), false, "    check valid");
+        TEST_RESULT_UINT(
+            varLstSize(varVarLst(kvGet(result, varNewStr(PAGE_CHECKSUM_KEY_ERROR_STR)))), 1, "    check error total");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        // Break the checksums of blocks 0, 2-4, and 15 (a run crosses the buffer boundary)
+        ((TestPageHeader *)(bufPtr(input) + 0 * TEST_PAGE_SIZE))->checksum = 0xEEEE;
+        ((TestPageHeader *)(bufPtr(input) + 2 * TEST_PAGE_SIZE))->checksum = 0xEEEE;
+        ((TestPageHeader *)(bufPtr(input) + 3 * TEST_PAGE_SIZE))->checksum = 0xEEEE;
+        ((TestPageHeader *)(bufPtr(input) + 4 * TEST_PAGE_SIZE))->checksum = 0xEEEE;
+        ((TestPageHeader *)(bufPtr(input) + 15 * TEST_PAGE_SIZE))->checksum = 0xEEEE;
+
+        TEST_ASSIGN(result, testPageChecksum(input, TEST_PAGE_SIZE * 3, 1, 0xFFFFFFFF, 0xFFFFFFFF), "invalid pages");
+        TEST_RESULT_BOOL(varBool(kvGet(result, varNewStr(PAGE_CHECKSUM_KEY_VALID_STR))), false, "    check valid");
+        TEST_RESULT_BOOL(varBool(kvGet(result, varNewStr(PAGE_CHECKSUM_KEY_ALIGN_STR))), true, "    check align");
+
+        const VariantList *error = varVarLst(kvGet(result, varNewStr(PAGE_CHECKSUM_KEY_ERROR_STR)));
+        TEST_RESULT_UINT(varLstSize(error), 3, "    check error total");
+        TEST_RESULT_UINT(varUInt64(varLstGet(error, 0)), TEST_SEGMENT_PAGE_TOTAL, "    check single block");
+        TEST_RESULT_UINT(
+            varUInt64(varLstGet(varVarLst(varLstGet(error, 1)), 0)), TEST_SEGMENT_PAGE_TOTAL + 2, "    check range begin");
+        TEST_RESULT_UINT(
+            varUInt64(varLstGet(varVarLst(varLstGet(error, 1)), 1)), TEST_SEGMENT_PAGE_TOTAL + 4, "    check range end");
+        TEST_RESULT_UINT(varUInt64(varLstGet(error, 2)), TEST_SEGMENT_PAGE_TOTAL + 15, "    check last block");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        // Pages with an LSN past the ignore limit are not reported (the fill gives the other pages an LSN of 0x77777777/77777777)
+        ((TestPageHeader *)(bufPtr(input) + 15 * TEST_PAGE_SIZE))->walId = 0x77777778;
+
+        TEST_ASSIGN(result, testPageChecksum(input, TEST_PAGE_SIZE * 4, 1, 0x77777778, 0), "ignore pages past lsn limit");
+        TEST_RESULT_UINT(
+            varLstSize(varVarLst(kvGet(result, varNewStr(PAGE_CHECKSUM_KEY_ERROR_STR)))), 2, "    check error total");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        // A misaligned final buffer invalidates the file and removes the errors
+        bufUsedSet(input, bufUsed(input) - 1);
+
+        TEST_ASSIGN(result, testPageChecksum(input, TEST_PAGE_SIZE * 4, 1, 0xFFFFFFFF, 0xFFFFFFFF), "misaligned");
+        TEST_RESULT_BOOL(varBool(kvGet(result, varNewStr(PAGE_CHECKSUM_KEY_VALID_STR))), false, "    check valid");
+        TEST_RESULT_BOOL(varBool(kvGet(result, varNewStr(PAGE_CHECKSUM_KEY_ALIGN_STR))), false, "    check align");
+        TEST_RESULT_PTR(kvGet(result, varNewStr(PAGE_CHECKSUM_KEY_ERROR_STR)), NULL, "    check no errors");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        PageChecksum *filter = pageChecksumNew(0, TEST_SEGMENT_PAGE_TOTAL, TEST_PAGE_SIZE, 0, 0);
+
+        TEST_RESULT_STR(strPtr(ioFilterType(pageChecksumFilter(filter))), PAGE_CHECKSUM_FILTER_TYPE, "check filter type");
+        TEST_RESULT_VOID(pageChecksumProcess(filter, bufNewC(1, bufPtr(input))), "process misaligned buffer");
+        TEST_RESULT_STR(
+            strPtr(pageChecksumToLog(filter)), "{pageTotal: 0, valid: false, align: false}", "check log");
+        TEST_ERROR(
+            pageChecksumProcess(filter, bufNewC(1, bufPtr(input))), AssertError,
+            "should not be possible to see two misaligned pages in a row");
+
+        TEST_RESULT_VOID(pageChecksumFree(filter), "free filter");
+        TEST_RESULT_VOID(pageChecksumFree(NULL), "free null filter");
+    }
+
+    FUNCTION_HARNESS_RESULT_VOID();
+}
@@ -1,6 +1,29 @@
 /***********************************************************************************************************************************
 Test Ini
 ***********************************************************************************************************************************/
+#include "common/io/bufferRead.h"
+
+/***********************************************************************************************************************************
+Callback that renders the section/key/values loaded by iniLoad()
+***********************************************************************************************************************************/
+static void
+testIniLoadCallback(void *data, const String *section, const String *key, const String *value)
+{
+    strCatFmt((String *)data, "%s:%s=%s|", strPtr(section), strPtr(key), strPtr(value));
+}
+
+/***********************************************************************************************************************************
+Load ini content with iniLoad() and return the rendered section/key/values
+***********************************************************************************************************************************/
+static String *
+testIniLoad(const char *content)
+{
+    String *result = strNew("");
+
+    iniLoad(ioBufferReadIo(ioBufferReadNew(bufNewStr(strNew(content)))), testIniLoadCallback, result);
+
+    return result;
+}
 
 /***********************************************************************************************************************************
 Test Run
@@ -51,6 +74,39 @@ testRun(void)
         TEST_RESULT_VOID(iniFree(ini), "free ini");
     }
 
+    // *****************************************************************************************************************************
+    if (testBegin("iniLoad()"))
+    {
+        TEST_RESULT_STR(strPtr(testIniLoad("")), "", "no content");
+        TEST_RESULT_STR(strPtr(testIniLoad("\n# Comment\n\n")), "", "no key/values");
+        TEST_ERROR(testIniLoad("[section]\n =value"), FormatError, "key is zero-length at line 2: =value");
+
+        // Small buffer so lines are split across reads and long lines must grow the buffer
+        // -------------------------------------------------------------------------------------------------------------------------
+        size_t bufferSize = ioBufferSize();
+        ioBufferSizeSet(8);
+
+        TEST_RESULT_STR(
+            strPtr(
+                testIniLoad(
+                    "[section1]\r\n"
+                    "key1=value1\r\n"
+                    "\tkey2 \t= \tvalue2 with spaces\t\n"
+                    "key3=\n"
+                    "\r key4\r\t=\r\tvalue4\n"
+                    "[section2]\n"
+                    "key-that-is-longer-than-the-buffer=value=with=equals")),
+            "section1:key1=value1|section1:key2=value2 with spaces|section1:key3=|section1:key4=value4|"
+                "section2:key-that-is-longer-than-the-buffer=value=with=equals|",
+            "load in small reads");
+
+        TEST_ERROR(
+            testIniLoad("[section]\nkey=value\n[section-that-is-not-closed\n"), FormatError,
+            "ini section should end with ] at line 3: [section-that-is-not-closed");
+
+        ioBufferSizeSet(bufferSize);
+    }
+
     // *****************************************************************************************************************************
     if (testBegin("iniParse()"))
     {
@@ -63,7 +119,7 @@ testRun(void)
             iniParse(iniNew(), strNew("compress=y\n")), FormatError, "key/value found outside of section at line 1: compress=y");
         TEST_ERROR(iniParse(iniNew(), strNew("[section\n")), FormatError, "ini section should end with ] at line 1: [section");
         TEST_ERROR(iniParse(iniNew(), strNew("[section]\nkey")), FormatError, "missing '=' in key/value at line 2: key");
-        TEST_ERROR(iniParse(iniNew(), strNew("[section]\n =value")), FormatError, "key is zero-length at line 1: =value");
+        TEST_ERROR(iniParse(iniNew(), strNew("[section]\n =value")), FormatError, "key is zero-length at line 2: =value");
 
         // -------------------------------------------------------------------------------------------------------------------------
         TEST_ASSIGN(ini, iniNew(), "new ini");
@@ -84,5 +140,35 @@ testRun(void)
         TEST_RESULT_STR(strPtr(varStr(iniGet(ini, strNew("db"), strNew("pg1-path")))), "/path/to/pg", "get pg1-path");
     }
 
+    // *****************************************************************************************************************************
+    if (testBegin("iniParse() benchmark"))
+    {
+        // Load a synthetic manifest with many files.  Before keys were indexed the load time grew with the square of the number of
+        // files.  Unit tests are built without optimization so only the scaling of the results is useful.
+        for (unsigned int fileTotal = 25000; fileTotal <= 100000; fileTotal *= 2)
+        {
+            MEM_CONTEXT_TEMP_BEGIN()
+            {
+                String *content = strNew("[target:file]\n");
+
+                for (unsigned int fileIdx = 0; fileIdx < fileTotal; fileIdx++)
+                {
+                    strCatFmt(
+                        content, "pg_data/base/16384/%u={\"checksum\":\"%040u\",\"size\":8192,\"timestamp\":1557432154}\n",
+                        fileIdx, fileIdx);
+                }
+
+                Ini *ini = iniNew();
+                uint64_t timeBegin = testTimeMSec();
+
+                iniParse(ini, content);
+
+                TEST_LOG_FMT("%u files: %" PRIu64 "ms", fileTotal, testTimeMSec() - timeBegin);
+                TEST_RESULT_UINT(strLstSize(iniSectionKeyList(ini, strNew("target:file"))), fileTotal, "    check file total");
+            }
+            MEM_CONTEXT_TEMP_END();
+        }
+    }
+
     FUNCTION_HARNESS_RESULT_VOID();
 }
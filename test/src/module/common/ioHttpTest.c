@@ -269,6 +269,41 @@ testHttpServer(void)
 
         harnessTlsServerClose();
 
+        // Async request with body
+        harnessTlsServerAccept();
+
+        harnessTlsServerExpect(
+            "PUT /upload HTTP/1.1\r\n"
+            "content-length:4\r\n"
+            "\r\n"
+            "DATA");
+
+        harnessTlsServerReply(
+            "HTTP/1.1 200 OK\r\n"
+            "content-length:0\r\n"
+            "\r\n");
+
+        // Async request with response never read
+        harnessTlsServerExpect(
+            "GET /abandon HTTP/1.1\r\n"
+            "\r\n");
+
+        harnessTlsServerClose();
+
+        // Request after abandoned request uses a new connection
+        harnessTlsServerAccept();
+
+        harnessTlsServerExpect(
+            "GET / HTTP/1.1\r\n"
+            "\r\n");
+
+        harnessTlsServerReply(
+            "HTTP/1.1 200 OK\r\n"
+            "content-length:0\r\n"
+            "\r\n");
+
+        harnessTlsServerClose();
+
         exit(0);
     }
 }
@@ -370,55 +405,65 @@ testRun(void)
         HttpClient *client = NULL;
         ioBufferSizeSet(35);
 
-        TEST_ASSIGN(client, httpClientNew(strNew("localhost"), TLS_TEST_PORT, 500, true, NULL, NULL), "new client");
+        TEST_ASSIGN(
+            client, httpClientNew(tlsContextNew(true, NULL, NULL), strNew("localhost"), TLS_TEST_PORT, 500), "new client");
 
         TEST_ERROR(
-            httpClientRequest(client, strNew("GET"), strNew("/"), NULL, NULL, false), HostConnectError,
+            httpClientRequest(client, strNew("GET"), strNew("/"), NULL, NULL, NULL, false), HostConnectError,
             "unable to connect to 'localhost:9443': [111] Connection refused");
 
+        // Async send errors are reported when the response is read
+        TEST_RESULT_VOID(
+            httpClientRequestAsync(client, strNew("GET"), strNew("/"), NULL, NULL, NULL), "async request with send error");
+        TEST_RESULT_BOOL(httpClientBusy(client), true, "    client is busy");
+        TEST_ERROR(
+            httpClientResponse(client, false), HostConnectError, "unable to connect to 'localhost:9443': [111] Connection refused");
+        TEST_RESULT_BOOL(httpClientBusy(client), false, "    client is not busy");
+
         // Start http test server
         testHttpServer();
 
         // Test no output from server
-        TEST_ASSIGN(client, httpClientNew(strNew(TLS_TEST_HOST), TLS_TEST_PORT, 500, true, NULL, NULL), "new client");
+        TEST_ASSIGN(
+            client, httpClientNew(tlsContextNew(true, NULL, NULL), strNew(TLS_TEST_HOST), TLS_TEST_PORT, 500), "new client");
         client->timeout = 0;
 
         TEST_ERROR(
-            httpClientRequest(client, strNew("GET"), strNew("/"), NULL, NULL, false), FileReadError,
+            httpClientRequest(client, strNew("GET"), strNew("/"), NULL, NULL, NULL, false), FileReadError,
             "unable to read data from '" TLS_TEST_HOST ":9443' after 500ms");
 
         // Test invalid http version
         TEST_ERROR(
-            httpClientRequest(client, strNew("GET"), strNew("/"), NULL, NULL, false), FormatError,
+            httpClientRequest(client, strNew("GET"), strNew("/"), NULL, NULL, NULL, false), FormatError,
             "http version of response 'HTTP/1.0 200 OK' must be HTTP/1.1");
 
         // Test no space in status
         TEST_ERROR(
-            httpClientRequest(client, strNew("GET"), strNew("/"), NULL, NULL, false), FormatError,
+            httpClientRequest(client, strNew("GET"), strNew("/"), NULL, NULL, NULL, false), FormatError,
             "response status '200OK' must have a space");
 
         // Test unexpected end of headers
         TEST_ERROR(
-            httpClientRequest(client, strNew("GET"), strNew("/"), NULL, NULL, false), FileReadError,
+            httpClientRequest(client, strNew("GET"), strNew("/"), NULL, NULL, NULL, false), FileReadError,
             "unexpected eof while reading line");
 
         // Test missing colon in header
         TEST_ERROR(
-            httpClientRequest(client, strNew("GET"), strNew("/"), NULL, NULL, false), FormatError,
+            httpClientRequest(client, strNew("GET"), strNew("/"), NULL, NULL, NULL, false), FormatError,
             "header 'header-value' missing colon");
 
         // Test invalid transfer encoding
         TEST_ERROR(
-            httpClientRequest(client, strNew("GET"), strNew("/"), NULL, NULL, false), FormatError,
+            httpClientRequest(client, strNew("GET"), strNew("/"), NULL, NULL, NULL, false), FormatError,
             "only 'chunked' is supported for 'transfer-encoding' header");
 
         // Test content length and transfer encoding both set
         TEST_ERROR(
-            httpClientRequest(client, strNew("GET"), strNew("/"), NULL, NULL, false), FormatError,
+            httpClientRequest(client, strNew("GET"), strNew("/"), NULL, NULL, NULL, false), FormatError,
             "'transfer-encoding' and 'content-length' headers are both set");
 
         // Test 5xx error with no retry
-        TEST_ERROR(httpClientRequest(client, strNew("GET"), strNew("/"), NULL, NULL, false), ServiceError, "[503] Slow Down");
+        TEST_ERROR(httpClientRequest(client, strNew("GET"), strNew("/"), NULL, NULL, NULL, false), ServiceError, "[503] Slow Down");
 
         // Request with no content
         client->timeout = 500;
@@ -431,7 +476,7 @@ testRun(void)
         httpQueryAdd(query, strNew("type"), strNew("test"));
 
         TEST_RESULT_VOID(
-            httpClientRequest(client, strNew("GET"), strNew("/"), query, headerRequest, false), "request with no content");
+            httpClientRequest(client, strNew("GET"), strNew("/"), query, headerRequest, NULL, false), "request with no content");
         TEST_RESULT_UINT(httpClientResponseCode(client), 200, "    check response code");
         TEST_RESULT_STR(strPtr(httpClientResponseMessage(client)), "OK", "    check response message");
         TEST_RESULT_STR(
@@ -439,7 +484,8 @@ testRun(void)
             "    check response headers");
 
         // Error with content length 0
-        TEST_RESULT_VOID(httpClientRequest(client, strNew("GET"), strNew("/"), NULL, NULL, false), "error with content length 0");
+        TEST_RESULT_VOID(
+            httpClientRequest(client, strNew("GET"), strNew("/"), NULL, NULL, NULL, false), "error with content length 0");
         TEST_RESULT_UINT(httpClientResponseCode(client), 404, "    check response code");
         TEST_RESULT_STR(strPtr(httpClientResponseMessage(client)), "Not Found", "    check response message");
         TEST_RESULT_STR(
@@ -448,7 +494,8 @@ testRun(void)
         // Error with content
         Buffer *buffer = NULL;
 
-        TEST_ASSIGN(buffer, httpClientRequest(client, strNew("GET"), strNew("/"), NULL, NULL, false), "error with content length");
+        TEST_ASSIGN(
+            buffer, httpClientRequest(client, strNew("GET"), strNew("/"), NULL, NULL, NULL, false), "error with content length");
         TEST_RESULT_UINT(httpClientResponseCode(client), 403, "    check response code");
         TEST_RESULT_STR(strPtr(httpClientResponseMessage(client)), "Auth Error", "    check response message");
         TEST_RESULT_STR(
@@ -460,7 +507,8 @@ testRun(void)
 
         TEST_ASSIGN(
             buffer,
-            httpClientRequest(client, strNew("GET"), strNew("/path/file 1.txt"), NULL, NULL, true), "request with content length");
+            httpClientRequest(client, strNew("GET"), strNew("/path/file 1.txt"), NULL, NULL, NULL, true),
+            "request with content length");
         TEST_RESULT_STR(
             strPtr(httpHeaderToLog(httpClientReponseHeader(client))),  "{connection: 'close', content-length: '32'}",
             "    check response headers");
@@ -469,7 +517,7 @@ testRun(void)
 
         // Request with eof before content complete with retry
         TEST_ASSIGN(
-            buffer, httpClientRequest(client, strNew("GET"), strNew("/path/file 1.txt"), NULL, NULL, true),
+            buffer, httpClientRequest(client, strNew("GET"), strNew("/path/file 1.txt"), NULL, NULL, NULL, true),
             "request with content length retry");
         TEST_RESULT_STR(strPtr(strNewBuf(buffer)),  "01234567890123456789012345678901", "    check response");
         TEST_RESULT_UINT(httpClientRead(client, bufNew(1), true), 0, "    call internal read to check eof");
@@ -477,24 +525,96 @@ testRun(void)
         // Request with eof before content and error
         buffer = bufNew(32);
         TEST_RESULT_VOID(
-            httpClientRequest(client, strNew("GET"), strNew("/path/file 1.txt"), NULL, NULL, false),
+            httpClientRequest(client, strNew("GET"), strNew("/path/file 1.txt"), NULL, NULL, NULL, false),
             "request with content length error");
         TEST_ERROR(
             ioRead(httpClientIoRead(client), buffer), FileReadError, "unexpected EOF reading HTTP content");
 
         // Request with content using chunked encoding
-        TEST_RESULT_VOID(httpClientRequest(client, strNew("GET"), strNew("/"), NULL, NULL, false), "request with chunked encoding");
+        TEST_RESULT_VOID(
+            httpClientRequest(client, strNew("GET"), strNew("/"), NULL, NULL, NULL, false), "request with chunked encoding");
         TEST_RESULT_STR(
             strPtr(httpHeaderToLog(httpClientReponseHeader(client))),  "{transfer-encoding: 'chunked'}",
             "    check response headers");
+        TEST_RESULT_BOOL(httpClientBusy(client), true, "    client is busy until content is read");
 
         buffer = bufNew(35);
         TEST_RESULT_VOID(ioRead(httpClientIoRead(client), buffer),  "    read response");
         TEST_RESULT_STR(strPtr(strNewBuf(buffer)),  "01234567890123456789012345678901012", "    check response");
+        TEST_RESULT_BOOL(httpClientBusy(client), false, "    client is not busy");
+
+        // Async request with body
+        TEST_ASSIGN(
+            client, httpClientNew(tlsContextNew(true, NULL, NULL), strNew(TLS_TEST_HOST), TLS_TEST_PORT, 500), "new client");
+
+        TEST_RESULT_VOID(
+            httpClientRequestAsync(
+                client, HTTP_VERB_PUT_STR, strNew("/upload"), NULL,
+                httpHeaderAdd(httpHeaderNew(NULL), HTTP_HEADER_CONTENT_LENGTH_STR, strNew("4")), bufNewStr(strNew("DATA"))),
+            "async request with body");
+        TEST_RESULT_BOOL(httpClientBusy(client), true, "    client is busy");
+        TEST_RESULT_PTR(httpClientResponse(client, true), NULL, "    read response");
+        TEST_RESULT_UINT(httpClientResponseCode(client), 200, "    check response code");
+        TEST_RESULT_BOOL(httpClientBusy(client), false, "    client is not busy");
+
+        // Abandoning an async request closes the connection since the response will never be read
+        TEST_RESULT_VOID(
+            httpClientRequestAsync(client, strNew("GET"), strNew("/abandon"), NULL, NULL, NULL), "async request abandoned");
+        TEST_RESULT_VOID(
+            httpClientRequest(client, strNew("GET"), strNew("/"), NULL, NULL, NULL, false), "request after abandoned request");
+        TEST_RESULT_UINT(httpClientResponseCode(client), 200, "    check response code");
 
         TEST_RESULT_VOID(httpClientFree(client), "free client");
         TEST_RESULT_VOID(httpClientFree(NULL), "free null client");
     }
 
+    // *****************************************************************************************************************************
+    if (testBegin("HttpClientCache"))
+    {
+        HttpClientCache *cache = NULL;
+        HttpClient *client1 = NULL;
+        HttpClient *client2 = NULL;
+
+        TEST_ASSIGN(cache, httpClientCacheNew(strNew("localhost"), TLS_TEST_PORT, 0, true, NULL, NULL), "new cache");
+        TEST_RESULT_UINT(httpClientCacheSize(cache), 0, "    cache is empty");
+
+        TEST_ASSIGN(client1, httpClientCacheGet(cache), "get client");
+        TEST_RESULT_UINT(httpClientCacheSize(cache), 1, "    cache has one client");
+        TEST_RESULT_PTR(httpClientCacheGet(cache), client1, "get same client since it is not busy");
+
+        // Make the first client busy.  The send fails (there is no server) but the response has not been read yet.
+        httpClientRequestAsync(client1, strNew("GET"), strNew("/"), NULL, NULL, NULL);
+
+        TEST_ASSIGN(client2, httpClientCacheGet(cache), "get new client when first is busy");
+        TEST_RESULT_BOOL(client1 == client2, false, "    clients are different");
+        TEST_RESULT_UINT(httpClientCacheSize(cache), 2, "    cache has two clients");
+
+        TEST_ERROR(
+            httpClientResponse(client1, false), HostConnectError,
+            "unable to connect to 'localhost:9443': [111] Connection refused");
+        TEST_RESULT_PTR(httpClientCacheGet(cache), client1, "get first client again when no longer busy");
+        TEST_RESULT_UINT(httpClientCacheSize(cache), 2, "    cache still has two clients");
+
+        // Release a client that was abandoned while busy
+        httpClientRequestAsync(client2, strNew("GET"), strNew("/"), NULL, NULL, NULL);
+
+        TEST_RESULT_VOID(httpClientDone(client2), "release busy client");
+        TEST_RESULT_BOOL(httpClientBusy(client2), false, "    client is not busy");
+        TEST_RESULT_VOID(httpClientDone(client2), "release client that is not busy");
+
+        // Error when all clients are busy and the cache is full
+        for (unsigned int clientIdx = 0; clientIdx < HTTP_CLIENT_CACHE_MAX; clientIdx++)
+            httpClientRequestAsync(httpClientCacheGet(cache), strNew("GET"), strNew("/"), NULL, NULL, NULL);
+
+        TEST_RESULT_UINT(httpClientCacheSize(cache), HTTP_CLIENT_CACHE_MAX, "    cache is full");
+        TEST_ERROR(httpClientCacheGet(cache), AssertError, "all 64 http clients are busy");
+
+        TEST_RESULT_VOID(httpClientDone(client1), "release first client");
+        TEST_RESULT_PTR(httpClientCacheGet(cache), client1, "get released client from full cache");
+
+        TEST_RESULT_VOID(httpClientCacheFree(cache), "free cache");
+        TEST_RESULT_VOID(httpClientCacheFree(NULL), "free null cache");
+    }
+
     FUNCTION_HARNESS_RESULT_VOID();
 }
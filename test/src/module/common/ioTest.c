@@ -53,6 +53,15 @@ testIoWrite(void *driver, const Buffer *buffer)
     ASSERT(strEq(strNewBuf(buffer), strNew("ABC")));
 }
 
+static bool testIoWriteFlushCalled = false;
+
+static void
+testIoWriteFlush(void *driver)
+{
+    ASSERT(driver == (void *)999);
+    testIoWriteFlushCalled = true;
+}
+
 static bool testIoWriteCloseCalled = false;
 
 static void
@@ -336,9 +345,12 @@ testRun(void)
         TEST_RESULT_STR(strPtr(strNewBuf(buffer)), "AAA", "    check buffer");
 
         // Do line reads of various lengths
+        TEST_RESULT_BOOL(ioReadLineBuffered(read), false, "no line buffered");
         TEST_RESULT_STR(strPtr(ioReadLine(read)), "123", "read line");
         TEST_RESULT_STR(strPtr(ioReadLine(read)), "1234", "read line");
+        TEST_RESULT_BOOL(ioReadLineBuffered(read), false, "no line buffered");
         TEST_RESULT_STR(strPtr(ioReadLine(read)), "", "read line");
+        TEST_RESULT_BOOL(ioReadLineBuffered(read), true, "line buffered");
         TEST_RESULT_STR(strPtr(ioReadLine(read)), "12", "read line");
 
         // Read what was left in the line buffer
@@ -393,13 +405,16 @@ testRun(void)
         TEST_ASSIGN(
             write,
             ioWriteNewP(
-                (void *)999, .close = (IoWriteInterfaceClose)testIoWriteClose, .open = (IoWriteInterfaceOpen)testIoWriteOpen,
-                .write = (IoWriteInterfaceWrite)testIoWrite),
+                (void *)999, .close = (IoWriteInterfaceClose)testIoWriteClose, .flush = (IoWriteInterfaceFlush)testIoWriteFlush,
+                .open = (IoWriteInterfaceOpen)testIoWriteOpen, .write = (IoWriteInterfaceWrite)testIoWrite),
             "create io write object");
 
         TEST_RESULT_VOID(ioWriteOpen(write), "    open io object");
         TEST_RESULT_BOOL(testIoWriteOpenCalled, true, "    check io object open");
+        TEST_RESULT_INT(ioWriteHandle(write), -1, "    no handle");
         TEST_RESULT_VOID(ioWrite(write, bufNewZ("ABC")), "    write 3 bytes");
+        TEST_RESULT_VOID(ioWriteFlush(write), "    flush io object");
+        TEST_RESULT_BOOL(testIoWriteFlushCalled, true, "    check io object flushed");
         TEST_RESULT_VOID(ioWriteClose(write), "    close io object");
         TEST_RESULT_BOOL(testIoWriteCloseCalled, true, "    check io object closed");
 
@@ -457,6 +472,26 @@ testRun(void)
 
         TEST_RESULT_VOID(ioBufferWriteFree(bufferWrite), "    free buffer write object");
         TEST_RESULT_VOID(ioBufferWriteFree(NULL), "    free NULL buffer write object");
+
+        // Intermediate buffer smaller than the output buffer so filters must be run again before the output buffer is full
+        // -------------------------------------------------------------------------------------------------------------------------
+        ioBufferSizeSet(8);
+        buffer = bufNew(0);
+        bufferWrite = ioBufferWriteNew(buffer);
+
+        filterGroup = ioFilterGroupNew();
+        ioFilterGroupAdd(filterGroup, ioTestFilterMultiplyNew("double", 2, 1, 'X')->filter);
+        ioFilterGroupAdd(filterGroup, ioTestFilterMultiplyNew("single", 1, 1, 'Y')->filter);
+        ioFilterGroupAdd(filterGroup, ioTestFilterSizeNew("size")->filter);
+        ioWriteFilterGroupSet(ioBufferWriteIo(bufferWrite), filterGroup);
+
+        ioBufferSizeSet(2);
+        TEST_RESULT_VOID(ioWriteOpen(ioBufferWriteIo(bufferWrite)), "open buffer write object");
+        TEST_RESULT_VOID(ioWrite(ioBufferWriteIo(bufferWrite), bufNewZ("abc")), "    write bytes");
+        TEST_RESULT_BOOL(ioFilterGroupInputSame(filterGroup), false, "    input not needed again");
+        TEST_RESULT_VOID(ioWriteClose(ioBufferWriteIo(bufferWrite)), "    close buffer write object");
+        TEST_RESULT_STR(strPtr(strNewBuf(buffer)), "aabbccXY", "    check write");
+        TEST_RESULT_UINT(varUInt64(ioFilterGroupResult(filterGroup, strNew("size"))), 8, "    check size seen in output buffer");
     }
 
     // *****************************************************************************************************************************
@@ -481,6 +516,7 @@ testRun(void)
                 MEM_CONTEXT_TEMP_END();
 
                 ioWriteOpen(ioHandleWriteIo(write));
+                TEST_RESULT_INT(ioWriteHandle(ioHandleWriteIo(write)), HARNESS_FORK_CHILD_WRITE(), "check handle");
 
                 // Write a line to be read
                 TEST_RESULT_VOID(ioWriteLine(ioHandleWriteIo(write), strNew("test string 1")), "write test string");
@@ -84,6 +84,38 @@ testTlsServer(void)
 
         harnessTlsServerClose();
 
+        // Third protocol exchange on a new connection that resumes the prior session
+        harnessTlsServerAccept();
+
+        harnessTlsServerExpect("resume protocol info");
+        harnessTlsServerReply("resumed");
+
+        harnessTlsServerClose();
+
+        // Clients sharing a context.  The first connection is closed by the client after an error.
+        harnessTlsServerAccept();
+
+        harnessTlsServerExpect("error protocol info");
+        harnessTlsServerReply("error");
+
+        harnessTlsServerClose();
+
+        // The second connection is shut down cleanly by the client
+        harnessTlsServerAccept();
+
+        harnessTlsServerExpect("shutdown protocol info");
+        harnessTlsServerReply("shutdown");
+
+        harnessTlsServerClose();
+
+        // The third connection resumes the session of the second
+        harnessTlsServerAccept();
+
+        harnessTlsServerExpect("shared protocol info");
+        harnessTlsServerReply("shared");
+
+        harnessTlsServerClose();
+
         exit(0);
     }
 }
@@ -182,6 +214,7 @@ testRun(void)
 
         TEST_ASSIGN(client, tlsClientNew(strNew(TLS_TEST_HOST), 9443, 500, true, NULL, NULL), "new client");
         TEST_RESULT_VOID(tlsClientOpen(client), "open client");
+        TEST_RESULT_BOOL(tlsClientSessionReused(client), false, "    check session not reused");
 
         Buffer *input = bufNewStr(strNew("some protocol info"));
         TEST_RESULT_VOID(ioWrite(tlsClientIoWrite(client), input), "write input");
@@ -219,9 +252,67 @@ testRun(void)
         output = bufNew(12);
         TEST_RESULT_INT(ioRead(tlsClientIoRead(client), output), 0, "read no output after eof");
         TEST_RESULT_BOOL(ioReadEof(tlsClientIoRead(client)), true, "    check eof = true");
+        TEST_RESULT_BOOL(tlsClientSessionReused(client), false, "    check session not reused when closed");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        input = bufNewStr(strNew("resume protocol info"));
+        TEST_RESULT_VOID(tlsClientOpen(client), "open client with saved session");
+        TEST_RESULT_BOOL(tlsClientSessionReused(client), true, "    check session reused");
+        TEST_RESULT_VOID(ioWrite(tlsClientIoWrite(client), input), "write input");
+        ioWriteFlush(tlsClientIoWrite(client));
+
+        output = bufNew(7);
+        TEST_RESULT_INT(ioRead(tlsClientIoRead(client), output), 7, "read output");
+        TEST_RESULT_STR(strPtr(strNewBuf(output)), "resumed", "    check output");
 
         TEST_RESULT_VOID(tlsClientFree(client), "free client");
         TEST_RESULT_VOID(tlsClientFree(NULL), "free null client");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TlsContext *context = NULL;
+        TlsClient *client1 = NULL;
+        TlsClient *client2 = NULL;
+
+        TEST_ASSIGN(context, tlsContextNew(true, NULL, NULL), "new context");
+        TEST_ASSIGN(client1, tlsClientNewContext(context, strNew(TLS_TEST_HOST), 9443, 500), "new client with shared context");
+        TEST_ASSIGN(client2, tlsClientNewContext(context, strNew(TLS_TEST_HOST), 9443, 500), "new client with shared context");
+
+        input = bufNewStr(strNew("error protocol info"));
+        TEST_RESULT_VOID(tlsClientOpen(client1), "open first client");
+        TEST_RESULT_VOID(ioWrite(tlsClientIoWrite(client1), input), "write input");
+        ioWriteFlush(tlsClientIoWrite(client1));
+
+        output = bufNew(5);
+        TEST_RESULT_INT(ioRead(tlsClientIoRead(client1), output), 5, "read output");
+        TEST_RESULT_STR(strPtr(strNewBuf(output)), "error", "    check output");
+        TEST_RESULT_VOID(tlsClientClose(client1), "close first client as if there was an error");
+
+        input = bufNewStr(strNew("shutdown protocol info"));
+        TEST_RESULT_VOID(tlsClientOpen(client2), "open second client");
+        TEST_RESULT_BOOL(tlsClientSessionReused(client2), false, "    check session not saved on close");
+        TEST_RESULT_VOID(ioWrite(tlsClientIoWrite(client2), input), "write input");
+        ioWriteFlush(tlsClientIoWrite(client2));
+
+        output = bufNew(8);
+        TEST_RESULT_INT(ioRead(tlsClientIoRead(client2), output), 8, "read output");
+        TEST_RESULT_STR(strPtr(strNewBuf(output)), "shutdown", "    check output");
+        TEST_RESULT_VOID(tlsClientShutdown(client2), "shut down second client");
+        TEST_RESULT_BOOL(tlsClientEof(client2), true, "    check client is closed");
+
+        input = bufNewStr(strNew("shared protocol info"));
+        TEST_RESULT_VOID(tlsClientOpen(client1), "open first client again");
+        TEST_RESULT_BOOL(tlsClientSessionReused(client1), true, "    check session of second client reused");
+        TEST_RESULT_VOID(ioWrite(tlsClientIoWrite(client1), input), "write input");
+        ioWriteFlush(tlsClientIoWrite(client1));
+
+        output = bufNew(6);
+        TEST_RESULT_INT(ioRead(tlsClientIoRead(client1), output), 6, "read output");
+        TEST_RESULT_STR(strPtr(strNewBuf(output)), "shared", "    check output");
+
+        TEST_RESULT_VOID(tlsContextFree(context), "free context before clients");
+        TEST_RESULT_VOID(tlsContextFree(NULL), "free null context");
+        TEST_RESULT_VOID(tlsClientFree(client1), "free open client");
+        TEST_RESULT_VOID(tlsClientFree(client2), "free closed client");
     }
 
     FUNCTION_HARNESS_RESULT_VOID();
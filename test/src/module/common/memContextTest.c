@@ -387,6 +387,139 @@ testRun(void)
         MEM_CONTEXT_NEW_END();
     }
 
+    // *****************************************************************************************************************************
+    if (testBegin("memContextNewArena(), memArena*()"))
+    {
+        MemContext *memContext = NULL;
+
+        MEM_CONTEXT_NEW_ARENA_BEGIN("test-arena")
+        {
+            memContext = MEM_CONTEXT_NEW();
+
+            TEST_RESULT_BOOL(memContext->arena, true, "context is an arena");
+            TEST_RESULT_UINT(memContext->allocListSize, 0, "no allocation list");
+            TEST_RESULT_PTR(memContext->slabList, NULL, "no slabs");
+
+            // Allocate
+            // ---------------------------------------------------------------------------------------------------------------------
+            unsigned char *buffer1 = memNewRaw(3);
+            memset(buffer1, 0xFE, 3);
+
+            MemContextSlab *slab = memContext->slabList;
+            TEST_RESULT_BOOL(slab != NULL, true, "slab allocated");
+            TEST_RESULT_UINT(slab->size, MEM_CONTEXT_ARENA_SLAB_SIZE, "slab size");
+            TEST_RESULT_UINT(slab->used, MEM_CONTEXT_ARENA_HEADER_SIZE + MEM_CONTEXT_ARENA_ALIGN, "slab used");
+            TEST_RESULT_UINT((uintptr_t)buffer1 % MEM_CONTEXT_ARENA_ALIGN, 0, "buffer is aligned");
+
+            unsigned char *buffer2 = memNew(sizeof(size_t));
+            TEST_RESULT_UINT(((size_t *)buffer2)[0], 0, "buffer is zeroed");
+            TEST_RESULT_UINT((uintptr_t)buffer2 % MEM_CONTEXT_ARENA_ALIGN, 0, "buffer is aligned");
+
+            // Grow
+            // ---------------------------------------------------------------------------------------------------------------------
+            size_t used = slab->used;
+            TEST_RESULT_PTR(memGrowRaw(buffer2, 100), buffer2, "most recent allocation grows in place");
+            TEST_RESULT_UINT(slab->used, used + MEM_CONTEXT_ARENA_ALIGN_SIZE(100) - MEM_CONTEXT_ARENA_ALIGN, "slab used");
+
+            unsigned char *buffer1Grow = memGrowRaw(buffer1, 10);
+            TEST_RESULT_BOOL(buffer1Grow != buffer1, true, "older allocation is copied");
+            TEST_RESULT_INT(memcmp(buffer1Grow, "\xFE\xFE\xFE", 3), 0, "contents are copied");
+            TEST_ERROR(memFree(buffer1), AssertError, "unable to find allocation");
+
+            buffer1 = memGrowRaw(buffer1Grow, 2);
+            TEST_RESULT_PTR(buffer1, buffer1Grow, "most recent allocation shrinks in place");
+
+            // Free
+            // ---------------------------------------------------------------------------------------------------------------------
+            used = slab->used;
+            TEST_RESULT_VOID(memFree(buffer2), "free older allocation");
+            TEST_RESULT_UINT(slab->used, used, "space is not reused");
+            TEST_ERROR(memFree(buffer2), AssertError, "unable to find allocation");
+
+            TEST_RESULT_VOID(memFree(buffer1), "free most recent allocation");
+            TEST_RESULT_UINT(slab->used, used - MEM_CONTEXT_ARENA_HEADER_SIZE - MEM_CONTEXT_ARENA_ALIGN, "space is reused");
+
+            // Allocation made in another context
+            MEM_CONTEXT_NEW_ARENA_BEGIN("test-arena-other")
+            {
+                buffer1 = memNew(1);
+            }
+            MEM_CONTEXT_NEW_END();
+
+            TEST_ERROR(memFree(buffer1), AssertError, "unable to find allocation");
+
+            // Slabs
+            // ---------------------------------------------------------------------------------------------------------------------
+            buffer1 = memNewRaw(slab->size - slab->used - MEM_CONTEXT_ARENA_HEADER_SIZE);
+            TEST_RESULT_UINT(slab->used, slab->size, "slab is full");
+
+            memset(buffer1, 0xFE, 1);
+
+            buffer2 = memGrowRaw(buffer1, slab->size);
+            TEST_RESULT_PTR(memContext->slabList, slab, "current slab is not replaced by a large allocation");
+            TEST_RESULT_UINT(
+                memContext->slabList->next->size, MEM_CONTEXT_ARENA_HEADER_SIZE + MEM_CONTEXT_ARENA_SLAB_SIZE,
+                "large allocation gets its own slab");
+            TEST_RESULT_UINT(buffer2[0], 0xFE, "contents are copied");
+
+            TEST_RESULT_VOID(memFree(buffer2), "free large allocation");
+
+            memNew(1);
+            TEST_RESULT_PTR(memContext->slabList->next, slab, "new current slab when current slab is full");
+        }
+        MEM_CONTEXT_NEW_END();
+
+        TEST_RESULT_VOID(memContextFree(memContext), "free arena");
+        TEST_RESULT_PTR(memContext->slabList, NULL, "slabs are freed");
+
+        // First allocation is large
+        // -------------------------------------------------------------------------------------------------------------------------
+        MEM_CONTEXT_NEW_ARENA_BEGIN("test-arena")
+        {
+            memContext = MEM_CONTEXT_NEW();
+            memNew(MEM_CONTEXT_ARENA_SLAB_SIZE);
+
+            TEST_RESULT_UINT(
+                memContext->slabList->size, MEM_CONTEXT_ARENA_HEADER_SIZE + MEM_CONTEXT_ARENA_SLAB_SIZE, "large slab");
+            TEST_RESULT_PTR(memContext->slabList->next, NULL, "only slab");
+        }
+        MEM_CONTEXT_NEW_END();
+
+        memContextFree(memContext);
+    }
+
+    // *****************************************************************************************************************************
+    if (testBegin("memContextNewArena() benchmark"))
+    {
+        // Compare allocating and then freeing many small buffers in a standard and an arena context.  Unit tests are built without
+        // optimization so the results are only useful for comparing the contexts to each other.
+        unsigned int allocTotal = 10000;
+        void **allocList = malloc(sizeof(void *) * allocTotal);
+
+        for (unsigned int arena = 0; arena <= 1; arena++)
+        {
+            MemContext *memContext = arena ? memContextNewArena("benchmark") : memContextNew("benchmark");
+            MemContext *memContextOld = memContextSwitch(memContext);
+            uint64_t timeBegin = testTimeMSec();
+
+            for (unsigned int allocIdx = 0; allocIdx < allocTotal; allocIdx++)
+            {
+                allocList[allocIdx] = memNewRaw(16);
+                allocList[allocIdx] = memGrowRaw(allocList[allocIdx], 32);
+            }
+
+            for (unsigned int allocIdx = 0; allocIdx < allocTotal; allocIdx++)
+                memFree(allocList[allocIdx]);
+
+            memContextSwitch(memContextOld);
+            memContextFree(memContext);
+
+            TEST_LOG_FMT("%s: %" PRIu64 "ms", arena ? "arena" : "standard", testTimeMSec() - timeBegin);
+        }
+
+        free(allocList);
+    }
+
     memContextFree(memContextTop());
 
     FUNCTION_HARNESS_RESULT_VOID();
@@ -0,0 +1,22 @@
+/***********************************************************************************************************************************
+Test Thread Handler
+***********************************************************************************************************************************/
+
+/***********************************************************************************************************************************
+Test Run
+***********************************************************************************************************************************/
+void
+testRun(void)
+{
+    FUNCTION_HARNESS_VOID();
+
+    // *****************************************************************************************************************************
+    if (testBegin("threadError()"))
+    {
+        TEST_RESULT_VOID(threadError(0, "create thread"), "no thread error");
+        TEST_ERROR(
+            threadError(EAGAIN, "create thread"), KernelError, "unable to create thread: [11] Resource temporarily unavailable");
+    }
+
+    FUNCTION_HARNESS_RESULT_VOID();
+}
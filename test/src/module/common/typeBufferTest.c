@@ -11,7 +11,7 @@ testRun(void)
     FUNCTION_HARNESS_VOID();
 
     // *****************************************************************************************************************************
-    if (testBegin("bufNew(), bugNewC, bufNewStr(), bufNewZ(), bufMove(), bufSize(), bufPtr(), and bufFree()"))
+    if (testBegin("bufNew*(), bufUseC(), bufMove(), bufSize(), bufPtr(), and bufFree()"))
     {
         Buffer *buffer = NULL;
 
@@ -42,6 +42,22 @@ testRun(void)
 
         TEST_ASSIGN(buffer, bufNewC(sizeof(cBuffer), cBuffer), "create from c buffer");
         TEST_RESULT_BOOL(memcmp(bufPtr(buffer), cBuffer, sizeof(cBuffer)) == 0, true, "check buffer");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_ASSIGN(buffer, bufNewUseC(cBuffer, 2), "create buffer using c buffer");
+        TEST_RESULT_PTR(bufPtr(buffer), cBuffer, "    check pointer");
+        TEST_RESULT_SIZE(bufUsed(buffer), 2, "    check used");
+        TEST_RESULT_SIZE(bufSize(buffer), 2, "    check size");
+        TEST_ERROR(bufResize(buffer, 3), AssertError, "assertion '!this->external' failed");
+
+        bufLimitSet(buffer, 1);
+        TEST_RESULT_VOID(bufUseC(buffer, cBuffer + 1, 3), "use another part of the c buffer");
+        TEST_RESULT_BOOL(memcmp(bufPtr(buffer), "BCD", 3) == 0, true, "    check buffer");
+        TEST_RESULT_SIZE(bufSize(buffer), 3, "    check size (limit cleared)");
+        TEST_RESULT_VOID(bufUseC(buffer, NULL, 0), "use no memory");
+        TEST_RESULT_SIZE(bufUsed(buffer), 0, "    check used");
+        TEST_RESULT_VOID(bufFree(buffer), "free buffer");
+        TEST_RESULT_STR(cBuffer, "ABCD", "    check c buffer was not freed or changed");
     }
 
     // *****************************************************************************************************************************
@@ -70,7 +70,7 @@ testRun(void)
     }
 
     // *****************************************************************************************************************************
-    if (testBegin("kvToJson(), kvToJsonInternal()"))
+    if (testBegin("kvToJson(), kvToJsonInternal(), kvToJsonInfo()"))
     {
         KeyValue *keyValue = kvNew();
         String *json = NULL;
@@ -143,12 +143,24 @@ testRun(void)
             "\"backup-reference\":[\"20161219-212741F\",\"20161219-212741F_20161219-212803I\"],"
             "\"backup-timestamp-start\":1482182951,\"checksum-page-error\":[1]}",
             "  check string no pretty print");
+
+        // '/' is not escaped in info files
+        keyValue = kvNew();
+        kvPut(keyValue, varNewStrZ("path"), varNewStrZ("/pg/data"));
+        kvPut(keyValue, varNewStrZ("list"), varNewVarLst(varLstAdd(varLstNew(), varNewStrZ("../ts"))));
+
+        TEST_RESULT_STR(
+            strPtr(kvToJson(keyValue, 0)), "{\"list\":[\"..\\/ts\"],\"path\":\"\\/pg\\/data\"}", "kvToJson - / escaped");
+        TEST_RESULT_STR(
+            strPtr(kvToJsonInfo(keyValue)), "{\"list\":[\"../ts\"],\"path\":\"/pg/data\"}", "kvToJsonInfo - / not escaped");
     }
 
     // *****************************************************************************************************************************
-    if (testBegin("varToJson()"))
+    if (testBegin("varToJson(), varToJsonInfo()"))
     {
         TEST_ERROR(varToJson(varNewUInt64(100), 0), JsonFormatError, "variant type is invalid");
+        TEST_RESULT_STR(strPtr(varToJson(varNewStrZ("a \"quoted\" string"), 0)), "\"a \\\"quoted\\\" string\"", "String");
+        TEST_RESULT_STR(strPtr(varToJson(varNewBool(false), 0)), "false", "Boolean");
 
         String *json = NULL;
         Variant *keyValue = NULL;
@@ -284,6 +296,13 @@ testRun(void)
             "  }\n"
             "]\n",
             "  sorted json string result, pretty print");
+
+        // '/' is not escaped in info files
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_RESULT_STR(
+            strPtr(varToJson(varNewStrZ("../config/pg.conf"), 0)), "\"..\\/config\\/pg.conf\"", "varToJson - / escaped");
+        TEST_RESULT_STR(
+            strPtr(varToJsonInfo(varNewStrZ("../config/pg.conf"))), "\"../config/pg.conf\"", "varToJsonInfo - / not escaped");
     }
 
     FUNCTION_HARNESS_RESULT_VOID();
@@ -107,6 +107,80 @@ testRun(void)
 
         TEST_RESULT_VOID(kvFree(storeDup), "free dup store");
         TEST_RESULT_VOID(kvFree(store), "free store");
+
+        TEST_ASSIGN(storeDup, kvDup(kvNew()), "dup empty store");
+        TEST_RESULT_PTR(kvGet(storeDup, varNewInt(1)), NULL, "get from empty store");
+    }
+
+    // -----------------------------------------------------------------------------------------------------------------------------
+    if (testBegin("kvHash() and kvIndex*()"))
+    {
+        KeyValue *store = kvNew();
+
+        // Keys of each type
+        // -------------------------------------------------------------------------------------------------------------------------
+        kvPut(store, varNewBool(true), varNewInt(1));
+        kvPut(store, varNewDbl(-0.0), varNewInt(2));
+        kvPut(store, varNewDbl(1.5), varNewInt(3));
+        kvPut(store, varNewInt64(-1), varNewInt(4));
+        kvPut(store, varNewUInt64(1), varNewInt(5));
+        kvPut(store, varNewInt(1), varNewInt(6));
+
+        TEST_RESULT_INT(varInt(kvGet(store, varNewBool(true))), 1, "get bool key");
+        TEST_RESULT_PTR(kvGet(store, varNewBool(false)), NULL, "get missing bool key");
+        TEST_RESULT_INT(varInt(kvGet(store, varNewDbl(0.0))), 2, "get zero double key");
+        TEST_RESULT_INT(varInt(kvGet(store, varNewDbl(1.5))), 3, "get double key");
+        TEST_RESULT_INT(varInt(kvGet(store, varNewInt64(-1))), 4, "get int64 key");
+        TEST_RESULT_INT(varInt(kvGet(store, varNewUInt64(1))), 5, "get uint64 key");
+        TEST_RESULT_INT(varInt(kvGet(store, varNewInt(1))), 6, "get int key");
+
+        // Keys that cannot be compared
+        kvPut(store, varNewKv(), NULL);
+        TEST_ERROR(kvGet(store, varNewKv()), AssertError, "unable to test equality for KeyValue");
+        kvPut(store, varNewVarLst(varLstNew()), NULL);
+        TEST_ERROR(kvGet(store, varNewVarLst(varLstNew())), AssertError, "unable to test equality for VariantList");
+
+        kvFree(store);
+
+        // Index grows and keeps insertion order
+        // -------------------------------------------------------------------------------------------------------------------------
+        store = kvNew();
+
+        for (unsigned int keyIdx = 0; keyIdx < 1000; keyIdx++)
+            kvPut(store, varNewStr(strNewFmt("pg_data/base/%u", keyIdx)), varNewUInt64(keyIdx));
+
+        TEST_RESULT_UINT(store->indexSize, 2048, "index size");
+
+        unsigned int keyFound = 0;
+
+        for (unsigned int keyIdx = 0; keyIdx < 1000; keyIdx++)
+        {
+            if (varUInt64(kvGet(store, varNewStr(strNewFmt("pg_data/base/%u", keyIdx)))) == keyIdx &&
+                strEq(varStr(varLstGet(kvKeyList(store), keyIdx)), strNewFmt("pg_data/base/%u", keyIdx)))
+            {
+                keyFound++;
+            }
+        }
+
+        TEST_RESULT_UINT(keyFound, 1000, "all keys found in order");
+
+        TEST_RESULT_UINT(
+            varUInt64(kvGet(kvDup(store), varNewStr(strNew("pg_data/base/999")))), 999, "get key from duplicate");
+
+        kvFree(store);
+
+        // Keys with the same hash are compared
+        // -------------------------------------------------------------------------------------------------------------------------
+        store = kvNew();
+        kvPut(store, varNewStr(strNew("a")), varNewInt(1));
+
+        ((KeyValuePair *)lstGet(store->list, 0))->hash = kvHash(varNewStr(strNew("b")));
+        memset(store->index, 0, sizeof(unsigned int) * store->indexSize);
+        kvIndexAdd(store, 0);
+
+        TEST_RESULT_PTR(kvGet(store, varNewStr(strNew("b"))), NULL, "key with the same hash does not match");
+
+        kvFree(store);
     }
 
     FUNCTION_HARNESS_RESULT_VOID();
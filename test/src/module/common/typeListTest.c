@@ -29,7 +29,7 @@ testRun(void)
     FUNCTION_HARNESS_VOID();
 
     // *****************************************************************************************************************************
-    if (testBegin("lstNew(), lstMemContext(), lstToLog(), and lstFree()"))
+    if (testBegin("lstNew(), lstNewArena(), lstMemContext(), lstToLog(), and lstFree()"))
     {
         List *list = lstNew(sizeof(void *));
 
@@ -46,6 +46,16 @@ testRun(void)
         TEST_RESULT_VOID(lstFree(list), "free list");
         TEST_RESULT_VOID(lstFree(lstNew(1)), "free empty list");
         TEST_RESULT_VOID(lstFree(NULL), "free null list");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_ASSIGN(list, lstNewArena(sizeof(int)), "new arena list");
+        TEST_RESULT_INT(list->itemSize, sizeof(int), "item size");
+
+        for (int listIdx = 0; listIdx < LIST_INITIAL_SIZE * 4; listIdx++)
+            lstAdd(list, &listIdx);
+
+        TEST_RESULT_INT(*((int *)lstGet(list, LIST_INITIAL_SIZE * 4 - 1)), LIST_INITIAL_SIZE * 4 - 1, "check last item");
+        TEST_RESULT_VOID(lstFree(list), "free arena list");
     }
 
     // *****************************************************************************************************************************
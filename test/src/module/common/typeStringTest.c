@@ -244,7 +244,7 @@ testRun(void)
     }
 
     // *****************************************************************************************************************************
-    if (testBegin("strLstNew(), strLstAdd*(), strLstGet(), strLstMove(), strLstSize(), and strLstFree()"))
+    if (testBegin("strLstNew(), strLstNewArena(), strLstAdd*(), strLstGet(), strLstMove(), strLstSize(), and strLstFree()"))
     {
         // Add strings to the list
         // -------------------------------------------------------------------------------------------------------------------------
@@ -284,6 +284,13 @@ testRun(void)
 
         TEST_RESULT_VOID(strLstFree(list), "free string list");
         TEST_RESULT_VOID(strLstFree(NULL), "free null string list");
+
+        // Arena list
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_ASSIGN(list, strLstNewArena(), "new arena list");
+        TEST_RESULT_PTR(strLstAdd(list, strNew("STR01")), list, "add item");
+        TEST_RESULT_STR(strPtr(strLstGet(list, 0)), "STR01", "check item");
+        TEST_RESULT_VOID(strLstFree(list), "free arena string list");
     }
 
     // *****************************************************************************************************************************
@@ -85,6 +85,15 @@ testRun(void)
 
         TEST_RESULT_VOID(xmlDocumentFree(xmlDocument), "free xmldoc");
         TEST_RESULT_VOID(xmlDocumentFree(NULL), "free null xmldoc");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_RESULT_STR(strPtr(xmlFromText(strNew("path/file.txt"))), "path/file.txt", "text without special characters");
+        TEST_RESULT_STR(
+            strPtr(xmlFromText(strNew("a&b<c>d\"e'f"))), "a&amp;b&lt;c&gt;d&quot;e&apos;f", "text with special characters");
+
+        xmlDocument = xmlDocumentNewZ(strPtr(strNewFmt("<Key>%s</Key>", strPtr(xmlFromText(strNew("</Key><Key>x&y'\""))))));
+        TEST_RESULT_STR(
+            strPtr(xmlNodeContent(xmlDocumentRoot(xmlDocument))), "</Key><Key>x&y'\"", "escaped text parses as the original text");
     }
 
     FUNCTION_HARNESS_RESULT_VOID();
@@ -1,6 +1,8 @@
 /***********************************************************************************************************************************
 Test Gzip
 ***********************************************************************************************************************************/
+#include <errno.h>
+
 #include "common/io/filter/group.h"
 #include "common/io/bufferRead.h"
 #include "common/io/bufferWrite.h"
@@ -42,6 +44,41 @@ testCompress(GzipCompress *compress, Buffer *decompressed, size_t inputSize, siz
     return compressed;
 }
 
+/***********************************************************************************************************************************
+Compress data with multiple threads
+***********************************************************************************************************************************/
+static Buffer *
+testCompressParallel(GzipCompressParallel *compress, Buffer *decompressed, size_t inputSize, size_t outputSize)
+{
+    Buffer *compressed = bufNew(1024 * 1024);
+    size_t inputTotal = 0;
+    ioBufferSizeSet(outputSize);
+
+    IoFilterGroup *filterGroup = ioFilterGroupNew();
+    ioFilterGroupAdd(filterGroup, gzipCompressParallelFilter(compress));
+    IoWrite *write = ioBufferWriteIo(ioBufferWriteNew(compressed));
+    ioWriteFilterGroupSet(write, filterGroup);
+    ioWriteOpen(write);
+
+    // Compress input data
+    while (inputTotal < bufUsed(decompressed))
+    {
+        Buffer *input = bufNewC(
+            inputSize > bufUsed(decompressed) - inputTotal ? bufUsed(decompressed) - inputTotal : inputSize,
+            bufPtr(decompressed) + inputTotal);
+
+        ioWrite(write, input);
+
+        inputTotal += bufUsed(input);
+        bufFree(input);
+    }
+
+    ioWriteClose(write);
+    gzipCompressParallelFree(compress);
+
+    return compressed;
+}
+
 /***********************************************************************************************************************************
 Decompress data
 ***********************************************************************************************************************************/
@@ -161,6 +198,112 @@ testRun(void)
         TEST_RESULT_VOID(gzipDecompressFree(NULL), "free null decompress object");
     }
 
+    // *****************************************************************************************************************************
+    if (testBegin("GzipCompressParallel"))
+    {
+        const char *simpleData = "A simple string";
+        Buffer *decompressed = bufNewC(strlen(simpleData), simpleData);
+        Buffer *compressed = NULL;
+
+        TEST_ASSIGN(
+            compressed, testCompressParallel(gzipCompressParallelNew(3, false, 1, 1024), decompressed, 1024, 1024),
+            "simple data - compress one block");
+        TEST_RESULT_BOOL(
+            bufEq(decompressed, testDecompress(gzipDecompressNew(false), compressed, 1024, 1024)), true,
+            "    decompress");
+
+        TEST_ASSIGN(
+            compressed, testCompressParallel(gzipCompressParallelNew(3, false, 2, 4), decompressed, 1, 1),
+            "simple data - compress small blocks small in/small out buffer");
+        TEST_RESULT_BOOL(
+            bufEq(decompressed, testDecompress(gzipDecompressNew(false), compressed, 1, 1)), true, "    decompress");
+
+        TEST_ASSIGN(
+            compressed, testCompressParallel(gzipCompressParallelNew(3, true, 3, 2), decompressed, 1024, 3),
+            "simple data - compress raw small blocks large in/small out buffer");
+        TEST_RESULT_BOOL(
+            bufEq(decompressed, testDecompress(gzipDecompressNew(true), compressed, 1024, 1024)), true, "    decompress");
+
+        // Compress empty input
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_ASSIGN(
+            compressed, testCompressParallel(gzipCompressParallelNew(3, false, 2, 1024), bufNew(0), 1024, 1024),
+            "empty data - compress");
+        TEST_RESULT_UINT(
+            bufUsed(testDecompress(gzipDecompressNew(false), compressed, 1024, 1024)), 0, "    decompress");
+
+        // Compress data that spans many blocks.  The data repeats across block boundaries so it compresses as well as it would with
+        // a single stream because each block is primed with the end of the prior block.
+        // -------------------------------------------------------------------------------------------------------------------------
+        decompressed = bufNew(1024 * 1024);
+
+        for (unsigned int byteIdx = 0; byteIdx < bufSize(decompressed); byteIdx++)
+            bufPtr(decompressed)[byteIdx] = (unsigned char)((byteIdx * 7919 % 65521) % 251);
+
+        bufUsedSet(decompressed, bufSize(decompressed));
+
+        Buffer *compressedSerial = testCompress(gzipCompressNew(6, false), decompressed, 65536, 65536);
+
+        TEST_ASSIGN(
+            compressed, testCompressParallel(gzipCompressParallelNew(6, false, 4, 65536), decompressed, 65536, 65536),
+            "large data - compress large in/large out buffer");
+        TEST_RESULT_BOOL(
+            bufEq(decompressed, testDecompress(gzipDecompressNew(false), compressed, 65536, 65536)), true, "    decompress");
+        TEST_RESULT_BOOL(bufUsed(compressed) < bufUsed(compressedSerial) + 1024, true, "    compression similar to serial");
+
+        TEST_ASSIGN(
+            compressed, testCompressParallel(gzipCompressParallelNew(6, false, 4, 4096), decompressed, 100000, 1000),
+            "large data - compress large in/small out buffer");
+        TEST_RESULT_BOOL(
+            bufEq(decompressed, testDecompress(gzipDecompressNew(false), compressed, 65536, 65536)), true, "    decompress");
+
+        TEST_ASSIGN(
+            compressed, testCompressParallel(gzipCompressParallelNew(1, true, 2, 8192), decompressed, 1000, 100000),
+            "large data - compress raw small in/large out buffer");
+        TEST_RESULT_BOOL(
+            bufEq(decompressed, testDecompress(gzipDecompressNew(true), compressed, 65536, 65536)), true, "    decompress");
+
+        // Error when a block does not fit in the output buffer
+        // -------------------------------------------------------------------------------------------------------------------------
+        GzipCompressParallel *compress = gzipCompressParallelNew(3, false, 1, 1024);
+        compress->jobList[0].output = bufNew(1);
+
+        TEST_ERROR(
+            testCompressParallel(compress, decompressed, 1024, 1024), AssertError, "zlib threw error: [-5] no space in buffer");
+
+        TEST_RESULT_VOID(gzipCompressParallelFree(compress), "free compress object");
+        TEST_RESULT_VOID(gzipCompressParallelFree(NULL), "free null compress object");
+
+        // Free the parent context while jobs are in flight.  Job data must remain valid until the workers have stopped.
+        // -------------------------------------------------------------------------------------------------------------------------
+        MEM_CONTEXT_TEMP_BEGIN()
+        {
+            // Random data is slow to compress so the workers will still be busy
+            Buffer *random = bufNew(4 * 1024 * 1024);
+            Buffer *compressed = bufNew(1);
+
+            for (unsigned int byteIdx = 0; byteIdx < bufSize(random); byteIdx++)
+                bufPtr(random)[byteIdx] = (unsigned char)rand();
+
+            bufUsedSet(random, bufSize(random));
+
+            compress = gzipCompressParallelNew(9, false, 2, 1024 * 1024);
+
+            TEST_RESULT_VOID(gzipCompressParallelProcess(compress, random, compressed), "submit jobs");
+            TEST_RESULT_BOOL(compress->jobSubmitTotal > compress->jobOutputTotal, true, "    check jobs in flight");
+        }
+        MEM_CONTEXT_TEMP_END();
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        compress = gzipCompressParallelNew(3, false, 2, 1024);
+
+        TEST_RESULT_STR(
+            strPtr(gzipCompressParallelToLog(compress)),
+            "{inputSame: false, done: false, flushing: false, threadTotal: 2, blockSize: 1024}", "format object");
+
+        gzipCompressParallelFree(compress);
+    }
+
     // *****************************************************************************************************************************
     if (testBegin("gzipDecompressToLog() and gzipCompressToLog()"))
     {
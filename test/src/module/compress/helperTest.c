@@ -0,0 +1,99 @@
+/***********************************************************************************************************************************
+Test Compression Helper
+***********************************************************************************************************************************/
+#include "common/io/filter/group.h"
+#include "common/io/bufferRead.h"
+#include "common/io/bufferWrite.h"
+#include "common/io/io.h"
+#include "common/regExp.h"
+
+/***********************************************************************************************************************************
+Compress and then decompress data with the filters for a compression type
+***********************************************************************************************************************************/
+static Buffer *
+testRoundTrip(CompressType type, const Buffer *data)
+{
+    // Compress
+    Buffer *compressed = bufNew(0);
+
+    IoFilterGroup *filterGroup = ioFilterGroupNew();
+    ioFilterGroupAdd(filterGroup, compressFilter(type, compressLevelDefault(type)));
+    IoWrite *write = ioBufferWriteIo(ioBufferWriteNew(compressed));
+    ioWriteFilterGroupSet(write, filterGroup);
+    ioWriteOpen(write);
+    ioWrite(write, data);
+    ioWriteClose(write);
+
+    // Decompress
+    Buffer *decompressed = bufNew(0);
+
+    filterGroup = ioFilterGroupNew();
+    ioFilterGroupAdd(filterGroup, decompressFilter(type));
+    write = ioBufferWriteIo(ioBufferWriteNew(decompressed));
+    ioWriteFilterGroupSet(write, filterGroup);
+    ioWriteOpen(write);
+    ioWrite(write, compressed);
+    ioWriteClose(write);
+
+    return decompressed;
+}
+
+/***********************************************************************************************************************************
+Test Run
+***********************************************************************************************************************************/
+void
+testRun(void)
+{
+    FUNCTION_HARNESS_VOID();
+
+    // *****************************************************************************************************************************
+    if (testBegin("compressType(), compressTypeName(), compressTypeFromFile(), and compressTypePresent()"))
+    {
+        TEST_RESULT_UINT(compressType(strNew("none")), compressTypeNone, "none type");
+        TEST_RESULT_UINT(compressType(strNew("gz")), compressTypeGz, "gz type");
+        TEST_RESULT_UINT(compressType(strNew("lz4")), compressTypeLz4, "lz4 type");
+        TEST_RESULT_UINT(compressType(strNew("zst")), compressTypeZst, "zst type");
+        TEST_ERROR(compressType(strNew("bogus")), AssertError, "invalid compression type 'bogus'");
+
+        TEST_RESULT_STR(strPtr(compressTypeName(compressTypeNone)), "none", "none name");
+        TEST_RESULT_STR(strPtr(compressTypeName(compressTypeZst)), "zst", "zst name");
+
+        TEST_RESULT_UINT(compressTypeFromFile(strNew("file")), compressTypeNone, "no compression");
+        TEST_RESULT_UINT(compressTypeFromFile(strNew("file.gz")), compressTypeGz, "gz compression");
+        TEST_RESULT_UINT(compressTypeFromFile(strNew("file.lz4")), compressTypeLz4, "lz4 compression");
+        TEST_RESULT_UINT(compressTypeFromFile(strNew("file.zst")), compressTypeZst, "zst compression");
+        TEST_RESULT_UINT(compressTypeFromFile(strNew("file.zst.partial")), compressTypeNone, "extension must be last");
+
+        TEST_RESULT_STR(compressExtZ(compressTypeNone), "", "none extension");
+        TEST_RESULT_STR(compressExtZ(compressTypeLz4), ".lz4", "lz4 extension");
+
+        TEST_RESULT_VOID(compressTypePresent(compressTypeNone), "none is present");
+        TEST_RESULT_VOID(compressTypePresent(compressTypeGz), "gz is present");
+        TEST_RESULT_VOID(compressTypePresent(compressTypeLz4), "lz4 is present");
+        TEST_ERROR(compressTypePresent(compressTypeZst), OptionInvalidValueError, "pgBackRest not compiled with zst support");
+
+        // Make sure the regular expression matches all types
+        RegExp *regExp = regExpNew(strNew("^file" COMPRESS_EXT_REGEXP "$"));
+
+        TEST_RESULT_BOOL(regExpMatch(regExp, strNew("file")), true, "match no extension");
+        TEST_RESULT_BOOL(regExpMatch(regExp, strNew("file.gz")), true, "match gz extension");
+        TEST_RESULT_BOOL(regExpMatch(regExp, strNew("file.lz4")), true, "match lz4 extension");
+        TEST_RESULT_BOOL(regExpMatch(regExp, strNew("file.zst")), true, "match zst extension");
+        TEST_RESULT_BOOL(regExpMatch(regExp, strNew("file.bz2")), false, "no match for unknown extension");
+    }
+
+    // *****************************************************************************************************************************
+    if (testBegin("compressFilter() and decompressFilter()"))
+    {
+        Buffer *data = bufNewZ("A simple string that is compressed and then decompressed");
+
+        TEST_RESULT_BOOL(bufEq(testRoundTrip(compressTypeGz, data), data), true, "gz round trip");
+        TEST_RESULT_BOOL(bufEq(testRoundTrip(compressTypeLz4, data), data), true, "lz4 round trip");
+
+        TEST_RESULT_INT(compressLevelDefault(compressTypeZst), 3, "zst default level");
+        TEST_ERROR(compressFilter(compressTypeZst, 3), OptionInvalidValueError, "pgBackRest not compiled with zst support");
+        TEST_ERROR(decompressFilter(compressTypeZst), OptionInvalidValueError, "pgBackRest not compiled with zst support");
+    }
+
+    FUNCTION_HARNESS_RESULT_VOID();
+}
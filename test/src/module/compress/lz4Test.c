@@ -0,0 +1,209 @@
+/***********************************************************************************************************************************
+Test LZ4
+***********************************************************************************************************************************/
+#include "common/io/filter/group.h"
+#include "common/io/bufferRead.h"
+#include "common/io/bufferWrite.h"
+#include "common/io/io.h"
+
+/***********************************************************************************************************************************
+Compress data
+***********************************************************************************************************************************/
+static Buffer *
+testCompress(Lz4Compress *compress, Buffer *decompressed, size_t inputSize, size_t outputSize)
+{
+    Buffer *compressed = bufNew(1024 * 1024);
+    size_t inputTotal = 0;
+    ioBufferSizeSet(outputSize);
+
+    IoFilterGroup *filterGroup = ioFilterGroupNew();
+    ioFilterGroupAdd(filterGroup, lz4CompressFilter(compress));
+    IoWrite *write = ioBufferWriteIo(ioBufferWriteNew(compressed));
+    ioWriteFilterGroupSet(write, filterGroup);
+    ioWriteOpen(write);
+
+    // Compress input data
+    while (inputTotal < bufUsed(decompressed))
+    {
+        // Generate the input buffer based on input size.  This breaks the data up into chunks as it would be in a real scenario.
+        Buffer *input = bufNewC(
+            inputSize > bufUsed(decompressed) - inputTotal ? bufUsed(decompressed) - inputTotal : inputSize,
+            bufPtr(decompressed) + inputTotal);
+
+        ioWrite(write, input);
+
+        inputTotal += bufUsed(input);
+        bufFree(input);
+    }
+
+    ioWriteClose(write);
+    lz4CompressFree(compress);
+
+    return compressed;
+}
+
+/***********************************************************************************************************************************
+Decompress data
+***********************************************************************************************************************************/
+static Buffer *
+testDecompress(Lz4Decompress *decompress, Buffer *compressed, size_t inputSize, size_t outputSize)
+{
+    Buffer *decompressed = bufNew(1024 * 1024);
+    Buffer *output = bufNew(outputSize);
+    ioBufferSizeSet(inputSize);
+
+    IoFilterGroup *filterGroup = ioFilterGroupNew();
+    ioFilterGroupAdd(filterGroup, lz4DecompressFilter(decompress));
+    IoRead *read = ioBufferReadIo(ioBufferReadNew(compressed));
+    ioReadFilterGroupSet(read, filterGroup);
+    ioReadOpen(read);
+
+    while (!ioReadEof(read))
+    {
+        ioRead(read, output);
+        bufCat(decompressed, output);
+        bufUsedZero(output);
+    }
+
+    ioReadClose(read);
+    bufFree(output);
+    lz4DecompressFree(decompress);
+
+    return decompressed;
+}
+
+/***********************************************************************************************************************************
+Test Run
+***********************************************************************************************************************************/
+void
+testRun(void)
+{
+    FUNCTION_HARNESS_VOID();
+
+    // *****************************************************************************************************************************
+    if (testBegin("lz4Error()"))
+    {
+        TEST_RESULT_UINT(lz4Error(0), 0, "check success");
+        TEST_ERROR(lz4Error((size_t)-2), FormatError, "lz4 error: [-2] ERROR_maxBlockSize_invalid");
+    }
+
+    // *****************************************************************************************************************************
+    if (testBegin("Lz4Compress and Lz4Decompress"))
+    {
+        const char *simpleData = "A simple string";
+        Buffer *compressed = NULL;
+        Buffer *decompressed = bufNewC(strlen(simpleData), simpleData);
+
+        TEST_ASSIGN(
+            compressed, testCompress(lz4CompressNew(1), decompressed, 1024, 1024),
+            "simple data - compress large in/large out buffer");
+
+        TEST_RESULT_BOOL(
+            bufEq(compressed, testCompress(lz4CompressNew(1), decompressed, 1024, 1)), true,
+            "simple data - compress large in/small out buffer");
+
+        TEST_RESULT_BOOL(
+            bufEq(compressed, testCompress(lz4CompressNew(1), decompressed, 1, 1024)), true,
+            "simple data - compress small in/large out buffer");
+
+        TEST_RESULT_BOOL(
+            bufEq(compressed, testCompress(lz4CompressNew(1), decompressed, 1, 1)), true,
+            "simple data - compress small in/small out buffer");
+
+        TEST_RESULT_BOOL(
+            bufEq(decompressed, testDecompress(lz4DecompressNew(), compressed, 1024, 1024)), true,
+            "simple data - decompress large in/large out buffer");
+
+        TEST_RESULT_BOOL(
+            bufEq(decompressed, testDecompress(lz4DecompressNew(), compressed, 1024, 1)), true,
+            "simple data - decompress large in/small out buffer");
+
+        TEST_RESULT_BOOL(
+            bufEq(decompressed, testDecompress(lz4DecompressNew(), compressed, 1, 1024)), true,
+            "simple data - decompress small in/large out buffer");
+
+        TEST_RESULT_BOOL(
+            bufEq(decompressed, testDecompress(lz4DecompressNew(), compressed, 1, 1)), true,
+            "simple data - decompress small in/small out buffer");
+
+        // Compress empty input
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_ASSIGN(compressed, testCompress(lz4CompressNew(1), bufNew(0), 1024, 1024), "empty data - compress");
+        TEST_RESULT_UINT(bufUsed(testDecompress(lz4DecompressNew(), compressed, 1024, 1024)), 0, "    decompress");
+
+        // Compress a large zero input buffer into small output buffer
+        // -------------------------------------------------------------------------------------------------------------------------
+        decompressed = bufNew(1024 * 1024 - 1);
+        memset(bufPtr(decompressed), 0, bufSize(decompressed));
+        bufUsedSet(decompressed, bufSize(decompressed));
+
+        TEST_ASSIGN(
+            compressed, testCompress(lz4CompressNew(1), decompressed, bufSize(decompressed), 1024),
+            "zero data - compress large in/small out buffer");
+
+        TEST_RESULT_BOOL(
+            bufEq(decompressed, testDecompress(lz4DecompressNew(), compressed, bufSize(compressed), 1024 * 256)), true,
+            "zero data - decompress large in/small out buffer");
+
+        // Compress mixed data with a higher level
+        // -------------------------------------------------------------------------------------------------------------------------
+        for (unsigned int byteIdx = 0; byteIdx < bufSize(decompressed); byteIdx++)
+            bufPtr(decompressed)[byteIdx] = (unsigned char)((byteIdx * 7919 % 65521) % 251);
+
+        TEST_ASSIGN(
+            compressed, testCompress(lz4CompressNew(9), decompressed, 65536, 4096), "mixed data - compress high level");
+
+        TEST_RESULT_BOOL(
+            bufEq(decompressed, testDecompress(lz4DecompressNew(), compressed, 4096, 65536)), true,
+            "mixed data - decompress");
+
+        // Grow the internal buffer when input is larger than on prior calls
+        // -------------------------------------------------------------------------------------------------------------------------
+        Lz4Compress *compress = lz4CompressNew(1);
+        Buffer *input = bufNewZ(simpleData);
+        Buffer *output = bufNew(1);
+
+        TEST_RESULT_VOID(lz4CompressProcess(compress, input, output), "compress small input");
+        TEST_RESULT_BOOL(lz4CompressInputSame(compress), true, "    buffered output remains");
+
+        while (lz4CompressInputSame(compress))
+        {
+            bufUsedZero(output);
+            lz4CompressProcess(compress, input, output);
+        }
+
+        TEST_RESULT_VOID(lz4CompressProcess(compress, decompressed, output), "compress large input");
+        TEST_RESULT_BOOL(lz4CompressInputSame(compress), true, "    buffered output remains");
+
+        // Error on truncated and invalid data
+        // -------------------------------------------------------------------------------------------------------------------------
+        compressed = testCompress(lz4CompressNew(1), bufNewZ(simpleData), 1024, 1024);
+        bufUsedSet(compressed, bufUsed(compressed) - 1);
+
+        TEST_ERROR(
+            testDecompress(lz4DecompressNew(), compressed, 1024, 1024), FormatError, "unexpected eof in compressed data");
+        TEST_ERROR(
+            testDecompress(lz4DecompressNew(), bufNewZ(simpleData), 1024, 1024), FormatError,
+            "lz4 error: [-13] ERROR_frameType_unknown");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_RESULT_VOID(lz4CompressFree(NULL), "free null compress object");
+        TEST_RESULT_VOID(lz4DecompressFree(NULL), "free null decompress object");
+    }
+
+    // *****************************************************************************************************************************
+    if (testBegin("lz4CompressToLog() and lz4DecompressToLog()"))
+    {
+        Lz4Compress *compress = lz4CompressNew(7);
+
+        TEST_RESULT_STR(
+            strPtr(lz4CompressToLog(compress)), "{level: 7, first: true, inputSame: false, flushing: false}", "format compress");
+
+        Lz4Decompress *decompress = lz4DecompressNew();
+
+        TEST_RESULT_STR(
+            strPtr(lz4DecompressToLog(decompress)), "{inputSame: false, inputOffset: 0, done: false}", "format decompress");
+    }
+
+    FUNCTION_HARNESS_RESULT_VOID();
+}
@@ -0,0 +1,191 @@
+/***********************************************************************************************************************************
+Test Zstandard
+***********************************************************************************************************************************/
+#include "common/io/filter/group.h"
+#include "common/io/bufferRead.h"
+#include "common/io/bufferWrite.h"
+#include "common/io/io.h"
+
+/***********************************************************************************************************************************
+Compress data
+***********************************************************************************************************************************/
+static Buffer *
+testCompress(ZstCompress *compress, Buffer *decompressed, size_t inputSize, size_t outputSize)
+{
+    Buffer *compressed = bufNew(1024 * 1024);
+    size_t inputTotal = 0;
+    ioBufferSizeSet(outputSize);
+
+    IoFilterGroup *filterGroup = ioFilterGroupNew();
+    ioFilterGroupAdd(filterGroup, zstCompressFilter(compress));
+    IoWrite *write = ioBufferWriteIo(ioBufferWriteNew(compressed));
+    ioWriteFilterGroupSet(write, filterGroup);
+    ioWriteOpen(write);
+
+    // Compress input data
+    while (inputTotal < bufUsed(decompressed))
+    {
+        // Generate the input buffer based on input size.  This breaks the data up into chunks as it would be in a real scenario.
+        Buffer *input = bufNewC(
+            inputSize > bufUsed(decompressed) - inputTotal ? bufUsed(decompressed) - inputTotal : inputSize,
+            bufPtr(decompressed) + inputTotal);
+
+        ioWrite(write, input);
+
+        inputTotal += bufUsed(input);
+        bufFree(input);
+    }
+
+    ioWriteClose(write);
+    zstCompressFree(compress);
+
+    return compressed;
+}
+
+/***********************************************************************************************************************************
+Decompress data
+***********************************************************************************************************************************/
+static Buffer *
+testDecompress(ZstDecompress *decompress, Buffer *compressed, size_t inputSize, size_t outputSize)
+{
+    Buffer *decompressed = bufNew(1024 * 1024);
+    Buffer *output = bufNew(outputSize);
+    ioBufferSizeSet(inputSize);
+
+    IoFilterGroup *filterGroup = ioFilterGroupNew();
+    ioFilterGroupAdd(filterGroup, zstDecompressFilter(decompress));
+    IoRead *read = ioBufferReadIo(ioBufferReadNew(compressed));
+    ioReadFilterGroupSet(read, filterGroup);
+    ioReadOpen(read);
+
+    while (!ioReadEof(read))
+    {
+        ioRead(read, output);
+        bufCat(decompressed, output);
+        bufUsedZero(output);
+    }
+
+    ioReadClose(read);
+    bufFree(output);
+    zstDecompressFree(decompress);
+
+    return decompressed;
+}
+
+/***********************************************************************************************************************************
+Test Run
+***********************************************************************************************************************************/
+void
+testRun(void)
+{
+    FUNCTION_HARNESS_VOID();
+
+    // *****************************************************************************************************************************
+    if (testBegin("zstError()"))
+    {
+        TEST_RESULT_UINT(zstError(0), 0, "check success");
+        TEST_ERROR(zstError((size_t)-1), FormatError, "zst error: [-1] Error (generic)");
+    }
+
+    // *****************************************************************************************************************************
+    if (testBegin("ZstCompress and ZstDecompress"))
+    {
+        const char *simpleData = "A simple string";
+        Buffer *compressed = NULL;
+        Buffer *decompressed = bufNewC(strlen(simpleData), simpleData);
+
+        TEST_ASSIGN(
+            compressed, testCompress(zstCompressNew(1), decompressed, 1024, 1024),
+            "simple data - compress large in/large out buffer");
+
+        TEST_RESULT_BOOL(
+            bufEq(compressed, testCompress(zstCompressNew(1), decompressed, 1024, 1)), true,
+            "simple data - compress large in/small out buffer");
+
+        TEST_RESULT_BOOL(
+            bufEq(compressed, testCompress(zstCompressNew(1), decompressed, 1, 1024)), true,
+            "simple data - compress small in/large out buffer");
+
+        TEST_RESULT_BOOL(
+            bufEq(compressed, testCompress(zstCompressNew(1), decompressed, 1, 1)), true,
+            "simple data - compress small in/small out buffer");
+
+        TEST_RESULT_BOOL(
+            bufEq(decompressed, testDecompress(zstDecompressNew(), compressed, 1024, 1024)), true,
+            "simple data - decompress large in/large out buffer");
+
+        TEST_RESULT_BOOL(
+            bufEq(decompressed, testDecompress(zstDecompressNew(), compressed, 1024, 1)), true,
+            "simple data - decompress large in/small out buffer");
+
+        TEST_RESULT_BOOL(
+            bufEq(decompressed, testDecompress(zstDecompressNew(), compressed, 1, 1024)), true,
+            "simple data - decompress small in/large out buffer");
+
+        TEST_RESULT_BOOL(
+            bufEq(decompressed, testDecompress(zstDecompressNew(), compressed, 1, 1)), true,
+            "simple data - decompress small in/small out buffer");
+
+        // Compress empty input
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_ASSIGN(compressed, testCompress(zstCompressNew(1), bufNew(0), 1024, 1024), "empty data - compress");
+        TEST_RESULT_UINT(bufUsed(testDecompress(zstDecompressNew(), compressed, 1024, 1024)), 0, "    decompress");
+
+        // Compress a large zero input buffer into small output buffer
+        // -------------------------------------------------------------------------------------------------------------------------
+        decompressed = bufNew(1024 * 1024 - 1);
+        memset(bufPtr(decompressed), 0, bufSize(decompressed));
+        bufUsedSet(decompressed, bufSize(decompressed));
+
+        TEST_ASSIGN(
+            compressed, testCompress(zstCompressNew(1), decompressed, bufSize(decompressed), 1024),
+            "zero data - compress large in/small out buffer");
+
+        TEST_RESULT_BOOL(
+            bufEq(decompressed, testDecompress(zstDecompressNew(), compressed, bufSize(compressed), 1024 * 256)), true,
+            "zero data - decompress large in/small out buffer");
+
+        // Compress mixed data with a higher level
+        // -------------------------------------------------------------------------------------------------------------------------
+        for (unsigned int byteIdx = 0; byteIdx < bufSize(decompressed); byteIdx++)
+            bufPtr(decompressed)[byteIdx] = (unsigned char)((byteIdx * 7919 % 65521) % 251);
+
+        TEST_ASSIGN(
+            compressed, testCompress(zstCompressNew(9), decompressed, 65536, 4096), "mixed data - compress high level");
+
+        TEST_RESULT_BOOL(
+            bufEq(decompressed, testDecompress(zstDecompressNew(), compressed, 4096, 65536)), true,
+            "mixed data - decompress");
+
+        // Error on truncated and invalid data
+        // -------------------------------------------------------------------------------------------------------------------------
+        compressed = testCompress(zstCompressNew(1), bufNewZ(simpleData), 1024, 1024);
+        bufUsedSet(compressed, bufUsed(compressed) - 1);
+
+        TEST_ERROR(
+            testDecompress(zstDecompressNew(), compressed, 1024, 1024), FormatError, "unexpected eof in compressed data");
+        TEST_ERROR(
+            testDecompress(zstDecompressNew(), bufNewZ(simpleData), 1024, 1024), FormatError,
+            "zst error: [-10] Unknown frame descriptor");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_RESULT_VOID(zstCompressFree(NULL), "free null compress object");
+        TEST_RESULT_VOID(zstDecompressFree(NULL), "free null decompress object");
+    }
+
+    // *****************************************************************************************************************************
+    if (testBegin("zstCompressToLog() and zstDecompressToLog()"))
+    {
+        ZstCompress *compress = zstCompressNew(7);
+
+        TEST_RESULT_STR(
+            strPtr(zstCompressToLog(compress)), "{level: 7, inputSame: false, inputOffset: 0, flushing: false}", "format compress");
+
+        ZstDecompress *decompress = zstDecompressNew();
+
+        TEST_RESULT_STR(
+            strPtr(zstDecompressToLog(decompress)), "{inputSame: false, inputOffset: 0, done: false}", "format decompress");
+    }
+
+    FUNCTION_HARNESS_RESULT_VOID();
+}
@@ -0,0 +1,366 @@
+/***********************************************************************************************************************************
+Test Chunked AES-256-GCM Cipher
+***********************************************************************************************************************************/
+#include <errno.h>
+
+#include "common/io/filter/group.h"
+#include "common/io/bufferWrite.h"
+#include "common/io/io.h"
+
+/***********************************************************************************************************************************
+Data for testing
+***********************************************************************************************************************************/
+#define TEST_PASS                                                   "areallybadpassphrase"
+
+/***********************************************************************************************************************************
+Encrypt/decrypt data
+***********************************************************************************************************************************/
+static Buffer *
+testCipher(CipherGcm *cipher, const Buffer *source, size_t inputSize, size_t outputSize)
+{
+    Buffer *destination = bufNew(0);
+    size_t inputTotal = 0;
+    ioBufferSizeSet(outputSize);
+
+    IoFilterGroup *filterGroup = ioFilterGroupNew();
+    ioFilterGroupAdd(filterGroup, cipherGcmFilter(cipher));
+    IoWrite *write = ioBufferWriteIo(ioBufferWriteNew(destination));
+    ioWriteFilterGroupSet(write, filterGroup);
+    ioWriteOpen(write);
+
+    // Break the source up into chunks as it would be in a real scenario
+    while (inputTotal < bufUsed(source))
+    {
+        Buffer *input = bufNewC(
+            inputSize > bufUsed(source) - inputTotal ? bufUsed(source) - inputTotal : inputSize, bufPtr(source) + inputTotal);
+
+        ioWrite(write, input);
+
+        inputTotal += bufUsed(input);
+        bufFree(input);
+    }
+
+    ioWriteClose(write);
+    cipherGcmFree(cipher);
+
+    return destination;
+}
+
+/***********************************************************************************************************************************
+Generate data that does not repeat within a chunk
+***********************************************************************************************************************************/
+static Buffer *
+testData(size_t size)
+{
+    Buffer *result = bufNew(size);
+
+    for (size_t dataIdx = 0; dataIdx < size; dataIdx++)
+        bufPtr(result)[dataIdx] = (unsigned char)(dataIdx * 7 + dataIdx / 251);
+
+    bufUsedSet(result, size);
+
+    return result;
+}
+
+/***********************************************************************************************************************************
+Test Run
+***********************************************************************************************************************************/
+void
+testRun(void)
+{
+    FUNCTION_HARNESS_VOID();
+
+    const Buffer *testPass = bufNewStr(strNew(TEST_PASS));
+
+    // *****************************************************************************************************************************
+    if (testBegin("cipherGcmNew() and cipherGcmFree()"))
+    {
+        CipherGcm *cipher = cipherGcmNew(cipherModeEncrypt, testPass, 2, 1024);
+        TEST_RESULT_STR(memContextName(cipher->memContext), "CipherGcm", "mem context name is valid");
+        TEST_RESULT_PTR(cipher->pass, NULL, "passphrase is freed after key derivation");
+        TEST_RESULT_BOOL(cipher->headerDone, true, "header is generated");
+        TEST_RESULT_SIZE(bufUsed(cipher->header), CIPHER_GCM_HEADER_SIZE, "header size is valid");
+        TEST_RESULT_BOOL(memcmp(bufPtr(cipher->header), CIPHER_GCM_MAGIC, CIPHER_GCM_MAGIC_SIZE) == 0, true, "header magic");
+        TEST_RESULT_UINT(cipher->jobTotal, 4, "job total");
+        TEST_RESULT_UINT(cipher->workerStarted, 0, "workers are not started");
+
+        TEST_RESULT_STR(
+            strPtr(cipherGcmToLog(cipher)),
+            "{inputSame: false, done: false, flushing: false, threadTotal: 2, threadStarted: 0, chunkSize: 1024}", "format object");
+
+        TEST_RESULT_VOID(cipherGcmFree(cipher), "free cipher");
+        TEST_RESULT_VOID(cipherGcmFree(NULL), "free null cipher");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        cipher = cipherGcmNew(cipherModeDecrypt, testPass, 0, 0);
+        TEST_RESULT_BOOL(cipher->headerDone, false, "header is read from input on decrypt");
+        TEST_RESULT_PTR_NE(cipher->pass, NULL, "passphrase is kept until the header is read");
+
+        TEST_RESULT_VOID(cipherGcmFree(cipher), "free cipher");
+
+        // Master keys are cached by passphrase and salt and file keys are derived from the master key and the file salt
+        // -------------------------------------------------------------------------------------------------------------------------
+        cipherGcmKeyCacheClear();
+
+        cipher = cipherGcmNew(cipherModeEncrypt, testPass, 0, 1024);
+        TEST_RESULT_BOOL(cipherGcmKeyCache.entry[0].valid, true, "master key is cached");
+        TEST_RESULT_UINT(cipherGcmKeyCache.replaceIdx, 1, "    replace index");
+        TEST_RESULT_BOOL(
+            memcmp(cipherGcmKeyCache.entry[0].salt, bufPtr(cipher->header) + CIPHER_GCM_HEADER_KEY_SALT_OFFSET,
+            CIPHER_GCM_SALT_SIZE) == 0, true, "    master key salt is in header");
+
+        unsigned char key[CIPHER_GCM_KEY_SIZE];
+        unsigned char keyMaster[CIPHER_GCM_KEY_SIZE];
+
+        PKCS5_PBKDF2_HMAC(
+            TEST_PASS, (int)strlen(TEST_PASS), bufPtr(cipher->header) + CIPHER_GCM_HEADER_KEY_SALT_OFFSET, CIPHER_GCM_SALT_SIZE,
+            CIPHER_GCM_KEY_ITERATION, EVP_sha256(), CIPHER_GCM_KEY_SIZE, keyMaster);
+        TEST_RESULT_BOOL(memcmp(cipherGcmKeyCache.entry[0].key, keyMaster, sizeof(keyMaster)) == 0, true, "    master key");
+
+        HMAC(
+            EVP_sha256(), keyMaster, CIPHER_GCM_KEY_SIZE, bufPtr(cipher->header) + CIPHER_GCM_HEADER_SALT_OFFSET,
+            CIPHER_GCM_SALT_SIZE, key, NULL);
+        TEST_RESULT_BOOL(memcmp(cipher->key, key, sizeof(key)) == 0, true, "    file key");
+
+        CipherGcm *cipher2 = cipherGcmNew(cipherModeEncrypt, testPass, 0, 1024);
+        TEST_RESULT_UINT(cipherGcmKeyCache.replaceIdx, 1, "master key is reused");
+        TEST_RESULT_BOOL(
+            memcmp(
+                bufPtr(cipher->header) + CIPHER_GCM_HEADER_KEY_SALT_OFFSET,
+                bufPtr(cipher2->header) + CIPHER_GCM_HEADER_KEY_SALT_OFFSET, CIPHER_GCM_SALT_SIZE) == 0,
+            true, "    master key salt is reused");
+        TEST_RESULT_BOOL(memcmp(cipher->key, cipher2->key, sizeof(key)) != 0, true, "    file keys differ");
+
+        cipherGcmFree(cipher);
+        cipherGcmFree(cipher2);
+
+        // A header written with another master key salt derives a new master key on decrypt
+        unsigned char header[CIPHER_GCM_HEADER_SIZE];
+        memcpy(header, bufPtr(cipher->header), sizeof(header));
+        header[CIPHER_GCM_HEADER_KEY_SALT_OFFSET] ^= 0xFF;
+
+        cipher = cipherGcmNew(cipherModeDecrypt, testPass, 0, 0);
+        cipherGcmInit(cipher, 1024, header);
+        TEST_RESULT_UINT(cipherGcmKeyCache.replaceIdx, 2, "master key is derived for new salt");
+        TEST_RESULT_BOOL(memcmp(cipherGcmKeyCache.entry[1].key, keyMaster, sizeof(keyMaster)) != 0, true, "    master keys differ");
+        cipherGcmFree(cipher);
+
+        // The oldest master key is cleansed and replaced when the cache is full
+        for (unsigned int passIdx = 0; passIdx < CIPHER_GCM_KEY_CACHE_TOTAL - 1; passIdx++)
+            cipherGcmFree(cipherGcmNew(cipherModeEncrypt, bufNewStr(strNewFmt("pass%u", passIdx)), 0, 1024));
+
+        TEST_RESULT_UINT(cipherGcmKeyCache.replaceIdx, 1, "cache is full");
+        TEST_RESULT_BOOL(
+            memcmp(cipherGcmKeyCache.entry[0].key, keyMaster, sizeof(keyMaster)) != 0, true, "    oldest master key is replaced");
+
+        // Clearing the cache cleanses all keys
+        TEST_RESULT_VOID(cipherGcmKeyCacheClear(), "clear cache");
+
+        unsigned char keyZero[CIPHER_GCM_KEY_SIZE] = {0};
+
+        for (unsigned int entryIdx = 0; entryIdx < CIPHER_GCM_KEY_CACHE_TOTAL; entryIdx++)
+        {
+            if (cipherGcmKeyCache.entry[entryIdx].valid ||
+                memcmp(cipherGcmKeyCache.entry[entryIdx].key, keyZero, sizeof(keyZero)) != 0)
+            {
+                THROW_FMT(AssertError, "cache entry %u not cleansed", entryIdx);
+            }
+        }
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_RESULT_VOID(threadError(0, "create thread"), "no thread error");
+        TEST_ERROR(
+            threadError(EAGAIN, "create thread"), KernelError, "unable to create thread: [11] Resource temporarily unavailable");
+    }
+
+    // *****************************************************************************************************************************
+    if (testBegin("Encrypt and Decrypt"))
+    {
+        Buffer *plaintext = testData(100000);
+
+        // Single thread, small input/output buffers
+        // -------------------------------------------------------------------------------------------------------------------------
+        Buffer *encrypted = NULL;
+
+        TEST_ASSIGN(encrypted, testCipher(cipherGcmNew(cipherModeEncrypt, testPass, 0, 1000), plaintext, 333, 7), "encrypt");
+        TEST_RESULT_SIZE(
+            bufUsed(encrypted), CIPHER_GCM_HEADER_SIZE + bufUsed(plaintext) + (100 + 1) * CIPHER_GCM_TAG_SIZE,
+            "    check size (empty last chunk)");
+        TEST_RESULT_BOOL(
+            bufEq(plaintext, testCipher(cipherGcmNew(cipherModeDecrypt, testPass, 0, 0), encrypted, 5, 11)), true,
+            "    decrypt");
+        TEST_RESULT_BOOL(
+            bufEq(plaintext, testCipher(cipherGcmNew(cipherModeDecrypt, testPass, 3, 0), encrypted, 65536, 65536)), true,
+            "    decrypt with threads");
+
+        // Threads, various buffer sizes
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_ASSIGN(encrypted, testCipher(cipherGcmNew(cipherModeEncrypt, testPass, 4, 4096), plaintext, 65536, 65536), "encrypt");
+        TEST_RESULT_SIZE(
+            bufUsed(encrypted), CIPHER_GCM_HEADER_SIZE + bufUsed(plaintext) + (24 + 1) * CIPHER_GCM_TAG_SIZE, "    check size");
+        TEST_RESULT_BOOL(
+            bufEq(plaintext, testCipher(cipherGcmNew(cipherModeDecrypt, testPass, 2, 0), encrypted, 17, 100000)), true,
+            "    decrypt");
+        TEST_RESULT_BOOL(
+            bufEq(plaintext, testCipher(cipherGcmNew(cipherModeDecrypt, testPass, 0, 0), encrypted, 100000, 3)), true,
+            "    decrypt single thread");
+
+        TEST_ASSIGN(encrypted, testCipher(cipherGcmNew(cipherModeEncrypt, testPass, 3, 2048), plaintext, 19, 5), "encrypt");
+        TEST_RESULT_BOOL(
+            bufEq(plaintext, testCipher(cipherGcmNew(cipherModeDecrypt, testPass, 4, 0), encrypted, 1000, 1000)), true,
+            "    decrypt");
+
+        // Encrypting the same data twice produces different output since the salt is random
+        TEST_RESULT_BOOL(
+            bufEq(encrypted, testCipher(cipherGcmNew(cipherModeEncrypt, testPass, 3, 2048), plaintext, 19, 5)), false,
+            "encrypt again is different");
+
+        // Empty data
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_ASSIGN(encrypted, testCipher(cipherGcmNew(cipherModeEncrypt, testPass, 2, 1024), bufNew(0), 1024, 1024), "encrypt");
+        TEST_RESULT_SIZE(bufUsed(encrypted), CIPHER_GCM_HEADER_SIZE + CIPHER_GCM_TAG_SIZE, "    check size");
+        TEST_RESULT_SIZE(
+            bufUsed(testCipher(cipherGcmNew(cipherModeDecrypt, testPass, 2, 0), encrypted, 1024, 1024)), 0, "    decrypt");
+
+        // Errors
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_ASSIGN(encrypted, testCipher(cipherGcmNew(cipherModeEncrypt, testPass, 2, 1000), plaintext, 65536, 65536), "encrypt");
+
+        TEST_ERROR(
+            testCipher(cipherGcmNew(cipherModeDecrypt, bufNewStr(strNew("bogus")), 2, 0), encrypted, 65536, 65536), CryptoError,
+            "unable to process cipher chunk 0");
+
+        Buffer *tampered = bufNewC(bufUsed(encrypted), bufPtr(encrypted));
+        bufPtr(tampered)[CIPHER_GCM_HEADER_SIZE + 5 * (1000 + CIPHER_GCM_TAG_SIZE) + 100] ^= 1;
+
+        TEST_ERROR(
+            testCipher(cipherGcmNew(cipherModeDecrypt, testPass, 2, 0), tampered, 65536, 65536), CryptoError,
+            "unable to process cipher chunk 5");
+
+        // Swap the first two chunks
+        tampered = bufNewC(bufUsed(encrypted), bufPtr(encrypted));
+        memcpy(bufPtr(tampered) + CIPHER_GCM_HEADER_SIZE, bufPtr(encrypted) + CIPHER_GCM_HEADER_SIZE + 1000 + CIPHER_GCM_TAG_SIZE,
+            1000 + CIPHER_GCM_TAG_SIZE);
+        memcpy(bufPtr(tampered) + CIPHER_GCM_HEADER_SIZE + 1000 + CIPHER_GCM_TAG_SIZE, bufPtr(encrypted) + CIPHER_GCM_HEADER_SIZE,
+            1000 + CIPHER_GCM_TAG_SIZE);
+
+        TEST_ERROR(
+            testCipher(cipherGcmNew(cipherModeDecrypt, testPass, 0, 0), tampered, 65536, 65536), CryptoError,
+            "unable to process cipher chunk 0");
+
+        // Truncated on a chunk boundary
+        TEST_ERROR(
+            testCipher(
+                cipherGcmNew(cipherModeDecrypt, testPass, 2, 0),
+                bufNewC(CIPHER_GCM_HEADER_SIZE + 10 * (1000 + CIPHER_GCM_TAG_SIZE), bufPtr(encrypted)), 65536, 65536),
+            CryptoError, "cipher data truncated");
+
+        // Truncated within a chunk
+        TEST_ERROR(
+            testCipher(
+                cipherGcmNew(cipherModeDecrypt, testPass, 2, 0),
+                bufNewC(CIPHER_GCM_HEADER_SIZE + 10 * (1000 + CIPHER_GCM_TAG_SIZE) + 500, bufPtr(encrypted)), 65536, 65536),
+            CryptoError, "unable to process cipher chunk 10");
+
+        TEST_ERROR(
+            testCipher(cipherGcmNew(cipherModeDecrypt, testPass, 2, 0), bufNewC(10, bufPtr(encrypted)), 65536, 65536),
+            CryptoError, "cipher header missing");
+        TEST_ERROR(
+            testCipher(cipherGcmNew(cipherModeDecrypt, testPass, 2, 0), plaintext, 65536, 65536), CryptoError,
+            "cipher header invalid");
+
+        Buffer *header = bufNewC(CIPHER_GCM_HEADER_SIZE, bufPtr(encrypted));
+        memset(bufPtr(header) + CIPHER_GCM_MAGIC_SIZE, 0, 4);
+
+        TEST_ERROR(
+            testCipher(cipherGcmNew(cipherModeDecrypt, testPass, 2, 0), header, 65536, 65536), CryptoError,
+            "cipher chunk size 0 is invalid");
+
+        memset(bufPtr(header) + CIPHER_GCM_MAGIC_SIZE, 0xFF, 4);
+
+        TEST_ERROR(
+            testCipher(cipherGcmNew(cipherModeDecrypt, testPass, 2, 0), header, 65536, 65536), CryptoError,
+            "cipher chunk size 4294967295 is invalid");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        CipherGcm *cipher = cipherGcmNew(cipherModeEncrypt, testPass, 2, 1000);
+        Buffer *output = bufNew(65536);
+
+        ioFilterProcessInOut(cipherGcmFilter(cipher), plaintext, output);
+        TEST_RESULT_UINT(cipher->workerStarted, 2, "workers started");
+        TEST_RESULT_VOID(cipherGcmFree(cipher), "free cipher with jobs in progress");
+
+        // Free the parent context while jobs are in flight.  Job data must remain valid until the workers have stopped.
+        // -------------------------------------------------------------------------------------------------------------------------
+        MEM_CONTEXT_TEMP_BEGIN()
+        {
+            Buffer *large = testData(16 * 1024 * 1024);
+            cipher = cipherGcmNew(cipherModeEncrypt, testPass, 2, 4 * 1024 * 1024);
+
+            ioFilterProcessInOut(cipherGcmFilter(cipher), large, bufNew(1));
+            TEST_RESULT_BOOL(cipher->jobSubmitTotal > cipher->jobOutputTotal, true, "jobs in flight");
+        }
+        MEM_CONTEXT_TEMP_END();
+    }
+
+    // *****************************************************************************************************************************
+    if (testBegin("cipherGcmRangeOffset(), cipherGcmRangeSize(), and cipherGcmDecryptRange()"))
+    {
+        Buffer *plaintext = testData(10500);
+        Buffer *encrypted = testCipher(cipherGcmNew(cipherModeEncrypt, testPass, 2, 1000), plaintext, 65536, 65536);
+        Buffer *header = bufNewC(CIPHER_GCM_HEADER_SIZE, bufPtr(encrypted));
+
+        // Range within one chunk
+        // -------------------------------------------------------------------------------------------------------------------------
+        uint64_t offset = 0;
+        uint64_t size = 0;
+
+        TEST_ASSIGN(offset, cipherGcmRangeOffset(header, 2100), "range offset");
+        TEST_RESULT_UINT(offset, CIPHER_GCM_HEADER_SIZE + 2 * (1000 + CIPHER_GCM_TAG_SIZE), "    check offset");
+        TEST_ASSIGN(size, cipherGcmRangeSize(header, 2100, 100), "range size");
+        TEST_RESULT_UINT(size, 1000 + CIPHER_GCM_TAG_SIZE, "    check size");
+
+        Buffer *range = bufNewC((size_t)size, bufPtr(encrypted) + offset);
+        TEST_RESULT_BOOL(
+            bufEq(cipherGcmDecryptRange(testPass, header, range, 2100, 100), bufNewC(100, bufPtr(plaintext) + 2100)), true,
+            "    decrypt range");
+
+        // Range across chunks
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_ASSIGN(offset, cipherGcmRangeOffset(header, 999), "range offset");
+        TEST_ASSIGN(size, cipherGcmRangeSize(header, 999, 2002), "range size");
+        TEST_RESULT_UINT(size, 4 * (1000 + CIPHER_GCM_TAG_SIZE), "    check size");
+
+        range = bufNewC((size_t)size, bufPtr(encrypted) + offset);
+        TEST_RESULT_BOOL(
+            bufEq(cipherGcmDecryptRange(testPass, header, range, 999, 2002), bufNewC(2002, bufPtr(plaintext) + 999)), true,
+            "    decrypt range");
+
+        // Range past the end
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_ASSIGN(offset, cipherGcmRangeOffset(header, 9900), "range offset");
+        range = bufNewC(bufUsed(encrypted) - (size_t)offset, bufPtr(encrypted) + offset);
+
+        TEST_RESULT_BOOL(
+            bufEq(cipherGcmDecryptRange(testPass, header, range, 9900, 5000), bufNewC(600, bufPtr(plaintext) + 9900)), true,
+            "    decrypt range");
+
+        TEST_ASSIGN(offset, cipherGcmRangeOffset(header, 10500), "range offset at the end");
+        range = bufNewC(bufUsed(encrypted) - (size_t)offset, bufPtr(encrypted) + offset);
+
+        TEST_RESULT_SIZE(bufUsed(cipherGcmDecryptRange(testPass, header, range, 10500, 100)), 0, "    decrypt range");
+
+        // Errors
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_ERROR(
+            cipherGcmDecryptRange(
+                testPass, header, bufNewC(1000 + CIPHER_GCM_TAG_SIZE, bufPtr(encrypted) + CIPHER_GCM_HEADER_SIZE), 0, 2000),
+            CryptoError, "cipher data truncated");
+        TEST_ERROR(
+            cipherGcmDecryptRange(
+                testPass, header, bufNewC(1000 + CIPHER_GCM_TAG_SIZE, bufPtr(encrypted) + CIPHER_GCM_HEADER_SIZE), 1000, 100),
+            CryptoError, "unable to process cipher chunk 1");
+    }
+
+    FUNCTION_HARNESS_RESULT_VOID();
+}
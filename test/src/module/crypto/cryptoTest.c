@@ -41,10 +41,12 @@ testRun(void)
         TEST_ERROR(cipherType(strNew(BOGUS_STR)), AssertError, "invalid cipher name 'BOGUS'");
         TEST_RESULT_UINT(cipherType(strNew("none")), cipherTypeNone, "none type");
         TEST_RESULT_UINT(cipherType(strNew("aes-256-cbc")), cipherTypeAes256Cbc, "aes-256-cbc type");
+        TEST_RESULT_UINT(cipherType(strNew("aes-256-gcm")), cipherTypeAes256Gcm, "aes-256-gcm type");
 
-        TEST_ERROR(cipherTypeName((CipherType)2), AssertError, "invalid cipher type 2");
+        TEST_ERROR(cipherTypeName((CipherType)3), AssertError, "invalid cipher type 3");
         TEST_RESULT_STR(strPtr(cipherTypeName(cipherTypeNone)), "none", "none name");
         TEST_RESULT_STR(strPtr(cipherTypeName(cipherTypeAes256Cbc)), "aes-256-cbc", "aes-256-cbc name");
+        TEST_RESULT_STR(strPtr(cipherTypeName(cipherTypeAes256Gcm)), "aes-256-gcm", "aes-256-gcm name");
     }
 
     // *****************************************************************************************************************************
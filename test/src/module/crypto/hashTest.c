@@ -1,6 +1,19 @@
 /***********************************************************************************************************************************
 Test Cryptographic Hashes
 ***********************************************************************************************************************************/
+#include "common/time.h"
+
+/***********************************************************************************************************************************
+Message sizes for multi-buffer tests.  Sizes around the block size and padding boundary test padding and sizes around the queue size
+test flushing when the queue is full.
+***********************************************************************************************************************************/
+static const size_t testMultiSize[] =
+{
+    0, 1, 55, 56, 57, 63, 64, 65, 119, 120, 128, 1000, 8192, CRYPTO_HASH_MULTI_QUEUE_SIZE - 1, CRYPTO_HASH_MULTI_QUEUE_SIZE,
+    CRYPTO_HASH_MULTI_QUEUE_SIZE + 1, CRYPTO_HASH_MULTI_QUEUE_SIZE * 3 + 17, 5, 77777, 4096, 16 * 1024 * 3 + 1,
+};
+
+#define TEST_MULTI_TOTAL                                            (sizeof(testMultiSize) / sizeof(testMultiSize[0]))
 
 /***********************************************************************************************************************************
 Test Run
@@ -53,6 +66,211 @@ testRun(void)
             "    check empty hash");
     }
 
+    // *****************************************************************************************************************************
+    if (testBegin("CryptoHashMulti"))
+    {
+        Buffer *message = bufNew(CRYPTO_HASH_MULTI_QUEUE_SIZE * 4);
+        bufUsedSet(message, bufSize(message));
+
+        for (size_t byteIdx = 0; byteIdx < bufUsed(message); byteIdx++)
+            bufPtr(message)[byteIdx] = (unsigned char)((byteIdx * 7919 % 65521) % 251);
+
+        // Get the expected hashes from the single-stream implementation
+        String *hashExpected[TEST_MULTI_TOTAL];
+
+        for (unsigned int streamIdx = 0; streamIdx < TEST_MULTI_TOTAL; streamIdx++)
+        {
+            hashExpected[streamIdx] = bufHex(
+                cryptoHashOneC(HASH_TYPE_SHA1_STR, bufPtr(message) + streamIdx, testMultiSize[streamIdx]));
+        }
+
+        // Each implementation supported by this CPU must produce the same hashes.  There are more streams than lanes so lanes are
+        // refilled, and streams finish at different times so there are idle lanes and single streams.
+        for (unsigned int implIdx = 0; implIdx < CRYPTO_HASH_MULTI_IMPL_TOTAL; implIdx++)
+        {
+            if (!cryptoHashMultiImplSupported((CryptoHashMultiImpl)implIdx))
+            {
+                TEST_LOG_FMT("%s not supported by this CPU", cryptoHashMultiImplLocal[implIdx].name);
+                continue;
+            }
+
+            CryptoHashMulti *multi = cryptoHashMultiNew();
+            multi->impl = implIdx;
+
+            CryptoHash *hash[TEST_MULTI_TOTAL];
+
+            for (unsigned int streamIdx = 0; streamIdx < TEST_MULTI_TOTAL; streamIdx++)
+                hash[streamIdx] = cryptoHashNewMulti(multi);
+
+            // Write the messages in chunks of different sizes, alternating between streams
+            size_t messageDone[TEST_MULTI_TOTAL] = {0};
+            bool more;
+
+            do
+            {
+                more = false;
+
+                for (unsigned int streamIdx = 0; streamIdx < TEST_MULTI_TOTAL; streamIdx++)
+                {
+                    size_t chunkSize = testMultiSize[streamIdx] - messageDone[streamIdx];
+
+                    if (chunkSize > 1000 + streamIdx * 997)
+                        chunkSize = 1000 + streamIdx * 997;
+
+                    if (chunkSize > 0)
+                    {
+                        ioFilterProcessIn(
+                            cryptoHashFilter(hash[streamIdx]),
+                            bufNewC(chunkSize, bufPtr(message) + streamIdx + messageDone[streamIdx]));
+                        messageDone[streamIdx] += chunkSize;
+                        more = true;
+                    }
+                }
+            }
+            while (more);
+
+            for (unsigned int streamIdx = 0; streamIdx < TEST_MULTI_TOTAL; streamIdx++)
+            {
+                TEST_RESULT_STR(
+                    strPtr(varStr(ioFilterResult(cryptoHashFilter(hash[streamIdx])))), strPtr(hashExpected[streamIdx]),
+                    "%s hash for %zu bytes", cryptoHashMultiImplLocal[implIdx].name, testMultiSize[streamIdx]);
+            }
+
+            for (unsigned int streamIdx = 0; streamIdx < TEST_MULTI_TOTAL; streamIdx++)
+                cryptoHashFree(hash[streamIdx]);
+
+            TEST_RESULT_VOID(cryptoHashMultiFree(multi), "    free multi");
+        }
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        CryptoHashMulti *multi = NULL;
+
+        TEST_ASSIGN(multi, cryptoHashMultiNew(), "create multi");
+        TEST_RESULT_STR(cryptoHashMultiImpl(multi), cryptoHashMultiImplLocal[cryptoHashMultiImplSelect()].name, "    check impl");
+        TEST_RESULT_UINT(
+            cryptoHashMultiLaneTotal(multi), cryptoHashMultiImplLocal[cryptoHashMultiImplSelect()].laneTotal,
+            "    check lane total");
+
+        CryptoHash *hash = cryptoHashNewMulti(multi);
+        TEST_RESULT_STR(
+            strPtr(cryptoHashMultiToLog(multi)),
+            strPtr(
+                strNewFmt(
+                    "{impl: %s, laneTotal: %u, streamTotal: 1}", cryptoHashMultiImpl(multi), cryptoHashMultiLaneTotal(multi))),
+            "    check log");
+
+        TEST_RESULT_VOID(cryptoHashProcessStr(hash, strNew("12345")), "    add 12345");
+        TEST_RESULT_STR(strPtr(bufHex(cryptoHash(hash))), "8cb2237d0679ca88db6464eac60da96345513964", "    check small hash");
+        TEST_RESULT_UINT(multi->streamTotal, 0, "    stream removed after hash");
+
+        CryptoHash *hash2 = NULL;
+
+        TEST_ASSIGN(hash, cryptoHashNewMulti(multi), "create hash");
+        TEST_ASSIGN(hash2, cryptoHashNewMulti(multi), "create second hash");
+        TEST_RESULT_UINT(multi->streamTotal, 2, "    streams added");
+        TEST_RESULT_VOID(cryptoHashFree(hash), "    free hash");
+        TEST_RESULT_PTR(multi->streamFirst, hash2->multiStream, "    second hash is first");
+        TEST_RESULT_PTR(hash2->multiStream->streamNext, NULL, "    second hash is last");
+        TEST_RESULT_VOID(cryptoHashFree(hash2), "    free second hash");
+        TEST_RESULT_UINT(multi->streamTotal, 0, "    streams removed after free");
+        TEST_RESULT_PTR(multi->streamFirst, NULL, "    no streams");
+
+        TEST_RESULT_VOID(cryptoHashMultiStreamFree(NULL), "free null stream");
+        TEST_RESULT_VOID(cryptoHashMultiFree(multi), "free multi");
+        TEST_RESULT_VOID(cryptoHashMultiFree(NULL), "free null multi");
+
+        // Free a parent context with live streams, which frees the engine before the streams
+        // -------------------------------------------------------------------------------------------------------------------------
+        CryptoHashMultiStream *stream = NULL;
+
+        MEM_CONTEXT_TEMP_BEGIN()
+        {
+            multi = cryptoHashMultiNew();
+            hash = cryptoHashNewMulti(multi);
+            hash2 = cryptoHashNewMulti(multi);
+            TEST_RESULT_VOID(cryptoHashProcessStr(hash, strNew("12345")), "add data to live stream");
+
+            // Free the engine on its own to check that the streams are detached
+            stream = hash->multiStream;
+            TEST_RESULT_VOID(cryptoHashMultiFree(multi), "free multi with live streams");
+            TEST_RESULT_PTR(stream->multi, NULL, "    stream is detached");
+            TEST_RESULT_VOID(cryptoHashFree(hash), "    free detached stream");
+
+            // Create another engine and stream so the engine is freed first with the parent
+            multi = cryptoHashMultiNew();
+            hash = cryptoHashNewMulti(multi);
+        }
+        MEM_CONTEXT_TEMP_END();
+
+        TEST_RESULT_VOID((void)0, "free parent with live streams");
+    }
+
+    // *****************************************************************************************************************************
+    if (testBegin("CryptoHashMulti benchmark"))
+    {
+        // Hash the same total data as one stream with OpenSSL and as several streams with each multi-buffer implementation.  Unit
+        // tests are built without optimization so the results are only useful for comparing implementations to each other.
+        unsigned int streamTotal = SHA1_LANE_MAX;
+        size_t streamSize = 1024 * 1024;
+        size_t chunkSize = 64 * 1024;
+
+        Buffer *chunk = bufNew(chunkSize);
+        bufUsedSet(chunk, bufSize(chunk));
+        memset(bufPtr(chunk), 0x55, bufSize(chunk));
+
+        double byteTotal = (double)streamTotal * (double)streamSize;
+
+        MEM_CONTEXT_TEMP_BEGIN()
+        {
+            CryptoHash *hash = cryptoHashNew(HASH_TYPE_SHA1_STR);
+            TimeMSec timeBegin = timeMSec();
+
+            for (size_t chunkIdx = 0; chunkIdx < streamTotal * streamSize / chunkSize; chunkIdx++)
+                cryptoHashProcess(hash, chunk);
+
+            cryptoHash(hash);
+
+            TimeMSec timeTotal = timeMSec() - timeBegin;
+            TEST_LOG_FMT("openssl: %.2f GB/s", byteTotal / (double)(timeTotal == 0 ? 1 : timeTotal) / 1000000.0);
+        }
+        MEM_CONTEXT_TEMP_END();
+
+        for (unsigned int implIdx = 0; implIdx < CRYPTO_HASH_MULTI_IMPL_TOTAL; implIdx++)
+        {
+            if (!cryptoHashMultiImplSupported((CryptoHashMultiImpl)implIdx))
+                continue;
+
+            MEM_CONTEXT_TEMP_BEGIN()
+            {
+                CryptoHashMulti *multi = cryptoHashMultiNew();
+                multi->impl = implIdx;
+
+                CryptoHash *hash[SHA1_LANE_MAX];
+
+                for (unsigned int streamIdx = 0; streamIdx < streamTotal; streamIdx++)
+                    hash[streamIdx] = cryptoHashNewMulti(multi);
+
+                TimeMSec timeBegin = timeMSec();
+
+                for (size_t chunkIdx = 0; chunkIdx < streamSize / chunkSize; chunkIdx++)
+                {
+                    for (unsigned int streamIdx = 0; streamIdx < streamTotal; streamIdx++)
+                        cryptoHashProcess(hash[streamIdx], chunk);
+                }
+
+                for (unsigned int streamIdx = 0; streamIdx < streamTotal; streamIdx++)
+                    cryptoHash(hash[streamIdx]);
+
+                TimeMSec timeTotal = timeMSec() - timeBegin;
+
+                TEST_LOG_FMT(
+                    "%s (%u lanes): %.2f GB/s", cryptoHashMultiImplLocal[implIdx].name, cryptoHashMultiImplLocal[implIdx].laneTotal,
+                    byteTotal / (double)(timeTotal == 0 ? 1 : timeTotal) / 1000000.0);
+            }
+            MEM_CONTEXT_TEMP_END();
+        }
+    }
+
     // *****************************************************************************************************************************
     if (testBegin("cryptoHashOne*()"))
     {
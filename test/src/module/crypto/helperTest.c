@@ -0,0 +1,59 @@
+/***********************************************************************************************************************************
+Test Cipher Helper
+***********************************************************************************************************************************/
+#include "common/io/bufferWrite.h"
+#include "common/io/filter/group.h"
+#include "common/io/io.h"
+
+/***********************************************************************************************************************************
+Encrypt and then decrypt data
+***********************************************************************************************************************************/
+static Buffer *
+testCipherFilter(CipherMode mode, CipherType type, const Buffer *pass, const Buffer *source)
+{
+    Buffer *destination = bufNew(0);
+
+    IoWrite *write = ioBufferWriteIo(ioBufferWriteNew(destination));
+    ioWriteFilterGroupSet(write, ioFilterGroupAdd(ioFilterGroupNew(), cipherFilter(mode, type, pass)));
+    ioWriteOpen(write);
+    ioWrite(write, source);
+    ioWriteClose(write);
+
+    return destination;
+}
+
+static Buffer *
+testRoundTrip(CipherType type, const Buffer *pass, const Buffer *plaintext)
+{
+    return testCipherFilter(cipherModeDecrypt, type, pass, testCipherFilter(cipherModeEncrypt, type, pass, plaintext));
+}
+
+/***********************************************************************************************************************************
+Test Run
+***********************************************************************************************************************************/
+void
+testRun(void)
+{
+    FUNCTION_HARNESS_VOID();
+
+    // *****************************************************************************************************************************
+    if (testBegin("cipherFilter()"))
+    {
+        const Buffer *pass = bufNewStr(strNew("areallybadpassphrase"));
+        const Buffer *plaintext = bufNewStr(strNew("plaintext"));
+
+        TEST_RESULT_STR(
+            strPtr(ioFilterType(cipherFilter(cipherModeEncrypt, cipherTypeAes256Cbc, pass))), "cipherBlock", "aes-256-cbc filter");
+        TEST_RESULT_STR(
+            strPtr(ioFilterType(cipherFilter(cipherModeEncrypt, cipherTypeAes256Gcm, pass))), "cipherGcm", "aes-256-gcm filter");
+
+        // Round trip with each cipher type
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_RESULT_STR(
+            strPtr(strNewBuf(testRoundTrip(cipherTypeAes256Cbc, pass, plaintext))), "plaintext", "aes-256-cbc round trip");
+        TEST_RESULT_STR(
+            strPtr(strNewBuf(testRoundTrip(cipherTypeAes256Gcm, pass, plaintext))), "plaintext", "aes-256-gcm round trip");
+    }
+
+    FUNCTION_HARNESS_RESULT_VOID();
+}
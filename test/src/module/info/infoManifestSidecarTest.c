@@ -0,0 +1,324 @@
+/***********************************************************************************************************************************
+Test Manifest Sidecar
+***********************************************************************************************************************************/
+#include "common/harnessLog.h"
+#include "common/io/bufferWrite.h"
+#include "common/io/filter/group.h"
+#include "crypto/hash.h"
+#include "crypto/helper.h"
+#include "storage/driver/posix/storage.h"
+
+/***********************************************************************************************************************************
+Build a manifest with the files used in the tests and save it so it has a checksum
+***********************************************************************************************************************************/
+static InfoManifest *
+testManifest(IoWrite *write)
+{
+    InfoManifest *result = infoManifestNew();
+    iniSet(infoManifestIni(result), strNew("backrest"), strNew("backrest-format"), varNewStrZ("5"));
+
+    infoManifestFileAdd(
+        result,
+        &(InfoManifestFile){.name = strNew("pg_data/global/1"), .size = 1, .timestamp = -1,
+            .reference = strNew("20190818-084502F")});
+    infoManifestFileAdd(
+        result,
+        &(InfoManifestFile){.name = strNew("pg_data/PG_VERSION"), .size = 3, .timestamp = 1565282101,
+            .checksum = strNew("184473f470864e067ee3a22e64b47b0a1c356f29")});
+    infoManifestFileAdd(result, &(InfoManifestFile){.name = strNew("pg_data/base/1/1000"), .size = 8192, .timestamp = 1565282100});
+
+    infoManifestSave(result, write == NULL ? ioBufferWriteIo(ioBufferWriteNew(bufNew(0))) : write);
+
+    return result;
+}
+
+/***********************************************************************************************************************************
+Save the sidecar for a manifest to a buffer
+***********************************************************************************************************************************/
+static Buffer *
+testSidecar(const InfoManifest *manifest)
+{
+    Buffer *result = bufNew(0);
+    infoManifestSaveSidecar(manifest, ioBufferWriteIo(ioBufferWriteNew(result)));
+
+    return result;
+}
+
+/***********************************************************************************************************************************
+Test Run
+***********************************************************************************************************************************/
+void
+testRun(void)
+{
+    FUNCTION_HARNESS_VOID();
+
+    Storage *storageTest = storageDriverPosixInterface(
+        storageDriverPosixNew(strNew(testPath()), STORAGE_MODE_FILE_DEFAULT, STORAGE_MODE_PATH_DEFAULT, true, NULL));
+
+    // *****************************************************************************************************************************
+    if (testBegin("infoManifestSidecarNew(), infoManifestSidecarFind(), and infoManifestSidecarFile()"))
+    {
+        InfoManifest *manifest = testManifest(NULL);
+        const String *manifestChecksum = infoManifestChecksum(manifest);
+        Buffer *buffer = testSidecar(manifest);
+
+        // Valid sidecar
+        // -------------------------------------------------------------------------------------------------------------------------
+        InfoManifestSidecar *sidecar = NULL;
+
+        TEST_ASSIGN(sidecar, infoManifestSidecarNew(bufNewC(bufUsed(buffer), bufPtr(buffer)), manifestChecksum), "new sidecar");
+        TEST_RESULT_UINT(infoManifestSidecarFileTotal(sidecar), 3, "    file total");
+        TEST_RESULT_STR(strPtr(infoManifestSidecarManifestChecksum(sidecar)), strPtr(manifestChecksum), "    manifest checksum");
+
+        InfoManifestFile file = infoManifestSidecarFile(sidecar, 0);
+        TEST_RESULT_STR(strPtr(file.name), "pg_data/PG_VERSION", "    file name");
+        TEST_RESULT_UINT(file.size, 3, "    file size");
+        TEST_RESULT_INT(file.timestamp, 1565282101, "    file timestamp");
+        TEST_RESULT_STR(strPtr(file.checksum), "184473f470864e067ee3a22e64b47b0a1c356f29", "    file checksum");
+        TEST_RESULT_PTR(file.reference, NULL, "    file reference");
+
+        file = infoManifestSidecarFile(sidecar, 1);
+        TEST_RESULT_STR(strPtr(file.name), "pg_data/base/1/1000", "    file name");
+        TEST_RESULT_PTR(file.checksum, NULL, "    file checksum");
+        TEST_RESULT_PTR(file.reference, NULL, "    file reference");
+
+        file = infoManifestSidecarFile(sidecar, 2);
+        TEST_RESULT_STR(strPtr(file.name), "pg_data/global/1", "    file name");
+        TEST_RESULT_INT(file.timestamp, -1, "    file timestamp");
+        TEST_RESULT_STR(strPtr(file.reference), "20190818-084502F", "    file reference");
+
+        // Find files
+        // -------------------------------------------------------------------------------------------------------------------------
+        unsigned int fileIdx = 0;
+
+        TEST_RESULT_BOOL(infoManifestSidecarFind(sidecar, strNew("pg_data/PG_VERSION"), &fileIdx), true, "find first file");
+        TEST_RESULT_UINT(fileIdx, 0, "    file index");
+        TEST_RESULT_BOOL(infoManifestSidecarFind(sidecar, strNew("pg_data/base/1/1000"), &fileIdx), true, "find middle file");
+        TEST_RESULT_UINT(fileIdx, 1, "    file index");
+        TEST_RESULT_BOOL(infoManifestSidecarFind(sidecar, strNew("pg_data/global/1"), &fileIdx), true, "find last file");
+        TEST_RESULT_UINT(fileIdx, 2, "    file index");
+
+        TEST_RESULT_BOOL(infoManifestSidecarFind(sidecar, strNew("a"), &fileIdx), false, "file before first is not found");
+        TEST_RESULT_BOOL(infoManifestSidecarFind(sidecar, strNew("z"), &fileIdx), false, "file after last is not found");
+        TEST_RESULT_BOOL(infoManifestSidecarFind(sidecar, strNew("pg_data/base/1/1000x"), &fileIdx), false, "longer name");
+        TEST_RESULT_BOOL(infoManifestSidecarFind(sidecar, strNew("pg_data/base/1/100"), &fileIdx), false, "shorter name");
+        TEST_RESULT_UINT(fileIdx, 2, "    file index is unchanged");
+
+        TEST_RESULT_VOID(infoManifestSidecarFree(sidecar), "free sidecar");
+        TEST_RESULT_VOID(infoManifestSidecarFree(NULL), "free null sidecar");
+
+        // Empty sidecar
+        // -------------------------------------------------------------------------------------------------------------------------
+        InfoManifest *manifestEmpty = infoManifestNew();
+        infoManifestSave(manifestEmpty, ioBufferWriteIo(ioBufferWriteNew(bufNew(0))));
+
+        TEST_ASSIGN(sidecar, infoManifestSidecarNew(testSidecar(manifestEmpty), NULL), "new empty sidecar");
+        TEST_RESULT_UINT(infoManifestSidecarFileTotal(sidecar), 0, "    file total");
+        TEST_RESULT_BOOL(infoManifestSidecarFind(sidecar, strNew("pg_data/PG_VERSION"), &fileIdx), false, "    file not found");
+
+        // Errors
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_ERROR(infoManifestSidecarNew(bufNew(0), NULL), FormatError, "invalid manifest sidecar header");
+
+        Buffer *invalid = bufNewC(bufUsed(buffer), bufPtr(buffer));
+        ((InfoManifestSidecarHeader *)bufPtr(invalid))->magic[0] = 'X';
+        TEST_ERROR(infoManifestSidecarNew(invalid, NULL), FormatError, "invalid manifest sidecar header");
+
+        invalid = bufNewC(bufUsed(buffer), bufPtr(buffer));
+        ((InfoManifestSidecarHeader *)bufPtr(invalid))->version = INFO_MANIFEST_SIDECAR_VERSION + 1;
+        TEST_ERROR(infoManifestSidecarNew(invalid, NULL), FormatError, "invalid manifest sidecar header");
+
+        invalid = bufNewC(bufUsed(buffer), bufPtr(buffer));
+        bufCatC(invalid, (const unsigned char *)"X", 0, 1);
+        TEST_ERROR(
+            infoManifestSidecarNew(invalid, NULL), FormatError,
+            strPtr(strNewFmt("invalid manifest sidecar size, expected %zu but found %zu", bufUsed(buffer), bufUsed(buffer) + 1)));
+
+        invalid = bufNewC(bufUsed(buffer), bufPtr(buffer));
+        bufPtr(invalid)[bufUsed(invalid) - 1] = 'X';
+        TEST_ERROR(infoManifestSidecarNew(invalid, NULL), ChecksumError, "invalid manifest sidecar checksum");
+
+        // Name and reference outside the string pool with a valid checksum
+        for (unsigned int fileIdx = 1; fileIdx < 3; fileIdx++)
+        {
+            invalid = bufNewC(bufUsed(buffer), bufPtr(buffer));
+            InfoManifestSidecarHeader *header = (InfoManifestSidecarHeader *)bufPtr(invalid);
+            InfoManifestSidecarFile *file = (InfoManifestSidecarFile *)(header + 1);
+
+            if (fileIdx == 1)
+                file[fileIdx].nameSize = header->poolSize;
+            else
+                file[fileIdx].referenceOffset = header->poolSize;
+
+            memcpy(
+                header->checksum,
+                bufPtr(cryptoHashOneC(HASH_TYPE_SHA1_STR, (const unsigned char *)file, bufUsed(invalid) - sizeof(*header))),
+                sizeof(header->checksum));
+
+            TEST_ERROR_FMT(infoManifestSidecarNew(invalid, NULL), FormatError, "invalid manifest sidecar file %u", fileIdx);
+        }
+
+        TEST_ERROR_FMT(
+            infoManifestSidecarNew(bufNewC(bufUsed(buffer), bufPtr(buffer)), strNew("bogus")), ChecksumError,
+            "manifest sidecar is stale, expected manifest checksum 'bogus' but found '%s'", strPtr(manifestChecksum));
+    }
+
+    // *****************************************************************************************************************************
+    if (testBegin("infoManifestSidecarNewLoad()"))
+    {
+        const String *fileName = strNew("backup.manifest");
+        const String *sidecarFileName = strNew("backup.manifest" INFO_MANIFEST_SIDECAR_EXT);
+
+        TEST_ERROR_FMT(
+            infoManifestSidecarNewLoad(storageTest, fileName, storageTest, cipherTypeNone, NULL), FileMissingError,
+            "unable to open '%s/backup.manifest' for read: [2] No such file or directory", testPath());
+
+        // Sidecar is built but not saved when there is no write storage
+        // -------------------------------------------------------------------------------------------------------------------------
+        InfoManifest *manifest = testManifest(storageFileWriteIo(storageNewWriteNP(storageTest, fileName)));
+        InfoManifestSidecar *sidecar = NULL;
+
+        TEST_ASSIGN(sidecar, infoManifestSidecarNewLoad(storageTest, fileName, NULL, cipherTypeNone, NULL), "load sidecar");
+        TEST_RESULT_UINT(infoManifestSidecarFileTotal(sidecar), 3, "    file total");
+        TEST_RESULT_STR(
+            strPtr(infoManifestSidecarManifestChecksum(sidecar)), strPtr(infoManifestChecksum(manifest)), "    manifest checksum");
+        TEST_RESULT_BOOL(storageExistsNP(storageTest, sidecarFileName), false, "    sidecar is not saved");
+
+        // Sidecar is saved and then used without loading the manifest
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_ASSIGN(sidecar, infoManifestSidecarNewLoad(storageTest, fileName, storageTest, cipherTypeNone, NULL), "load sidecar");
+        TEST_RESULT_BOOL(
+            bufEq(storageGetNP(storageNewReadNP(storageTest, sidecarFileName)), testSidecar(manifest)), true,
+            "    sidecar is saved");
+
+        // Truncate the manifest after the checksum so the manifest cannot be loaded
+        Buffer *manifestContent = storageGetNP(storageNewReadNP(storageTest, fileName));
+        storagePutNP(
+            storageNewWriteNP(storageTest, fileName),
+            bufNewC(
+                strlen("[backrest]\nbackrest-checksum=\"\"\n") + INFO_MANIFEST_SIDECAR_CHECKSUM_HEX_SIZE,
+                bufPtr(manifestContent)));
+
+        TEST_ASSIGN(sidecar, infoManifestSidecarNewLoad(storageTest, fileName, storageTest, cipherTypeNone, NULL), "load sidecar");
+        TEST_RESULT_UINT(infoManifestSidecarFileTotal(sidecar), 3, "    file total");
+
+        // Stale sidecar is rebuilt
+        // -------------------------------------------------------------------------------------------------------------------------
+        const String *checksumOld = strDup(infoManifestChecksum(manifest));
+
+        infoManifestFileAdd(manifest, &(InfoManifestFile){.name = strNew("pg_data/base/1/2000")});
+        infoManifestSave(manifest, storageFileWriteIo(storageNewWriteNP(storageTest, fileName)));
+
+        harnessLogLevelSet(logLevelDetail);
+
+        TEST_ASSIGN(sidecar, infoManifestSidecarNewLoad(storageTest, fileName, storageTest, cipherTypeNone, NULL), "load sidecar");
+        TEST_RESULT_UINT(infoManifestSidecarFileTotal(sidecar), 4, "    file total");
+        harnessLogResult(
+            strPtr(
+                strNewFmt(
+                    "P00 DETAIL: rebuild manifest sidecar 'backup.manifest.sidecar': manifest sidecar is stale, expected manifest"
+                        " checksum '%s' but found '%s'",
+                    strPtr(infoManifestChecksum(manifest)), strPtr(checksumOld))));
+        TEST_RESULT_BOOL(
+            bufEq(storageGetNP(storageNewReadNP(storageTest, sidecarFileName)), testSidecar(manifest)), true,
+            "    sidecar is saved");
+
+        // Invalid sidecar is rebuilt
+        // -------------------------------------------------------------------------------------------------------------------------
+        storagePutNP(storageNewWriteNP(storageTest, sidecarFileName), bufNewStr(strNew("BOGUS")));
+
+        TEST_ASSIGN(sidecar, infoManifestSidecarNewLoad(storageTest, fileName, storageTest, cipherTypeNone, NULL), "load sidecar");
+        TEST_RESULT_UINT(infoManifestSidecarFileTotal(sidecar), 4, "    file total");
+        harnessLogResult("P00 DETAIL: rebuild manifest sidecar 'backup.manifest.sidecar': invalid manifest sidecar header");
+
+        harnessLogLevelReset();
+        TEST_RESULT_BOOL(
+            bufEq(storageGetNP(storageNewReadNP(storageTest, sidecarFileName)), testSidecar(manifest)), true,
+            "    sidecar is saved");
+
+        // Sidecar is rebuilt when the manifest checksum is not where expected
+        // -------------------------------------------------------------------------------------------------------------------------
+        manifestContent = storageGetNP(storageNewReadNP(storageTest, fileName));
+
+        storagePutNP(storageNewWriteNP(storageTest, fileName), bufCat(bufNewStr(strNew("\n")), manifestContent));
+        TEST_ASSIGN(
+            sidecar, infoManifestSidecarNewLoad(storageTest, fileName, NULL, cipherTypeNone, NULL), "load with no section first");
+        TEST_RESULT_UINT(infoManifestSidecarFileTotal(sidecar), 4, "    file total");
+
+        storagePutNP(
+            storageNewWriteNP(storageTest, fileName),
+            bufNewStr(strNewFmt("[backrest]\n\n%s", strPtr(strSub(strNewBuf(manifestContent), strlen("[backrest]\n"))))));
+        TEST_ASSIGN(
+            sidecar, infoManifestSidecarNewLoad(storageTest, fileName, NULL, cipherTypeNone, NULL), "load with no checksum first");
+        TEST_RESULT_UINT(infoManifestSidecarFileTotal(sidecar), 4, "    file total");
+
+        // Manifest checksum must be valid when the sidecar is rebuilt
+        storagePutNP(
+            storageNewWriteNP(storageTest, fileName),
+            bufNewStr(strNew("[backrest]\nbackrest-checksum=\"BOGUS\"\nbackrest-format=5\n")));
+        TEST_ERROR(
+            infoManifestSidecarNewLoad(storageTest, fileName, NULL, cipherTypeNone, NULL), ChecksumError,
+            "invalid manifest checksum, expected \"a3765a8c2c1e5d35274a0b0ce118f4031faff0bd\" but found \"BOGUS\"");
+
+        storagePutNP(
+            storageNewWriteNP(storageTest, fileName),
+            bufNewStr(strNew("[backrest]\nbackrest-checksum=\"a3765a8c2c1e5d35274a0b0ce118f4031faff0bdX\nbackrest-format=5\n")));
+        TEST_ERROR(
+            infoManifestSidecarNewLoad(storageTest, fileName, NULL, cipherTypeNone, NULL), ChecksumError,
+            "invalid manifest checksum, expected \"a3765a8c2c1e5d35274a0b0ce118f4031faff0bd\" but found"
+                " \"a3765a8c2c1e5d35274a0b0ce118f4031faff0bdX");
+
+        // Encrypted manifest and sidecar
+        // -------------------------------------------------------------------------------------------------------------------------
+        storageRemoveNP(storageTest, sidecarFileName);
+
+        StorageFileWrite *write = storageNewWriteNP(storageTest, fileName);
+        ioWriteFilterGroupSet(
+            storageFileWriteIo(write),
+            ioFilterGroupAdd(
+                ioFilterGroupNew(), cipherFilter(cipherModeEncrypt, cipherTypeAes256Cbc, bufNewStr(strNew("12345678")))));
+        manifest = testManifest(storageFileWriteIo(write));
+
+        TEST_ASSIGN(
+            sidecar, infoManifestSidecarNewLoad(storageTest, fileName, storageTest, cipherTypeAes256Cbc, strNew("12345678")),
+            "load encrypted sidecar");
+        TEST_RESULT_UINT(infoManifestSidecarFileTotal(sidecar), 3, "    file total");
+        TEST_RESULT_BOOL(
+            bufEq(storageGetNP(storageNewReadNP(storageTest, sidecarFileName)), testSidecar(manifest)), false,
+            "    sidecar is encrypted");
+
+        TEST_ASSIGN(
+            sidecar, infoManifestSidecarNewLoad(storageTest, fileName, storageTest, cipherTypeAes256Cbc, strNew("12345678")),
+            "load encrypted sidecar");
+        TEST_RESULT_STR(
+            strPtr(infoManifestSidecarManifestChecksum(sidecar)), strPtr(infoManifestChecksum(manifest)), "    manifest checksum");
+
+        // Corrupt encrypted sidecar is rebuilt
+        // -------------------------------------------------------------------------------------------------------------------------
+        Buffer *sidecarContent = storageGetNP(storageNewReadNP(storageTest, sidecarFileName));
+
+        storagePutNP(storageNewWriteNP(storageTest, sidecarFileName), bufNewStr(strNew("BOGUS")));
+        harnessLogLevelSet(logLevelDetail);
+
+        TEST_ASSIGN(
+            sidecar, infoManifestSidecarNewLoad(storageTest, fileName, storageTest, cipherTypeAes256Cbc, strNew("12345678")),
+            "load corrupt encrypted sidecar");
+        TEST_RESULT_UINT(infoManifestSidecarFileTotal(sidecar), 3, "    file total");
+        harnessLogResult("P00 DETAIL: rebuild manifest sidecar 'backup.manifest.sidecar': cipher header missing");
+
+        storagePutNP(
+            storageNewWriteNP(storageTest, sidecarFileName), bufNewC(bufUsed(sidecarContent) - 1, bufPtr(sidecarContent)));
+
+        TEST_ASSIGN(
+            sidecar, infoManifestSidecarNewLoad(storageTest, fileName, storageTest, cipherTypeAes256Cbc, strNew("12345678")),
+            "load truncated encrypted sidecar");
+        TEST_RESULT_UINT(infoManifestSidecarFileTotal(sidecar), 3, "    file total");
+        harnessLogResult("P00 DETAIL: rebuild manifest sidecar 'backup.manifest.sidecar': unable to flush");
+
+        harnessLogLevelReset();
+        TEST_RESULT_UINT(
+            bufUsed(storageGetNP(storageNewReadNP(storageTest, sidecarFileName))), bufUsed(sidecarContent), "    sidecar is saved");
+    }
+
+    FUNCTION_HARNESS_RESULT_VOID();
+}
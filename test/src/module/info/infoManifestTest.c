@@ -0,0 +1,619 @@
+/***********************************************************************************************************************************
+Test Manifest Info Handler
+***********************************************************************************************************************************/
+#include <grp.h>
+#include <pwd.h>
+#include <unistd.h>
+
+#include "common/harnessLog.h"
+#include "common/io/bufferRead.h"
+#include "common/io/bufferWrite.h"
+#include "crypto/hash.h"
+#include "info/infoManifestSidecar.h"
+#include "postgres/version.h"
+#include "storage/helper.h"
+
+/***********************************************************************************************************************************
+Run a shell command to set up a cluster
+***********************************************************************************************************************************/
+#define TEST_SYSTEM_FMT(...)                                                                                                       \
+    TEST_RESULT_INT(system(strPtr(strNewFmt(__VA_ARGS__))), 0, "set up cluster")
+
+/***********************************************************************************************************************************
+Render each value in a manifest the way Perl renders it, i.e. decode the value and encode it again with JSON::PP.  Perl calculates
+the checksum in the same way so the values must be identical for Perl to accept a manifest built in C.
+***********************************************************************************************************************************/
+static const char *
+testManifestPerl(const String *manifest)
+{
+    String *fileC = strNewFmt("%s/manifest.c", testPath());
+    String *filePerl = strNewFmt("%s/manifest.perl", testPath());
+
+    storagePutNP(storageNewWriteNP(storageLocalWrite(), fileC), bufNewStr(manifest));
+
+    TEST_RESULT_INT(
+        system(
+            strPtr(
+                strNewFmt(
+                    "perl -MJSON::PP -e 'my $json = JSON::PP->new()->canonical()->allow_nonref();"
+                        " while (<>) {print /^([^=\\[]+)=(.*)$/ ? \"$1=\" . $json->encode($json->decode($2)) . \"\\n\" : $_}'"
+                        " %s > %s",
+                    strPtr(fileC), strPtr(filePerl)))),
+        0, "render with Perl");
+
+    return strPtr(strNewBuf(storageGetNP(storageNewReadNP(storageLocal(), filePerl))));
+}
+
+/***********************************************************************************************************************************
+Load a manifest from a string and save it back to a string
+***********************************************************************************************************************************/
+static InfoManifest *
+testManifestLoad(const char *content)
+{
+    return infoManifestNewLoad(ioBufferReadIo(ioBufferReadNew(bufNewStr(strNew(content)))));
+}
+
+static const char *
+testManifestSave(InfoManifest *manifest)
+{
+    Buffer *result = bufNew(0);
+    infoManifestSave(manifest, ioBufferWriteIo(ioBufferWriteNew(result)));
+
+    return strPtr(strNewBuf(result));
+}
+
+/***********************************************************************************************************************************
+Test Run
+***********************************************************************************************************************************/
+void
+testRun(void)
+{
+    // *****************************************************************************************************************************
+    if (testBegin("infoManifestPathAbsolute()"))
+    {
+        TEST_RESULT_STR(strPtr(infoManifestPathAbsolute(strNew("/base"), strNew("/abs/path"))), "/abs/path", "path is absolute");
+        TEST_RESULT_STR(strPtr(infoManifestPathAbsolute(strNew("/base/pg"), strNew("path"))), "/base/pg/path", "relative path");
+        TEST_RESULT_STR(strPtr(infoManifestPathAbsolute(strNew("/base/pg"), strNew("../../path"))), "/path", "relative path up");
+
+        TEST_ERROR(
+            infoManifestPathAbsolute(strNew("base"), strNew("path")), PathTypeError, "base is not an absolute path");
+        TEST_ERROR(
+            infoManifestPathAbsolute(strNew("/base/../pg"), strNew("path")), PathTypeError, "/base/../pg is not an absolute path");
+        TEST_ERROR(
+            infoManifestPathAbsolute(strNew("/base"), strNew("path/../path")), PathTypeError,
+            "result /base/path/../path was not an absolute path");
+    }
+
+    // *****************************************************************************************************************************
+    if (testBegin("infoManifestBuild()"))
+    {
+        const char *user = getpwuid(getuid())->pw_name;
+        const char *group = getgrgid(getgid())->gr_name;
+        String *pgPath = strNewFmt("%s/pg", testPath());
+
+        // Offline 9.4 cluster with a tablespace, a link to a file, and files/paths that are skipped
+        //--------------------------------------------------------------------------------------------------------------------------
+        TEST_SYSTEM_FMT(
+            "mkdir -p %s %s/config %s/ts && cd %s && "
+            "mkdir -p base/1 global pg_log pg_stat_tmp pg_subtrans pg_tblspc pg_xlog/archive_status pgsql_tmp"
+                " ../ts/PG_9.4_201409291/1 ../ts/PG_9.4_201409291/pgsql_tmp1 ../ts/other && "
+            "echo 9.4 > PG_VERSION && "
+            "touch global/pg_control postmaster.pid pg_log/log.txt pg_stat_tmp/stat pg_subtrans/0000"
+                " pg_xlog/000000010000000000000001 pgsql_tmp/temp base/1/1000 base/1/1000_init base/1/1000_vm.1 base/1/2000"
+                " base/1/t1_2000 base/1/pg_internal.init ../config/postgresql.conf ../ts/PG_9.4_201409291/1/3000"
+                " ../ts/other/other && "
+            "ln -s ../config/postgresql.conf postgresql.conf && ln -s ../../ts pg_tblspc/16384 && "
+            "find .. -type d -exec chmod 700 {} + && find .. -type f -exec chmod 600 {} + && chmod 640 base/1/2000 && "
+            "find .. -type f -exec touch -m -d @1565282100 {} + && "
+            "sudo chown 77777:77777 base/1/1000_init && sudo chown -h 77777:77777 postgresql.conf pg_tblspc/16384",
+            strPtr(pgPath), testPath(), testPath(), strPtr(pgPath));
+
+        StringList *excludeList = strLstNew();
+        strLstAddZ(excludeList, "pg_stat_tmp");
+        strLstAddZ(excludeList, "pg_log/");
+
+        TEST_RESULT_STR(
+            strPtr(infoManifestBuild(storageLocal(), pgPath, PG_VERSION_94, 201409291, false, NULL, excludeList)),
+            strPtr(
+                strNewFmt(
+                    "[backup:target]\n"
+                    "pg_data={\"path\":\"%s\",\"type\":\"path\"}\n"
+                    "pg_data/postgresql.conf={\"file\":\"postgresql.conf\",\"path\":\"../config\",\"type\":\"link\"}\n"
+                    "pg_tblspc/16384={\"path\":\"../../ts\",\"tablespace-id\":\"16384\",\"tablespace-name\":\"ts16384\""
+                        ",\"type\":\"link\"}\n"
+                    "\n"
+                    "[target:file]\n"
+                    "pg_data/PG_VERSION={\"size\":4,\"timestamp\":1565282100}\n"
+                    "pg_data/base/1/1000_init={\"group\":false,\"master\":false,\"size\":0,\"timestamp\":1565282100"
+                        ",\"user\":false}\n"
+                    "pg_data/base/1/2000={\"master\":false,\"mode\":\"0640\",\"size\":0,\"timestamp\":1565282100}\n"
+                    "pg_data/global/pg_control={\"size\":0,\"timestamp\":1565282100}\n"
+                    "pg_data/pg_xlog/000000010000000000000001={\"size\":0,\"timestamp\":1565282100}\n"
+                    "pg_data/postgresql.conf={\"size\":0,\"timestamp\":1565282100}\n"
+                    "pg_tblspc/16384/PG_9.4_201409291/1/3000={\"master\":false,\"size\":0,\"timestamp\":1565282100}\n"
+                    "\n"
+                    "[target:file:default]\n"
+                    "group=\"%s\"\n"
+                    "master=true\n"
+                    "mode=\"0600\"\n"
+                    "user=\"%s\"\n"
+                    "\n"
+                    "[target:link]\n"
+                    "pg_data/pg_tblspc/16384={\"destination\":\"../../ts\",\"group\":false,\"user\":false}\n"
+                    "pg_data/postgresql.conf={\"destination\":\"../config/postgresql.conf\",\"group\":false"
+                        ",\"user\":false}\n"
+                    "\n"
+                    "[target:path]\n"
+                    "pg_data={}\n"
+                    "pg_data/base={}\n"
+                    "pg_data/base/1={}\n"
+                    "pg_data/global={}\n"
+                    "pg_data/pg_log={}\n"
+                    "pg_data/pg_subtrans={}\n"
+                    "pg_data/pg_tblspc={}\n"
+                    "pg_data/pg_xlog={}\n"
+                    "pg_data/pg_xlog/archive_status={}\n"
+                    "pg_tblspc={}\n"
+                    "pg_tblspc/16384={}\n"
+                    "pg_tblspc/16384/PG_9.4_201409291={}\n"
+                    "pg_tblspc/16384/PG_9.4_201409291/1={}\n"
+                    "\n"
+                    "[target:path:default]\n"
+                    "group=\"%s\"\n"
+                    "mode=\"0700\"\n"
+                    "user=\"%s\"\n",
+                    strPtr(pgPath), group, user, group, user)),
+            "build manifest");
+
+        harnessLogResult(
+            "P00   INFO: exclude pg_stat_tmp from backup using 'pg_stat_tmp' exclusion\n"
+            "P00   INFO: exclude pg_log/log.txt from backup using 'pg_log/' exclusion");
+
+        // Link destinations and target paths are rendered the same way Perl renders them
+        //--------------------------------------------------------------------------------------------------------------------------
+        String *manifest = infoManifestBuild(storageLocal(), pgPath, PG_VERSION_94, 201409291, false, NULL, NULL);
+
+        TEST_RESULT_BOOL(
+            strstr(strPtr(manifest), "\"destination\":\"../config/postgresql.conf\"") != NULL, true, "/ is not escaped");
+        TEST_RESULT_STR(testManifestPerl(manifest), strPtr(manifest), "manifest matches Perl rendering");
+
+        TEST_SYSTEM_FMT("sudo rm -rf %s %s/config %s/ts", strPtr(pgPath), testPath(), testPath());
+
+        // Online 10 cluster with a tablespace map, a link to a path, and unlogged relations
+        //--------------------------------------------------------------------------------------------------------------------------
+        TEST_SYSTEM_FMT(
+            "mkdir -p %s %s/ts/PG_10_201707211/1 %s/stat && cd %s && "
+            "mkdir -p base/1 global pg_tblspc pg_wal/archive_status pg_xact && "
+            "touch PG_VERSION global/pg_control base/1/1000 base/1/1000_init base/1/1000_vm base/1/2000.1 pg_xact/0000"
+                " pg_wal/000000010000000000000001 pg_wal/archive_status/000000010000000000000001.ready"
+                " %s/ts/PG_10_201707211/1/3000 %s/stat/global.stat && "
+            "ln -s %s/ts pg_tblspc/16385 && ln -s ../stat pg_stat && "
+            "find .. -type d -exec chmod 700 {} + && find .. -type f -exec chmod 600 {} + && "
+            "find .. -type f -exec touch -m -d @1565282100 {} +",
+            strPtr(pgPath), testPath(), testPath(), strPtr(pgPath), testPath(), testPath(), testPath());
+
+        KeyValue *tablespaceMap = kvNew();
+        kvPut(tablespaceMap, varNewStrZ("16385"), varNewStrZ("ts1"));
+
+        TEST_RESULT_STR(
+            strPtr(infoManifestBuild(storageLocal(), pgPath, PG_VERSION_10, 201707211, true, tablespaceMap, NULL)),
+            strPtr(
+                strNewFmt(
+                    "[backup:target]\n"
+                    "pg_data={\"path\":\"%s\",\"type\":\"path\"}\n"
+                    "pg_data/pg_stat={\"path\":\"../stat\",\"type\":\"link\"}\n"
+                    "pg_tblspc/16385={\"path\":\"%s\",\"tablespace-id\":\"16385\",\"tablespace-name\":\"ts1\""
+                        ",\"type\":\"link\"}\n"
+                    "\n"
+                    "[target:file]\n"
+                    "pg_data/PG_VERSION={\"master\":true,\"size\":0,\"timestamp\":1565282100}\n"
+                    "pg_data/base/1/1000_init={\"size\":0,\"timestamp\":1565282100}\n"
+                    "pg_data/base/1/2000.1={\"size\":0,\"timestamp\":1565282100}\n"
+                    "pg_data/global/pg_control={\"master\":true,\"size\":0,\"timestamp\":1565282100}\n"
+                    "pg_data/pg_stat/global.stat={\"master\":true,\"size\":0,\"timestamp\":1565282100}\n"
+                    "pg_data/pg_xact/0000={\"size\":0,\"timestamp\":1565282100}\n"
+                    "pg_tblspc/16385/PG_10_201707211/1/3000={\"size\":0,\"timestamp\":1565282100}\n"
+                    "\n"
+                    "[target:file:default]\n"
+                    "group=\"%s\"\n"
+                    "master=false\n"
+                    "mode=\"0600\"\n"
+                    "user=\"%s\"\n"
+                    "\n"
+                    "[target:link]\n"
+                    "pg_data/pg_stat={\"destination\":\"../stat\"}\n"
+                    "pg_data/pg_tblspc/16385={\"destination\":\"%s\"}\n"
+                    "\n"
+                    "[target:link:default]\n"
+                    "group=\"%s\"\n"
+                    "user=\"%s\"\n"
+                    "\n"
+                    "[target:path]\n"
+                    "pg_data={}\n"
+                    "pg_data/base={}\n"
+                    "pg_data/base/1={}\n"
+                    "pg_data/global={}\n"
+                    "pg_data/pg_stat={}\n"
+                    "pg_data/pg_tblspc={}\n"
+                    "pg_data/pg_wal={}\n"
+                    "pg_data/pg_wal/archive_status={}\n"
+                    "pg_data/pg_xact={}\n"
+                    "pg_tblspc={}\n"
+                    "pg_tblspc/16385={}\n"
+                    "pg_tblspc/16385/PG_10_201707211={}\n"
+                    "pg_tblspc/16385/PG_10_201707211/1={}\n"
+                    "\n"
+                    "[target:path:default]\n"
+                    "group=\"%s\"\n"
+                    "mode=\"0700\"\n"
+                    "user=\"%s\"\n",
+                    strPtr(pgPath), strPtr(strNewFmt("%s/ts", testPath())), group, user,
+                    strPtr(strNewFmt("%s/ts", testPath())), group, user, group, user)),
+            "build manifest");
+
+        // Tablespace missing from the map
+        //--------------------------------------------------------------------------------------------------------------------------
+        TEST_ERROR(
+            infoManifestBuild(storageLocal(), pgPath, PG_VERSION_10, 201707211, true, kvNew(), NULL), AssertError,
+            "tablespace with oid 16385 not found in tablespace map\n"
+                "HINT: was a tablespace created or dropped during the backup?");
+
+        // Links that reference the same path
+        //--------------------------------------------------------------------------------------------------------------------------
+        TEST_SYSTEM_FMT("ln -s ../stat %s/pg_stat2", strPtr(pgPath));
+
+        TEST_ERROR_FMT(
+            infoManifestBuild(storageLocal(), pgPath, PG_VERSION_10, 201707211, true, tablespaceMap, NULL), LinkDestinationError,
+            "link %s/pg_stat2 (../stat) references a subdirectory of or the same directory as link %s/pg_stat (../stat)",
+            strPtr(pgPath), strPtr(pgPath));
+
+        TEST_SYSTEM_FMT("rm %s/pg_stat2", strPtr(pgPath));
+
+        // Link to a link
+        //--------------------------------------------------------------------------------------------------------------------------
+        TEST_SYSTEM_FMT("ln -s stat %s/stat-link && ln -s ../stat-link %s/pg_stat2", testPath(), strPtr(pgPath));
+
+        TEST_ERROR_FMT(
+            infoManifestBuild(storageLocal(), pgPath, PG_VERSION_10, 201707211, true, tablespaceMap, NULL), LinkDestinationError,
+            "link '%s/pg_stat2' -> '../stat-link' cannot reference another link", strPtr(pgPath));
+
+        TEST_SYSTEM_FMT("rm %s/pg_stat2 %s/stat-link", strPtr(pgPath), testPath());
+
+        // Link loop
+        //--------------------------------------------------------------------------------------------------------------------------
+        TEST_SYSTEM_FMT("ln -s ../stat %s/stat/loop", testPath());
+
+        TEST_ERROR(
+            infoManifestBuild(storageLocal(), pgPath, PG_VERSION_10, 201707211, true, tablespaceMap, NULL), FormatError,
+            "recursion in manifest build exceeds depth of 16: pg_data/pg_stat/loop/loop/loop/loop/loop/loop/loop/loop/loop/loop/loop"
+                "/loop/loop/loop/loop\n"
+            "HINT: is there a link loop in $PGDATA?");
+
+        TEST_SYSTEM_FMT("rm %s/stat/loop", testPath());
+
+        // Tablespace in PGDATA
+        //--------------------------------------------------------------------------------------------------------------------------
+        TEST_SYSTEM_FMT("ln -s %s/base %s/pg_tblspc/1", strPtr(pgPath), strPtr(pgPath));
+
+        TEST_ERROR_FMT(
+            infoManifestBuild(storageLocal(), pgPath, PG_VERSION_10, 201707211, true, NULL, NULL), TablespaceInPgdataError,
+            "tablespace symlink %s/base destination must not be in $PGDATA", strPtr(pgPath));
+
+        TEST_SYSTEM_FMT("rm %s/pg_tblspc/1 && ln -s ../base %s/pg_tblspc/1", strPtr(pgPath), strPtr(pgPath));
+
+        TEST_ERROR(
+            infoManifestBuild(storageLocal(), pgPath, PG_VERSION_10, 201707211, true, NULL, NULL), TablespaceInPgdataError,
+            "tablespace symlink ../base destination must not be in $PGDATA");
+
+        // File in pg_tblspc
+        //--------------------------------------------------------------------------------------------------------------------------
+        TEST_SYSTEM_FMT("rm %s/pg_tblspc/1 && touch %s/pg_tblspc/1", strPtr(pgPath), strPtr(pgPath));
+
+        TEST_ERROR(
+            infoManifestBuild(storageLocal(), pgPath, PG_VERSION_10, 201707211, true, NULL, NULL), LinkExpectedError,
+            "pg_tblspc/1 is not a symlink - pg_tblspc should contain only symlinks");
+
+        TEST_SYSTEM_FMT("rm -rf %s %s/ts %s/stat", strPtr(pgPath), testPath(), testPath());
+
+        // Offline 8.4 cluster where tablespace files are stored directly in the link destination and relations are not filtered
+        //--------------------------------------------------------------------------------------------------------------------------
+        TEST_SYSTEM_FMT(
+            "mkdir -p %s/base/1 %s/global %s/pg_tblspc %s/ts && cd %s && "
+            "touch PG_VERSION global/pg_control base/1/t1_1000 base/1/1000_init base/1/1000 %s/ts/2000 && "
+            "ln -s %s/ts pg_tblspc/16386 && "
+            "find .. -type d -exec chmod 700 {} + && find .. -type f -exec chmod 600 {} + && chmod 640 global/pg_control && "
+            "find .. -type f -exec touch -m -d @1565282100 {} +",
+            strPtr(pgPath), strPtr(pgPath), strPtr(pgPath), testPath(), strPtr(pgPath), testPath(), testPath());
+
+        TEST_RESULT_STR(
+            strPtr(infoManifestBuild(storageLocal(), pgPath, PG_VERSION_84, 200904091, false, NULL, NULL)),
+            strPtr(
+                strNewFmt(
+                    "[backup:target]\n"
+                    "pg_data={\"path\":\"%s\",\"type\":\"path\"}\n"
+                    "pg_tblspc/16386={\"path\":\"%s\",\"tablespace-id\":\"16386\",\"tablespace-name\":\"ts16386\""
+                        ",\"type\":\"link\"}\n"
+                    "\n"
+                    "[target:file]\n"
+                    "pg_data/PG_VERSION={\"master\":true,\"size\":0,\"timestamp\":1565282100}\n"
+                    "pg_data/base/1/1000={\"size\":0,\"timestamp\":1565282100}\n"
+                    "pg_data/base/1/1000_init={\"size\":0,\"timestamp\":1565282100}\n"
+                    "pg_data/base/1/t1_1000={\"size\":0,\"timestamp\":1565282100}\n"
+                    "pg_data/global/pg_control={\"master\":true,\"mode\":\"0640\",\"size\":0,\"timestamp\":1565282100}\n"
+                    "pg_tblspc/16386/2000={\"size\":0,\"timestamp\":1565282100}\n"
+                    "\n"
+                    "[target:file:default]\n"
+                    "group=\"%s\"\n"
+                    "master=false\n"
+                    "mode=\"0600\"\n"
+                    "user=\"%s\"\n"
+                    "\n"
+                    "[target:link]\n"
+                    "pg_data/pg_tblspc/16386={\"destination\":\"%s\"}\n"
+                    "\n"
+                    "[target:link:default]\n"
+                    "group=\"%s\"\n"
+                    "user=\"%s\"\n"
+                    "\n"
+                    "[target:path]\n"
+                    "pg_data={}\n"
+                    "pg_data/base={}\n"
+                    "pg_data/base/1={}\n"
+                    "pg_data/global={}\n"
+                    "pg_data/pg_tblspc={}\n"
+                    "pg_tblspc={}\n"
+                    "pg_tblspc/16386={}\n"
+                    "\n"
+                    "[target:path:default]\n"
+                    "group=\"%s\"\n"
+                    "mode=\"0700\"\n"
+                    "user=\"%s\"\n",
+                    strPtr(pgPath), strPtr(strNewFmt("%s/ts", testPath())), group, user,
+                    strPtr(strNewFmt("%s/ts", testPath())), group, user, group, user)),
+            "build manifest");
+
+        TEST_SYSTEM_FMT("rm -rf %s %s/ts", strPtr(pgPath), testPath());
+    }
+
+    // *****************************************************************************************************************************
+    if (testBegin("infoManifestNewLoad(), infoManifestFileAdd(), and infoManifestSave()"))
+    {
+        // Manifest built with files added one at a time
+        //--------------------------------------------------------------------------------------------------------------------------
+        const char *content =
+            "[backrest]\n"
+            "backrest-checksum=\"7e04a71d0ac7fcb919ea8999f8d74097da1b6558\"\n"
+            "backrest-format=5\n"
+            "backrest-version=\"2.14\"\n"
+            "\n"
+            "[backup]\n"
+            "backup-label=\"20190818-084502F\"\n"
+            "\n"
+            "[target:file]\n"
+            "pg_data/PG_VERSION={\"checksum\":\"184473f470864e067ee3a22e64b47b0a1c356f29\",\"size\":3,\"timestamp\":1565282101}\n"
+            "pg_data/base/1/1000={\"reference\":\"20190818-084502F\",\"size\":8192,\"timestamp\":1565282100}\n"
+            "pg_data/base/1/2000={\"checksum\":\"da39a3ee5e6b4b0d3255bfef95601890afd80709\",\"reference\":\"20190818-084502F\""
+                ",\"size\":0,\"timestamp\":1565282100}\n"
+            "\n"
+            "[target:file:default]\n"
+            "master=false\n";
+
+        InfoManifest *manifest = NULL;
+
+        TEST_ASSIGN(manifest, infoManifestNew(), "new manifest");
+        TEST_RESULT_VOID(
+            iniSet(infoManifestIni(manifest), strNew("backrest"), strNew("backrest-format"), varNewStrZ("5")), "set format");
+        iniSet(infoManifestIni(manifest), strNew("backrest"), strNew("backrest-version"), varNewStrZ("\"2.14\""));
+        iniSet(infoManifestIni(manifest), strNew("backup"), strNew("backup-label"), varNewStrZ("\"20190818-084502F\""));
+        iniSet(infoManifestIni(manifest), strNew("target:file:default"), strNew("master"), varNewStrZ("false"));
+
+        TEST_RESULT_VOID(
+            infoManifestFileAdd(
+                manifest,
+                &(InfoManifestFile){.name = strNew("pg_data/PG_VERSION"), .size = 3, .timestamp = 1565282101,
+                    .checksum = strNew("184473f470864e067ee3a22e64b47b0a1c356f29")}),
+            "add file with checksum");
+        TEST_RESULT_VOID(
+            infoManifestFileAdd(
+                manifest,
+                &(InfoManifestFile){.name = strNew("pg_data/base/1/1000"), .size = 8192, .timestamp = 1565282100,
+                    .reference = strNew("20190818-084502F")}),
+            "add file with reference");
+        TEST_RESULT_VOID(
+            infoManifestFileAdd(
+                manifest,
+                &(InfoManifestFile){.name = strNew("pg_data/base/1/2000"), .size = 0, .timestamp = 1565282100,
+                    .checksum = strNew("da39a3ee5e6b4b0d3255bfef95601890afd80709"), .reference = strNew("20190818-084502F")}),
+            "add file with checksum and reference");
+
+        TEST_ERROR(
+            infoManifestFileAdd(manifest, &(InfoManifestFile){.name = strNew("bogus"), .checksum = strNew("xyz")}), AssertError,
+            "invalid checksum 'xyz' for file 'bogus'");
+
+        TEST_RESULT_STR(testManifestSave(manifest), content, "save manifest");
+        TEST_RESULT_VOID(infoManifestFree(manifest), "free manifest");
+
+        TEST_ASSIGN(manifest, testManifestLoad(content), "load manifest");
+        TEST_RESULT_UINT(infoManifestFileTotal(manifest), 3, "    file total");
+        TEST_RESULT_STR(strPtr(infoManifestChecksum(manifest)), "7e04a71d0ac7fcb919ea8999f8d74097da1b6558", "    checksum");
+
+        InfoManifestFile file = infoManifestFile(manifest, 0);
+        TEST_RESULT_STR(strPtr(file.name), "pg_data/PG_VERSION", "    file name");
+        TEST_RESULT_UINT(file.size, 3, "    file size");
+        TEST_RESULT_INT(file.timestamp, 1565282101, "    file timestamp");
+        TEST_RESULT_STR(strPtr(file.checksum), "184473f470864e067ee3a22e64b47b0a1c356f29", "    file checksum");
+        TEST_RESULT_PTR(file.reference, NULL, "    file reference");
+
+        file = infoManifestFile(manifest, 1);
+        TEST_RESULT_STR(strPtr(file.name), "pg_data/base/1/1000", "    file name");
+        TEST_RESULT_PTR(file.checksum, NULL, "    file checksum");
+        TEST_RESULT_STR(strPtr(file.reference), "20190818-084502F", "    file reference");
+
+        TEST_RESULT_STR(testManifestSave(manifest), content, "save loaded manifest");
+        TEST_RESULT_VOID(infoManifestFree(manifest), "free manifest");
+
+        // Values that cannot be stored in columns are preserved exactly
+        //--------------------------------------------------------------------------------------------------------------------------
+        content =
+            "[backrest]\n"
+            "backrest-checksum=\"cedab14513dcbcb6b09c2154c7e52146a7d13681\"\n"
+            "backrest-format=5\n"
+            "backrest-version=\"2.14\"\n"
+            "\n"
+            "[target:file]\n"
+            "PG_VERSION={\"checksum\":\"ABCDEF0123456789ABCDEF0123456789ABCDEF01\",\"size\":\"3\",\"timestamp\":-5}\n"
+            "pg_data/base/1/1000={\"checksum\":1,\"checksum-page\":false,\"checksum-page-error\":[1,[3,5]],\"group\":\"gr\\\"oup\""
+                ",\"reference\":\"bad\\\\ref\",\"size\":-1,\"timestamp\":1565282100,\"user\":false}\n"
+            "pg_data/base/1/2000={\"checksum\":\"da39a3ee5e6b4b0d3255bfef95601890afd80709\",\"master\":true"
+                ",\"nested\":{\"a\":[{\"b\":\"}\"}]},\"reference\":\"20190818-084502F\",\"repo-size\":10"
+                ",\"size\":123456789012345678901234567890123,\"timestamp\":1565282100}\n"
+            "pg_data/base/1/sub/3000={\"reference\":\"20190818-084502F\",\"size\":0,\"timestamp\":1565282100}\n"
+            "pg_data/base/1/zzz={\"master\":true,\"nested\":{\"a\":[{\"b\":\"}\"}]},\"repo-size\":10"
+                ",\"size\":123456789012345678901234567890123,\"timestamp\":1}\n";
+
+        TEST_ASSIGN(manifest, testManifestLoad(content), "load manifest");
+        TEST_RESULT_UINT(infoManifestFileTotal(manifest), 5, "    file total");
+
+        file = infoManifestFile(manifest, 0);
+        TEST_RESULT_STR(strPtr(file.name), "PG_VERSION", "    file with no path");
+        TEST_RESULT_PTR(file.checksum, NULL, "    invalid checksum is not a column");
+
+        file = infoManifestFile(manifest, 3);
+        TEST_RESULT_STR(strPtr(file.name), "pg_data/base/1/sub/3000", "    file name");
+        TEST_RESULT_UINT(file.size, 0, "    file size");
+
+        TEST_RESULT_STR(testManifestSave(manifest), content, "save manifest");
+        TEST_RESULT_VOID(infoManifestFree(manifest), "free manifest");
+        TEST_RESULT_VOID(infoManifestFree(NULL), "free null manifest");
+
+        // Values that are not valid for a column are preserved exactly, even when the JSON is not valid
+        //--------------------------------------------------------------------------------------------------------------------------
+        content =
+            "[backrest]\n"
+            "backrest-checksum=\"cc6987436741d4903ae449276987b0a58a22cde5\"\n"
+            "backrest-format=5\n"
+            "\n"
+            "[target:file]\n"
+            "p1/a={\"checksum\":10,\"reference\":1,\"size\":-,\"timestamp\":-}\n"
+            "p2/b={\"checksum\":\"g000000000000000000000000000000000000000\",\"reference\":\"x\"y,\"timestamp\":\"x\"}\n"
+            "p2/c={\"checksum\":\"!000000000000000000000000000000000000000\",\"reference\":false}\n"
+            "p2/d={\"reference\":\"r1\"}\n"
+            "p2/e={\"reference\":\"r2\"}\n"
+            "p2/f={\"reference\":\"r2\"}\n";
+
+        TEST_ASSIGN(manifest, testManifestLoad(content), "load manifest");
+        TEST_RESULT_STR(strPtr(infoManifestFile(manifest, 5).reference), "r2", "    file reference");
+
+        // Save with a small buffer so the manifest is written in more than one write
+        size_t bufferSizeOld = ioBufferSize();
+        ioBufferSizeSet(64);
+
+        TEST_RESULT_STR(testManifestSave(manifest), content, "save manifest");
+
+        ioBufferSizeSet(bufferSizeOld);
+
+        // Empty manifest
+        //--------------------------------------------------------------------------------------------------------------------------
+        TEST_RESULT_STR(
+            testManifestSave(infoManifestNew()), "[backrest]\nbackrest-checksum=\"8022a89338ba62e1d66ca83d3a7d4db887dab524\"\n",
+            "save empty manifest");
+
+        // Errors
+        //--------------------------------------------------------------------------------------------------------------------------
+        TEST_ERROR(
+            testManifestLoad("[backrest]\nbackrest-format=5\n"), ChecksumError,
+            "invalid manifest checksum, expected \"a3765a8c2c1e5d35274a0b0ce118f4031faff0bd\" but found none");
+        TEST_ERROR(
+            testManifestLoad("[backrest]\nbackrest-checksum=\"BOGUS\"\nbackrest-format=5\n"), ChecksumError,
+            "invalid manifest checksum, expected \"a3765a8c2c1e5d35274a0b0ce118f4031faff0bd\" but found \"BOGUS\"");
+        TEST_ERROR(
+            testManifestLoad("[backrest]\nbackrest-checksum=\"c8c08d0df6cc92ad66aad6a4fd2aea511c8f1e3e\"\nbackrest-format=4\n"),
+            FormatError, "invalid manifest format, expected 5 but found 4");
+
+        TEST_ERROR(testManifestLoad("[target:file]\nfile=[]\n"), FormatError, "invalid JSON object '[]'");
+        TEST_ERROR(testManifestLoad("[target:file]\nfile={}x\n"), FormatError, "invalid JSON object '{}x'");
+        TEST_ERROR(testManifestLoad("[target:file]\nfile={a:1}\n"), FormatError, "invalid JSON object '{a:1}'");
+        TEST_ERROR(testManifestLoad("[target:file]\nfile={\"a\n"), FormatError, "invalid JSON object '{\"a'");
+        TEST_ERROR(testManifestLoad("[target:file]\nfile={\"a\"1}\n"), FormatError, "invalid JSON object '{\"a\"1}'");
+        TEST_ERROR(testManifestLoad("[target:file]\nfile={\"a\":}\n"), FormatError, "invalid JSON object '{\"a\":}'");
+        TEST_ERROR(testManifestLoad("[target:file]\nfile={\"a\":1\n"), FormatError, "invalid JSON object '{\"a\":1'");
+        TEST_ERROR(testManifestLoad("[target:file]\nfile={\"a\":\"\\\n"), FormatError, "invalid JSON object '{\"a\":\"\\'");
+    }
+
+    // *****************************************************************************************************************************
+    if (testBegin("infoManifestSaveSidecar()"))
+    {
+        InfoManifest *manifest = infoManifestNew();
+
+        TEST_RESULT_PTR(infoManifestChecksum(manifest), NULL, "no checksum before save");
+        TEST_ERROR(
+            infoManifestSaveSidecar(manifest, ioBufferWriteIo(ioBufferWriteNew(bufNew(0)))), AssertError,
+            "manifest must be loaded or saved before the sidecar is saved");
+
+        // Files are added out of order and share a reference
+        infoManifestFileAdd(
+            manifest,
+            &(InfoManifestFile){.name = strNew("pg_data/global/1"), .size = 1, .timestamp = -1,
+                .reference = strNew("20190818-084502F")});
+        infoManifestFileAdd(
+            manifest,
+            &(InfoManifestFile){.name = strNew("pg_data/PG_VERSION"), .size = 3, .timestamp = 1565282101,
+                .checksum = strNew("184473f470864e067ee3a22e64b47b0a1c356f29")});
+        infoManifestFileAdd(
+            manifest,
+            &(InfoManifestFile){.name = strNew("pg_data/base/1/1000"), .size = 8192, .timestamp = 1565282100,
+                .reference = strNew("20190818-084502F")});
+
+        // Save the manifest so it has a checksum
+        const char *content = testManifestSave(manifest);
+
+        Buffer *sidecar = bufNew(0);
+        TEST_RESULT_VOID(infoManifestSaveSidecar(manifest, ioBufferWriteIo(ioBufferWriteNew(sidecar))), "save sidecar");
+
+        const char *pool = "pg_data/PG_VERSIONpg_data/base/1/100020190818-084502Fpg_data/global/1";
+
+        TEST_RESULT_UINT(
+            bufUsed(sidecar), sizeof(InfoManifestSidecarHeader) + 3 * sizeof(InfoManifestSidecarFile) + strlen(pool),
+            "    sidecar size");
+
+        const InfoManifestSidecarHeader *header = (const InfoManifestSidecarHeader *)bufPtr(sidecar);
+        TEST_RESULT_STR(header->magic, INFO_MANIFEST_SIDECAR_MAGIC, "    magic");
+        TEST_RESULT_UINT(header->version, INFO_MANIFEST_SIDECAR_VERSION, "    version");
+        TEST_RESULT_UINT(header->fileTotal, 3, "    file total");
+        TEST_RESULT_UINT(header->poolSize, strlen(pool), "    pool size");
+        TEST_RESULT_STR(
+            strPtr(strNewN(header->manifestChecksum, sizeof(header->manifestChecksum))),
+            strPtr(strSubN(strNew(content), strlen("[backrest]\nbackrest-checksum=\""), sizeof(header->manifestChecksum))),
+            "    manifest checksum");
+        TEST_RESULT_STR(
+            strPtr(infoManifestChecksum(manifest)), strPtr(strNewN(header->manifestChecksum, sizeof(header->manifestChecksum))),
+            "    manifest checksum is stored");
+
+        const InfoManifestSidecarFile *file = (const InfoManifestSidecarFile *)(header + 1);
+        TEST_RESULT_STR(strPtr(strNewN((const char *)(file + 3), header->poolSize)), pool, "    pool");
+
+        TEST_RESULT_UINT(file[0].nameOffset, 0, "    file 0 name offset");
+        TEST_RESULT_UINT(file[0].nameSize, 18, "    file 0 name size");
+        TEST_RESULT_UINT(file[0].size, 3, "    file 0 size");
+        TEST_RESULT_INT(file[0].timestamp, 1565282101, "    file 0 timestamp");
+        TEST_RESULT_UINT(file[0].flag, INFO_MANIFEST_SIDECAR_FLAG_CHECKSUM, "    file 0 has checksum");
+        TEST_RESULT_STR(
+            strPtr(bufHex(bufNewC(sizeof(file[0].checksum), file[0].checksum))), "184473f470864e067ee3a22e64b47b0a1c356f29",
+            "    file 0 checksum");
+        TEST_RESULT_UINT(file[0].referenceSize, 0, "    file 0 has no reference");
+
+        TEST_RESULT_UINT(file[1].nameOffset, 18, "    file 1 name offset");
+        TEST_RESULT_UINT(file[1].flag, 0, "    file 1 has no checksum");
+        TEST_RESULT_UINT(file[1].referenceOffset, 37, "    file 1 reference offset");
+        TEST_RESULT_UINT(file[1].referenceSize, 16, "    file 1 reference size");
+
+        TEST_RESULT_UINT(file[2].nameOffset, 53, "    file 2 name offset");
+        TEST_RESULT_INT(file[2].timestamp, -1, "    file 2 timestamp");
+        TEST_RESULT_UINT(file[2].referenceOffset, 37, "    file 2 reference is shared");
+
+        TEST_RESULT_STR(
+            strPtr(bufHex(bufNewC(sizeof(header->checksum), header->checksum))),
+            strPtr(bufHex(cryptoHashOneC(HASH_TYPE_SHA1_STR, (const unsigned char *)file, bufUsed(sidecar) - sizeof(*header)))),
+            "    checksum");
+    }
+}
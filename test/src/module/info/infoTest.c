@@ -63,8 +63,7 @@ testRun(void)
         ioWriteFilterGroupSet(
             storageFileWriteIo(infoWrite),
             ioFilterGroupAdd(
-                ioFilterGroupNew(),
-                cipherBlockFilter(cipherBlockNew(cipherModeEncrypt, cipherTypeAes256Cbc, bufNewStr(strNew("12345678")), NULL))));
+                ioFilterGroupNew(), cipherFilter(cipherModeEncrypt, cipherTypeAes256Cbc, bufNewStr(strNew("12345678")))));
 
         storageRemoveNP(storageLocalWrite(), fileNameCopy);
         storagePutNP(
@@ -93,6 +92,27 @@ testRun(void)
         TEST_RESULT_STR(strPtr(infoFileName(info)), strPtr(fileName), "    infoFileName() is set");
         TEST_RESULT_STR(strPtr(infoCipherPass(info)), "ABCDEFGH", "    cipherPass is set");
 
+        // Encrypted with aes-256-gcm
+        //--------------------------------------------------------------------------------------------------------------------------
+        StorageFileRead *infoRead = storageNewReadNP(storageLocal(), fileName);
+
+        ioReadFilterGroupSet(
+            storageFileReadIo(infoRead),
+            ioFilterGroupAdd(
+                ioFilterGroupNew(), cipherFilter(cipherModeDecrypt, cipherTypeAes256Cbc, bufNewStr(strNew("12345678")))));
+
+        Buffer *infoPlain = storageGetNP(infoRead);
+
+        infoWrite = storageNewWriteNP(storageLocalWrite(), fileName);
+        ioWriteFilterGroupSet(
+            storageFileWriteIo(infoWrite),
+            ioFilterGroupAdd(
+                ioFilterGroupNew(), cipherFilter(cipherModeEncrypt, cipherTypeAes256Gcm, bufNewStr(strNew("12345678")))));
+        storagePutNP(infoWrite, infoPlain);
+
+        TEST_ASSIGN(info, infoNew(storageLocal(), fileName, cipherTypeAes256Gcm, strNew("12345678")), "infoNew() - load gcm file");
+        TEST_RESULT_STR(strPtr(infoCipherPass(info)), "ABCDEFGH", "    cipherPass is set");
+
         // Invalid format
         //--------------------------------------------------------------------------------------------------------------------------
         storageRemoveNP(storageLocalWrite(), fileName);
@@ -236,6 +256,39 @@ testRun(void)
 
         storageRemoveNP(storageLocalWrite(), fileNameCopy);
 
+        // Empty files
+        //--------------------------------------------------------------------------------------------------------------------------
+        storagePutNP(storageNewWriteNP(storageLocalWrite(), fileName), bufNew(0));
+        storagePutNP(storageNewWriteNP(storageLocalWrite(), fileNameCopy), bufNew(0));
+
+        TEST_ERROR(
+            infoNew(storageLocal(), fileName, cipherTypeNone, NULL), FormatError,
+            strPtr(
+                strNewFmt(
+                    "unable to load info file '%s/test.ini' or '%s/test.ini.copy':\n"
+                    "FormatError: section 'backrest', key 'backrest-checksum' does not exist\n"
+                    "FormatError: section 'backrest', key 'backrest-checksum' does not exist",
+                testPath(), testPath())));
+
+        storageRemoveNP(storageLocalWrite(), fileName);
+        storageRemoveNP(storageLocalWrite(), fileNameCopy);
+
+        // infoChecksum*()
+        //--------------------------------------------------------------------------------------------------------------------------
+        InfoChecksum *checksum = NULL;
+
+        TEST_ASSIGN(checksum, infoChecksumNew(), "new checksum");
+        TEST_RESULT_STR(strPtr(infoChecksumHex(checksum)), "bf21a9e8fbc5a3846fb05b4fa0859e0917b2202f", "    empty checksum");
+        TEST_RESULT_VOID(infoChecksumFree(checksum), "    free checksum");
+
+        TEST_ASSIGN(checksum, infoChecksumNew(), "new checksum");
+        infoChecksumAdd(checksum, INFO_SECTION_BACKREST_STR, INFO_KEY_CHECKSUM_STR, strNew("\"bogus\""));
+        infoChecksumAdd(checksum, INFO_SECTION_BACKREST_STR, INFO_KEY_FORMAT_STR, strNew("5"));
+        TEST_RESULT_STR(
+            strPtr(infoChecksumHex(checksum)), "a3765a8c2c1e5d35274a0b0ce118f4031faff0bd", "    checksum skips stored checksum");
+        TEST_RESULT_VOID(infoChecksumFree(checksum), "    free checksum");
+        TEST_RESULT_VOID(infoChecksumFree(NULL), "    free NULL checksum");
+
         // infoFree()
         //--------------------------------------------------------------------------------------------------------------------------
         TEST_RESULT_VOID(infoFree(info), "infoFree() - free info memory context");
@@ -1,6 +1,7 @@
 /***********************************************************************************************************************************
 Test Page Checksums
 ***********************************************************************************************************************************/
+#include "common/time.h"
 
 /***********************************************************************************************************************************
 Page data for testing -- use 8192 for page size since this is the most common value
@@ -41,6 +42,85 @@ testRun(void)
         TEST_RESULT_U16_HEX(pageChecksum(testPage(0), 999, TEST_PAGE_SIZE), 0x0EC3, "check for 0xFF filled page, block 999");
     }
 
+    // *****************************************************************************************************************************
+    if (testBegin("pageChecksumBlock() implementations"))
+    {
+        // Fill the pages with data that varies from row to row
+        for (unsigned int byteIdx = 0; byteIdx < TEST_PAGE_TOTAL * TEST_PAGE_SIZE; byteIdx++)
+            testPage(0)[byteIdx] = (unsigned char)((byteIdx * 7919 % 65521) % 251);
+
+        // Get the expected checksums from the portable implementation
+        uint16_t checksumExpected[TEST_PAGE_TOTAL];
+        pageChecksumRows = pageChecksumRowsPortable;
+
+        for (unsigned int pageIdx = 0; pageIdx < TEST_PAGE_TOTAL; pageIdx++)
+            checksumExpected[pageIdx] = pageChecksum(testPage(pageIdx), pageIdx, TEST_PAGE_SIZE);
+
+        // Each implementation supported by this CPU must produce the same checksums
+        for (unsigned int implIdx = 0; implIdx < PAGE_CHECKSUM_IMPL_TOTAL; implIdx++)
+        {
+            if (!pageChecksumImplSupported((PageChecksumImpl)implIdx))
+            {
+                TEST_LOG_FMT("%s not supported by this CPU", pageChecksumImplLocal[implIdx].name);
+                continue;
+            }
+
+            pageChecksumRows = pageChecksumImplLocal[implIdx].rows;
+
+            for (unsigned int pageIdx = 0; pageIdx < TEST_PAGE_TOTAL; pageIdx++)
+            {
+                TEST_RESULT_U16_HEX(
+                    pageChecksum(testPage(pageIdx), pageIdx, TEST_PAGE_SIZE), checksumExpected[pageIdx], "%s checksum for page %u",
+                    pageChecksumImplLocal[implIdx].name, pageIdx);
+            }
+        }
+
+        // The checksum is calculated as if pd_checksum were zero and the page is not modified
+        ((PageHeader)testPage(0))->pd_checksum = 0xAAAA;
+
+        TEST_RESULT_U16_HEX(pageChecksum(testPage(0), 0, TEST_PAGE_SIZE), checksumExpected[0], "pd_checksum is ignored");
+        TEST_RESULT_U16_HEX(((PageHeader)testPage(0))->pd_checksum, 0xAAAA, "pd_checksum is not modified");
+
+        // The best implementation is selected on first use
+        pageChecksumRows = NULL;
+
+        TEST_RESULT_U16_HEX(pageChecksum(testPage(1), 1, TEST_PAGE_SIZE), checksumExpected[1], "select implementation");
+        TEST_RESULT_BOOL(pageChecksumRows != NULL, true, "implementation selected");
+    }
+
+    // *****************************************************************************************************************************
+    if (testBegin("pageChecksumBlock() benchmark"))
+    {
+        // Report the throughput of each implementation.  Unit tests are built without optimization so the results are only useful
+        // for comparing implementations to each other.
+        unsigned int loopTotal = 256;
+        uint64_t byteTotal = (uint64_t)loopTotal * TEST_PAGE_TOTAL * TEST_PAGE_SIZE;
+
+        for (unsigned int implIdx = 0; implIdx < PAGE_CHECKSUM_IMPL_TOTAL; implIdx++)
+        {
+            if (!pageChecksumImplSupported((PageChecksumImpl)implIdx))
+                continue;
+
+            pageChecksumRows = pageChecksumImplLocal[implIdx].rows;
+            uint32_t checksumTotal = 0;
+            TimeMSec timeBegin = timeMSec();
+
+            for (unsigned int loopIdx = 0; loopIdx < loopTotal; loopIdx++)
+            {
+                for (unsigned int pageIdx = 0; pageIdx < TEST_PAGE_TOTAL; pageIdx++)
+                    checksumTotal += pageChecksum(testPage(pageIdx), pageIdx, TEST_PAGE_SIZE);
+            }
+
+            TimeMSec timeTotal = timeMSec() - timeBegin;
+
+            TEST_LOG_FMT(
+                "%s: %.2f GB/s (checksum total %u)", pageChecksumImplLocal[implIdx].name,
+                (double)byteTotal / (double)(timeTotal == 0 ? 1 : timeTotal) / 1000000.0, checksumTotal);
+        }
+
+        pageChecksumRows = NULL;
+    }
+
     // *****************************************************************************************************************************
     if (testBegin("pageChecksumTest()"))
     {
@@ -53,6 +53,18 @@ testServerProtocol(const String *command, const VariantList *paramList, Protocol
     FUNCTION_HARNESS_RESULT(BOOL, found);
 }
 
+/***********************************************************************************************************************************
+Create an opened read object for frame data
+***********************************************************************************************************************************/
+static IoRead *
+testFrameRead(const char *data, size_t size)
+{
+    IoRead *result = ioBufferReadIo(ioBufferReadNew(bufNewC(size, data)));
+    ioReadOpen(result);
+
+    return result;
+}
+
 /***********************************************************************************************************************************
 Test Run
 ***********************************************************************************************************************************/
@@ -148,6 +160,94 @@ testRun(void)
             "remote protocol params for local");
     }
 
+    // *****************************************************************************************************************************
+    if (testBegin("protocolFrameRead() and protocolFrameWrite()"))
+    {
+        Buffer *frameBuffer = bufNew(256);
+        IoWrite *write = ioBufferWriteIo(ioBufferWriteNew(frameBuffer));
+        ioWriteOpen(write);
+
+        TEST_RESULT_VOID(protocolFrameWrite(write, protocolFrameTypeResponse, varNewStr(strNew("abc"))), "write response");
+        TEST_RESULT_VOID(ioWriteFlush(write), "flush");
+        TEST_RESULT_STR(
+            strPtr(bufHex(bufNewC(bufUsed(frameBuffer), bufPtr(frameBuffer)))), "52000000087300000003616263", "    check frame");
+
+        bufUsedZero(frameBuffer);
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        Variant *data = varNewKv();
+        kvPut(varKv(data), varNewStrZ("bool"), varNewBool(true));
+        kvPut(varKv(data), varNewStrZ("double"), varNewDbl(1.5));
+        kvPut(varKv(data), varNewStrZ("int"), varNewInt(-1));
+        kvPut(varKv(data), varNewStrZ("int64"), varNewInt64(-9999999999));
+        kvPut(varKv(data), varNewStrZ("null"), NULL);
+        kvPut(varKv(data), varNewStrZ("str"), varNewStrZ("value"));
+        kvPut(varKv(data), varNewStrZ("str-null"), varNewStr(NULL));
+        kvPut(varKv(data), varNewStrZ("uint64"), varNewUInt64(UINT64_MAX));
+
+        VariantList *list = varLstNew();
+        varLstAdd(list, varNewStrZ("item"));
+        varLstAdd(list, varNewVarLst(NULL));
+        varLstAdd(list, varNewKv());
+        kvPut(varKv(data), varNewStrZ("list"), varNewVarLst(list));
+
+        TEST_RESULT_VOID(protocolFrameWrite(write, protocolFrameTypeCommand, data), "write command");
+        TEST_RESULT_VOID(
+            protocolFrameWrite(write, protocolFrameTypeResponse, varNewStr(strNewFmt("%01024d", 0))), "write large response");
+        TEST_RESULT_VOID(protocolFrameWriteBlock(write, bufNewStr(strNew("DATA"))), "write block");
+        TEST_RESULT_VOID(protocolFrameWriteBlock(write, bufNew(0)), "write empty block");
+        TEST_RESULT_VOID(protocolFrameWriteBlock(write, NULL), "write null block");
+        TEST_RESULT_VOID(ioWriteFlush(write), "flush");
+
+        IoRead *read = ioBufferReadIo(ioBufferReadNew(frameBuffer));
+        ioReadOpen(read);
+
+        ProtocolFrameType type = 0;
+
+        TEST_ASSIGN(data, protocolFrameRead(read, &type), "read command");
+        TEST_RESULT_INT(type, protocolFrameTypeCommand, "    check type");
+        TEST_RESULT_STR(
+            strPtr(varToJson(data, 0)),
+            "{\"bool\":true,\"double\":1.5,\"int\":-1,\"int64\":-9999999999,\"list\":[\"item\",null,{}],\"null\":null,"
+                "\"str\":\"value\",\"str-null\":null,\"uint64\":18446744073709551615}",
+            "    check data");
+        TEST_RESULT_INT(varType(kvGet(varKv(data), varNewStrZ("int64"))), varTypeInt64, "    check int64 type");
+        TEST_RESULT_INT(varType(kvGet(varKv(data), varNewStrZ("uint64"))), varTypeUInt64, "    check uint64 type");
+
+        TEST_RESULT_UINT(strSize(varStr(protocolFrameRead(read, &type))), 1024, "read large response");
+        TEST_RESULT_INT(type, protocolFrameTypeResponse, "    check type");
+
+        Buffer *block = bufNew(4);
+
+        TEST_RESULT_SIZE(protocolFrameReadBlock(read), 4, "read block size");
+        TEST_RESULT_SIZE(ioRead(read, block), 4, "read block");
+        TEST_RESULT_STR(strPtr(strNewBuf(block)), "DATA", "    check block");
+        TEST_RESULT_SIZE(protocolFrameReadBlock(read), 0, "read empty block size");
+        TEST_RESULT_SIZE(protocolFrameReadBlock(read), 0, "read null block size");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_ERROR(protocolFrameRead(testFrameRead("", 0), &type), ProtocolError, "unexpected eof while reading frame");
+        TEST_ERROR(
+            protocolFrameRead(testFrameRead("R\0\0\0\x02n", 6), &type), ProtocolError, "unexpected eof while reading frame");
+        TEST_ERROR(protocolFrameRead(testFrameRead("X\0\0\0\0", 5), &type), ProtocolError, "invalid frame type 'X'");
+        TEST_ERROR(protocolFrameRead(testFrameRead("B\0\0\0\0", 5), &type), ProtocolError, "invalid frame type 'B'");
+        TEST_ERROR(protocolFrameRead(testFrameRead("R\0\0\0\0", 5), &type), ProtocolError, "frame data is truncated");
+        TEST_ERROR(
+            protocolFrameRead(testFrameRead("R\x04\0\0\x01", 5), &type), ProtocolError,
+            "frame size 67108865 exceeds maximum of 67108864 bytes");
+        TEST_ERROR(
+            protocolFrameRead(testFrameRead("C\xFF\xFF\xFF\xFF", 5), &type), ProtocolError,
+            "frame size 4294967295 exceeds maximum of 67108864 bytes");
+        TEST_ERROR(protocolFrameRead(testFrameRead("R\0\0\0\x01x", 6), &type), ProtocolError, "invalid frame data tag 'x'");
+        TEST_ERROR(
+            protocolFrameRead(testFrameRead("R\0\0\0\x02nn", 7), &type), ProtocolError, "frame has unexpected data after value");
+        TEST_ERROR(protocolFrameRead(testFrameRead("R\0\0\0\x02s\0", 7), &type), ProtocolError, "frame data is truncated");
+        TEST_ERROR(
+            protocolFrameRead(testFrameRead("R\0\0\0\x07k\0\0\0\x01nn", 12), &type), ProtocolError,
+            "frame key must not be null");
+        TEST_ERROR(protocolFrameReadBlock(testFrameRead("R\0\0\0\0", 5)), ProtocolError, "expected block frame");
+    }
+
     // *****************************************************************************************************************************
     if (testBegin("ProtocolCommand"))
     {
@@ -233,6 +333,55 @@ testRun(void)
 
                 // Wait for exit
                 TEST_RESULT_STR(strPtr(ioReadLine(read)), "{\"cmd\":\"exit\"}", "exit command");
+
+                // Greeting with binary frames
+                ioWriteLine(
+                    write,
+                    strNew(
+                        "{\"name\":\"pgBackRest\",\"service\":\"test\",\"version\":\"" PROJECT_VERSION "\",\"frame\":\"binary\"}"));
+                ioWriteFlush(write);
+
+                TEST_RESULT_STR(strPtr(ioReadLine(read)), "{\"cmd\":\"frame\",\"param\":[\"binary\"]}", "frame command");
+                ioWriteLine(write, strNew("{}"));
+                ioWriteFlush(write);
+
+                // Throw error
+                ProtocolFrameType type = 0;
+
+                TEST_RESULT_STR(
+                    strPtr(varToJson(protocolFrameRead(read, &type), 0)), "{\"cmd\":\"noop\"}", "noop with error text");
+                TEST_RESULT_INT(type, protocolFrameTypeCommand, "    check type");
+
+                Variant *error = varNewKv();
+                kvPut(varKv(error), varNewStr(PROTOCOL_ERROR_STR), varNewInt(25));
+                kvPut(varKv(error), varNewStr(PROTOCOL_OUTPUT_STR), varNewStrZ("sample error message"));
+                protocolFrameWrite(write, protocolFrameTypeError, error);
+                ioWriteFlush(write);
+
+                // No output expected
+                TEST_RESULT_STR(
+                    strPtr(varToJson(protocolFrameRead(read, &type), 0)), "{\"cmd\":\"noop\"}", "noop with output returned");
+                protocolFrameWrite(write, protocolFrameTypeResponse, varNewStrZ("bogus"));
+                ioWriteFlush(write);
+
+                // Invalid frame type
+                TEST_RESULT_STR(
+                    strPtr(varToJson(protocolFrameRead(read, &type), 0)), "{\"cmd\":\"noop\"}", "noop with invalid frame");
+                protocolFrameWrite(write, protocolFrameTypeCommand, NULL);
+                ioWriteFlush(write);
+
+                // Send output
+                TEST_RESULT_STR(
+                    strPtr(varToJson(protocolFrameRead(read, &type), 0)), "{\"cmd\":\"test\",\"param\":[1]}", "test command");
+
+                VariantList *output = varLstNew();
+                varLstAdd(output, varNewStrZ("value1"));
+                varLstAdd(output, varNewUInt64(2));
+                protocolFrameWrite(write, protocolFrameTypeResponse, varNewVarLst(output));
+                ioWriteFlush(write);
+
+                // Wait for exit
+                TEST_RESULT_STR(strPtr(varToJson(protocolFrameRead(read, &type), 0)), "{\"cmd\":\"exit\"}", "exit command");
             }
             HARNESS_FORK_CHILD_END();
 
@@ -277,6 +426,7 @@ testRun(void)
                 }
                 MEM_CONTEXT_TEMP_END();
 
+                TEST_RESULT_BOOL(protocolClientBinary(client), false, "check json");
                 TEST_RESULT_PTR(protocolClientIoRead(client), client->read, "get read io");
                 TEST_RESULT_PTR(protocolClientIoWrite(client), client->write, "get write io");
 
@@ -299,6 +449,27 @@ testRun(void)
                 // Free client
                 TEST_RESULT_VOID(protocolClientFree(client), "free client");
                 TEST_RESULT_VOID(protocolClientFree(NULL), "free null client");
+
+                // Binary frames
+                // -----------------------------------------------------------------------------------------------------------------
+                TEST_ASSIGN(client, protocolClientNew(strNew("test client"), strNew("test"), read, write), "create binary client");
+                TEST_RESULT_BOOL(protocolClientBinary(client), true, "check binary");
+
+                TEST_ERROR(protocolClientNoOp(client), AssertError, "raised from test client: sample error message");
+                TEST_ERROR(protocolClientNoOp(client), AssertError, "no output required by command");
+                TEST_ERROR(protocolClientNoOp(client), ProtocolError, "expected response frame but got 'C'");
+
+                TEST_ASSIGN(
+                    output,
+                    varVarLst(
+                        protocolClientExecute(
+                            client, protocolCommandParamAdd(protocolCommandNew(strNew("test")), varNewInt(1)), true)),
+                    "execute command with output");
+                TEST_RESULT_UINT(varLstSize(output), 2, "check output size");
+                TEST_RESULT_STR(strPtr(varStr(varLstGet(output, 0))), "value1", "check value1");
+                TEST_RESULT_UINT(varUInt64(varLstGet(output, 1)), 2, "check value2");
+
+                TEST_RESULT_VOID(protocolClientFree(client), "free client");
             }
             HARNESS_FORK_PARENT_END();
         }
@@ -319,7 +490,8 @@ testRun(void)
 
                 // Check greeting
                 TEST_RESULT_STR(
-                    strPtr(ioReadLine(read)), "{\"name\":\"pgBackRest\",\"service\":\"test\",\"version\":\"" PROJECT_VERSION "\"}",
+                    strPtr(ioReadLine(read)),
+                    "{\"frame\":\"binary\",\"name\":\"pgBackRest\",\"service\":\"test\",\"version\":\"" PROJECT_VERSION "\"}",
                     "check greeting");
 
                 // Noop
@@ -347,8 +519,58 @@ testRun(void)
                 TEST_RESULT_STR(strPtr(ioReadLine(read)), "{\"out\":false}", "complex request result");
                 TEST_RESULT_STR(strPtr(ioReadLine(read)), "LINEOFTEXT", "complex request result");
 
+                // Invalid frame
+                TEST_RESULT_VOID(ioWriteLine(write, strNew("{\"cmd\":\"frame\",\"param\":[\"bogus\"]}")), "write bogus frame");
+                TEST_RESULT_VOID(ioWriteFlush(write), "flush bogus frame");
+                TEST_RESULT_STR(strPtr(ioReadLine(read)), "{\"err\":39,\"out\":\"invalid frame 'bogus'\"}", "bogus frame error");
+
+                // Switch to binary frames
+                TEST_RESULT_VOID(ioWriteLine(write, strNew("{\"cmd\":\"frame\",\"param\":[\"binary\"]}")), "write frame");
+                TEST_RESULT_VOID(ioWriteFlush(write), "flush frame");
+                TEST_RESULT_STR(strPtr(ioReadLine(read)), "{}", "frame result");
+
+                // Simple request
+                ProtocolFrameType type = 0;
+
+                TEST_RESULT_VOID(
+                    protocolFrameWrite(
+                        write, protocolFrameTypeCommand, protocolCommandVar(protocolCommandNew(strNew("request-simple")))),
+                    "write simple request");
+                TEST_RESULT_VOID(ioWriteFlush(write), "flush simple request");
+                TEST_RESULT_BOOL(varBool(protocolFrameRead(read, &type)), true, "simple request result");
+                TEST_RESULT_INT(type, protocolFrameTypeResponse, "    check type");
+
+                // Noop
+                TEST_RESULT_VOID(
+                    protocolFrameWrite(
+                        write, protocolFrameTypeCommand, protocolCommandVar(protocolCommandNew(PROTOCOL_COMMAND_NOOP_STR))),
+                    "write noop");
+                TEST_RESULT_VOID(ioWriteFlush(write), "flush noop");
+                TEST_RESULT_PTR(protocolFrameRead(read, &type), NULL, "noop result");
+                TEST_RESULT_INT(type, protocolFrameTypeResponse, "    check type");
+
+                // Invalid command
+                TEST_RESULT_VOID(
+                    protocolFrameWrite(write, protocolFrameTypeCommand, protocolCommandVar(protocolCommandNew(strNew("bogus")))),
+                    "write bogus");
+                TEST_RESULT_VOID(ioWriteFlush(write), "flush bogus");
+                TEST_RESULT_STR(
+                    strPtr(varToJson(protocolFrameRead(read, &type), 0)), "{\"err\":39,\"out\":\"invalid command 'bogus'\"}",
+                    "bogus error");
+                TEST_RESULT_INT(type, protocolFrameTypeError, "    check type");
+
+                // Invalid frame type
+                TEST_RESULT_VOID(protocolFrameWrite(write, protocolFrameTypeResponse, NULL), "write response");
+                TEST_RESULT_VOID(ioWriteFlush(write), "flush response");
+                TEST_RESULT_STR(
+                    strPtr(varToJson(protocolFrameRead(read, &type), 0)),
+                    "{\"err\":39,\"out\":\"expected command frame but got 'R'\"}", "response error");
+
                 // Exit
-                TEST_RESULT_VOID(ioWriteLine(write, strNew("{\"cmd\":\"exit\"}")), "write exit");
+                TEST_RESULT_VOID(
+                    protocolFrameWrite(
+                        write, protocolFrameTypeCommand, protocolCommandVar(protocolCommandNew(PROTOCOL_COMMAND_EXIT_STR))),
+                    "write exit");
                 TEST_RESULT_VOID(ioWriteFlush(write), "flush exit");
             }
             HARNESS_FORK_CHILD_END();
@@ -381,6 +603,7 @@ testRun(void)
 
                 TEST_ERROR(protocolServerProcess(server), AssertError, "test assert");
                 TEST_RESULT_VOID(protocolServerProcess(server), "run process loop again");
+                TEST_RESULT_BOOL(protocolServerBinary(server), true, "check binary");
 
                 TEST_RESULT_VOID(protocolServerFree(server), "free server");
                 TEST_RESULT_VOID(protocolServerFree(NULL), "free null server");
@@ -479,7 +702,7 @@ testRun(void)
             {
                 // -----------------------------------------------------------------------------------------------------------------
                 ProtocolParallel *parallel = NULL;
-                TEST_ASSIGN(parallel, protocolParallelNew(2000), "create parallel");
+                TEST_ASSIGN(parallel, protocolParallelNew(2000, 1), "create parallel");
                 TEST_RESULT_STR(
                     strPtr(protocolParallelToLog(parallel)), "{state: pending, clientTotal: 0, jobTotal: 0}", "check log");
 
@@ -534,6 +757,9 @@ testRun(void)
                 TEST_RESULT_VOID(
                     protocolParallelJobAdd(parallel, protocolParallelJobNew(varNewStr(strNew("job3")), command)), "add job");
 
+                TEST_RESULT_STR(
+                    strPtr(protocolParallelToLog(parallel)), "{state: pending, clientTotal: 2, jobTotal: 3}", "check log");
+
                 // Process jobs
                 TEST_RESULT_INT(protocolParallelProcess(parallel), 0, "process jobs");
 
@@ -547,6 +773,8 @@ testRun(void)
                 TEST_RESULT_INT(varIntForce(protocolParallelJobResult(job)), 2, "check result is 2");
 
                 TEST_RESULT_PTR(protocolParallelResult(parallel), NULL, "check no more results");
+                TEST_RESULT_STR(
+                    strPtr(protocolParallelToLog(parallel)), "{state: running, clientTotal: 2, jobTotal: 2}", "check log");
 
                 // Process jobs
                 TEST_RESULT_INT(protocolParallelProcess(parallel), 1, "process jobs");
@@ -586,6 +814,92 @@ testRun(void)
             HARNESS_FORK_PARENT_END();
         }
         HARNESS_FORK_END();
+
+        // Multiple jobs per client
+        // -------------------------------------------------------------------------------------------------------------------------
+        HARNESS_FORK_BEGIN()
+        {
+            HARNESS_FORK_CHILD_BEGIN(0, true)
+            {
+                IoRead *read = ioHandleReadIo(ioHandleReadNew(strNew("server read"), HARNESS_FORK_CHILD_READ(), 10000));
+                ioReadOpen(read);
+                IoWrite *write = ioHandleWriteIo(ioHandleWriteNew(strNew("server write"), HARNESS_FORK_CHILD_WRITE()));
+                ioWriteOpen(write);
+
+                // Greeting with noop
+                ioWriteLine(write, strNew("{\"name\":\"pgBackRest\",\"service\":\"test\",\"version\":\"" PROJECT_VERSION "\"}"));
+                ioWriteFlush(write);
+
+                TEST_RESULT_STR(strPtr(ioReadLine(read)), "{\"cmd\":\"noop\"}", "noop");
+                ioWriteLine(write, strNew("{}"));
+                ioWriteFlush(write);
+
+                // Both commands are sent before any results are read.  Write both results at once so the second is buffered.
+                TEST_RESULT_STR(strPtr(ioReadLine(read)), "{\"cmd\":\"command1\"}", "command1");
+                TEST_RESULT_STR(strPtr(ioReadLine(read)), "{\"cmd\":\"command2\"}", "command2");
+                ioWriteLine(write, strNew("{\"out\":1}\n{\"out\":2}"));
+                ioWriteFlush(write);
+
+                TEST_RESULT_STR(strPtr(ioReadLine(read)), "{\"cmd\":\"command3\"}", "command3");
+                ioWriteLine(write, strNew("{\"out\":3}"));
+                ioWriteFlush(write);
+
+                // Wait for exit
+                TEST_RESULT_STR(strPtr(ioReadLine(read)), "{\"cmd\":\"exit\"}", "exit command");
+            }
+            HARNESS_FORK_CHILD_END();
+
+            HARNESS_FORK_PARENT_BEGIN()
+            {
+                ProtocolParallel *parallel = NULL;
+                TEST_ASSIGN(parallel, protocolParallelNew(2000, 2), "create parallel");
+
+                IoRead *read = ioHandleReadIo(ioHandleReadNew(strNew("client read"), HARNESS_FORK_PARENT_READ_PROCESS(0), 2000));
+                ioReadOpen(read);
+                IoWrite *write = ioHandleWriteIo(ioHandleWriteNew(strNew("client write"), HARNESS_FORK_PARENT_WRITE_PROCESS(0)));
+                ioWriteOpen(write);
+
+                ProtocolClient *client = NULL;
+                TEST_ASSIGN(client, protocolClientNew(strNew("test client"), strNew("test"), read, write), "create client");
+                TEST_RESULT_VOID(protocolParallelClientAdd(parallel, client), "add client");
+
+                for (unsigned int jobIdx = 1; jobIdx <= 3; jobIdx++)
+                {
+                    TEST_RESULT_VOID(
+                        protocolParallelJobAdd(
+                            parallel,
+                            protocolParallelJobNew(varNewInt((int)jobIdx), protocolCommandNew(strNewFmt("command%u", jobIdx)))),
+                        "add job %u", jobIdx);
+                }
+
+                // Two jobs are sent to the client and both results are read
+                TEST_RESULT_INT(protocolParallelProcess(parallel), 0, "process jobs");
+                TEST_RESULT_INT(protocolParallelProcess(parallel), 2, "process jobs");
+
+                ProtocolParallelJob *job = NULL;
+                TEST_ASSIGN(job, protocolParallelResult(parallel), "get result");
+                TEST_RESULT_INT(varInt(protocolParallelJobKey(job)), 1, "check key is 1");
+                TEST_RESULT_INT(varIntForce(protocolParallelJobResult(job)), 1, "check result is 1");
+                TEST_ASSIGN(job, protocolParallelResult(parallel), "get result");
+                TEST_RESULT_INT(varInt(protocolParallelJobKey(job)), 2, "check key is 2");
+                TEST_RESULT_INT(varIntForce(protocolParallelJobResult(job)), 2, "check result is 2");
+                TEST_RESULT_PTR(protocolParallelResult(parallel), NULL, "check no more results");
+
+                // The last job was sent after the results were read
+                TEST_RESULT_INT(protocolParallelProcess(parallel), 1, "process jobs");
+
+                TEST_ASSIGN(job, protocolParallelResult(parallel), "get result");
+                TEST_RESULT_INT(varInt(protocolParallelJobKey(job)), 3, "check key is 3");
+                TEST_RESULT_INT(varIntForce(protocolParallelJobResult(job)), 3, "check result is 3");
+
+                TEST_RESULT_BOOL(protocolParallelDone(parallel), true, "check done");
+
+                TEST_RESULT_VOID(protocolClientFree(client), "free client");
+                TEST_RESULT_VOID(protocolParallelFree(parallel), "free parallel");
+            }
+            HARNESS_FORK_PARENT_END();
+        }
+        HARNESS_FORK_END();
     }
 
     // *****************************************************************************************************************************
@@ -1,6 +1,9 @@
 /***********************************************************************************************************************************
 Test Posix Storage Driver
 ***********************************************************************************************************************************/
+#include <inttypes.h>
+#include <signal.h>
+
 #include "common/io/io.h"
 #include "common/time.h"
 #include "storage/fileRead.h"
@@ -9,6 +12,15 @@ Test Posix Storage Driver
 #include "common/harnessConfig.h"
 #include "common/harnessFork.h"
 
+/***********************************************************************************************************************************
+Signal handler that does nothing so a blocked read() or write() is interrupted
+***********************************************************************************************************************************/
+static void
+testSignalHandler(int signal)
+{
+    (void)signal;
+}
+
 /***********************************************************************************************************************************
 Test function for path expression
 ***********************************************************************************************************************************/
@@ -25,6 +37,30 @@ storageTestPathExpression(const String *expression, const String *path)
     return result;
 }
 
+/***********************************************************************************************************************************
+Test callbacks for storageListEach()
+***********************************************************************************************************************************/
+static void
+testListEachCallback(void *callbackData, const String *name, StorageInfo info)
+{
+    strLstAdd(
+        (StringList *)callbackData,
+        strNewFmt(
+            "%s {%s, %zu, %04o}", strPtr(name),
+            info.type == storageTypeFile ? "file" : (info.type == storageTypePath ? "path" : "link"), info.size,
+            (unsigned int)info.mode));
+}
+
+static void
+testListEachRemoveCallback(void *callbackData, const String *name, StorageInfo info)
+{
+    // Remove all files on the first call so entries that have already been read from the directory are missing
+    if (strLstSize((StringList *)callbackData) == 0 && system(strPtr(strNewFmt("rm %s/remove/*", testPath()))) != 0)
+        THROW(AssertError, "unable to remove files");
+
+    testListEachCallback(callbackData, name, info);
+}
+
 /***********************************************************************************************************************************
 Macro to create a path and file that cannot be accessed
 ***********************************************************************************************************************************/
@@ -211,6 +247,12 @@ testRun(void)
         TEST_RESULT_INT(info.type, storageTypeFile, "    check type");
         TEST_RESULT_INT(info.size, 8, "    check size");
         TEST_RESULT_INT(info.mode, 0640, "    check mode");
+        TEST_RESULT_UINT(info.userId, getuid(), "    check user");
+        TEST_RESULT_UINT(info.groupId, getgid(), "    check group");
+        TEST_RESULT_PTR(info.linkDestination, NULL, "    check link destination");
+
+        TEST_RESULT_INT(system(strPtr(strNewFmt("touch -m -d @1555160000 %s", strPtr(fileName)))), 0, "set file time");
+        TEST_RESULT_INT(storageInfoNP(storageTest, fileName).timeModified, 1555160000, "    check time modified");
 
         storageRemoveP(storageTest, fileName, .errorOnMissing = true);
 
@@ -223,6 +265,7 @@ testRun(void)
         TEST_RESULT_INT(info.type, storageTypeLink, "    check type");
         TEST_RESULT_INT(info.size, 0, "    check size");
         TEST_RESULT_INT(info.mode, 0777, "    check mode");
+        TEST_RESULT_STR(strPtr(info.linkDestination), "/tmp", "    check link destination");
 
         storageRemoveP(storageTest, linkName, .errorOnMissing = true);
 
@@ -270,6 +313,64 @@ testRun(void)
             strPtr(strLstJoin(storageListP(storageTest, NULL, .expression = strNew("^bbb")), ", ")), "bbb.txt", "dir list");
     }
 
+    // *****************************************************************************************************************************
+    if (testBegin("storageListEach()"))
+    {
+        TEST_CREATE_NOPERM();
+
+        StringList *list = strLstNew();
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_ERROR_FMT(
+            storageListEachP(storageTest, strNew(BOGUS_STR), testListEachCallback, list, .errorOnMissing = true), PathOpenError,
+            "unable to open path '%s/BOGUS' for read: [2] No such file or directory", testPath());
+
+        TEST_RESULT_BOOL(
+            storageListEachNP(storageTest, strNew(BOGUS_STR), testListEachCallback, list), false, "ignore missing dir");
+
+        TEST_ERROR_FMT(
+            storageListEachNP(storageTest, pathNoPerm, testListEachCallback, list), PathOpenError,
+            "unable to open path '%s' for read: [13] Permission denied", strPtr(pathNoPerm));
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_RESULT_VOID(storagePutNP(storageNewWriteNP(storageTest, strNew("aaa.txt")), bufNewZ("aaa")), "write aaa.text");
+        TEST_RESULT_INT(system(strPtr(strNewFmt("ln -s /tmp %s/link", testPath()))), 0, "create link");
+
+        TEST_RESULT_BOOL(storageListEachNP(storageTest, NULL, testListEachCallback, list), true, "list with info");
+        TEST_RESULT_STR(
+            strPtr(strLstJoin(strLstSort(list, sortOrderAsc), ", ")),
+            "aaa.txt {file, 3, 0640}, link {link, 0, 0777}, noperm {path, 0, 0700}", "    check list");
+
+        list = strLstNew();
+
+        TEST_RESULT_BOOL(
+            storageListEachP(storageTest, NULL, testListEachCallback, list, .expression = strNew("^aaa")), true,
+            "list with expression");
+        TEST_RESULT_STR(strPtr(strLstJoin(list, ", ")), "aaa.txt {file, 3, 0640}", "    check list");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_RESULT_INT(
+            system(strPtr(strNewFmt("mkdir %s/noexec && touch %s/noexec/file && chmod 600 %s/noexec", testPath(), testPath(),
+            testPath()))),
+            0, "create path that can be read but not searched");
+
+        TEST_ERROR_FMT(
+            storageListEachNP(storageTest, strNew("noexec"), testListEachCallback, list), FileOpenError,
+            "unable to get info for '%s/noexec/file': [13] Permission denied", testPath());
+
+        TEST_RESULT_INT(system(strPtr(strNewFmt("chmod 700 %s/noexec", testPath()))), 0, "reset permissions");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        storagePutNP(storageNewWriteNP(storageTest, strNew("remove/aaa")), NULL);
+        storagePutNP(storageNewWriteNP(storageTest, strNew("remove/bbb")), NULL);
+
+        list = strLstNew();
+
+        TEST_RESULT_BOOL(
+            storageListEachNP(storageTest, strNew("remove"), testListEachRemoveCallback, list), true, "list with removed files");
+        TEST_RESULT_UINT(strLstSize(list), 1, "    check removed file was skipped");
+    }
+
     // *****************************************************************************************************************************
     if (testBegin("storageCopy()"))
     {
@@ -723,6 +824,8 @@ testRun(void)
 
         TEST_ASSIGN(file, storageNewReadNP(storageTest, fileName), "new read file");
         TEST_RESULT_BOOL(ioReadOpen(storageFileReadIo(file)), true, "   open file");
+        TEST_RESULT_INT(
+            ioReadHandle(storageFileReadIo(file)), ((StorageDriverPosixFileRead *)file->driver)->handle, "   check handle");
 
         // Close the file handle so operations will fail
         close(((StorageDriverPosixFileRead *)file->driver)->handle);
@@ -782,6 +885,41 @@ testRun(void)
 
         TEST_RESULT_VOID(ioReadClose(storageFileReadIo(file)), "    close file");
 
+        // Read with an offset and/or limit
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_RESULT_STR(
+            strPtr(strNewBuf(storageGetNP(storageNewReadP(storageTest, fileName, .offset = 4)))), "FILE\n", "read with offset");
+        TEST_RESULT_STR(
+            strPtr(strNewBuf(storageGetNP(storageNewReadP(storageTest, fileName, .limit = varNewUInt64(4))))), "TEST",
+            "read with limit");
+        TEST_RESULT_STR(
+            strPtr(strNewBuf(storageGetNP(storageNewReadP(storageTest, fileName, .offset = 4, .limit = varNewUInt64(100))))),
+            "FILE\n", "read with limit past eof");
+        TEST_RESULT_STR(
+            strPtr(strNewBuf(storageGetNP(storageNewReadP(storageTest, fileName, .offset = 100)))), "",
+            "read with offset past eof");
+
+        TEST_ASSIGN(file, storageNewReadP(storageTest, fileName, .offset = 2, .limit = varNewUInt64(5)), "new read file");
+        TEST_RESULT_BOOL(ioReadOpen(storageFileReadIo(file)), true, "   open file");
+
+        bufUsedZero(buffer);
+
+        do
+        {
+            bufUsedZero(outBuffer);
+            ioRead(storageFileReadIo(file), outBuffer);
+            bufCat(buffer, outBuffer);
+        }
+        while (!ioReadEof(storageFileReadIo(file)));
+
+        TEST_RESULT_STR(strPtr(strNewBuf(buffer)), "STFIL", "    read with offset and limit in small buffers");
+        TEST_RESULT_VOID(ioReadClose(storageFileReadIo(file)), "    close file");
+
+        TEST_ASSIGN(file, storageNewReadP(storageTest, fileName, .offset = UINT64_MAX), "new read file with invalid offset");
+        TEST_ERROR_FMT(
+            ioReadOpen(storageFileReadIo(file)), FileOpenError, "unable to seek to %" PRIu64 " in '%s': [22] Invalid argument",
+            UINT64_MAX, strPtr(fileName));
+
         TEST_RESULT_VOID(storageFileReadFree(storageNewReadNP(storageTest, fileName)), "   free file");
         TEST_RESULT_VOID(storageFileReadFree(NULL), "   free null file");
         TEST_RESULT_VOID(storageDriverPosixFileReadFree(NULL), "   free null posix file");
@@ -917,6 +1055,218 @@ testRun(void)
         storageRemoveP(storageTest, fileName, .errorOnMissing = true);
     }
 
+    // *****************************************************************************************************************************
+    if (testBegin("StorageDriverPosixFileAsync"))
+    {
+        ioBufferSizeSet(2);
+
+        String *fileName = strNewFmt("%s/test.file", testPath());
+        Buffer *expectedBuffer = bufNewZ("ASYNC TEST FILE THAT IS MUCH LARGER THAN THE BUFFER SIZE\n");
+
+        // Errors from the pthread functions used to start the thread are thrown by threadError()
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_RESULT_VOID(threadError(0, "create thread"), "no thread error");
+        TEST_ERROR(
+            threadError(EAGAIN, "create thread"), KernelError, "unable to create thread: [11] Resource temporarily unavailable");
+
+        // Write behind starts after the first buffer and the data is written by close
+        // -------------------------------------------------------------------------------------------------------------------------
+        StorageFileWrite *fileWrite = NULL;
+
+        TEST_ASSIGN(fileWrite, storageNewWriteNP(storageTest, fileName), "new write file");
+        TEST_RESULT_VOID(ioWriteOpen(storageFileWriteIo(fileWrite)), "    open file");
+        TEST_RESULT_VOID(ioWrite(storageFileWriteIo(fileWrite), bufNewC(3, bufPtr(expectedBuffer))), "    write direct");
+        TEST_RESULT_PTR(((StorageDriverPosixFileWrite *)fileWrite->driver)->async, NULL, "    write behind not started");
+        TEST_RESULT_VOID(
+            ioWrite(storageFileWriteIo(fileWrite), bufNewC(bufUsed(expectedBuffer) - 3, bufPtr(expectedBuffer) + 3)),
+            "    write behind");
+        TEST_RESULT_BOOL(((StorageDriverPosixFileWrite *)fileWrite->driver)->async != NULL, true, "    write behind started");
+        TEST_RESULT_VOID(ioWriteClose(storageFileWriteIo(fileWrite)), "    close file");
+        TEST_RESULT_PTR(((StorageDriverPosixFileWrite *)fileWrite->driver)->async, NULL, "    write behind stopped");
+
+        TEST_RESULT_BOOL(
+            bufEq(storageGetNP(storageNewReadNP(storageTest, fileName)), expectedBuffer), true, "    check file contents");
+
+        // Read ahead starts after the first buffer and returns all the data
+        // -------------------------------------------------------------------------------------------------------------------------
+        StorageFileRead *fileRead = NULL;
+        Buffer *buffer = bufNew(bufUsed(expectedBuffer) + 1);
+
+        TEST_ASSIGN(fileRead, storageNewReadNP(storageTest, fileName), "new read file");
+        TEST_RESULT_BOOL(ioReadOpen(storageFileReadIo(fileRead)), true, "    open file");
+
+        bufLimitSet(buffer, 3);
+        TEST_RESULT_VOID(storageDriverPosixFileRead(storageFileReadDriver(fileRead), buffer, false), "    read direct");
+        TEST_RESULT_PTR(((StorageDriverPosixFileRead *)fileRead->driver)->async, NULL, "    read ahead not started");
+
+        bufLimitSet(buffer, 4);
+        TEST_RESULT_VOID(storageDriverPosixFileRead(storageFileReadDriver(fileRead), buffer, false), "    read part of a buffer");
+        TEST_RESULT_BOOL(((StorageDriverPosixFileRead *)fileRead->driver)->async != NULL, true, "    read ahead started");
+
+        bufLimitClear(buffer);
+        TEST_RESULT_VOID(storageDriverPosixFileRead(storageFileReadDriver(fileRead), buffer, false), "    read ahead");
+        TEST_RESULT_BOOL(bufEq(buffer, expectedBuffer), true, "    check contents");
+        TEST_RESULT_BOOL(((StorageDriverPosixFileRead *)fileRead->driver)->eof, true, "    eof");
+        TEST_RESULT_VOID(ioReadClose(storageFileReadIo(fileRead)), "    close file");
+        TEST_RESULT_PTR(((StorageDriverPosixFileRead *)fileRead->driver)->async, NULL, "    read ahead stopped");
+
+        TEST_RESULT_BOOL(
+            bufEq(storageGetNP(storageNewReadNP(storageTest, fileName)), expectedBuffer), true, "    check contents with get");
+
+        // Free while reading ahead, explicitly and when the mem context is freed
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_ASSIGN(fileRead, storageNewReadNP(storageTest, fileName), "new read file");
+        TEST_RESULT_BOOL(ioReadOpen(storageFileReadIo(fileRead)), true, "    open file");
+        TEST_RESULT_VOID(ioRead(storageFileReadIo(fileRead), bufNew(4)), "    read direct");
+        TEST_RESULT_VOID(ioRead(storageFileReadIo(fileRead), bufNew(4)), "    read ahead");
+
+        StorageDriverPosixFileAsync *async = ((StorageDriverPosixFileRead *)fileRead->driver)->async;
+        TEST_RESULT_BOOL(
+            strBeginsWithZ(storageDriverPosixFileAsyncToLog(async), "{write: false, bufferSize: 2, fillTotal: "), true,
+            "    check log");
+        TEST_RESULT_VOID(storageDriverPosixFileReadFree(storageFileReadDriver(fileRead)), "    free driver");
+
+        MEM_CONTEXT_TEMP_BEGIN()
+        {
+            TEST_ASSIGN(fileRead, storageNewReadNP(storageTest, fileName), "new read file");
+            TEST_RESULT_BOOL(ioReadOpen(storageFileReadIo(fileRead)), true, "    open file");
+            TEST_RESULT_VOID(ioRead(storageFileReadIo(fileRead), bufNew(4)), "    read direct");
+            TEST_RESULT_VOID(ioRead(storageFileReadIo(fileRead), bufNew(4)), "    read ahead");
+        }
+        MEM_CONTEXT_TEMP_END();
+
+        // Read error is reported once the data read before it has been returned
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_ASSIGN(fileRead, storageNewReadNP(storageTest, fileName), "new read file");
+        TEST_RESULT_BOOL(ioReadOpen(storageFileReadIo(fileRead)), true, "    open file");
+        TEST_RESULT_VOID(
+            storageDriverPosixFileRead(storageFileReadDriver(fileRead), bufNew(2), false), "    read direct");
+
+        // Replace the file with a directory so the next read fails
+        int handle = open(testPath(), O_RDONLY);
+        TEST_RESULT_INT(
+            dup2(handle, ((StorageDriverPosixFileRead *)fileRead->driver)->handle),
+            ((StorageDriverPosixFileRead *)fileRead->driver)->handle, "    replace handle");
+        close(handle);
+
+        TEST_ERROR_FMT(
+            storageDriverPosixFileRead(storageFileReadDriver(fileRead), bufNew(2), false), FileReadError,
+            "unable to read '%s': [21] Is a directory", strPtr(fileName));
+        TEST_RESULT_VOID(ioReadClose(storageFileReadIo(fileRead)), "    close file");
+
+        // Write error is reported by the next write or close
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_ASSIGN(fileWrite, storageNewWriteNP(storageTest, fileName), "new write file");
+        TEST_RESULT_VOID(ioWriteOpen(storageFileWriteIo(fileWrite)), "    open file");
+        TEST_RESULT_VOID(ioWrite(storageFileWriteIo(fileWrite), bufNewC(3, bufPtr(expectedBuffer))), "    write direct");
+
+        // Replace the file with a read-only file so writes fail
+        handle = open(strPtr(fileName), O_RDONLY);
+        TEST_RESULT_INT(
+            dup2(handle, ((StorageDriverPosixFileWrite *)fileWrite->driver)->handle),
+            ((StorageDriverPosixFileWrite *)fileWrite->driver)->handle, "    replace handle");
+        close(handle);
+
+        TEST_ERROR_FMT(
+            storageDriverPosixFileWrite(storageFileWriteFileDriver(fileWrite), expectedBuffer), FileWriteError,
+            "unable to write '%s': [9] Bad file descriptor", strPtr(fileName));
+
+        async = ((StorageDriverPosixFileWrite *)fileWrite->driver)->async;
+        TEST_RESULT_INT(storageDriverPosixFileAsyncFlush(async), EBADF, "    write failed");
+        TEST_RESULT_BOOL(
+            strEndsWithZ(storageDriverPosixFileAsyncToLog(async), ", drainTotal: 0, eof: false, error: 9}"), true, "    check log");
+
+        TEST_ERROR_FMT(
+            storageDriverPosixFileWrite(storageFileWriteFileDriver(fileWrite), bufNewC(3, bufPtr(expectedBuffer))),
+            FileWriteError, "unable to write '%s': [9] Bad file descriptor", strPtr(fileName));
+        TEST_ERROR_FMT(
+            storageDriverPosixFileWriteClose(storageFileWriteFileDriver(fileWrite)), FileWriteError,
+            "unable to write '%s': [9] Bad file descriptor", strPtr(fileName));
+        TEST_RESULT_VOID(storageFileWriteFree(fileWrite), "    free file");
+
+        // Free while writing behind, explicitly and when the mem context is freed
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_ASSIGN(fileWrite, storageNewWriteNP(storageTest, fileName), "new write file");
+        TEST_RESULT_VOID(ioWriteOpen(storageFileWriteIo(fileWrite)), "    open file");
+        TEST_RESULT_VOID(ioWrite(storageFileWriteIo(fileWrite), expectedBuffer), "    write direct");
+        TEST_RESULT_VOID(ioWrite(storageFileWriteIo(fileWrite), expectedBuffer), "    write behind");
+        TEST_RESULT_VOID(storageDriverPosixFileWriteFree(storageFileWriteFileDriver(fileWrite)), "    free driver");
+
+        MEM_CONTEXT_TEMP_BEGIN()
+        {
+            TEST_ASSIGN(fileWrite, storageNewWriteNP(storageTest, fileName), "new write file");
+            TEST_RESULT_VOID(ioWriteOpen(storageFileWriteIo(fileWrite)), "    open file");
+            TEST_RESULT_VOID(ioWrite(storageFileWriteIo(fileWrite), expectedBuffer), "    write direct");
+            TEST_RESULT_VOID(ioWrite(storageFileWriteIo(fileWrite), expectedBuffer), "    write behind");
+        }
+        MEM_CONTEXT_TEMP_END();
+
+        TEST_RESULT_VOID(storageDriverPosixFileAsyncFree(NULL), "    free null async");
+
+        // Interrupted and short reads and writes are retried.  A pipe is used so the thread blocks and can be interrupted.
+        // -------------------------------------------------------------------------------------------------------------------------
+        struct sigaction signalAction = {.sa_handler = testSignalHandler};
+        struct sigaction signalActionOld;
+        TEST_RESULT_INT(sigaction(SIGUSR1, &signalAction, &signalActionOld), 0, "set signal handler without restart");
+
+        int pipeHandle[2];
+        TEST_RESULT_INT(pipe(pipeHandle), 0, "create pipe");
+
+        // Interrupt the read while the pipe is empty
+        TEST_ASSIGN(async, storageDriverPosixFileAsyncNew(pipeHandle[0], false, 2), "new read ahead");
+        sleepMSec(100);
+        TEST_RESULT_INT(pthread_kill(async->thread, SIGUSR1), 0, "    interrupt read");
+        sleepMSec(100);
+
+        TEST_RESULT_INT(write(pipeHandle[1], "ab", 2), 2, "    write to pipe");
+        close(pipeHandle[1]);
+
+        buffer = bufNew(3);
+        TEST_RESULT_INT(storageDriverPosixFileAsyncRead(async, buffer), 0, "    read");
+        TEST_RESULT_STR(strPtr(strNewBuf(buffer)), "ab", "    check contents");
+        TEST_RESULT_VOID(storageDriverPosixFileAsyncFree(async), "    free");
+        close(pipeHandle[0]);
+
+        // Interrupt the write once the pipe is full so the write is short, then again so it is interrupted before writing anything
+        TEST_RESULT_INT(pipe(pipeHandle), 0, "create pipe");
+
+        Buffer *writeBuffer = bufNew(1024 * 1024);
+        bufUsedSet(writeBuffer, bufSize(writeBuffer));
+
+        for (size_t writeIdx = 0; writeIdx < bufUsed(writeBuffer); writeIdx++)
+            bufPtr(writeBuffer)[writeIdx] = (unsigned char)(writeIdx % 251);
+
+        TEST_ASSIGN(async, storageDriverPosixFileAsyncNew(pipeHandle[1], true, bufUsed(writeBuffer)), "new write behind");
+        TEST_RESULT_INT(storageDriverPosixFileAsyncWrite(async, writeBuffer), 0, "    write");
+        sleepMSec(100);
+        TEST_RESULT_INT(pthread_kill(async->thread, SIGUSR1), 0, "    interrupt write after some data is written");
+        sleepMSec(100);
+        TEST_RESULT_INT(pthread_kill(async->thread, SIGUSR1), 0, "    interrupt write before data is written");
+        sleepMSec(100);
+
+        buffer = bufNew(bufUsed(writeBuffer));
+
+        while (bufRemains(buffer) > 0)
+        {
+            ssize_t actualBytes = read(pipeHandle[0], bufRemainsPtr(buffer), bufRemains(buffer));
+
+            if (actualBytes <= 0)
+                break;
+
+            bufUsedInc(buffer, (size_t)actualBytes);
+        }
+
+        TEST_RESULT_INT(storageDriverPosixFileAsyncFlush(async), 0, "    flush");
+        TEST_RESULT_BOOL(bufEq(buffer, writeBuffer), true, "    check contents");
+        TEST_RESULT_VOID(storageDriverPosixFileAsyncFree(async), "    free");
+        close(pipeHandle[0]);
+        close(pipeHandle[1]);
+
+        TEST_RESULT_INT(sigaction(SIGUSR1, &signalActionOld, NULL), 0, "restore signal handler");
+
+        storageRemoveP(storageTest, fileName, .errorOnMissing = true);
+    }
+
     // *****************************************************************************************************************************
     if (testBegin("storageLocal() and storageLocalWrite()"))
     {
@@ -1,11 +1,61 @@
 /***********************************************************************************************************************************
 Test Remote Storage Driver
 ***********************************************************************************************************************************/
+#include <fcntl.h>
+#include <inttypes.h>
+#include <pthread.h>
+#include <sys/time.h>
+#include <time.h>
+#include <unistd.h>
+
 #include "common/io/bufferRead.h"
 #include "common/io/bufferWrite.h"
+#include "common/io/handleWrite.h"
+#include "protocol/frame.h"
+#include "version.h"
 
 #include "common/harnessConfig.h"
 
+/***********************************************************************************************************************************
+Test callback for storageListEach()
+***********************************************************************************************************************************/
+static void
+testListEachCallback(void *callbackData, const String *name, StorageInfo info)
+{
+    strLstAdd(
+        (StringList *)callbackData,
+        strNewFmt(
+            "%s {%s, %zu, %04o, %s, %" PRId64 "%s%s}", strPtr(name),
+            info.type == storageTypeFile ? "file" : info.type == storageTypePath ? "path" : "link", info.size,
+            (unsigned int)info.mode, info.userId == getuid() && info.groupId == getgid() ? "current" : "other",
+            (int64_t)info.timeModified, info.linkDestination == NULL ? "" : ", ",
+            info.linkDestination == NULL ? "" : strPtr(info.linkDestination)));
+}
+
+/***********************************************************************************************************************************
+Read a pipe until eof after a delay so the writer fills the pipe first
+***********************************************************************************************************************************/
+typedef struct TestPipeReadData
+{
+    int handle;                                                     // Handle to read from
+    Buffer *buffer;                                                 // Data read
+} TestPipeReadData;
+
+static void *
+testPipeRead(void *data)
+{
+    TestPipeReadData *pipeRead = data;
+
+    nanosleep(&(struct timespec){.tv_nsec = 100 * 1000 * 1000}, NULL);
+
+    ssize_t readSize;
+
+    while ((readSize = read(pipeRead->handle, bufRemainsPtr(pipeRead->buffer), bufRemains(pipeRead->buffer))) > 0)
+        bufUsedInc(pipeRead->buffer, (size_t)readSize);
+
+    return NULL;
+}
+
 /***********************************************************************************************************************************
 Test Run
 ***********************************************************************************************************************************/
@@ -99,6 +149,94 @@ testRun(void)
         TEST_RESULT_BOOL(storageDriverRemoteProtocol(strNew(BOGUS_STR), paramList, server), false, "invalid function");
     }
 
+    // *****************************************************************************************************************************
+    if (testBegin("storageListEach()"))
+    {
+        Storage *storageRemote = NULL;
+        TEST_ASSIGN(storageRemote, storageRepoGet(strNew(STORAGE_TYPE_POSIX), false), "get remote repo storage");
+        storagePathCreateNP(storageTest, strNew("repo"));
+
+        StringList *list = strLstNew();
+
+        TEST_RESULT_BOOL(storageListEachNP(storageRemote, NULL, testListEachCallback, list), true, "list empty path");
+        TEST_RESULT_UINT(strLstSize(list), 0, "    check list");
+        TEST_RESULT_BOOL(
+            storageListEachNP(storageRemote, strNew(BOGUS_STR), testListEachCallback, list), false, "missing directory ignored");
+        TEST_ERROR_FMT(
+            storageListEachP(storageRemote, strNew(BOGUS_STR), testListEachCallback, list, .errorOnMissing = true), PathOpenError,
+            "raised from remote-0 protocol on 'localhost': unable to open path '%s/repo/BOGUS' for read:"
+                " [2] No such file or directory",
+            testPath());
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        storagePathCreateNP(storageTest, strNew("repo/testy"));
+        storagePutNP(storageNewWriteNP(storageTest, strNew("repo/test.txt")), bufNewStr(strNew("TEST")));
+        THROW_ON_SYS_ERROR(symlink("test.txt", strPtr(strNewFmt("%s/repo/link", testPath()))) == -1, FileOpenError, "link");
+
+        // Set modification times so they can be checked
+        struct timeval timeModified[2] = {{.tv_sec = 1555555555}, {.tv_sec = 1555555555}};
+
+        THROW_ON_SYS_ERROR(
+            utimes(strPtr(strNewFmt("%s/repo/testy", testPath())), timeModified) == -1, FileWriteError, "testy time");
+        THROW_ON_SYS_ERROR(
+            utimes(strPtr(strNewFmt("%s/repo/test.txt", testPath())), timeModified) == -1, FileWriteError, "test.txt time");
+        THROW_ON_SYS_ERROR(
+            lutimes(strPtr(strNewFmt("%s/repo/link", testPath())), timeModified) == -1, FileWriteError, "link time");
+
+        TEST_RESULT_BOOL(storageListEachNP(storageRemote, NULL, testListEachCallback, list), true, "list path, file, and link");
+        TEST_RESULT_STR(
+            strPtr(strLstJoin(strLstSort(list, sortOrderAsc), ", ")),
+            "link {link, 0, 0777, current, 1555555555, test.txt}, test.txt {file, 4, 0640, current, 1555555555},"
+                " testy {path, 0, 0750, current, 1555555555}",
+            "    check list");
+
+        // Check protocol function directly
+        // -------------------------------------------------------------------------------------------------------------------------
+        VariantList *paramList = varLstNew();
+        varLstAdd(paramList, NULL);
+        varLstAdd(paramList, varNewBool(false));
+        varLstAdd(paramList, varNewStr(strNew("^testy$")));
+
+        TEST_RESULT_BOOL(
+            storageDriverRemoteProtocol(PROTOCOL_COMMAND_STORAGE_LIST_EACH_STR, paramList, server), true, "protocol list each");
+        TEST_RESULT_STR(
+            strPtr(strNewBuf(serverWrite)),
+            strPtr(
+                strNewFmt(
+                    "{\"out\":[\"testy\",1,0,488,%u,%u,1555555555,null]}\n{\"out\":true}\n", (unsigned int)getuid(),
+                    (unsigned int)getgid())),
+            "check result");
+
+        bufUsedSet(serverWrite, 0);
+
+        paramList = varLstNew();
+        varLstAdd(paramList, NULL);
+        varLstAdd(paramList, varNewBool(false));
+        varLstAdd(paramList, varNewStr(strNew("^link$")));
+
+        TEST_RESULT_BOOL(
+            storageDriverRemoteProtocol(PROTOCOL_COMMAND_STORAGE_LIST_EACH_STR, paramList, server), true,
+            "protocol list each link");
+        TEST_RESULT_STR(
+            strPtr(strNewBuf(serverWrite)),
+            strPtr(
+                strNewFmt(
+                    "{\"out\":[\"link\",2,0,511,%u,%u,1555555555,\"test.txt\"]}\n{\"out\":true}\n", (unsigned int)getuid(),
+                    (unsigned int)getgid())),
+            "check result");
+
+        bufUsedSet(serverWrite, 0);
+
+        // Entries are sent in multiple batches when the batch is full
+        for (unsigned int fileIdx = 0; fileIdx < PROTOCOL_STORAGE_LIST_EACH_BATCH_MAX; fileIdx++)
+            storagePutNP(storageNewWriteNP(storageTest, strNewFmt("repo/batch/%04u", fileIdx)), NULL);
+
+        list = strLstNew();
+
+        TEST_RESULT_BOOL(storageListEachNP(storageRemote, strNew("batch"), testListEachCallback, list), true, "list full batch");
+        TEST_RESULT_UINT(strLstSize(list), PROTOCOL_STORAGE_LIST_EACH_BATCH_MAX, "    check list size");
+    }
+
     // *****************************************************************************************************************************
     if (testBegin("storageNewRead()"))
     {
@@ -136,15 +274,50 @@ testRun(void)
 
         TEST_RESULT_BOOL(
             bufEq(storageGetNP(storageNewReadNP(storageRemote, strNew("test.txt"))), contentBuf), true, "get file again");
+        TEST_RESULT_STR(
+            strPtr(
+                strNewBuf(storageGetNP(storageNewReadP(storageRemote, strNew("test.txt"), .offset = 1, .limit = varNewUInt64(4))))),
+            "ABAB", "get file with offset and limit");
 
         TEST_ERROR(
             storageDriverRemoteFileReadBlockSize(strNew("bogus")), ProtocolError, "'bogus' is not a valid block size message");
 
+        // Read from a server that does not support binary frames
+        // -------------------------------------------------------------------------------------------------------------------------
+        IoRead *clientRead = ioBufferReadIo(
+            ioBufferReadNew(
+                bufNewStr(
+                    strNew(
+                        "{\"name\":\"pgBackRest\",\"service\":\"test\",\"version\":\"" PROJECT_VERSION "\"}\n"
+                        "{}\n"
+                        "{\"out\":true}\n"
+                        "BRBLOCK4\n"
+                        "TESTBRBLOCK0\n"))));
+        ioReadOpen(clientRead);
+        IoWrite *clientWrite = ioBufferWriteIo(ioBufferWriteNew(bufNew(1024)));
+        ioWriteOpen(clientWrite);
+
+        ProtocolClient *client = NULL;
+        TEST_ASSIGN(client, protocolClientNew(strNew("test"), strNew("test"), clientRead, clientWrite), "new json client");
+        TEST_RESULT_BOOL(protocolClientBinary(client), false, "    check json");
+
+        TEST_RESULT_BOOL(
+            bufEq(
+                storageGetNP(
+                    storageDriverRemoteFileReadInterface(
+                        storageDriverRemoteFileReadNew(storageDriver(storageRemote), client, strNew("test.txt"), false, 0, NULL))),
+                bufNewStr(strNew("TEST"))),
+            true, "get file with json");
+
+        protocolClientFree(client);
+
         // Check protocol function directly (file missing)
         // -------------------------------------------------------------------------------------------------------------------------
         VariantList *paramList = varLstNew();
         varLstAdd(paramList, varNewStr(strNew("missing.txt")));
         varLstAdd(paramList, varNewBool(true));
+        varLstAdd(paramList, varNewUInt64(0));
+        varLstAdd(paramList, NULL);
 
         TEST_RESULT_BOOL(
             storageDriverRemoteProtocol(PROTOCOL_COMMAND_STORAGE_OPEN_READ_STR, paramList, server), true,
@@ -153,6 +326,25 @@ testRun(void)
 
         bufUsedSet(serverWrite, 0);
 
+        // Create a server that has switched to binary frames
+        // -------------------------------------------------------------------------------------------------------------------------
+        Buffer *serverBinaryCommand = bufNew(256);
+        IoWrite *serverBinaryCommandIo = ioBufferWriteIo(ioBufferWriteNew(serverBinaryCommand));
+        ioWriteOpen(serverBinaryCommandIo);
+        ioWriteLine(serverBinaryCommandIo, strNew("{\"cmd\":\"frame\",\"param\":[\"binary\"]}"));
+        protocolFrameWrite(
+            serverBinaryCommandIo, protocolFrameTypeCommand, protocolCommandVar(protocolCommandNew(PROTOCOL_COMMAND_EXIT_STR)));
+        ioWriteFlush(serverBinaryCommandIo);
+
+        IoRead *serverBinaryRead = ioBufferReadIo(ioBufferReadNew(serverBinaryCommand));
+        ioReadOpen(serverBinaryRead);
+
+        ProtocolServer *serverBinary = protocolServerNew(strNew("test"), strNew("test"), serverBinaryRead, serverWriteIo);
+        protocolServerProcess(serverBinary);
+        TEST_RESULT_BOOL(protocolServerBinary(serverBinary), true, "binary server");
+
+        bufUsedSet(serverWrite, 0);
+
         // Check protocol function directly (file exists)
         // -------------------------------------------------------------------------------------------------------------------------
         storagePutNP(storageNewWriteNP(storageTest, strNew("repo/test.txt")), bufNewStr(strNew("TESTDATA")));
@@ -161,6 +353,8 @@ testRun(void)
         paramList = varLstNew();
         varLstAdd(paramList, varNewStr(strNew("test.txt")));
         varLstAdd(paramList, varNewBool(false));
+        varLstAdd(paramList, varNewUInt64(0));
+        varLstAdd(paramList, NULL);
 
         TEST_RESULT_BOOL(
             storageDriverRemoteProtocol(PROTOCOL_COMMAND_STORAGE_OPEN_READ_STR, paramList, server), true, "protocol open read");
@@ -173,6 +367,238 @@ testRun(void)
             "check result");
 
         bufUsedSet(serverWrite, 0);
+
+        // Check protocol function directly (file exists, offset and limit)
+        // -------------------------------------------------------------------------------------------------------------------------
+        VariantList *paramRangeList = varLstNew();
+        varLstAdd(paramRangeList, varNewStr(strNew("test.txt")));
+        varLstAdd(paramRangeList, varNewBool(false));
+        varLstAdd(paramRangeList, varNewUInt64(2));
+        varLstAdd(paramRangeList, varNewUInt64(4));
+
+        TEST_RESULT_BOOL(
+            storageDriverRemoteProtocol(PROTOCOL_COMMAND_STORAGE_OPEN_READ_STR, paramRangeList, server), true,
+            "protocol open read with offset and limit");
+        TEST_RESULT_STR(
+            strPtr(strNewBuf(serverWrite)),
+            "{\"out\":true}\n"
+                "BRBLOCK4\n"
+                "STDABRBLOCK0\n",
+            "check result");
+
+        bufUsedSet(serverWrite, 0);
+
+        // Check protocol function directly (file exists, binary frames)
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_RESULT_BOOL(
+            storageDriverRemoteProtocol(PROTOCOL_COMMAND_STORAGE_OPEN_READ_STR, paramList, serverBinary), true,
+            "protocol open read");
+        TEST_RESULT_STR(
+            strPtr(bufHex(bufNewC(bufUsed(serverWrite), bufPtr(serverWrite)))),
+            "52000000026201"                                        // Response true
+                "420000000454455354"                                // Block TEST
+                "420000000444415441"                                // Block DATA
+                "4200000000",                                       // Block end
+            "check result");
+
+        bufUsedSet(serverWrite, 0);
+
+        // Send file directly when the protocol is writing to a handle
+        // -------------------------------------------------------------------------------------------------------------------------
+        int sendHandle = open(strPtr(strNewFmt("%s/send.out", testPath())), O_WRONLY | O_CREAT | O_TRUNC, 0640);
+        IoWrite *sendWrite = ioHandleWriteIo(ioHandleWriteNew(strNew("send"), sendHandle));
+        ioWriteOpen(sendWrite);
+
+        ProtocolServer *serverSend = protocolServerNew(
+            strNew("test"), strNew("test"), ioBufferReadIo(ioBufferReadNew(bufNew(0))), sendWrite);
+
+        THROW_ON_SYS_ERROR(ftruncate(sendHandle, 0) == -1, FileWriteError, "unable to truncate");
+        THROW_ON_SYS_ERROR(lseek(sendHandle, 0, SEEK_SET) == -1, FileWriteError, "unable to seek");
+
+        IoRead *sendRead = storageFileReadIo(storageNewReadNP(storageTest, strNew("repo/test.txt")));
+        ioReadOpen(sendRead);
+
+        TEST_RESULT_BOOL(storageDriverRemoteProtocolSendFile(serverSend, sendRead, NULL), true, "send file");
+        TEST_RESULT_STR(
+            strPtr(strNewBuf(storageGetNP(storageNewReadNP(storageTest, strNew("send.out"))))),
+            "BRBLOCK4\n"
+                "TESTBRBLOCK4\n"
+                "DATA",
+            "check result");
+
+        ioReadClose(sendRead);
+
+        // Send file directly with offset and limit
+        // -------------------------------------------------------------------------------------------------------------------------
+        THROW_ON_SYS_ERROR(ftruncate(sendHandle, 0) == -1, FileWriteError, "unable to truncate");
+        THROW_ON_SYS_ERROR(lseek(sendHandle, 0, SEEK_SET) == -1, FileWriteError, "unable to seek");
+
+        sendRead = storageFileReadIo(storageNewReadP(storageTest, strNew("repo/test.txt"), .offset = 3, .limit = varNewUInt64(3)));
+        ioReadOpen(sendRead);
+
+        TEST_RESULT_BOOL(storageDriverRemoteProtocolSendFile(serverSend, sendRead, varNewUInt64(3)), true, "send file");
+        TEST_RESULT_STR(
+            strPtr(strNewBuf(storageGetNP(storageNewReadNP(storageTest, strNew("send.out"))))), "BRBLOCK3\nTDA", "check result");
+
+        ioReadClose(sendRead);
+
+        // Send nothing when the offset is past the end of the file
+        THROW_ON_SYS_ERROR(ftruncate(sendHandle, 0) == -1, FileWriteError, "unable to truncate");
+        THROW_ON_SYS_ERROR(lseek(sendHandle, 0, SEEK_SET) == -1, FileWriteError, "unable to seek");
+
+        sendRead = storageFileReadIo(
+            storageNewReadP(storageTest, strNew("repo/test.txt"), .offset = 100, .limit = varNewUInt64(100)));
+        ioReadOpen(sendRead);
+
+        TEST_RESULT_BOOL(storageDriverRemoteProtocolSendFile(serverSend, sendRead, varNewUInt64(100)), true, "send file past eof");
+        TEST_RESULT_STR(strPtr(strNewBuf(storageGetNP(storageNewReadNP(storageTest, strNew("send.out"))))), "", "check result");
+
+        ioReadClose(sendRead);
+
+        // Send file directly with binary frames
+        // -------------------------------------------------------------------------------------------------------------------------
+        ioBufferSizeSet(8192);
+
+        serverBinaryRead = ioBufferReadIo(ioBufferReadNew(serverBinaryCommand));
+        ioReadOpen(serverBinaryRead);
+
+        serverBinary = protocolServerNew(strNew("test"), strNew("test"), serverBinaryRead, sendWrite);
+        protocolServerProcess(serverBinary);
+
+        ioBufferSizeSet(4);
+
+        THROW_ON_SYS_ERROR(ftruncate(sendHandle, 0) == -1, FileWriteError, "unable to truncate");
+        THROW_ON_SYS_ERROR(lseek(sendHandle, 0, SEEK_SET) == -1, FileWriteError, "unable to seek");
+
+        sendRead = storageFileReadIo(storageNewReadNP(storageTest, strNew("repo/test.txt")));
+        ioReadOpen(sendRead);
+
+        TEST_RESULT_BOOL(storageDriverRemoteProtocolSendFile(serverBinary, sendRead, NULL), true, "send file");
+        TEST_RESULT_STR(
+            strPtr(bufHex(storageGetNP(storageNewReadNP(storageTest, strNew("send.out"))))),
+            "420000000454455354"                                    // Block TEST
+                "420000000444415441",                               // Block DATA
+            "check result");
+
+        ioReadClose(sendRead);
+
+        // Send what is left when the file is truncated after the size to send was determined
+        // -------------------------------------------------------------------------------------------------------------------------
+        THROW_ON_SYS_ERROR(ftruncate(sendHandle, 0) == -1, FileWriteError, "unable to truncate");
+        THROW_ON_SYS_ERROR(lseek(sendHandle, 0, SEEK_SET) == -1, FileWriteError, "unable to seek");
+
+        storagePutNP(storageNewWriteNP(storageTest, strNew("repo/truncate.txt")), bufNewStr(strNew("TESTDATA")));
+
+        const String *truncateFile = strNewFmt("%s/repo/truncate.txt", testPath());
+        int fileHandle = open(strPtr(truncateFile), O_RDONLY);
+        THROW_ON_SYS_ERROR(truncate(strPtr(truncateFile), 5) == -1, FileWriteError, "unable to truncate");
+
+        TEST_RESULT_VOID(storageDriverRemoteProtocolSendHandle(serverSend, fileHandle, sendHandle, 8), "send truncated file");
+        TEST_RESULT_STR(
+            strPtr(strNewBuf(storageGetNP(storageNewReadNP(storageTest, strNew("send.out"))))),
+            "BRBLOCK4\n"
+                "TESTBRBLOCK1\n"
+                "D",
+            "check result");
+
+        close(fileHandle);
+
+        // Truncated mid-read through the protocol, i.e. after the first block has been sent
+        // -------------------------------------------------------------------------------------------------------------------------
+        storagePutNP(storageNewWriteNP(storageTest, strNew("repo/truncate.txt")), bufNewStr(strNew("TESTDATA")));
+
+        THROW_ON_SYS_ERROR(ftruncate(sendHandle, 0) == -1, FileWriteError, "unable to truncate");
+        THROW_ON_SYS_ERROR(lseek(sendHandle, 0, SEEK_SET) == -1, FileWriteError, "unable to seek");
+
+        fileHandle = open(strPtr(truncateFile), O_RDONLY);
+
+        TEST_RESULT_VOID(storageDriverRemoteProtocolSendHandle(serverSend, fileHandle, sendHandle, 4), "send first block");
+        THROW_ON_SYS_ERROR(truncate(strPtr(truncateFile), 6) == -1, FileWriteError, "unable to truncate");
+        TEST_RESULT_VOID(storageDriverRemoteProtocolSendHandle(serverSend, fileHandle, sendHandle, 4), "send rest of file");
+        TEST_RESULT_VOID(storageDriverRemoteProtocolSendHandle(serverSend, fileHandle, sendHandle, 4), "send nothing at eof");
+        TEST_RESULT_STR(
+            strPtr(strNewBuf(storageGetNP(storageNewReadNP(storageTest, strNew("send.out"))))),
+            "BRBLOCK4\n"
+                "TESTBRBLOCK2\n"
+                "DA",
+            "check result");
+
+        close(fileHandle);
+
+        // Wait when a non-blocking output is full
+        // -------------------------------------------------------------------------------------------------------------------------
+        ioBufferSizeSet(65536);
+
+        Buffer *fileData = bufNew(262144);
+        memset(bufPtr(fileData), 'X', bufSize(fileData));
+        bufUsedSet(fileData, bufSize(fileData));
+        storagePutNP(storageNewWriteNP(storageTest, strNew("repo/large.txt")), fileData);
+
+        // The data is sent to a non-blocking handle but the protocol writes block headers to a blocking handle for the same pipe
+        int pipeHandle[2];
+        THROW_ON_SYS_ERROR(pipe(pipeHandle) == -1, FileOpenError, "unable to create pipe");
+
+        int pipeHandleBlock = open(strPtr(strNewFmt("/proc/self/fd/%d", pipeHandle[1])), O_WRONLY);
+        THROW_ON_SYS_ERROR(pipeHandleBlock == -1, FileOpenError, "unable to open pipe");
+        THROW_ON_SYS_ERROR(fcntl(pipeHandle[1], F_SETFL, O_NONBLOCK) == -1, FileOpenError, "unable to set non-blocking");
+
+        IoWrite *pipeWrite = ioHandleWriteIo(ioHandleWriteNew(strNew("pipe"), pipeHandleBlock));
+        ioWriteOpen(pipeWrite);
+        ProtocolServer *serverPipe = protocolServerNew(
+            strNew("test"), strNew("test"), ioBufferReadIo(ioBufferReadNew(bufNew(0))), pipeWrite);
+
+        // Start reading the pipe after the greeting has been written
+        TestPipeReadData pipeRead = {.handle = pipeHandle[0], .buffer = bufNew(bufSize(fileData) * 2)};
+        pthread_t pipeThread;
+        THROW_ON_SYS_ERROR(pthread_create(&pipeThread, NULL, testPipeRead, &pipeRead) != 0, AssertError, "create thread");
+
+        fileHandle = open(strPtr(strNewFmt("%s/repo/large.txt", testPath())), O_RDONLY);
+
+        TEST_RESULT_VOID(
+            storageDriverRemoteProtocolSendHandle(serverPipe, fileHandle, pipeHandle[1], bufSize(fileData)),
+            "send file to full pipe");
+
+        close(fileHandle);
+        close(pipeHandleBlock);
+        close(pipeHandle[1]);
+        THROW_ON_SYS_ERROR(pthread_join(pipeThread, NULL) != 0, AssertError, "join thread");
+        close(pipeHandle[0]);
+
+        // Remove the greeting and block headers to check the data
+        const char *pipeData = (const char *)bufPtr(pipeRead.buffer);
+        size_t pipeIdx = (size_t)(strchr(pipeData, '\n') - pipeData) + 1;
+        TEST_RESULT_BOOL(strncmp(pipeData + pipeIdx, PROTOCOL_BLOCK_HEADER, 7) == 0, true, "    check block header");
+
+        Buffer *dataSent = bufNew(bufSize(fileData));
+
+        while (pipeIdx < bufUsed(pipeRead.buffer))
+        {
+            size_t headerSize = (size_t)((const char *)memchr(pipeData + pipeIdx, '\n', 32) - (pipeData + pipeIdx)) + 1;
+            size_t blockSize = (size_t)cvtZToUInt64(
+                strPtr(
+                    strNewN(
+                        pipeData + pipeIdx + sizeof(PROTOCOL_BLOCK_HEADER) - 1, headerSize - sizeof(PROTOCOL_BLOCK_HEADER))));
+
+            bufCatC(dataSent, bufPtr(pipeRead.buffer), pipeIdx + headerSize, blockSize);
+            pipeIdx += headerSize + blockSize;
+        }
+
+        TEST_RESULT_BOOL(bufEq(dataSent, fileData), true, "    check data");
+
+        ioBufferSizeSet(4);
+
+        // Files that are not regular files are sent through a buffer
+        // -------------------------------------------------------------------------------------------------------------------------
+        IoRead *devNullRead = storageFileReadIo(storageNewReadNP(storageLocal(), strNew("/dev/null")));
+        ioReadOpen(devNullRead);
+
+        TEST_RESULT_BOOL(
+            storageDriverRemoteProtocolSendFile(serverSend, devNullRead, NULL), false, "no send for non-regular file");
+
+        ioReadClose(devNullRead);
+        ioWriteClose(sendWrite);
+        close(sendHandle);
+
         ioBufferSizeSet(8192);
     }
 